@@ -36,6 +36,14 @@ typedef struct SBlockOrderInfo {
   SColumnInfoData* pColData;
 } SBlockOrderInfo;
 
+// Layout of the normalized sort key, which encodes the sort columns of a row into a byte string, so that the order of
+// two rows is the order of their keys compared by memcmp.
+typedef struct SBlockSortKey {
+  int32_t keyLen;     // 0 if the first sort column can not be encoded
+  int32_t numOfCols;  // number of the leading sort columns in the key
+  bool    exact;      // false if rows with the same key still need to be compared by the sort columns
+} SBlockSortKey;
+
 int32_t taosGetFqdnPortFromEp(const char* ep, SEp* pEp);
 void    addEpIntoEpSet(SEpSet* pEpSet, const char* fqdn, uint16_t port);
 
@@ -213,6 +221,9 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock);
 size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
+void    blockDataGetSortKey(const SSDataBlock* pBlock, const SArray* pOrderInfo, SBlockSortKey* pKey);
+void    blockDataEncodeSortKeys(const SSDataBlock* pBlock, const SArray* pOrderInfo, const SBlockSortKey* pKey,
+                                char* buf, int32_t stride);
 int32_t blockDataSort_rv(SSDataBlock* pDataBlock, SArray* pOrderInfo, bool nullFirst);
 
 int32_t colInfoDataEnsureCapacity(SColumnInfoData* pColumn, uint32_t numOfRows);
@@ -65,6 +65,7 @@ extern int32_t tsNumOfVnodeQueryThreads;
 extern int32_t tsNumOfVnodeStreamThreads;
 extern int32_t tsNumOfVnodeFetchThreads;
 extern int32_t tsNumOfVnodeWriteThreads;
+extern int32_t tsNumOfVnodeReplayThreads;
 extern int32_t tsNumOfVnodeSyncThreads;
 extern int32_t tsNumOfVnodeRsmaThreads;
 extern int32_t tsNumOfQnodeQueryThreads;
@@ -90,11 +91,15 @@ extern uint16_t tsTelemPort;
 // query buffer management
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node
+extern int32_t tsQueryGroupBufferSize;  // memory in MB for the groups of the group by operators of a query, 0 means no limit
 
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQuerySmaOptimize;
 extern bool    tsQueryPlannerTrace;
+extern bool    tsQueryLinearizable;
+extern int32_t tsQueryMaxStaleness;
+extern int32_t tsQueryScanParallelism;
 
 // client
 extern int32_t tsMinSlidingTime;
@@ -132,6 +137,11 @@ extern int32_t tsTransPullupInterval;
 extern int32_t tsMqRebalanceInterval;
 extern int32_t tsTtlUnit;
 extern int32_t tsTtlPushInterval;
+extern int32_t tsTtlBatchDropNum;
+extern bool    tsMetaWalMode;
+extern bool    tsMetaTagCache;
+extern bool    tsMetaMmapRead;
+extern bool    tsMetaSnapshotRead;
 extern int32_t tsGrantHBInterval;
 extern int32_t tsUptimeInterval;
 
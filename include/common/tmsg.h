@@ -881,6 +881,7 @@ int32_t tDeserializeSVTrimDbReq(void* buf, int32_t bufLen, SVTrimDbReq* pReq);
 
 typedef struct {
   int32_t timestamp;
+  int32_t batchNum;  // max tables dropped by one request, 0 for no limit
 } SVDropTtlTableReq;
 
 int32_t tSerializeSVDropTtlTableReq(void* buf, int32_t bufLen, SVDropTtlTableReq* pReq);
@@ -1067,6 +1068,8 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t numOfSchemaCacheHits;
+  int64_t numOfSchemaCacheMisses;
   int64_t errors;
 } SVnodesStat;
 
@@ -1084,6 +1087,8 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t numOfSchemaCacheHits;
+  int64_t numOfSchemaCacheMisses;
 } SVnodeLoad;
 
 typedef struct {
@@ -1572,10 +1577,10 @@ int32_t tDeserializeSServerStatusRsp(void* buf, int32_t bufLen, SServerStatusRsp
 
 /**
  * The layout of the query message payload is as following:
- * +--------------------+---------------------------------+
- * |Sql statement       | Physical plan                   |
- * |(denoted by sqlLen) |(In JSON, denoted by contentLen) |
- * +--------------------+---------------------------------+
+ * +--------------------+---------------------------------+----------------+
+ * |Sql statement       | Physical plan                   | SSubQueryMsgExt|
+ * |(denoted by sqlLen) |(In JSON, denoted by contentLen) | (optional)     |
+ * +--------------------+---------------------------------+----------------+
  */
 typedef struct SSubQueryMsg {
   SMsgHead header;
@@ -1592,6 +1597,15 @@ typedef struct SSubQueryMsg {
   char     msg[];
 } SSubQueryMsg;
 
+// optional fields appended after the physical plan, absent in messages of older versions
+typedef struct {
+  int8_t  linearizable;  // serve on leader only while its lease is valid
+  int32_t maxStaleMs;    // > 0: followers may serve with data at most this stale
+} SSubQueryMsgExt;
+
+int32_t tPutSubQueryMsgExt(uint8_t* p, const SSubQueryMsgExt* pExt);
+void    tGetSubQueryMsgExt(const SSubQueryMsg* pMsg, int32_t contLen, SSubQueryMsgExt* pExt);
+
 typedef struct {
   SMsgHead header;
   uint64_t sId;
@@ -106,6 +106,7 @@ typedef struct SJoinLogicNode {
   SNode*     pOnConditions;
   bool       isSingleTableJoin;
   EOrder     inputTsOrder;
+  bool       hashJoin;  // no primary key equality, joined by hashing the equal columns of both sides
 } SJoinLogicNode;
 
 typedef struct SAggLogicNode {
@@ -340,6 +341,7 @@ typedef struct STableScanPhysiNode {
   int64_t        watermark;
   int8_t         igExpired;
   bool           assignBlockUid;
+  int8_t         parallelism;  // max number of workers that scan the table list of a vgroup
 } STableScanPhysiNode;
 
 typedef STableScanPhysiNode STableSeqScanPhysiNode;
@@ -380,6 +382,15 @@ typedef struct SSortMergeJoinPhysiNode {
   EOrder     inputTsOrder;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNodeList* pLeftKeys;   // SColumnNode of the left child, pairwise equal to pRightKeys
+  SNodeList* pRightKeys;  // SColumnNode of the right child
+  SNode*     pOnConditions;
+  SNodeList* pTargets;
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
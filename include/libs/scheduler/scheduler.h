@@ -76,6 +76,8 @@ typedef struct SSchedulerReq {
   void*                 chkKillParam;
   SExecResult*          pExecRes;
   void**                pFetchRes;
+  bool                  linearizable;
+  int32_t               maxStaleMs;
 } SSchedulerReq;
 
 
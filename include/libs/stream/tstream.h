@@ -13,6 +13,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef _STREAM_H_
+#define _STREAM_H_
+
 #include "executor.h"
 #include "os.h"
 #include "query.h"
@@ -28,9 +31,6 @@
 extern "C" {
 #endif
 
-#ifndef _STREAM_H_
-#define _STREAM_H_
-
 typedef struct SStreamTask SStreamTask;
 
 enum {
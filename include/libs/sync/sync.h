@@ -216,6 +216,8 @@ int32_t     syncSetStandby(int64_t rid);
 ESyncState  syncGetMyRole(int64_t rid);
 bool        syncIsReady(int64_t rid);
 bool        syncIsReadyForRead(int64_t rid);
+bool        syncIsReadyForLeaseRead(int64_t rid, SyncIndex* pReadIndex);
+bool        syncIsReadyForStaleRead(int64_t rid, int32_t maxStaleMs, SyncIndex* pReadIndex);
 const char* syncGetMyRoleStr(int64_t rid);
 bool        syncRestoreFinish(int64_t rid);
 SyncTerm    syncGetMyTerm(int64_t rid);
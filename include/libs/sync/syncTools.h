@@ -343,9 +343,12 @@ typedef struct SyncAppendEntries {
   SyncTerm  privateTerm;
   uint32_t  dataLen;
   char      data[];
+  // data is followed by int64_t leaseStartMs, leader monotonic time when sent, echoed back in reply
 } SyncAppendEntries;
 
 SyncAppendEntries* syncAppendEntriesBuild(uint32_t dataLen, int32_t vgId);
+void               syncAppendEntriesSetLeaseStart(SyncAppendEntries* pMsg, int64_t leaseStartMs);
+int64_t            syncAppendEntriesLeaseStart(const SyncAppendEntries* pMsg);
 void               syncAppendEntriesDestroy(SyncAppendEntries* pMsg);
 void               syncAppendEntriesSerialize(const SyncAppendEntries* pMsg, char* buf, uint32_t bufLen);
 void               syncAppendEntriesDeserialize(const char* buf, uint32_t len, SyncAppendEntries* pMsg);
@@ -390,9 +393,12 @@ typedef struct SyncAppendEntriesBatch {
   int32_t   dataCount;
   uint32_t  dataLen;
   char      data[];  // block1, block2
+  // data is followed by int64_t leaseStartMs, as in SyncAppendEntries
 } SyncAppendEntriesBatch;
 
 SyncAppendEntriesBatch* syncAppendEntriesBatchBuild(SSyncRaftEntry** entryPArr, int32_t arrSize, int32_t vgId);
+void                    syncAppendEntriesBatchSetLeaseStart(SyncAppendEntriesBatch* pMsg, int64_t leaseStartMs);
+int64_t                 syncAppendEntriesBatchLeaseStart(const SyncAppendEntriesBatch* pMsg);
 SOffsetAndContLen*      syncAppendEntriesBatchMetaTableArray(SyncAppendEntriesBatch* pMsg);
 void                    syncAppendEntriesBatchDestroy(SyncAppendEntriesBatch* pMsg);
 void                    syncAppendEntriesBatchSerialize(const SyncAppendEntriesBatch* pMsg, char* buf, uint32_t bufLen);
@@ -424,6 +430,7 @@ typedef struct SyncAppendEntriesReply {
   bool      success;
   SyncIndex matchIndex;
   int64_t   startTime;
+  int64_t   leaseStartMs;  // echo of the append entries lease start, 0 from older versions
 } SyncAppendEntriesReply;
 
 SyncAppendEntriesReply* syncAppendEntriesReplyBuild(int32_t vgId);
@@ -557,9 +564,12 @@ typedef struct SyncSnapshotSend {
   int32_t   seq;
   uint32_t  dataLen;
   char      data[];
+  // compressed data is followed by uint32_t rawLen, the length of data before compression
 } SyncSnapshotSend;
 
 SyncSnapshotSend* syncSnapshotSendBuild(uint32_t dataLen, int32_t vgId);
+SyncSnapshotSend* syncSnapshotSendBuildCmpr(uint32_t dataLen, uint32_t rawLen, int32_t vgId);
+uint32_t          syncSnapshotSendRawLen(const SyncSnapshotSend* pMsg);
 void              syncSnapshotSendDestroy(SyncSnapshotSend* pMsg);
 void              syncSnapshotSendSerialize(const SyncSnapshotSend* pMsg, char* buf, uint32_t bufLen);
 void              syncSnapshotSendDeserialize(const char* buf, uint32_t len, SyncSnapshotSend* pMsg);
@@ -97,6 +97,8 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+typedef struct SWalMmap SWalMmap;
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -114,7 +116,9 @@ typedef struct SWal {
   int64_t       refId;
   TdThreadMutex mutex;
   // ref
-  SHashObj *pRefHash;  // refId -> SWalRef
+  SHashObj *pRefHash;   // refId -> SWalRef
+  SHashObj *pMmapHash;  // fileFirstVer -> SWalMmap, guarded by mutex
+  SWalMmap *pMmapList;  // all mappings still alive, guarded by mutex
   // path
   char path[WAL_PATH_LEN];
   // reusable write head
@@ -133,6 +137,7 @@ typedef struct {
   int8_t scanNotApplied;
   int8_t scanMeta;
   int8_t enableRef;
+  int8_t enableMmap;  // read entries in place from a shared read-only mapping of the log file
 } SWalFilterCond;
 
 typedef struct {
@@ -147,6 +152,9 @@ typedef struct {
   int8_t         curStopped;
   TdThreadMutex  mutex;
   SWalFilterCond cond;
+  // mmap mode, pHead points into pMmap at mmapOffset
+  SWalMmap *pMmap;
+  int64_t   mmapOffset;
   // TODO remove it
   SWalCkHead *pHead;
 } SWalReader;
@@ -198,6 +206,12 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver, SWalCkHead *pHead);
 int32_t walFetchBody(SWalReader *pRead, SWalCkHead **ppHead);
 int32_t walSkipFetchBody(SWalReader *pRead, const SWalCkHead *pHead);
 
+// fetch into pRead->pHead, which is owned by the reader and valid until the next fetch.
+// in mmap mode pHead points directly into the log file mapping without any copy
+int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer);
+int32_t walFetchBodyNew(SWalReader *pRead);
+int32_t walSkipFetchBodyNew(SWalReader *pRead);
+
 SWalRef *walRefCommittedVer(SWal *);
 
 SWalRef *walOpenRef(SWal *);
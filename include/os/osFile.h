@@ -95,6 +95,13 @@ void taosGetTmpfilePath(const char *inputTmpDir, const char *fileNamePrefix, cha
 
 int64_t taosFSendFile(TdFilePtr pFileOut, TdFilePtr pFileIn, int64_t *offset, int64_t size);
 
+// map the first length bytes of the file read-only, NULL is returned if mapping is not supported or failed
+void   *taosMmapReadOnlyFile(TdFilePtr pFile, int64_t length);
+int32_t taosMunmapFile(void *ptr, int64_t length);
+// replace the whole pages of a mapping from offset on with zero pages, so that they stay readable after the file is
+// truncated to offset
+int32_t taosMmapZeroTail(void *ptr, int64_t length, int64_t offset);
+
 bool taosValidFile(TdFilePtr pFile);
 
 int32_t taosGetErrorFile(TdFilePtr pFile);
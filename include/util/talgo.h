@@ -54,6 +54,21 @@ typedef void (*__ext_swap_fn_t)(void *p1, void *p2, const void *param);
  */
 void taosqsort(void *src, int64_t numOfElem, int64_t size, const void *param, __ext_compar_fn_t comparFn);
 
+/**
+ * radix sort of the fixed length records, which are ordered by the leading keyLen bytes compared with memcmp. The
+ * records with the same key are ordered by comparFn, or kept in any order if it is NULL.
+ *
+ * @param src
+ * @param numOfElem
+ * @param size      length of a record
+ * @param keyLen    length of the key at the beginning of each record
+ * @param param
+ * @param comparFn
+ * @return 0 on success, -1 if out of memory
+ */
+int32_t taosRadixSort(void *src, int64_t numOfElem, int64_t size, int32_t keyLen, const void *param,
+                      __ext_compar_fn_t comparFn);
+
 /**
  * binary search, with range support
  *
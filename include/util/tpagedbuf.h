@@ -153,6 +153,13 @@ void setBufPageDirty(void* pPage, bool dirty);
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
 
+/**
+ * Change the maximum size of the pages kept in memory, which is a soft limit as well.
+ * @param pBuf
+ * @param inMemBufSize
+ */
+void dBufSetInMemBufSize(SDiskbasedBuf* pBuf, int32_t inMemBufSize);
+
 /**
  * Set the pageId page buffer is not need
  * @param pBuf
@@ -679,6 +679,8 @@ int32_t scheduleQuery(SRequestObj* pRequest, SQueryPlan* pDag, SArray* pNodeList
          .chkKillFp = chkRequestKilled,
          .chkKillParam = (void*)pRequest->self,
          .pExecRes = &res,
+         .linearizable = tsQueryLinearizable,
+         .maxStaleMs = tsQueryMaxStaleness,
   };
 
   int32_t code = schedulerExecJob(&req, &pRequest->body.queryJob);
@@ -1055,6 +1057,8 @@ void launchAsyncQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaData* pResultM
             .chkKillFp = chkRequestKilled,
             .chkKillParam = (void*)pRequest->self,
             .pExecRes = NULL,
+            .linearizable = tsQueryLinearizable,
+            .maxStaleMs = tsQueryMaxStaleness,
         };
         code = schedulerExecJob(&req, &pRequest->body.queryJob);
         taosArrayDestroy(pNodeList);
@@ -887,6 +887,303 @@ static int32_t* createTupleIndex(size_t rows) {
 
 static void destroyTupleIndex(int32_t* index) { taosMemoryFreeClear(index); }
 
+#define SORT_KEY_MAX_LEN       64
+#define SORT_KEY_BINARY_PREFIX 16
+#define SORT_KEY_NCHAR_PREFIX  32
+#define SORT_KEY_MIN_ROWS      64
+
+// length of the encoded value, besides the null flag, or 0 if the type can not be encoded
+static int32_t getSortKeyColWidth(const SColumnInfoData* pCol, bool* truncated) {
+  *truncated = false;
+
+  int32_t len = pCol->info.bytes - VARSTR_HEADER_SIZE;
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return pCol->info.bytes;
+    case TSDB_DATA_TYPE_BINARY:
+      // the prefix and the length, since a shorter string comes first
+      *truncated = (len > SORT_KEY_BINARY_PREFIX);
+      return TMIN(len, SORT_KEY_BINARY_PREFIX) + sizeof(uint16_t);
+    case TSDB_DATA_TYPE_NCHAR:
+      *truncated = (len > SORT_KEY_NCHAR_PREFIX);
+      return TMIN(len, SORT_KEY_NCHAR_PREFIX) + sizeof(uint16_t);
+    default:
+      return 0;
+  }
+}
+
+void blockDataGetSortKey(const SSDataBlock* pBlock, const SArray* pOrderInfo, SBlockSortKey* pKey) {
+  pKey->keyLen = 0;
+  pKey->numOfCols = 0;
+  pKey->exact = true;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    bool    truncated = false;
+    int32_t width = getSortKeyColWidth(pCol, &truncated);
+    if (width == 0 || pKey->keyLen + 1 + width > SORT_KEY_MAX_LEN) {
+      pKey->exact = false;
+      break;
+    }
+
+    pKey->keyLen += 1 + width;
+    pKey->numOfCols += 1;
+
+    // the columns after a truncated one are not encoded
+    if (truncated) {
+      pKey->exact = false;
+      break;
+    }
+  }
+}
+
+static FORCE_INLINE void sortKeyPutUint(char* p, uint64_t v, int32_t bytes) {
+  for (int32_t i = bytes - 1; i >= 0; --i) {
+    p[i] = (char)(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+static void sortKeyPutValue(char* p, const char* pData, int32_t type, int32_t width) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      sortKeyPutUint(p, (uint8_t)(*(int8_t*)pData) ^ 0x80u, 1);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      sortKeyPutUint(p, (uint16_t)(*(int16_t*)pData) ^ 0x8000u, 2);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      sortKeyPutUint(p, (uint32_t)(*(int32_t*)pData) ^ 0x80000000u, 4);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      sortKeyPutUint(p, (uint64_t)(*(int64_t*)pData) ^ 0x8000000000000000ull, 8);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      sortKeyPutUint(p, *(uint8_t*)pData, 1);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      sortKeyPutUint(p, *(uint16_t*)pData, 2);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      sortKeyPutUint(p, *(uint32_t*)pData, 4);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      sortKeyPutUint(p, *(uint64_t*)pData, 8);
+      break;
+    case TSDB_DATA_TYPE_FLOAT: {
+      // NaN comes first as in compareFloatVal, and -0.0 equals to 0.0
+      float    f = *(float*)pData;
+      uint32_t v = 0;
+      if (!isnan(f)) {
+        f = (f == 0) ? 0 : f;
+        memcpy(&v, &f, sizeof(v));
+        v = (v & 0x80000000u) ? ~v : (v | 0x80000000u);
+      }
+      sortKeyPutUint(p, v, 4);
+      break;
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double   d = *(double*)pData;
+      uint64_t v = 0;
+      if (!isnan(d)) {
+        d = (d == 0) ? 0 : d;
+        memcpy(&v, &d, sizeof(v));
+        v = (v & 0x8000000000000000ull) ? ~v : (v | 0x8000000000000000ull);
+      }
+      sortKeyPutUint(p, v, 8);
+      break;
+    }
+    case TSDB_DATA_TYPE_BINARY: {
+      // compareLenPrefixedStr compares the common part with strncmp, which stops at the first '\0'
+      int32_t prefix = width - sizeof(uint16_t);
+      int32_t len = varDataLen(pData);
+      int32_t n = strnlen(varDataVal(pData), TMIN(len, prefix));
+      memcpy(p, varDataVal(pData), n);
+      memset(p + n, 0, prefix - n);
+      sortKeyPutUint(p + prefix, TMIN(len, prefix + 1), sizeof(uint16_t));
+      break;
+    }
+    case TSDB_DATA_TYPE_NCHAR: {
+      // compareLenPrefixedWStr compares the length first
+      int32_t prefix = width - sizeof(uint16_t);
+      int32_t len = varDataLen(pData);
+      int32_t n = TMIN(len, prefix);
+      sortKeyPutUint(p, len, sizeof(uint16_t));
+      memcpy(p + sizeof(uint16_t), varDataVal(pData), n);
+      memset(p + sizeof(uint16_t) + n, 0, prefix - n);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void blockDataEncodeSortKeys(const SSDataBlock* pBlock, const SArray* pOrderInfo, const SBlockSortKey* pKey,
+                             char* buf, int32_t stride) {
+  int32_t offset = 0;
+  for (int32_t i = 0; i < pKey->numOfCols; ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    bool    truncated = false;
+    int32_t width = getSortKeyColWidth(pCol, &truncated);
+    bool    desc = (pOrder->order == TSDB_ORDER_DESC);
+
+    for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+      char* p = buf + (int64_t)j * stride + offset;
+
+      // the null flag is not affected by the order
+      bool isNull = colDataIsNull_s(pCol, j);
+      p[0] = (isNull == pOrder->nullFirst) ? 0 : 1;
+      if (isNull) {
+        memset(p + 1, 0, width);
+        continue;
+      }
+
+      sortKeyPutValue(p + 1, colDataGetData(pCol, j), pCol->info.type, width);
+      if (desc) {
+        for (int32_t k = 1; k <= width; ++k) {
+          p[k] = ~p[k];
+        }
+      }
+    }
+
+    offset += 1 + width;
+  }
+}
+
+typedef struct SSortKeyComparParam {
+  const SSDataBlockSortHelper* pHelper;
+  int32_t                      indexOffset;  // offset of the row index in a record
+} SSortKeyComparParam;
+
+static int32_t sortKeyTieCompar(const void* p1, const void* p2, const void* param) {
+  const SSortKeyComparParam* pParam = param;
+  return dataBlockCompar((const char*)p1 + pParam->indexOffset, (const char*)p2 + pParam->indexOffset,
+                         pParam->pHelper);
+}
+
+// Sort the row index by the normalized keys with radix sort, the rows with the same key are compared by
+// dataBlockCompar if the key does not cover all sort columns. Return false if the keys can not be used.
+static bool sortTupleIndexByKey(SSDataBlock* pDataBlock, SArray* pOrderInfo, const SSDataBlockSortHelper* pHelper,
+                                int32_t* index) {
+  int32_t rows = pDataBlock->info.rows;
+
+  SBlockSortKey key = {0};
+  blockDataGetSortKey(pDataBlock, pOrderInfo, &key);
+  if (key.keyLen == 0 || rows < SORT_KEY_MIN_ROWS) {
+    return false;
+  }
+
+  int32_t indexOffset = ALIGN_NUM(key.keyLen, sizeof(int32_t));
+  int32_t stride = indexOffset + sizeof(int32_t);
+  if ((int64_t)rows * stride > INT32_MAX / 2) {
+    return false;
+  }
+
+  char* buf = taosMemoryCalloc(rows, stride);
+  if (buf == NULL) {
+    return false;
+  }
+
+  blockDataEncodeSortKeys(pDataBlock, pOrderInfo, &key, buf, stride);
+  for (int32_t i = 0; i < rows; ++i) {
+    *(int32_t*)(buf + (int64_t)i * stride + indexOffset) = i;
+  }
+
+  SSortKeyComparParam param = {.pHelper = pHelper, .indexOffset = indexOffset};
+  if (taosRadixSort(buf, rows, stride, key.keyLen, &param, key.exact ? NULL : sortKeyTieCompar) != 0) {
+    taosMemoryFree(buf);
+    return false;
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    index[i] = *(int32_t*)(buf + (int64_t)i * stride + indexOffset);
+  }
+
+  taosMemoryFree(buf);
+  return true;
+}
+
+// sort the values of a var type column in place
+static int32_t varColSort(SColumnInfoData* pColumnInfoData, int32_t numOfRows, SBlockOrderInfo* pOrder) {
+  SSDataBlock block = {.pDataBlock = taosArrayInit(1, sizeof(SColumnInfoData))};
+  SArray*     pOrderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  int32_t*    index = createTupleIndex(numOfRows);
+  int32_t     code = TSDB_CODE_SUCCESS;
+  char*       pData = NULL;
+  if (block.pDataBlock == NULL || pOrderInfo == NULL || index == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  block.info.rows = numOfRows;
+  taosArrayPush(block.pDataBlock, pColumnInfoData);
+
+  SBlockOrderInfo order = *pOrder;
+  order.slotId = 0;
+  order.pColData = taosArrayGet(block.pDataBlock, 0);
+  taosArrayPush(pOrderInfo, &order);
+
+  SSDataBlockSortHelper helper = {.pDataBlock = &block, .orderInfo = pOrderInfo};
+  if (!sortTupleIndexByKey(&block, pOrderInfo, &helper, index)) {
+    terrno = 0;
+    taosqsort(index, numOfRows, sizeof(int32_t), &helper, dataBlockCompar);
+    if (terrno) {
+      code = terrno;
+      goto _exit;
+    }
+  }
+
+  // rebuild the data in the sorted order, which also drops the unused space
+  pData = taosMemoryMalloc(TMAX(pColumnInfoData->varmeta.length, 1));
+  if (pData == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  int32_t len = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_var(pColumnInfoData, index[i])) {
+      index[i] = -1;
+      continue;
+    }
+
+    char*   pVal = colDataGetVarData(pColumnInfoData, index[i]);
+    int32_t valLen = (pColumnInfoData->info.type == TSDB_DATA_TYPE_JSON) ? getJsonValueLen(pVal) : varDataTLen(pVal);
+    memcpy(pData + len, pVal, valLen);
+    index[i] = len;
+    len += valLen;
+  }
+
+  memcpy(pColumnInfoData->varmeta.offset, index, sizeof(int32_t) * numOfRows);
+  taosMemoryFree(pColumnInfoData->pData);
+  pColumnInfoData->pData = pData;
+  pColumnInfoData->varmeta.length = len;
+  pColumnInfoData->varmeta.allocLen = TMAX(pColumnInfoData->varmeta.length, 1);
+
+_exit:
+  taosArrayDestroy(block.pDataBlock);
+  taosArrayDestroy(pOrderInfo);
+  destroyTupleIndex(index);
+  return code;
+}
+
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   ASSERT(pDataBlock != NULL && pOrderInfo != NULL);
   if (pDataBlock->info.rows <= 1) {
@@ -930,6 +1227,14 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
 
         return TSDB_CODE_SUCCESS;
       } else {  // var data type
+        int64_t p0 = taosGetTimestampUs();
+
+        SColumnInfoData* pColInfoData = taosArrayGet(pDataBlock->pDataBlock, 0);
+        int32_t          code = varColSort(pColInfoData, rows, taosArrayGet(pOrderInfo, 0));
+
+        int64_t p1 = taosGetTimestampUs();
+        uDebug("blockDataSort var column cost:%" PRId64 ", rows:%d\n", p1 - p0, pDataBlock->info.rows);
+        return code;
       }
     } else if (numOfCols == 2) {
     }
@@ -949,9 +1254,11 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
     pInfo->pColData = taosArrayGet(pDataBlock->pDataBlock, pInfo->slotId);
   }
 
-  terrno = 0;
-  taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
-  if (terrno) return terrno;
+  if (!sortTupleIndexByKey(pDataBlock, pOrderInfo, &helper, index)) {
+    terrno = 0;
+    taosqsort(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
+    if (terrno) return terrno;
+  }
 
   int64_t p1 = taosGetTimestampUs();
 
@@ -1082,8 +1389,6 @@ int32_t dataBlockCompar_rv(const void* p1, const void* p2, const void* param) {
   return 0;
 }
 
-int32_t varColSort(SColumnInfoData* pColumnInfoData, SBlockOrderInfo* pOrder) { return 0; }
-
 int32_t blockDataSort_rv(SSDataBlock* pDataBlock, SArray* pOrderInfo, bool nullFirst) {
   // Allocate the additional buffer.
   int64_t p0 = taosGetTimestampUs();
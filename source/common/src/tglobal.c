@@ -60,6 +60,7 @@ int32_t tsNumOfVnodeQueryThreads = 4;
 int32_t tsNumOfVnodeStreamThreads = 2;
 int32_t tsNumOfVnodeFetchThreads = 4;
 int32_t tsNumOfVnodeWriteThreads = 2;
+int32_t tsNumOfVnodeReplayThreads = 0;
 int32_t tsNumOfVnodeSyncThreads = 2;
 int32_t tsNumOfVnodeRsmaThreads = 2;
 int32_t tsNumOfQnodeQueryThreads = 4;
@@ -92,6 +93,9 @@ bool tsSmlDataFormat =
 int32_t tsQueryPolicy = 1;
 int32_t tsQuerySmaOptimize = 0;
 bool    tsQueryPlannerTrace = false;
+bool    tsQueryLinearizable = false;  // read on vgroup leader under lease only
+int32_t tsQueryMaxStaleness = 0;      // ms, > 0 allows reading from vgroup followers
+int32_t tsQueryScanParallelism = 1;   // max scan workers of one query in a vnode, 1 means serial scan
 
 /*
  * denote if the server needs to compress response message at the application layer to client, including query rsp,
@@ -129,6 +133,10 @@ int32_t tsMinIntervalTime = 1;
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
 
+// the memory for the groups of the group by operators of a query, in MB. The rows of the groups beyond it are spilled
+// to disk and aggregated later. 0 means no limit (default)
+int32_t tsQueryGroupBufferSize = 0;
+
 int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
 
@@ -161,8 +169,13 @@ int32_t tsTransPullupInterval = 2;
 int32_t tsMqRebalanceInterval = 2;
 int32_t tsTtlUnit = 86400;
 int32_t tsTtlPushInterval = 86400;
+int32_t tsTtlBatchDropNum = 10000;  // number of tables dropped by one ttl batch, 0 means no limit
 int32_t tsGrantHBInterval = 60;
 int32_t tsUptimeInterval = 300;  // seconds
+bool    tsMetaWalMode = false;   // commit vnode meta through tdb wal instead of rollback journal
+bool    tsMetaTagCache = false;  // keep tag values of child tables in columnar arrays per super table
+bool    tsMetaMmapRead = false;  // serve meta page cache misses from a mapping of the db files
+bool    tsMetaSnapshotRead = false;  // meta readers read a snapshot of the pages instead of waiting for the writer
 char    tsUdfdResFuncs[1024] = ""; // udfd resident funcs that teardown when udfd exits
 
 #ifndef _STORAGE
@@ -285,6 +298,9 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryPolicy", tsQueryPolicy, 1, 3, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "querySmaOptimize", tsQuerySmaOptimize, 0, 1, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "queryPlannerTrace", tsQueryPlannerTrace, true) != 0) return -1;
+  if (cfgAddBool(pCfg, "queryLinearizable", tsQueryLinearizable, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryMaxStaleness", tsQueryMaxStaleness, 0, 3600 * 1000, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryScanParallelism", tsQueryScanParallelism, 1, 64, true) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
@@ -336,6 +352,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "maxNumOfDistinctRes", tsMaxNumOfDistinctResults, 10 * 10000, 10000 * 10000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "countAlwaysReturnValue", tsCountAlwaysReturnValue, 0, 1, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryGroupBufferSize", tsQueryGroupBufferSize, 0, 2047, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "multiProcess", tsMultiProcess, 0, 2, 0) != 0) return -1;
@@ -373,6 +390,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfVnodeWriteThreads = tsNumOfCores;
   tsNumOfVnodeWriteThreads = TMAX(tsNumOfVnodeWriteThreads, 1);
   if (cfgAddInt32(pCfg, "numOfVnodeWriteThreads", tsNumOfVnodeWriteThreads, 1, 1024, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfVnodeReplayThreads", tsNumOfVnodeReplayThreads, 0, 1024, 0) != 0) return -1;
 
   tsNumOfVnodeSyncThreads = tsNumOfCores * 2;
   tsNumOfVnodeSyncThreads = TMAX(tsNumOfVnodeSyncThreads, 16);
@@ -419,7 +437,12 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "mqRebalanceInterval", tsMqRebalanceInterval, 1, 10000, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "ttlUnit", tsTtlUnit, 1, 86400 * 365, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "ttlPushInterval", tsTtlPushInterval, 1, 100000, 1) != 0) return -1;
+  if (cfgAddInt32(pCfg, "ttlBatchDropNum", tsTtlBatchDropNum, 0, INT32_MAX, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "uptimeInterval", tsUptimeInterval, 1, 100000, 1) != 0) return -1;
+  if (cfgAddBool(pCfg, "metaWalMode", tsMetaWalMode, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "metaTagCache", tsMetaTagCache, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "metaMmapRead", tsMetaMmapRead, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "metaSnapshotRead", tsMetaSnapshotRead, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, 0) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, 0) != 0) return -1;
@@ -645,6 +668,9 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryPolicy = cfgGetItem(pCfg, "queryPolicy")->i32;
   tsQuerySmaOptimize = cfgGetItem(pCfg, "querySmaOptimize")->i32;
   tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
+  tsQueryLinearizable = cfgGetItem(pCfg, "queryLinearizable")->bval;
+  tsQueryMaxStaleness = cfgGetItem(pCfg, "queryMaxStaleness")->i32;
+  tsQueryScanParallelism = cfgGetItem(pCfg, "queryScanParallelism")->i32;
   return 0;
 }
 
@@ -676,6 +702,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMaxNumOfDistinctResults = cfgGetItem(pCfg, "maxNumOfDistinctRes")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsQueryGroupBufferSize = cfgGetItem(pCfg, "queryGroupBufferSize")->i32;
   tsPrintAuth = cfgGetItem(pCfg, "printAuth")->bval;
 
   tsMultiProcess = cfgGetItem(pCfg, "multiProcess")->bval;
@@ -692,6 +719,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsNumOfVnodeStreamThreads = cfgGetItem(pCfg, "numOfVnodeStreamThreads")->i32;
   tsNumOfVnodeFetchThreads = cfgGetItem(pCfg, "numOfVnodeFetchThreads")->i32;
   tsNumOfVnodeWriteThreads = cfgGetItem(pCfg, "numOfVnodeWriteThreads")->i32;
+  tsNumOfVnodeReplayThreads = cfgGetItem(pCfg, "numOfVnodeReplayThreads")->i32;
   tsNumOfVnodeSyncThreads = cfgGetItem(pCfg, "numOfVnodeSyncThreads")->i32;
   tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
   tsNumOfQnodeQueryThreads = cfgGetItem(pCfg, "numOfQnodeQueryThreads")->i32;
@@ -716,7 +744,12 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMqRebalanceInterval = cfgGetItem(pCfg, "mqRebalanceInterval")->i32;
   tsTtlUnit = cfgGetItem(pCfg, "ttlUnit")->i32;
   tsTtlPushInterval = cfgGetItem(pCfg, "ttlPushInterval")->i32;
+  tsTtlBatchDropNum = cfgGetItem(pCfg, "ttlBatchDropNum")->i32;
   tsUptimeInterval = cfgGetItem(pCfg, "uptimeInterval")->i32;
+  tsMetaWalMode = cfgGetItem(pCfg, "metaWalMode")->bval;
+  tsMetaTagCache = cfgGetItem(pCfg, "metaTagCache")->bval;
+  tsMetaMmapRead = cfgGetItem(pCfg, "metaMmapRead")->bval;
+  tsMetaSnapshotRead = cfgGetItem(pCfg, "metaSnapshotRead")->bval;
 
   tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
   tstrncpy(tsUdfdResFuncs, cfgGetItem(pCfg, "udfdResFuncs")->str, sizeof(tsUdfdResFuncs));
@@ -938,6 +971,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsNumOfVnodeFetchThreads = cfgGetItem(pCfg, "numOfVnodeFetchThreads")->i32;
       } else if (strcasecmp("numOfVnodeWriteThreads", name) == 0) {
         tsNumOfVnodeWriteThreads = cfgGetItem(pCfg, "numOfVnodeWriteThreads")->i32;
+      } else if (strcasecmp("numOfVnodeReplayThreads", name) == 0) {
+        tsNumOfVnodeReplayThreads = cfgGetItem(pCfg, "numOfVnodeReplayThreads")->i32;
       } else if (strcasecmp("numOfVnodeSyncThreads", name) == 0) {
         tsNumOfVnodeSyncThreads = cfgGetItem(pCfg, "numOfVnodeSyncThreads")->i32;
       } else if (strcasecmp("numOfVnodeRsmaThreads", name) == 0) {
@@ -973,12 +1008,20 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         if (tsQueryBufferSize >= 0) {
           tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
         }
+      } else if (strcasecmp("queryGroupBufferSize", name) == 0) {
+        tsQueryGroupBufferSize = cfgGetItem(pCfg, "queryGroupBufferSize")->i32;
       } else if (strcasecmp("qnodeShmSize", name) == 0) {
         tsQnodeShmSize = cfgGetItem(pCfg, "qnodeShmSize")->i32;
       } else if (strcasecmp("qDebugFlag", name) == 0) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
         tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
+      } else if (strcasecmp("queryLinearizable", name) == 0) {
+        tsQueryLinearizable = cfgGetItem(pCfg, "queryLinearizable")->bval;
+      } else if (strcasecmp("queryMaxStaleness", name) == 0) {
+        tsQueryMaxStaleness = cfgGetItem(pCfg, "queryMaxStaleness")->i32;
+      } else if (strcasecmp("queryScanParallelism", name) == 0) {
+        tsQueryScanParallelism = cfgGetItem(pCfg, "queryScanParallelism")->i32;
       }
       break;
     }
@@ -1060,6 +1103,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsTtlUnit = cfgGetItem(pCfg, "ttlUnit")->i32;
       } else if (strcasecmp("ttlPushInterval", name) == 0) {
         tsTtlPushInterval = cfgGetItem(pCfg, "ttlPushInterval")->i32;
+      } else if (strcasecmp("ttlBatchDropNum", name) == 0) {
+        tsTtlBatchDropNum = cfgGetItem(pCfg, "ttlBatchDropNum")->i32;
       } else if (strcasecmp("tmrDebugFlag", name) == 0) {
         tmrDebugFlag = cfgGetItem(pCfg, "tmrDebugFlag")->i32;
       } else if (strcasecmp("tsdbDebugFlag", name) == 0) {
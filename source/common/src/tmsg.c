@@ -2732,6 +2732,7 @@ int32_t tSerializeSVDropTtlTableReq(void *buf, int32_t bufLen, SVDropTtlTableReq
 
   if (tStartEncode(&encoder) < 0) return -1;
   if (tEncodeI32(&encoder, pReq->timestamp) < 0) return -1;
+  if (tEncodeI32(&encoder, pReq->batchNum) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -2745,6 +2746,11 @@ int32_t tDeserializeSVDropTtlTableReq(void *buf, int32_t bufLen, SVDropTtlTableR
 
   if (tStartDecode(&decoder) < 0) return -1;
   if (tDecodeI32(&decoder, &pReq->timestamp) < 0) return -1;
+  // requests of older mnodes carry no batch size
+  pReq->batchNum = 0;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI32(&decoder, &pReq->batchNum) < 0) return -1;
+  }
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -4299,6 +4305,30 @@ int32_t tDeserializeSServerStatusRsp(void *buf, int32_t bufLen, SServerStatusRsp
   tDecoderClear(&decoder);
   return 0;
 }
+
+// the extension is written field by field, a receiver reads only the fields the sender had
+int32_t tPutSubQueryMsgExt(uint8_t *p, const SSubQueryMsgExt *pExt) {
+  int32_t n = 0;
+  n += tPutI8(p ? p + n : p, pExt->linearizable);
+  n += tPutI32(p ? p + n : p, htonl(pExt->maxStaleMs));
+  return n;
+}
+
+// pMsg is in host order, i.e. after qWorkerPreprocessQueryMsg
+void tGetSubQueryMsgExt(const SSubQueryMsg *pMsg, int32_t contLen, SSubQueryMsgExt *pExt) {
+  memset(pExt, 0, sizeof(*pExt));
+
+  int64_t  extLen = (int64_t)contLen - sizeof(SSubQueryMsg) - pMsg->sqlLen - pMsg->phyLen;
+  uint8_t *p = (uint8_t *)pMsg->msg + pMsg->sqlLen + pMsg->phyLen;
+  int32_t  n = 0;
+
+  if (extLen >= n + sizeof(int8_t)) n += tGetI8(p + n, &pExt->linearizable);
+  if (extLen >= n + sizeof(int32_t)) {
+    n += tGetI32(p + n, &pExt->maxStaleMs);
+    pExt->maxStaleMs = ntohl(pExt->maxStaleMs);
+  }
+}
+
 int32_t tEncodeSMqOffset(SEncoder *encoder, const SMqOffset *pOffset) {
   if (tEncodeI32(encoder, pOffset->vgId) < 0) return -1;
   if (tEncodeI64(encoder, pOffset->offset) < 0) return -1;
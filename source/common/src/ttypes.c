@@ -423,13 +423,17 @@ char tTokenTypeSwitcher[13] = {
     TSDB_DATA_TYPE_NCHAR,    // TK_NCHAR
 };
 
-float  floatMin = -FLT_MAX, floatMax = FLT_MAX;
+// in 8 bytes, as the filter copies the bounds of every type as an int64_t
+union {
+  float   f;
+  int64_t i;
+} floatMin = {.f = -FLT_MAX}, floatMax = {.f = FLT_MAX};
 double doubleMin = -DBL_MAX, doubleMax = DBL_MAX;
 
 FORCE_INLINE void *getDataMin(int32_t type) {
   switch (type) {
     case TSDB_DATA_TYPE_FLOAT:
-      return &floatMin;
+      return &floatMin.f;
     case TSDB_DATA_TYPE_DOUBLE:
       return &doubleMin;
     default:
@@ -440,7 +444,7 @@ FORCE_INLINE void *getDataMin(int32_t type) {
 FORCE_INLINE void *getDataMax(int32_t type) {
   switch (type) {
     case TSDB_DATA_TYPE_FLOAT:
-      return &floatMax;
+      return &floatMax.f;
     case TSDB_DATA_TYPE_DOUBLE:
       return &doubleMax;
     default:
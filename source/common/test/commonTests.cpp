@@ -10,8 +10,10 @@
 
 #include "taos.h"
 #include "tcommon.h"
+#include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
+#include "tmsg.h"
 #include "tvariant.h"
 
 namespace {
@@ -154,6 +156,140 @@ TEST(testCase, Datablock_test) {
   taosArrayDestroy(pOrderInfo);
 }
 
+static int32_t compareSortedRow(SSDataBlock* pBlock, SArray* pOrderInfo, int32_t r1, int32_t r2) {
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = (SBlockOrderInfo*)taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    bool null1 = colDataIsNull_s(pCol, r1);
+    bool null2 = colDataIsNull_s(pCol, r2);
+    if (null1 && null2) {
+      continue;
+    } else if (null1 || null2) {
+      return (null1 == pOrder->nullFirst) ? -1 : 1;
+    }
+
+    __compar_fn_t fn = getKeyComparFunc(pCol->info.type, pOrder->order);
+    int32_t       ret = fn(colDataGetData(pCol, r1), colDataGetData(pCol, r2));
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+static SSDataBlock* createSortTestBlock(int32_t numOfRows) {
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData col0 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  SColumnInfoData col1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40 + VARSTR_HEADER_SIZE, 2);
+  SColumnInfoData col2 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 3);
+  SColumnInfoData col3 = createColumnInfoData(TSDB_DATA_TYPE_NCHAR, 80 + VARSTR_HEADER_SIZE, 4);
+  blockDataAppendColInfo(b, &col0);
+  blockDataAppendColInfo(b, &col1);
+  blockDataAppendColInfo(b, &col2);
+  blockDataAppendColInfo(b, &col3);
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[128] = {0};
+  taosSeedRand(1);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t v = (int32_t)(taosRand() % 100) - 50;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&v, (i % 7) == 0);
+
+    // the strings share a long prefix, and some of them are the prefix of others
+    int32_t len = snprintf(varDataVal(buf), 41, "the common prefix of a string:%d", taosRand() % 50);
+    varDataSetLen(buf, len - (i % 3));
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, buf, (i % 11) == 0);
+
+    double d = ((int32_t)(taosRand() % 200) - 100) / 3.0;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, false);
+
+    len = taosRand() % 80;
+    for (int32_t j = 0; j < len; ++j) {
+      varDataVal(buf)[j] = taosRand() % 2;
+    }
+    varDataSetLen(buf, len);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 3), i, buf, false);
+    b->info.rows++;
+  }
+
+  return b;
+}
+
+TEST(testCase, blockDataSort_test) {
+  int32_t numOfRows = 5000;
+
+  // {slotId, order, nullFirst} of the sort columns
+  int32_t cases[][3][3] = {
+      {{0, TSDB_ORDER_ASC, 1}, {1, TSDB_ORDER_DESC, 0}, {-1}},
+      {{1, TSDB_ORDER_ASC, 1}, {0, TSDB_ORDER_DESC, 0}, {-1}},
+      {{2, TSDB_ORDER_DESC, 0}, {0, TSDB_ORDER_ASC, 1}, {-1}},
+      {{3, TSDB_ORDER_ASC, 0}, {0, TSDB_ORDER_ASC, 0}, {-1}},
+      {{0, TSDB_ORDER_DESC, 1}, {2, TSDB_ORDER_ASC, 0}, {1, TSDB_ORDER_ASC, 0}},
+  };
+
+  for (int32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+    SSDataBlock* b = createSortTestBlock(numOfRows);
+    SArray*      pOrderInfo = taosArrayInit(3, sizeof(SBlockOrderInfo));
+    for (int32_t i = 0; i < 3 && cases[c][i][0] >= 0; ++i) {
+      SBlockOrderInfo order = {cases[c][i][2] == 1, cases[c][i][1], cases[c][i][0], NULL};
+      taosArrayPush(pOrderInfo, &order);
+    }
+
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+    double           sum = 0;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      sum += *(double*)colDataGetData(pCol, i);
+    }
+
+    ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+    ASSERT_EQ(b->info.rows, numOfRows);
+
+    pCol = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+    double sum1 = 0;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      sum1 += *(double*)colDataGetData(pCol, i);
+      if (i > 0) {
+        ASSERT_LE(compareSortedRow(b, pOrderInfo, i - 1, i), 0);
+      }
+    }
+    ASSERT_NEAR(sum, sum1, 1e-6);
+
+    taosArrayDestroy(pOrderInfo);
+    blockDataDestroy(b);
+  }
+}
+
+TEST(testCase, var_column_sort_test) {
+  int32_t      numOfRows = 1000;
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40 + VARSTR_HEADER_SIZE, 1);
+  blockDataAppendColInfo(b, &col);
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[64] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t len = snprintf(varDataVal(buf), 41, "%d", (i * 7919) % numOfRows);
+    varDataSetLen(buf, len);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, buf, false);
+    b->info.rows++;
+  }
+
+  SArray*         pOrderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order = {true, TSDB_ORDER_DESC, 0, NULL};
+  taosArrayPush(pOrderInfo, &order);
+
+  ASSERT_EQ(blockDataSort(b, pOrderInfo), 0);
+  for (int32_t i = 1; i < numOfRows; ++i) {
+    ASSERT_LT(compareSortedRow(b, pOrderInfo, i - 1, i), 0);
+  }
+
+  taosArrayDestroy(pOrderInfo);
+  blockDataDestroy(b);
+}
+
 #if 0
 TEST(testCase, non_var_dataBlock_split_test) {
   SSDataBlock* b = static_cast<SSDataBlock*>(taosMemoryCalloc(1, sizeof(SSDataBlock)));
@@ -260,4 +396,68 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, subQueryMsgExt_test) {
+  const char* sql = "select * from t";
+  const char* plan = "{\"NodeType\":\"1\"}";
+  uint32_t    sqlLen = strlen(sql);
+  uint32_t    phyLen = strlen(plan);
+
+  SSubQueryMsgExt ext = {.linearizable = 1, .maxStaleMs = 3000};
+  int32_t         extLen = tPutSubQueryMsgExt(NULL, &ext);
+  int32_t         contLen = sizeof(SSubQueryMsg) + sqlLen + phyLen + extLen;
+
+  SSubQueryMsg* pMsg = (SSubQueryMsg*)taosMemoryCalloc(1, contLen);
+  pMsg->sqlLen = sqlLen;
+  pMsg->phyLen = phyLen;
+  memcpy(pMsg->msg, sql, sqlLen);
+  memcpy(pMsg->msg + sqlLen, plan, phyLen);
+  ASSERT_EQ(tPutSubQueryMsgExt((uint8_t*)pMsg->msg + sqlLen + phyLen, &ext), extLen);
+
+  SSubQueryMsgExt ext2 = {0};
+  tGetSubQueryMsgExt(pMsg, contLen, &ext2);
+  ASSERT_EQ(ext2.linearizable, 1);
+  ASSERT_EQ(ext2.maxStaleMs, 3000);
+
+  // sent by a version that knew only the first field
+  tGetSubQueryMsgExt(pMsg, contLen - sizeof(int32_t), &ext2);
+  ASSERT_EQ(ext2.linearizable, 1);
+  ASSERT_EQ(ext2.maxStaleMs, 0);
+
+  // sent by an older version, nothing after the plan
+  tGetSubQueryMsgExt(pMsg, contLen - extLen, &ext2);
+  ASSERT_EQ(ext2.linearizable, 0);
+  ASSERT_EQ(ext2.maxStaleMs, 0);
+
+  taosMemoryFree(pMsg);
+}
+
+TEST(testCase, dropTtlTableReq_test) {
+  SVDropTtlTableReq req = {.timestamp = 1234567, .batchNum = 500};
+  int32_t           len = tSerializeSVDropTtlTableReq(NULL, 0, &req);
+  char*             buf = (char*)taosMemoryCalloc(1, len);
+  ASSERT_EQ(tSerializeSVDropTtlTableReq(buf, len, &req), len);
+
+  // a continuation is built from the decoded request, so it keeps the batch size of the mnode
+  SVDropTtlTableReq req2 = {0};
+  ASSERT_EQ(tDeserializeSVDropTtlTableReq(buf, len, &req2), 0);
+  ASSERT_EQ(req2.timestamp, 1234567);
+  ASSERT_EQ(req2.batchNum, 500);
+  taosMemoryFree(buf);
+
+  // sent by an older mnode, no batch size means no limit
+  char     old[64] = {0};
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, (uint8_t*)old, sizeof(old));
+  ASSERT_EQ(tStartEncode(&encoder), 0);
+  ASSERT_EQ(tEncodeI32(&encoder, 7654321), 0);
+  tEndEncode(&encoder);
+  len = encoder.pos;
+  tEncoderClear(&encoder);
+
+  req2.batchNum = -1;
+  ASSERT_EQ(tDeserializeSVDropTtlTableReq(old, len, &req2), 0);
+  ASSERT_EQ(req2.timestamp, 7654321);
+  ASSERT_EQ(req2.batchNum, 0);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
@@ -51,6 +51,8 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   int64_t numOfInsertSuccessReqs = 0;
   int64_t numOfBatchInsertReqs = 0;
   int64_t numOfBatchInsertSuccessReqs = 0;
+  int64_t numOfSchemaCacheHits = 0;
+  int64_t numOfSchemaCacheMisses = 0;
 
   for (int32_t i = 0; i < taosArrayGetSize(pVloads); ++i) {
     SVnodeLoad *pLoad = taosArrayGet(pVloads, i);
@@ -59,6 +61,8 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
     numOfInsertSuccessReqs += pLoad->numOfInsertSuccessReqs;
     numOfBatchInsertReqs += pLoad->numOfBatchInsertReqs;
     numOfBatchInsertSuccessReqs += pLoad->numOfBatchInsertSuccessReqs;
+    numOfSchemaCacheHits += pLoad->numOfSchemaCacheHits;
+    numOfSchemaCacheMisses += pLoad->numOfSchemaCacheMisses;
     if (pLoad->syncState == TAOS_SYNC_STATE_LEADER) masterNum++;
     totalVnodes++;
   }
@@ -70,6 +74,8 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pInfo->vstat.numOfInsertSuccessReqs = numOfInsertSuccessReqs - pMgmt->state.numOfInsertSuccessReqs;
   pInfo->vstat.numOfBatchInsertReqs = numOfBatchInsertReqs - pMgmt->state.numOfBatchInsertReqs;
   pInfo->vstat.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs - pMgmt->state.numOfBatchInsertSuccessReqs;
+  pInfo->vstat.numOfSchemaCacheHits = numOfSchemaCacheHits - pMgmt->state.numOfSchemaCacheHits;
+  pInfo->vstat.numOfSchemaCacheMisses = numOfSchemaCacheMisses - pMgmt->state.numOfSchemaCacheMisses;
   pMgmt->state.totalVnodes = totalVnodes;
   pMgmt->state.masterNum = masterNum;
   pMgmt->state.numOfSelectReqs = numOfSelectReqs;
@@ -77,6 +83,8 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pMgmt->state.numOfInsertSuccessReqs = numOfInsertSuccessReqs;
   pMgmt->state.numOfBatchInsertReqs = numOfBatchInsertReqs;
   pMgmt->state.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs;
+  pMgmt->state.numOfSchemaCacheHits = numOfSchemaCacheHits;
+  pMgmt->state.numOfSchemaCacheMisses = numOfSchemaCacheMisses;
 
   tfsGetMonitorInfo(pMgmt->pTfs, &pInfo->tfs);
   taosArrayDestroy(pVloads);
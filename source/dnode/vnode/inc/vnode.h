@@ -93,6 +93,9 @@ void        metaReaderInit(SMetaReader *pReader, SMeta *pMeta, int32_t flags);
 void        metaReaderClear(SMetaReader *pReader);
 int32_t     metaGetTableEntryByUid(SMetaReader *pReader, tb_uid_t uid);
 int32_t     metaGetTableTags(SMeta *pMeta, uint64_t suid, SArray *uidList, SHashObj *tags);
+// served from the columnar tag cache of the super table, TSDB_CODE_NOT_FOUND if it is off or cannot serve the column
+int32_t     metaGetTagCacheUidList(SMeta *pMeta, uint64_t suid, SArray *uidList);
+int32_t     metaGetTagCacheCol(SMeta *pMeta, uint64_t suid, SArray *uidList, int16_t cid, SColumnInfoData *pColData);
 int32_t     metaReadNext(SMetaReader *pReader);
 const void *metaGetTableTagVal(void *tag, int16_t type, STagVal *tagVal);
 int         metaGetTableNameByUid(void *meta, uint64_t uid, char *tbName);
@@ -104,11 +107,14 @@ typedef struct SMetaFltParam {
   int16_t  type;
   void    *val;
   bool     reverse;
+  bool     equal;  // filterFunc tests equality, the scan ends once past val
   int (*filterFunc)(void *a, void *b, int16_t type);
 
 } SMetaFltParam;
 
 int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *results);
+// conjunction of conditions of one super table, results are sorted by uid
+int32_t metaFilterTableIdsMulti(SMeta *pMeta, SMetaFltParam *params, int32_t nParam, SArray *results);
 
 #if 1  // refact APIs below (TODO)
 typedef SVCreateTbReq   STbCfg;
@@ -144,6 +150,7 @@ bool     tsdbNextDataBlock(STsdbReader *pReader);
 void     tsdbRetrieveDataBlockInfo(STsdbReader *pReader, SDataBlockInfo *pDataBlockInfo);
 int32_t  tsdbRetrieveDatablockSMA(STsdbReader *pReader, SColumnDataAgg ***pBlockStatis, bool *allHave);
 SArray  *tsdbRetrieveDataBlock(STsdbReader *pTsdbReadHandle, SArray *pColumnIdList);
+SArray  *tsdbRetrieveDataBlockRest(STsdbReader *pReader, const int8_t *pSelect);
 int32_t  tsdbReaderReset(STsdbReader *pReader, SQueryTableDataCond *pCond);
 int32_t  tsdbGetFileBlocksDistInfo(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
 int64_t  tsdbGetNumOfRowsInMemTable(STsdbReader *pHandle);
@@ -344,6 +351,7 @@ struct SMetaEntry {
 struct SMetaReader {
   int32_t    flags;
   SMeta     *pMeta;
+  TSNAP     *pSnap;  // pinned by the reader itself with snapshot reads
   SDecoder   coder;
   SMetaEntry me;
   void      *pBuf;
@@ -26,6 +26,7 @@ extern "C" {
 typedef struct SMetaIdx   SMetaIdx;
 typedef struct SMetaDB    SMetaDB;
 typedef struct SMetaCache SMetaCache;
+typedef struct SMetaBulk  SMetaBulk;
 
 // metaDebug ==================
 // clang-format off
@@ -66,6 +67,13 @@ int32_t metaCacheOpen(SMeta* pMeta);
 void    metaCacheClose(SMeta* pMeta);
 int32_t metaCacheUpsert(SMeta* pMeta, SMetaInfo* pInfo);
 int32_t metaCacheDrop(SMeta* pMeta, int64_t uid);
+int32_t metaSchemaCacheGet(SMeta* pMeta, int64_t uid, int32_t sver, STSchema** ppTSchema);
+int32_t metaSchemaCacheInsert(SMeta* pMeta, int64_t uid, const STSchema* pTSchema);
+void    metaSchemaCacheDrop(SMeta* pMeta, int64_t uid);
+bool    metaTagCacheHas(SMeta* pMeta, tb_uid_t suid);
+int32_t metaTagCacheUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag);
+void    metaTagCacheDel(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid);
+void    metaTagCacheDrop(SMeta* pMeta, tb_uid_t suid);
 
 struct SMeta {
   TdThreadRwlock lock;
@@ -93,6 +101,15 @@ struct SMeta {
   SMetaIdx* pIdx;
 
   SMetaCache* pCache;
+
+  SMetaBulk* pBulk;  // tables created are collected and bulk loaded when set
+
+  int8_t inCheckpoint;  // background tdb wal checkpoint is running
+  int8_t snapRead;      // readers pin a tdb snapshot instead of taking the lock
+
+  // with snapshot reads, the thread holding the lock to write and the metaRLock() calls it nested in it
+  int64_t wrThread;
+  int32_t wrRead;
 };
 
 typedef struct {
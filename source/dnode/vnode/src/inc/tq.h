@@ -102,6 +102,7 @@ typedef struct {
   int64_t snapshotVer;
 
   SWalReader* pWalReader;
+  SWalCkHead* pMetaCkHead;  // private copy of meta logs, which may be rewritten by the table filter
 
   SWalRef* pRef;
 
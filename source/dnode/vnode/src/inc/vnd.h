@@ -93,6 +93,9 @@ int32_t vnodeLoadInfo(const char* dir, SVnodeInfo* pInfo);
 int32_t vnodeSyncCommit(SVnode* pVnode);
 int32_t vnodeAsyncCommit(SVnode* pVnode);
 
+// vnodeReplay.c
+int32_t vnodeReplayWal(SVnode* pVnode);
+
 // vnodeSync.c
 int32_t vnodeSyncOpen(SVnode* pVnode, char* path);
 void    vnodeSyncStart(SVnode* pVnode);
@@ -100,6 +103,8 @@ void    vnodeSyncClose(SVnode* pVnode);
 void    vnodeRedirectRpcMsg(SVnode* pVnode, SRpcMsg* pMsg);
 bool    vnodeIsLeader(SVnode* pVnode);
 bool    vnodeIsReadyForRead(SVnode* pVnode);
+bool    vnodeIsReadyForLeaseRead(SVnode* pVnode);
+bool    vnodeIsReadyForStaleRead(SVnode* pVnode, int32_t maxStaleMs);
 bool    vnodeIsRoleLeader(SVnode* pVnode);
 
 #ifdef __cplusplus
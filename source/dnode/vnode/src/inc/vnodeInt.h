@@ -104,8 +104,10 @@ int             metaCreateSTable(SMeta* pMeta, int64_t version, SVCreateStbReq*
 int             metaAlterSTable(SMeta* pMeta, int64_t version, SVCreateStbReq* pReq);
 int             metaDropSTable(SMeta* pMeta, int64_t verison, SVDropStbReq* pReq, SArray* tbUidList);
 int             metaCreateTable(SMeta* pMeta, int64_t version, SVCreateTbReq* pReq, STableMetaRsp** pMetaRsp);
+int32_t         metaBulkBegin(SMeta* pMeta);
+int32_t         metaBulkEnd(SMeta* pMeta);
 int             metaDropTable(SMeta* pMeta, int64_t version, SVDropTbReq* pReq, SArray* tbUids, int64_t* tbUid);
-int             metaTtlDropTable(SMeta* pMeta, int64_t ttl, SArray* tbUids);
+int             metaTtlDropTable(SMeta* pMeta, int64_t ttl, int32_t maxNum, SArray* tbUids, bool* pMore);
 int             metaAlterTable(SMeta* pMeta, int64_t version, SVAlterTbReq* pReq, STableMetaRsp* pMetaRsp);
 SSchemaWrapper* metaGetTableSchema(SMeta* pMeta, tb_uid_t uid, int32_t sver, bool isinline);
 STSchema*       metaGetTbTSchema(SMeta* pMeta, tb_uid_t uid, int32_t sver);
@@ -126,7 +128,7 @@ SArray*         metaGetSmaIdsByTable(SMeta* pMeta, tb_uid_t uid);
 SArray*         metaGetSmaTbUids(SMeta* pMeta);
 void*           metaGetIdx(SMeta* pMeta);
 void*           metaGetIvtIdx(SMeta* pMeta);
-int             metaTtlSmaller(SMeta* pMeta, uint64_t time, SArray* uidList);
+int             metaTtlSmaller(SMeta* pMeta, uint64_t time, int32_t maxNum, SArray* uidList, bool* pMore);
 
 int32_t metaCreateTSma(SMeta* pMeta, int64_t version, SSmaCfg* pCfg);
 int32_t metaDropTSma(SMeta* pMeta, int64_t indexUid);
@@ -138,6 +140,7 @@ typedef struct SMetaInfo {
   int32_t skmVer;
 } SMetaInfo;
 int32_t metaGetInfo(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo);
+void    metaGetSchemaCacheStat(SMeta* pMeta, int64_t* nHit, int64_t* nMiss);
 
 // tsdb
 int         tsdbOpen(SVnode* pVnode, STsdb** ppTsdb, const char* dir, STsdbKeepCfg* pKeepCfg);
@@ -380,6 +383,7 @@ enum {
   SNAP_DATA_TQ_OFFSET = 8,
   SNAP_DATA_STREAM_TASK = 9,
   SNAP_DATA_STREAM_STATE = 10,
+  SNAP_DATA_TSDB_FILE = 11,  // whole tsdb data file set, full snapshot only
 };
 
 struct SSnapDataHdr {
@@ -16,6 +16,11 @@
 
 #define META_CACHE_BASE_BUCKET 1024
 
+#define META_SCHEMA_CACHE_BUCKET    1024
+#define META_SCHEMA_CACHE_MAX_ENTRY (META_SCHEMA_CACHE_BUCKET * 8)
+
+#define META_TAG_CACHE_MIN_CAP 1024
+
 // (uid , suid) : child table
 // (uid,     0) : normal table
 // (suid, suid) : super table
@@ -25,12 +30,67 @@ struct SMetaCacheEntry {
   SMetaInfo        info;
 };
 
+// (uid, sver) : built STSchema of a super table (uid is suid) or a normal table, shared by all child tables
+typedef struct SSchemaCacheEntry SSchemaCacheEntry;
+struct SSchemaCacheEntry {
+  SSchemaCacheEntry* next;
+  int64_t            uid;
+  int32_t            sver;
+  volatile int32_t   nRef;
+  STSchema*          pTSchema;
+};
+
+// tag values of all child tables of a super table, one column per tag indexed by a dense child ordinal. A dropped
+// child is replaced by the last one, so the ordinals stay dense. Ordinals follow the uid order of ctb.idx as long as
+// sorted is set, readers of the uid list sort them back when it is not.
+typedef struct {
+  SColumnInfoData data;   // info.colId is the tag cid
+  int64_t         nLive;  // payload bytes still referenced by a child, for var types
+} STagCacheCol;
+
+typedef struct {
+  int32_t      nChild;
+  int32_t      cap;
+  bool         sorted;
+  tb_uid_t*    aUid;  // child ordinal -> uid
+  SHashObj*    pOrd;  // uid -> child ordinal
+  int32_t      nCol;
+  STagCacheCol aCol[];
+} STagCache;
+
 struct SMetaCache {
+  // table info cache, changed under the meta write lock, its own lock is for the readers out of the meta lock when
+  // they read snapshots
+  TdThreadRwlock    lock;
   int32_t           nEntry;
   int32_t           nBucket;
   SMetaCacheEntry** aBucket;
+
+  // schema cache, protected by its own lock
+  struct {
+    TdThreadRwlock      lock;
+    int32_t             nEntry;
+    SSchemaCacheEntry** aBucket;
+    int64_t             nHit;
+    int64_t             nMiss;
+  } sCache;
+
+  // columnar tag cache, built on first use, protected by its own lock
+  struct {
+    TdThreadRwlock lock;
+    SHashObj*      pStb;  // suid -> STagCache*
+  } tCache;
 };
 
+static void metaTagCacheFree(STagCache* pTagCache);
+
+static void metaSchemaCacheUnref(SSchemaCacheEntry* pEntry) {
+  if (atomic_sub_fetch_32(&pEntry->nRef, 1) == 0) {
+    taosMemoryFree(pEntry->pTSchema);
+    taosMemoryFree(pEntry);
+  }
+}
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
@@ -49,6 +109,32 @@ int32_t metaCacheOpen(SMeta* pMeta) {
     taosMemoryFree(pCache);
     goto _err;
   }
+  taosThreadRwlockInit(&pCache->lock, NULL);
+
+  pCache->sCache.nEntry = 0;
+  pCache->sCache.nHit = 0;
+  pCache->sCache.nMiss = 0;
+  pCache->sCache.aBucket = (SSchemaCacheEntry**)taosMemoryCalloc(META_SCHEMA_CACHE_BUCKET, sizeof(SSchemaCacheEntry*));
+  if (pCache->sCache.aBucket == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    taosThreadRwlockDestroy(&pCache->lock);
+    taosMemoryFree(pCache->aBucket);
+    taosMemoryFree(pCache);
+    goto _err;
+  }
+  taosThreadRwlockInit(&pCache->sCache.lock, NULL);
+
+  pCache->tCache.pStb = taosHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pCache->tCache.pStb == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    taosThreadRwlockDestroy(&pCache->sCache.lock);
+    taosMemoryFree(pCache->sCache.aBucket);
+    taosThreadRwlockDestroy(&pCache->lock);
+    taosMemoryFree(pCache->aBucket);
+    taosMemoryFree(pCache);
+    goto _err;
+  }
+  taosThreadRwlockInit(&pCache->tCache.lock, NULL);
 
   pMeta->pCache = pCache;
 
@@ -71,6 +157,28 @@ void metaCacheClose(SMeta* pMeta) {
       }
     }
     taosMemoryFree(pMeta->pCache->aBucket);
+    taosThreadRwlockDestroy(&pMeta->pCache->lock);
+
+    metaDebug("vgId:%d schema cache hit:%" PRId64 " miss:%" PRId64, TD_VID(pMeta->pVnode), pMeta->pCache->sCache.nHit,
+              pMeta->pCache->sCache.nMiss);
+    for (int32_t iBucket = 0; iBucket < META_SCHEMA_CACHE_BUCKET; iBucket++) {
+      SSchemaCacheEntry* pEntry = pMeta->pCache->sCache.aBucket[iBucket];
+      while (pEntry) {
+        SSchemaCacheEntry* tEntry = pEntry->next;
+        metaSchemaCacheUnref(pEntry);
+        pEntry = tEntry;
+      }
+    }
+    taosMemoryFree(pMeta->pCache->sCache.aBucket);
+    taosThreadRwlockDestroy(&pMeta->pCache->sCache.lock);
+
+    for (void* pIter = taosHashIterate(pMeta->pCache->tCache.pStb, NULL); pIter;
+         pIter = taosHashIterate(pMeta->pCache->tCache.pStb, pIter)) {
+      metaTagCacheFree(*(STagCache**)pIter);
+    }
+    taosHashCleanup(pMeta->pCache->tCache.pStb);
+    taosThreadRwlockDestroy(&pMeta->pCache->tCache.lock);
+
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -121,7 +229,9 @@ int32_t metaCacheUpsert(SMeta* pMeta, SMetaInfo* pInfo) {
   // ASSERT(metaIsWLocked(pMeta));
 
   // search
-  SMetaCache*       pCache = pMeta->pCache;
+  SMetaCache* pCache = pMeta->pCache;
+  taosThreadRwlockWrlock(&pCache->lock);
+
   int32_t           iBucket = TABS(pInfo->uid) % pCache->nBucket;
   SMetaCacheEntry** ppEntry = &pCache->aBucket[iBucket];
   while (*ppEntry && (*ppEntry)->info.uid != pInfo->uid) {
@@ -155,13 +265,16 @@ int32_t metaCacheUpsert(SMeta* pMeta, SMetaInfo* pInfo) {
   }
 
 _exit:
+  taosThreadRwlockUnlock(&pCache->lock);
   return code;
 }
 
 int32_t metaCacheDrop(SMeta* pMeta, int64_t uid) {
   int32_t code = 0;
 
-  SMetaCache*       pCache = pMeta->pCache;
+  SMetaCache* pCache = pMeta->pCache;
+  taosThreadRwlockWrlock(&pCache->lock);
+
   int32_t           iBucket = TABS(uid) % pCache->nBucket;
   SMetaCacheEntry** ppEntry = &pCache->aBucket[iBucket];
   while (*ppEntry && (*ppEntry)->info.uid != uid) {
@@ -182,13 +295,16 @@ int32_t metaCacheDrop(SMeta* pMeta, int64_t uid) {
   }
 
 _exit:
+  taosThreadRwlockUnlock(&pCache->lock);
   return code;
 }
 
 int32_t metaCacheGet(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo) {
   int32_t code = 0;
 
-  SMetaCache*      pCache = pMeta->pCache;
+  SMetaCache* pCache = pMeta->pCache;
+  taosThreadRwlockRdlock(&pCache->lock);
+
   int32_t          iBucket = TABS(uid) % pCache->nBucket;
   SMetaCacheEntry* pEntry = pCache->aBucket[iBucket];
 
@@ -202,5 +318,679 @@ int32_t metaCacheGet(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo) {
     code = TSDB_CODE_NOT_FOUND;
   }
 
+  taosThreadRwlockUnlock(&pCache->lock);
+  return code;
+}
+
+int32_t metaSchemaCacheGet(SMeta* pMeta, int64_t uid, int32_t sver, STSchema** ppTSchema) {
+  int32_t code = 0;
+
+  SMetaCache*        pCache = pMeta->pCache;
+  SSchemaCacheEntry* pEntry;
+
+  taosThreadRwlockRdlock(&pCache->sCache.lock);
+  pEntry = pCache->sCache.aBucket[TABS(uid) % META_SCHEMA_CACHE_BUCKET];
+  while (pEntry && (pEntry->uid != uid || pEntry->sver != sver)) {
+    pEntry = pEntry->next;
+  }
+  if (pEntry) atomic_add_fetch_32(&pEntry->nRef, 1);
+  taosThreadRwlockUnlock(&pCache->sCache.lock);
+
+  if (pEntry == NULL) {
+    atomic_add_fetch_64(&pCache->sCache.nMiss, 1);
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+
+  // the entry is pinned, so the copy can be made out of the lock even if the entry is dropped meanwhile
+  int32_t size = sizeof(STSchema) + sizeof(STColumn) * pEntry->pTSchema->numOfCols;
+  *ppTSchema = (STSchema*)taosMemoryMalloc(size);
+  if (*ppTSchema == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  } else {
+    memcpy(*ppTSchema, pEntry->pTSchema, size);
+    atomic_add_fetch_64(&pCache->sCache.nHit, 1);
+  }
+  metaSchemaCacheUnref(pEntry);
+
+_exit:
+  return code;
+}
+
+int32_t metaSchemaCacheInsert(SMeta* pMeta, int64_t uid, const STSchema* pTSchema) {
+  int32_t code = 0;
+
+  SMetaCache*        pCache = pMeta->pCache;
+  int32_t            size = sizeof(STSchema) + sizeof(STColumn) * pTSchema->numOfCols;
+  SSchemaCacheEntry* pEntryNew = (SSchemaCacheEntry*)taosMemoryMalloc(sizeof(*pEntryNew));
+  if (pEntryNew == NULL || (pEntryNew->pTSchema = (STSchema*)taosMemoryMalloc(size)) == NULL) {
+    taosMemoryFree(pEntryNew);
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  pEntryNew->uid = uid;
+  pEntryNew->sver = pTSchema->version;
+  pEntryNew->nRef = 1;
+  memcpy(pEntryNew->pTSchema, pTSchema, size);
+
+  taosThreadRwlockWrlock(&pCache->sCache.lock);
+
+  int32_t             iBucket = TABS(uid) % META_SCHEMA_CACHE_BUCKET;
+  SSchemaCacheEntry** ppEntry = &pCache->sCache.aBucket[iBucket];
+  while (*ppEntry && ((*ppEntry)->uid != uid || (*ppEntry)->sver != pEntryNew->sver)) {
+    ppEntry = &(*ppEntry)->next;
+  }
+
+  if (*ppEntry) {  // inserted by another reader
+    taosThreadRwlockUnlock(&pCache->sCache.lock);
+    metaSchemaCacheUnref(pEntryNew);
+    goto _exit;
+  }
+
+  if (pCache->sCache.nEntry >= META_SCHEMA_CACHE_MAX_ENTRY) {
+    // cache is full, evict the bucket to insert into
+    SSchemaCacheEntry* pEntry = pCache->sCache.aBucket[iBucket];
+    while (pEntry) {
+      SSchemaCacheEntry* tEntry = pEntry->next;
+      metaSchemaCacheUnref(pEntry);
+      pCache->sCache.nEntry--;
+      pEntry = tEntry;
+    }
+    pCache->sCache.aBucket[iBucket] = NULL;
+  }
+
+  pEntryNew->next = pCache->sCache.aBucket[iBucket];
+  pCache->sCache.aBucket[iBucket] = pEntryNew;
+  pCache->sCache.nEntry++;
+
+  taosThreadRwlockUnlock(&pCache->sCache.lock);
+
+_exit:
+  return code;
+}
+
+void metaSchemaCacheDrop(SMeta* pMeta, int64_t uid) {
+  SMetaCache* pCache = pMeta->pCache;
+
+  taosThreadRwlockWrlock(&pCache->sCache.lock);
+
+  SSchemaCacheEntry** ppEntry = &pCache->sCache.aBucket[TABS(uid) % META_SCHEMA_CACHE_BUCKET];
+  while (*ppEntry) {
+    SSchemaCacheEntry* pEntry = *ppEntry;
+    if (pEntry->uid == uid) {
+      *ppEntry = pEntry->next;
+      metaSchemaCacheUnref(pEntry);
+      pCache->sCache.nEntry--;
+    } else {
+      ppEntry = &pEntry->next;
+    }
+  }
+
+  taosThreadRwlockUnlock(&pCache->sCache.lock);
+}
+
+void metaGetSchemaCacheStat(SMeta* pMeta, int64_t* nHit, int64_t* nMiss) {
+  *nHit = atomic_load_64(&pMeta->pCache->sCache.nHit);
+  *nMiss = atomic_load_64(&pMeta->pCache->sCache.nMiss);
+}
+
+// tag cache ==================
+static STagCache* metaTagCacheNew(const SSchemaWrapper* pTagSchema) {
+  STagCache* pTagCache = (STagCache*)taosMemoryCalloc(1, sizeof(STagCache) + sizeof(STagCacheCol) * pTagSchema->nCols);
+  if (pTagCache == NULL) return NULL;
+
+  pTagCache->pOrd = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pTagCache->pOrd == NULL) {
+    taosMemoryFree(pTagCache);
+    return NULL;
+  }
+
+  pTagCache->sorted = true;
+  pTagCache->nCol = pTagSchema->nCols;
+  for (int32_t iCol = 0; iCol < pTagSchema->nCols; iCol++) {
+    SColumnInfo* pInfo = &pTagCache->aCol[iCol].data.info;
+    pInfo->colId = pTagSchema->pSchema[iCol].colId;
+    pInfo->type = pTagSchema->pSchema[iCol].type;
+    pInfo->bytes = pTagSchema->pSchema[iCol].bytes;
+  }
+
+  return pTagCache;
+}
+
+static void metaTagCacheFree(STagCache* pTagCache) {
+  if (pTagCache == NULL) return;
+
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    colDataDestroy(&pTagCache->aCol[iCol].data);
+  }
+  taosHashCleanup(pTagCache->pOrd);
+  taosMemoryFree(pTagCache->aUid);
+  taosMemoryFree(pTagCache);
+}
+
+static int32_t metaTagCacheGrow(STagCache* pTagCache) {
+  int32_t cap = TMAX(pTagCache->cap * 2, META_TAG_CACHE_MIN_CAP);
+  void*   p;
+
+  p = taosMemoryRealloc(pTagCache->aUid, sizeof(tb_uid_t) * cap);
+  if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pTagCache->aUid = (tb_uid_t*)p;
+
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    SColumnInfoData* pData = &pTagCache->aCol[iCol].data;
+
+    if (IS_VAR_DATA_TYPE(pData->info.type)) {
+      p = taosMemoryRealloc(pData->varmeta.offset, sizeof(int32_t) * cap);
+      if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+      pData->varmeta.offset = (int32_t*)p;
+    } else {
+      p = taosMemoryRealloc(pData->nullbitmap, BitmapLen(cap));
+      if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+      memset((char*)p + BitmapLen(pTagCache->cap), 0, BitmapLen(cap) - BitmapLen(pTagCache->cap));
+      pData->nullbitmap = (char*)p;
+
+      p = taosMemoryRealloc(pData->pData, pData->info.bytes * cap);
+      if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+      pData->pData = (char*)p;
+    }
+  }
+
+  pTagCache->cap = cap;
+  return 0;
+}
+
+static int32_t metaTagColSet(STagCacheCol* pCol, int32_t ord, bool isNew, const STag* pTag) {
+  SColumnInfoData* pData = &pCol->data;
+  STagVal          tagVal = {.cid = pData->info.colId};
+  bool             find = tTagGet(pTag, &tagVal);
+
+  if (!IS_VAR_DATA_TYPE(pData->info.type)) {
+    if (find) {
+      memcpy(pData->pData + pData->info.bytes * ord, &tagVal.i64, pData->info.bytes);
+      colDataSetNotNull_f(pData->nullbitmap, ord);
+    } else {
+      colDataSetNull_f(pData->nullbitmap, ord);
+      pData->hasNull = true;
+    }
+    return 0;
+  }
+
+  if (!isNew && !colDataIsNull_var(pData, ord)) {
+    pCol->nLive -= varDataTLen(pData->pData + pData->varmeta.offset[ord]);
+  }
+
+  if (!find) {
+    colDataSetNull_var(pData, ord);
+    pData->hasNull = true;
+    return 0;
+  }
+
+  SVarColAttr* pAttr = &pData->varmeta;
+  int32_t      len = VARSTR_HEADER_SIZE + tagVal.nData;
+  if (pAttr->allocLen < pAttr->length + len) {
+    int32_t allocLen = TMAX(TMAX(pAttr->allocLen * 2, pAttr->length + len), 4096);
+    char*   p = taosMemoryRealloc(pData->pData, allocLen);
+    if (p == NULL) {
+      colDataSetNull_var(pData, ord);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pData->pData = p;
+    pAttr->allocLen = allocLen;
+  }
+
+  pAttr->offset[ord] = pAttr->length;
+  varDataSetLen(pData->pData + pAttr->length, tagVal.nData);
+  memcpy(varDataVal(pData->pData + pAttr->length), tagVal.pData, tagVal.nData);
+  pAttr->length += len;
+  pCol->nLive += len;
+
+  return 0;
+}
+
+// updated and dropped values leave holes in the payload of var type columns, squeeze them out once they dominate
+static int32_t metaTagColCompact(STagCacheCol* pCol, int32_t nChild) {
+  SColumnInfoData* pData = &pCol->data;
+
+  if (!IS_VAR_DATA_TYPE(pData->info.type) || pData->varmeta.length <= pCol->nLive * 2 + 4096) return 0;
+
+  char* p = taosMemoryMalloc(TMAX(pCol->nLive, 1));
+  if (p == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  int32_t length = 0;
+  for (int32_t ord = 0; ord < nChild; ord++) {
+    if (colDataIsNull_var(pData, ord)) continue;
+
+    int32_t len = varDataTLen(pData->pData + pData->varmeta.offset[ord]);
+    memcpy(p + length, pData->pData + pData->varmeta.offset[ord], len);
+    pData->varmeta.offset[ord] = length;
+    length += len;
+  }
+
+  taosMemoryFree(pData->pData);
+  pData->pData = p;
+  pData->varmeta.allocLen = TMAX(pCol->nLive, 1);
+  pData->varmeta.length = length;
+  return 0;
+}
+
+static int32_t metaTagCachePut(STagCache* pTagCache, tb_uid_t uid, const STag* pTag) {
+  int32_t  code = 0;
+  int32_t  ord;
+  bool     isNew;
+  int32_t* pOrd = (int32_t*)taosHashGet(pTagCache->pOrd, &uid, sizeof(uid));
+
+  if (pOrd) {
+    ord = *pOrd;
+    isNew = false;
+  } else {
+    if (pTagCache->nChild >= pTagCache->cap) {
+      code = metaTagCacheGrow(pTagCache);
+      if (code) goto _exit;
+    }
+    ord = pTagCache->nChild;
+    isNew = true;
+  }
+
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    code = metaTagColSet(&pTagCache->aCol[iCol], ord, isNew, pTag);
+    if (code) goto _exit;
+
+    if (!isNew) {
+      code = metaTagColCompact(&pTagCache->aCol[iCol], pTagCache->nChild);
+      if (code) goto _exit;
+    }
+  }
+
+  if (isNew) {
+    if (taosHashPut(pTagCache->pOrd, &uid, sizeof(uid), &ord, sizeof(ord)) < 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    if (ord > 0 && pTagCache->aUid[ord - 1] > uid) pTagCache->sorted = false;
+    pTagCache->aUid[ord] = uid;
+    pTagCache->nChild++;
+  }
+
+_exit:
+  return code;
+}
+
+static int32_t metaTagCacheRemove(STagCache* pTagCache, tb_uid_t uid) {
+  int32_t  code = 0;
+  int32_t* pOrd = (int32_t*)taosHashGet(pTagCache->pOrd, &uid, sizeof(uid));
+
+  if (pOrd == NULL) goto _exit;
+
+  int32_t ord = *pOrd;
+  int32_t last = pTagCache->nChild - 1;
+
+  // move the last child into the hole
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    STagCacheCol*    pCol = &pTagCache->aCol[iCol];
+    SColumnInfoData* pData = &pCol->data;
+
+    if (IS_VAR_DATA_TYPE(pData->info.type)) {
+      if (!colDataIsNull_var(pData, ord)) {
+        pCol->nLive -= varDataTLen(pData->pData + pData->varmeta.offset[ord]);
+      }
+      pData->varmeta.offset[ord] = pData->varmeta.offset[last];
+    } else if (ord != last) {
+      memcpy(pData->pData + pData->info.bytes * ord, pData->pData + pData->info.bytes * last, pData->info.bytes);
+      if (colDataIsNull_f(pData->nullbitmap, last)) {
+        colDataSetNull_f(pData->nullbitmap, ord);
+      } else {
+        colDataSetNotNull_f(pData->nullbitmap, ord);
+      }
+    }
+  }
+
+  taosHashRemove(pTagCache->pOrd, &uid, sizeof(uid));
+  if (ord != last) {
+    pTagCache->aUid[ord] = pTagCache->aUid[last];
+    *(int32_t*)taosHashGet(pTagCache->pOrd, &pTagCache->aUid[ord], sizeof(tb_uid_t)) = ord;
+    pTagCache->sorted = false;
+  }
+  pTagCache->nChild--;
+
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    code = metaTagColCompact(&pTagCache->aCol[iCol], pTagCache->nChild);
+    if (code) goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
+typedef struct {
+  tb_uid_t uid;
+  int32_t  ord;
+} STagCacheOrd;
+
+static int32_t metaTagCacheOrdCmpr(const void* p1, const void* p2) {
+  tb_uid_t uid1 = ((const STagCacheOrd*)p1)->uid;
+  tb_uid_t uid2 = ((const STagCacheOrd*)p2)->uid;
+  return uid1 < uid2 ? -1 : (uid1 > uid2 ? 1 : 0);
+}
+
+// renumber the children in uid order, the payload of var type columns stays where it is
+static int32_t metaTagCacheSort(STagCache* pTagCache) {
+  int32_t       code = 0;
+  int32_t       nChild = pTagCache->nChild;
+  STagCacheOrd* aOrd = NULL;
+  char*         pBuf = NULL;
+
+  if (pTagCache->sorted) goto _exit;
+
+  aOrd = (STagCacheOrd*)taosMemoryMalloc(sizeof(STagCacheOrd) * TMAX(nChild, 1));
+  if (aOrd == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  for (int32_t ord = 0; ord < nChild; ord++) {
+    aOrd[ord].uid = pTagCache->aUid[ord];
+    aOrd[ord].ord = ord;
+  }
+  taosSort(aOrd, nChild, sizeof(STagCacheOrd), metaTagCacheOrdCmpr);
+
+  // scratch big enough for the offsets or the values of any column
+  int32_t maxBytes = sizeof(int32_t);
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    maxBytes = TMAX(maxBytes, pTagCache->aCol[iCol].data.info.bytes);
+  }
+  pBuf = (char*)taosMemoryMalloc((int64_t)maxBytes * TMAX(nChild, 1) + BitmapLen(pTagCache->cap));
+  if (pBuf == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    SColumnInfoData* pData = &pTagCache->aCol[iCol].data;
+
+    if (IS_VAR_DATA_TYPE(pData->info.type)) {
+      int32_t* aOffset = (int32_t*)pBuf;
+      for (int32_t ord = 0; ord < nChild; ord++) {
+        aOffset[ord] = pData->varmeta.offset[aOrd[ord].ord];
+      }
+      memcpy(pData->varmeta.offset, aOffset, sizeof(int32_t) * nChild);
+    } else {
+      int32_t bytes = pData->info.bytes;
+      char*   pVal = pBuf;
+      char*   pBitmap = pBuf + (int64_t)bytes * nChild;
+
+      memset(pBitmap, 0, BitmapLen(pTagCache->cap));
+      for (int32_t ord = 0; ord < nChild; ord++) {
+        memcpy(pVal + bytes * ord, pData->pData + bytes * aOrd[ord].ord, bytes);
+        if (colDataIsNull_f(pData->nullbitmap, aOrd[ord].ord)) colDataSetNull_f(pBitmap, ord);
+      }
+      memcpy(pData->pData, pVal, (int64_t)bytes * nChild);
+      memcpy(pData->nullbitmap, pBitmap, BitmapLen(pTagCache->cap));
+    }
+  }
+
+  // pOrd does not take updates, the ordinals are rewritten in place
+  for (int32_t ord = 0; ord < nChild; ord++) {
+    pTagCache->aUid[ord] = aOrd[ord].uid;
+    *(int32_t*)taosHashGet(pTagCache->pOrd, &aOrd[ord].uid, sizeof(tb_uid_t)) = ord;
+  }
+  pTagCache->sorted = true;
+
+_exit:
+  taosMemoryFree(pBuf);
+  taosMemoryFree(aOrd);
+  return code;
+}
+
+// build the tag cache of a super table from ctb.idx, the meta lock is held so no child table changes meanwhile. With
+// snapshot reads the reader does not hold the lock, so take it and build from the latest snapshot only.
+static int32_t metaTagCacheBuild(SMeta* pMeta, tb_uid_t suid) {
+  int32_t    code = 0;
+  STagCache* pTagCache = NULL;
+  TBC*       pCur = NULL;
+  void*      pKey = NULL;
+  void*      pVal = NULL;
+  int        kLen = 0;
+  int        vLen = 0;
+  int        c = 0;
+  SDecoder   dc = {0};
+  SMetaEntry me = {0};
+
+  if (pMeta->snapRead) taosThreadRwlockRdlock(&pMeta->lock);
+  metaRLock(pMeta);
+
+  if (!tdbReadIsLatest(pMeta->pEnv)) {
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+
+  if (tdbTbGet(pMeta->pUidIdx, &suid, sizeof(suid), &pVal, &vLen) < 0) {
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+  STbDbKey tbDbKey = {.uid = suid, .version = ((SUidIdxVal*)pVal)[0].version};
+  if (tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), &pVal, &vLen) < 0) {
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+  tDecoderInit(&dc, pVal, vLen);
+  metaDecodeEntry(&dc, &me);
+
+  // json tags are kept as a whole blob, nothing to gain
+  if (me.type != TSDB_SUPER_TABLE || me.stbEntry.schemaTag.nCols <= 0 ||
+      me.stbEntry.schemaTag.pSchema[0].type == TSDB_DATA_TYPE_JSON) {
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+
+  pTagCache = metaTagCacheNew(&me.stbEntry.schemaTag);
+  if (pTagCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  if (tdbTbcOpen(pMeta->pCtbIdx, &pCur, NULL) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  tdbTbcMoveTo(pCur, &(SCtbIdxKey){.suid = suid, .uid = INT64_MIN}, sizeof(SCtbIdxKey), &c);
+  if (c > 0) {
+    tdbTbcMoveToNext(pCur);
+  }
+
+  while (tdbTbcNext(pCur, &pKey, &kLen, &pVal, &vLen) == 0) {
+    SCtbIdxKey* pCtbIdxKey = (SCtbIdxKey*)pKey;
+    if (pCtbIdxKey->suid < suid) continue;
+    if (pCtbIdxKey->suid > suid) break;
+
+    code = metaTagCachePut(pTagCache, pCtbIdxKey->uid, (const STag*)pVal);
+    if (code) goto _exit;
+  }
+
+  taosThreadRwlockWrlock(&pMeta->pCache->tCache.lock);
+  if (taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid)) == NULL) {
+    if (taosHashPut(pMeta->pCache->tCache.pStb, &suid, sizeof(suid), &pTagCache, POINTER_BYTES) < 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      metaDebug("vgId:%d tag cache of suid:%" PRId64 " is built, children:%d", TD_VID(pMeta->pVnode), suid,
+                pTagCache->nChild);
+      pTagCache = NULL;
+    }
+  }
+  taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock);
+
+_exit:
+  if (pCur) tdbTbcClose(pCur);
+  tDecoderClear(&dc);
+  metaULock(pMeta);
+  if (pMeta->snapRead) taosThreadRwlockUnlock(&pMeta->lock);
+  tdbFree(pKey);
+  tdbFree(pVal);
+  metaTagCacheFree(pTagCache);
+  return code;
+}
+
+// return the tag cache of a super table with the cache read locked, build it if not there yet
+static STagCache* metaTagCacheAcquire(SMeta* pMeta, tb_uid_t suid) {
+  if (!tsMetaTagCache) return NULL;
+
+  for (int32_t iTry = 0; iTry < 2; iTry++) {
+    taosThreadRwlockRdlock(&pMeta->pCache->tCache.lock);
+    STagCache** ppTagCache = (STagCache**)taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+    if (ppTagCache) return *ppTagCache;
+    taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock);
+
+    if (iTry == 0 && metaTagCacheBuild(pMeta, suid) != 0) break;
+  }
+
+  return NULL;
+}
+
+static void metaTagCacheRelease(SMeta* pMeta) { taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock); }
+
+bool metaTagCacheHas(SMeta* pMeta, tb_uid_t suid) {
+  bool has;
+
+  taosThreadRwlockRdlock(&pMeta->pCache->tCache.lock);
+  has = (taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid)) != NULL);
+  taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock);
+
+  return has;
+}
+
+// on failure the tag cache of the super table is dropped, it is rebuilt on next use
+int32_t metaTagCacheUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag) {
+  int32_t code = 0;
+
+  taosThreadRwlockWrlock(&pMeta->pCache->tCache.lock);
+  STagCache** ppTagCache = (STagCache**)taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+  if (ppTagCache) {
+    code = metaTagCachePut(*ppTagCache, uid, pTag);
+    if (code) {
+      metaTagCacheFree(*ppTagCache);
+      taosHashRemove(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+    }
+  }
+  taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock);
+
+  return code;
+}
+
+void metaTagCacheDel(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  taosThreadRwlockWrlock(&pMeta->pCache->tCache.lock);
+  STagCache** ppTagCache = (STagCache**)taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+  if (ppTagCache && metaTagCacheRemove(*ppTagCache, uid) != 0) {
+    metaTagCacheFree(*ppTagCache);
+    taosHashRemove(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+  }
+  taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock);
+}
+
+void metaTagCacheDrop(SMeta* pMeta, tb_uid_t suid) {
+  taosThreadRwlockWrlock(&pMeta->pCache->tCache.lock);
+  STagCache** ppTagCache = (STagCache**)taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+  if (ppTagCache) {
+    metaTagCacheFree(*ppTagCache);
+    taosHashRemove(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+  }
+  taosThreadRwlockUnlock(&pMeta->pCache->tCache.lock);
+}
+
+// the children in ctb.idx order, as the table list is built without the cache
+int32_t metaGetTagCacheUidList(SMeta* pMeta, uint64_t suid, SArray* uidList) {
+  int32_t    code = 0;
+  STagCache* pTagCache = metaTagCacheAcquire(pMeta, suid);
+
+  if (pTagCache == NULL) return TSDB_CODE_NOT_FOUND;
+
+  if (!pTagCache->sorted) {
+    metaTagCacheRelease(pMeta);
+
+    taosThreadRwlockWrlock(&pMeta->pCache->tCache.lock);
+    STagCache** ppTagCache = (STagCache**)taosHashGet(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+    if (ppTagCache == NULL) {
+      code = TSDB_CODE_NOT_FOUND;
+      goto _exit;
+    }
+    pTagCache = *ppTagCache;
+    code = metaTagCacheSort(pTagCache);
+    if (code) {
+      metaTagCacheFree(pTagCache);
+      taosHashRemove(pMeta->pCache->tCache.pStb, &suid, sizeof(suid));
+      goto _exit;
+    }
+  }
+
+  if (pTagCache->nChild > 0 && taosArrayAddBatch(uidList, pTagCache->aUid, pTagCache->nChild) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+_exit:
+  metaTagCacheRelease(pMeta);
+  return code;
+}
+
+int32_t metaGetTagCacheCol(SMeta* pMeta, uint64_t suid, SArray* uidList, int16_t cid, SColumnInfoData* pColData) {
+  int32_t          code = 0;
+  SColumnInfoData* pData = NULL;
+  STagCache*       pTagCache = metaTagCacheAcquire(pMeta, suid);
+
+  if (pTagCache == NULL) return TSDB_CODE_NOT_FOUND;
+
+  for (int32_t iCol = 0; iCol < pTagCache->nCol; iCol++) {
+    if (pTagCache->aCol[iCol].data.info.colId == cid) {
+      pData = &pTagCache->aCol[iCol].data;
+      break;
+    }
+  }
+  if (pData == NULL || pData->info.type != pColData->info.type) {
+    code = TSDB_CODE_NOT_FOUND;
+    goto _exit;
+  }
+
+  int32_t   nRows = taosArrayGetSize(uidList);
+  tb_uid_t* aUid = (tb_uid_t*)TARRAY_GET_START(uidList);
+
+  if (nRows == pTagCache->nChild && memcmp(aUid, pTagCache->aUid, sizeof(tb_uid_t) * nRows) == 0) {
+    // all children in ordinal order, copy the whole column
+    if (IS_VAR_DATA_TYPE(pData->info.type)) {
+      if (pColData->varmeta.allocLen < pData->varmeta.length) {
+        char* p = taosMemoryRealloc(pColData->pData, pData->varmeta.length);
+        if (p == NULL) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+          goto _exit;
+        }
+        pColData->pData = p;
+        pColData->varmeta.allocLen = pData->varmeta.length;
+      }
+      memcpy(pColData->varmeta.offset, pData->varmeta.offset, sizeof(int32_t) * nRows);
+      memcpy(pColData->pData, pData->pData, pData->varmeta.length);
+      pColData->varmeta.length = pData->varmeta.length;
+    } else {
+      memcpy(pColData->nullbitmap, pData->nullbitmap, BitmapLen(nRows));
+      memcpy(pColData->pData, pData->pData, pData->info.bytes * nRows);
+    }
+    pColData->hasNull = pData->hasNull;
+    goto _exit;
+  }
+
+  for (int32_t iRow = 0; iRow < nRows; iRow++) {
+    int32_t ord = -1;
+
+    if (iRow < pTagCache->nChild && pTagCache->aUid[iRow] == aUid[iRow]) {
+      ord = iRow;
+    } else {
+      int32_t* pOrd = (int32_t*)taosHashGet(pTagCache->pOrd, &aUid[iRow], sizeof(tb_uid_t));
+      if (pOrd) ord = *pOrd;
+    }
+
+    if (ord < 0 || colDataIsNull_s(pData, ord)) {
+      colDataAppendNULL(pColData, iRow);
+    } else {
+      code = colDataAppend(pColData, iRow, colDataGetData(pData, ord), false);
+      if (code) goto _exit;
+    }
+  }
+
+_exit:
+  metaTagCacheRelease(pMeta);
   return code;
 }
@@ -14,6 +14,7 @@
  */
 
 #include "meta.h"
+#include "vnd.h"
 
 static FORCE_INLINE void *metaMalloc(void *pPool, size_t size) { return vnodeBufPoolMalloc((SVBufPool *)pPool, size); }
 static FORCE_INLINE void  metaFree(void *pPool, void *p) { vnodeBufPoolFree((SVBufPool *)pPool, p); }
@@ -32,8 +33,32 @@ int metaBegin(SMeta *pMeta, int8_t fromSys) {
   return 0;
 }
 
+static int32_t metaCheckpointImpl(void *arg) {
+  SMeta *pMeta = (SMeta *)arg;
+
+  if (tdbCheckpoint(pMeta->pEnv) < 0) {
+    metaError("vgId:%d, failed to checkpoint meta wal", TD_VID(pMeta->pVnode));
+  }
+
+  atomic_store_8(&pMeta->inCheckpoint, 0);
+  return 0;
+}
+
 // commit the meta txn
-int metaCommit(SMeta *pMeta) { return tdbCommit(pMeta->pEnv, &pMeta->txn); }
+int metaCommit(SMeta *pMeta) {
+  if (tdbCommit(pMeta->pEnv, &pMeta->txn) < 0) {
+    return -1;
+  }
+
+  // fold the wal back into the db files off the write thread
+  if (tdbNeedCheckpoint(pMeta->pEnv) && atomic_val_compare_exchange_8(&pMeta->inCheckpoint, 0, 1) == 0) {
+    if (vnodeScheduleTask(metaCheckpointImpl, pMeta) < 0) {
+      atomic_store_8(&pMeta->inCheckpoint, 0);
+    }
+  }
+
+  return 0;
+}
 
 // abort the meta txn
 int metaAbort(SMeta *pMeta) { return tdbAbort(pMeta->pEnv, &pMeta->txn); }
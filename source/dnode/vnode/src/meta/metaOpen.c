@@ -58,6 +58,24 @@ int metaOpen(SVnode *pVnode, SMeta **ppMeta) {
     goto _err;
   }
 
+  if (tsMetaWalMode && tdbSetJournalMode(pMeta->pEnv, TDB_JOURNAL_MODE_WAL) < 0) {
+    metaError("vgId:%d, failed to set meta env to wal mode since %s", TD_VID(pVnode), tstrerror(terrno));
+    goto _err;
+  }
+
+  if (tsMetaMmapRead && tdbSetMmapRead(pMeta->pEnv, true) < 0) {
+    metaError("vgId:%d, failed to set meta env to mmap read since %s", TD_VID(pVnode), tstrerror(terrno));
+    goto _err;
+  }
+
+  if (tsMetaSnapshotRead) {
+    if (tdbSetSnapshotRead(pMeta->pEnv, true) < 0) {
+      metaError("vgId:%d, failed to set meta env to snapshot read since %s", TD_VID(pVnode), tstrerror(terrno));
+      goto _err;
+    }
+    pMeta->snapRead = 1;
+  }
+
   // open pTbDb
   ret = tdbTbOpen("table.db", sizeof(STbDbKey), -1, tbDbKeyCmpr, pMeta->pEnv, &pMeta->pTbDb);
   if (ret < 0) {
@@ -176,6 +194,9 @@ _err:
 
 int metaClose(SMeta *pMeta) {
   if (pMeta) {
+    while (atomic_load_8(&pMeta->inCheckpoint)) {
+      taosMsleep(1);
+    }
     if (pMeta->pCache) metaCacheClose(pMeta);
     if (pMeta->pIdx) metaCloseIdx(pMeta);
     if (pMeta->pStreamDb) tdbTbClose(pMeta->pStreamDb);
@@ -197,9 +218,20 @@ int metaClose(SMeta *pMeta) {
   return 0;
 }
 
+// with snapshot reads a reader pins a snapshot of the meta env instead, only the writer takes the lock
 int32_t metaRLock(SMeta *pMeta) {
   int32_t ret = 0;
 
+  if (pMeta->snapRead) {
+    // a read nested in the write lock is only counted, so metaULock() tells it from the write unlock
+    if (atomic_load_64(&pMeta->wrThread) == taosGetSelfPthreadId()) {
+      pMeta->wrRead++;
+    } else {
+      tdbReadBegin(pMeta->pEnv);
+    }
+    return 0;
+  }
+
   metaTrace("meta rlock %p B", &pMeta->lock);
 
   ret = taosThreadRwlockRdlock(&pMeta->lock);
@@ -215,6 +247,9 @@ int32_t metaWLock(SMeta *pMeta) {
   metaTrace("meta wlock %p B", &pMeta->lock);
 
   ret = taosThreadRwlockWrlock(&pMeta->lock);
+  if (pMeta->snapRead) {
+    atomic_store_64(&pMeta->wrThread, taosGetSelfPthreadId());
+  }
 
   metaTrace("meta wlock %p E", &pMeta->lock);
 
@@ -224,6 +259,21 @@ int32_t metaWLock(SMeta *pMeta) {
 int32_t metaULock(SMeta *pMeta) {
   int32_t ret = 0;
 
+  if (pMeta->snapRead) {
+    if (atomic_load_64(&pMeta->wrThread) != taosGetSelfPthreadId()) {
+      tdbReadEnd(pMeta->pEnv);
+      return 0;
+    }
+    if (pMeta->wrRead > 0) {
+      pMeta->wrRead--;
+      return 0;
+    }
+
+    // the writer is done with a change, make it visible to new snapshots
+    atomic_store_64(&pMeta->wrThread, 0);
+    tdbPublish(pMeta->pEnv);
+  }
+
   metaTrace("meta ulock %p B", &pMeta->lock);
 
   ret = taosThreadRwlockUnlock(&pMeta->lock);
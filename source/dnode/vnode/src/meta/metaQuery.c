@@ -19,23 +19,46 @@ void metaReaderInit(SMetaReader *pReader, SMeta *pMeta, int32_t flags) {
   memset(pReader, 0, sizeof(*pReader));
   pReader->flags = flags;
   pReader->pMeta = pMeta;
-  metaRLock(pMeta);
+  if (pMeta->snapRead) {
+    // the reader may be kept past the read section of the thread and cleared by another one, it pins its own snapshot
+    tdbSnapOpen(pMeta->pEnv, &pReader->pSnap);
+  } else {
+    metaRLock(pMeta);
+  }
 }
 
 void metaReaderClear(SMetaReader *pReader) {
   if (pReader->pMeta) {
-    metaULock(pReader->pMeta);
+    if (pReader->pMeta->snapRead) {
+      tdbSnapClose(pReader->pSnap);
+      pReader->pSnap = NULL;
+    } else {
+      metaULock(pReader->pMeta);
+    }
   }
   tDecoderClear(&pReader->coder);
   tdbFree(pReader->pBuf);
 }
 
+// the reads of a reader see the snapshot it pinned on init
+static void metaReaderBegin(SMetaReader *pReader) {
+  if (pReader->pSnap) tdbReadBeginAt(pReader->pMeta->pEnv, pReader->pSnap);
+}
+
+static void metaReaderEnd(SMetaReader *pReader) {
+  if (pReader->pSnap) tdbReadEnd(pReader->pMeta->pEnv);
+}
+
 int metaGetTableEntryByVersion(SMetaReader *pReader, int64_t version, tb_uid_t uid) {
   SMeta   *pMeta = pReader->pMeta;
   STbDbKey tbDbKey = {.version = version, .uid = uid};
+  int32_t  ret;
 
   // query table.db
-  if (tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), &pReader->pBuf, &pReader->szBuf) < 0) {
+  metaReaderBegin(pReader);
+  ret = tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), &pReader->pBuf, &pReader->szBuf);
+  metaReaderEnd(pReader);
+  if (ret < 0) {
     terrno = TSDB_CODE_PAR_TABLE_NOT_EXIST;
     goto _err;
   }
@@ -145,9 +168,13 @@ bool metaIsTableExist(SMeta *pMeta, tb_uid_t uid) {
 int metaGetTableEntryByUid(SMetaReader *pReader, tb_uid_t uid) {
   SMeta  *pMeta = pReader->pMeta;
   int64_t version;
+  int32_t ret;
 
   // query uid.idx
-  if (tdbTbGet(pMeta->pUidIdx, &uid, sizeof(uid), &pReader->pBuf, &pReader->szBuf) < 0) {
+  metaReaderBegin(pReader);
+  ret = tdbTbGet(pMeta->pUidIdx, &uid, sizeof(uid), &pReader->pBuf, &pReader->szBuf);
+  metaReaderEnd(pReader);
+  if (ret < 0) {
     terrno = TSDB_CODE_PAR_TABLE_NOT_EXIST;
     return -1;
   }
@@ -159,9 +186,13 @@ int metaGetTableEntryByUid(SMetaReader *pReader, tb_uid_t uid) {
 int metaGetTableEntryByName(SMetaReader *pReader, const char *name) {
   SMeta   *pMeta = pReader->pMeta;
   tb_uid_t uid;
+  int32_t  ret;
 
   // query name.idx
-  if (tdbTbGet(pMeta->pNameIdx, name, strlen(name) + 1, &pReader->pBuf, &pReader->szBuf) < 0) {
+  metaReaderBegin(pReader);
+  ret = tdbTbGet(pMeta->pNameIdx, name, strlen(name) + 1, &pReader->pBuf, &pReader->szBuf);
+  metaReaderEnd(pReader);
+  if (ret < 0) {
     terrno = TSDB_CODE_PAR_TABLE_NOT_EXIST;
     return -1;
   }
@@ -222,7 +253,10 @@ SMTbCursor *metaOpenTbCursor(SMeta *pMeta) {
 
   metaReaderInit(&pTbCur->mr, pMeta, 0);
 
+  // the cursor pins the snapshot of the reader
+  metaReaderBegin(&pTbCur->mr);
   tdbTbcOpen(pMeta->pUidIdx, &pTbCur->pDbc, NULL);
+  metaReaderEnd(&pTbCur->mr);
 
   tdbTbcMoveToFirst(pTbCur->pDbc);
 
@@ -363,31 +397,33 @@ _err:
   return NULL;
 }
 
-int metaTtlSmaller(SMeta *pMeta, uint64_t ttl, SArray *uidList) {
+// expired uids, oldest first and at most maxNum of them (no limit if maxNum <= 0), *pMore is set if some are left
+int metaTtlSmaller(SMeta *pMeta, uint64_t ttl, int32_t maxNum, SArray *uidList, bool *pMore) {
   TBC *pCur;
   int  ret = tdbTbcOpen(pMeta->pTtlIdx, &pCur, NULL);
   if (ret < 0) {
     return ret;
   }
 
-  STtlIdxKey ttlKey = {0};
-  ttlKey.dtime = ttl;
-  ttlKey.uid = INT64_MAX;
-  int c = 0;
-  tdbTbcMoveTo(pCur, &ttlKey, sizeof(ttlKey), &c);
-  if (c < 0) {
-    tdbTbcMoveToPrev(pCur);
-  }
+  *pMore = false;
+  tdbTbcMoveToFirst(pCur);
 
   void *pKey = NULL;
   int   kLen = 0;
   while (1) {
-    ret = tdbTbcPrev(pCur, &pKey, &kLen, NULL, NULL);
+    ret = tdbTbcNext(pCur, &pKey, &kLen, NULL, NULL);
     if (ret < 0) {
       break;
     }
-    ttlKey = *(STtlIdxKey *)pKey;
-    taosArrayPush(uidList, &ttlKey.uid);
+    STtlIdxKey *ttlKey = (STtlIdxKey *)pKey;
+    if (ttlKey->dtime > (int64_t)ttl) {
+      break;
+    }
+    if (maxNum > 0 && taosArrayGetSize(uidList) >= maxNum) {
+      *pMore = true;
+      break;
+    }
+    taosArrayPush(uidList, &ttlKey->uid);
   }
   tdbFree(pKey);
   tdbTbcClose(pCur);
@@ -417,11 +453,12 @@ SMCtbCursor *metaOpenCtbCursor(SMeta *pMeta, tb_uid_t uid) {
 
   pCtbCur->pMeta = pMeta;
   pCtbCur->suid = uid;
-  metaRLock(pMeta);
+  // with snapshot reads the tdb cursor pins its own snapshot, so the cursor may be closed by any thread
+  if (!pMeta->snapRead) metaRLock(pMeta);
 
   ret = tdbTbcOpen(pMeta->pCtbIdx, &pCtbCur->pCur, NULL);
   if (ret < 0) {
-    metaULock(pMeta);
+    if (!pMeta->snapRead) metaULock(pMeta);
     taosMemoryFree(pCtbCur);
     return NULL;
   }
@@ -439,7 +476,7 @@ SMCtbCursor *metaOpenCtbCursor(SMeta *pMeta, tb_uid_t uid) {
 
 void metaCloseCtbCursor(SMCtbCursor *pCtbCur) {
   if (pCtbCur) {
-    if (pCtbCur->pMeta) metaULock(pCtbCur->pMeta);
+    if (pCtbCur->pMeta && !pCtbCur->pMeta->snapRead) metaULock(pCtbCur->pMeta);
     if (pCtbCur->pCur) {
       tdbTbcClose(pCtbCur->pCur);
 
@@ -491,12 +528,12 @@ SMStbCursor *metaOpenStbCursor(SMeta *pMeta, tb_uid_t suid) {
 
   pStbCur->pMeta = pMeta;
   pStbCur->suid = suid;
-  metaRLock(pMeta);
+  if (!pMeta->snapRead) metaRLock(pMeta);  // see metaOpenCtbCursor()
 
   ret = tdbTbcOpen(pMeta->pSuidIdx, &pStbCur->pCur, NULL);
   if (ret < 0) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
-    metaULock(pMeta);
+    if (!pMeta->snapRead) metaULock(pMeta);
     taosMemoryFree(pStbCur);
     return NULL;
   }
@@ -512,7 +549,7 @@ SMStbCursor *metaOpenStbCursor(SMeta *pMeta, tb_uid_t suid) {
 
 void metaCloseStbCursor(SMStbCursor *pStbCur) {
   if (pStbCur) {
-    if (pStbCur->pMeta) metaULock(pStbCur->pMeta);
+    if (pStbCur->pMeta && !pStbCur->pMeta->snapRead) metaULock(pStbCur->pMeta);
     if (pStbCur->pCur) {
       tdbTbcClose(pStbCur->pCur);
 
@@ -540,6 +577,25 @@ STSchema *metaGetTbTSchema(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
   SSchemaWrapper *pSW = NULL;
   STSchemaBuilder sb = {0};
   SSchema        *pSchema;
+  SMetaInfo       info;
+  tb_uid_t        skmUid = 0;
+  int32_t         skmVer = sver;
+
+  // schema is owned by the super table for child tables, try the cache first
+  if (metaGetInfo(pMeta, uid, &info) == 0) {
+    skmUid = info.suid ? info.suid : uid;
+    if (skmVer < 0) {
+      if (skmUid != uid && metaGetInfo(pMeta, skmUid, &info) < 0) {
+        skmUid = 0;
+      } else {
+        skmVer = info.skmVer;
+      }
+    }
+
+    if (skmUid && metaSchemaCacheGet(pMeta, skmUid, skmVer, &pTSchema) == 0) {
+      return pTSchema;
+    }
+  }
 
   pSW = metaGetTableSchema(pMeta, uid, sver, 0);
   if (!pSW) return NULL;
@@ -553,6 +609,10 @@ STSchema *metaGetTbTSchema(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
 
   tdDestroyTSchemaBuilder(&sb);
 
+  if (pTSchema && skmUid && pTSchema->version == skmVer) {
+    metaSchemaCacheInsert(pMeta, skmUid, pTSchema);
+  }
+
   taosMemoryFree(pSW->pSchema);
   taosMemoryFree(pSW);
   return pTSchema;
@@ -611,6 +671,10 @@ int32_t metaGetTbTSchemaEx(SMeta *pMeta, tb_uid_t suid, tb_uid_t uid, int32_t sv
 
   ASSERT(sver > 0);
 
+  if (metaSchemaCacheGet(pMeta, suid ? suid : uid, sver, ppTSchema) == 0) {
+    goto _exit;
+  }
+
   skmDbKey.uid = suid ? suid : uid;
   skmDbKey.sver = sver;
   metaRLock(pMeta);
@@ -642,6 +706,8 @@ int32_t metaGetTbTSchemaEx(SMeta *pMeta, tb_uid_t suid, tb_uid_t uid, int32_t sv
   STSchema *pTSchema = tdGetSchemaFromBuilder(&sb);
   tdDestroyTSchemaBuilder(&sb);
 
+  if (pTSchema) metaSchemaCacheInsert(pMeta, skmDbKey.uid, pTSchema);
+
   *ppTSchema = pTSchema;
   taosMemoryFree(pSchemaWrapper->pSchema);
 
@@ -697,11 +763,11 @@ SMSmaCursor *metaOpenSmaCursor(SMeta *pMeta, tb_uid_t uid) {
 
   pSmaCur->pMeta = pMeta;
   pSmaCur->uid = uid;
-  metaRLock(pMeta);
+  if (!pMeta->snapRead) metaRLock(pMeta);  // see metaOpenCtbCursor()
 
   ret = tdbTbcOpen(pMeta->pSmaIdx, &pSmaCur->pCur, NULL);
   if (ret < 0) {
-    metaULock(pMeta);
+    if (!pMeta->snapRead) metaULock(pMeta);
     taosMemoryFree(pSmaCur);
     return NULL;
   }
@@ -719,7 +785,7 @@ SMSmaCursor *metaOpenSmaCursor(SMeta *pMeta, tb_uid_t uid) {
 
 void metaCloseSmaCursor(SMSmaCursor *pSmaCur) {
   if (pSmaCur) {
-    if (pSmaCur->pMeta) metaULock(pSmaCur->pMeta);
+    if (pSmaCur->pMeta && !pSmaCur->pMeta->snapRead) metaULock(pSmaCur->pMeta);
     if (pSmaCur->pCur) {
       tdbTbcClose(pSmaCur->pCur);
 
@@ -984,9 +1050,54 @@ typedef struct {
   int32_t  vLen;
 } SIdxCursor;
 
+static int32_t metaFltParamToIdxKey(SMetaFltParam *param, tb_uid_t uid, STagIdxKey **ppKey, int32_t *nKey) {
+  char   *buf = NULL;
+  int32_t nTagData = 0;
+  void   *tagData = NULL;
+
+  if (param->val == NULL) {
+    terrno = TSDB_CODE_INVALID_PARA;
+    return -1;
+  }
+
+  if (IS_VAR_DATA_TYPE(param->type)) {
+    tagData = varDataVal(param->val);
+    nTagData = varDataLen(param->val);
+
+    if (param->type == TSDB_DATA_TYPE_NCHAR) {
+      int32_t maxSize = 4 * nTagData + 1;
+      buf = taosMemoryCalloc(1, maxSize);
+      if (buf == NULL) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        return -1;
+      }
+      if (false == taosMbsToUcs4(tagData, nTagData, (TdUcs4 *)buf, maxSize, &maxSize)) {
+        taosMemoryFree(buf);
+        return -1;
+      }
+
+      tagData = buf;
+      nTagData = maxSize;
+    }
+  } else {
+    tagData = param->val;
+    nTagData = tDataTypes[param->type].bytes;
+  }
+
+  int32_t ret = metaCreateTagIdxKey(param->suid, param->cid, tagData, nTagData, param->type, uid, ppKey, nKey);
+  taosMemoryFree(buf);
+  return ret;
+}
+
+static FORCE_INLINE tb_uid_t metaTagIdxKeyUid(STagIdxKey *p) {
+  if (IS_VAR_DATA_TYPE(p->type)) {
+    return *(tb_uid_t *)(p->data + varDataTLen(p->data));
+  }
+  return *(tb_uid_t *)(p->data + tDataTypes[p->type].bytes);
+}
+
 int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *pUids) {
   int32_t ret = 0;
-  char   *buf = NULL;
 
   STagIdxKey *pKey = NULL;
   int32_t     nKey = 0;
@@ -998,45 +1109,20 @@ int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *pUids) {
   pCursor->cid = param->cid;
   pCursor->type = param->type;
 
+  ret = metaFltParamToIdxKey(param, param->reverse ? INT64_MAX : INT64_MIN, &pKey, &nKey);
+  if (ret != 0) {
+    metaError("vgId:%d, failed to filter table ids of suid:%" PRId64 " cid:%d", TD_VID(pMeta->pVnode), param->suid,
+              param->cid);
+    taosMemoryFree(pCursor);
+    return -1;
+  }
+
   metaRLock(pMeta);
   ret = tdbTbcOpen(pMeta->pTagIdx, &pCursor->pCur, NULL);
   if (ret < 0) {
     goto END;
   }
 
-  int32_t maxSize = 0;
-  int32_t nTagData = 0;
-  void   *tagData = NULL;
-
-  if (param->val == NULL) {
-    metaError("vgId:%d, failed to filter NULL data", TD_VID(pMeta->pVnode));
-    return -1;
-  } else {
-    if (IS_VAR_DATA_TYPE(param->type)) {
-      tagData = varDataVal(param->val);
-      nTagData = varDataLen(param->val);
-
-      if (param->type == TSDB_DATA_TYPE_NCHAR) {
-        maxSize = 4 * nTagData + 1;
-        buf = taosMemoryCalloc(1, maxSize);
-        if (false == taosMbsToUcs4(tagData, nTagData, (TdUcs4 *)buf, maxSize, &maxSize)) {
-          goto END;
-        }
-
-        tagData = buf;
-        nTagData = maxSize;
-      }
-    } else {
-      tagData = param->val;
-      nTagData = tDataTypes[param->type].bytes;
-    }
-  }
-  ret = metaCreateTagIdxKey(pCursor->suid, pCursor->cid, tagData, nTagData, pCursor->type,
-                            param->reverse ? INT64_MAX : INT64_MIN, &pKey, &nKey);
-
-  if (ret != 0) {
-    goto END;
-  }
   int cmp = 0;
   if (tdbTbcMoveTo(pCursor->pCur, pKey, nKey, &cmp) < 0) {
     goto END;
@@ -1070,17 +1156,12 @@ int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *pUids) {
       int32_t cmp = (*param->filterFunc)(p->data, pKey->data, pKey->type);
       if (cmp == 0) {
         // match
-        tb_uid_t tuid = 0;
-        if (IS_VAR_DATA_TYPE(pKey->type)) {
-          tuid = *(tb_uid_t *)(p->data + varDataTLen(p->data));
-        } else {
-          tuid = *(tb_uid_t *)(p->data + tDataTypes[pCursor->type].bytes);
-        }
+        tb_uid_t tuid = metaTagIdxKeyUid(p);
         taosArrayPush(pUids, &tuid);
-      } else if (cmp == 1) {
+      } else if (cmp == 1 && !param->equal) {
         // not match but should continue to iter
       } else {
-        // not match and no more result
+        // not match and no more result, an equal scan is past its value once it stops matching
         break;
       }
     }
@@ -1093,7 +1174,6 @@ int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *pUids) {
 END:
   if (pCursor->pMeta) metaULock(pCursor->pMeta);
   if (pCursor->pCur) tdbTbcClose(pCursor->pCur);
-  taosMemoryFree(buf);
   taosMemoryFree(pKey);
 
   taosMemoryFree(pCursor);
@@ -1101,6 +1181,260 @@ END:
   return ret;
 }
 
+typedef struct {
+  SMetaFltParam *param;
+  STagIdxKey    *pKey;
+  int32_t        nKey;
+  bool           isEqual;
+} SIdxFltCond;
+
+static int metaUidCmpr(const void *a, const void *b) {
+  tb_uid_t l = *(tb_uid_t *)a;
+  tb_uid_t r = *(tb_uid_t *)b;
+  return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+// Pick the condition a scan over one tag column starts from: an equal condition if there is one, otherwise the
+// tightest bound in the chosen direction, i.e. the one whose value satisfies every other bound of that direction.
+static SIdxFltCond *metaFltPickStart(SIdxFltCond *conds, int32_t nCond, bool *reverse) {
+  bool hasForward = false;
+  for (int32_t i = 0; i < nCond; i++) {
+    if (conds[i].isEqual) {
+      *reverse = false;
+      return &conds[i];
+    }
+    if (!conds[i].param->reverse) hasForward = true;
+  }
+
+  *reverse = !hasForward;
+  SIdxFltCond *pStart = NULL;
+  for (int32_t i = 0; i < nCond; i++) {
+    if (conds[i].param->reverse != *reverse) continue;
+    if (pStart == NULL) pStart = &conds[i];
+
+    bool tightest = true;
+    for (int32_t j = 0; j < nCond && tightest; j++) {
+      if (j == i || conds[j].param->reverse != *reverse) continue;
+      tightest = (*conds[j].param->filterFunc)(conds[i].pKey->data, conds[j].pKey->data, conds[i].pKey->type) == 0;
+    }
+    if (tightest) return &conds[i];
+  }
+  return pStart;
+}
+
+// Scan the tag index once for all conditions on the same tag column. Entries come in value order, so a condition
+// bounding the far end of the scan ends it on the first miss while the others only skip the entry.
+static int32_t metaFltScanColumn(TBC *pCur, SIdxFltCond *conds, int32_t nCond, SArray *pUids) {
+  bool         reverse = false;
+  SIdxFltCond *pStart = metaFltPickStart(conds, nCond, &reverse);
+  STagIdxKey  *pKey = pStart->pKey;
+
+  int cmp = 0;
+  if (tdbTbcMoveTo(pCur, pKey, pStart->nKey, &cmp) < 0) {
+    return 0;
+  }
+
+  bool first = true;
+  while (1) {
+    void   *entryKey = NULL, *entryVal = NULL;
+    int32_t nEntryKey, nEntryVal;
+
+    if (tdbTbcGet(pCur, (const void **)&entryKey, &nEntryKey, (const void **)&entryVal, &nEntryVal) < 0) {
+      break;
+    }
+
+    STagIdxKey *p = entryKey;
+    if (p->type != pKey->type || p->cid != pKey->cid) {
+      if (!first) break;
+    } else {
+      if (p->suid != pKey->suid) break;
+      first = false;
+
+      bool match = true;
+      bool stop = false;
+      for (int32_t i = 0; i < nCond && !stop; i++) {
+        int32_t res = (*conds[i].param->filterFunc)(p->data, conds[i].pKey->data, pKey->type);
+        if (res == 0) continue;
+
+        match = false;
+        stop = (res != 1) || conds[i].isEqual || (conds[i].param->reverse != reverse);
+      }
+      if (stop) break;
+
+      if (match) {
+        tb_uid_t uid = metaTagIdxKeyUid(p);
+        if (taosArrayPush(pUids, &uid) == NULL) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          return -1;
+        }
+      }
+    }
+
+    if ((reverse ? tdbTbcMoveToPrev(pCur) : tdbTbcMoveToNext(pCur)) < 0) {
+      break;
+    }
+  }
+
+  // uids of a single value are already in key order
+  if (!pStart->isEqual) {
+    taosArraySort(pUids, metaUidCmpr);
+  }
+  return 0;
+}
+
+// first position in [from, size) whose uid is not less than target, galloping from the current position
+static int32_t metaUidSeek(SArray *pUids, int32_t from, tb_uid_t target) {
+  int32_t   size = taosArrayGetSize(pUids);
+  tb_uid_t *a = (tb_uid_t *)TARRAY_GET_START(pUids);
+
+  int32_t step = 1;
+  int32_t lo = from, hi = from;
+  while (hi < size && a[hi] < target) {
+    lo = hi + 1;
+    hi += step;
+    step <<= 1;
+  }
+  if (hi > size) hi = size;
+
+  while (lo < hi) {
+    int32_t mid = lo + ((hi - lo) >> 1);
+    if (a[mid] < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// leapfrog intersection of sorted uid lists
+static int32_t metaUidIntersect(SArray **lists, int32_t nList, SArray *pUids) {
+  int32_t pos[TSDB_MAX_TAGS] = {0};
+
+  for (int32_t i = 0; i < nList; i++) {
+    if (taosArrayGetSize(lists[i]) == 0) return 0;
+  }
+  if (nList == 1) {
+    if (taosArrayAddAll(pUids, lists[0]) == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    return 0;
+  }
+
+  tb_uid_t target = *(tb_uid_t *)taosArrayGet(lists[0], 0);
+  int32_t  nAgree = 0;
+  int32_t  i = 0;
+  while (1) {
+    pos[i] = metaUidSeek(lists[i], pos[i], target);
+    if (pos[i] >= taosArrayGetSize(lists[i])) break;
+
+    tb_uid_t uid = *(tb_uid_t *)taosArrayGet(lists[i], pos[i]);
+    if (uid == target) {
+      if (++nAgree == nList) {
+        if (taosArrayPush(pUids, &uid) == NULL) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          return -1;
+        }
+        if (++pos[i] >= taosArrayGetSize(lists[i])) break;
+        target = *(tb_uid_t *)taosArrayGet(lists[i], pos[i]);
+        nAgree = 1;
+      }
+    } else {
+      target = uid;
+      nAgree = 1;
+    }
+    i = (i + 1) % nList;
+  }
+  return 0;
+}
+
+int32_t metaFilterTableIdsMulti(SMeta *pMeta, SMetaFltParam *params, int32_t nParam, SArray *pUids) {
+  int32_t      ret = 0;
+  TBC         *pCur = NULL;
+  SIdxFltCond *conds = NULL;
+  SArray      *lists[TSDB_MAX_TAGS] = {0};
+  int32_t      nList = 0;
+
+  conds = taosMemoryCalloc(nParam, sizeof(SIdxFltCond));
+  if (conds == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  // build every search key, including the NCHAR conversion, once and outside the meta lock
+  for (int32_t i = 0; i < nParam; i++) {
+    SMetaFltParam *param = &params[i];
+    if (param->filterFunc == NULL || param->suid != params[0].suid) {
+      terrno = TSDB_CODE_INVALID_PARA;
+      ret = -1;
+      goto _exit;
+    }
+
+    conds[i].param = param;
+    conds[i].isEqual = param->equal;
+    ret = metaFltParamToIdxKey(param, param->reverse ? INT64_MAX : INT64_MIN, &conds[i].pKey, &conds[i].nKey);
+    if (ret != 0) goto _exit;
+  }
+
+  metaRLock(pMeta);
+  ret = tdbTbcOpen(pMeta->pTagIdx, &pCur, NULL);
+  if (ret < 0) {
+    metaULock(pMeta);
+    goto _exit;
+  }
+
+  // conditions on the same tag column are evaluated in one bounded scan, each column yields a sorted uid list
+  for (int32_t i = 0; i < nParam; i++) {
+    int32_t nSame = 0;
+    for (int32_t j = i; j < nParam; j++) {
+      if (conds[j].param->cid == conds[i].param->cid) {
+        SIdxFltCond t = conds[i + nSame];
+        conds[i + nSame] = conds[j];
+        conds[j] = t;
+        nSame++;
+      }
+    }
+
+    if (nList >= TSDB_MAX_TAGS) {
+      terrno = TSDB_CODE_INVALID_PARA;
+      ret = -1;
+      break;
+    }
+    lists[nList] = taosArrayInit(64, sizeof(tb_uid_t));
+    if (lists[nList] == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      ret = -1;
+      break;
+    }
+    ret = metaFltScanColumn(pCur, &conds[i], nSame, lists[nList++]);
+    if (ret != 0 || taosArrayGetSize(lists[nList - 1]) == 0) break;
+
+    i += nSame - 1;
+  }
+
+  tdbTbcClose(pCur);
+  metaULock(pMeta);
+
+  if (ret == 0 && nList > 0) {
+    ret = metaUidIntersect(lists, nList, pUids);
+  }
+
+_exit:
+  if (ret != 0) {
+    metaError("vgId:%d, failed to filter table ids of suid:%" PRId64 " with %d conditions since %s",
+              TD_VID(pMeta->pVnode), params[0].suid, nParam, tstrerror(terrno));
+  }
+  for (int32_t i = 0; i < nList; i++) {
+    taosArrayDestroy(lists[i]);
+  }
+  for (int32_t i = 0; i < nParam; i++) {
+    taosMemoryFree(conds[i].pKey);
+  }
+  taosMemoryFree(conds);
+  return ret;
+}
+
 int32_t metaGetTableTags(SMeta *pMeta, uint64_t suid, SArray *uidList, SHashObj *tags) {
   SMCtbCursor *pCur = metaOpenCtbCursor(pMeta, suid);
 
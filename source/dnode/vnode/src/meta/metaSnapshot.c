@@ -147,6 +147,14 @@ int32_t metaSnapWriterOpen(SMeta* pMeta, int64_t sver, int64_t ever, SMetaSnapWr
 
   metaBegin(pMeta, 1);
 
+  // restored tables are loaded into meta at once, tdb tables of a new vnode are built bottom-up
+  code = metaBulkBegin(pMeta);
+  if (code) {
+    code = terrno;
+    taosMemoryFree(pWriter);
+    goto _err;
+  }
+
   *ppWriter = pWriter;
   return code;
 
@@ -160,6 +168,12 @@ int32_t metaSnapWriterClose(SMetaSnapWriter** ppWriter, int8_t rollback) {
   int32_t          code = 0;
   SMetaSnapWriter* pWriter = *ppWriter;
 
+  code = metaBulkEnd(pWriter->pMeta);
+  if (code) {
+    code = terrno;
+    goto _err;
+  }
+
   if (rollback) {
     ASSERT(0);
   } else {
@@ -25,7 +25,14 @@ static int metaSaveToSkmDb(SMeta *pMeta, const SMetaEntry *pME);
 static int metaUpdateCtbIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int metaUpdateSuidIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int metaUpdateTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry);
+static void metaDestroyTagIdxKey(STagIdxKey *pTagIdxKey);
 static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type);
+static int metaTbPut(SMeta *pMeta, TTB *pTb, const void *pKey, int kLen, const void *pVal, int vLen, int8_t upsert);
+static int metaBulkPutInfo(SMetaBulk *pBulk, const SMetaInfo *pInfo, const char *name);
+static const SMetaInfo *metaBulkGetInfo(SMetaBulk *pBulk, const char *name);
+static int              metaBulkFlush(SMeta *pMeta);
+static void             metaBulkMark(SMetaBulk *pBulk, int32_t *aMark);
+static void             metaBulkRollback(SMetaBulk *pBulk, const int32_t *aMark);
 
 static void metaGetEntryInfo(const SMetaEntry *pEntry, SMetaInfo *pInfo) {
   pInfo->uid = pEntry->uid;
@@ -257,6 +264,7 @@ int metaDropSTable(SMeta *pMeta, int64_t verison, SVDropStbReq *pReq, SArray *tb
   if (rc < 0) {
     tdbTbcClose(pCtbIdxc);
     metaWLock(pMeta);
+    metaTagCacheDrop(pMeta, pReq->suid);
     goto _drop_super_table;
   }
 
@@ -277,6 +285,8 @@ int metaDropSTable(SMeta *pMeta, int64_t verison, SVDropStbReq *pReq, SArray *tb
 
   metaWLock(pMeta);
 
+  metaTagCacheDrop(pMeta, pReq->suid);
+
   for (int32_t iChild = 0; iChild < taosArrayGetSize(tbUidList); iChild++) {
     tb_uid_t uid = *(tb_uid_t *)taosArrayGet(tbUidList, iChild);
     metaDropTableByUid(pMeta, uid, NULL);
@@ -291,6 +301,9 @@ _drop_super_table:
   tdbTbDelete(pMeta->pUidIdx, &pReq->suid, sizeof(tb_uid_t), &pMeta->txn);
   tdbTbDelete(pMeta->pSuidIdx, &pReq->suid, sizeof(tb_uid_t), &pMeta->txn);
 
+  metaCacheDrop(pMeta, pReq->suid);
+  metaSchemaCacheDrop(pMeta, pReq->suid);
+
   metaULock(pMeta);
 
 _exit:
@@ -362,6 +375,11 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   // update uid index
   metaUpdateUidIdx(pMeta, &nStbEntry);
 
+  metaSchemaCacheDrop(pMeta, pReq->suid);
+
+  // tag columns may be added, dropped or resized, rebuild on next use
+  metaTagCacheDrop(pMeta, pReq->suid);
+
   if (oStbEntry.pBuf) taosMemoryFree(oStbEntry.pBuf);
   metaULock(pMeta);
   tDecoderClear(&dc);
@@ -371,8 +389,9 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
 }
 
 int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMetaRsp **pMetaRsp) {
-  SMetaEntry  me = {0};
-  SMetaReader mr = {0};
+  SMetaEntry       me = {0};
+  SMetaReader      mr = {0};
+  const SMetaInfo *pInfo;
 
   // validate message
   if (pReq->type != TSDB_CHILD_TABLE && pReq->type != TSDB_NORMAL_TABLE) {
@@ -403,6 +422,16 @@ int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMe
   }
   metaReaderClear(&mr);
 
+  // tables collected by the bulk are not in name.idx yet
+  if (pMeta->pBulk && (pInfo = metaBulkGetInfo(pMeta->pBulk, pReq->name)) != NULL) {
+    pReq->uid = pInfo->uid;
+    if (pReq->type == TSDB_CHILD_TABLE) {
+      pReq->ctb.suid = pInfo->suid;
+    }
+    terrno = TSDB_CODE_TDB_TABLE_ALREADY_EXIST;
+    return -1;
+  }
+
   // build SMetaEntry
   me.version = version;
   me.type = pReq->type;
@@ -507,8 +536,8 @@ int metaDropTable(SMeta *pMeta, int64_t version, SVDropTbReq *pReq, SArray *tbUi
   return 0;
 }
 
-int metaTtlDropTable(SMeta *pMeta, int64_t ttl, SArray *tbUids) {
-  int ret = metaTtlSmaller(pMeta, ttl, tbUids);
+int metaTtlDropTable(SMeta *pMeta, int64_t ttl, int32_t maxNum, SArray *tbUids, bool *pMore) {
+  int ret = metaTtlSmaller(pMeta, ttl, maxNum, tbUids, pMore);
   if (ret != 0) {
     return ret;
   }
@@ -516,6 +545,9 @@ int metaTtlDropTable(SMeta *pMeta, int64_t ttl, SArray *tbUids) {
     return 0;
   }
 
+  // in uid order the uid.idx and table.db deletes of a batch land on neighbouring pages
+  taosArraySort(tbUids, compareInt64Val);
+
   metaWLock(pMeta);
   for (int i = 0; i < taosArrayGetSize(tbUids); ++i) {
     tb_uid_t *uid = (tb_uid_t *)taosArrayGet(tbUids, i);
@@ -552,6 +584,29 @@ static int metaDeleteTtlIdx(SMeta *pMeta, const SMetaEntry *pME) {
   return tdbTbDelete(pMeta->pTtlIdx, &ttlKey, sizeof(ttlKey), &pMeta->txn);
 }
 
+static void metaDeleteTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry, const SSchema *pTagColumn) {
+  STagIdxKey *pTagIdxKey = NULL;
+  int32_t     nTagIdxKey = 0;
+  const void *pTagData = NULL;
+  int32_t     nTagData = 0;
+
+  STagVal tagVal = {.cid = pTagColumn->colId};
+  tTagGet((const STag *)pCtbEntry->ctbEntry.pTags, &tagVal);
+  if (IS_VAR_DATA_TYPE(pTagColumn->type)) {
+    pTagData = tagVal.pData;
+    nTagData = (int32_t)tagVal.nData;
+  } else {
+    pTagData = &(tagVal.i64);
+    nTagData = tDataTypes[pTagColumn->type].bytes;
+  }
+
+  if (metaCreateTagIdxKey(pCtbEntry->ctbEntry.suid, pTagColumn->colId, pTagData, nTagData, pTagColumn->type,
+                          pCtbEntry->uid, &pTagIdxKey, &nTagIdxKey) == 0) {
+    tdbTbDelete(pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, &pMeta->txn);
+  }
+  metaDestroyTagIdxKey(pTagIdxKey);
+}
+
 static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
   void      *pData = NULL;
   int        nData = 0;
@@ -588,6 +643,8 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
         const SSchema *pTagColumn = &stbEntry.stbEntry.schemaTag.pSchema[0];
         if (pTagColumn->type == TSDB_DATA_TYPE_JSON) {
           metaDelJsonVarFromIdx(pMeta, &e, pTagColumn);
+        } else {
+          metaDeleteTagIdx(pMeta, &e, pTagColumn);
         }
         tDecoderClear(&tdc);
       }
@@ -603,6 +660,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
 
   if (e.type == TSDB_CHILD_TABLE) {
     tdbTbDelete(pMeta->pCtbIdx, &(SCtbIdxKey){.suid = e.ctbEntry.suid, .uid = uid}, sizeof(SCtbIdxKey), &pMeta->txn);
+    metaTagCacheDel(pMeta, e.ctbEntry.suid, uid);
 
     --pMeta->pVnode->config.vndStats.numOfCTables;
   } else if (e.type == TSDB_NORMAL_TABLE) {
@@ -618,6 +676,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
   }
 
   metaCacheDrop(pMeta, uid);
+  if (e.type != TSDB_CHILD_TABLE) metaSchemaCacheDrop(pMeta, uid);
 
   tDecoderClear(&dc);
   tdbFree(pData);
@@ -779,6 +838,8 @@ static int metaAlterTableColumn(SMeta *pMeta, int64_t version, SVAlterTbReq *pAl
 
   metaSaveToSkmDb(pMeta, &entry);
 
+  metaSchemaCacheDrop(pMeta, uid);
+
   metaULock(pMeta);
 
   metaUpdateMetaRsp(uid, pAlterTbReq->tbName, pSchema, pMetaRsp);
@@ -922,6 +983,8 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
     taosArrayDestroy(pTagArray);
   }
 
+  metaWLock(pMeta);
+
   // save to table.db
   metaSaveToTbDb(pMeta, &ctbEntry);
 
@@ -936,6 +999,10 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
   tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), ctbEntry.ctbEntry.pTags,
               ((STag *)(ctbEntry.ctbEntry.pTags))->len, &pMeta->txn);
 
+  metaTagCacheUpsert(pMeta, ctbEntry.ctbEntry.suid, uid, (const STag *)ctbEntry.ctbEntry.pTags);
+
+  metaULock(pMeta);
+
   tDecoderClear(&dc1);
   tDecoderClear(&dc2);
   if (ctbEntry.ctbEntry.pTags) taosMemoryFree((void *)ctbEntry.ctbEntry.pTags);
@@ -1097,7 +1164,7 @@ static int metaSaveToTbDb(SMeta *pMeta, const SMetaEntry *pME) {
   tEncoderClear(&coder);
 
   // write to table.db
-  if (tdbTbInsert(pMeta->pTbDb, pKey, kLen, pVal, vLen, &pMeta->txn) < 0) {
+  if (metaTbPut(pMeta, pMeta->pTbDb, pKey, kLen, pVal, vLen, 0) < 0) {
     goto _err;
   }
 
@@ -1116,11 +1183,15 @@ static int metaUpdateUidIdx(SMeta *pMeta, const SMetaEntry *pME) {
   // upsert cache
   SMetaInfo info;
   metaGetEntryInfo(pME, &info);
-  metaCacheUpsert(pMeta, &info);
+  if (pMeta->pBulk) {
+    if (metaBulkPutInfo(pMeta->pBulk, &info, pME->name) < 0) return -1;
+  } else {
+    metaCacheUpsert(pMeta, &info);
+  }
 
   SUidIdxVal uidIdxVal = {.suid = info.suid, .version = info.version, .skmVer = info.skmVer};
 
-  return tdbTbUpsert(pMeta->pUidIdx, &pME->uid, sizeof(tb_uid_t), &uidIdxVal, sizeof(uidIdxVal), &pMeta->txn);
+  return metaTbPut(pMeta, pMeta->pUidIdx, &pME->uid, sizeof(tb_uid_t), &uidIdxVal, sizeof(uidIdxVal), 1);
 }
 
 static int metaUpdateSuidIdx(SMeta *pMeta, const SMetaEntry *pME) {
@@ -1128,21 +1199,21 @@ static int metaUpdateSuidIdx(SMeta *pMeta, const SMetaEntry *pME) {
 }
 
 static int metaUpdateNameIdx(SMeta *pMeta, const SMetaEntry *pME) {
-  return tdbTbInsert(pMeta->pNameIdx, pME->name, strlen(pME->name) + 1, &pME->uid, sizeof(tb_uid_t), &pMeta->txn);
+  return metaTbPut(pMeta, pMeta->pNameIdx, pME->name, strlen(pME->name) + 1, &pME->uid, sizeof(tb_uid_t), 0);
 }
 
 static int metaUpdateTtlIdx(SMeta *pMeta, const SMetaEntry *pME) {
   STtlIdxKey ttlKey = {0};
   metaBuildTtlIdxKey(&ttlKey, pME);
   if (ttlKey.dtime == 0) return 0;
-  return tdbTbInsert(pMeta->pTtlIdx, &ttlKey, sizeof(ttlKey), NULL, 0, &pMeta->txn);
+  return metaTbPut(pMeta, pMeta->pTtlIdx, &ttlKey, sizeof(ttlKey), NULL, 0, 0);
 }
 
 static int metaUpdateCtbIdx(SMeta *pMeta, const SMetaEntry *pME) {
   SCtbIdxKey ctbIdxKey = {.suid = pME->ctbEntry.suid, .uid = pME->uid};
 
-  return tdbTbInsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pME->ctbEntry.pTags,
-                     ((STag *)(pME->ctbEntry.pTags))->len, &pMeta->txn);
+  return metaTbPut(pMeta, pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pME->ctbEntry.pTags,
+                   ((STag *)(pME->ctbEntry.pTags))->len, 0);
 }
 
 int metaCreateTagIdxKey(tb_uid_t suid, int32_t cid, const void *pTagData, int32_t nTagData, int8_t type, tb_uid_t uid,
@@ -1230,7 +1301,7 @@ static int metaUpdateTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry) {
     ret = -1;
     goto end;
   }
-  tdbTbUpsert(pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, NULL, 0, &pMeta->txn);
+  metaTbPut(pMeta, pMeta->pTagIdx, pTagIdxKey, nTagIdxKey, NULL, 0, 1);
 end:
   metaDestroyTagIdxKey(pTagIdxKey);
   tDecoderClear(&dc);
@@ -1276,7 +1347,7 @@ static int metaSaveToSkmDb(SMeta *pMeta, const SMetaEntry *pME) {
   tEncoderInit(&coder, pVal, vLen);
   tEncodeSSchemaWrapper(&coder, pSW);
 
-  if (tdbTbInsert(pMeta->pSkmDb, &skmDbKey, sizeof(skmDbKey), pVal, vLen, &pMeta->txn) < 0) {
+  if (metaTbPut(pMeta, pMeta->pSkmDb, &skmDbKey, sizeof(skmDbKey), pVal, vLen, 0) < 0) {
     rcode = -1;
     goto _exit;
   }
@@ -1290,9 +1361,288 @@ _exit:
   return rcode;
 }
 
+// SMetaBulk ========================================
+// Tables created in a batch are collected per tdb table, and loaded into each one sorted by key at the end, which
+// builds the tdb tables bottom-up when they are empty, e.g. on snapshot restore.
+#define META_BULK_FILL_FACTOR 90
+#define META_BULK_MAX_SIZE    (64 << 20)  // flush the records collected beyond this size
+
+#define META_BULK_MAX_TB       8
+
+typedef struct {
+  int64_t seq;  // keeps the put order of records with the same key
+  int32_t kLen;
+  int32_t vLen;
+  int8_t  upsert;
+  uint8_t data[];
+} SMetaBulkRec;
+
+typedef struct {
+  TTB      *pTb;
+  SArray   *aRec;   // SArray<SMetaBulkRec *>
+  SHashObj *pKeys;  // keys collected without upsert, a duplicate is rejected as tdbTbInsert does
+} SMetaBulkTb;
+
+struct SMetaBulk {
+  int32_t     nTb;
+  SMetaBulkTb aTb[META_BULK_MAX_TB];
+  SHashObj   *pInfo;  // table name -> SMetaInfo, to update the cache once loaded
+  int64_t     size;
+  int64_t     seq;
+  int32_t     code;  // set by a failed flush, nothing more is collected or loaded after it
+};
+
+int32_t metaBulkBegin(SMeta *pMeta) {
+  SMetaBulk *pBulk;
+
+  if (pMeta->pBulk) return 0;
+
+  pBulk = (SMetaBulk *)taosMemoryCalloc(1, sizeof(*pBulk));
+  if (pBulk == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  pBulk->pInfo = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (pBulk->pInfo == NULL) {
+    taosMemoryFree(pBulk);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  pMeta->pBulk = pBulk;
+  return 0;
+}
+
+int32_t metaBulkEnd(SMeta *pMeta) {
+  SMetaBulk *pBulk = pMeta->pBulk;
+  int32_t    code = 0;
+
+  if (pBulk == NULL) return 0;
+
+  metaWLock(pMeta);
+  if (pBulk->code) {
+    terrno = pBulk->code;
+    code = -1;
+  } else {
+    code = metaBulkFlush(pMeta);
+  }
+  pMeta->pBulk = NULL;
+  metaULock(pMeta);
+
+  for (int32_t iTb = 0; iTb < pBulk->nTb; iTb++) {
+    taosArrayDestroyP(pBulk->aTb[iTb].aRec, taosMemoryFree);
+    taosHashCleanup(pBulk->aTb[iTb].pKeys);
+  }
+  taosHashCleanup(pBulk->pInfo);
+  taosMemoryFree(pBulk);
+
+  if (code) {
+    metaError("vgId:%d, failed to bulk load tables since %s", TD_VID(pMeta->pVnode), tstrerror(terrno));
+  }
+  return code;
+}
+
+static int metaTbPut(SMeta *pMeta, TTB *pTb, const void *pKey, int kLen, const void *pVal, int vLen, int8_t upsert) {
+  SMetaBulk    *pBulk = pMeta->pBulk;
+  SMetaBulkTb  *pBulkTb = NULL;
+  SMetaBulkRec *pRec;
+
+  if (pBulk == NULL) {
+    if (upsert) {
+      return tdbTbUpsert(pTb, pKey, kLen, pVal, vLen, &pMeta->txn);
+    } else {
+      return tdbTbInsert(pTb, pKey, kLen, pVal, vLen, &pMeta->txn);
+    }
+  }
+
+  if (pBulk->code) {
+    terrno = pBulk->code;
+    return -1;
+  }
+
+  for (int32_t iTb = 0; iTb < pBulk->nTb; iTb++) {
+    if (pBulk->aTb[iTb].pTb == pTb) {
+      pBulkTb = &pBulk->aTb[iTb];
+      break;
+    }
+  }
+
+  if (pBulkTb == NULL) {
+    ASSERT(pBulk->nTb < tListLen(pBulk->aTb));
+    pBulkTb = &pBulk->aTb[pBulk->nTb];
+    pBulkTb->aRec = taosArrayInit(1024, POINTER_BYTES);
+    if (pBulkTb->aRec == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    pBulkTb->pTb = pTb;
+    pBulk->nTb++;
+  }
+
+  // the loader upserts, so an insert is checked against the table and the records collected so far
+  if (!upsert) {
+    void *pOldVal = NULL;
+    int   nOldVal = 0;
+    int   exist = (tdbTbGet(pTb, pKey, kLen, &pOldVal, &nOldVal) == 0);
+    tdbFree(pOldVal);
+
+    if (exist || (pBulkTb->pKeys && taosHashGet(pBulkTb->pKeys, pKey, kLen))) {
+      terrno = TSDB_CODE_TDB_TABLE_ALREADY_EXIST;
+      return -1;
+    }
+
+    if (pBulkTb->pKeys == NULL) {
+      pBulkTb->pKeys = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+    }
+    if (pBulkTb->pKeys == NULL || taosHashPut(pBulkTb->pKeys, pKey, kLen, NULL, 0) < 0) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  pRec = (SMetaBulkRec *)taosMemoryMalloc(sizeof(*pRec) + kLen + vLen);
+  if (pRec == NULL || taosArrayPush(pBulkTb->aRec, &pRec) == NULL) {
+    if (!upsert) taosHashRemove(pBulkTb->pKeys, pKey, kLen);
+    taosMemoryFree(pRec);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  pRec->seq = pBulk->seq++;
+  pRec->kLen = kLen;
+  pRec->vLen = vLen;
+  pRec->upsert = upsert;
+  memcpy(pRec->data, pKey, kLen);
+  if (vLen > 0) {
+    memcpy(pRec->data + kLen, pVal, vLen);
+  }
+
+  pBulk->size += sizeof(*pRec) + kLen + vLen;
+  return 0;
+}
+
+// number of records collected per tdb table, to drop what a failed entry collected
+static void metaBulkMark(SMetaBulk *pBulk, int32_t *aMark) {
+  for (int32_t iTb = 0; iTb < META_BULK_MAX_TB; iTb++) {
+    aMark[iTb] = (iTb < pBulk->nTb) ? taosArrayGetSize(pBulk->aTb[iTb].aRec) : 0;
+  }
+}
+
+static void metaBulkRollback(SMetaBulk *pBulk, const int32_t *aMark) {
+  for (int32_t iTb = 0; iTb < pBulk->nTb; iTb++) {
+    SMetaBulkTb *pBulkTb = &pBulk->aTb[iTb];
+
+    while (taosArrayGetSize(pBulkTb->aRec) > aMark[iTb]) {
+      SMetaBulkRec *pRec = *(SMetaBulkRec **)taosArrayPop(pBulkTb->aRec);
+      if (!pRec->upsert) {
+        taosHashRemove(pBulkTb->pKeys, pRec->data, pRec->kLen);
+      }
+      pBulk->size -= sizeof(*pRec) + pRec->kLen + pRec->vLen;
+      taosMemoryFree(pRec);
+    }
+  }
+}
+
+static int metaBulkPutInfo(SMetaBulk *pBulk, const SMetaInfo *pInfo, const char *name) {
+  if (taosHashPut(pBulk->pInfo, name, strlen(name), pInfo, sizeof(*pInfo)) < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  return 0;
+}
+
+static const SMetaInfo *metaBulkGetInfo(SMetaBulk *pBulk, const char *name) {
+  return (const SMetaInfo *)taosHashGet(pBulk->pInfo, name, strlen(name));
+}
+
+static int32_t metaBulkRecCmpr(const void *p1, const void *p2, const void *param) {
+  const SMetaBulkRec *pRec1 = *(const SMetaBulkRec **)p1;
+  const SMetaBulkRec *pRec2 = *(const SMetaBulkRec **)p2;
+
+  int c = tdbTbCmpr((TTB *)param, pRec1->data, pRec1->kLen, pRec2->data, pRec2->kLen);
+  if (c == 0) {
+    return pRec1->seq < pRec2->seq ? -1 : 1;
+  }
+  return c < 0 ? -1 : 1;
+}
+
+static int metaBulkFlush(SMeta *pMeta) {
+  SMetaBulk *pBulk = pMeta->pBulk;
+  TBL       *pTbl = NULL;
+  int        ret = 0;
+
+  for (int32_t iTb = 0; iTb < pBulk->nTb; iTb++) {
+    SMetaBulkTb *pBulkTb = &pBulk->aTb[iTb];
+    int32_t      nRec = taosArrayGetSize(pBulkTb->aRec);
+
+    if (nRec == 0) continue;
+
+    taosqsort(TARRAY_GET_START(pBulkTb->aRec), nRec, POINTER_BYTES, pBulkTb->pTb, metaBulkRecCmpr);
+
+    ret = tdbTbBulkOpen(pBulkTb->pTb, META_BULK_FILL_FACTOR, &pMeta->txn, &pTbl);
+    for (int32_t iRec = 0; ret == 0 && iRec < nRec; iRec++) {
+      SMetaBulkRec *pRec = taosArrayGetP(pBulkTb->aRec, iRec);
+      ret = tdbTbBulkPut(pTbl, pRec->data, pRec->kLen, pRec->vLen > 0 ? pRec->data + pRec->kLen : NULL, pRec->vLen);
+    }
+    if (tdbTbBulkClose(pTbl) < 0) ret = -1;
+    pTbl = NULL;
+
+    taosArrayClearP(pBulkTb->aRec, taosMemoryFree);
+    taosHashClear(pBulkTb->pKeys);
+    if (ret < 0) {
+      // part of the tables may be loaded already, the batch can only fail as a whole now
+      pBulk->code = terrno ? terrno : TSDB_CODE_FAILED;
+      terrno = pBulk->code;
+      for (iTb++; iTb < pBulk->nTb; iTb++) {
+        taosArrayClearP(pBulk->aTb[iTb].aRec, taosMemoryFree);
+        taosHashClear(pBulk->aTb[iTb].pKeys);
+      }
+      goto _exit;
+    }
+  }
+
+  // the tables are visible from the cache only once they are in the tdb tables
+  for (void *pIter = taosHashIterate(pBulk->pInfo, NULL); pIter; pIter = taosHashIterate(pBulk->pInfo, pIter)) {
+    SMetaInfo *pInfo = (SMetaInfo *)pIter;
+
+    metaCacheUpsert(pMeta, pInfo);
+
+    if (pInfo->suid && pInfo->suid != pInfo->uid && metaTagCacheHas(pMeta, pInfo->suid)) {
+      void *pTags = NULL;
+      int   nTags = 0;
+      if (tdbTbGet(pMeta->pCtbIdx, &(SCtbIdxKey){.suid = pInfo->suid, .uid = pInfo->uid}, sizeof(SCtbIdxKey), &pTags,
+                   &nTags) == 0) {
+        metaTagCacheUpsert(pMeta, pInfo->suid, pInfo->uid, (const STag *)pTags);
+      } else {
+        metaTagCacheDrop(pMeta, pInfo->suid);
+      }
+      tdbFree(pTags);
+    }
+  }
+
+_exit:
+  taosHashClear(pBulk->pInfo);
+  pBulk->size = 0;
+  return ret;
+}
+
 int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
+  SMetaBulk *pBulk = pMeta->pBulk;
+  int32_t    aMark[META_BULK_MAX_TB];
+  bool       hasInfo = false;
+
   metaWLock(pMeta);
 
+  if (pBulk) {
+    metaBulkMark(pBulk, aMark);
+    hasInfo = (metaBulkGetInfo(pBulk, pME->name) != NULL);
+  }
+
+  // child tables look up their super table, so it goes to the tables directly
+  if (pME->type == TSDB_SUPER_TABLE) {
+    pMeta->pBulk = NULL;
+  }
+
   // save to table.db
   if (metaSaveToTbDb(pMeta, pME) < 0) goto _err;
 
@@ -1308,6 +1658,11 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
 
     // update tag.idx
     if (metaUpdateTagIdx(pMeta, pME) < 0) goto _err;
+
+    // bulk loaded children go to the tag cache once they are in ctb.idx
+    if (pMeta->pBulk == NULL) {
+      metaTagCacheUpsert(pMeta, pME->ctbEntry.suid, pME->uid, (const STag *)pME->ctbEntry.pTags);
+    }
   } else {
     // update schema.db
     if (metaSaveToSkmDb(pMeta, pME) < 0) goto _err;
@@ -1321,13 +1676,25 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
     if (metaUpdateTtlIdx(pMeta, pME) < 0) goto _err;
   }
 
+  pMeta->pBulk = pBulk;
+  if (pBulk && pBulk->size >= META_BULK_MAX_SIZE) {
+    if (metaBulkFlush(pMeta) < 0) goto _err;
+  }
+
   metaULock(pMeta);
   return 0;
 
 _err:
+  pMeta->pBulk = pBulk;
+  // what the entry collected is dropped, as if it was never handled
+  if (pBulk && pBulk->code == 0) {
+    metaBulkRollback(pBulk, aMark);
+    if (!hasInfo) taosHashRemove(pBulk->pInfo, pME->name, strlen(pME->name));
+  }
   metaULock(pMeta);
   return -1;
 }
+
 // refactor later
 void *metaGetIdx(SMeta *pMeta) { return pMeta->pTagIdx; }
 void *metaGetIvtIdx(SMeta *pMeta) { return pMeta->pTagIvtIdx; }
@@ -63,6 +63,7 @@ static void destroySTqHandle(void* data) {
     walCloseReader(pData->pWalReader);
     tqCloseReader(pData->execHandle.pExecReader);
   }
+  taosMemoryFreeClear(pData->pMetaCkHead);
 }
 
 STQ* tqOpen(const char* path, SVnode* pVnode) {
@@ -531,13 +532,6 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
 
   if (fetchOffsetNew.type == TMQ_OFFSET__LOG) {
     int64_t fetchVer = fetchOffsetNew.version + 1;
-    pCkHead = taosMemoryMalloc(sizeof(SWalCkHead) + 2048);
-    if (pCkHead == NULL) {
-      tDeleteSTaosxRsp(&taosxRsp);
-      return -1;
-    }
-
-    walSetReaderCapacity(pHandle->pWalReader, 2048);
 
     while (1) {
       consumerEpoch = atomic_load_32(&pHandle->epoch);
@@ -554,7 +548,6 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
           code = -1;
         }
         tDeleteSTaosxRsp(&taosxRsp);
-        if (pCkHead) taosMemoryFree(pCkHead);
         return code;
       }
 
@@ -577,7 +570,6 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
             code = -1;
           }
           tDeleteSTaosxRsp(&taosxRsp);
-          if (pCkHead) taosMemoryFree(pCkHead);
           return code;
         } else {
           fetchVer++;
@@ -593,12 +585,10 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
         metaRsp.metaRsp = pHead->body;
         if (tqSendMetaPollRsp(pTq, pMsg, pReq, &metaRsp) < 0) {
           code = -1;
-          taosMemoryFree(pCkHead);
           tDeleteSTaosxRsp(&taosxRsp);
           return code;
         }
         code = 0;
-        if (pCkHead) taosMemoryFree(pCkHead);
         tDeleteSTaosxRsp(&taosxRsp);
         return code;
       }
@@ -694,6 +684,9 @@ int32_t tqProcessVgChangeReq(STQ* pTq, int64_t version, char* msg, int32_t msgLe
     };
     pHandle->snapshotVer = ver;
 
+    // consumers of the same vnode share the log file mappings instead of copying every entry
+    SWalFilterCond walCond = {.enableMmap = 1};
+
     if (pHandle->execHandle.subType == TOPIC_SUB_TYPE__COLUMN) {
       pHandle->execHandle.execCol.qmsg = req.qmsg;
       req.qmsg = NULL;
@@ -708,7 +701,7 @@ int32_t tqProcessVgChangeReq(STQ* pTq, int64_t version, char* msg, int32_t msgLe
       pHandle->execHandle.pExecReader = qExtractReaderFromStreamScanner(scanner);
       ASSERT(pHandle->execHandle.pExecReader);
     } else if (pHandle->execHandle.subType == TOPIC_SUB_TYPE__DB) {
-      pHandle->pWalReader = walOpenReader(pTq->pVnode->pWal, NULL);
+      pHandle->pWalReader = walOpenReader(pTq->pVnode->pWal, &walCond);
       pHandle->execHandle.pExecReader = tqOpenReader(pTq->pVnode);
       pHandle->execHandle.execDb.pFilterOutTbUid =
           taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
@@ -717,7 +710,7 @@ int32_t tqProcessVgChangeReq(STQ* pTq, int64_t version, char* msg, int32_t msgLe
 
       pHandle->execHandle.task = qCreateQueueExecTaskInfo(NULL, &handle, NULL, NULL);
     } else if (pHandle->execHandle.subType == TOPIC_SUB_TYPE__TABLE) {
-      pHandle->pWalReader = walOpenReader(pTq->pVnode->pWal, NULL);
+      pHandle->pWalReader = walOpenReader(pTq->pVnode->pWal, &walCond);
 
       pHandle->execHandle.execTb.suid = req.suid;
 
@@ -267,6 +267,7 @@ int32_t tqMetaRestoreHandle(STQ* pTq) {
     STqHandle handle;
     tDecoderInit(&decoder, (uint8_t*)pVal, vLen);
     tDecodeSTqHandle(&decoder, &handle);
+    handle.pMetaCkHead = NULL;
 
     handle.pRef = walOpenRef(pTq->pVnode->pWal);
     if (handle.pRef == NULL) {
@@ -282,6 +283,7 @@ int32_t tqMetaRestoreHandle(STQ* pTq) {
         .initTqReader = true,
         .version = handle.snapshotVer,
     };
+    SWalFilterCond walCond = {.enableMmap = 1};
 
     if (handle.execHandle.subType == TOPIC_SUB_TYPE__COLUMN) {
 
@@ -294,14 +296,14 @@ int32_t tqMetaRestoreHandle(STQ* pTq) {
       handle.execHandle.pExecReader = qExtractReaderFromStreamScanner(scanner);
       ASSERT(handle.execHandle.pExecReader);
     } else if (handle.execHandle.subType == TOPIC_SUB_TYPE__DB) {
-      handle.pWalReader = walOpenReader(pTq->pVnode->pWal, NULL);
+      handle.pWalReader = walOpenReader(pTq->pVnode->pWal, &walCond);
       handle.execHandle.pExecReader = tqOpenReader(pTq->pVnode);
 
       buildSnapContext(reader.meta, reader.version, 0, handle.execHandle.subType, handle.fetchMeta, (SSnapContext **)(&reader.sContext));
       handle.execHandle.task =
           qCreateQueueExecTaskInfo(NULL, &reader, NULL, NULL);
     } else if (handle.execHandle.subType == TOPIC_SUB_TYPE__TABLE) {
-      handle.pWalReader = walOpenReader(pTq->pVnode->pWal, NULL);
+      handle.pWalReader = walOpenReader(pTq->pVnode->pWal, &walCond);
 
       SArray* tbUidList = taosArrayInit(0, sizeof(int64_t));
       vnodeGetCtbIdList(pTq->pVnode, handle.execHandle.execTb.suid, tbUidList);
@@ -186,13 +186,15 @@ bool isValValidForTable(STqHandle* pHandle, SWalCont *pHead){
   return tbSuid == realTbSuid;
 }
 
+// on success *ppCkHead points to the entry held by the wal reader of the handle, which is valid until the next fetch
 int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHead** ppCkHead) {
-  int32_t code = 0;
-  taosThreadMutexLock(&pHandle->pWalReader->mutex);
+  int32_t     code = 0;
+  SWalReader* pWalReader = pHandle->pWalReader;
+  taosThreadMutexLock(&pWalReader->mutex);
   int64_t offset = *fetchOffset;
 
   while (1) {
-    if (walFetchHead(pHandle->pWalReader, offset, *ppCkHead) < 0) {
+    if (offset > walGetCommittedVer(pWalReader->pWal) || walFetchHeadNew(pWalReader, offset) < 0) {
       tqDebug("tmq poll: consumer:%" PRId64 ", (epoch %d) vgId:%d offset %" PRId64 ", no more log to return",
               pHandle->consumerId, pHandle->epoch, TD_VID(pTq->pVnode), offset);
       *fetchOffset = offset - 1;
@@ -200,8 +202,8 @@ int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHea
       goto END;
     }
 
-    if ((*ppCkHead)->head.msgType == TDMT_VND_SUBMIT) {
-      code = walFetchBody(pHandle->pWalReader, ppCkHead);
+    if (pWalReader->pHead->head.msgType == TDMT_VND_SUBMIT) {
+      code = walFetchBodyNew(pWalReader);
 
       if (code < 0) {
         ASSERT(0);
@@ -209,14 +211,14 @@ int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHea
         code = -1;
         goto END;
       }
+      *ppCkHead = pWalReader->pHead;
       *fetchOffset = offset;
       code = 0;
       goto END;
     } else {
       if (pHandle->fetchMeta) {
-        SWalCont* pHead = &((*ppCkHead)->head);
-        if (IS_META_MSG(pHead->msgType)) {
-          code = walFetchBody(pHandle->pWalReader, ppCkHead);
+        if (IS_META_MSG(pWalReader->pHead->head.msgType)) {
+          code = walFetchBodyNew(pWalReader);
 
           if (code < 0) {
             ASSERT(0);
@@ -224,14 +226,30 @@ int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHea
             code = -1;
             goto END;
           }
-          if(isValValidForTable(pHandle, pHead)){
+
+          // the entry may be mapped read-only, copy it out before filtering
+          int64_t     entryLen = sizeof(SWalCkHead) + pWalReader->pHead->head.bodyLen;
+          SWalCkHead* pMetaCkHead = taosMemoryRealloc(pHandle->pMetaCkHead, entryLen);
+          if (pMetaCkHead == NULL) {
+            terrno = TSDB_CODE_OUT_OF_MEMORY;
+            *fetchOffset = offset;
+            code = -1;
+            goto END;
+          }
+          memcpy(pMetaCkHead, pWalReader->pHead, entryLen);
+          pHandle->pMetaCkHead = pMetaCkHead;
+
+          if (isValValidForTable(pHandle, &pMetaCkHead->head)) {
+            *ppCkHead = pMetaCkHead;
             *fetchOffset = offset;
             code = 0;
             goto END;
           }
+          offset++;
+          continue;
         }
       }
-      code = walSkipFetchBody(pHandle->pWalReader, *ppCkHead);
+      code = walSkipFetchBodyNew(pWalReader);
       if (code < 0) {
         ASSERT(0);
         *fetchOffset = offset;
@@ -241,8 +259,8 @@ int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHea
       offset++;
     }
   }
-  END:
-  taosThreadMutexUnlock(&pHandle->pWalReader->mutex);
+END:
+  taosThreadMutexUnlock(&pWalReader->mutex);
   return code;
 }
 
@@ -252,7 +270,8 @@ STqReader* tqOpenReader(SVnode* pVnode) {
     return NULL;
   }
 
-  pReader->pWalReader = walOpenReader(pVnode->pWal, NULL);
+  SWalFilterCond cond = {.enableMmap = 1};
+  pReader->pWalReader = walOpenReader(pVnode->pWal, &cond);
   if (pReader->pWalReader == NULL) {
     return NULL;
   }
@@ -640,36 +640,28 @@ int32_t tsdbFSUpsertFSet(STsdbFS *pFS, SDFileSet *pSet) {
       *pDFileSet->pDataF = *pSet->pDataF;
       *pDFileSet->pSmaF = *pSet->pSmaF;
       // stt
-      if (pSet->nSttF > pDFileSet->nSttF) {
-        ASSERT(pSet->nSttF == pDFileSet->nSttF + 1);
-
-        pDFileSet->aSttF[pDFileSet->nSttF] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-        if (pDFileSet->aSttF[pDFileSet->nSttF] == NULL) {
+      for (int32_t iStt = pSet->nSttF; iStt < pDFileSet->nSttF; iStt++) {
+        taosMemoryFree(pDFileSet->aSttF[iStt]);
+        pDFileSet->aSttF[iStt] = NULL;
+      }
+      for (int32_t iStt = pDFileSet->nSttF; iStt < pSet->nSttF; iStt++) {
+        pDFileSet->aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
+        if (pDFileSet->aSttF[iStt] == NULL) {
+          pDFileSet->nSttF = iStt;
           code = TSDB_CODE_OUT_OF_MEMORY;
           goto _exit;
         }
-        *pDFileSet->aSttF[pDFileSet->nSttF] = *pSet->aSttF[pSet->nSttF - 1];
-        pDFileSet->nSttF++;
-      } else if (pSet->nSttF < pDFileSet->nSttF) {
-        ASSERT(pSet->nSttF == 1);
-        for (int32_t iStt = 1; iStt < pDFileSet->nSttF; iStt++) {
-          taosMemoryFree(pDFileSet->aSttF[iStt]);
-        }
-
-        *pDFileSet->aSttF[0] = *pSet->aSttF[0];
-        pDFileSet->nSttF = 1;
-      } else {
-        for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
-          *pDFileSet->aSttF[iStt] = *pSet->aSttF[iStt];
-        }
       }
+      for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+        *pDFileSet->aSttF[iStt] = *pSet->aSttF[iStt];
+      }
+      pDFileSet->nSttF = pSet->nSttF;
 
       goto _exit;
     }
   }
 
-  ASSERT(pSet->nSttF == 1);
-  SDFileSet fSet = {.diskId = pSet->diskId, .fid = pSet->fid, .nSttF = 1};
+  SDFileSet fSet = {.diskId = pSet->diskId, .fid = pSet->fid, .nSttF = pSet->nSttF};
 
   // head
   fSet.pHeadF = (SHeadFile *)taosMemoryMalloc(sizeof(SHeadFile));
@@ -696,12 +688,14 @@ int32_t tsdbFSUpsertFSet(STsdbFS *pFS, SDFileSet *pSet) {
   *fSet.pSmaF = *pSet->pSmaF;
 
   // stt
-  fSet.aSttF[0] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-  if (fSet.aSttF[0] == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    fSet.aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
+    if (fSet.aSttF[iStt] == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    *fSet.aSttF[iStt] = *pSet->aSttF[iStt];
   }
-  *fSet.aSttF[0] = *pSet->aSttF[0];
 
   if (taosArrayInsert(pFS->aDFileSet, idx, &fSet) == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
@@ -870,73 +864,26 @@ int32_t tsdbFSCommit2(STsdb *pTsdb, STsdbFS *pFSNew) {
     }
 
     // stt
-    if (sameDisk) {
-      if (pSetNew->nSttF > pSetOld->nSttF) {
-        ASSERT(pSetNew->nSttF = pSetOld->nSttF + 1);
-        pSetOld->aSttF[pSetOld->nSttF] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-        if (pSetOld->aSttF[pSetOld->nSttF] == NULL) {
-          code = TSDB_CODE_OUT_OF_MEMORY;
-          goto _err;
-        }
-        *pSetOld->aSttF[pSetOld->nSttF] = *pSetNew->aSttF[pSetOld->nSttF];
-        pSetOld->aSttF[pSetOld->nSttF]->nRef = 1;
-        pSetOld->nSttF++;
-      } else if (pSetNew->nSttF < pSetOld->nSttF) {
-        ASSERT(pSetNew->nSttF == 1);
-        for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
-          SSttFile *pSttFile = pSetOld->aSttF[iStt];
-          nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
-          if (nRef == 0) {
-            tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
-            taosRemoveFile(fname);
-            taosMemoryFree(pSttFile);
-          }
-          pSetOld->aSttF[iStt] = NULL;
-        }
+    for (int32_t iStt = 0; iStt < TMAX(pSetOld->nSttF, pSetNew->nSttF); iStt++) {
+      SSttFile *pSttFile = (iStt < pSetOld->nSttF) ? pSetOld->aSttF[iStt] : NULL;
 
-        pSetOld->nSttF = 1;
-        pSetOld->aSttF[0] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-        if (pSetOld->aSttF[0] == NULL) {
-          code = TSDB_CODE_OUT_OF_MEMORY;
-          goto _err;
-        }
-        *pSetOld->aSttF[0] = *pSetNew->aSttF[0];
-        pSetOld->aSttF[0]->nRef = 1;
-      } else {
-        for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
-          if (pSetOld->aSttF[iStt]->commitID != pSetNew->aSttF[iStt]->commitID) {
-            SSttFile *pSttFile = pSetOld->aSttF[iStt];
-            nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
-            if (nRef == 0) {
-              tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
-              taosRemoveFile(fname);
-              taosMemoryFree(pSttFile);
-            }
-
-            pSetOld->aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-            if (pSetOld->aSttF[iStt] == NULL) {
-              code = TSDB_CODE_OUT_OF_MEMORY;
-              goto _err;
-            }
-            *pSetOld->aSttF[iStt] = *pSetNew->aSttF[iStt];
-            pSetOld->aSttF[iStt]->nRef = 1;
-          } else {
-            ASSERT(pSetOld->aSttF[iStt]->size == pSetOld->aSttF[iStt]->size);
-            ASSERT(pSetOld->aSttF[iStt]->offset == pSetOld->aSttF[iStt]->offset);
-          }
-        }
+      if (sameDisk && pSttFile && iStt < pSetNew->nSttF && pSttFile->commitID == pSetNew->aSttF[iStt]->commitID) {
+        ASSERT(pSttFile->size == pSetNew->aSttF[iStt]->size);
+        ASSERT(pSttFile->offset == pSetNew->aSttF[iStt]->offset);
+        continue;
       }
-    } else {
-      ASSERT(pSetOld->nSttF == pSetNew->nSttF);
-      for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
-        SSttFile *pSttFile = pSetOld->aSttF[iStt];
+
+      if (pSttFile) {
         nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
         if (nRef == 0) {
           tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
           taosRemoveFile(fname);
           taosMemoryFree(pSttFile);
         }
+        pSetOld->aSttF[iStt] = NULL;
+      }
 
+      if (iStt < pSetNew->nSttF) {
         pSetOld->aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
         if (pSetOld->aSttF[iStt] == NULL) {
           code = TSDB_CODE_OUT_OF_MEMORY;
@@ -946,6 +893,7 @@ int32_t tsdbFSCommit2(STsdb *pTsdb, STsdbFS *pFSNew) {
         pSetOld->aSttF[iStt]->nRef = 1;
       }
     }
+    pSetOld->nSttF = pSetNew->nSttF;
 
     if (!sameDisk) {
       pSetOld->diskId = pSetNew->diskId;
@@ -990,7 +938,7 @@ int32_t tsdbFSCommit2(STsdb *pTsdb, STsdbFS *pFSNew) {
     continue;
 
   _add_new:
-    fSet = (SDFileSet){.diskId = pSetNew->diskId, .fid = pSetNew->fid, .nSttF = 1};
+    fSet = (SDFileSet){.diskId = pSetNew->diskId, .fid = pSetNew->fid, .nSttF = pSetNew->nSttF};
 
     // head
     fSet.pHeadF = (SHeadFile *)taosMemoryMalloc(sizeof(SHeadFile));
@@ -1020,14 +968,15 @@ int32_t tsdbFSCommit2(STsdb *pTsdb, STsdbFS *pFSNew) {
     fSet.pSmaF->nRef = 1;
 
     // stt
-    ASSERT(pSetNew->nSttF == 1);
-    fSet.aSttF[0] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-    if (fSet.aSttF[0] == NULL) {
-      code = TSDB_CODE_OUT_OF_MEMORY;
-      goto _err;
+    for (int32_t iStt = 0; iStt < pSetNew->nSttF; iStt++) {
+      fSet.aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
+      if (fSet.aSttF[iStt] == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _err;
+      }
+      *fSet.aSttF[iStt] = *pSetNew->aSttF[iStt];
+      fSet.aSttF[iStt]->nRef = 1;
     }
-    *fSet.aSttF[0] = *pSetNew->aSttF[0];
-    fSet.aSttF[0]->nRef = 1;
 
     if (taosArrayInsert(pTsdb->fs.aDFileSet, iOld, &fSet) == NULL) {
       code = TSDB_CODE_OUT_OF_MEMORY;
@@ -346,7 +346,7 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   int32_t code = 0;
 
   // get
-  STbData *pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  STbData *pTbData = tsdbGetTbDataFromMemTable(pMemTable, suid, uid);
   if (pTbData) goto _exit;
 
   // create
@@ -606,10 +606,12 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
     tsdbCacheInsertLast(pMemTable->pTsdb->lruCache, pTbData->uid, pLastRow, pMemTable->pTsdb);
   }
 
-  // SMemTable
+  // SMemTable, tables may be inserted in parallel on wal replay
+  taosWLockLatch(&pMemTable->latch);
   pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
   pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
   pMemTable->nRow += nRow;
+  taosWUnLockLatch(&pMemTable->latch);
 
   pRsp->numOfRows = nRow;
   pRsp->affectedRows = nRow;
@@ -78,8 +78,10 @@ typedef struct SBlockLoadSuppInfo {
   SArray*          pColAgg;
   SColumnDataAgg   tsColAgg;
   SColumnDataAgg** plist;
-  int16_t*         colIds;    // column ids for loading file block data
-  char**           buildBuf;  // build string tmp buffer, todo remove it later after all string format being updated.
+  int16_t*         colIds;      // column ids for loading file block data
+  char**           buildBuf;    // build string tmp buffer, todo remove it later after all string format being updated.
+  bool*            delayLoad;   // columns of the file block loaded after the filter, see tsdbRetrieveDataBlockRest
+  int16_t*         loadColIds;  // column ids of the file block columns decoded by current load
 } SBlockLoadSuppInfo;
 
 typedef struct SLastBlockReader {
@@ -135,6 +137,8 @@ typedef struct SReaderStatus {
   SFileBlockDumpInfo   fBlockDumpInfo;
   SDFileSet*           pCurrentFileset;  // current opened file set
   SBlockData           fileBlockData;
+  bool                 delayedColLoad;   // the delayed columns of the current result block are not loaded yet
+  int32_t              resRowIndex;      // the first row of the current result block in the file block
   SFilesetIter         fileIter;
   SDataBlockIter       blockIter;
 } SReaderStatus;
@@ -203,9 +207,14 @@ static int32_t setColumnIdSlotList(STsdbReader* pReader, SSDataBlock* pBlock) {
 
   pSupInfo->colIds = taosMemoryMalloc(numOfCols * sizeof(int16_t));
   pSupInfo->buildBuf = taosMemoryCalloc(numOfCols, POINTER_BYTES);
-  if (pSupInfo->buildBuf == NULL || pSupInfo->colIds == NULL) {
+  pSupInfo->delayLoad = taosMemoryCalloc(numOfCols, sizeof(bool));
+  pSupInfo->loadColIds = taosMemoryMalloc(numOfCols * sizeof(int16_t));
+  if (pSupInfo->buildBuf == NULL || pSupInfo->colIds == NULL || pSupInfo->delayLoad == NULL ||
+      pSupInfo->loadColIds == NULL) {
     taosMemoryFree(pSupInfo->colIds);
     taosMemoryFree(pSupInfo->buildBuf);
+    taosMemoryFree(pSupInfo->delayLoad);
+    taosMemoryFree(pSupInfo->loadColIds);
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
@@ -481,7 +490,7 @@ static int32_t tsdbReaderCreate(SVnode* pVnode, SQueryTableDataCond* pCond, STsd
   pReader->pTsdb = getTsdbByRetentions(pVnode, pCond->twindows.skey, pVnode->config.tsdbCfg.retentions, idstr, &level);
   pReader->suid = pCond->suid;
   pReader->order = pCond->order;
-  pReader->capacity = 4096;
+  pReader->capacity = capacity;
   pReader->idStr = (idstr != NULL) ? strdup(idstr) : NULL;
   pReader->verRange = getQueryVerRange(pVnode, pCond, level);
   pReader->type = pCond->type;
@@ -820,12 +829,88 @@ int32_t getEndPosInDataBlock(STsdbReader* pReader, SBlockData* pBlockData, SData
   } else if (!asc && pReader->window.skey <= pBlock->minKey.ts) {
     endPos = 0;
   } else {
-    endPos = doBinarySearchKey(pBlockData->aTSKEY, pBlock->nRow, pos, pReader->window.ekey, pReader->order);
+    int64_t key = asc ? pReader->window.ekey : pReader->window.skey;
+    endPos = doBinarySearchKey(pBlockData->aTSKEY, pBlock->nRow, pos, key, pReader->order);
   }
 
   return endPos;
 }
 
+// Copy the rows [startIndex, startIndex + step * remain) of the decoded columns in pBlockData to the result block.
+// Only the result columns whose delay load flag equals to delayed are copied, and the rows not selected by pSelect are
+// left unset if pSelect is not NULL.
+static void copyFileBlockColumns(STsdbReader* pReader, SBlockData* pBlockData, int32_t startIndex, int32_t remain,
+                                 bool delayed, const int8_t* pSelect) {
+  SSDataBlock*        pResBlock = pReader->pResBlock;
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+  int32_t             numOfOutputCols = blockDataGetNumOfCols(pResBlock);
+  int32_t             step = ASCENDING_TRAVERSE(pReader->order) ? 1 : -1;
+  SColVal             cv = {0};
+
+  int32_t i = (pSupInfo->colIds[0] == PRIMARYKEY_TIMESTAMP_COL_ID) ? 1 : 0;
+  int32_t colIndex = 0;
+  int32_t num = taosArrayGetSize(pBlockData->aIdx);
+  while (i < numOfOutputCols && colIndex < num) {
+    if (pSupInfo->delayLoad[i] != delayed) {
+      i += 1;
+      continue;
+    }
+
+    int32_t          rowIndex = 0;
+    SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, i);
+
+    SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
+    if (pData->cid < pColData->info.colId) {
+      colIndex += 1;
+    } else if (pData->cid == pColData->info.colId) {
+      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL) {
+        colDataAppendNNULL(pColData, 0, remain);
+      } else {
+        if (IS_NUMERIC_TYPE(pColData->info.type) && step == 1) {
+          uint8_t* p = pData->pData + tDataTypes[pData->type].bytes * startIndex;
+          memcpy(pColData->pData, p, remain * tDataTypes[pData->type].bytes);
+
+          // null value exists, check one-by-one
+          if (pData->flag != HAS_VALUE) {
+            for (int32_t j = startIndex; rowIndex < remain; j += step, rowIndex++) {
+              uint8_t v = tColDataGetBitValue(pData, j);
+              if (v == 0 || v == 1) {
+                colDataSetNull_f(pColData->nullbitmap, rowIndex);
+              }
+            }
+          }
+        } else {
+          for (int32_t j = startIndex; rowIndex < remain; j += step, rowIndex++) {
+            if (pSelect != NULL && pSelect[rowIndex] == 0) {
+              if (IS_VAR_DATA_TYPE(pColData->info.type)) {
+                colDataAppendNULL(pColData, rowIndex);
+              }
+              continue;
+            }
+
+            tColDataGetValue(pData, j, &cv);
+            doCopyColVal(pColData, rowIndex, i, &cv, pSupInfo);
+          }
+        }
+      }
+
+      colIndex += 1;
+      i += 1;
+    } else {  // the specified column does not exist in file block, fill with null data
+      colDataAppendNNULL(pColData, 0, remain);
+      i += 1;
+    }
+  }
+
+  while (i < numOfOutputCols) {
+    if (pSupInfo->delayLoad[i] == delayed) {
+      SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, i);
+      colDataAppendNNULL(pColData, 0, remain);
+    }
+    i += 1;
+  }
+}
+
 static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo) {
   SReaderStatus*  pStatus = &pReader->status;
   SDataBlockIter* pBlockIter = &pStatus->blockIter;
@@ -834,12 +919,8 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(pBlockIter);
   SDataBlk*           pBlock = getCurrentBlock(pBlockIter);
   SSDataBlock*        pResBlock = pReader->pResBlock;
-  int32_t             numOfOutputCols = blockDataGetNumOfCols(pResBlock);
-
-  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
-  SColVal cv = {0};
   int64_t st = taosGetTimestampUs();
   bool    asc = ASCENDING_TRAVERSE(pReader->order);
   int32_t step = asc ? 1 : -1;
@@ -851,7 +932,8 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   } else {
     int32_t pos = asc? pBlock->nRow-1:0;
     int32_t order = (pReader->order == TSDB_ORDER_ASC)? TSDB_ORDER_DESC:TSDB_ORDER_ASC;
-    pDumpInfo->rowIndex = doBinarySearchKey(pBlockData->aTSKEY, pBlock->nRow, pos, pReader->window.skey, order);
+    int64_t key = asc ? pReader->window.skey : pReader->window.ekey;
+    pDumpInfo->rowIndex = doBinarySearchKey(pBlockData->aTSKEY, pBlock->nRow, pos, key, order);
   }
 
   // time window check
@@ -869,8 +951,7 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
 
   int32_t rowIndex = 0;
 
-  int32_t i = 0;
-  SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, i);
+  SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, 0);
   if (pColData->info.colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
     if (asc) {
       memcpy(pColData->pData, &pBlockData->aTSKEY[pDumpInfo->rowIndex], remain * sizeof(int64_t));
@@ -879,58 +960,11 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
         colDataAppendInt64(pColData, rowIndex++, &pBlockData->aTSKEY[j]);
       }
     }
-
-    i += 1;
-  }
-
-  int32_t colIndex = 0;
-  int32_t num = taosArrayGetSize(pBlockData->aIdx);
-  while (i < numOfOutputCols && colIndex < num) {
-    rowIndex = 0;
-    pColData = taosArrayGet(pResBlock->pDataBlock, i);
-
-    SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
-    if (pData->cid < pColData->info.colId) {
-      colIndex += 1;
-    } else if (pData->cid == pColData->info.colId) {
-      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL) {
-        colDataAppendNNULL(pColData, 0, remain);
-      } else {
-        if (IS_NUMERIC_TYPE(pColData->info.type) && asc) {
-          uint8_t* p = pData->pData + tDataTypes[pData->type].bytes * pDumpInfo->rowIndex;
-          memcpy(pColData->pData, p, remain * tDataTypes[pData->type].bytes);
-
-          // null value exists, check one-by-one
-          if (pData->flag != HAS_VALUE) {
-            for (int32_t j = pDumpInfo->rowIndex; rowIndex < remain; j += step, rowIndex++) {
-              uint8_t v = tColDataGetBitValue(pData, j);
-              if (v == 0 || v == 1) {
-                colDataSetNull_f(pColData->nullbitmap, rowIndex);
-              }
-            }
-          }
-        } else {
-          for (int32_t j = pDumpInfo->rowIndex; rowIndex < remain; j += step) {
-            tColDataGetValue(pData, j, &cv);
-            doCopyColVal(pColData, rowIndex++, i, &cv, pSupInfo);
-          }
-        }
-      }
-
-      colIndex += 1;
-      i += 1;
-    } else {  // the specified column does not exist in file block, fill with null data
-      colDataAppendNNULL(pColData, 0, remain);
-      i += 1;
-    }
   }
 
-  while (i < numOfOutputCols) {
-    pColData = taosArrayGet(pResBlock->pDataBlock, i);
-    colDataAppendNNULL(pColData, 0, remain);
-    i += 1;
-  }
+  copyFileBlockColumns(pReader, pBlockData, pDumpInfo->rowIndex, remain, false, NULL);
 
+  pStatus->resRowIndex = pDumpInfo->rowIndex;
   pResBlock->info.rows = remain;
   pDumpInfo->rowIndex += step * remain;
 
@@ -3290,6 +3324,48 @@ void* tsdbGetIvtIdx(SMeta* pMeta) {
 
 uint64_t getReaderMaxVersion(STsdbReader* pReader) { return pReader->verRange.maxVer; }
 
+// the schema, the tables, the read snapshot and the first file block of a reader, for the inner readers of an
+// external range as well
+static int32_t initReaderForTables(STsdbReader* pReader, SArray* pTableList) {
+  // NOTE: the endVersion in pCond is the data version not schema version, so pCond->endVersion is not correct here.
+  if (pReader->suid != 0) {
+    pReader->pSchema = metaGetTbTSchema(pReader->pTsdb->pVnode->pMeta, pReader->suid, /*pCond->endVersion*/ -1);
+    if (pReader->pSchema == NULL) {
+      tsdbError("failed to get table schema, suid:%"PRIu64", ver:%"PRId64" , %s", pReader->suid, -1, pReader->idStr);
+    }
+  } else if (taosArrayGetSize(pTableList) > 0) {
+    STableKeyInfo* pKey = taosArrayGet(pTableList, 0);
+    pReader->pSchema = metaGetTbTSchema(pReader->pTsdb->pVnode->pMeta, pKey->uid, /*pCond->endVersion*/ -1);
+    if (pReader->pSchema == NULL) {
+      tsdbError("failed to get table schema, uid:%"PRIu64", ver:%"PRId64" , %s", pKey->uid, -1, pReader->idStr);
+    }
+  }
+
+  int32_t numOfTables = taosArrayGetSize(pTableList);
+  pReader->status.pTableMap = createDataBlockScanInfo(pReader, pTableList->pData, numOfTables);
+  if (pReader->status.pTableMap == NULL) {
+    return TSDB_CODE_TDB_OUT_OF_MEMORY;
+  }
+
+  int32_t code = tsdbTakeReadSnap(pReader->pTsdb, &pReader->pReadSnap, pReader->idStr);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SDataBlockIter* pBlockIter = &pReader->status.blockIter;
+
+  initFilesetIterator(&pReader->status.fileIter, pReader->pReadSnap->fs.aDFileSet, pReader);
+  resetDataBlockIterator(&pReader->status.blockIter, pReader->order);
+
+  // no data in files, let's try buffer in memory
+  if (pReader->status.fileIter.numOfFiles == 0) {
+    pReader->status.loadFromFile = false;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return initForFirstBlockInFile(pReader, pBlockIter);
+}
+
 // ====================================== EXPOSED APIs ======================================
 int32_t tsdbReaderOpen(SVnode* pVnode, SQueryTableDataCond* pCond, SArray* pTableList, STsdbReader** ppReader,
                        const char* idstr) {
@@ -3321,90 +3397,42 @@ int32_t tsdbReaderOpen(SVnode* pVnode, SQueryTableDataCond* pCond, SArray* pTabl
 
     // here we only need one more row, so the capacity is set to be ONE.
     code = tsdbReaderCreate(pVnode, pCond, &pReader->innerReader[0], 1, idstr);
-    if (code != TSDB_CODE_SUCCESS) {
-      goto _err;
+    if (code == TSDB_CODE_SUCCESS) {
+      if (order == TSDB_ORDER_ASC) {
+        pCond->twindows.skey = w.ekey;
+        pCond->twindows.ekey = INT64_MAX;
+        pCond->order = TSDB_ORDER_ASC;
+      } else {
+        pCond->twindows.skey = INT64_MIN;
+        pCond->twindows.ekey = w.skey;
+        pCond->order = TSDB_ORDER_DESC;
+      }
+      code = tsdbReaderCreate(pVnode, pCond, &pReader->innerReader[1], 1, idstr);
     }
 
-    if (order == TSDB_ORDER_ASC) {
-      pCond->twindows.skey = w.ekey;
-      pCond->twindows.ekey = INT64_MAX;
-    } else {
-      pCond->twindows.skey = INT64_MIN;
-      pCond->twindows.ekey = w.ekey;
-    }
-    code = tsdbReaderCreate(pVnode, pCond, &pReader->innerReader[1], 1, idstr);
+    // the query condition of the caller is left as it is
+    pCond->twindows = w;
+    pCond->order = order;
     if (code != TSDB_CODE_SUCCESS) {
       goto _err;
     }
   }
 
-  // NOTE: the endVersion in pCond is the data version not schema version, so pCond->endVersion is not correct here.
-  if (pCond->suid != 0) {
-    pReader->pSchema = metaGetTbTSchema(pReader->pTsdb->pVnode->pMeta, pReader->suid, /*pCond->endVersion*/ -1);
-    if (pReader->pSchema == NULL) {
-      tsdbError("failed to get table schema, suid:%"PRIu64", ver:%"PRId64" , %s", pReader->suid, -1, pReader->idStr);
-    }
-  } else if (taosArrayGetSize(pTableList) > 0) {
-    STableKeyInfo* pKey = taosArrayGet(pTableList, 0);
-    pReader->pSchema = metaGetTbTSchema(pReader->pTsdb->pVnode->pMeta, pKey->uid, /*pCond->endVersion*/ -1);
-    if (pReader->pSchema == NULL) {
-      tsdbError("failed to get table schema, uid:%"PRIu64", ver:%"PRId64" , %s", pKey->uid, -1, pReader->idStr);
+  code = initReaderForTables(pReader, pTableList);
+  for (int32_t i = 0; i < tListLen(pReader->innerReader) && code == TSDB_CODE_SUCCESS; ++i) {
+    if (pReader->innerReader[i] != NULL) {
+      code = initReaderForTables(pReader->innerReader[i], pTableList);
     }
   }
 
-  int32_t numOfTables = taosArrayGetSize(pTableList);
-  pReader->status.pTableMap = createDataBlockScanInfo(pReader, pTableList->pData, numOfTables);
-  if (pReader->status.pTableMap == NULL) {
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("failed to create data reader, code:%s %s", tstrerror(code), idstr);
     tsdbReaderClose(pReader);
     *ppReader = NULL;
-
-    code = TSDB_CODE_TDB_OUT_OF_MEMORY;
-    goto _err;
-  }
-
-  code = tsdbTakeReadSnap(pReader->pTsdb, &pReader->pReadSnap, pReader->idStr);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto _err;
-  }
-
-  if (pReader->type == TIMEWINDOW_RANGE_CONTAINED) {
-    SDataBlockIter* pBlockIter = &pReader->status.blockIter;
-
-    initFilesetIterator(&pReader->status.fileIter, pReader->pReadSnap->fs.aDFileSet, pReader);
-    resetDataBlockIterator(&pReader->status.blockIter, pReader->order);
-
-    // no data in files, let's try buffer in memory
-    if (pReader->status.fileIter.numOfFiles == 0) {
-      pReader->status.loadFromFile = false;
-    } else {
-      code = initForFirstBlockInFile(pReader, pBlockIter);
-      if (code != TSDB_CODE_SUCCESS) {
-        return code;
-      }
-    }
-  } else {
-    STsdbReader*    pPrevReader = pReader->innerReader[0];
-    SDataBlockIter* pBlockIter = &pPrevReader->status.blockIter;
-
-    code = tsdbTakeReadSnap(pPrevReader->pTsdb, &pPrevReader->pReadSnap, pReader->idStr);
-    if (code != TSDB_CODE_SUCCESS) {
-      goto _err;
-    }
-
-    initFilesetIterator(&pPrevReader->status.fileIter, pPrevReader->pReadSnap->fs.aDFileSet, pPrevReader);
-    resetDataBlockIterator(&pPrevReader->status.blockIter, pPrevReader->order);
-
-    // no data in files, let's try buffer in memory
-    if (pPrevReader->status.fileIter.numOfFiles == 0) {
-      pPrevReader->status.loadFromFile = false;
-    } else {
-      code = initForFirstBlockInFile(pPrevReader, pBlockIter);
-      if (code != TSDB_CODE_SUCCESS) {
-        return code;
-      }
-    }
+    return code;
   }
 
+  int32_t numOfTables = taosArrayGetSize(pTableList);
   tsdbDebug("%p total numOfTable:%d in this query %s", pReader, numOfTables, pReader->idStr);
   return code;
 
@@ -3418,10 +3446,16 @@ void tsdbReaderClose(STsdbReader* pReader) {
     return;
   }
 
+  // the inner readers of an external range not exhausted yet
+  tsdbReaderClose(pReader->innerReader[0]);
+  tsdbReaderClose(pReader->innerReader[1]);
+
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
 
   taosMemoryFreeClear(pSupInfo->plist);
   taosMemoryFree(pSupInfo->colIds);
+  taosMemoryFree(pSupInfo->delayLoad);
+  taosMemoryFree(pSupInfo->loadColIds);
 
   taosArrayDestroy(pSupInfo->pColAgg);
   for (int32_t i = 0; i < blockDataGetNumOfCols(pReader->pResBlock); ++i) {
@@ -3476,10 +3510,16 @@ void tsdbReaderClose(STsdbReader* pReader) {
   taosMemoryFreeClear(pReader);
 }
 
+static void clearDelayLoadColumns(STsdbReader* pReader) {
+  memset(pReader->suppInfo.delayLoad, 0, blockDataGetNumOfCols(pReader->pResBlock) * sizeof(bool));
+  pReader->status.delayedColLoad = false;
+}
+
 static bool doTsdbNextDataBlock(STsdbReader* pReader) {
   // cleanup the data that belongs to the previous data block
   SSDataBlock* pBlock = pReader->pResBlock;
   blockDataCleanup(pBlock);
+  clearDelayLoadColumns(pReader);
 
   SReaderStatus* pStatus = &pReader->status;
 
@@ -3508,32 +3548,31 @@ bool tsdbNextDataBlock(STsdbReader* pReader) {
     return false;
   }
 
-  if (pReader->innerReader[0] != NULL) {
-    bool ret = doTsdbNextDataBlock(pReader->innerReader[0]);
-    if (ret) {
-      pReader->step = EXTERNAL_ROWS_PREV;
-      return ret;
+  // only the first block of an inner reader is returned, i.e. the row closest to the range, see tsdbReaderOpen
+  if (pReader->innerReader[0] != NULL && pReader->step == 0) {
+    pReader->step = EXTERNAL_ROWS_PREV;
+    if (doTsdbNextDataBlock(pReader->innerReader[0])) {
+      return true;
     }
+  }
 
+  if (pReader->innerReader[0] != NULL) {
     tsdbReaderClose(pReader->innerReader[0]);
     pReader->innerReader[0] = NULL;
   }
 
-  pReader->step = EXTERNAL_ROWS_MAIN;
-  bool ret = doTsdbNextDataBlock(pReader);
-  if (ret) {
-    return ret;
+  if (pReader->step != EXTERNAL_ROWS_NEXT) {
+    pReader->step = EXTERNAL_ROWS_MAIN;
+    if (doTsdbNextDataBlock(pReader)) {
+      return true;
+    }
   }
 
-  if (pReader->innerReader[1] != NULL) {
-    bool ret1 = doTsdbNextDataBlock(pReader->innerReader[1]);
-    if (ret1) {
-      pReader->step = EXTERNAL_ROWS_NEXT;
-      return ret1;
+  if (pReader->innerReader[1] != NULL && pReader->step == EXTERNAL_ROWS_MAIN) {
+    pReader->step = EXTERNAL_ROWS_NEXT;
+    if (doTsdbNextDataBlock(pReader->innerReader[1])) {
+      return true;
     }
-
-    tsdbReaderClose(pReader->innerReader[1]);
-    pReader->innerReader[1] = NULL;
   }
 
   return false;
@@ -3638,7 +3677,50 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SColumnDataAgg*** pBlockS
   return code;
 }
 
-static SArray* doRetrieveDataBlock(STsdbReader* pReader) {
+// the result columns not in pIdList are delayed, and the flags are cleared when the reader moves to the next block
+static bool setDelayLoadColumns(STsdbReader* pReader, const SArray* pIdList) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  int32_t             numOfCols = blockDataGetNumOfCols(pReader->pResBlock);
+  int32_t             numOfIds = taosArrayGetSize(pIdList);
+  bool                delayed = false;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (pSup->colIds[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
+      continue;
+    }
+
+    pSup->delayLoad[i] = true;
+    for (int32_t j = 0; j < numOfIds; ++j) {
+      if (*(int16_t*)taosArrayGet(pIdList, j) == pSup->colIds[i]) {
+        pSup->delayLoad[i] = false;
+        break;
+      }
+    }
+
+    delayed |= pSup->delayLoad[i];
+  }
+
+  return delayed;
+}
+
+// only the result columns are decoded, instead of all the columns in the schema
+static int32_t initFileBlockData(STsdbReader* pReader, uint64_t uid, bool delayed) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SBlockData*         pBlockData = &pReader->status.fileBlockData;
+  int32_t             numOfCols = blockDataGetNumOfCols(pReader->pResBlock);
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (pSup->colIds[i] != PRIMARYKEY_TIMESTAMP_COL_ID && pSup->delayLoad[i] == delayed) {
+      pSup->loadColIds[num++] = pSup->colIds[i];
+    }
+  }
+
+  tBlockDataReset(pBlockData);
+  return tBlockDataInitByCols(pBlockData, pReader->suid, uid, pReader->pSchema, pSup->loadColIds, num);
+}
+
+static SArray* doRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
   SReaderStatus* pStatus = &pReader->status;
 
   if (pStatus->composedDataBlock) {
@@ -3647,9 +3729,15 @@ static SArray* doRetrieveDataBlock(STsdbReader* pReader) {
 
   SFileDataBlockInfo*  pFBlock = getCurrentBlockInfo(&pStatus->blockIter);
   STableBlockScanInfo* pBlockScanInfo = taosHashGet(pStatus->pTableMap, &pFBlock->uid, sizeof(pFBlock->uid));
+  SDataBlk*            pBlock = getCurrentBlock(&pStatus->blockIter);
+
+  // the rows left in a partially copied block are merged from the decoded columns later, which need all the columns
+  bool delayed = false;
+  if (pIdList != NULL && pBlock->nRow <= pReader->capacity) {
+    delayed = setDelayLoadColumns(pReader, pIdList);
+  }
 
-  tBlockDataReset(&pStatus->fileBlockData);
-  int32_t code = tBlockDataInit(&pStatus->fileBlockData, pReader->suid, pBlockScanInfo->uid, pReader->pSchema);
+  int32_t code = initFileBlockData(pReader, pBlockScanInfo->uid, false);
   if (code != TSDB_CODE_SUCCESS) {
     terrno = code;
     return NULL;
@@ -3663,19 +3751,70 @@ static SArray* doRetrieveDataBlock(STsdbReader* pReader) {
   }
 
   copyBlockDataToSDataBlock(pReader, pBlockScanInfo);
+  pStatus->delayedColLoad = delayed && (pReader->pResBlock->info.rows > 0);
+  return pReader->pResBlock->pDataBlock;
+}
+
+static SArray* doRetrieveDataBlockRest(STsdbReader* pReader, const int8_t* pSelect) {
+  SReaderStatus* pStatus = &pReader->status;
+  if (!pStatus->delayedColLoad) {
+    return pReader->pResBlock->pDataBlock;
+  }
+
+  SFileDataBlockInfo* pFBlock = getCurrentBlockInfo(&pStatus->blockIter);
+  SDataBlk*           pBlock = getCurrentBlock(&pStatus->blockIter);
+
+  int32_t code = initFileBlockData(pReader, pFBlock->uid, true);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return NULL;
+  }
+
+  // the block has been dumped, so the dump info is not touched here
+  int64_t st = taosGetTimestampUs();
+  code = tsdbReadDataBlock(pReader->pFileReader, pBlock, &pStatus->fileBlockData);
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("%p error occurs in loading delayed columns of file block, brange:%" PRId64 "-%" PRId64
+              ", rows:%d, code:%s %s",
+              pReader, pBlock->minKey.ts, pBlock->maxKey.ts, pBlock->nRow, tstrerror(code), pReader->idStr);
+    terrno = code;
+    return NULL;
+  }
+
+  copyFileBlockColumns(pReader, &pStatus->fileBlockData, pStatus->resRowIndex, pReader->pResBlock->info.rows, true,
+                       pSelect);
+  pStatus->delayedColLoad = false;
+
+  double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
+  pReader->cost.blockLoadTime += elapsedTime;
+
+  tsdbDebug("%p load delayed columns of file block, brange:%" PRId64 "-%" PRId64 ", rows:%d, elapsed time:%.2f ms, %s",
+            pReader, pBlock->minKey.ts, pBlock->maxKey.ts, pReader->pResBlock->info.rows, elapsedTime, pReader->idStr);
   return pReader->pResBlock->pDataBlock;
 }
 
 SArray* tsdbRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
   if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
     if (pReader->step == EXTERNAL_ROWS_PREV) {
-      return doRetrieveDataBlock(pReader->innerReader[0]);
+      return doRetrieveDataBlock(pReader->innerReader[0], pIdList);
+    } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
+      return doRetrieveDataBlock(pReader->innerReader[1], pIdList);
+    }
+  }
+
+  return doRetrieveDataBlock(pReader, pIdList);
+}
+
+SArray* tsdbRetrieveDataBlockRest(STsdbReader* pReader, const int8_t* pSelect) {
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    if (pReader->step == EXTERNAL_ROWS_PREV) {
+      return doRetrieveDataBlockRest(pReader->innerReader[0], pSelect);
     } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
-      return doRetrieveDataBlock(pReader->innerReader[1]);
+      return doRetrieveDataBlockRest(pReader->innerReader[1], pSelect);
     }
   }
 
-  return doRetrieveDataBlock(pReader);
+  return doRetrieveDataBlockRest(pReader, pSelect);
 }
 
 int32_t tsdbReaderReset(STsdbReader* pReader, SQueryTableDataCond* pCond) {
@@ -15,6 +15,39 @@
 
 #include "tsdb.h"
 
+// SNAP_DATA_TSDB_FILE ====================================
+#define TSDB_SNAP_FILE_CHUNK_SIZE (1 << 20)
+#define TSDB_SNAP_FILE_SET_INFO   (-1)
+#define TSDB_SNAP_NFILE(pSet)     (3 + (pSet)->nSttF)  // head, data, sma, stt...
+
+typedef struct {
+  int32_t  fid;
+  int32_t  iFile;   // TSDB_SNAP_FILE_SET_INFO, or index of the file in the set
+  int64_t  offset;  // offset of the chunk in the file
+  int64_t  size;    // size of the file on disk
+  uint32_t cksum;   // checksum of the chunk
+} STsdbSnapFileHdr;
+
+static void tsdbSnapFileName(STsdb* pTsdb, SDFileSet* pSet, int32_t iFile, char fname[], int64_t* size) {
+  int64_t lSize;
+
+  if (iFile == 0) {
+    tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+    lSize = pSet->pHeadF->size;
+  } else if (iFile == 1) {
+    tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+    lSize = pSet->pDataF->size;
+  } else if (iFile == 2) {
+    tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+    lSize = pSet->pSmaF->size;
+  } else {
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iFile - 3], fname);
+    lSize = pSet->aSttF[iFile - 3]->size;
+  }
+
+  *size = tsdbLogicToFileSize(lSize, pTsdb->pVnode->config.tsdbPageSize);
+}
+
 // STsdbSnapReader ========================================
 typedef enum { SNAP_DATA_FILE_ITER = 0, SNAP_STT_FILE_ITER } EFIterT;
 typedef struct {
@@ -54,6 +87,14 @@ struct STsdbSnapReader {
   SFDataIter    aFDataIter[TSDB_MAX_STT_TRIGGER + 1];
   SBlockData    bData;
   SSkmInfo      skmTable;
+  // for whole file copy
+  int8_t     copyFile;
+  SDFileSet* pCopySet;
+  int8_t     copySetSent;
+  int32_t    iCopyFile;
+  TdFilePtr  pCopyFD;
+  int64_t    copyOffset;
+  int64_t    copySize;
   // for del file
   int8_t       delDone;
   SDelFReader* pDelFReader;
@@ -75,6 +116,20 @@ static int32_t tsdbSnapReadOpenFile(STsdbSnapReader* pReader) {
   if (pSet == NULL) return code;
 
   pReader->fid = pSet->fid;
+
+  // ship the whole file set as it is, the stt files of a set share one commit id at the receiver
+  if (pReader->copyFile && pSet->nSttF <= 1) {
+    pReader->pCopySet = pSet;
+    pReader->copySetSent = 0;
+    pReader->iCopyFile = 0;
+    pReader->copyOffset = 0;
+    pReader->copySize = 0;
+
+    tsdbInfo("vgId:%d, vnode snapshot tsdb open data file to copy for %s, fid:%d", TD_VID(pReader->pTsdb->pVnode),
+             pReader->pTsdb->path, pReader->fid);
+    return code;
+  }
+
   code = tsdbDataFReaderOpen(&pReader->pDataFReader, pReader->pTsdb, pSet);
   if (code) goto _err;
 
@@ -295,16 +350,118 @@ _exit:
   return code;
 }
 
+static int32_t tsdbSnapReadFileChunk(STsdbSnapReader* pReader, uint8_t** ppData) {
+  int32_t    code = 0;
+  STsdb*     pTsdb = pReader->pTsdb;
+  SDFileSet* pSet = pReader->pCopySet;
+  char       fname[TSDB_FILENAME_LEN];
+
+  // file set info first
+  if (!pReader->copySetSent) {
+    int32_t size = sizeof(STsdbSnapFileHdr) + tPutDFileSet(NULL, pSet);
+    *ppData = taosMemoryMalloc(sizeof(SSnapDataHdr) + size);
+    if (*ppData == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+
+    SSnapDataHdr*     pHdr = (SSnapDataHdr*)*ppData;
+    STsdbSnapFileHdr* pFHdr = (STsdbSnapFileHdr*)pHdr->data;
+    pHdr->type = SNAP_DATA_TSDB_FILE;
+    pHdr->size = size;
+    pFHdr->fid = pSet->fid;
+    pFHdr->iFile = TSDB_SNAP_FILE_SET_INFO;
+    pFHdr->offset = 0;
+    pFHdr->size = size - sizeof(STsdbSnapFileHdr);
+    tPutDFileSet(pHdr->data + sizeof(STsdbSnapFileHdr), pSet);
+    pFHdr->cksum = taosCalcChecksum(0, pHdr->data + sizeof(STsdbSnapFileHdr), pFHdr->size);
+
+    pReader->copySetSent = 1;
+    return code;
+  }
+
+  while (true) {
+    if (pReader->pCopyFD == NULL) {
+      if (pReader->iCopyFile >= TSDB_SNAP_NFILE(pSet)) {
+        // file set done
+        pReader->pCopySet = NULL;
+        return code;
+      }
+
+      tsdbSnapFileName(pTsdb, pSet, pReader->iCopyFile, fname, &pReader->copySize);
+      pReader->copyOffset = 0;
+      if (pReader->copySize == 0) {
+        pReader->iCopyFile++;
+        continue;
+      }
+
+      pReader->pCopyFD = taosOpenFile(fname, TD_FILE_READ);
+      if (pReader->pCopyFD == NULL) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        goto _err;
+      }
+    }
+
+    if (pReader->copyOffset >= pReader->copySize) {
+      taosCloseFile(&pReader->pCopyFD);
+      pReader->iCopyFile++;
+      continue;
+    }
+
+    int64_t n = TMIN(TSDB_SNAP_FILE_CHUNK_SIZE, pReader->copySize - pReader->copyOffset);
+    *ppData = taosMemoryMalloc(sizeof(SSnapDataHdr) + sizeof(STsdbSnapFileHdr) + n);
+    if (*ppData == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+
+    SSnapDataHdr*     pHdr = (SSnapDataHdr*)*ppData;
+    STsdbSnapFileHdr* pFHdr = (STsdbSnapFileHdr*)pHdr->data;
+    uint8_t*          pChunk = pHdr->data + sizeof(STsdbSnapFileHdr);
+
+    if (taosReadFile(pReader->pCopyFD, pChunk, n) != n) {
+      taosMemoryFree(*ppData);
+      *ppData = NULL;
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _err;
+    }
+
+    pHdr->type = SNAP_DATA_TSDB_FILE;
+    pHdr->size = sizeof(STsdbSnapFileHdr) + n;
+    pFHdr->fid = pSet->fid;
+    pFHdr->iFile = pReader->iCopyFile;
+    pFHdr->offset = pReader->copyOffset;
+    pFHdr->size = pReader->copySize;
+    pFHdr->cksum = taosCalcChecksum(0, pChunk, n);
+
+    pReader->copyOffset += n;
+    return code;
+  }
+
+_err:
+  tsdbError("vgId:%d, vnode snapshot tsdb read file chunk for %s failed since %s", TD_VID(pTsdb->pVnode), pTsdb->path,
+            tstrerror(code));
+  return code;
+}
+
 static int32_t tsdbSnapReadData(STsdbSnapReader* pReader, uint8_t** ppData) {
   int32_t code = 0;
   STsdb*  pTsdb = pReader->pTsdb;
 
   while (true) {
-    if (pReader->pDataFReader == NULL) {
+    if (pReader->pDataFReader == NULL && pReader->pCopySet == NULL) {
       code = tsdbSnapReadOpenFile(pReader);
       if (code) goto _err;
     }
 
+    if (pReader->pCopySet) {
+      code = tsdbSnapReadFileChunk(pReader, ppData);
+      if (code) goto _err;
+
+      if (*ppData) break;
+      continue;
+    }
+
     if (pReader->pDataFReader == NULL) break;
 
     SRowInfo* pRowInfo = tsdbSnapGetRow(pReader);
@@ -450,6 +607,8 @@ int32_t tsdbSnapReaderOpen(STsdb* pTsdb, int64_t sver, int64_t ever, int8_t type
   pReader->sver = sver;
   pReader->ever = ever;
   pReader->type = type;
+  // a full snapshot covers all versions in the data files, so they can be copied without re-encoding
+  pReader->copyFile = (type == SNAP_DATA_TSDB && sver == 0);
 
   code = taosThreadRwlockRdlock(&pTsdb->rwLock);
   if (code) {
@@ -524,6 +683,7 @@ int32_t tsdbSnapReaderClose(STsdbSnapReader** ppReader) {
 
   // data
   if (pReader->pDataFReader) tsdbDataFReaderClose(&pReader->pDataFReader);
+  if (pReader->pCopyFD) taosCloseFile(&pReader->pCopyFD);
   for (int32_t iIter = 0; iIter < sizeof(pReader->aFDataIter) / sizeof(pReader->aFDataIter[0]); iIter++) {
     SFDataIter* pIter = &pReader->aFDataIter[iIter];
 
@@ -641,6 +801,19 @@ struct STsdbSnapWriter {
     SBlockData    sData;
   } dWriter;
 
+  // for whole file copy
+  struct {
+    int8_t    inUse;
+    SDFileSet wSet;
+    SHeadFile fHead;
+    SDataFile fData;
+    SSmaFile  fSma;
+    SSttFile  fStt[TSDB_MAX_STT_TRIGGER];
+    int32_t   iFile;
+    TdFilePtr pFD;
+    int64_t   offset;
+  } fCopy;
+
   // for del file
   SDelFReader* pDelFReader;
   SDelFWriter* pDelFWriter;
@@ -1243,6 +1416,196 @@ _err:
   return code;
 }
 
+// SNAP_DATA_TSDB_FILE
+static int32_t tsdbSnapWriteFileClose(STsdbSnapWriter* pWriter) {
+  int32_t code = 0;
+
+  if (pWriter->fCopy.pFD == NULL) return code;
+
+  if (taosFsyncFile(pWriter->fCopy.pFD) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  }
+  taosCloseFile(&pWriter->fCopy.pFD);
+
+  return code;
+}
+
+// check the current file is received completely and the skipped ones before iFileTo are empty
+static int32_t tsdbSnapWriteFileCheck(STsdbSnapWriter* pWriter, int32_t iFileTo) {
+  SDFileSet* pSet = &pWriter->fCopy.wSet;
+  char       fname[TSDB_FILENAME_LEN];
+  int64_t    size;
+
+  if (pWriter->fCopy.iFile >= 0) {
+    tsdbSnapFileName(pWriter->pTsdb, pSet, pWriter->fCopy.iFile, fname, &size);
+    if (pWriter->fCopy.offset != size) return TSDB_CODE_FILE_CORRUPTED;
+  }
+
+  for (int32_t iFile = pWriter->fCopy.iFile + 1; iFile < iFileTo; iFile++) {
+    tsdbSnapFileName(pWriter->pTsdb, pSet, iFile, fname, &size);
+    if (size != 0) return TSDB_CODE_FILE_CORRUPTED;
+  }
+
+  return 0;
+}
+
+static int32_t tsdbSnapWriteFileSetEnd(STsdbSnapWriter* pWriter) {
+  int32_t    code = 0;
+  STsdb*     pTsdb = pWriter->pTsdb;
+  SDFileSet* pSet = &pWriter->fCopy.wSet;
+
+  ASSERT(pWriter->fCopy.inUse);
+
+  code = tsdbSnapWriteFileClose(pWriter);
+  if (code) goto _err;
+
+  code = tsdbSnapWriteFileCheck(pWriter, TSDB_SNAP_NFILE(pSet));
+  if (code) goto _err;
+
+  code = tsdbFSUpsertFSet(&pWriter->fs, pSet);
+  if (code) goto _err;
+
+  pWriter->fCopy.inUse = 0;
+
+  tsdbInfo("vgId:%d, vnode snapshot tsdb file set copied for %s, fid:%d", TD_VID(pTsdb->pVnode), pTsdb->path,
+           pSet->fid);
+  return code;
+
+_err:
+  tsdbError("vgId:%d, vnode snapshot tsdb write file set end for %s failed since %s, fid:%d", TD_VID(pTsdb->pVnode),
+            pTsdb->path, tstrerror(code), pSet->fid);
+  return code;
+}
+
+static int32_t tsdbSnapWriteFileSetStart(STsdbSnapWriter* pWriter, STsdbSnapFileHdr* pFHdr, uint8_t* pInfo) {
+  int32_t   code = 0;
+  STsdb*    pTsdb = pWriter->pTsdb;
+  SDFileSet fSet = {0};
+
+  if (tGetDFileSet(pInfo, &fSet) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  if (fSet.fid != pFHdr->fid || fSet.nSttF > TSDB_MAX_STT_TRIGGER) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _exit;
+  }
+
+  // files are renamed with the commit id of this writer
+  SDiskID did = {0};
+  tfsAllocDisk(pTsdb->pVnode->pTfs, 0, &did);
+  tfsMkdirRecurAt(pTsdb->pVnode->pTfs, pTsdb->path, did);
+
+  SDFileSet* pSet = &pWriter->fCopy.wSet;
+  *pSet = (SDFileSet){.diskId = did, .fid = fSet.fid, .nSttF = fSet.nSttF};
+  pWriter->fCopy.fHead = (SHeadFile){.commitID = pWriter->commitID,
+                                     .size = fSet.pHeadF->size,
+                                     .offset = fSet.pHeadF->offset};
+  pWriter->fCopy.fData = (SDataFile){.commitID = pWriter->commitID, .size = fSet.pDataF->size};
+  pWriter->fCopy.fSma = (SSmaFile){.commitID = pWriter->commitID, .size = fSet.pSmaF->size};
+  pSet->pHeadF = &pWriter->fCopy.fHead;
+  pSet->pDataF = &pWriter->fCopy.fData;
+  pSet->pSmaF = &pWriter->fCopy.fSma;
+  for (int32_t iStt = 0; iStt < fSet.nSttF; iStt++) {
+    pWriter->fCopy.fStt[iStt] = (SSttFile){.commitID = pWriter->commitID,
+                                           .size = fSet.aSttF[iStt]->size,
+                                           .offset = fSet.aSttF[iStt]->offset};
+    pSet->aSttF[iStt] = &pWriter->fCopy.fStt[iStt];
+  }
+
+  pWriter->fCopy.iFile = TSDB_SNAP_FILE_SET_INFO;
+  pWriter->fCopy.offset = 0;
+  pWriter->fCopy.inUse = 1;
+
+_exit:
+  taosMemoryFree(fSet.pHeadF);
+  taosMemoryFree(fSet.pDataF);
+  taosMemoryFree(fSet.pSmaF);
+  for (int32_t iStt = 0; iStt < TMIN(fSet.nSttF, TSDB_MAX_STT_TRIGGER); iStt++) {
+    taosMemoryFree(fSet.aSttF[iStt]);
+  }
+  return code;
+}
+
+static int32_t tsdbSnapWriteFile(STsdbSnapWriter* pWriter, uint8_t* pData, uint32_t nData) {
+  int32_t           code = 0;
+  STsdb*            pTsdb = pWriter->pTsdb;
+  SSnapDataHdr*     pHdr = (SSnapDataHdr*)pData;
+  STsdbSnapFileHdr* pFHdr = (STsdbSnapFileHdr*)pHdr->data;
+  uint8_t*          pChunk = pHdr->data + sizeof(STsdbSnapFileHdr);
+  int64_t           n = pHdr->size - sizeof(STsdbSnapFileHdr);
+  char              fname[TSDB_FILENAME_LEN];
+  int64_t           size;
+
+  if (pHdr->size < sizeof(STsdbSnapFileHdr) || taosCalcChecksum(0, pChunk, n) != pFHdr->cksum) {
+    code = TSDB_CODE_CHECKSUM_ERROR;
+    goto _err;
+  }
+
+  // file set info
+  if (pFHdr->iFile == TSDB_SNAP_FILE_SET_INFO) {
+    if (pWriter->fCopy.inUse) {
+      code = tsdbSnapWriteFileSetEnd(pWriter);
+      if (code) goto _err;
+    }
+
+    code = tsdbSnapWriteFileSetStart(pWriter, pFHdr, pChunk);
+    if (code) goto _err;
+
+    goto _exit;
+  }
+
+  // file chunk
+  SDFileSet* pSet = &pWriter->fCopy.wSet;
+  if (!pWriter->fCopy.inUse || pFHdr->fid != pSet->fid || pFHdr->iFile < pWriter->fCopy.iFile ||
+      pFHdr->iFile >= TSDB_SNAP_NFILE(pSet)) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _err;
+  }
+
+  if (pFHdr->iFile != pWriter->fCopy.iFile) {
+    code = tsdbSnapWriteFileClose(pWriter);
+    if (code) goto _err;
+
+    code = tsdbSnapWriteFileCheck(pWriter, pFHdr->iFile);
+    if (code) goto _err;
+
+    pWriter->fCopy.iFile = pFHdr->iFile;
+    pWriter->fCopy.offset = 0;
+
+    tsdbSnapFileName(pTsdb, pSet, pFHdr->iFile, fname, &size);
+    if (size != pFHdr->size) {
+      code = TSDB_CODE_INVALID_MSG;
+      goto _err;
+    }
+
+    pWriter->fCopy.pFD = taosOpenFile(fname, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+    if (pWriter->fCopy.pFD == NULL) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _err;
+    }
+  }
+
+  if (pFHdr->offset != pWriter->fCopy.offset) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _err;
+  }
+
+  if (taosWriteFile(pWriter->fCopy.pFD, pChunk, n) != n) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _err;
+  }
+  pWriter->fCopy.offset += n;
+
+_exit:
+  return code;
+
+_err:
+  tsdbError("vgId:%d, vnode snapshot tsdb write file for %s failed since %s", TD_VID(pTsdb->pVnode), pTsdb->path,
+            tstrerror(code));
+  return code;
+}
+
 // APIs
 int32_t tsdbSnapWriterOpen(STsdb* pTsdb, int64_t sver, int64_t ever, STsdbSnapWriter** ppWriter) {
   int32_t          code = 0;
@@ -1344,6 +1707,11 @@ int32_t tsdbSnapWriterClose(STsdbSnapWriter** ppWriter, int8_t rollback) {
       if (code) goto _err;
     }
 
+    if (pWriter->fCopy.inUse) {
+      code = tsdbSnapWriteFileSetEnd(pWriter);
+      if (code) goto _err;
+    }
+
     code = tsdbSnapWriteDelEnd(pWriter);
     if (code) goto _err;
 
@@ -1363,6 +1731,8 @@ int32_t tsdbSnapWriterClose(STsdbSnapWriter** ppWriter, int8_t rollback) {
     taosThreadRwlockUnlock(&pTsdb->rwLock);
   }
 
+  if (pWriter->fCopy.pFD) taosCloseFile(&pWriter->fCopy.pFD);
+
   // SNAP_DATA_DEL
   taosArrayDestroy(pWriter->aDelIdxW);
   taosArrayDestroy(pWriter->aDelData);
@@ -1405,6 +1775,11 @@ int32_t tsdbSnapWrite(STsdbSnapWriter* pWriter, uint8_t* pData, uint32_t nData)
   int32_t       code = 0;
   SSnapDataHdr* pHdr = (SSnapDataHdr*)pData;
 
+  if (pHdr->type != SNAP_DATA_TSDB_FILE && pWriter->fCopy.inUse) {
+    code = tsdbSnapWriteFileSetEnd(pWriter);
+    if (code) goto _err;
+  }
+
   // ts data
   if (pHdr->type == SNAP_DATA_TSDB) {
     code = tsdbSnapWriteData(pWriter, pData, nData);
@@ -1418,6 +1793,14 @@ int32_t tsdbSnapWrite(STsdbSnapWriter* pWriter, uint8_t* pData, uint32_t nData)
     }
   }
 
+  // whole data files
+  if (pHdr->type == SNAP_DATA_TSDB_FILE) {
+    code = tsdbSnapWriteFile(pWriter, pData, nData);
+    if (code) goto _err;
+
+    goto _exit;
+  }
+
   // del data
   if (pHdr->type == SNAP_DATA_DEL) {
     code = tsdbSnapWriteDel(pWriter, pData, nData);
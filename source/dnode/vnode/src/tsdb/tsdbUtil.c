@@ -972,6 +972,41 @@ _exit:
   return code;
 }
 
+// only the columns in aCid, which is in ascending order of column id, are decoded when the block is read
+int32_t tBlockDataInitByCols(SBlockData *pBlockData, int64_t suid, int64_t uid, STSchema *pTSchema, const int16_t *aCid,
+                             int32_t nCid) {
+  int32_t code = 0;
+
+  ASSERT(suid || uid);
+
+  pBlockData->suid = suid;
+  pBlockData->uid = uid;
+  pBlockData->nRow = 0;
+
+  taosArrayClear(pBlockData->aIdx);
+  int32_t iCid = 0;
+  for (int32_t iColumn = 1; iColumn < pTSchema->numOfCols && iCid < nCid; iColumn++) {
+    STColumn *pTColumn = &pTSchema->columns[iColumn];
+
+    while (iCid < nCid && aCid[iCid] < pTColumn->colId) {
+      iCid++;
+    }
+
+    if (iCid >= nCid || aCid[iCid] != pTColumn->colId) {
+      continue;
+    }
+
+    SColData *pColData;
+    code = tBlockDataAddColData(pBlockData, taosArrayGetSize(pBlockData->aIdx), &pColData);
+    if (code) goto _exit;
+
+    tColDataInit(pColData, pTColumn->colId, pTColumn->type, (pTColumn->flags & COL_SMA_ON) ? 1 : 0);
+  }
+
+_exit:
+  return code;
+}
+
 int32_t tBlockDataInitEx(SBlockData *pBlockData, SBlockData *pBlockDataFrom) {
   int32_t code = 0;
 
@@ -158,6 +158,12 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
     goto _err;
   }
 
+  // replay committed wal in parallel before sync takes over
+  if (vnodeReplayWal(pVnode) < 0) {
+    vError("vgId:%d, failed to replay wal since %s", TD_VID(pVnode), tstrerror(terrno));
+    goto _err;
+  }
+
   // open sync
   if (vnodeSyncOpen(pVnode, dir)) {
     vError("vgId:%d, failed to open sync since %s", TD_VID(pVnode), tstrerror(terrno));
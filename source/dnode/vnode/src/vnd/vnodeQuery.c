@@ -379,6 +379,7 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = 2;
   pLoad->numOfBatchInsertReqs = 5;
   pLoad->numOfBatchInsertSuccessReqs = 4;
+  metaGetSchemaCacheStat(pVnode->pMeta, &pLoad->numOfSchemaCacheHits, &pLoad->numOfSchemaCacheMisses);
   return 0;
 }
 
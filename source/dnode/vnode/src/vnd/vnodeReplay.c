@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "vnd.h"
+
+/*
+ * Fast wal replay on vnode open.
+ *
+ * Entries in (applied, wal committed version] are known to be committed, they are replayed before sync is opened
+ * instead of going through the apply queue one by one. The wal is read sequentially through a mmap reader, entries are
+ * collected into batches, submits of a batch are checked in parallel, then runs of plain submits are inserted into the
+ * memtable in parallel with tables partitioned by uid, so rows of one table are still inserted in version order. After
+ * a run is inserted, each of its submits goes through the rest of the write path (applied version, tq push, rsma) in
+ * version order. Everything else (meta changes, auto create table submits, rsma) is a barrier and applied by
+ * vnodeProcessWriteMsg.
+ */
+
+#define REPLAY_MAX_THREADS  64
+#define REPLAY_BATCH_SIZE   4096
+#define REPLAY_BATCH_BYTES  (64 * 1024 * 1024)
+#define REPLAY_LOG_INTERVAL 10000  // ms
+
+typedef struct {
+  int64_t version;
+  int64_t term;
+  tmsg_t  msgType;
+  int32_t contLen;
+  void   *pCont;
+  int8_t  parallel;  // plain submit, insert in parallel
+  int8_t  invalid;   // rejected by scan, nothing to insert
+} SReplayEntry;
+
+typedef struct {
+  // check a submit and mark it parallel if it can be inserted out of the apply order
+  void (*scan)(SVnode *pVnode, SReplayEntry *pEntry);
+  // insert one block of a parallel submit, called by the worker owning the table
+  int32_t (*insert)(SVnode *pVnode, SReplayEntry *pEntry, SSubmitMsgIter *pIter, SSubmitBlk *pBlock,
+                    SSubmitBlkRsp *pRsp);
+  // rest of the write path of a parallel submit, called in version order once its run is inserted
+  int32_t (*post)(SVnode *pVnode, SReplayEntry *pEntry);
+  // apply a barrier entry
+  int32_t (*apply)(SVnode *pVnode, SReplayEntry *pEntry);
+} SReplayOps;
+
+typedef struct SReplayCtx SReplayCtx;
+
+typedef struct {
+  SReplayCtx *pCtx;
+  int32_t     idx;
+  TdThread    thread;
+  int64_t     nRow;
+  int32_t     code;
+} SReplayWorker;
+
+struct SReplayCtx {
+  SVnode           *pVnode;
+  const SReplayOps *pOps;
+  int32_t           nWorker;
+  int32_t           nThread;  // threads started
+  SReplayWorker     aWorker[REPLAY_MAX_THREADS];
+  SReplayEntry     *aEntry;
+  int32_t           nEntry;
+  int64_t           nBytes;
+  // job handed to the workers, guarded by mutex
+  TdThreadMutex mutex;
+  TdThreadCond  jobCond;
+  TdThreadCond  doneCond;
+  int64_t       jobId;
+  int32_t       nDone;
+  bool          stop;
+  void (*fp)(SReplayWorker *);
+  int32_t start;
+  int32_t end;
+  // statistics
+  int64_t nEntryTotal;
+  int64_t nBytesTotal;
+  int64_t nRowTotal;
+  int64_t nParallel;
+};
+
+static void vnodeReplayClearBatch(SReplayCtx *pCtx) {
+  for (int32_t i = 0; i < pCtx->nEntry; i++) {
+    taosMemoryFree(pCtx->aEntry[i].pCont);
+  }
+  pCtx->nEntry = 0;
+  pCtx->nBytes = 0;
+}
+
+static void *vnodeReplayWorkerLoop(void *param) {
+  SReplayWorker *pWorker = (SReplayWorker *)param;
+  SReplayCtx    *pCtx = pWorker->pCtx;
+  int64_t        jobId = 0;
+
+  taosThreadMutexLock(&pCtx->mutex);
+  for (;;) {
+    while (!pCtx->stop && pCtx->jobId == jobId) {
+      taosThreadCondWait(&pCtx->jobCond, &pCtx->mutex);
+    }
+    if (pCtx->stop) break;
+    jobId = pCtx->jobId;
+    taosThreadMutexUnlock(&pCtx->mutex);
+
+    pCtx->fp(pWorker);
+
+    taosThreadMutexLock(&pCtx->mutex);
+    if (++pCtx->nDone == pCtx->nWorker) {
+      taosThreadCondSignal(&pCtx->doneCond);
+    }
+  }
+  taosThreadMutexUnlock(&pCtx->mutex);
+
+  return NULL;
+}
+
+static void vnodeReplayStopWorkers(SReplayCtx *pCtx) {
+  taosThreadMutexLock(&pCtx->mutex);
+  pCtx->stop = true;
+  taosThreadCondBroadcast(&pCtx->jobCond);
+  taosThreadMutexUnlock(&pCtx->mutex);
+
+  for (int32_t i = 0; i < pCtx->nThread; i++) {
+    taosThreadJoin(pCtx->aWorker[i].thread, NULL);
+  }
+  pCtx->nThread = 0;
+
+  taosThreadCondDestroy(&pCtx->doneCond);
+  taosThreadCondDestroy(&pCtx->jobCond);
+  taosThreadMutexDestroy(&pCtx->mutex);
+}
+
+// the workers live through the whole replay, each batch only hands them a new job
+static int32_t vnodeReplayStartWorkers(SReplayCtx *pCtx) {
+  taosThreadMutexInit(&pCtx->mutex, NULL);
+  taosThreadCondInit(&pCtx->jobCond, NULL);
+  taosThreadCondInit(&pCtx->doneCond, NULL);
+
+  for (int32_t i = 0; i < pCtx->nWorker; i++) {
+    SReplayWorker *pWorker = &pCtx->aWorker[i];
+    pWorker->pCtx = pCtx;
+    pWorker->idx = i;
+    if (taosThreadCreate(&pWorker->thread, NULL, vnodeReplayWorkerLoop, pWorker) != 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      vnodeReplayStopWorkers(pCtx);
+      return -1;
+    }
+    pCtx->nThread++;
+  }
+
+  return 0;
+}
+
+static int32_t vnodeReplayRunWorkers(SReplayCtx *pCtx, void (*fp)(SReplayWorker *), int32_t start, int32_t end) {
+  for (int32_t i = 0; i < pCtx->nWorker; i++) {
+    pCtx->aWorker[i].nRow = 0;
+    pCtx->aWorker[i].code = 0;
+  }
+
+  taosThreadMutexLock(&pCtx->mutex);
+  pCtx->fp = fp;
+  pCtx->start = start;
+  pCtx->end = end;
+  pCtx->nDone = 0;
+  pCtx->jobId++;
+  taosThreadCondBroadcast(&pCtx->jobCond);
+  while (pCtx->nDone < pCtx->nWorker) {
+    taosThreadCondWait(&pCtx->doneCond, &pCtx->mutex);
+  }
+  taosThreadMutexUnlock(&pCtx->mutex);
+
+  int32_t code = 0;
+  for (int32_t i = 0; i < pCtx->nWorker; i++) {
+    pCtx->nRowTotal += pCtx->aWorker[i].nRow;
+    if (code == 0) code = pCtx->aWorker[i].code;
+  }
+
+  if (code) {
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
+static void vnodeReplayScan(SVnode *pVnode, SReplayEntry *pEntry) {
+  if (pEntry->msgType != TDMT_VND_SUBMIT || VND_IS_RSMA(pVnode)) return;
+
+  SSubmitReq    *pSubmitReq = (SSubmitReq *)pEntry->pCont;
+  SSubmitMsgIter msgIter = {0};
+  SSubmitBlk    *pBlock = NULL;
+
+  if (tInitSubmitMsgIter(pSubmitReq, &msgIter) < 0) return;
+  for (;;) {
+    if (tGetSubmitMsgNext(&msgIter, &pBlock) < 0) return;
+    if (pBlock == NULL) break;
+
+    // auto create table writes meta, keep it in order
+    if (msgIter.schemaLen > 0) return;
+  }
+
+  pSubmitReq->version = pEntry->version;
+  if (tsdbScanAndConvertSubmitMsg(pVnode->pTsdb, pSubmitReq) < 0) {
+    pEntry->invalid = 1;
+  }
+  pEntry->parallel = 1;
+}
+
+static int32_t vnodeReplayInsert(SVnode *pVnode, SReplayEntry *pEntry, SSubmitMsgIter *pIter, SSubmitBlk *pBlock,
+                                 SSubmitBlkRsp *pRsp) {
+  return tsdbInsertTableData(pVnode->pTsdb, pEntry->version, pIter, pBlock, pRsp);
+}
+
+// what vnodeProcessWriteMsg does for a submit besides the insert
+static int32_t vnodeReplayPost(SVnode *pVnode, SReplayEntry *pEntry) {
+  pVnode->state.applied = pEntry->version;
+  pVnode->state.applyTerm = pEntry->term;
+
+  if (!pEntry->invalid) {
+    tdProcessRSmaSubmit(pVnode->pSma, pEntry->pCont, STREAM_INPUT__DATA_SUBMIT);
+  }
+
+  walApplyVer(pVnode->pWal, pEntry->version);
+
+  if (tqPushMsg(pVnode->pTq, pEntry->pCont, pEntry->contLen, pEntry->msgType, pEntry->version) < 0) {
+    vError("vgId:%d, failed to push msg to TQ since %s", TD_VID(pVnode), tstrerror(terrno));
+    return -1;
+  }
+
+  return 0;
+}
+
+static int32_t vnodeReplayApply(SVnode *pVnode, SReplayEntry *pEntry) {
+  SRpcMsg msg = {.msgType = pEntry->msgType, .pCont = pEntry->pCont, .contLen = pEntry->contLen};
+  SRpcMsg rsp = {0};
+  msg.info.conn.applyIndex = pEntry->version;
+  msg.info.conn.applyTerm = pEntry->term;
+
+  // failures are logged and skipped as in the apply queue, commit is done inside if needed
+  if (vnodeProcessWriteMsg(pVnode, &msg, pEntry->version, &rsp) < 0) {
+    vError("vgId:%d, failed to replay %s, index:%" PRId64 " since %s", TD_VID(pVnode), TMSG_INFO(pEntry->msgType),
+           pEntry->version, terrstr());
+  }
+  rpcFreeCont(rsp.pCont);
+
+  pVnode->state.applyTerm = pEntry->term;
+  return 0;
+}
+
+static const SReplayOps vnodeReplayOps = {
+    .scan = vnodeReplayScan,
+    .insert = vnodeReplayInsert,
+    .post = vnodeReplayPost,
+    .apply = vnodeReplayApply,
+};
+
+static void vnodeReplayScanFunc(SReplayWorker *pWorker) {
+  SReplayCtx *pCtx = pWorker->pCtx;
+
+  for (int32_t i = pCtx->start + pWorker->idx; i < pCtx->end; i += pCtx->nWorker) {
+    pCtx->pOps->scan(pCtx->pVnode, &pCtx->aEntry[i]);
+  }
+}
+
+// errors the replay can not go on with, the rest fail the block only as in vnodeProcessSubmitReq
+static bool vnodeReplayIsFatal(int32_t code) {
+  return code == TSDB_CODE_OUT_OF_MEMORY || code == TSDB_CODE_TDB_OUT_OF_MEMORY || code == TSDB_CODE_FILE_CORRUPTED ||
+         code == TSDB_CODE_TDB_FILE_CORRUPTED || (code & 0xffff0000) == TAOS_SYSTEM_ERROR(0);
+}
+
+// insert blocks of tables belonging to this worker, in version order
+static void vnodeReplayInsertFunc(SReplayWorker *pWorker) {
+  SReplayCtx *pCtx = pWorker->pCtx;
+  SVnode     *pVnode = pCtx->pVnode;
+
+  for (int32_t i = pCtx->start; i < pCtx->end; i++) {
+    SReplayEntry *pEntry = &pCtx->aEntry[i];
+    if (pEntry->invalid) continue;
+
+    SSubmitMsgIter msgIter = {0};
+    SSubmitBlk    *pBlock = NULL;
+
+    tInitSubmitMsgIter((SSubmitReq *)pEntry->pCont, &msgIter);
+    for (;;) {
+      tGetSubmitMsgNext(&msgIter, &pBlock);
+      if (pBlock == NULL) break;
+      if ((uint64_t)msgIter.uid % pCtx->nWorker != pWorker->idx) continue;
+
+      SSubmitBlkRsp blkRsp = {0};
+      if (pCtx->pOps->insert(pVnode, pEntry, &msgIter, pBlock, &blkRsp) < 0) {
+        vError("vgId:%d, failed to replay submit block, uid:%" PRId64 " index:%" PRId64 " since %s", TD_VID(pVnode),
+               msgIter.uid, pEntry->version, terrstr());
+        if (vnodeReplayIsFatal(terrno)) {
+          pWorker->code = terrno;
+          return;
+        }
+        continue;
+      }
+      pWorker->nRow += blkRsp.numOfRows;
+    }
+  }
+}
+
+static int32_t vnodeReplayApplyBatch(SReplayCtx *pCtx) {
+  SVnode *pVnode = pCtx->pVnode;
+
+  if (pCtx->nEntry == 0) return 0;
+
+  if (vnodeReplayRunWorkers(pCtx, vnodeReplayScanFunc, 0, pCtx->nEntry) < 0) return -1;
+
+  for (int32_t i = 0; i < pCtx->nEntry;) {
+    SReplayEntry *pEntry = &pCtx->aEntry[i];
+
+    if (pEntry->parallel) {
+      // memtable may be switched by commit, stop the run there
+      int32_t j = i + 1;
+      while (j < pCtx->nEntry && pCtx->aEntry[j].parallel) j++;
+
+      if (vnodeReplayRunWorkers(pCtx, vnodeReplayInsertFunc, i, j) < 0) return -1;
+      for (int32_t k = i; k < j; k++) {
+        if (pCtx->pOps->post(pVnode, &pCtx->aEntry[k]) < 0) return -1;
+      }
+      pCtx->nParallel += (j - i);
+
+      if (vnodeShouldCommit(pVnode)) {
+        vInfo("vgId:%d, commit at version %" PRId64 " in wal replay", TD_VID(pVnode), pCtx->aEntry[j - 1].version);
+        if (vnodeCommit(pVnode) < 0 || vnodeBegin(pVnode) < 0) return -1;
+      }
+      i = j;
+      continue;
+    }
+
+    if (pCtx->pOps->apply(pVnode, pEntry) < 0) return -1;
+    i++;
+  }
+
+  vnodeReplayClearBatch(pCtx);
+  return 0;
+}
+
+static bool vnodeReplayIsUserMsg(tmsg_t msgType) {
+  return msgType != TDMT_SYNC_NOOP && msgType != TDMT_SYNC_CONFIG_CHANGE &&
+         msgType != TDMT_SYNC_CONFIG_CHANGE_FINISH && msgType != TDMT_SYNC_LEADER_TRANSFER;
+}
+
+int32_t vnodeReplayWal(SVnode *pVnode) {
+  int32_t        code = 0;
+  SWalReader    *pReader = NULL;
+  SReplayCtx    *pCtx = NULL;
+  bool           started = false;
+  int64_t        sver = pVnode->state.applied + 1;
+  int64_t        ever = walGetCommittedVer(pVnode->pWal);
+  int64_t        startMs = 0;
+  int64_t        lastLogMs = 0;
+  int64_t        elapsed = 0;
+  SWalFilterCond cond = {.scanUncommited = 0, .scanNotApplied = 1, .scanMeta = 1, .enableMmap = 1};
+
+  if (tsNumOfVnodeReplayThreads <= 0 || sver > ever) {
+    return 0;
+  }
+
+  if (sver < walGetFirstVer(pVnode->pWal)) {
+    vInfo("vgId:%d, skip wal replay since log from %" PRId64 " not exist, first:%" PRId64, TD_VID(pVnode), sver,
+          walGetFirstVer(pVnode->pWal));
+    return 0;
+  }
+
+  pCtx = (SReplayCtx *)taosMemoryCalloc(1, sizeof(*pCtx));
+  if (pCtx == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  pCtx->pVnode = pVnode;
+  pCtx->pOps = &vnodeReplayOps;
+  pCtx->nWorker = TMIN(tsNumOfVnodeReplayThreads, REPLAY_MAX_THREADS);
+  pCtx->aEntry = (SReplayEntry *)taosMemoryCalloc(REPLAY_BATCH_SIZE, sizeof(SReplayEntry));
+  if (pCtx->aEntry == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  pReader = walOpenReader(pVnode->pWal, &cond);
+  if (pReader == NULL) {
+    code = terrno;
+    goto _err;
+  }
+
+  if (vnodeReplayStartWorkers(pCtx) < 0) {
+    code = terrno;
+    goto _err;
+  }
+  started = true;
+
+  vInfo("vgId:%d, start to replay wal from %" PRId64 " to %" PRId64 ", threads:%d", TD_VID(pVnode), sver, ever,
+        pCtx->nWorker);
+
+  startMs = taosGetMonotonicMs();
+  lastLogMs = startMs;
+  for (int64_t ver = sver; ver <= ever; ver++) {
+    if (walReadVer(pReader, ver) < 0) {
+      code = terrno;
+      goto _err;
+    }
+
+    SWalCont *pHead = &pReader->pHead->head;
+    pCtx->nEntryTotal++;
+    pCtx->nBytesTotal += pHead->bodyLen;
+    if (!vnodeReplayIsUserMsg(pHead->msgType)) continue;
+
+    SReplayEntry *pEntry = &pCtx->aEntry[pCtx->nEntry];
+    memset(pEntry, 0, sizeof(*pEntry));
+    pEntry->version = ver;
+    pEntry->term = pHead->syncMeta.term;
+    pEntry->msgType = pHead->msgType;
+    pEntry->contLen = pHead->bodyLen;
+    pEntry->pCont = taosMemoryMalloc(pHead->bodyLen);
+    if (pEntry->pCont == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+    memcpy(pEntry->pCont, pHead->body, pHead->bodyLen);
+    pCtx->nEntry++;
+    pCtx->nBytes += pHead->bodyLen;
+
+    if (pCtx->nEntry >= REPLAY_BATCH_SIZE || pCtx->nBytes >= REPLAY_BATCH_BYTES) {
+      if (vnodeReplayApplyBatch(pCtx) < 0) {
+        code = terrno;
+        goto _err;
+      }
+    }
+
+    int64_t nowMs = taosGetMonotonicMs();
+    if (nowMs - lastLogMs >= REPLAY_LOG_INTERVAL) {
+      vInfo("vgId:%d, wal replay in progress, index:%" PRId64 "/%" PRId64 ", rows:%" PRId64 ", %.2f MB/s",
+            TD_VID(pVnode), ver, ever, pCtx->nRowTotal,
+            pCtx->nBytesTotal / 1048576.0 / ((nowMs - startMs) / 1000.0));
+      lastLogMs = nowMs;
+    }
+  }
+
+  if (vnodeReplayApplyBatch(pCtx) < 0) {
+    code = terrno;
+    goto _err;
+  }
+
+  // make replayed data durable, sync restarts from the committed version
+  pVnode->state.applied = ever;
+  if (vnodeCommit(pVnode) < 0 || vnodeBegin(pVnode) < 0) {
+    code = terrno;
+    goto _err;
+  }
+
+  elapsed = TMAX(taosGetMonotonicMs() - startMs, 1);
+  vInfo("vgId:%d, wal replay finished, index:%" PRId64 " to %" PRId64 ", entries:%" PRId64 " parallel:%" PRId64
+        ", rows:%" PRId64 ", bytes:%" PRId64 ", elapsed:%" PRId64 "ms, %.2f MB/s, %.0f rows/s",
+        TD_VID(pVnode), sver, ever, pCtx->nEntryTotal, pCtx->nParallel, pCtx->nRowTotal, pCtx->nBytesTotal, elapsed,
+        pCtx->nBytesTotal / 1048576.0 / (elapsed / 1000.0), pCtx->nRowTotal / (elapsed / 1000.0));
+
+  vnodeReplayStopWorkers(pCtx);
+  walCloseReader(pReader);
+  taosMemoryFree(pCtx->aEntry);
+  taosMemoryFree(pCtx);
+  return 0;
+
+_err:
+  vError("vgId:%d, failed to replay wal since %s", TD_VID(pVnode), tstrerror(code));
+  if (started) vnodeReplayStopWorkers(pCtx);
+  if (pReader) walCloseReader(pReader);
+  if (pCtx) {
+    if (pCtx->aEntry) {
+      vnodeReplayClearBatch(pCtx);
+      taosMemoryFree(pCtx->aEntry);
+    }
+    taosMemoryFree(pCtx);
+  }
+  terrno = code;
+  return -1;
+}
@@ -355,6 +355,7 @@ int32_t vnodeSnapWrite(SVSnapWriter *pWriter, uint8_t *pData, uint32_t nData) {
       if (code) goto _err;
     } break;
     case SNAP_DATA_TSDB:
+    case SNAP_DATA_TSDB_FILE:
     case SNAP_DATA_DEL: {
       // tsdb
       if (pWriter->pTsdbSnapWriter == NULL) {
@@ -289,9 +289,24 @@ int32_t vnodePreprocessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
 
 int32_t vnodeProcessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
   vTrace("message in vnode query queue is processing");
-  if ((pMsg->msgType == TDMT_SCH_QUERY) && !vnodeIsReadyForRead(pVnode)) {
-    vnodeRedirectRpcMsg(pVnode, pMsg);
-    return 0;
+  if (pMsg->msgType == TDMT_SCH_QUERY) {
+    // already converted to host order in vnodePreprocessQueryMsg
+    SSubQueryMsg   *pQuery = pMsg->pCont;
+    SSubQueryMsgExt ext = {0};
+    bool            ready = false;
+    tGetSubQueryMsgExt(pQuery, pMsg->contLen, &ext);
+    if (ext.linearizable) {
+      ready = vnodeIsReadyForRead(pVnode) && vnodeIsReadyForLeaseRead(pVnode);
+    } else if (ext.maxStaleMs > 0) {
+      ready = vnodeIsReadyForRead(pVnode) || vnodeIsReadyForStaleRead(pVnode, ext.maxStaleMs);
+    } else {
+      ready = vnodeIsReadyForRead(pVnode);
+    }
+
+    if (!ready) {
+      vnodeRedirectRpcMsg(pVnode, pMsg);
+      return 0;
+    }
   }
 
   SReadHandle handle = {.meta = pVnode->pMeta, .config = &pVnode->config, .vnode = pVnode, .pMsgCb = &pVnode->msgCb};
@@ -309,9 +324,11 @@ int32_t vnodeProcessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
 
 int32_t vnodeProcessFetchMsg(SVnode *pVnode, SRpcMsg *pMsg, SQueueInfo *pInfo) {
   vTrace("vgId:%d, msg:%p in fetch queue is processing", pVnode->config.vgId, pMsg);
+  // a task admitted as a stale read runs on a follower and is fetched there
   if ((pMsg->msgType == TDMT_SCH_FETCH || pMsg->msgType == TDMT_VND_TABLE_META || pMsg->msgType == TDMT_VND_TABLE_CFG ||
        pMsg->msgType == TDMT_VND_BATCH_META) &&
-      !vnodeIsReadyForRead(pVnode)) {
+      !vnodeIsReadyForRead(pVnode) &&
+      !(pMsg->msgType == TDMT_SCH_FETCH && qWorkerIsStaleReadTask(pVnode->pQuery, pMsg))) {
     vnodeRedirectRpcMsg(pVnode, pMsg);
     return 0;
   }
@@ -401,6 +418,26 @@ _exit:
   return code;
 }
 
+static void vnodeContinueDropTtlTb(SVnode *pVnode, SVDropTtlTableReq *pTtlReq) {
+  int32_t   reqLen = tSerializeSVDropTtlTableReq(NULL, 0, pTtlReq);
+  int32_t   contLen = reqLen + sizeof(SMsgHead);
+  SMsgHead *pHead = rpcMallocCont(contLen);
+  if (pHead == NULL) {
+    return;
+  }
+  pHead->contLen = contLen;
+  pHead->vgId = pVnode->config.vgId;
+  tSerializeSVDropTtlTableReq((char *)pHead + sizeof(SMsgHead), reqLen, pTtlReq);
+
+  SRpcMsg rpcMsg = {.msgType = TDMT_VND_DROP_TTL_TABLE, .pCont = pHead, .contLen = contLen};
+  if (tmsgPutToQueue(&pVnode->msgCb, WRITE_QUEUE, &rpcMsg) != 0) {
+    rpcFreeCont(pHead);
+    vError("vgId:%d, failed to continue drop ttl table since %s", pVnode->config.vgId, terrstr());
+  } else {
+    vDebug("vgId:%d, drop ttl table continues in next batch, time:%d", pVnode->config.vgId, pTtlReq->timestamp);
+  }
+}
+
 static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
   SArray *tbUids = taosArrayInit(8, sizeof(int64_t));
   if (tbUids == NULL) return TSDB_CODE_OUT_OF_MEMORY;
@@ -412,7 +449,9 @@ static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *p
   }
 
   vDebug("vgId:%d, drop ttl table req will be processed, time:%d", pVnode->config.vgId, ttlReq.timestamp);
-  int32_t ret = metaTtlDropTable(pVnode->pMeta, ttlReq.timestamp, tbUids);
+  bool    more = false;
+  // the batch size travels in the request, so every replica applies the same batches whatever its own config
+  int32_t ret = metaTtlDropTable(pVnode->pMeta, ttlReq.timestamp, ttlReq.batchNum, tbUids, &more);
   if (ret != 0) {
     goto end;
   }
@@ -420,6 +459,13 @@ static int32_t vnodeProcessDropTtlTbReq(SVnode *pVnode, int64_t version, void *p
     tqUpdateTbUidList(pVnode->pTq, tbUids, false);
   }
 
+  // the rest goes to the back of the write queue so that submits queued meanwhile are not held up. Only the leader
+  // re-queues it: if the leadership changes before the rest is dropped, the tables left are dropped by the next drop
+  // ttl table request of the mnode ttl timer, on the new leader
+  if (more && vnodeIsLeader(pVnode)) {
+    vnodeContinueDropTtlTb(pVnode, &ttlReq);
+  }
+
 end:
   taosArrayDestroy(tbUids);
   return ret;
@@ -471,6 +517,8 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
   char               tbName[TSDB_TABLE_FNAME_LEN];
   STbUidStore       *pStore = NULL;
   SArray            *tbUids = NULL;
+  SArray            *tbIdx = NULL;  // index of the created tables in the batch
+  bool               inBulk = false;
 
   pRsp->msgType = TDMT_VND_CREATE_TABLE_RSP;
   pRsp->code = TSDB_CODE_SUCCESS;
@@ -487,12 +535,20 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
 
   rsp.pArray = taosArrayInit(req.nReqs, sizeof(cRsp));
   tbUids = taosArrayInit(req.nReqs, sizeof(int64_t));
-  if (rsp.pArray == NULL || tbUids == NULL) {
+  tbIdx = taosArrayInit(req.nReqs, sizeof(int32_t));
+  if (rsp.pArray == NULL || tbUids == NULL || tbIdx == NULL) {
     rcode = -1;
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
 
+  // collect the tables and load them into meta at once
+  if (metaBulkBegin(pVnode->pMeta) < 0) {
+    rcode = -1;
+    goto _exit;
+  }
+  inBulk = true;
+
   // loop to create table
   for (int32_t iReq = 0; iReq < req.nReqs; iReq++) {
     pCreateReq = req.pReqs + iReq;
@@ -525,14 +581,29 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
       }
     } else {
       cRsp.code = TSDB_CODE_SUCCESS;
-      tdFetchTbUidList(pVnode->pSma, &pStore, pCreateReq->ctb.suid, pCreateReq->uid);
       taosArrayPush(tbUids, &pCreateReq->uid);
-      vnodeUpdateMetaRsp(pVnode, cRsp.pMeta);
+      taosArrayPush(tbIdx, &iReq);
     }
 
     taosArrayPush(rsp.pArray, &cRsp);
   }
 
+  // the tables are in meta only once the bulk is loaded, if it fails the whole request fails
+  inBulk = false;
+  if (metaBulkEnd(pVnode->pMeta) < 0) {
+    rcode = -1;
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(tbIdx); i++) {
+    int32_t        iReq = *(int32_t *)taosArrayGet(tbIdx, i);
+    SVCreateTbRsp *pCRsp = taosArrayGet(rsp.pArray, iReq);
+
+    pCreateReq = req.pReqs + iReq;
+    tdFetchTbUidList(pVnode->pSma, &pStore, pCreateReq->ctb.suid, pCreateReq->uid);
+    vnodeUpdateMetaRsp(pVnode, pCRsp->pMeta);
+  }
+
   vDebug("vgId:%d, add %d new created tables into query table list", TD_VID(pVnode), (int32_t)taosArrayGetSize(tbUids));
   tqUpdateTbUidList(pVnode->pTq, tbUids, true);
   if (tdUpdateTbUidList(pVnode->pSma, pStore, true) < 0) {
@@ -553,12 +624,16 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
   tEncodeSVCreateTbBatchRsp(&encoder, &rsp);
 
 _exit:
+  if (inBulk) {
+    metaBulkEnd(pVnode->pMeta);
+  }
   for (int32_t iReq = 0; iReq < req.nReqs; iReq++) {
     pCreateReq = req.pReqs + iReq;
     taosArrayDestroy(pCreateReq->ctb.tagName);
   }
   taosArrayDestroyEx(rsp.pArray, tFreeSVCreateTbRsp);
   taosArrayDestroy(tbUids);
+  taosArrayDestroy(tbIdx);
   tDecoderClear(&decoder);
   tEncoderClear(&encoder);
   return rcode;
@@ -795,3 +795,43 @@ bool vnodeIsReadyForRead(SVnode *pVnode) {
          syncGetMyRoleStr(pVnode->sync), syncGetLastIndex(pVnode->sync), syncGetCommitIndex(pVnode->sync));
   return false;
 }
+
+bool vnodeIsReadyForLeaseRead(SVnode *pVnode) {
+  SyncIndex readIndex = SYNC_INDEX_INVALID;
+  if (!syncIsReadyForLeaseRead(pVnode->sync, &readIndex)) {
+    vDebug("vgId:%d, vnode not ready for lease read, state:%s since %s", pVnode->config.vgId,
+           syncGetMyRoleStr(pVnode->sync), terrstr());
+    return false;
+  }
+
+  // everything committed before the read arrived must be visible
+  if (pVnode->state.applied < readIndex) {
+    vDebug("vgId:%d, vnode not ready for lease read, applied:%" PRId64 " read index:%" PRId64, pVnode->config.vgId,
+           pVnode->state.applied, readIndex);
+    terrno = TSDB_CODE_APP_NOT_READY;
+    return false;
+  }
+
+  return true;
+}
+
+bool vnodeIsReadyForStaleRead(SVnode *pVnode, int32_t maxStaleMs) {
+  SyncIndex readIndex = SYNC_INDEX_INVALID;
+  if (!syncIsReadyForStaleRead(pVnode->sync, maxStaleMs, &readIndex)) {
+    vDebug("vgId:%d, vnode not ready for stale read, state:%s, max stale:%dms", pVnode->config.vgId,
+           syncGetMyRoleStr(pVnode->sync), maxStaleMs);
+    return false;
+  }
+
+  // do not hold the query thread for the apply thread, the leader serves it instead
+  if (pVnode->state.applied < readIndex) {
+    vDebug("vgId:%d, vnode not ready for stale read, applied:%" PRId64 " commit:%" PRId64, pVnode->config.vgId,
+           pVnode->state.applied, readIndex);
+    terrno = TSDB_CODE_APP_NOT_READY;
+    return false;
+  }
+
+  vTrace("vgId:%d, vnode ready for stale read, state:%s, applied:%" PRId64 " commit:%" PRId64, pVnode->config.vgId,
+         syncGetMyRoleStr(pVnode->sync), pVnode->state.applied, readIndex);
+  return true;
+}
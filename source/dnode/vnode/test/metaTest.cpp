@@ -0,0 +1,608 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "meta.h"
+#include "vnodeTestUtil.h"
+
+#define TEST_ROOT TD_TMP_DIR_PATH "metaTest"
+#define TEST_SUID 1000
+
+class MetaTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pVnode = vnodeTestOpen(TEST_ROOT, 2);
+    ASSERT_NE(pVnode, nullptr);
+    pVnode->config.szPage = 4096;
+    pVnode->config.szCache = 256;
+
+    openMeta();
+  }
+
+  void TearDown() override {
+    closeMeta();
+    vnodeTestClose(pVnode);
+    taosRemoveDir(TEST_ROOT);
+  }
+
+  void openMeta() {
+    ASSERT_EQ(metaOpen(pVnode, &pMeta), 0);
+    ASSERT_EQ(metaBegin(pMeta, 1), 0);
+  }
+
+  void closeMeta() {
+    if (pMeta == NULL) return;
+    ASSERT_EQ(metaCommit(pMeta), 0);
+    metaClose(pMeta);
+    pMeta = NULL;
+  }
+
+  // super table (ts timestamp, v int) tags (t1 int, t2 varchar(16))
+  void createSuperTable() {
+    SSchema aCol[] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+                      {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4, .name = "v"}};
+    SSchema aTag[] = {{.type = TSDB_DATA_TYPE_INT, .colId = 3, .bytes = 4, .name = "t1"},
+                      {.type = TSDB_DATA_TYPE_VARCHAR, .colId = 4, .bytes = 16 + VARSTR_HEADER_SIZE, .name = "t2"}};
+    SVCreateStbReq req = {0};
+    req.name = (char *)"st";
+    req.suid = TEST_SUID;
+    req.schemaRow = {.nCols = 2, .version = 1, .pSchema = aCol};
+    req.schemaTag = {.nCols = 2, .version = 1, .pSchema = aTag};
+    ASSERT_EQ(metaCreateSTable(pMeta, ++version, &req), 0);
+  }
+
+  // tags of a child table, a NULL t1 when isNull
+  static STag *buildTags(int32_t t1, const char *t2, bool isNull = false) {
+    SArray *pVals = taosArrayInit(2, sizeof(STagVal));
+    STag   *pTag = NULL;
+
+    if (!isNull) {
+      STagVal v1 = {.cid = 3, .type = TSDB_DATA_TYPE_INT};
+      v1.i64 = t1;
+      taosArrayPush(pVals, &v1);
+    }
+    STagVal v2 = {.cid = 4, .type = TSDB_DATA_TYPE_VARCHAR};
+    v2.pData = (uint8_t *)t2;
+    v2.nData = strlen(t2);
+    taosArrayPush(pVals, &v2);
+
+    tTagNew(pVals, 1, false, &pTag);
+    taosArrayDestroy(pVals);
+    return pTag;
+  }
+
+  int32_t createChildTable(const char *name, tb_uid_t uid, int32_t t1, const char *t2, int64_t ver = -1,
+                           bool isNull = false) {
+    STag         *pTag = buildTags(t1, t2, isNull);
+    SVCreateTbReq req = {0};
+    req.name = (char *)name;
+    req.uid = uid;
+    req.type = TSDB_CHILD_TABLE;
+    req.ctime = ctime;
+    req.ttl = ttl;
+    req.ctb.name = (char *)"st";
+    req.ctb.suid = TEST_SUID;
+    req.ctb.pTag = (uint8_t *)pTag;
+
+    STableMetaRsp *pRsp = NULL;
+    int32_t        ret = metaCreateTable(pMeta, ver < 0 ? ++version : ver, &req, &pRsp);
+    taosMemoryFree(pRsp);
+    taosMemoryFree(pTag);
+    return ret;
+  }
+
+  tb_uid_t uidByName(const char *name) {
+    SMetaReader mr = {0};
+    tb_uid_t    uid = 0;
+
+    metaReaderInit(&mr, pMeta, 0);
+    if (metaGetTableEntryByName(&mr, name) == 0) {
+      uid = mr.me.uid;
+    }
+    metaReaderClear(&mr);
+    return uid;
+  }
+
+  SVnode *pVnode = NULL;
+  SMeta  *pMeta = NULL;
+  int64_t version = 0;
+  int64_t ctime = 0;  // of the child tables created next, in ms
+  int32_t ttl = 0;    // of the child tables created next, in ttl units
+};
+
+// a table rejected in a bulk leaves nothing behind, the others of the batch are loaded
+TEST_F(MetaTest, bulkDuplicate) {
+  createSuperTable();
+  ASSERT_EQ(createChildTable("t0", 100, 0, "a"), 0);
+
+  int64_t ver = ++version;
+  ASSERT_EQ(metaBulkBegin(pMeta), 0);
+  ASSERT_EQ(createChildTable("t1", 101, 1, "b", ver), 0);
+  // same uid in the same request, table.db rejects the (version, uid) key
+  ASSERT_EQ(createChildTable("t2", 101, 2, "c", ver), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_TDB_TABLE_ALREADY_EXIST);
+  // name collected by the bulk
+  ASSERT_EQ(createChildTable("t1", 102, 3, "d", ver), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_TDB_TABLE_ALREADY_EXIST);
+  // name already in the tables
+  ASSERT_EQ(createChildTable("t0", 103, 4, "e", ver), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_TDB_TABLE_ALREADY_EXIST);
+  ASSERT_EQ(createChildTable("t3", 104, 5, "f", ver), 0);
+  ASSERT_EQ(metaBulkEnd(pMeta), 0);
+
+  EXPECT_EQ(uidByName("t0"), 100);
+  EXPECT_EQ(uidByName("t1"), 101);
+  EXPECT_EQ(uidByName("t2"), 0);
+  EXPECT_EQ(uidByName("t3"), 104);
+
+  SMetaInfo info = {0};
+  ASSERT_EQ(metaGetInfo(pMeta, 101, &info), 0);
+  EXPECT_EQ(info.version, ver);
+  EXPECT_EQ(info.suid, TEST_SUID);
+  EXPECT_NE(metaGetInfo(pMeta, 103, &info), 0);
+
+  // the bulk drops a rejected table's records, so its name is free afterwards
+  ASSERT_EQ(createChildTable("t2", 105, 2, "c"), 0);
+  EXPECT_EQ(uidByName("t2"), 105);
+
+  // everything survives a reopen
+  closeMeta();
+  openMeta();
+  EXPECT_EQ(uidByName("t0"), 100);
+  EXPECT_EQ(uidByName("t1"), 101);
+  EXPECT_EQ(uidByName("t2"), 105);
+  EXPECT_EQ(uidByName("t3"), 104);
+}
+
+// a table failing in the middle of its entry is rolled back out of the bulk
+TEST_F(MetaTest, bulkRollback) {
+  createSuperTable();
+
+  int64_t ver = ++version;
+  ASSERT_EQ(metaBulkBegin(pMeta), 0);
+  ASSERT_EQ(createChildTable("t1", 201, 1, "a", ver), 0);
+  // table.db, uid.idx and name.idx records of this one are collected before ctb.idx rejects the uid
+  ASSERT_EQ(createChildTable("t9", 201, 9, "z", ver + 1), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_TDB_TABLE_ALREADY_EXIST);
+  // so a table with the rejected name can still be created in the same bulk
+  ASSERT_EQ(createChildTable("t9", 209, 9, "z", ver), 0);
+  ASSERT_EQ(metaBulkEnd(pMeta), 0);
+
+  EXPECT_EQ(uidByName("t1"), 201);
+  EXPECT_EQ(uidByName("t9"), 209);
+
+  // uid.idx of 201 still points to t1, not to the rolled back entry
+  SMetaReader mr = {0};
+  metaReaderInit(&mr, pMeta, 0);
+  ASSERT_EQ(metaGetTableEntryByUid(&mr, 201), 0);
+  EXPECT_STREQ(mr.me.name, "t1");
+  EXPECT_EQ(mr.me.version, ver);
+  metaReaderClear(&mr);
+
+  // only the two loaded tables are children of the super table
+  std::vector<tb_uid_t> uids;
+  SMCtbCursor          *pCur = metaOpenCtbCursor(pMeta, TEST_SUID);
+  ASSERT_NE(pCur, nullptr);
+  for (tb_uid_t uid; (uid = metaCtbCursorNext(pCur)) != 0;) uids.push_back(uid);
+  metaCloseCtbCursor(pCur);
+  ASSERT_EQ(uids.size(), 2);
+  EXPECT_EQ(uids[0], 201);
+  EXPECT_EQ(uids[1], 209);
+}
+
+// child tables share the schema of their super table in the cache, counted by the load report
+TEST_F(MetaTest, schemaCacheStat) {
+  int64_t nHit = -1, nMiss = -1;
+  createSuperTable();
+  ASSERT_EQ(createChildTable("t1", 301, 1, "a"), 0);
+  ASSERT_EQ(createChildTable("t2", 302, 2, "b"), 0);
+
+  metaGetSchemaCacheStat(pMeta, &nHit, &nMiss);
+  EXPECT_EQ(nHit, 0);
+  EXPECT_EQ(nMiss, 0);
+
+  // the first lookup loads the super table's schema
+  STSchema *pTSchema = metaGetTbTSchema(pMeta, 301, -1);
+  ASSERT_NE(pTSchema, nullptr);
+  EXPECT_EQ(pTSchema->numOfCols, 2);
+  EXPECT_EQ(pTSchema->version, 1);
+  taosMemoryFree(pTSchema);
+  metaGetSchemaCacheStat(pMeta, &nHit, &nMiss);
+  EXPECT_EQ(nHit, 0);
+  EXPECT_EQ(nMiss, 1);
+
+  // any child of the same super table hits, with or without an explicit version
+  pTSchema = metaGetTbTSchema(pMeta, 302, -1);
+  ASSERT_NE(pTSchema, nullptr);
+  EXPECT_EQ(pTSchema->numOfCols, 2);
+  taosMemoryFree(pTSchema);
+  pTSchema = metaGetTbTSchema(pMeta, 301, 1);
+  ASSERT_NE(pTSchema, nullptr);
+  taosMemoryFree(pTSchema);
+  ASSERT_EQ(metaGetTbTSchemaEx(pMeta, TEST_SUID, 302, 1, &pTSchema), 0);
+  EXPECT_EQ(pTSchema->numOfCols, 2);
+  taosMemoryFree(pTSchema);
+  metaGetSchemaCacheStat(pMeta, &nHit, &nMiss);
+  EXPECT_EQ(nHit, 3);
+  EXPECT_EQ(nMiss, 1);
+
+  // an unknown version misses
+  pTSchema = NULL;
+  EXPECT_NE(metaGetTbTSchemaEx(pMeta, TEST_SUID, 302, 7, &pTSchema), 0);
+  taosMemoryFree(pTSchema);
+  metaGetSchemaCacheStat(pMeta, &nHit, &nMiss);
+  EXPECT_EQ(nHit, 3);
+  EXPECT_EQ(nMiss, 2);
+}
+
+// the columnar tag cache returns the children in ctb.idx order after creates and drops reorder its slots
+TEST_F(MetaTest, tagCacheOrder) {
+  bool tagCache = tsMetaTagCache;
+  tsMetaTagCache = true;
+
+  createSuperTable();
+  ASSERT_EQ(createChildTable("c5", 505, 5, "c5"), 0);
+  ASSERT_EQ(createChildTable("c1", 501, 1, "c1"), 0);
+  ASSERT_EQ(createChildTable("c3", 503, 3, "c3"), 0);
+
+  // built from ctb.idx on first use
+  SArray *uidList = taosArrayInit(8, sizeof(tb_uid_t));
+  ASSERT_EQ(metaGetTagCacheUidList(pMeta, TEST_SUID, uidList), 0);
+  EXPECT_EQ(std::vector<tb_uid_t>((tb_uid_t *)TARRAY_GET_START(uidList),
+                                  (tb_uid_t *)TARRAY_GET_START(uidList) + taosArrayGetSize(uidList)),
+            std::vector<tb_uid_t>({501, 503, 505}));
+
+  // appended and moved into the hole of the dropped one in the cache
+  ASSERT_EQ(createChildTable("c2", 502, 2, "c2"), 0);
+  ASSERT_EQ(createChildTable("c4", 504, 4, "c4", -1, true), 0);
+  SVDropTbReq dropReq = {0};
+  dropReq.name = (char *)"c1";
+  ASSERT_EQ(metaDropTable(pMeta, ++version, &dropReq, NULL, NULL), 0);
+
+  std::vector<tb_uid_t> ctbUids;
+  SMCtbCursor          *pCur = metaOpenCtbCursor(pMeta, TEST_SUID);
+  ASSERT_NE(pCur, nullptr);
+  for (tb_uid_t uid; (uid = metaCtbCursorNext(pCur)) != 0;) ctbUids.push_back(uid);
+  metaCloseCtbCursor(pCur);
+  ASSERT_EQ(ctbUids, std::vector<tb_uid_t>({502, 503, 504, 505}));
+
+  taosArrayClear(uidList);
+  ASSERT_EQ(metaGetTagCacheUidList(pMeta, TEST_SUID, uidList), 0);
+  ASSERT_EQ(std::vector<tb_uid_t>((tb_uid_t *)TARRAY_GET_START(uidList),
+                                  (tb_uid_t *)TARRAY_GET_START(uidList) + taosArrayGetSize(uidList)),
+            ctbUids);
+
+  // the whole columns, then a subset out of order
+  for (int32_t round = 0; round < 2; round++) {
+    if (round == 1) {
+      taosArrayClear(uidList);
+      for (tb_uid_t uid : {505, 502, 504, 999}) taosArrayPush(uidList, &uid);
+    }
+    int32_t         rows = taosArrayGetSize(uidList);
+    SColumnInfoData t1 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 3);
+    SColumnInfoData t2 = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE, 4);
+    ASSERT_EQ(colInfoDataEnsureCapacity(&t1, rows), 0);
+    ASSERT_EQ(colInfoDataEnsureCapacity(&t2, rows), 0);
+    ASSERT_EQ(metaGetTagCacheCol(pMeta, TEST_SUID, uidList, 3, &t1), 0);
+    ASSERT_EQ(metaGetTagCacheCol(pMeta, TEST_SUID, uidList, 4, &t2), 0);
+
+    for (int32_t i = 0; i < rows; i++) {
+      tb_uid_t uid = *(tb_uid_t *)taosArrayGet(uidList, i);
+      if (uid == 999) {
+        EXPECT_TRUE(colDataIsNull_s(&t1, i));
+        EXPECT_TRUE(colDataIsNull_s(&t2, i));
+        continue;
+      }
+      if (uid == 504) {
+        EXPECT_TRUE(colDataIsNull_s(&t1, i));
+      } else {
+        ASSERT_FALSE(colDataIsNull_s(&t1, i));
+        EXPECT_EQ(*(int32_t *)colDataGetData(&t1, i), uid - 500);
+      }
+      ASSERT_FALSE(colDataIsNull_s(&t2, i));
+      char *p = colDataGetData(&t2, i);
+      EXPECT_EQ(std::string(varDataVal(p), varDataLen(p)), "c" + std::to_string(uid - 500));
+    }
+    colDataDestroy(&t1);
+    colDataDestroy(&t2);
+  }
+
+  taosArrayDestroy(uidList);
+  tsMetaTagCache = tagCache;
+}
+
+// filter funcs as the index filter builds them: 0 is a match, 1 a miss the scan goes on after
+static int fltGreaterThan(void *a, void *b, int16_t type) { return *(int32_t *)a > *(int32_t *)b ? 0 : 1; }
+static int fltGreaterEqual(void *a, void *b, int16_t type) { return *(int32_t *)a >= *(int32_t *)b ? 0 : 1; }
+static int fltLessThan(void *a, void *b, int16_t type) { return *(int32_t *)a < *(int32_t *)b ? 0 : 1; }
+static int fltLessEqual(void *a, void *b, int16_t type) { return *(int32_t *)a <= *(int32_t *)b ? 0 : 1; }
+static int fltEqual(void *a, void *b, int16_t type) { return *(int32_t *)a == *(int32_t *)b ? 0 : 1; }
+
+class MetaFilterTest : public MetaTest {
+ protected:
+  void SetUp() override {
+    MetaTest::SetUp();
+    createSuperTable();
+    // t1 of child i is i % 10, uids are not in value order
+    for (int32_t i = 0; i < 20; i++) {
+      std::string name = "f" + std::to_string(i);
+      ASSERT_EQ(createChildTable(name.c_str(), 600 + i, i % 10, "x"), 0);
+    }
+  }
+
+  struct Cond {
+    char    op[3];
+    int32_t val;
+  };
+
+  static SMetaFltParam toParam(const Cond &cond) {
+    SMetaFltParam param = {.suid = TEST_SUID, .cid = 3, .type = TSDB_DATA_TYPE_INT};
+    param.val = (void *)&cond.val;
+    if (strcmp(cond.op, ">") == 0) {
+      param.filterFunc = fltGreaterThan;
+    } else if (strcmp(cond.op, ">=") == 0) {
+      param.filterFunc = fltGreaterEqual;
+    } else if (strcmp(cond.op, "<") == 0) {
+      param.filterFunc = fltLessThan;
+      param.reverse = true;
+    } else if (strcmp(cond.op, "<=") == 0) {
+      param.filterFunc = fltLessEqual;
+      param.reverse = true;
+    } else {
+      param.filterFunc = fltEqual;
+      param.equal = true;
+    }
+    return param;
+  }
+
+  std::vector<tb_uid_t> filter(const std::vector<Cond> &conds) {
+    std::vector<SMetaFltParam> params;
+    for (const Cond &cond : conds) params.push_back(toParam(cond));
+
+    SArray *pUids = taosArrayInit(8, sizeof(tb_uid_t));
+    EXPECT_EQ(metaFilterTableIdsMulti(pMeta, params.data(), params.size(), pUids), 0);
+    std::vector<tb_uid_t> uids((tb_uid_t *)TARRAY_GET_START(pUids),
+                               (tb_uid_t *)TARRAY_GET_START(pUids) + taosArrayGetSize(pUids));
+    taosArrayDestroy(pUids);
+    return uids;
+  }
+
+  // children whose t1 satisfies all conditions, in uid order
+  static std::vector<tb_uid_t> expected(const std::vector<Cond> &conds) {
+    std::vector<tb_uid_t> uids;
+    for (int32_t i = 0; i < 20; i++) {
+      int32_t v = i % 10;
+      bool    match = true;
+      for (const Cond &cond : conds) {
+        SMetaFltParam param = toParam(cond);
+        match = match && param.filterFunc(&v, (void *)&cond.val, TSDB_DATA_TYPE_INT) == 0;
+      }
+      if (match) uids.push_back(600 + i);
+    }
+    return uids;
+  }
+
+  bool metaLockFree() {
+    if (taosThreadRwlockTryWrlock(&pMeta->lock) != 0) return false;
+    taosThreadRwlockUnlock(&pMeta->lock);
+    return true;
+  }
+};
+
+TEST_F(MetaFilterTest, single) {
+  std::vector<std::vector<Cond>> cases = {{{"=", 5}}, {{"=", 0}}, {{"=", 10}}, {{">", 7}},
+                                          {{">=", 7}}, {{"<", 2}}, {{"<=", 2}}, {{">", 9}}};
+  for (const std::vector<Cond> &conds : cases) {
+    EXPECT_EQ(filter(conds), expected(conds)) << conds[0].op << conds[0].val;
+
+    // same rows as the one condition scan, which returns them in value order
+    SMetaFltParam param = toParam(conds[0]);
+    SArray       *pUids = taosArrayInit(8, sizeof(tb_uid_t));
+    ASSERT_EQ(metaFilterTableIds(pMeta, &param, pUids), 0);
+    std::vector<tb_uid_t> uids((tb_uid_t *)TARRAY_GET_START(pUids),
+                               (tb_uid_t *)TARRAY_GET_START(pUids) + taosArrayGetSize(pUids));
+    taosArrayDestroy(pUids);
+    std::sort(uids.begin(), uids.end());
+    EXPECT_EQ(uids, expected(conds)) << conds[0].op << conds[0].val;
+  }
+}
+
+TEST_F(MetaFilterTest, rangeAndEqual) {
+  std::vector<std::vector<Cond>> cases = {
+      {{">", 3}, {"<", 7}},              // closed range
+      {{"<", 7}, {">", 3}},              // same, upper bound first
+      {{">=", 3}, {"<=", 3}},            // a point
+      {{">", 2}, {">", 7}},              // tightest lower bound is not the first
+      {{"<", 8}, {"<", 2}},              // upper bounds only, scanned backwards
+      {{"<=", 8}, {"<", 9}, {">=", 1}},  // redundant bounds
+      {{"=", 5}, {">", 2}},              // an equal starts the scan
+      {{">", 2}, {"=", 5}, {"<", 9}},
+      {{"=", 5}, {"<", 5}},              // equal outside the range
+      {{"=", 4}, {"=", 5}},              // two equals
+      {{">=", 8}, {"<=", 2}},            // empty range
+      {{">", 9}, {"<", 100}},            // past the last value
+  };
+  for (const std::vector<Cond> &conds : cases) {
+    std::string desc;
+    for (const Cond &cond : conds) desc += std::string(cond.op) + std::to_string(cond.val) + " ";
+    EXPECT_EQ(filter(conds), expected(conds)) << desc;
+  }
+  EXPECT_EQ(filter({{">", 3}, {"<", 7}}).size(), 6);
+}
+
+TEST_F(MetaFilterTest, invalid) {
+  SArray       *pUids = taosArrayInit(8, sizeof(tb_uid_t));
+  Cond          c1 = {">", 3}, c2 = {"<", 7};
+  SMetaFltParam params[2] = {toParam(c1), toParam(c2)};
+
+  // a NULL value fails before the meta lock is taken, in both the single and the multi condition path
+  params[1].val = NULL;
+  EXPECT_EQ(metaFilterTableIdsMulti(pMeta, params, 2, pUids), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_INVALID_PARA);
+  EXPECT_TRUE(metaLockFree());
+  EXPECT_EQ(metaFilterTableIds(pMeta, &params[1], pUids), -1);
+  EXPECT_TRUE(metaLockFree());
+
+  // conditions of different super tables
+  params[1] = toParam(c2);
+  params[1].suid = TEST_SUID + 1;
+  EXPECT_EQ(metaFilterTableIdsMulti(pMeta, params, 2, pUids), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_INVALID_PARA);
+  EXPECT_TRUE(metaLockFree());
+  EXPECT_EQ(taosArrayGetSize(pUids), 0);
+
+  // the meta is still writable
+  ASSERT_EQ(createChildTable("f20", 620, 5, "x"), 0);
+  params[1] = toParam(c2);
+  EXPECT_EQ(metaFilterTableIdsMulti(pMeta, params, 2, pUids), 0);
+  EXPECT_EQ(taosArrayGetSize(pUids), 7);
+  taosArrayDestroy(pUids);
+}
+
+// expired tables are dropped oldest first in batches of at most maxNum, more is set while expired ones are left
+TEST_F(MetaTest, ttlBatch) {
+  createSuperTable();
+
+  // expire at 1000 + i * 10 + ttlUnit
+  ttl = 1;
+  for (int32_t i = 0; i < 10; i++) {
+    ctime = (1000 + (9 - i) * 10) * 1000LL;
+    ASSERT_EQ(createChildTable(("e" + std::to_string(i)).c_str(), 700 + i, i, "x"), 0);
+  }
+  // not expired, no ttl
+  ttl = 100;
+  ASSERT_EQ(createChildTable("live", 720, 0, "x"), 0);
+  ttl = 0;
+  ASSERT_EQ(createChildTable("forever", 721, 0, "x"), 0);
+
+  int64_t               now = 1000 + 100 + tsTtlUnit;
+  std::vector<tb_uid_t> dropped;
+  int32_t               nBatch = 0;
+  for (bool more = true; more; nBatch++) {
+    SArray *tbUids = taosArrayInit(8, sizeof(tb_uid_t));
+    ASSERT_EQ(metaTtlDropTable(pMeta, now, 4, tbUids, &more), 0);
+    ASSERT_LE(taosArrayGetSize(tbUids), 4);
+    EXPECT_EQ(more, taosArrayGetSize(tbUids) == 4);
+    for (int32_t i = 0; i < taosArrayGetSize(tbUids); i++) dropped.push_back(*(tb_uid_t *)taosArrayGet(tbUids, i));
+    taosArrayDestroy(tbUids);
+
+    // the oldest go first, a batch is dropped in uid order
+    if (nBatch == 0) {
+      EXPECT_EQ(std::vector<tb_uid_t>(dropped.begin(), dropped.end()), std::vector<tb_uid_t>({706, 707, 708, 709}));
+      EXPECT_EQ(uidByName("e9"), 0);
+      EXPECT_EQ(uidByName("e5"), 705);
+    }
+  }
+  EXPECT_EQ(nBatch, 3);
+  std::sort(dropped.begin(), dropped.end());
+  EXPECT_EQ(dropped, std::vector<tb_uid_t>({700, 701, 702, 703, 704, 705, 706, 707, 708, 709}));
+
+  // nothing left to drop
+  bool    more = true;
+  SArray *tbUids = taosArrayInit(8, sizeof(tb_uid_t));
+  ASSERT_EQ(metaTtlDropTable(pMeta, now, 4, tbUids, &more), 0);
+  EXPECT_EQ(taosArrayGetSize(tbUids), 0);
+  EXPECT_FALSE(more);
+  taosArrayDestroy(tbUids);
+
+  for (int32_t i = 0; i < 10; i++) EXPECT_EQ(uidByName(("e" + std::to_string(i)).c_str()), 0);
+  EXPECT_EQ(uidByName("live"), 720);
+  EXPECT_EQ(uidByName("forever"), 721);
+
+  // no limit drops everything expired at once
+  now += 100 * tsTtlUnit;
+  tbUids = taosArrayInit(8, sizeof(tb_uid_t));
+  ASSERT_EQ(metaTtlDropTable(pMeta, now, 0, tbUids, &more), 0);
+  EXPECT_EQ(taosArrayGetSize(tbUids), 1);
+  EXPECT_FALSE(more);
+  taosArrayDestroy(tbUids);
+  EXPECT_EQ(uidByName("live"), 0);
+  EXPECT_EQ(uidByName("forever"), 721);
+}
+
+// with snapshot reads cursors and readers keep their own snapshot past commits and may be closed by any thread
+TEST_F(MetaTest, snapshotReadPins) {
+  bool snapshotRead = tsMetaSnapshotRead;
+  tsMetaSnapshotRead = true;
+  closeMeta();
+  openMeta();
+  ASSERT_TRUE(pMeta->snapRead);
+
+  createSuperTable();
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_EQ(createChildTable(("c" + std::to_string(i)).c_str(), 800 + i, i, "x"), 0);
+  }
+
+  SMCtbCursor *pCtbCur = metaOpenCtbCursor(pMeta, TEST_SUID);
+  ASSERT_NE(pCtbCur, nullptr);
+  SMTbCursor *pTbCur = metaOpenTbCursor(pMeta);
+  ASSERT_NE(pTbCur, nullptr);
+  SMetaReader mr = {0};
+  metaReaderInit(&mr, pMeta, 0);
+  EXPECT_FALSE(tdbInRead(pMeta->pEnv));
+
+  // a writer inside a read section releases the write lock on its own unlock
+  metaRLock(pMeta);
+  metaWLock(pMeta);
+  metaRLock(pMeta);
+  metaULock(pMeta);
+  EXPECT_NE(taosThreadRwlockTryWrlock(&pMeta->lock), 0);
+  metaULock(pMeta);
+  ASSERT_EQ(taosThreadRwlockTryWrlock(&pMeta->lock), 0);
+  taosThreadRwlockUnlock(&pMeta->lock);
+  EXPECT_TRUE(tdbInRead(pMeta->pEnv));
+  metaULock(pMeta);
+  EXPECT_FALSE(tdbInRead(pMeta->pEnv));
+
+  // the commit goes on with all of them open
+  for (int32_t i = 4; i < 6; i++) {
+    ASSERT_EQ(createChildTable(("c" + std::to_string(i)).c_str(), 800 + i, i, "x"), 0);
+  }
+  ASSERT_EQ(metaCommit(pMeta), 0);
+  ASSERT_EQ(metaBegin(pMeta, 1), 0);
+
+  std::vector<tb_uid_t> uids;
+  for (tb_uid_t uid; (uid = metaCtbCursorNext(pCtbCur)) != 0;) uids.push_back(uid);
+  EXPECT_EQ(uids, std::vector<tb_uid_t>({800, 801, 802, 803}));
+  int32_t nChild = 0;
+  while (metaTbCursorNext(pTbCur) == 0) {
+    if (pTbCur->mr.me.type == TSDB_CHILD_TABLE) nChild++;
+  }
+  EXPECT_EQ(nChild, 4);
+  EXPECT_EQ(metaGetTableEntryByName(&mr, "c3"), 0);
+  EXPECT_NE(metaGetTableEntryByName(&mr, "c5"), 0);
+
+  std::thread closer([&]() {
+    metaCloseCtbCursor(pCtbCur);
+    metaCloseTbCursor(pTbCur);
+    metaReaderClear(&mr);
+  });
+  closer.join();
+
+  EXPECT_EQ(uidByName("c5"), 805);
+  uids.clear();
+  pCtbCur = metaOpenCtbCursor(pMeta, TEST_SUID);
+  for (tb_uid_t uid; (uid = metaCtbCursorNext(pCtbCur)) != 0;) uids.push_back(uid);
+  metaCloseCtbCursor(pCtbCur);
+  EXPECT_EQ(uids.size(), 6);
+
+  tsMetaSnapshotRead = snapshotRead;
+}
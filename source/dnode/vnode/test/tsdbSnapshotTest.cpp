@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tsdb.h"
+#include "vnodeTestUtil.h"
+
+#define TEST_PAGE_SIZE 4096
+
+typedef struct {
+  SVnode* pVnode;
+  STsdb*  pTsdb;
+  char    root[TSDB_FILENAME_LEN];
+} STestTsdb;
+
+static void openTestTsdb(STestTsdb* pT, const char* root, int32_t vgId) {
+  snprintf(pT->root, sizeof(pT->root), "%s", root);
+
+  if (pT->pVnode == NULL) {
+    pT->pVnode = vnodeTestOpen(pT->root, vgId);
+    ASSERT_NE(pT->pVnode, nullptr);
+    pT->pVnode->config.tsdbPageSize = TEST_PAGE_SIZE;
+    pT->pVnode->config.cacheLastSize = 1;
+    pT->pVnode->config.tsdbCfg.days = 14400;
+    pT->pVnode->config.tsdbCfg.keep0 = 14400 * 100;
+    pT->pVnode->config.tsdbCfg.keep1 = 14400 * 100;
+    pT->pVnode->config.tsdbCfg.keep2 = 14400 * 100;
+  }
+
+  ASSERT_EQ(tsdbOpen(pT->pVnode, &pT->pTsdb, VNODE_TSDB_DIR, NULL), 0);
+}
+
+static void closeTestTsdb(STestTsdb* pT, bool keepVnode) {
+  tsdbClose(&pT->pTsdb);
+  if (!keepVnode) {
+    vnodeTestClose(pT->pVnode);
+    pT->pVnode = NULL;
+  }
+}
+
+static uint8_t fileByte(int32_t seed, int64_t i) { return (uint8_t)((seed * 31 + i) % 251); }
+
+static void writeTestFile(const char* fname, int64_t size, int32_t seed) {
+  TdFilePtr pFD = taosOpenFile(fname, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  ASSERT_NE(pFD, nullptr);
+
+  uint8_t buf[4096];
+  for (int64_t off = 0; off < size; off += sizeof(buf)) {
+    int64_t n = TMIN((int64_t)sizeof(buf), size - off);
+    for (int64_t i = 0; i < n; i++) buf[i] = fileByte(seed, off + i);
+    ASSERT_EQ(taosWriteFile(pFD, buf, n), n);
+  }
+  taosCloseFile(&pFD);
+}
+
+static void readTestFile(const char* fname, std::string* pContent) {
+  int64_t size = 0;
+  pContent->clear();
+  if (taosStatFile(fname, &size, NULL) < 0) return;
+
+  TdFilePtr pFD = taosOpenFile(fname, TD_FILE_READ);
+  ASSERT_NE(pFD, nullptr);
+  pContent->resize(size);
+  ASSERT_EQ(taosReadFile(pFD, &(*pContent)[0], size), size);
+  taosCloseFile(&pFD);
+}
+
+static bool testFileExist(const char* fname) { return taosCheckExistFile(fname); }
+
+// a file set with its own storage, file sizes are logic sizes
+typedef struct {
+  SDFileSet fSet;
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  fStt[TSDB_MAX_STT_TRIGGER];
+} STestFSet;
+
+static void initTestFSet(STestFSet* pT, int32_t fid, int64_t commitID, int64_t lSize, int32_t nStt,
+                         const int64_t* aSttCommitID) {
+  memset(pT, 0, sizeof(*pT));
+  pT->fHead = (SHeadFile){.commitID = commitID, .size = lSize, .offset = lSize / 2};
+  pT->fData = (SDataFile){.commitID = commitID, .size = lSize * 3};
+  pT->fSma = (SSmaFile){.commitID = commitID, .size = lSize / 4};
+  pT->fSet = (SDFileSet){.diskId = {0}, .fid = fid, .nSttF = (uint8_t)nStt};
+  pT->fSet.pHeadF = &pT->fHead;
+  pT->fSet.pDataF = &pT->fData;
+  pT->fSet.pSmaF = &pT->fSma;
+  for (int32_t iStt = 0; iStt < nStt; iStt++) {
+    pT->fStt[iStt] = (SSttFile){.commitID = aSttCommitID[iStt], .size = lSize + iStt * 100, .offset = 10};
+    pT->fSet.aSttF[iStt] = &pT->fStt[iStt];
+  }
+}
+
+static void testFileName(STsdb* pTsdb, SDFileSet* pSet, int32_t iFile, char* fname, int64_t* pSize) {
+  int64_t lSize;
+  if (iFile == 0) {
+    tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+    lSize = pSet->pHeadF->size;
+  } else if (iFile == 1) {
+    tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+    lSize = pSet->pDataF->size;
+  } else if (iFile == 2) {
+    tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+    lSize = pSet->pSmaF->size;
+  } else {
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iFile - 3], fname);
+    lSize = pSet->aSttF[iFile - 3]->size;
+  }
+  *pSize = tsdbLogicToFileSize(lSize, TEST_PAGE_SIZE);
+}
+
+static void writeTestFSetFiles(STsdb* pTsdb, SDFileSet* pSet) {
+  char    fname[TSDB_FILENAME_LEN];
+  int64_t size;
+  for (int32_t iFile = 0; iFile < 3 + pSet->nSttF; iFile++) {
+    testFileName(pTsdb, pSet, iFile, fname, &size);
+    writeTestFile(fname, size, pSet->fid * 10 + iFile);
+  }
+}
+
+// write the files of the set and commit it into the tsdb like a commit does
+static void commitTestFSet(STsdb* pTsdb, SDFileSet* pSet) {
+  writeTestFSetFiles(pTsdb, pSet);
+
+  STsdbFS fs = {0};
+  ASSERT_EQ(tsdbFSCopy(pTsdb, &fs), 0);
+  ASSERT_EQ(tsdbFSUpsertFSet(&fs, pSet), 0);
+  ASSERT_EQ(tsdbFSCommit1(pTsdb, &fs), 0);
+  ASSERT_EQ(tsdbFSCommit2(pTsdb, &fs), 0);
+  tsdbFSDestroy(&fs);
+}
+
+static SDFileSet* getFSet(STsdbFS* pFS, int32_t fid) {
+  SDFileSet tFSet = {.fid = fid};
+  return (SDFileSet*)taosArraySearch(pFS->aDFileSet, &tFSet, tDFileSetCmprFn, TD_EQ);
+}
+
+class TsdbSnapshotTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    taosRemoveDir(TD_TMP_DIR_PATH "tsdbSnapshotTest");
+    taosMkDir(TD_TMP_DIR_PATH "tsdbSnapshotTest");
+  }
+  static void TearDownTestSuite() { taosRemoveDir(TD_TMP_DIR_PATH "tsdbSnapshotTest"); }
+};
+
+TEST_F(TsdbSnapshotTest, upsertFSetSttList) {
+  STsdbFS fs = {0};
+  fs.aDFileSet = taosArrayInit(0, sizeof(SDFileSet));
+
+  STestFSet t;
+  int64_t   aSttID[] = {11, 12, 13, 14};
+
+  // new set with two stt files
+  initTestFSet(&t, 5, 10, 1000, 2, aSttID);
+  ASSERT_EQ(tsdbFSUpsertFSet(&fs, &t.fSet), 0);
+  SDFileSet* pSet = getFSet(&fs, 5);
+  ASSERT_NE(pSet, nullptr);
+  ASSERT_EQ(pSet->nSttF, 2);
+  ASSERT_EQ(pSet->aSttF[1]->commitID, 12);
+
+  // grow by more than one
+  initTestFSet(&t, 5, 20, 2000, 4, aSttID);
+  ASSERT_EQ(tsdbFSUpsertFSet(&fs, &t.fSet), 0);
+  pSet = getFSet(&fs, 5);
+  ASSERT_EQ(pSet->nSttF, 4);
+  ASSERT_EQ(pSet->pHeadF->commitID, 20);
+  for (int32_t iStt = 0; iStt < 4; iStt++) {
+    ASSERT_EQ(pSet->aSttF[iStt]->commitID, aSttID[iStt]);
+    ASSERT_EQ(pSet->aSttF[iStt]->size, 2000 + iStt * 100);
+  }
+
+  // shrink to one
+  int64_t aMergedID[] = {30};
+  initTestFSet(&t, 5, 30, 3000, 1, aMergedID);
+  ASSERT_EQ(tsdbFSUpsertFSet(&fs, &t.fSet), 0);
+  pSet = getFSet(&fs, 5);
+  ASSERT_EQ(pSet->nSttF, 1);
+  ASSERT_EQ(pSet->aSttF[0]->commitID, 30);
+  ASSERT_EQ(pSet->aSttF[0]->size, 3000);
+
+  // sets without stt files, kept in fid order
+  initTestFSet(&t, 3, 40, 500, 0, NULL);
+  ASSERT_EQ(tsdbFSUpsertFSet(&fs, &t.fSet), 0);
+  initTestFSet(&t, 5, 50, 500, 0, NULL);
+  ASSERT_EQ(tsdbFSUpsertFSet(&fs, &t.fSet), 0);
+  ASSERT_EQ(taosArrayGetSize(fs.aDFileSet), 2);
+  ASSERT_EQ(((SDFileSet*)taosArrayGet(fs.aDFileSet, 0))->fid, 3);
+  ASSERT_EQ(((SDFileSet*)taosArrayGet(fs.aDFileSet, 0))->nSttF, 0);
+  ASSERT_EQ(((SDFileSet*)taosArrayGet(fs.aDFileSet, 1))->fid, 5);
+  ASSERT_EQ(((SDFileSet*)taosArrayGet(fs.aDFileSet, 1))->nSttF, 0);
+
+  tsdbFSDestroy(&fs);
+}
+
+TEST_F(TsdbSnapshotTest, commitSttList) {
+  STestTsdb tsdb = {0};
+  openTestTsdb(&tsdb, TD_TMP_DIR_PATH "tsdbSnapshotTest" TD_DIRSEP "commit", 2);
+  STsdb* pTsdb = tsdb.pTsdb;
+
+  STestFSet t;
+  char      fname[TSDB_FILENAME_LEN];
+  int64_t   size;
+
+  // add a set with one stt, then append two stt files from later commits
+  int64_t aSttID[] = {1, 2, 3};
+  initTestFSet(&t, 7, 1, 10000, 1, aSttID);
+  commitTestFSet(pTsdb, &t.fSet);
+  initTestFSet(&t, 7, 1, 10000, 3, aSttID);
+  commitTestFSet(pTsdb, &t.fSet);
+
+  SDFileSet* pSet = getFSet(&pTsdb->fs, 7);
+  ASSERT_NE(pSet, nullptr);
+  ASSERT_EQ(pSet->nSttF, 3);
+  for (int32_t iStt = 0; iStt < 3; iStt++) {
+    ASSERT_EQ(pSet->aSttF[iStt]->commitID, aSttID[iStt]);
+    ASSERT_EQ(pSet->aSttF[iStt]->nRef, 1);
+  }
+
+  std::vector<std::string> oldStt;
+  for (int32_t iStt = 0; iStt < 3; iStt++) {
+    testFileName(pTsdb, pSet, 3 + iStt, fname, &size);
+    oldStt.push_back(fname);
+    ASSERT_TRUE(testFileExist(fname));
+  }
+
+  // a merge replaces all stt files of the set with one
+  int64_t aMergedID[] = {4};
+  initTestFSet(&t, 7, 4, 20000, 1, aMergedID);
+  commitTestFSet(pTsdb, &t.fSet);
+
+  pSet = getFSet(&pTsdb->fs, 7);
+  ASSERT_EQ(pSet->nSttF, 1);
+  ASSERT_EQ(pSet->aSttF[0]->commitID, 4);
+  ASSERT_EQ(pSet->pDataF->size, 60000);
+  for (auto& f : oldStt) {
+    ASSERT_FALSE(testFileExist(f.c_str()));
+  }
+  testFileName(pTsdb, pSet, 3, fname, &size);
+  ASSERT_TRUE(testFileExist(fname));
+
+  // a new set without stt files and a new one with several
+  initTestFSet(&t, 8, 5, 3000, 0, NULL);
+  commitTestFSet(pTsdb, &t.fSet);
+  int64_t aNewID[] = {5, 6};
+  initTestFSet(&t, 9, 5, 3000, 2, aNewID);
+  commitTestFSet(pTsdb, &t.fSet);
+
+  ASSERT_EQ(taosArrayGetSize(pTsdb->fs.aDFileSet), 3);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 8)->nSttF, 0);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 9)->nSttF, 2);
+
+  // the committed file system is loaded back and matches the files on disk
+  closeTestTsdb(&tsdb, true);
+  openTestTsdb(&tsdb, tsdb.root, 2);
+  pTsdb = tsdb.pTsdb;
+  ASSERT_EQ(taosArrayGetSize(pTsdb->fs.aDFileSet), 3);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 7)->nSttF, 1);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 7)->aSttF[0]->commitID, 4);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 8)->nSttF, 0);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 9)->nSttF, 2);
+  ASSERT_EQ(getFSet(&pTsdb->fs, 9)->aSttF[1]->commitID, 6);
+
+  closeTestTsdb(&tsdb, false);
+}
+
+TEST_F(TsdbSnapshotTest, wholeFileCopy) {
+  STestTsdb src = {0};
+  STestTsdb dst = {0};
+  openTestTsdb(&src, TD_TMP_DIR_PATH "tsdbSnapshotTest" TD_DIRSEP "src", 3);
+  openTestTsdb(&dst, TD_TMP_DIR_PATH "tsdbSnapshotTest" TD_DIRSEP "dst", 3);
+
+  // fid 1 spans several chunks, fid 2 has no stt file
+  STestFSet t;
+  int64_t   aSttID[] = {2};
+  initTestFSet(&t, 1, 2, 900 * 1024, 1, aSttID);
+  commitTestFSet(src.pTsdb, &t.fSet);
+  initTestFSet(&t, 2, 2, 5000, 0, NULL);
+  commitTestFSet(src.pTsdb, &t.fSet);
+
+  // the destination has an older version of fid 1 with more stt files
+  int64_t aOldID[] = {1, 2};
+  initTestFSet(&t, 1, 1, 7000, 2, aOldID);
+  commitTestFSet(dst.pTsdb, &t.fSet);
+  char    fname[TSDB_FILENAME_LEN];
+  int64_t size;
+  testFileName(dst.pTsdb, getFSet(&dst.pTsdb->fs, 1), 4, fname, &size);
+  std::string oldStt = fname;
+
+  // transfer
+  dst.pVnode->state.commitID = 9;
+  STsdbSnapReader* pReader = NULL;
+  STsdbSnapWriter* pWriter = NULL;
+  ASSERT_EQ(tsdbSnapReaderOpen(src.pTsdb, 0, INT64_MAX, SNAP_DATA_TSDB, &pReader), 0);
+  ASSERT_EQ(tsdbSnapWriterOpen(dst.pTsdb, 0, INT64_MAX, &pWriter), 0);
+
+  int32_t nChunk = 0;
+  while (true) {
+    uint8_t* pData = NULL;
+    ASSERT_EQ(tsdbSnapRead(pReader, &pData), 0);
+    if (pData == NULL) break;
+
+    SSnapDataHdr* pHdr = (SSnapDataHdr*)pData;
+    ASSERT_EQ(pHdr->type, SNAP_DATA_TSDB_FILE);
+    ASSERT_EQ(tsdbSnapWrite(pWriter, pData, sizeof(SSnapDataHdr) + pHdr->size), 0);
+    taosMemoryFree(pData);
+    nChunk++;
+  }
+  ASSERT_GT(nChunk, 2 + 3 + 4);
+
+  ASSERT_EQ(tsdbSnapReaderClose(&pReader), 0);
+  ASSERT_EQ(tsdbSnapWriterClose(&pWriter, 0), 0);
+
+  // same sets, files renamed to the writer commit id, same bytes
+  ASSERT_EQ(taosArrayGetSize(dst.pTsdb->fs.aDFileSet), 2);
+  for (int32_t fid = 1; fid <= 2; fid++) {
+    SDFileSet* pSrcSet = getFSet(&src.pTsdb->fs, fid);
+    SDFileSet* pDstSet = getFSet(&dst.pTsdb->fs, fid);
+    ASSERT_NE(pDstSet, nullptr);
+    ASSERT_EQ(pDstSet->nSttF, pSrcSet->nSttF);
+    ASSERT_EQ(pDstSet->pHeadF->commitID, 9);
+    ASSERT_EQ(pDstSet->pHeadF->offset, pSrcSet->pHeadF->offset);
+    ASSERT_EQ(pDstSet->pDataF->size, pSrcSet->pDataF->size);
+
+    for (int32_t iFile = 0; iFile < 3 + pSrcSet->nSttF; iFile++) {
+      std::string srcContent, dstContent;
+      testFileName(src.pTsdb, pSrcSet, iFile, fname, &size);
+      readTestFile(fname, &srcContent);
+      testFileName(dst.pTsdb, pDstSet, iFile, fname, &size);
+      readTestFile(fname, &dstContent);
+      ASSERT_EQ(srcContent.size(), size);
+      ASSERT_TRUE(srcContent == dstContent) << "fid:" << fid << " iFile:" << iFile;
+    }
+  }
+  ASSERT_FALSE(testFileExist(oldStt.c_str()));
+
+  // the copied file system is loaded back
+  closeTestTsdb(&dst, true);
+  openTestTsdb(&dst, dst.root, 3);
+  ASSERT_EQ(taosArrayGetSize(dst.pTsdb->fs.aDFileSet), 2);
+  ASSERT_EQ(getFSet(&dst.pTsdb->fs, 1)->nSttF, 1);
+
+  closeTestTsdb(&src, false);
+  closeTestTsdb(&dst, false);
+}
+
+TEST_F(TsdbSnapshotTest, wholeFileCopyCorrupted) {
+  STestTsdb src = {0};
+  STestTsdb dst = {0};
+  openTestTsdb(&src, TD_TMP_DIR_PATH "tsdbSnapshotTest" TD_DIRSEP "csrc", 4);
+  openTestTsdb(&dst, TD_TMP_DIR_PATH "tsdbSnapshotTest" TD_DIRSEP "cdst", 4);
+
+  STestFSet t;
+  int64_t   aSttID[] = {2};
+  initTestFSet(&t, 1, 2, 5000, 1, aSttID);
+  commitTestFSet(src.pTsdb, &t.fSet);
+
+  STsdbSnapReader* pReader = NULL;
+  STsdbSnapWriter* pWriter = NULL;
+  ASSERT_EQ(tsdbSnapReaderOpen(src.pTsdb, 0, INT64_MAX, SNAP_DATA_TSDB, &pReader), 0);
+  ASSERT_EQ(tsdbSnapWriterOpen(dst.pTsdb, 0, INT64_MAX, &pWriter), 0);
+
+  // the file set info is accepted, a flipped byte in the first file chunk is not
+  uint8_t* pData = NULL;
+  ASSERT_EQ(tsdbSnapRead(pReader, &pData), 0);
+  SSnapDataHdr* pHdr = (SSnapDataHdr*)pData;
+  ASSERT_EQ(tsdbSnapWrite(pWriter, pData, sizeof(SSnapDataHdr) + pHdr->size), 0);
+  taosMemoryFree(pData);
+
+  ASSERT_EQ(tsdbSnapRead(pReader, &pData), 0);
+  pHdr = (SSnapDataHdr*)pData;
+  pHdr->data[pHdr->size - 1] ^= 0xff;
+  ASSERT_EQ(tsdbSnapWrite(pWriter, pData, sizeof(SSnapDataHdr) + pHdr->size), TSDB_CODE_CHECKSUM_ERROR);
+  taosMemoryFree(pData);
+
+  ASSERT_EQ(tsdbSnapReaderClose(&pReader), 0);
+  tsdbSnapWriterClose(&pWriter, 0);
+  ASSERT_EQ(getFSet(&dst.pTsdb->fs, 1), nullptr);
+
+  closeTestTsdb(&src, false);
+  closeTestTsdb(&dst, false);
+}
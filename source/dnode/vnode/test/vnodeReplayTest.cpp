@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../src/vnd/vnodeReplay.c"
+#include "vnodeTestUtil.h"
+
+#define REPLAY_TEST_ROOT TD_TMP_DIR_PATH "vnodeReplayTest"
+
+// replay ops recording what the batch driver does, instead of writing to tsdb/tq
+typedef struct {
+  char    type;  // 'i' insert, 'p' post, 'a' apply
+  int64_t version;
+  int64_t uid;
+} SReplayEvent;
+
+static TdThreadMutex             replayMutex;
+static std::vector<SReplayEvent> replayEvents;
+static int64_t                   replayFailUid = -1;
+static int32_t                   replayFailCode = TSDB_CODE_OUT_OF_MEMORY;
+static bool                      replaySerial = false;  // every entry applied one by one, as with no replay threads
+
+static void replayRecord(char type, int64_t version, int64_t uid) {
+  taosThreadMutexLock(&replayMutex);
+  replayEvents.push_back({type, version, uid});
+  taosThreadMutexUnlock(&replayMutex);
+}
+
+static void testScan(SVnode *pVnode, SReplayEntry *pEntry) {
+  pEntry->parallel = (pEntry->msgType == TDMT_VND_SUBMIT && !replaySerial);
+}
+
+static int32_t testInsert(SVnode *pVnode, SReplayEntry *pEntry, SSubmitMsgIter *pIter, SSubmitBlk *pBlock,
+                          SSubmitBlkRsp *pRsp) {
+  if (pIter->uid == replayFailUid) {
+    terrno = replayFailCode;
+    return -1;
+  }
+  // give other workers a chance to run out of order if the driver is wrong
+  if (pIter->uid % 3 == 0) taosUsleep(100);
+  replayRecord('i', pEntry->version, pIter->uid);
+  pRsp->numOfRows = pIter->numOfRows;
+  return 0;
+}
+
+static int32_t testPost(SVnode *pVnode, SReplayEntry *pEntry) {
+  replayRecord('p', pEntry->version, 0);
+  pVnode->state.applied = pEntry->version;
+  return 0;
+}
+
+// a submit applied as by vnodeProcessSubmitReq, a block that fails to insert fails alone
+static int32_t testApply(SVnode *pVnode, SReplayEntry *pEntry) {
+  if (pEntry->msgType == TDMT_VND_SUBMIT) {
+    SSubmitMsgIter msgIter = {0};
+    SSubmitBlk    *pBlock = NULL;
+
+    tInitSubmitMsgIter((SSubmitReq *)pEntry->pCont, &msgIter);
+    for (;;) {
+      tGetSubmitMsgNext(&msgIter, &pBlock);
+      if (pBlock == NULL) break;
+
+      SSubmitBlkRsp blkRsp = {0};
+      testInsert(pVnode, pEntry, &msgIter, pBlock, &blkRsp);
+    }
+  }
+
+  replayRecord('a', pEntry->version, 0);
+  pVnode->state.applied = pEntry->version;
+  return 0;
+}
+
+static const SReplayOps testReplayOps = {
+    .scan = testScan,
+    .insert = testInsert,
+    .post = testPost,
+    .apply = testApply,
+};
+
+static void *buildSubmit(const std::vector<int64_t> &uids, int32_t *pLen) {
+  int32_t     len = sizeof(SSubmitReq) + uids.size() * sizeof(SSubmitBlk);
+  SSubmitReq *pReq = (SSubmitReq *)taosMemoryCalloc(1, len);
+
+  pReq->header.contLen = htonl(len);
+  pReq->length = htonl(len);
+  pReq->numOfBlocks = htonl(uids.size());
+  SSubmitBlk *pBlock = (SSubmitBlk *)pReq->blocks;
+  for (int64_t uid : uids) {
+    pBlock->uid = htobe64(uid);
+    pBlock->numOfRows = htonl(1);
+    pBlock++;
+  }
+
+  *pLen = len;
+  return pReq;
+}
+
+class VnodeReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosThreadMutexInit(&replayMutex, NULL);
+    replayEvents.clear();
+    replayFailUid = -1;
+    replayFailCode = TSDB_CODE_OUT_OF_MEMORY;
+    replaySerial = false;
+
+    pVnode = vnodeTestOpen(REPLAY_TEST_ROOT, 2);
+    ASSERT_NE(pVnode, nullptr);
+
+    pCtx = (SReplayCtx *)taosMemoryCalloc(1, sizeof(SReplayCtx));
+    pCtx->pVnode = pVnode;
+    pCtx->pOps = &testReplayOps;
+    pCtx->nWorker = 4;
+    pCtx->aEntry = (SReplayEntry *)taosMemoryCalloc(REPLAY_BATCH_SIZE, sizeof(SReplayEntry));
+    ASSERT_EQ(vnodeReplayStartWorkers(pCtx), 0);
+  }
+
+  void TearDown() override {
+    vnodeReplayStopWorkers(pCtx);
+    vnodeReplayClearBatch(pCtx);
+    taosMemoryFree(pCtx->aEntry);
+    taosMemoryFree(pCtx);
+    vnodeTestClose(pVnode);
+    taosRemoveDir(REPLAY_TEST_ROOT);
+    taosThreadMutexDestroy(&replayMutex);
+  }
+
+  void addSubmit(const std::vector<int64_t> &uids) {
+    SReplayEntry *pEntry = &pCtx->aEntry[pCtx->nEntry++];
+    memset(pEntry, 0, sizeof(*pEntry));
+    pEntry->version = ++version;
+    pEntry->msgType = TDMT_VND_SUBMIT;
+    pEntry->pCont = buildSubmit(uids, &pEntry->contLen);
+  }
+
+  void addBarrier() {
+    SReplayEntry *pEntry = &pCtx->aEntry[pCtx->nEntry++];
+    memset(pEntry, 0, sizeof(*pEntry));
+    pEntry->version = ++version;
+    pEntry->msgType = TDMT_VND_CREATE_TABLE;
+    pEntry->contLen = sizeof(SMsgHead);
+    pEntry->pCont = taosMemoryCalloc(1, pEntry->contLen);
+  }
+
+  SVnode     *pVnode = NULL;
+  SReplayCtx *pCtx = NULL;
+  int64_t     version = 0;
+};
+
+TEST_F(VnodeReplayTest, orderAndBarrier) {
+  // two runs of submits around a barrier, tables spread over all workers
+  for (int32_t i = 0; i < 20; i++) addSubmit({1, 2, 3, 4, 5, 6, 7, 8});
+  addBarrier();
+  for (int32_t i = 0; i < 20; i++) addSubmit({3, 6, 9, 12});
+  int64_t barrier = 21;
+
+  ASSERT_EQ(vnodeReplayApplyBatch(pCtx), 0);
+  EXPECT_EQ(pCtx->nEntry, 0);
+  EXPECT_EQ(pCtx->nParallel, 40);
+  EXPECT_EQ(pCtx->nRowTotal, 20 * 8 + 20 * 4);
+  EXPECT_EQ(pVnode->state.applied, version);
+
+  std::map<int64_t, int64_t> lastVer;  // uid -> last inserted version
+  int64_t                    lastPost = 0;
+  bool                       barrierDone = false;
+  int32_t                    nInsert = 0;
+  for (size_t i = 0; i < replayEvents.size(); i++) {
+    const SReplayEvent &ev = replayEvents[i];
+    if (ev.type == 'i') {
+      // rows of one table are inserted in version order
+      EXPECT_GT(ev.version, lastVer[ev.uid]);
+      lastVer[ev.uid] = ev.version;
+      // nothing of the second run is inserted before the barrier, nothing of the first after it
+      EXPECT_EQ(ev.version > barrier, barrierDone);
+      nInsert++;
+    } else if (ev.type == 'p') {
+      // post processing is done in version order, after all inserts of the run
+      EXPECT_GT(ev.version, lastPost);
+      lastPost = ev.version;
+    } else {
+      EXPECT_EQ(ev.version, barrier);
+      // the barrier waits for the whole first run to be posted
+      EXPECT_EQ(lastPost, barrier - 1);
+      barrierDone = true;
+    }
+  }
+  EXPECT_TRUE(barrierDone);
+  EXPECT_EQ(nInsert, 20 * 8 + 20 * 4);
+  EXPECT_EQ(lastPost, version);
+
+  // inserts of one run all come before its first post
+  for (size_t i = 0, firstPost = SIZE_MAX; i < replayEvents.size(); i++) {
+    if (replayEvents[i].type == 'p' && firstPost == SIZE_MAX) firstPost = i;
+    if (replayEvents[i].type == 'a') firstPost = SIZE_MAX;
+    if (replayEvents[i].type == 'i') EXPECT_EQ(firstPost, SIZE_MAX);
+  }
+}
+
+TEST_F(VnodeReplayTest, workerReuse) {
+  TdThread threads[REPLAY_MAX_THREADS];
+  for (int32_t i = 0; i < pCtx->nWorker; i++) threads[i] = pCtx->aWorker[i].thread;
+
+  for (int32_t round = 0; round < 50; round++) {
+    addSubmit({(int64_t)round, (int64_t)round + 1});
+    addBarrier();
+    ASSERT_EQ(vnodeReplayApplyBatch(pCtx), 0);
+  }
+
+  EXPECT_EQ(pCtx->nThread, pCtx->nWorker);
+  for (int32_t i = 0; i < pCtx->nWorker; i++) {
+    EXPECT_TRUE(taosThreadEqual(threads[i], pCtx->aWorker[i].thread));
+  }
+  EXPECT_EQ(pVnode->state.applied, version);
+  EXPECT_EQ(pCtx->nParallel, 50);
+}
+
+TEST_F(VnodeReplayTest, insertError) {
+  addSubmit({1, 2, 3});
+  addSubmit({4, 5, 6});
+  addBarrier();
+  replayFailUid = 5;
+
+  terrno = 0;
+  EXPECT_EQ(vnodeReplayApplyBatch(pCtx), -1);
+  EXPECT_EQ(terrno, TSDB_CODE_OUT_OF_MEMORY);
+
+  // nothing of the failed run is post processed, the barrier is not applied
+  for (const SReplayEvent &ev : replayEvents) {
+    EXPECT_EQ(ev.type, 'i');
+  }
+  EXPECT_EQ(pVnode->state.applied, 0);
+}
+
+TEST_F(VnodeReplayTest, droppedTable) {
+  // table 5 is dropped by a later entry, its blocks fail but the rest of the wal is replayed as in serial apply
+  replayFailUid = 5;
+  replayFailCode = TSDB_CODE_TDB_TABLE_NOT_EXIST;
+
+  std::set<std::pair<int64_t, int64_t>> inserted[2];  // (version, uid)
+  std::set<int64_t>                     done[2];      // versions posted or applied
+  int64_t                               applied[2];
+  for (int32_t serial = 0; serial < 2; serial++) {
+    replaySerial = serial;
+    replayEvents.clear();
+    version = 0;
+    pVnode->state.applied = 0;
+
+    addSubmit({1, 2, 3, 4, 5, 6});
+    addSubmit({4, 5, 6});
+    addBarrier();
+    addSubmit({5, 7});
+    addSubmit({8});
+
+    terrno = 0;
+    ASSERT_EQ(vnodeReplayApplyBatch(pCtx), 0);
+    for (const SReplayEvent &ev : replayEvents) {
+      if (ev.type == 'i') {
+        inserted[serial].insert({ev.version, ev.uid});
+      } else {
+        done[serial].insert(ev.version);
+      }
+    }
+    applied[serial] = pVnode->state.applied;
+  }
+
+  EXPECT_EQ(inserted[0], inserted[1]);
+  EXPECT_EQ(done[0], done[1]);
+  EXPECT_EQ(applied[0], applied[1]);
+  EXPECT_EQ(applied[0], version);
+  EXPECT_EQ(inserted[0].size(), 5 + 2 + 1 + 1);
+  EXPECT_EQ(done[0].size(), version);
+}
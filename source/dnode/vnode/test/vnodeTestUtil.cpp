@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnodeTestUtil.h"
+
+#define VNODE_TEST_PATH_LEN 16
+
+SVnode *vnodeTestOpen(const char *root, int32_t vgId) {
+  taosRemoveDir(root);
+  taosMkDir(root);
+
+  SDiskCfg diskCfg = {0};
+  snprintf(diskCfg.dir, sizeof(diskCfg.dir), "%s", root);
+  diskCfg.level = 0;
+  diskCfg.primary = 1;
+
+  SVnode *pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode) + VNODE_TEST_PATH_LEN);
+  if (pVnode == NULL) {
+    return NULL;
+  }
+  pVnode->path = (char *)&pVnode[1];
+  snprintf(pVnode->path, VNODE_TEST_PATH_LEN, "vnode%d", vgId);
+  pVnode->config = vnodeCfgDefault;
+  pVnode->config.vgId = vgId;
+  taosThreadMutexInit(&pVnode->mutex, NULL);
+  taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
+
+  pVnode->pTfs = tfsOpen(&diskCfg, 1);
+  if (pVnode->pTfs == NULL) {
+    vnodeTestClose(pVnode);
+    return NULL;
+  }
+
+  char dir[TSDB_FILENAME_LEN];
+  snprintf(dir, sizeof(dir), "%s%s%s", root, TD_DIRSEP, pVnode->path);
+  taosMkDir(dir);
+
+  return pVnode;
+}
+
+void vnodeTestClose(SVnode *pVnode) {
+  if (pVnode == NULL) {
+    return;
+  }
+
+  tfsClose(pVnode->pTfs);
+  taosThreadCondDestroy(&pVnode->poolNotEmpty);
+  taosThreadMutexDestroy(&pVnode->mutex);
+  taosMemoryFree(pVnode);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VNODE_TEST_UTIL_H
+#define VNODE_TEST_UTIL_H
+
+#include "vnd.h"
+
+// a vnode of the unit tests with the default config, a tfs on an emptied root and its directory "vnode<vgId>" in it.
+// Meta, tsdb and the buffer pool are opened by the tests. NULL if the tfs can not be opened
+SVnode *vnodeTestOpen(const char *root, int32_t vgId);
+void    vnodeTestClose(SVnode *pVnode);
+
+#endif  // VNODE_TEST_UTIL_H
@@ -34,6 +34,7 @@ extern "C" {
 #include "scalar.h"
 #include "taosdef.h"
 #include "tarray.h"
+#include "tgrouphash.h"
 #include "thash.h"
 #include "tlockfree.h"
 #include "tmsg.h"
@@ -183,6 +184,7 @@ typedef struct SExecTaskInfo {
   EOPTR_EXEC_MODEL      execModel;       // operator execution model [batch model|stream model]
   SSubplan*             pSubplan;
   struct SOperatorInfo* pRoot;
+  int64_t               groupBufSize;    // memory of the groups kept by all the group by operators of the query
 } SExecTaskInfo;
 
 enum {
@@ -317,6 +319,34 @@ typedef struct {
   SExprSupp*     pExprSup;  // expr supporter of aggregate operator
 } SAggOptrPushDownInfo;
 
+typedef struct STableScanWorker {
+  struct STableScanParaInfo* pPara;
+  struct STableScanInfo*     pScanInfo;  // private copy of the scan info with its own reader and filter
+  SOperatorInfo*             pOperator;  // shell operator to load data blocks in the worker
+  SExecTaskInfo*             pTaskInfo;  // private task info, errors in the worker jump to its env
+  SSDataBlock*               pBlock;     // the block being filled by the worker
+  bool                       pending;    // pBlock is loaded, but not pushed since the buffer is full
+} STableScanWorker;
+
+// Scan state shared by the query thread and the workers of a parallel table scan. Each worker scans a slice of the
+// table list and hands the loaded blocks over through a bounded buffer. A worker never waits for room in the buffer,
+// it is parked instead and rescheduled by the query thread, so the pool threads are not held by a slow consumer.
+typedef struct STableScanParaInfo {
+  TdThreadMutex           mutex;
+  TdThreadCond            notEmpty;
+  SArray*                 pBlocks;   // SSDataBlock*, loaded blocks not yet returned
+  SArray*                 pParked;   // STableScanWorker*, workers waiting for room in the buffer
+  int32_t                 capacity;  // the max number of buffered blocks
+  int32_t                 numOfWorkers;
+  int32_t                 numOfRunning;  // workers not ended yet, including the parked ones
+  int32_t                 code;
+  int8_t                  stop;
+  STableScanWorker*       pWorkers;
+  SSDataBlock*            pCurBlock;  // the block returned last time, released in the next call
+  SExecTaskInfo*          pTaskInfo;
+  SFileBlockLoadRecorder* pRecorder;  // load cost of the table scan, the cost of each worker is added when it ends
+} STableScanParaInfo;
+
 typedef struct STableScanInfo {
   STsdbReader* dataReader;
   SReadHandle  readHandle;
@@ -339,6 +369,12 @@ typedef struct STableScanInfo {
   int8_t               noTable;
   SAggOptrPushDownInfo pdInfo;
   int8_t               assignBlockUid;
+  int32_t              parallelism;
+  STableScanParaInfo*  pParaScan;
+  SLimitInfo           limitInfo;  // pushed down by the optimizer when the scan is in the order of the timestamp
+  SArray*              pFilterCols;       // ids of the columns required by the filter, which are loaded first
+  SArray*              pFilterColMatch;   // SColMatchInfo of the columns in pFilterCols
+  SArray*              pDelayedColMatch;  // SColMatchInfo of the columns loaded only for the rows passing the filter
 } STableScanInfo;
 
 typedef struct STableMergeScanInfo {
@@ -382,6 +418,7 @@ typedef struct STableMergeScanInfo {
   SSampleExecInfo sample;  // sample execution info
 
   SSortExecInfo sortExecInfo;
+  SLimitInfo    limitInfo;
 } STableMergeScanInfo;
 
 typedef struct STagScanInfo {
@@ -691,18 +728,74 @@ typedef struct SFillOperatorInfo {
   int32_t           numOfNotFillExpr;
 } SFillOperatorInfo;
 
+typedef enum EGroupKeyType {
+  GROUP_KEY_GENERIC = 0,  // serialized keys, one hash probe for each run of rows with identical keys
+  GROUP_KEY_INT,          // one or two integer keys, hashed and probed a block at a time
+  GROUP_KEY_TAG,          // a single tag key, which rarely changes within a data block
+} EGroupKeyType;
+
+typedef struct SGroupKeySup {
+  EGroupKeyType  keyType;
+  int32_t        keyWidth;    // width of the fixed size keys of GROUP_KEY_INT
+  int32_t        capacity;    // number of rows of the per block buffers
+  char*          pKeyBuf;     // group id + serialized group keys, the key of GROUP_KEY_GENERIC and GROUP_KEY_TAG
+  uint64_t*      pKeys;       // fixed size keys of GROUP_KEY_INT of current block
+  uint64_t*      pHashes;     // hash value of the group keys of each row of current block
+  int32_t*       pGroups;     // group (entry index of pHashTable) of each row of current block
+  SGroupHashObj* pHashTable;  // group keys and the per group payload
+  bool           noNewGroup;  // the rows of the groups not in pHashTable get -1, instead of creating new groups
+} SGroupKeySup;
+
+#define GROUP_SPILL_FANOUT_BITS 4
+#define GROUP_SPILL_FANOUT      (1 << GROUP_SPILL_FANOUT_BITS)
+#define GROUP_SPILL_MAX_LEVEL   7  // the upper 32 bits of the hash value are used to partition the rows
+
+typedef struct SGroupSpillPage {
+  int32_t  pageId;
+  uint64_t groupId;  // group id of the data block kept in the page
+} SGroupSpillPage;
+
+typedef struct SGroupSpillPartition {
+  int32_t level;      // the rows are partitioned by level radix passes over the hash value of the group keys
+  int64_t numOfRows;
+  SArray* pPageList;  // SArray<SGroupSpillPage>
+} SGroupSpillPartition;
+
+/**
+ * When the groups kept in memory by all the group by operators of the query reach queryGroupBufferSize, the rows of any
+ * other group are radix partitioned by the hash value of the group keys and written to disk, one data block per page. Once the groups in memory are returned, each spilled
+ * partition is aggregated in the same way, and partitioned further by the next bits of the hash value if it still
+ * does not fit in memory.
+ */
+typedef struct SGroupSpillSup {
+  int64_t              memLimit;   // queryGroupBufferSize in bytes, 0 means no limit
+  int64_t              groupSize;  // memory of a group kept in memory
+  int64_t              memUsed;    // memory of the groups kept by the operator, a part of pQueryMemUsed
+  int64_t*             pQueryMemUsed;  // SExecTaskInfo.groupBufSize
+  int32_t              level;      // radix passes over the rows being aggregated, 0 for the input of the operator
+  SDiskbasedBuf*       pBuf;       // spilled rows
+  int32_t              pageSize;
+  int32_t              rowsPerPage;
+  SSDataBlock*         pBlocks[GROUP_SPILL_FANOUT];  // rows of each partition not written yet
+  SGroupSpillPartition parts[GROUP_SPILL_FANOUT];    // partitions of the rows being aggregated
+  SArray*              pPending;   // SArray<SGroupSpillPartition>, partitions to be aggregated
+  SSDataBlock*         pReadBlock;
+  int64_t              numOfSpilledRows;
+} SGroupSpillSup;
+
 typedef struct SGroupbyOperatorInfo {
   SOptrBasicInfo binfo;
   SAggSupporter  aggSup;
 
-  SArray*       pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*       pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  SNode*        pCondition;
-  bool          isInit;       // denote if current val is initialized or not
-  char*         keyBuf;       // group by keys for hash
-  int32_t       groupKeyLen;  // total group by column width
-  SGroupResInfo groupResInfo;
-  SExprSupp     scalarSup;
+  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  SNode*         pCondition;
+  char*          keyBuf;       // group by keys for hash
+  int32_t        groupKeyLen;  // total group by column width
+  SGroupKeySup   keySup;       // group of each row, the payload is the SResultRowPosition of the group
+  SGroupResInfo  groupResInfo;
+  SExprSupp      scalarSup;
+  SGroupSpillSup spillSup;
 } SGroupbyOperatorInfo;
 
 typedef struct SDataGroupInfo {
@@ -718,7 +811,7 @@ typedef struct SPartitionOperatorInfo {
   SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
   char*          keyBuf;         // group by keys for hash
   int32_t        groupKeyLen;    // total group by column width
-  SHashObj*      pGroupSet;      // quick locate the window object for each result
+  SGroupKeySup   keySup;         // group of each row, the payload is the SDataGroupInfo of the group
 
   SDiskbasedBuf* pBuf;              // query result buffer based on blocked-wised disk file
   int32_t        rowCapacity;       // maximum number of rows for each buffer page
@@ -878,6 +971,43 @@ typedef struct SJoinOperatorInfo {
   SNode*       pCondAfterMerge;
 } SJoinOperatorInfo;
 
+#define HJOIN_PART_BITS     4
+#define HJOIN_NUM_OF_PARTS  (1 << HJOIN_PART_BITS)
+
+typedef struct SHJoinSide {
+  SArray*      pKeyCols;  // SColumnInfo of the join keys in the blocks of this side
+  SSDataBlock* pTemplate;
+  SArray*      pBlocks;   // SSDataBlock* read ahead from the downstream
+  int64_t      bytes;
+  bool         finished;
+  int32_t      rowsPerPage;
+  SArray*      pPageIds[HJOIN_NUM_OF_PARTS];
+  int64_t      partRows[HJOIN_NUM_OF_PARTS];
+  SSDataBlock* pPartBlock[HJOIN_NUM_OF_PARTS];  // rows of a partition not yet flushed to a page
+  SSDataBlock* pLoadBlock;
+} SHJoinSide;
+
+typedef struct SHashJoinOperatorInfo {
+  SSDataBlock*   pRes;
+  int32_t        joinType;
+  SHJoinSide     side[2];
+  int32_t        buildIdx;      // the hash table is built on this side and probed by the other one
+  SHashObj*      pHashTable;    // join key -> index of the first SHJoinRowRef of the key
+  SArray*        pRowRefs;      // SHJoinRowRef
+  SArray*        pBuildBlocks;  // SSDataBlock* referenced by pRowRefs
+  SArray*        pMatches;      // SHJoinMatch of the probe batch
+  char*          keyBuf;
+  int32_t        keyLen;
+  int64_t        maxBufSize;    // of the inputs kept in memory, beyond it both are partitioned to pBuf
+  SDiskbasedBuf* pBuf;          // partitions of both sides when the build side does not fit in memory
+  bool           spilled;
+  int32_t        curPart;
+  int32_t        probeBlockIdx;
+  SSDataBlock*   pProbe;
+  int32_t        probeRow;
+  SNode*         pCondAfterJoin;
+} SHashJoinOperatorInfo;
+
 #define OPTR_IS_OPENED(_optr)  (((_optr)->status & OP_OPENED) == OP_OPENED)
 #define OPTR_SET_OPENED(_optr) ((_optr)->status |= OP_OPENED)
 
@@ -918,6 +1048,9 @@ int32_t getBufferPgSize(int32_t rowSize, uint32_t* defaultPgsz, uint32_t* defaul
 
 void    doSetOperatorCompleted(SOperatorInfo* pOperator);
 void    doFilter(const SNode* pFilterNode, SSDataBlock* pBlock, const SArray* pColMatchInfo);
+// doFilter in two steps: evaluate the filter to the result of each row, and then keep the qualified rows in the block
+bool    doEvalFilter(const SNode* pFilterNode, SSDataBlock* pBlock, int8_t** rowRes);
+void    doApplyFilterResult(SSDataBlock* pBlock, const int8_t* rowRes, bool keep, const SArray* pColMatchInfo);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, SExprInfo* pPseudoExpr, int32_t numOfPseudoExpr,
                                SSDataBlock* pBlock, const char* idStr);
 
@@ -996,6 +1129,9 @@ SOperatorInfo* createTimeSliceOperatorInfo(SOperatorInfo* downstream, SPhysiNode
 SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                            SSortMergeJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
 
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
+
 SOperatorInfo* createStreamSessionAggOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pPhyNode,
                                                   SExecTaskInfo* pTaskInfo);
 SOperatorInfo* createStreamFinalSessionAggOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pPhyNode,
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TGROUPHASH_H
+#define TDENGINE_TGROUPHASH_H
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief single thread, insert only hash table for the group by/partition by operators
+ *
+ * The slots are probed linearly and each slot keeps the high bits of the hash value together with the entry index, so
+ * that a probe only touches an entry when the hash values match. The entries are kept in insertion order in one
+ * array: the fixed size payload and the key, which is stored inline up to GROUP_HASH_MAX_INLINE_KEY bytes. An entry is
+ * addressed by its index, which stays valid until the table is cleared, while the pointer returned by
+ * tGroupHashGetData is only valid until the next insertion.
+ */
+typedef struct SGroupHashObj SGroupHashObj;
+
+#define GROUP_HASH_MAX_INLINE_KEY 128
+
+/**
+ * init the hash table
+ *
+ * @param capacity  initial number of entries
+ * @param maxKeyLen maximum length of the keys
+ * @param dataLen   length of the payload of each entry, which is zeroed when the entry is created
+ * @return
+ */
+SGroupHashObj *tGroupHashInit(int32_t capacity, int32_t maxKeyLen, int32_t dataLen);
+
+void tGroupHashCleanup(SGroupHashObj *pHashObj);
+
+void tGroupHashClear(SGroupHashObj *pHashObj);
+
+int32_t tGroupHashGetSize(const SGroupHashObj *pHashObj);
+
+/**
+ * hash value of a key of arbitrary length
+ */
+uint64_t tGroupHashCalc(const void *key, int32_t keyLen);
+
+/**
+ * find the entry of the key, or append a new one if it does not exist
+ *
+ * @param hash  hash value of the key, either tGroupHashCalc or any well mixed 64-bit value, as long as the same key
+ *              always gets the same value
+ * @param pNew  set to true if the entry is created by this call
+ * @return the entry index, or -1 if out of memory
+ */
+int32_t tGroupHashPut(SGroupHashObj *pHashObj, const void *key, int32_t keyLen, uint64_t hash, bool *pNew);
+
+/**
+ * tGroupHashPut for a batch of fixed width keys, pKeys holds num keys of keyLen bytes each. The entry index of key i is
+ * written into pIndex[i]. The entries created by this call are the ones no less than the size of the table before the
+ * call, and they are created in the order of their first occurrence in the batch.
+ * @return TSDB_CODE_SUCCESS or TSDB_CODE_OUT_OF_MEMORY
+ */
+int32_t tGroupHashBatchPut(SGroupHashObj *pHashObj, const char *pKeys, int32_t keyLen, const uint64_t *pHashes,
+                           int32_t num, int32_t *pIndex);
+
+/**
+ * find the entry of the key without adding it
+ * @return the entry index, or -1 if the key does not exist
+ */
+int32_t tGroupHashGet(const SGroupHashObj *pHashObj, const void *key, int32_t keyLen, uint64_t hash);
+
+void *tGroupHashGetData(const SGroupHashObj *pHashObj, int32_t index);
+
+void *tGroupHashGetKey(const SGroupHashObj *pHashObj, int32_t index, int32_t *keyLen);
+
+/**
+ * finalizer of splitmix64, which spreads the bits of integer keys over the whole hash value
+ */
+static FORCE_INLINE uint64_t tGroupHashMix64(uint64_t v) {
+  v ^= v >> 30;
+  v *= 0xbf58476d1ce4e5b9ULL;
+  v ^= v >> 27;
+  v *= 0x94d049bb133111ebULL;
+  v ^= v >> 31;
+  return v;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TGROUPHASH_H
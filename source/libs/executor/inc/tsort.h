@@ -21,6 +21,7 @@ extern "C" {
 #endif
 
 #include "tcommon.h"
+#include "tdatablock.h"
 #include "os.h"
 
 enum {
@@ -46,11 +47,18 @@ typedef struct SSortSource {
 
 } SSortSource;
 
+typedef struct SSortSourceKeys {
+  char         *pKeys;       // normalized sort keys of the rows in the current block of the source
+  int32_t       capacity;    // in rows
+} SSortSourceKeys;
+
 typedef struct SMsortComparParam {
   void        **pSources;
   int32_t       numOfSources;
   SArray       *orderInfo;   // SArray<SBlockOrderInfo>
   bool          cmpGroupId;
+  SBlockSortKey sortKey;     // keyLen is 0 if the sources are compared column by column
+  SArray       *pSourceKeys; // SArray<SSortSourceKeys>, one for each source
 } SMsortComparParam;
 
 typedef struct SSortHandle SSortHandle;
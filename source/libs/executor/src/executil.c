@@ -370,64 +370,60 @@ static int32_t createResultData(SDataType* pType, int32_t numOfRows, SScalarPara
   return TSDB_CODE_SUCCESS;
 }
 
-static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray* uidList, SNode* pTagCond) {
-  int32_t      code = TSDB_CODE_SUCCESS;
-  SArray*      pBlockList = NULL;
-  SSDataBlock* pResBlock = NULL;
-  SHashObj*    tags = NULL;
-  SScalarParam output = {0};
-
-  tagFilterAssist ctx = {0};
-
-  ctx.colHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
-  if (ctx.colHash == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    goto end;
-  }
-  ctx.index = 0;
-  ctx.cInfoList = taosArrayInit(4, sizeof(SColumnInfo));
-  if (ctx.cInfoList == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    goto end;
-  }
-
-  nodesRewriteExprPostOrder(&pTagCond, getColumn, (void*)&ctx);
+// Fill the tbname and tag columns of pResBlock for the tables in uidList, all child tables of suid are appended to
+// uidList if it is empty. Tag columns are copied from the columnar tag cache of meta when it is on, otherwise the tags
+// of each table are fetched and decoded.
+static int32_t fillTableTagBlock(void* metaHandle, uint64_t suid, SArray* uidList, SSDataBlock* pResBlock) {
+  int32_t   code = TSDB_CODE_SUCCESS;
+  SHashObj* tags = NULL;
+  bool      tagCached = false;
+  int32_t   rows = 0;
+
+  if (taosArrayGetSize(uidList) > 0 || metaGetTagCacheUidList(metaHandle, suid, uidList) == TSDB_CODE_SUCCESS) {
+    rows = taosArrayGetSize(uidList);
+    code = blockDataEnsureCapacity(pResBlock, rows);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto end;
+    }
 
-  pResBlock = createDataBlock();
-  if (pResBlock == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    goto end;
-  }
+    tagCached = true;
+    for (int32_t j = 0; j < taosArrayGetSize(pResBlock->pDataBlock); j++) {
+      SColumnInfoData* pColInfo = (SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, j);
+      if (pColInfo->info.colId != -1 &&
+          metaGetTagCacheCol(metaHandle, suid, uidList, pColInfo->info.colId, pColInfo) != TSDB_CODE_SUCCESS) {
+        tagCached = false;
+        break;
+      }
+    }
 
-  for (int32_t i = 0; i < taosArrayGetSize(ctx.cInfoList); ++i) {
-    SColumnInfoData colInfo = {{0}, 0};
-    colInfo.info = *(SColumnInfo*)taosArrayGet(ctx.cInfoList, i);
-    blockDataAppendColInfo(pResBlock, &colInfo);
+    if (!tagCached) {
+      for (int32_t j = 0; j < taosArrayGetSize(pResBlock->pDataBlock); j++) {
+        colInfoDataCleanup((SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, j), rows);
+      }
+    }
   }
 
-  //  int64_t stt = taosGetTimestampUs();
-  tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
-  code = metaGetTableTags(metaHandle, suid, uidList, tags);
-  if (code != TSDB_CODE_SUCCESS) {
-    qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), suid);
-    terrno = code;
-    goto end;
-  }
+  if (!tagCached) {
+    //  int64_t stt = taosGetTimestampUs();
+    tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+    code = metaGetTableTags(metaHandle, suid, uidList, tags);
+    if (code != TSDB_CODE_SUCCESS) {
+      qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), suid);
+      goto end;
+    }
 
-  int32_t rows = taosArrayGetSize(uidList);
-  if (rows == 0) {
-    goto end;
-  }
-  //  int64_t stt1 = taosGetTimestampUs();
-  //  qDebug("generate tag meta rows:%d, cost:%ld us", rows, stt1-stt);
+    //  int64_t stt1 = taosGetTimestampUs();
+    //  qDebug("generate tag meta rows:%d, cost:%ld us", rows, stt1-stt);
 
-  code = blockDataEnsureCapacity(pResBlock, rows);
-  if (code != TSDB_CODE_SUCCESS) {
-    terrno = code;
-    goto end;
+    if (rows == 0) {
+      rows = taosArrayGetSize(uidList);
+      code = blockDataEnsureCapacity(pResBlock, rows);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto end;
+      }
+    }
   }
 
-  //  int64_t st = taosGetTimestampUs();
   for (int32_t i = 0; i < rows; i++) {
     int64_t* uid = taosArrayGet(uidList, i);
     for (int32_t j = 0; j < taosArrayGetSize(pResBlock->pDataBlock); j++) {
@@ -440,7 +436,7 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray
 #if TAG_FILTER_DEBUG
         qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
 #endif
-      } else {
+      } else if (!tagCached) {
         void* tag = taosHashGet(tags, uid, sizeof(int64_t));
         ASSERT(tag);
         STagVal tagVal = {0};
@@ -475,6 +471,57 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray
   }
   pResBlock->info.rows = rows;
 
+end:
+  taosHashCleanup(tags);
+  return code;
+}
+
+static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray* uidList, SNode* pTagCond) {
+  int32_t      code = TSDB_CODE_SUCCESS;
+  SArray*      pBlockList = NULL;
+  SSDataBlock* pResBlock = NULL;
+  SScalarParam output = {0};
+
+  tagFilterAssist ctx = {0};
+
+  ctx.colHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
+  if (ctx.colHash == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+  ctx.index = 0;
+  ctx.cInfoList = taosArrayInit(4, sizeof(SColumnInfo));
+  if (ctx.cInfoList == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+
+  nodesRewriteExprPostOrder(&pTagCond, getColumn, (void*)&ctx);
+
+  pResBlock = createDataBlock();
+  if (pResBlock == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto end;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(ctx.cInfoList); ++i) {
+    SColumnInfoData colInfo = {{0}, 0};
+    colInfo.info = *(SColumnInfo*)taosArrayGet(ctx.cInfoList, i);
+    blockDataAppendColInfo(pResBlock, &colInfo);
+  }
+
+  //  int64_t st = taosGetTimestampUs();
+  code = fillTableTagBlock(metaHandle, suid, uidList, pResBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    goto end;
+  }
+
+  int32_t rows = taosArrayGetSize(uidList);
+  if (rows == 0) {
+    goto end;
+  }
+
   //  int64_t st1 = taosGetTimestampUs();
   //  qDebug("generate tag block rows:%d, cost:%ld us", rows, st1-st);
 
@@ -499,7 +546,6 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, uint64_t suid, SArray
   //  qDebug("calculate tag block rows:%d, cost:%ld us", rows, st2-st1);
 
 end:
-  taosHashCleanup(tags);
   taosHashCleanup(ctx.colHash);
   taosArrayDestroy(ctx.cInfoList);
   blockDataDestroy(pResBlock);
@@ -519,7 +565,6 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
   int32_t      code = TSDB_CODE_SUCCESS;
   SArray*      pBlockList = NULL;
   SSDataBlock* pResBlock = NULL;
-  SHashObj*    tags = NULL;
   SArray*      uidList = NULL;
   void*        keyBuf = NULL;
   SArray*      groupData = NULL;
@@ -566,69 +611,12 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
     taosArrayPush(uidList, &pkeyInfo->uid);
   }
 
-  //  int64_t stt = taosGetTimestampUs();
-  tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
-  code = metaGetTableTags(metaHandle, pTableListInfo->suid, uidList, tags);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto end;
-  }
-
-  //  int64_t stt1 = taosGetTimestampUs();
-  //  qDebug("generate tag meta rows:%d, cost:%ld us", rows, stt1-stt);
-
-  code = blockDataEnsureCapacity(pResBlock, rows);
+  //  int64_t st = taosGetTimestampUs();
+  code = fillTableTagBlock(metaHandle, pTableListInfo->suid, uidList, pResBlock);
   if (code != TSDB_CODE_SUCCESS) {
     goto end;
   }
 
-  //  int64_t st = taosGetTimestampUs();
-  for (int32_t i = 0; i < rows; i++) {
-    int64_t* uid = taosArrayGet(uidList, i);
-    for (int32_t j = 0; j < taosArrayGetSize(pResBlock->pDataBlock); j++) {
-      SColumnInfoData* pColInfo = (SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, j);
-
-      if (pColInfo->info.colId == -1) {  // tbname
-        char str[TSDB_TABLE_FNAME_LEN + VARSTR_HEADER_SIZE] = {0};
-        metaGetTableNameByUid(metaHandle, *uid, str);
-        colDataAppend(pColInfo, i, str, false);
-#if TAG_FILTER_DEBUG
-        qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
-#endif
-      } else {
-        void* tag = taosHashGet(tags, uid, sizeof(int64_t));
-        ASSERT(tag);
-        STagVal tagVal = {0};
-        tagVal.cid = pColInfo->info.colId;
-        const char* p = metaGetTableTagVal(tag, pColInfo->info.type, &tagVal);
-
-        if (p == NULL || (pColInfo->info.type == TSDB_DATA_TYPE_JSON && ((STag*)p)->nTag == 0)) {
-          colDataAppend(pColInfo, i, p, true);
-        } else if (pColInfo->info.type == TSDB_DATA_TYPE_JSON) {
-          colDataAppend(pColInfo, i, p, false);
-        } else if (IS_VAR_DATA_TYPE(pColInfo->info.type)) {
-          char* tmp = taosMemoryCalloc(tagVal.nData + VARSTR_HEADER_SIZE + 1, 1);
-          varDataSetLen(tmp, tagVal.nData);
-          memcpy(tmp + VARSTR_HEADER_SIZE, tagVal.pData, tagVal.nData);
-          colDataAppend(pColInfo, i, tmp, false);
-#if TAG_FILTER_DEBUG
-          qDebug("tagfilter varch:%s", tmp + 2);
-#endif
-          taosMemoryFree(tmp);
-        } else {
-          colDataAppend(pColInfo, i, (const char*)&tagVal.i64, false);
-#if TAG_FILTER_DEBUG
-          if (pColInfo->info.type == TSDB_DATA_TYPE_INT) {
-            qDebug("tagfilter int:%d", *(int*)(&tagVal.i64));
-          } else if (pColInfo->info.type == TSDB_DATA_TYPE_DOUBLE) {
-            qDebug("tagfilter double:%f", *(double*)(&tagVal.i64));
-          }
-#endif
-        }
-      }
-    }
-  }
-  pResBlock->info.rows = rows;
-
   //  int64_t st1 = taosGetTimestampUs();
   //  qDebug("generate tag block rows:%d, cost:%ld us", rows, st1-st);
 
@@ -732,7 +720,6 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
 
 end:
   taosMemoryFreeClear(keyBuf);
-  taosHashCleanup(tags);
   taosHashCleanup(ctx.colHash);
   taosArrayDestroy(ctx.cInfoList);
   blockDataDestroy(pResBlock);
@@ -932,6 +919,7 @@ SArray* extractPartitionColInfo(SNodeList* pNodeList) {
     SColumn c = {0};
     c.slotId = pColNode->slotId;
     c.colId = pColNode->colId;
+    c.colType = pColNode->colType;
     c.type = pColNode->node.resType.type;
     c.bytes = pColNode->node.resType.bytes;
     c.precision = pColNode->node.resType.precision;
@@ -1299,6 +1287,7 @@ SColumn extractColumnFromColumnNode(SColumnNode* pColNode) {
 
   c.slotId = pColNode->slotId;
   c.colId = pColNode->colId;
+  c.colType = pColNode->colType;
   c.type = pColNode->node.resType.type;
   c.bytes = pColNode->node.resType.bytes;
   c.scale = pColNode->node.resType.scale;
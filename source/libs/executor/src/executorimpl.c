@@ -1122,6 +1122,14 @@ void doFilter(const SNode* pFilterNode, SSDataBlock* pBlock, const SArray* pColM
     return;
   }
 
+  int8_t* rowRes = NULL;
+  bool    keep = doEvalFilter(pFilterNode, pBlock, &rowRes);
+  doApplyFilterResult(pBlock, rowRes, keep, pColMatchInfo);
+
+  taosMemoryFree(rowRes);
+}
+
+bool doEvalFilter(const SNode* pFilterNode, SSDataBlock* pBlock, int8_t** rowRes) {
   SFilterInfo* filter = NULL;
 
   // todo move to the initialization function
@@ -1131,12 +1139,14 @@ void doFilter(const SNode* pFilterNode, SSDataBlock* pBlock, const SArray* pColM
   SFilterColumnParam param1 = {.numOfCols = numOfCols, .pDataBlock = pBlock->pDataBlock};
   code = filterSetDataFromSlotId(filter, &param1);
 
-  int8_t* rowRes = NULL;
-
   // todo the keep seems never to be True??
-  bool keep = filterExecute(filter, pBlock, &rowRes, NULL, param1.numOfCols);
+  bool keep = filterExecute(filter, pBlock, rowRes, NULL, param1.numOfCols);
   filterFreeInfo(filter);
 
+  return keep;
+}
+
+void doApplyFilterResult(SSDataBlock* pBlock, const int8_t* rowRes, bool keep, const SArray* pColMatchInfo) {
   extractQualifiedTupleByFilterResult(pBlock, rowRes, keep);
 
   if (pColMatchInfo != NULL) {
@@ -1151,8 +1161,6 @@ void doFilter(const SNode* pFilterNode, SSDataBlock* pBlock, const SArray* pColM
       }
     }
   }
-
-  taosMemoryFree(rowRes);
 }
 
 void extractQualifiedTupleByFilterResult(SSDataBlock* pBlock, const int8_t* rowRes, bool keep) {
@@ -3731,6 +3739,8 @@ SOperatorInfo* createOperatorTree(SPhysiNode* pPhyNode, SExecTaskInfo* pTaskInfo
     pOptr = createStreamStateAggOperatorInfo(ops[0], pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN == type) {
     pOptr = createMergeJoinOperatorInfo(ops, size, (SSortMergeJoinPhysiNode*)pPhyNode, pTaskInfo);
+  } else if (QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN == type) {
+    pOptr = createHashJoinOperatorInfo(ops, size, (SHashJoinPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_FILL == type) {
     pOptr = createFillOperatorInfo(ops[0], (SFillPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_INDEF_ROWS_FUNC == type) {
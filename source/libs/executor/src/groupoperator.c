@@ -18,6 +18,7 @@
 #include "tname.h"
 
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "tmsg.h"
 
 #include "executorInt.h"
@@ -26,8 +27,10 @@
 #include "thash.h"
 #include "ttypes.h"
 
-static void*    getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, int32_t len);
+static void*    getDataGroupPage(const SPartitionOperatorInfo* pInfo, SDataGroupInfo* pGroupInfo);
+static void     cleanupGroupKeySup(SGroupKeySup* pSup);
 static int32_t* setupColumnOffset(const SSDataBlock* pBlock, int32_t rowCapacity);
+static void     cleanupGroupSpillSup(SGroupSpillSup* pSpill);
 static int32_t  setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols, char* pData,
                                         int16_t bytes, uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup);
 
@@ -46,7 +49,9 @@ static void destroyGroupOperatorInfo(void* param) {
   taosMemoryFreeClear(pInfo->keyBuf);
   taosArrayDestroy(pInfo->pGroupCols);
   taosArrayDestroyEx(pInfo->pGroupColVals, freeGroupKey);
+  cleanupGroupKeySup(&pInfo->keySup);
   cleanupExprSupp(&pInfo->scalarSup);
+  cleanupGroupSpillSup(&pInfo->spillSup);
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
@@ -231,82 +236,619 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
-static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
-  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
-  SGroupbyOperatorInfo* pInfo = pOperator->info;
+typedef int32_t (*__group_new_fn_t)(SOperatorInfo* pOperator, int32_t index, uint64_t groupId, char* pKey,
+                                     int32_t keyLen);
 
-  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
-  int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
-  //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
-  // qError("QInfo:0x%"PRIx64" group by not supported on double/float columns, abort", GET_TASKID(pRuntimeEnv));
-  //    return;
-  //  }
+static int32_t initGroupKeySup(SGroupKeySup* pSup, const SArray* pGroupCols, int32_t groupKeyLen, int32_t dataLen) {
+  int32_t  numOfGroupCols = taosArrayGetSize(pGroupCols);
+  SColumn* pCol = (numOfGroupCols == 1) ? taosArrayGet(pGroupCols, 0) : NULL;
 
-  int32_t     len = 0;
-  STimeWindow w = TSWINDOW_INITIALIZER;
+  pSup->keyType = GROUP_KEY_INT;
+  if (pCol != NULL && pCol->colType == COLUMN_TYPE_TAG && pCol->type != TSDB_DATA_TYPE_JSON) {
+    pSup->keyType = GROUP_KEY_TAG;
+  } else if (numOfGroupCols == 0 || numOfGroupCols > 2) {
+    pSup->keyType = GROUP_KEY_GENERIC;
+  } else {
+    for (int32_t i = 0; i < numOfGroupCols; ++i) {
+      pCol = taosArrayGet(pGroupCols, i);
+      if (!IS_INTEGER_TYPE(pCol->type) && pCol->type != TSDB_DATA_TYPE_BOOL &&
+          pCol->type != TSDB_DATA_TYPE_TIMESTAMP) {
+        pSup->keyType = GROUP_KEY_GENERIC;
+        break;
+      }
+    }
+  }
 
-  terrno = TSDB_CODE_SUCCESS;
-  int32_t num = 0;
-  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
-    // Compare with the previous row of this column, and do not set the output buffer again if they are identical.
-    if (!pInfo->isInit) {
-      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-      if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-        T_LONG_JMP(pTaskInfo->env, terrno);
+  // key of GROUP_KEY_INT: group id, the value of each group column and the null flags
+  int32_t maxKeyLen = sizeof(uint64_t) + groupKeyLen;
+  if (pSup->keyType == GROUP_KEY_INT) {
+    pSup->keyWidth = sizeof(uint64_t) * (numOfGroupCols + 2);
+    maxKeyLen = pSup->keyWidth;
+  }
+
+  pSup->pKeyBuf = taosMemoryCalloc(1, sizeof(uint64_t) + groupKeyLen);
+  pSup->pHashTable = tGroupHashInit(4096, maxKeyLen, dataLen);
+  if (pSup->pKeyBuf == NULL || pSup->pHashTable == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void cleanupGroupKeySup(SGroupKeySup* pSup) {
+  taosMemoryFreeClear(pSup->pKeyBuf);
+  taosMemoryFreeClear(pSup->pKeys);
+  taosMemoryFreeClear(pSup->pHashes);
+  taosMemoryFreeClear(pSup->pGroups);
+  tGroupHashCleanup(pSup->pHashTable);
+  pSup->pHashTable = NULL;
+}
+
+static int32_t ensureGroupKeySupCapacity(SGroupKeySup* pSup, int32_t numOfRows) {
+  if (numOfRows <= pSup->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t* pGroups = taosMemoryRealloc(pSup->pGroups, sizeof(int32_t) * numOfRows);
+  if (pGroups == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pSup->pGroups = pGroups;
+
+  uint64_t* pHashes = taosMemoryRealloc(pSup->pHashes, sizeof(uint64_t) * numOfRows);
+  if (pHashes == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pSup->pHashes = pHashes;
+
+  if (pSup->keyType == GROUP_KEY_INT) {
+    uint64_t* pKeys = taosMemoryRealloc(pSup->pKeys, (int64_t)pSup->keyWidth * numOfRows);
+    if (pKeys == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pSup->pKeys = pKeys;
+  }
+
+  pSup->capacity = numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool isSameColumnValue(SColumnInfoData* pCol, int32_t row1, int32_t row2) {
+  bool isNull1 = colDataIsNull_s(pCol, row1);
+  bool isNull2 = colDataIsNull_s(pCol, row2);
+  if (isNull1 || isNull2) {
+    return isNull1 == isNull2;
+  }
+
+  char* v1 = colDataGetData(pCol, row1);
+  char* v2 = colDataGetData(pCol, row2);
+  if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+    return v1 == v2 ||
+           (varDataLen(v1) == varDataLen(v2) && memcmp(varDataVal(v1), varDataVal(v2), varDataLen(v1)) == 0);
+  } else {
+    return memcmp(v1, v2, pCol->info.bytes) == 0;
+  }
+}
+
+// find the group of the rows [start, end), which share the group keys kept in pGroupColVals
+static int32_t putGroupRun(SOperatorInfo* pOperator, SGroupKeySup* pSup, const SArray* pGroupColVals, char* keyBuf,
+                           uint64_t groupId, int32_t start, int32_t end, __group_new_fn_t fp) {
+  int32_t len = buildGroupKeys(keyBuf, pGroupColVals);
+  *(uint64_t*)pSup->pKeyBuf = groupId;
+  memcpy(pSup->pKeyBuf + sizeof(uint64_t), keyBuf, len);
+
+  int32_t  keyLen = len + sizeof(uint64_t);
+  uint64_t hash = tGroupHashCalc(pSup->pKeyBuf, keyLen);
+  int32_t  index = -1;
+  if (pSup->noNewGroup) {
+    index = tGroupHashGet(pSup->pHashTable, pSup->pKeyBuf, keyLen, hash);
+  } else {
+    bool isNew = false;
+    index = tGroupHashPut(pSup->pHashTable, pSup->pKeyBuf, keyLen, hash, &isNew);
+    if (index < 0) {
+      return terrno;
+    }
+
+    if (isNew) {
+      int32_t code = fp(pOperator, index, groupId, keyBuf, len);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
       }
-      pInfo->isInit = true;
-      num++;
-      continue;
     }
+  }
+
+  for (int32_t i = start; i < end; ++i) {
+    pSup->pGroups[i] = index;
+    pSup->pHashes[i] = hash;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the rows of the same group are usually adjacent, so only the first row of each run of identical keys is probed
+static int32_t doResolveGroupsByRun(SOperatorInfo* pOperator, SGroupKeySup* pSup, SArray* pGroupCols,
+                                    SArray* pGroupColVals, char* keyBuf, SSDataBlock* pBlock, uint64_t groupId,
+                                    __group_new_fn_t fp) {
+  int32_t          numOfGroupCols = taosArrayGetSize(pGroupCols);
+  SColumnInfoData* pTagCol = NULL;
+  if (pSup->keyType == GROUP_KEY_TAG) {
+    SColumn* pCol = taosArrayGet(pGroupCols, 0);
+    pTagCol = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+  }
+
+  terrno = TSDB_CODE_SUCCESS;
+  recordNewGroupKeys(pGroupCols, pGroupColVals, pBlock, 0);
+  if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
+    return terrno;
+  }
 
-    bool equal = groupKeyCompare(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j, numOfGroupCols);
+  int32_t start = 0;
+  for (int32_t j = 1; j < pBlock->info.rows; ++j) {
+    bool equal = (pTagCol != NULL) ? isSameColumnValue(pTagCol, start, j)
+                                   : groupKeyCompare(pGroupCols, pGroupColVals, pBlock, j, numOfGroupCols);
     if (equal) {
-      num++;
       continue;
     }
 
-    // The first row of a new block does not belongs to the previous existed group
-    if (j == 0) {
-      num++;
-      recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-      if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-        T_LONG_JMP(pTaskInfo->env, terrno);
+    int32_t code = putGroupRun(pOperator, pSup, pGroupColVals, keyBuf, groupId, start, j, fp);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    recordNewGroupKeys(pGroupCols, pGroupColVals, pBlock, j);
+    if (terrno != TSDB_CODE_SUCCESS) {
+      return terrno;
+    }
+    start = j;
+  }
+
+  return putGroupRun(pOperator, pSup, pGroupColVals, keyBuf, groupId, start, pBlock->info.rows, fp);
+}
+
+static void buildIntGroupKeys(SGroupKeySup* pSup, SArray* pGroupCols, SSDataBlock* pBlock, uint64_t groupId) {
+  int32_t   numOfRows = pBlock->info.rows;
+  int32_t   numOfGroupCols = taosArrayGetSize(pGroupCols);
+  int32_t   width = pSup->keyWidth / sizeof(uint64_t);
+  uint64_t* pKeys = pSup->pKeys;
+
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    pKeys[j * width] = groupId;
+    pKeys[j * width + width - 1] = 0;
+  }
+
+  // fill the keys column by column, the raw bits of a value are enough to tell the groups apart
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    uint64_t*        pDst = pKeys + i + 1;
+    const char*      pData = pColInfoData->pData;
+
+    switch (pColInfoData->info.bytes) {
+      case sizeof(uint8_t):
+        for (int32_t j = 0; j < numOfRows; ++j) pDst[j * width] = ((const uint8_t*)pData)[j];
+        break;
+      case sizeof(uint16_t):
+        for (int32_t j = 0; j < numOfRows; ++j) pDst[j * width] = ((const uint16_t*)pData)[j];
+        break;
+      case sizeof(uint32_t):
+        for (int32_t j = 0; j < numOfRows; ++j) pDst[j * width] = ((const uint32_t*)pData)[j];
+        break;
+      default:
+        for (int32_t j = 0; j < numOfRows; ++j) pDst[j * width] = ((const uint64_t*)pData)[j];
+        break;
+    }
+
+    if (pColInfoData->hasNull) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        if (colDataIsNull_f(pColInfoData->nullbitmap, j)) {
+          pDst[j * width] = 0;
+          pKeys[j * width + width - 1] |= (1u << i);
+        }
       }
+    }
+  }
+
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    uint64_t* pKey = pKeys + j * width;
+    uint64_t  h = tGroupHashMix64(pKey[0]);
+    for (int32_t k = 1; k < width; ++k) {
+      h = tGroupHashMix64(h ^ pKey[k]);
+    }
+    pSup->pHashes[j] = h;
+  }
+}
+
+// integer keys of the whole block are hashed and probed together, no matter how the rows are ordered
+static int32_t doResolveIntGroups(SOperatorInfo* pOperator, SGroupKeySup* pSup, SArray* pGroupCols,
+                                  SArray* pGroupColVals, char* keyBuf, SSDataBlock* pBlock, uint64_t groupId,
+                                  __group_new_fn_t fp) {
+  buildIntGroupKeys(pSup, pGroupCols, pBlock, groupId);
+
+  if (pSup->noNewGroup) {
+    for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+      pSup->pGroups[j] = tGroupHashGet(pSup->pHashTable, (const char*)pSup->pKeys + (int64_t)j * pSup->keyWidth,
+                                       pSup->keyWidth, pSup->pHashes[j]);
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t prevSize = tGroupHashGetSize(pSup->pHashTable);
+  int32_t code = tGroupHashBatchPut(pSup->pHashTable, (const char*)pSup->pKeys, pSup->keyWidth, pSup->pHashes,
+                                    pBlock->info.rows, pSup->pGroups);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // the new groups are created in the order of their first rows
+  int32_t size = tGroupHashGetSize(pSup->pHashTable);
+  for (int32_t j = 0; j < pBlock->info.rows && prevSize < size; ++j) {
+    if (pSup->pGroups[j] != prevSize) {
       continue;
     }
 
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_APP_ERROR);
+    recordNewGroupKeys(pGroupCols, pGroupColVals, pBlock, j);
+    int32_t len = buildGroupKeys(keyBuf, pGroupColVals);
+    code = fp(pOperator, prevSize, groupId, keyBuf, len);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
     }
+    prevSize += 1;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/**
+ * Find the group of each row of the data block and keep it in pSup->pGroups. For each group showing up the first
+ * time, fp is called with the serialized group keys in keyBuf, right after the group is added into the hash table.
+ * If pSup->noNewGroup is set, the rows of the groups not in the hash table get -1 instead.
+ */
+static int32_t doResolveGroups(SOperatorInfo* pOperator, SGroupKeySup* pSup, SArray* pGroupCols,
+                               SArray* pGroupColVals, char* keyBuf, SSDataBlock* pBlock, uint64_t groupId,
+                               __group_new_fn_t fp) {
+  if (pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = ensureGroupKeySupCapacity(pSup, pBlock->info.rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pSup->keyType == GROUP_KEY_INT) {
+    return doResolveIntGroups(pOperator, pSup, pGroupCols, pGroupColVals, keyBuf, pBlock, groupId, fp);
+  } else {
+    return doResolveGroupsByRun(pOperator, pSup, pGroupCols, pGroupColVals, keyBuf, pBlock, groupId, fp);
+  }
+}
+
+static int32_t setNewGroupResultRow(SOperatorInfo* pOperator, int32_t index, uint64_t groupId, char* pKey,
+                                    int32_t keyLen) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+
+  int32_t code = setGroupResultOutputBuf(pOperator, &pInfo->binfo, pOperator->exprSupp.numOfExprs, pKey, keyLen,
+                                         groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  *(SResultRowPosition*)tGroupHashGetData(pInfo->keySup.pHashTable, index) = pInfo->binfo.resultRowInfo.cur;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the same as the hit path of doSetResultOutBufByKey, without looking up the result row hash table
+static void setGroupResultRowByPos(SOperatorInfo* pOperator, SResultRowPosition* pPos) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SResultRowInfo*       pResultRowInfo = &pInfo->binfo.resultRowInfo;
+  SDiskbasedBuf*        pBuf = pInfo->aggSup.pResultBuf;
+
+  if (pResultRowInfo->cur.pageId != -1 && pResultRowInfo->cur.pageId != pPos->pageId) {
+    SFilePage* pPage = getBufPage(pBuf, pResultRowInfo->cur.pageId);
+    releaseBufPage(pBuf, pPage);
+  }
 
-    int32_t rowIndex = j - num;
-    doApplyFunctions(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows, pOperator->exprSupp.numOfExprs);
+  SResultRow* pResultRow = getResultRowByPos(pBuf, pPos, true);
+  pResultRowInfo->cur = *pPos;
+  setResultRowInitCtx(pResultRow, pOperator->exprSupp.pCtx, pOperator->exprSupp.numOfExprs,
+                      pOperator->exprSupp.rowEntryInfoOffset);
+}
+
+static int32_t initGroupSpillSup(SGroupSpillSup* pSpill, const SSDataBlock* pBlock, const char* id) {
+  if (pSpill->pBuf != NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (!osTempSpaceAvailable()) {
+    qError("Init group spill buffer failed since %s, %s", terrstr(TSDB_CODE_NO_AVAIL_DISK), id);
+    return TSDB_CODE_NO_AVAIL_DISK;
+  }
+
+  uint32_t pageSize = 0;
+  uint32_t bufSize = 0;
+  getBufferPgSize(pBlock->info.rowSize, &pageSize, &bufSize);
+
+  // only the pages being filled need to stay in memory, the others are written out in the order they are filled
+  int32_t code = createDiskbasedBuf(&pSpill->pBuf, pageSize, pageSize * GROUP_SPILL_FANOUT * 2, id, tsTempDir);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  pSpill->pageSize = pageSize;
+  pSpill->rowsPerPage = blockDataGetCapacityInRow(pBlock, pageSize);
+  pSpill->pReadBlock = createOneDataBlock(pBlock, false);
+  if (pSpill->pReadBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < GROUP_SPILL_FANOUT; ++i) {
+    pSpill->pBlocks[i] = createOneDataBlock(pBlock, false);
+    if (pSpill->pBlocks[i] == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    code = blockDataEnsureCapacity(pSpill->pBlocks[i], pSpill->rowsPerPage);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void destroySpillPartition(void* param) { taosArrayDestroy(((SGroupSpillPartition*)param)->pPageList); }
+
+// the groups of the operator are given back to the memory of the query
+static void releaseGroupMemory(SGroupSpillSup* pSpill) {
+  if (pSpill->pQueryMemUsed != NULL) {
+    *pSpill->pQueryMemUsed -= pSpill->memUsed;
+  }
+  pSpill->memUsed = 0;
+}
+
+static void cleanupGroupSpillSup(SGroupSpillSup* pSpill) {
+  releaseGroupMemory(pSpill);
+  for (int32_t i = 0; i < GROUP_SPILL_FANOUT; ++i) {
+    pSpill->pBlocks[i] = blockDataDestroy(pSpill->pBlocks[i]);
+    destroySpillPartition(&pSpill->parts[i]);
+  }
+
+  taosArrayDestroyEx(pSpill->pPending, destroySpillPartition);
+  pSpill->pPending = NULL;
+  pSpill->pReadBlock = blockDataDestroy(pSpill->pReadBlock);
+  destroyDiskbasedBuf(pSpill->pBuf);
+  pSpill->pBuf = NULL;
+}
+
+// write the buffered rows of a partition into a page of the spill buffer
+static int32_t flushSpillBlock(SGroupSpillSup* pSpill, int32_t index) {
+  SSDataBlock*          pBlock = pSpill->pBlocks[index];
+  SGroupSpillPartition* pPart = &pSpill->parts[index];
+  if (pBlock == NULL || pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pPart->pPageList == NULL) {
+    pPart->pPageList = taosArrayInit(4, sizeof(SGroupSpillPage));
+    if (pPart->pPageList == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SGroupSpillPage page = {.pageId = -1, .groupId = pBlock->info.groupId};
+  void*           pPage = getNewBufPage(pSpill->pBuf, &page.pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  blockDataToBuf(pPage, pBlock);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pSpill->pBuf, pPage);
+
+  if (taosArrayPush(pPart->pPageList, &page) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pPart->numOfRows += pBlock->info.rows;
+  blockDataCleanup(pBlock);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void appendSpillRow(SSDataBlock* pDst, const SSDataBlock* pSrc, int32_t rowIndex) {
+  for (int32_t i = 0; i < taosArrayGetSize(pDst->pDataBlock); ++i) {
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    if (colDataIsNull_s(pSrcCol, rowIndex)) {
+      colDataAppendNULL(pDstCol, pDst->info.rows);
+    } else {
+      colDataAppend(pDstCol, pDst->info.rows, colDataGetData(pSrcCol, rowIndex), false);
+    }
+  }
+
+  pDst->info.rows += 1;
+}
+
+// the rows [start, end) belong to groups that are not kept in memory, put them into the partition of their hash value
+static int32_t spillGroupRows(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t start, int32_t end) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpillSup*       pSpill = &pInfo->spillSup;
+  uint64_t*             pHashes = pInfo->keySup.pHashes;
+
+  int32_t code = initGroupSpillSup(pSpill, pBlock, GET_TASKID(pOperator->pTaskInfo));
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int32_t shift = 64 - GROUP_SPILL_FANOUT_BITS * (TMIN(pSpill->level, GROUP_SPILL_MAX_LEVEL) + 1);
+  for (int32_t j = start; j < end; ++j) {
+    int32_t      index = (pHashes[j] >> shift) & (GROUP_SPILL_FANOUT - 1);
+    SSDataBlock* pDst = pSpill->pBlocks[index];
+
+    // a page only holds the rows of one data group
+    if (pDst->info.rows >= pSpill->rowsPerPage || (pDst->info.rows > 0 && pDst->info.groupId != pBlock->info.groupId)) {
+      code = flushSpillBlock(pSpill, index);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+
+    pDst->info.groupId = pBlock->info.groupId;
+    appendSpillRow(pDst, pBlock, j);
+  }
+
+  pSpill->numOfSpilledRows += (end - start);
+  return TSDB_CODE_SUCCESS;
+}
+
+// all rows of current pass are either aggregated or spilled, the non-empty partitions are to be aggregated later
+static int32_t finishGroupSpillPass(SGroupSpillSup* pSpill) {
+  if (pSpill->pBuf == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pSpill->pPending == NULL) {
+    pSpill->pPending = taosArrayInit(GROUP_SPILL_FANOUT, sizeof(SGroupSpillPartition));
+    if (pSpill->pPending == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  for (int32_t i = 0; i < GROUP_SPILL_FANOUT; ++i) {
+    int32_t code = flushSpillBlock(pSpill, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    SGroupSpillPartition* pPart = &pSpill->parts[i];
+    if (pPart->numOfRows > 0) {
+      pPart->level = pSpill->level + 1;
+      if (taosArrayPush(pSpill->pPending, pPart) == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      memset(pPart, 0, sizeof(SGroupSpillPartition));
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupKeySup*         pSup = &pInfo->keySup;
+  SGroupSpillSup*       pSpill = &pInfo->spillSup;
+
+  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
+
+  // once the groups of all the group by operators of the query use up the memory, the rows of the other groups are
+  // spilled. An operator without any group in memory always takes the groups of a block, so each pass makes progress
+  if (pSpill->memLimit > 0 && !pSup->noNewGroup && pSpill->memUsed > 0 && *pSpill->pQueryMemUsed >= pSpill->memLimit) {
+    pSup->noNewGroup = true;
+    qDebug("%s %d groups in memory, %" PRId64 " bytes used by the query, spill the rows of the other groups, level:%d",
+           GET_TASKID(pTaskInfo), tGroupHashGetSize(pSup->pHashTable), *pSpill->pQueryMemUsed, pSpill->level);
+  }
+
+  int32_t code = doResolveGroups(pOperator, pSup, pInfo->pGroupCols, pInfo->pGroupColVals, pInfo->keyBuf, pBlock,
+                                 pBlock->info.groupId, setNewGroupResultRow);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  // the new groups of the block are charged to the query
+  if (pSpill->memLimit > 0) {
+    int64_t memUsed = tGroupHashGetSize(pSup->pHashTable) * pSpill->groupSize;
+    *pSpill->pQueryMemUsed += memUsed - pSpill->memUsed;
+    pSpill->memUsed = memUsed;
+  }
+
+  int32_t rowIndex = 0;
+  for (int32_t j = 1; j <= pBlock->info.rows; ++j) {
+    if (j < pBlock->info.rows && pSup->pGroups[j] == pSup->pGroups[rowIndex]) {
+      continue;
+    }
+
+    if (pSup->pGroups[rowIndex] < 0) {
+      code = spillGroupRows(pOperator, pBlock, rowIndex, j);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+
+      rowIndex = j;
+      continue;
+    }
+
+    setGroupResultRowByPos(pOperator, tGroupHashGetData(pSup->pHashTable, pSup->pGroups[rowIndex]));
+    doApplyFunctions(pTaskInfo, pCtx, NULL, rowIndex, j - rowIndex, pBlock->info.rows,
+                     pOperator->exprSupp.numOfExprs);
 
     // assign the group keys or user input constant values if required
     doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
-    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-    num = 1;
+    rowIndex = j;
   }
+}
+
+static void resetGroupAggState(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
 
-  if (num > 0) {
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_APP_ERROR);
+  cleanupGroupResInfo(&pInfo->groupResInfo);
+  tSimpleHashClear(pInfo->aggSup.pResultRowHashTable);
+  clearDiskbasedBuf(pInfo->aggSup.pResultBuf);
+  pInfo->aggSup.currentPageId = -1;
+  initResultRowInfo(&pInfo->binfo.resultRowInfo);
+
+  tGroupHashClear(pInfo->keySup.pHashTable);
+  pInfo->keySup.noNewGroup = false;
+  releaseGroupMemory(&pInfo->spillSup);
+}
+
+// aggregate the rows of the last spilled partition, the rows of the groups beyond the memory are spilled again
+static int32_t aggregateSpilledPartition(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpillSup*       pSpill = &pInfo->spillSup;
+
+  // the partition stays in the pending list until all of its rows are consumed, so it is released if interrupted
+  SGroupSpillPartition part = *(SGroupSpillPartition*)taosArrayGetLast(pSpill->pPending);
+  resetGroupAggState(pOperator);
+  pSpill->level = part.level;
+
+  qDebug("%s aggregate spilled partition, level:%d, rows:%" PRId64 ", pages:%d, remain partitions:%d",
+         GET_TASKID(pOperator->pTaskInfo), part.level, part.numOfRows, (int32_t)taosArrayGetSize(part.pPageList),
+         (int32_t)taosArrayGetSize(pSpill->pPending) - 1);
+
+  SSDataBlock* pBlock = pSpill->pReadBlock;
+  for (int32_t i = 0; i < taosArrayGetSize(part.pPageList); ++i) {
+    SGroupSpillPage* pPageInfo = taosArrayGet(part.pPageList, i);
+
+    void* pPage = getBufPage(pSpill->pBuf, pPageInfo->pageId);
+    if (pPage == NULL) {
+      return terrno;
     }
 
-    int32_t rowIndex = pBlock->info.rows - num;
-    doApplyFunctions(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows, pOperator->exprSupp.numOfExprs);
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
+    int32_t code = blockDataFromBuf(pBlock, pPage);
+    dBufSetBufPageRecycled(pSpill->pBuf, pPage);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    pBlock->info.groupId = pPageInfo->groupId;
+    setInputDataBlock(pOperator, pOperator->exprSupp.pCtx, pBlock, TSDB_ORDER_ASC, MAIN_SCAN, true);
+    doHashGroupbyAgg(pOperator, pBlock);
+  }
+
+  taosArrayPop(pSpill->pPending);
+  taosArrayDestroy(part.pPageList);
+
+  int32_t code = finishGroupSpillPass(pSpill);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
   }
+
+  initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
+  return TSDB_CODE_SUCCESS;
 }
 
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpillSup*       pSpill = &pInfo->spillSup;
 
   SSDataBlock* pRes = pInfo->binfo.pRes;
   while (1) {
@@ -314,8 +856,18 @@ static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
     doFilter(pInfo->pCondition, pRes, NULL);
 
     if (!hasRemainResults(&pInfo->groupResInfo)) {
-      doSetOperatorCompleted(pOperator);
-      break;
+      if (taosArrayGetSize(pSpill->pPending) == 0) {
+        // the results are all copied out, the memory goes to the other group by operators of the query
+        releaseGroupMemory(pSpill);
+        doSetOperatorCompleted(pOperator);
+        break;
+      }
+
+      // the groups in memory are all returned, continue with the spilled rows
+      int32_t code = aggregateSpilledPartition(pOperator);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pOperator->pTaskInfo->env, code);
+      }
     }
 
     if (pRes->info.rows > 0) {
@@ -373,6 +925,16 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
     doHashGroupbyAgg(pOperator, pBlock);
   }
 
+  int32_t code = finishGroupSpillPass(&pInfo->spillSup);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  if (pInfo->spillSup.numOfSpilledRows > 0) {
+    qDebug("%s %" PRId64 " rows of the groups beyond the memory are spilled into %d partitions", GET_TASKID(pTaskInfo),
+           pInfo->spillSup.numOfSpilledRows, (int32_t)taosArrayGetSize(pInfo->spillSup.pPending));
+  }
+
   pOperator->status = OP_RES_TO_RETURN;
 
 #if 0
@@ -418,6 +980,11 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SExprInfo* pEx
     goto _error;
   }
 
+  code = initGroupKeySup(&pInfo->keySup, pGroupColList, pInfo->groupKeyLen, sizeof(SResultRowPosition));
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
   initResultSizeInfo(&pOperator->resultInfo, 4096);
   code = initAggInfo(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, numOfCols, pInfo->groupKeyLen, pTaskInfo->id.str);
   if (code != TSDB_CODE_SUCCESS) {
@@ -427,6 +994,18 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SExprInfo* pEx
   initBasicInfo(&pInfo->binfo, pResultBlock);
   initResultRowInfo(&pInfo->binfo.resultRowInfo);
 
+  if (tsQueryGroupBufferSize > 0) {
+    // the result row, and the entries of both the group hash table and the result row hash table of a group
+    int64_t memLimit = tsQueryGroupBufferSize * 1048576LL;
+    pInfo->spillSup.memLimit = memLimit;
+    pInfo->spillSup.groupSize = pInfo->aggSup.resultRowSize +
+                                2 * (sizeof(uint64_t) * 4 + pInfo->groupKeyLen + sizeof(SResultRowPosition));
+    pInfo->spillSup.pQueryMemUsed = &pTaskInfo->groupBufSize;
+
+    // the result rows of the groups in memory are never paged out
+    dBufSetInMemBufSize(pInfo->aggSup.pResultBuf, memLimit);
+  }
+
   pOperator->name = "GroupbyAggOperator";
   pOperator->blocking = true;
   pOperator->status = OP_NOT_OPENED;
@@ -450,128 +1029,138 @@ _error:
   return NULL;
 }
 
-static void doHashPartition(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
-  //  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
-
+static int32_t setNewDataGroup(SOperatorInfo* pOperator, int32_t index, uint64_t groupId, char* pKey, int32_t keyLen) {
   SPartitionOperatorInfo* pInfo = pOperator->info;
+  SDataGroupInfo*         pGroupInfo = tGroupHashGetData(pInfo->keySup.pHashTable, index);
 
-  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
-    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
-    int32_t len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+  pGroupInfo->groupId = calcGroupId(pKey, keyLen);
+  pGroupInfo->pPageList = taosArrayInit(100, sizeof(int32_t));
+  if (pGroupInfo->pPageList == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-    SDataGroupInfo* pGroupInfo = NULL;
-    void*           pPage = getCurrentDataGroupInfo(pInfo, &pGroupInfo, len);
+  return TSDB_CODE_SUCCESS;
+}
 
-    pGroupInfo->numOfRows += 1;
+static void doCopyPartitionRow(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t j, void* pPage) {
+  SPartitionOperatorInfo* pInfo = pOperator->info;
 
-    // group id
-    if (pGroupInfo->groupId == 0) {
-      pGroupInfo->groupId = calcGroupId(pInfo->keyBuf, len);
-    }
+  // number of rows
+  int32_t* rows = (int32_t*)pPage;
 
-    // number of rows
-    int32_t* rows = (int32_t*)pPage;
+  size_t numOfCols = pOperator->exprSupp.numOfExprs;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SExprInfo* pExpr = &pOperator->exprSupp.pExprInfo[i];
+    int32_t    slotId = pExpr->base.pParam[0].pCol->slotId;
 
-    size_t numOfCols = pOperator->exprSupp.numOfExprs;
-    for (int32_t i = 0; i < numOfCols; ++i) {
-      SExprInfo* pExpr = &pOperator->exprSupp.pExprInfo[i];
-      int32_t    slotId = pExpr->base.pParam[0].pCol->slotId;
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, slotId);
 
-      SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, slotId);
+    int32_t bytes = pColInfoData->info.bytes;
+    int32_t startOffset = pInfo->columnOffset[i];
 
-      int32_t bytes = pColInfoData->info.bytes;
-      int32_t startOffset = pInfo->columnOffset[i];
+    int32_t* columnLen = NULL;
+    int32_t  contentLen = 0;
 
-      int32_t* columnLen = NULL;
-      int32_t  contentLen = 0;
+    if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
+      int32_t* offset = (int32_t*)((char*)pPage + startOffset);
+      columnLen = (int32_t*)((char*)pPage + startOffset + sizeof(int32_t) * pInfo->rowCapacity);
+      char* data = (char*)((char*)columnLen + sizeof(int32_t));
+
+      if (colDataIsNull_s(pColInfoData, j)) {
+        offset[(*rows)] = -1;
+        contentLen = 0;
+      } else if (pColInfoData->info.type == TSDB_DATA_TYPE_JSON) {
+        offset[*rows] = (*columnLen);
+        char*   src = colDataGetData(pColInfoData, j);
+        int32_t dataLen = getJsonValueLen(src);
+
+        memcpy(data + (*columnLen), src, dataLen);
+        int32_t v = (data + (*columnLen) + dataLen - (char*)pPage);
+        ASSERT(v > 0);
+
+        contentLen = dataLen;
+      } else {
+        offset[*rows] = (*columnLen);
+        char* src = colDataGetData(pColInfoData, j);
+        memcpy(data + (*columnLen), src, varDataTLen(src));
+        int32_t v = (data + (*columnLen) + varDataTLen(src) - (char*)pPage);
+        ASSERT(v > 0);
 
-      if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
-        int32_t* offset = (int32_t*)((char*)pPage + startOffset);
-        columnLen = (int32_t*)((char*)pPage + startOffset + sizeof(int32_t) * pInfo->rowCapacity);
-        char* data = (char*)((char*)columnLen + sizeof(int32_t));
+        contentLen = varDataTLen(src);
+      }
+    } else {
+      char* bitmap = (char*)pPage + startOffset;
+      columnLen = (int32_t*)((char*)pPage + startOffset + BitmapLen(pInfo->rowCapacity));
+      char* data = (char*)columnLen + sizeof(int32_t);
 
-        if (colDataIsNull_s(pColInfoData, j)) {
-          offset[(*rows)] = -1;
-          contentLen = 0;
-        } else if (pColInfoData->info.type == TSDB_DATA_TYPE_JSON) {
-          offset[*rows] = (*columnLen);
-          char*   src = colDataGetData(pColInfoData, j);
-          int32_t dataLen = getJsonValueLen(src);
+      bool isNull = colDataIsNull_f(pColInfoData->nullbitmap, j);
+      if (isNull) {
+        colDataSetNull_f(bitmap, (*rows));
+      } else {
+        memcpy(data + (*columnLen), colDataGetData(pColInfoData, j), bytes);
+        ASSERT((data + (*columnLen) + bytes - (char*)pPage) <= getBufPageSize(pInfo->pBuf));
+      }
+      contentLen = bytes;
+    }
 
-          memcpy(data + (*columnLen), src, dataLen);
-          int32_t v = (data + (*columnLen) + dataLen - (char*)pPage);
-          ASSERT(v > 0);
+    (*columnLen) += contentLen;
+    ASSERT(*columnLen >= 0);
+  }
 
-          contentLen = dataLen;
-        } else {
-          offset[*rows] = (*columnLen);
-          char* src = colDataGetData(pColInfoData, j);
-          memcpy(data + (*columnLen), src, varDataTLen(src));
-          int32_t v = (data + (*columnLen) + varDataTLen(src) - (char*)pPage);
-          ASSERT(v > 0);
+  (*rows) += 1;
+}
 
-          contentLen = varDataTLen(src);
-        }
-      } else {
-        char* bitmap = (char*)pPage + startOffset;
-        columnLen = (int32_t*)((char*)pPage + startOffset + BitmapLen(pInfo->rowCapacity));
-        char* data = (char*)columnLen + sizeof(int32_t);
+static void doHashPartition(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*          pTaskInfo = pOperator->pTaskInfo;
+  SPartitionOperatorInfo* pInfo = pOperator->info;
+  SGroupKeySup*           pSup = &pInfo->keySup;
 
-        bool isNull = colDataIsNull_f(pColInfoData->nullbitmap, j);
-        if (isNull) {
-          colDataSetNull_f(bitmap, (*rows));
-        } else {
-          memcpy(data + (*columnLen), colDataGetData(pColInfoData, j), bytes);
-          ASSERT((data + (*columnLen) + bytes - (char*)pPage) <= getBufPageSize(pInfo->pBuf));
-        }
-        contentLen = bytes;
-      }
+  // the partition keys do not include the group id of the input data blocks
+  int32_t code = doResolveGroups(pOperator, pSup, pInfo->pGroupCols, pInfo->pGroupColVals, pInfo->keyBuf, pBlock, 0,
+                                 setNewDataGroup);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
 
-      (*columnLen) += contentLen;
-      ASSERT(*columnLen >= 0);
-    }
+  // all groups of this block have been added, so the SDataGroupInfo will not be moved anymore
+  int32_t j = 0;
+  while (j < pBlock->info.rows) {
+    SDataGroupInfo* pGroupInfo = tGroupHashGetData(pSup->pHashTable, pSup->pGroups[j]);
+    void*           pPage = getDataGroupPage(pInfo, pGroupInfo);
+    int32_t*        rows = (int32_t*)pPage;
 
-    (*rows) += 1;
+    do {
+      doCopyPartitionRow(pOperator, pBlock, j, pPage);
+      pGroupInfo->numOfRows += 1;
+      j += 1;
+    } while (j < pBlock->info.rows && pSup->pGroups[j] == pSup->pGroups[j - 1] && (*rows) < pInfo->rowCapacity);
 
     setBufPageDirty(pPage, true);
     releaseBufPage(pInfo->pBuf, pPage);
   }
 }
 
-void* getCurrentDataGroupInfo(const SPartitionOperatorInfo* pInfo, SDataGroupInfo** pGroupInfo, int32_t len) {
-  SDataGroupInfo* p = taosHashGet(pInfo->pGroupSet, pInfo->keyBuf, len);
-
+// the last page of the group, or a new one if it is full
+static void* getDataGroupPage(const SPartitionOperatorInfo* pInfo, SDataGroupInfo* pGroupInfo) {
   void* pPage = NULL;
-  if (p == NULL) {  // it is a new group
-    SDataGroupInfo gi = {0};
-    gi.pPageList = taosArrayInit(100, sizeof(int32_t));
-    taosHashPut(pInfo->pGroupSet, pInfo->keyBuf, len, &gi, sizeof(SDataGroupInfo));
-
-    p = taosHashGet(pInfo->pGroupSet, pInfo->keyBuf, len);
-
-    int32_t pageId = 0;
-    pPage = getNewBufPage(pInfo->pBuf, &pageId);
-    taosArrayPush(p->pPageList, &pageId);
-
-    *(int32_t*)pPage = 0;
-  } else {
-    int32_t* curId = taosArrayGetLast(p->pPageList);
+  if (taosArrayGetSize(pGroupInfo->pPageList) > 0) {
+    int32_t* curId = taosArrayGetLast(pGroupInfo->pPageList);
     pPage = getBufPage(pInfo->pBuf, *curId);
 
     int32_t* rows = (int32_t*)pPage;
-    if (*rows >= pInfo->rowCapacity) {
-      // release buffer
-      releaseBufPage(pInfo->pBuf, pPage);
-
-      // add a new page for current group
-      int32_t pageId = 0;
-      pPage = getNewBufPage(pInfo->pBuf, &pageId);
-      taosArrayPush(p->pPageList, &pageId);
-      memset(pPage, 0, getBufPageSize(pInfo->pBuf));
+    if (*rows < pInfo->rowCapacity) {
+      return pPage;
     }
+
+    // release buffer
+    releaseBufPage(pInfo->pBuf, pPage);
   }
 
-  *pGroupInfo = p;
+  // add a new page for current group
+  int32_t pageId = 0;
+  pPage = getNewBufPage(pInfo->pBuf, &pageId);
+  taosArrayPush(pGroupInfo->pPageList, &pageId);
+  memset(pPage, 0, getBufPageSize(pInfo->pBuf));
   return pPage;
 }
 
@@ -613,9 +1202,10 @@ int32_t* setupColumnOffset(const SSDataBlock* pBlock, int32_t rowCapacity) {
 }
 
 static void clearPartitionOperator(SPartitionOperatorInfo* pInfo) {
-  void* ite = NULL;
-  while ((ite = taosHashIterate(pInfo->pGroupSet, ite)) != NULL) {
-    taosArrayDestroy(((SDataGroupInfo*)ite)->pPageList);
+  int32_t size = taosArrayGetSize(pInfo->sortedGroupArray);
+  for (int32_t i = 0; i < size; ++i) {
+    SDataGroupInfo* pGroupInfo = taosArrayGet(pInfo->sortedGroupArray, i);
+    taosArrayDestroy(pGroupInfo->pPageList);
   }
   taosArrayClear(pInfo->sortedGroupArray);
   clearDiskbasedBuf(pInfo->pBuf);
@@ -700,26 +1290,21 @@ static SSDataBlock* hashPartition(SOperatorInfo* pOperator) {
       }
     }
 
-    terrno = TSDB_CODE_SUCCESS;
     doHashPartition(pOperator, pBlock);
-    if (terrno != TSDB_CODE_SUCCESS) {  // group by json error
-      T_LONG_JMP(pTaskInfo->env, terrno);
-    }
   }
 
-  SArray* groupArray = taosArrayInit(taosHashGetSize(pInfo->pGroupSet), sizeof(SDataGroupInfo));
+  SGroupHashObj* pHashTable = pInfo->keySup.pHashTable;
+  int32_t        numOfGroups = tGroupHashGetSize(pHashTable);
+  SArray*        groupArray = taosArrayInit(numOfGroups, sizeof(SDataGroupInfo));
 
-  void* pGroupIter = taosHashIterate(pInfo->pGroupSet, NULL);
-  while (pGroupIter != NULL) {
-    SDataGroupInfo* pGroupInfo = pGroupIter;
-    taosArrayPush(groupArray, pGroupInfo);
-    pGroupIter = taosHashIterate(pInfo->pGroupSet, pGroupIter);
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    taosArrayPush(groupArray, tGroupHashGetData(pHashTable, i));
   }
 
   taosArraySort(groupArray, compareDataGroupInfo);
   pInfo->sortedGroupArray = groupArray;
   pInfo->groupIndex = -1;
-  taosHashClear(pInfo->pGroupSet);
+  tGroupHashClear(pHashTable);
 
   pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
 
@@ -740,8 +1325,19 @@ static void destroyPartitionOperatorInfo(void* param) {
 
   taosArrayDestroy(pInfo->pGroupColVals);
   taosMemoryFree(pInfo->keyBuf);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->sortedGroupArray); ++i) {
+    SDataGroupInfo* pGroupInfo = taosArrayGet(pInfo->sortedGroupArray, i);
+    taosArrayDestroy(pGroupInfo->pPageList);
+  }
   taosArrayDestroy(pInfo->sortedGroupArray);
-  taosHashCleanup(pInfo->pGroupSet);
+
+  // the groups that have not been moved into sortedGroupArray yet
+  for (int32_t i = 0; i < tGroupHashGetSize(pInfo->keySup.pHashTable); ++i) {
+    SDataGroupInfo* pGroupInfo = tGroupHashGetData(pInfo->keySup.pHashTable, i);
+    taosArrayDestroy(pGroupInfo->pPageList);
+  }
+  cleanupGroupKeySup(&pInfo->keySup);
   taosMemoryFree(pInfo->columnOffset);
 
   cleanupExprSupp(&pInfo->scalarSup);
@@ -773,12 +1369,6 @@ SOperatorInfo* createPartitionOperatorInfo(SOperatorInfo* downstream, SPartition
     }
   }
 
-  _hash_fn_t hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
-  pInfo->pGroupSet = taosHashInit(100, hashFn, false, HASH_NO_LOCK);
-  if (pInfo->pGroupSet == NULL) {
-    goto _error;
-  }
-
   uint32_t defaultPgsz = 0;
   uint32_t defaultBufsz = 0;
   getBufferPgSize(pResBlock->info.rowSize, &defaultPgsz, &defaultBufsz);
@@ -801,6 +1391,11 @@ SOperatorInfo* createPartitionOperatorInfo(SOperatorInfo* downstream, SPartition
     goto _error;
   }
 
+  code = initGroupKeySup(&pInfo->keySup, pInfo->pGroupCols, pInfo->groupKeyLen, sizeof(SDataGroupInfo));
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
   pOperator->name = "PartitionOperator";
   pOperator->blocking = true;
   pOperator->status = OP_NOT_OPENED;
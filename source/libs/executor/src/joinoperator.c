@@ -394,3 +394,601 @@ SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator) {
   }
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
+
+// build side data held in memory before both inputs are partitioned to disk
+#define HJOIN_MAX_BUILD_MEM_SIZE (64 * 1048576L)
+
+typedef struct SHJoinRowRef {
+  int32_t blockIdx;
+  int32_t rowIdx;
+  int32_t next;  // index of the next row with the same key, -1 for the end of the chain
+} SHJoinRowRef;
+
+typedef struct SHJoinMatch {
+  int32_t probeRow;
+  int32_t refIdx;
+} SHJoinMatch;
+
+static int32_t      doOpenHashJoinOperator(SOperatorInfo* pOperator);
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+static int32_t initHashJoinKeys(SHashJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream,
+                                SHashJoinPhysiNode* pJoinNode) {
+  pInfo->side[0].pKeyCols = taosArrayInit(LIST_LENGTH(pJoinNode->pLeftKeys), sizeof(SColumnInfo));
+  pInfo->side[1].pKeyCols = taosArrayInit(LIST_LENGTH(pJoinNode->pRightKeys), sizeof(SColumnInfo));
+  if (NULL == pInfo->side[0].pKeyCols || NULL == pInfo->side[1].pKeyCols) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < LIST_LENGTH(pJoinNode->pLeftKeys); ++i) {
+    SColumnNode* pCol1 = (SColumnNode*)nodesListGetNode(pJoinNode->pLeftKeys, i);
+    SColumnNode* pCol2 = (SColumnNode*)nodesListGetNode(pJoinNode->pRightKeys, i);
+    if (pCol1->dataBlockId != pDownstream[0]->resultDataBlockId) {
+      TSWAP(pCol1, pCol2);
+    }
+    ASSERT(pCol1->dataBlockId == pDownstream[0]->resultDataBlockId);
+    ASSERT(pCol2->dataBlockId == pDownstream[1]->resultDataBlockId);
+
+    SColumnInfo col1 = {0};
+    SColumnInfo col2 = {0};
+    setJoinColumnInfo(&col1, pCol1);
+    setJoinColumnInfo(&col2, pCol2);
+    taosArrayPush(pInfo->side[0].pKeyCols, &col1);
+    taosArrayPush(pInfo->side[1].pKeyCols, &col2);
+    // var data keys of both sides are compared with their length, reserve the longer one
+    pInfo->keyLen += TMAX(col1.bytes, col2.bytes);
+  }
+
+  pInfo->keyBuf = taosMemoryCalloc(1, pInfo->keyLen);
+  return (NULL == pInfo->keyBuf) ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHashJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHashJoinOperatorInfo));
+  SOperatorInfo*         pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  if (pOperator == NULL || pInfo == NULL) {
+    goto _error;
+  }
+
+  int32_t    numOfCols = 0;
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+
+  pInfo->pRes = createResDataBlock(pJoinNode->node.pOutputDataBlockDesc);
+  pInfo->joinType = pJoinNode->joinType;
+  pInfo->maxBufSize = HJOIN_MAX_BUILD_MEM_SIZE;
+  pOperator->name = "HashJoinOperator";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN;
+  pOperator->blocking = false;
+  pOperator->status = OP_NOT_OPENED;
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+  pOperator->info = pInfo;
+  pOperator->pTaskInfo = pTaskInfo;
+
+  int32_t code = initHashJoinKeys(pInfo, pDownstream, pJoinNode);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  for (int32_t i = 0; i < 2; ++i) {
+    pInfo->side[i].pBlocks = taosArrayInit(4, POINTER_BYTES);
+  }
+  pInfo->pHashTable = taosHashInit(4096, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  pInfo->pRowRefs = taosArrayInit(4096, sizeof(SHJoinRowRef));
+  pInfo->pBuildBlocks = taosArrayInit(4, POINTER_BYTES);
+  pInfo->pMatches = taosArrayInit(4096, sizeof(SHJoinMatch));
+  if (NULL == pInfo->side[0].pBlocks || NULL == pInfo->side[1].pBlocks || NULL == pInfo->pHashTable ||
+      NULL == pInfo->pRowRefs || NULL == pInfo->pBuildBlocks || NULL == pInfo->pMatches) {
+    goto _error;
+  }
+
+  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pInfo->pCondAfterJoin);
+    pLogicCond->pParameterList = nodesMakeList();
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+  } else if (pJoinNode->pOnConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->pOnConditions);
+  } else if (pJoinNode->node.pConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->node.pConditions);
+  }
+
+  pOperator->fpSet =
+      createOperatorFpSet(doOpenHashJoinOperator, doHashJoin, NULL, NULL, destroyHashJoinOperator, NULL, NULL, NULL);
+  code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = TSDB_CODE_OUT_OF_MEMORY;
+  return NULL;
+}
+
+static void destroyBlockList(SArray* pBlocks) {
+  for (int32_t i = 0; i < taosArrayGetSize(pBlocks); ++i) {
+    blockDataDestroy(taosArrayGetP(pBlocks, i));
+  }
+  taosArrayClear(pBlocks);
+}
+
+void destroyHashJoinOperator(void* param) {
+  SHashJoinOperatorInfo* pInfo = (SHashJoinOperatorInfo*)param;
+  for (int32_t i = 0; i < 2; ++i) {
+    SHJoinSide* pSide = &pInfo->side[i];
+    taosArrayDestroy(pSide->pKeyCols);
+    destroyBlockList(pSide->pBlocks);
+    taosArrayDestroy(pSide->pBlocks);
+    for (int32_t j = 0; j < HJOIN_NUM_OF_PARTS; ++j) {
+      taosArrayDestroy(pSide->pPageIds[j]);
+      blockDataDestroy(pSide->pPartBlock[j]);
+    }
+    blockDataDestroy(pSide->pTemplate);
+    blockDataDestroy(pSide->pLoadBlock);
+  }
+
+  // the build blocks are owned by the side they come from unless the input was partitioned
+  if (pInfo->spilled) {
+    destroyBlockList(pInfo->pBuildBlocks);
+  }
+  taosArrayDestroy(pInfo->pBuildBlocks);
+  taosHashCleanup(pInfo->pHashTable);
+  taosArrayDestroy(pInfo->pRowRefs);
+  taosArrayDestroy(pInfo->pMatches);
+  taosMemoryFree(pInfo->keyBuf);
+  destroyDiskbasedBuf(pInfo->pBuf);
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+  blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+// Returns false if any key column is NULL, which never equals to anything.
+static bool hashJoinGetKey(SHashJoinOperatorInfo* pInfo, SHJoinSide* pSide, SSDataBlock* pBlock, int32_t row,
+                           int32_t* pLen) {
+  char*   p = pInfo->keyBuf;
+  int32_t numOfKeys = taosArrayGetSize(pSide->pKeyCols);
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    SColumnInfo*     pKey = taosArrayGet(pSide->pKeyCols, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pKey->slotId);
+    if (colDataIsNull_s(pCol, row)) {
+      return false;
+    }
+    char* pData = colDataGetData(pCol, row);
+    if (IS_VAR_DATA_TYPE(pKey->type)) {
+      memcpy(p, pData, varDataTLen(pData));
+      p += varDataTLen(pData);
+    } else {
+      memcpy(p, pData, pKey->bytes);
+      p += pKey->bytes;
+    }
+  }
+  *pLen = (int32_t)(p - pInfo->keyBuf);
+  return true;
+}
+
+static void hashJoinBuildTable(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SHJoinSide*            pSide = &pInfo->side[pInfo->buildIdx];
+
+  int32_t numOfBlocks = taosArrayGetSize(pInfo->pBuildBlocks);
+  for (int32_t i = 0; i < numOfBlocks; ++i) {
+    SSDataBlock* pBlock = taosArrayGetP(pInfo->pBuildBlocks, i);
+    for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+      int32_t len = 0;
+      if (!hashJoinGetKey(pInfo, pSide, pBlock, j, &len)) {
+        continue;
+      }
+
+      SHJoinRowRef ref = {.blockIdx = i, .rowIdx = j, .next = -1};
+      int32_t      idx = taosArrayGetSize(pInfo->pRowRefs);
+      int32_t*     pHead = taosHashGet(pInfo->pHashTable, pInfo->keyBuf, len);
+      if (pHead != NULL) {
+        ref.next = *pHead;
+        *pHead = idx;
+      } else if (taosHashPut(pInfo->pHashTable, pInfo->keyBuf, len, &idx, sizeof(idx)) != 0) {
+        T_LONG_JMP(pOperator->pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+      if (taosArrayPush(pInfo->pRowRefs, &ref) == NULL) {
+        T_LONG_JMP(pOperator->pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+    }
+  }
+}
+
+static void hashJoinClearTable(SHashJoinOperatorInfo* pInfo) {
+  taosHashClear(pInfo->pHashTable);
+  taosArrayClear(pInfo->pRowRefs);
+  if (pInfo->spilled) {
+    destroyBlockList(pInfo->pBuildBlocks);
+  } else {
+    taosArrayClear(pInfo->pBuildBlocks);
+  }
+}
+
+static int32_t hashJoinFlushPart(SHashJoinOperatorInfo* pInfo, SHJoinSide* pSide, int32_t part) {
+  SSDataBlock* pBlock = pSide->pPartBlock[part];
+  if (pBlock == NULL || pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t pageId = -1;
+  void*   pPage = getNewBufPage(pInfo->pBuf, &pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+  if (pSide->pPageIds[part] == NULL) {
+    pSide->pPageIds[part] = taosArrayInit(4, sizeof(int32_t));
+  }
+  taosArrayPush(pSide->pPageIds[part], &pageId);
+
+  blockDataToBuf(pPage, pBlock);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pInfo->pBuf, pPage);
+  blockDataCleanup(pBlock);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hashJoinPartitionBlock(SHashJoinOperatorInfo* pInfo, SHJoinSide* pSide, SSDataBlock* pBlock) {
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int32_t len = 0;
+    if (!hashJoinGetKey(pInfo, pSide, pBlock, i, &len)) {
+      continue;
+    }
+
+    // the hash table takes the low bits of the same hash value, so partition by the high bits
+    uint32_t     hashVal = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY)(pInfo->keyBuf, len);
+    int32_t      part = hashVal >> (32 - HJOIN_PART_BITS);
+    SSDataBlock* pDst = pSide->pPartBlock[part];
+    if (pDst == NULL) {
+      pDst = createOneDataBlock(pSide->pTemplate, false);
+      if (pDst == NULL || blockDataEnsureCapacity(pDst, pSide->rowsPerPage) != TSDB_CODE_SUCCESS) {
+        blockDataDestroy(pDst);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      pSide->pPartBlock[part] = pDst;
+    }
+
+    for (int32_t j = 0; j < numOfCols; ++j) {
+      SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, j);
+      SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, j);
+      if (colDataIsNull_s(pSrc, i)) {
+        colDataAppendNULL(pDstCol, pDst->info.rows);
+      } else {
+        colDataAppend(pDstCol, pDst->info.rows, colDataGetData(pSrc, i), false);
+      }
+    }
+    pDst->info.rows += 1;
+    pSide->partRows[part] += 1;
+
+    if (pDst->info.rows >= pSide->rowsPerPage) {
+      int32_t code = hashJoinFlushPart(pInfo, pSide, part);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int64_t hashJoinTotalRows(SHJoinSide* pSide) {
+  int64_t rows = 0;
+  for (int32_t i = 0; i < HJOIN_NUM_OF_PARTS; ++i) {
+    rows += pSide->partRows[i];
+  }
+  return rows;
+}
+
+// The build side does not fit in memory: write both inputs to disk in partitions of the join key and join them
+// partition by partition.
+static void hashJoinSpill(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  int32_t rowSize = 0;
+  for (int32_t i = 0; i < 2; ++i) {
+    rowSize = TMAX(rowSize, (int32_t)ceil(blockDataGetSerialRowSize(pInfo->side[i].pTemplate)));
+  }
+  uint32_t pageSize = 0;
+  uint32_t bufSize = 0;
+  getBufferPgSize(rowSize, &pageSize, &bufSize);
+
+  if (!osTempSpaceAvailable()) {
+    qError("%s hash join spill failed since %s", GET_TASKID(pTaskInfo), tstrerror(TSDB_CODE_NO_AVAIL_DISK));
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_NO_AVAIL_DISK);
+  }
+  int32_t code = createDiskbasedBuf(&pInfo->pBuf, pageSize, bufSize, "hashJoin", tsTempDir);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+  pInfo->spilled = true;
+
+  for (int32_t i = 0; i < 2; ++i) {
+    SHJoinSide* pSide = &pInfo->side[i];
+    int32_t     numOfCols = taosArrayGetSize(pSide->pTemplate->pDataBlock);
+    pSide->rowsPerPage = (int32_t)((pageSize - blockDataGetSerialMetaSize(numOfCols)) /
+                                   ceil(blockDataGetSerialRowSize(pSide->pTemplate)));
+
+    for (int32_t j = 0; j < taosArrayGetSize(pSide->pBlocks); ++j) {
+      code = hashJoinPartitionBlock(pInfo, pSide, taosArrayGetP(pSide->pBlocks, j));
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+    destroyBlockList(pSide->pBlocks);
+
+    SOperatorInfo* pDownstream = pOperator->pDownstream[i];
+    while (!pSide->finished) {
+      SSDataBlock* pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+      if (pBlock == NULL) {
+        pSide->finished = true;
+        break;
+      }
+      code = hashJoinPartitionBlock(pInfo, pSide, pBlock);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+
+    for (int32_t j = 0; j < HJOIN_NUM_OF_PARTS; ++j) {
+      code = hashJoinFlushPart(pInfo, pSide, j);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+  }
+
+  qDebug("%s hash join inputs exceed %" PRId64 " bytes, partitioned to disk, rows left:%" PRId64 " right:%" PRId64,
+         GET_TASKID(pTaskInfo), pInfo->maxBufSize, hashJoinTotalRows(&pInfo->side[0]),
+         hashJoinTotalRows(&pInfo->side[1]));
+  pInfo->curPart = -1;
+}
+
+static SSDataBlock* hashJoinLoadPage(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock, int32_t pageId) {
+  void* pPage = getBufPage(pInfo->pBuf, pageId);
+  if (pPage == NULL) {
+    return NULL;
+  }
+  // blockDataFromBuf overwrites all the columns, and shrinks the var data offsets to the rows of the page, so the
+  // block must not be cleaned up by its capacity
+  blockDataFromBuf(pBlock, pPage);
+  releaseBufPage(pInfo->pBuf, pPage);
+  return pBlock;
+}
+
+// Moves to the next partition with rows on both sides and builds the hash table on its smaller side.
+static bool hashJoinNextPart(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  hashJoinClearTable(pInfo);
+  while (++pInfo->curPart < HJOIN_NUM_OF_PARTS) {
+    int32_t part = pInfo->curPart;
+    if (pInfo->side[0].partRows[part] == 0 || pInfo->side[1].partRows[part] == 0) {
+      continue;
+    }
+
+    pInfo->buildIdx = (pInfo->side[0].partRows[part] <= pInfo->side[1].partRows[part]) ? 0 : 1;
+    SHJoinSide* pSide = &pInfo->side[pInfo->buildIdx];
+    for (int32_t i = 0; i < taosArrayGetSize(pSide->pPageIds[part]); ++i) {
+      SSDataBlock* pBlock = createOneDataBlock(pSide->pTemplate, false);
+      if (pBlock == NULL || taosArrayPush(pInfo->pBuildBlocks, &pBlock) == NULL) {
+        blockDataDestroy(pBlock);
+        T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+      if (hashJoinLoadPage(pInfo, pBlock, *(int32_t*)taosArrayGet(pSide->pPageIds[part], i)) == NULL) {
+        T_LONG_JMP(pTaskInfo->env, terrno);
+      }
+    }
+    hashJoinBuildTable(pOperator);
+    pInfo->probeBlockIdx = 0;
+    return true;
+  }
+  return false;
+}
+
+static SSDataBlock* hashJoinNextProbeBlock(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t                probeIdx = 1 - pInfo->buildIdx;
+  SHJoinSide*            pSide = &pInfo->side[probeIdx];
+
+  if (!pInfo->spilled) {
+    if (pInfo->probeBlockIdx < taosArrayGetSize(pSide->pBlocks)) {
+      return taosArrayGetP(pSide->pBlocks, pInfo->probeBlockIdx++);
+    }
+    if (pSide->finished) {
+      return NULL;
+    }
+    SOperatorInfo* pDownstream = pOperator->pDownstream[probeIdx];
+    SSDataBlock*   pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+    if (pBlock == NULL) {
+      pSide->finished = true;
+    }
+    return pBlock;
+  }
+
+  while (pInfo->curPart < 0 || pInfo->probeBlockIdx >= taosArrayGetSize(pSide->pPageIds[pInfo->curPart])) {
+    if (!hashJoinNextPart(pOperator)) {
+      return NULL;
+    }
+    probeIdx = 1 - pInfo->buildIdx;
+    pSide = &pInfo->side[probeIdx];
+  }
+
+  if (pSide->pLoadBlock == NULL) {
+    pSide->pLoadBlock = createOneDataBlock(pSide->pTemplate, false);
+    if (pSide->pLoadBlock == NULL) {
+      T_LONG_JMP(pOperator->pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+  }
+  int32_t      pageId = *(int32_t*)taosArrayGet(pSide->pPageIds[pInfo->curPart], pInfo->probeBlockIdx++);
+  SSDataBlock* pBlock = hashJoinLoadPage(pInfo, pSide->pLoadBlock, pageId);
+  if (pBlock == NULL) {
+    T_LONG_JMP(pOperator->pTaskInfo->env, terrno);
+  }
+  return pBlock;
+}
+
+// Reads both inputs by turns until one of them ends, that one is the smaller input and the hash table is built on it.
+static int32_t doOpenHashJoinOperator(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  if (OPTR_IS_OPENED(pOperator)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  int32_t finishedIdx = -1;
+  while (finishedIdx < 0) {
+    for (int32_t i = 0; i < 2; ++i) {
+      SHJoinSide*    pSide = &pInfo->side[i];
+      SOperatorInfo* pDownstream = pOperator->pDownstream[i];
+      SSDataBlock*   pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+      if (pBlock == NULL) {
+        pSide->finished = true;
+        finishedIdx = i;
+        break;
+      }
+
+      // the downstream reuses its result block, keep a copy
+      SSDataBlock* pCopy = createOneDataBlock(pBlock, true);
+      if (pCopy == NULL || taosArrayPush(pSide->pBlocks, &pCopy) == NULL) {
+        blockDataDestroy(pCopy);
+        T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+      if (pSide->pTemplate == NULL) {
+        pSide->pTemplate = createOneDataBlock(pBlock, false);
+      }
+      pSide->bytes += blockDataGetSize(pCopy);
+    }
+
+    if (finishedIdx < 0 && pInfo->side[0].bytes + pInfo->side[1].bytes > pInfo->maxBufSize) {
+      hashJoinSpill(pOperator);
+      break;
+    }
+  }
+
+  if (!pInfo->spilled) {
+    pInfo->buildIdx = finishedIdx;
+    taosArrayAddAll(pInfo->pBuildBlocks, pInfo->side[finishedIdx].pBlocks);
+    hashJoinBuildTable(pOperator);
+    pInfo->probeBlockIdx = 0;
+  }
+
+  pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
+  OPTR_SET_OPENED(pOperator);
+  return TSDB_CODE_SUCCESS;
+}
+
+// Probes the hash table with the rows of the probe block in a batch, and then copies the output column by column.
+static void hashJoinProbe(SOperatorInfo* pOperator, SSDataBlock* pProbe) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SSDataBlock*           pRes = pInfo->pRes;
+  int32_t                probeIdx = 1 - pInfo->buildIdx;
+  SHJoinSide*            pSide = &pInfo->side[probeIdx];
+  int32_t                capacity = pOperator->resultInfo.threshold - pRes->info.rows;
+
+  taosArrayClear(pInfo->pMatches);
+  int32_t row = pInfo->probeRow;
+  for (; row < pProbe->info.rows && taosArrayGetSize(pInfo->pMatches) < capacity; ++row) {
+    int32_t len = 0;
+    if (!hashJoinGetKey(pInfo, pSide, pProbe, row, &len)) {
+      continue;
+    }
+    int32_t* pHead = taosHashGet(pInfo->pHashTable, pInfo->keyBuf, len);
+    for (int32_t idx = (pHead != NULL) ? *pHead : -1; idx >= 0;) {
+      SHJoinMatch match = {.probeRow = row, .refIdx = idx};
+      taosArrayPush(pInfo->pMatches, &match);
+      idx = ((SHJoinRowRef*)taosArrayGet(pInfo->pRowRefs, idx))->next;
+    }
+  }
+  pInfo->probeRow = row;
+
+  int32_t numOfMatches = taosArrayGetSize(pInfo->pMatches);
+  if (numOfMatches == 0) {
+    return;
+  }
+  int32_t code = blockDataEnsureCapacity(pRes, pRes->info.rows + numOfMatches);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s can not ensure block capacity for hash join, rows:%d", GET_TASKID(pOperator->pTaskInfo),
+           pRes->info.rows + numOfMatches);
+    T_LONG_JMP(pOperator->pTaskInfo->env, code);
+  }
+
+  SHJoinMatch* pMatches = TARRAY_GET_START(pInfo->pMatches);
+  for (int32_t i = 0; i < pOperator->exprSupp.numOfExprs; ++i) {
+    SExprInfo*       pExprInfo = &pOperator->exprSupp.pExprInfo[i];
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, i);
+    int32_t          slotId = pExprInfo->base.pParam[0].pCol->slotId;
+    bool fromProbe = (pExprInfo->base.pParam[0].pCol->dataBlockId == pOperator->pDownstream[probeIdx]->resultDataBlockId);
+
+    for (int32_t j = 0; j < numOfMatches; ++j) {
+      SColumnInfoData* pSrc = NULL;
+      int32_t          srcRow = 0;
+      if (fromProbe) {
+        pSrc = taosArrayGet(pProbe->pDataBlock, slotId);
+        srcRow = pMatches[j].probeRow;
+      } else {
+        SHJoinRowRef* pRef = taosArrayGet(pInfo->pRowRefs, pMatches[j].refIdx);
+        SSDataBlock*  pBuild = taosArrayGetP(pInfo->pBuildBlocks, pRef->blockIdx);
+        pSrc = taosArrayGet(pBuild->pDataBlock, slotId);
+        srcRow = pRef->rowIdx;
+      }
+
+      if (colDataIsNull_s(pSrc, srcRow)) {
+        colDataAppendNULL(pDst, pRes->info.rows + j);
+      } else {
+        colDataAppend(pDst, pRes->info.rows + j, colDataGetData(pSrc, srcRow), false);
+      }
+    }
+  }
+  pRes->info.rows += numOfMatches;
+}
+
+SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  int32_t code = pOperator->fpSet._openFn(pOperator);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pOperator->pTaskInfo->env, code);
+  }
+
+  SSDataBlock* pRes = pInfo->pRes;
+  blockDataCleanup(pRes);
+  blockDataEnsureCapacity(pRes, pOperator->resultInfo.capacity);
+  while (pRes->info.rows < pOperator->resultInfo.threshold) {
+    if (pInfo->pProbe == NULL || pInfo->probeRow >= pInfo->pProbe->info.rows) {
+      pInfo->pProbe = hashJoinNextProbeBlock(pOperator);
+      pInfo->probeRow = 0;
+      if (pInfo->pProbe == NULL) {
+        doSetOperatorCompleted(pOperator);
+        break;
+      }
+    }
+
+    int32_t numOfRowsBefore = pRes->info.rows;
+    hashJoinProbe(pOperator, pInfo->pProbe);
+    if (pInfo->pCondAfterJoin != NULL && pRes->info.rows > numOfRowsBefore) {
+      doFilter(pInfo->pCondAfterJoin, pRes, NULL);
+    }
+  }
+
+  pOperator->resultInfo.totalRows += pRes->info.rows;
+  return (pRes->info.rows > 0) ? pRes : NULL;
+}
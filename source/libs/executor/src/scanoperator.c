@@ -29,6 +29,7 @@
 #include "query.h"
 #include "tcompare.h"
 #include "thash.h"
+#include "tsched.h"
 #include "ttypes.h"
 #include "vnode.h"
 
@@ -39,6 +40,13 @@ static int32_t buildSysDbTableInfo(const SSysTableScanInfo* pInfo, int32_t capac
 static int32_t buildDbTableInfoBlock(bool sysInfo, const SSDataBlock* p, const SSysTableMeta* pSysDbTableMeta,
                                      size_t size, const char* dbName);
 
+#define SCAN_WORKER_QUEUE_SIZE   4096
+#define SCAN_WORKER_BUFFER_BLOCKS 2  // number of loaded blocks that can be buffered for each worker
+
+static TdThreadOnce scanWorkerPoolOnce = PTHREAD_ONCE_INIT;
+static SSchedQueue  scanWorkerPool = {0};
+static void*        pScanWorkerPool = NULL;
+
 static bool processBlockWithProbability(const SSampleExecInfo* pInfo);
 
 bool processBlockWithProbability(const SSampleExecInfo* pInfo) {
@@ -279,6 +287,42 @@ static bool doLoadBlockSMA(STableScanInfo* pTableScanInfo, SSDataBlock* pBlock,
   return true;
 }
 
+// The rest columns are decoded and relocated only when some rows of the block pass the filter, and the rows filtered
+// out are not copied by the reader.
+static int32_t doFilterAndLoadDelayedCols(STableScanInfo* pTableScanInfo, SSDataBlock* pBlock) {
+  if (pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int8_t* rowRes = NULL;
+  bool    keep = doEvalFilter(pTableScanInfo->pFilterNode, pBlock, &rowRes);
+
+  int32_t numOfQualified = keep ? pBlock->info.rows : 0;
+  if (!keep && rowRes != NULL) {
+    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+      numOfQualified += (rowRes[i] != 0);
+    }
+  }
+
+  if (numOfQualified == 0) {
+    pBlock->info.rows = 0;
+    taosMemoryFree(rowRes);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SArray* pCols = tsdbRetrieveDataBlockRest(pTableScanInfo->dataReader, keep ? NULL : rowRes);
+  if (pCols == NULL) {
+    taosMemoryFree(rowRes);
+    return terrno;
+  }
+
+  relocateColumnData(pBlock, pTableScanInfo->pDelayedColMatch, pCols, true);
+  doApplyFilterResult(pBlock, rowRes, keep, pTableScanInfo->pColMatchInfo);
+
+  taosMemoryFree(rowRes);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanInfo* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
@@ -360,12 +404,14 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanInfo* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
-  SArray* pCols = tsdbRetrieveDataBlock(pTableScanInfo->dataReader, NULL);
+  // with a filter, only the columns required by the filter are loaded here, see doFilterAndLoadDelayedCols
+  SArray* pCols = tsdbRetrieveDataBlock(pTableScanInfo->dataReader, pTableScanInfo->pFilterCols);
   if (pCols == NULL) {
     return terrno;
   }
 
-  relocateColumnData(pBlock, pTableScanInfo->pColMatchInfo, pCols, true);
+  bool delayed = (pTableScanInfo->pDelayedColMatch != NULL);
+  relocateColumnData(pBlock, delayed ? pTableScanInfo->pFilterColMatch : pTableScanInfo->pColMatchInfo, pCols, true);
 
   // currently only the tbname pseudo column
   if (pTableScanInfo->pseudoSup.numOfExprs > 0) {
@@ -380,7 +426,14 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanInfo* pTableSca
 
   if (pTableScanInfo->pFilterNode != NULL) {
     int64_t st = taosGetTimestampUs();
-    doFilter(pTableScanInfo->pFilterNode, pBlock, pTableScanInfo->pColMatchInfo);
+    if (delayed) {
+      int32_t code = doFilterAndLoadDelayedCols(pTableScanInfo, pBlock);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    } else {
+      doFilter(pTableScanInfo->pFilterNode, pBlock, pTableScanInfo->pColMatchInfo);
+    }
 
     double el = (taosGetTimestampUs() - st) / 1000.0;
     pTableScanInfo->readRecorder.filterTime += el;
@@ -611,7 +664,449 @@ static SSDataBlock* doTableScanGroup(SOperatorInfo* pOperator) {
   return NULL;
 }
 
-static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
+static void cleanupScanWorkerPool() { taosCleanUpScheduler(&scanWorkerPool); }
+
+static void initScanWorkerPool() {
+  int32_t numOfThreads = TMAX((int32_t)tsNumOfCores, 2);
+  pScanWorkerPool = taosInitScheduler(SCAN_WORKER_QUEUE_SIZE, numOfThreads, "qscan", &scanWorkerPool);
+  if (pScanWorkerPool == NULL) {
+    qError("failed to init scan worker pool, numOfThreads:%d", numOfThreads);
+    return;
+  }
+
+  atexit(cleanupScanWorkerPool);
+}
+
+// The blocks loaded by the workers are returned in any order, so only the single pass scan of one table group in the
+// batch model is done in parallel. The blocks of one table are still returned in time order, since each table is
+// scanned by one worker only.
+static int32_t getTableScanParallelism(SOperatorInfo* pOperator) {
+  STableScanInfo* pInfo = pOperator->info;
+  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
+
+  // the workers do not return the blocks in the order of the timestamp, which the limit depends on
+  if (pInfo->parallelism <= 1 || pTaskInfo->execModel != OPTR_EXEC_MODEL_BATCH || pInfo->assignBlockUid ||
+      pInfo->limitInfo.limit.limit >= 0 ||
+      pInfo->scanInfo.numOfAsc + pInfo->scanInfo.numOfDesc != 1 ||
+      taosArrayGetSize(pTaskInfo->tableqinfoList.pGroupList) != 1) {
+    return 1;
+  }
+
+  taosThreadOnce(&scanWorkerPoolOnce, initScanWorkerPool);
+  if (pScanWorkerPool == NULL) {
+    return 1;
+  }
+
+  int32_t numOfTables = taosArrayGetSize(pTaskInfo->tableqinfoList.pTableList);
+  return TMIN(TMIN(pInfo->parallelism, numOfTables), scanWorkerPool.numOfThreads);
+}
+
+// The SMA of a block points to the buffer of the data reader, which is overwritten by the next block. Keep a copy of
+// it, since the block is consumed after the worker has moved on.
+static int32_t copyBlockSMA(SSDataBlock* pBlock) {
+  if (pBlock->pBlockAgg == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t          numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  SColumnDataAgg** pColAgg = taosMemoryCalloc(1, numOfCols * (POINTER_BYTES + sizeof(SColumnDataAgg)));
+  if (pColAgg == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SColumnDataAgg* pAgg = (SColumnDataAgg*)((char*)pColAgg + numOfCols * POINTER_BYTES);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (pBlock->pBlockAgg[i] != NULL) {
+      pAgg[i] = *pBlock->pBlockAgg[i];
+      pColAgg[i] = &pAgg[i];
+    }
+  }
+
+  taosMemoryFree(pBlock->pBlockAgg);
+  pBlock->pBlockAgg = pColAgg;
+  return TSDB_CODE_SUCCESS;
+}
+
+enum {
+  SCAN_BLOCK_PUSHED = 0,
+  SCAN_BLOCK_PARKED,  // the buffer is full, the worker keeps the block and is rescheduled once there is room for it
+  SCAN_BLOCK_STOPPED,
+};
+
+static int32_t pushTableScanBlock(STableScanWorker* pWorker) {
+  STableScanParaInfo* pPara = pWorker->pPara;
+  int32_t             ret = SCAN_BLOCK_PUSHED;
+
+  taosThreadMutexLock(&pPara->mutex);
+  if (pPara->stop) {
+    ret = SCAN_BLOCK_STOPPED;
+  } else if (taosArrayGetSize(pPara->pBlocks) >= pPara->capacity) {
+    pWorker->pending = true;
+    taosArrayPush(pPara->pParked, &pWorker);
+    ret = SCAN_BLOCK_PARKED;
+  } else {
+    pWorker->pending = false;
+    taosArrayPush(pPara->pBlocks, &pWorker->pBlock);
+    pWorker->pBlock = NULL;
+    taosThreadCondSignal(&pPara->notEmpty);
+  }
+
+  taosThreadMutexUnlock(&pPara->mutex);
+  return ret;
+}
+
+static void addBlockLoadCost(SFileBlockLoadRecorder* pDst, const SFileBlockLoadRecorder* pSrc) {
+  pDst->totalRows += pSrc->totalRows;
+  pDst->totalCheckedRows += pSrc->totalCheckedRows;
+  pDst->totalBlocks += pSrc->totalBlocks;
+  pDst->loadBlocks += pSrc->loadBlocks;
+  pDst->loadBlockStatis += pSrc->loadBlockStatis;
+  pDst->skipBlocks += pSrc->skipBlocks;
+  pDst->filterOutBlocks += pSrc->filterOutBlocks;
+  pDst->elapsedTime = TMAX(pDst->elapsedTime, pSrc->elapsedTime);
+  pDst->filterTime += pSrc->filterTime;
+}
+
+static void tableScanWorkerDone(STableScanWorker* pWorker, int32_t code) {
+  STableScanParaInfo* pPara = pWorker->pPara;
+
+  taosThreadMutexLock(&pPara->mutex);
+  if (code != TSDB_CODE_SUCCESS && pPara->code == TSDB_CODE_SUCCESS) {
+    pPara->code = code;
+  }
+
+  addBlockLoadCost(pPara->pRecorder, &pWorker->pScanInfo->readRecorder);
+  pPara->numOfRunning -= 1;
+  taosThreadCondBroadcast(&pPara->notEmpty);
+  taosThreadMutexUnlock(&pPara->mutex);
+}
+
+static void doTableScanWorker(SSchedMsg* pMsg) {
+  STableScanWorker*   pWorker = pMsg->ahandle;
+  STableScanParaInfo* pPara = pWorker->pPara;
+  STableScanInfo*     pInfo = pWorker->pScanInfo;
+  SExecTaskInfo*      pTaskInfo = pWorker->pTaskInfo;
+
+  int32_t code = setjmp(pTaskInfo->env);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s table scan worker failed, code:%s", GET_TASKID(pTaskInfo), tstrerror(code));
+    tableScanWorkerDone(pWorker, code);
+    return;
+  }
+
+  int64_t st = taosGetTimestampUs();
+
+  // resumed after being parked, the block loaded last time goes first
+  if (pWorker->pending) {
+    int32_t ret = pushTableScanBlock(pWorker);
+    if (ret == SCAN_BLOCK_PARKED) {
+      return;
+    } else if (ret == SCAN_BLOCK_STOPPED) {
+      tableScanWorkerDone(pWorker, TSDB_CODE_SUCCESS);
+      return;
+    }
+  }
+
+  while (!atomic_load_8(&pPara->stop) && tsdbNextDataBlock(pInfo->dataReader)) {
+    if (isTaskKilled(pPara->pTaskInfo)) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_TSC_QUERY_CANCELLED);
+    }
+
+    // the block is handed over to the query thread once loaded, so a new one is created for each block
+    if (pWorker->pBlock == NULL) {
+      pWorker->pBlock = createOneDataBlock(pInfo->pResBlock, false);
+      if (pWorker->pBlock == NULL) {
+        T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+    }
+
+    SSDataBlock* pBlock = pWorker->pBlock;
+    blockDataCleanup(pBlock);
+
+    SDataBlockInfo binfo = pBlock->info;
+    tsdbRetrieveDataBlockInfo(pInfo->dataReader, &binfo);
+
+    binfo.capacity = binfo.rows;
+    blockDataEnsureCapacity(pBlock, binfo.rows);
+    pBlock->info = binfo;
+
+    uint64_t* groupId = taosHashGet(pTaskInfo->tableqinfoList.map, &pBlock->info.uid, sizeof(int64_t));
+    if (groupId) {
+      pBlock->info.groupId = *groupId;
+    }
+
+    uint32_t status = 0;
+    code = loadDataBlock(pWorker->pOperator, pInfo, pBlock, &status);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    if (status == FUNC_DATA_REQUIRED_FILTEROUT || pBlock->info.rows == 0) {
+      continue;
+    }
+
+    code = copyBlockSMA(pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    pInfo->readRecorder.elapsedTime += (taosGetTimestampUs() - st) / 1000.0;
+    st = taosGetTimestampUs();
+
+    int32_t ret = pushTableScanBlock(pWorker);
+    if (ret == SCAN_BLOCK_PARKED) {
+      return;
+    } else if (ret == SCAN_BLOCK_STOPPED) {
+      break;
+    }
+  }
+
+  tableScanWorkerDone(pWorker, TSDB_CODE_SUCCESS);
+}
+
+static int32_t initTableScanWorker(SOperatorInfo* pOperator, STableScanWorker* pWorker, int32_t index,
+                                   int32_t numOfWorkers) {
+  STableScanInfo* pInfo = pOperator->info;
+  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
+  SArray*         pTableList = pTaskInfo->tableqinfoList.pTableList;
+  int32_t         numOfTables = taosArrayGetSize(pTableList);
+
+  pWorker->pPara = pInfo->pParaScan;
+  pWorker->pScanInfo = taosMemoryCalloc(1, sizeof(STableScanInfo));
+  pWorker->pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  pWorker->pTaskInfo = taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  if (pWorker->pScanInfo == NULL || pWorker->pOperator == NULL || pWorker->pTaskInfo == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the column match info and its filter/delayed subsets, the pseudo columns and the query condition are shared with
+  // the query thread, while the block SMA of the aggregate results is not used by the workers.
+  STableScanInfo* pWorkerInfo = pWorker->pScanInfo;
+  *pWorkerInfo = *pInfo;
+  pWorkerInfo->dataReader = NULL;
+  pWorkerInfo->pFilterNode = NULL;
+  pWorkerInfo->pdInfo.pAggSup = NULL;
+  pWorkerInfo->pdInfo.pExprSup = NULL;
+  pWorkerInfo->pParaScan = NULL;
+  pWorkerInfo->parallelism = 1;
+  memset(&pWorkerInfo->readRecorder, 0, sizeof(SFileBlockLoadRecorder));
+
+  // the filter node is revised when the filter is initialized, so each worker keeps a copy of it
+  if (pInfo->pFilterNode != NULL) {
+    pWorkerInfo->pFilterNode = nodesCloneNode(pInfo->pFilterNode);
+    if (pWorkerInfo->pFilterNode == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  // the id, the schema and the table list of the query are shared by the worker, which has its own status, error code
+  // and jump buffer. The query thread keeps the task info alive until all the workers have ended.
+  SExecTaskInfo* pWorkerTaskInfo = pWorker->pTaskInfo;
+  *pWorkerTaskInfo = *pTaskInfo;
+  pWorkerTaskInfo->status = TASK_NOT_COMPLETED;
+  pWorkerTaskInfo->code = TSDB_CODE_SUCCESS;
+  pWorkerTaskInfo->owner = 0;
+  pWorkerTaskInfo->pRoot = pWorker->pOperator;
+  memset(&pWorkerTaskInfo->cost, 0, sizeof(STaskCostInfo));
+
+  pWorker->pOperator->name = pOperator->name;
+  pWorker->pOperator->operatorType = pOperator->operatorType;
+  pWorker->pOperator->info = pWorkerInfo;
+  pWorker->pOperator->pTaskInfo = pWorker->pTaskInfo;
+
+  SArray* pSubTableList = taosArrayInit(numOfTables / numOfWorkers + 1, sizeof(STableKeyInfo));
+  if (pSubTableList == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = index; i < numOfTables; i += numOfWorkers) {
+    taosArrayPush(pSubTableList, taosArrayGet(pTableList, i));
+  }
+
+  int32_t code = tsdbReaderOpen(pInfo->readHandle.vnode, &pInfo->cond, pSubTableList, &pWorkerInfo->dataReader,
+                                GET_TASKID(pTaskInfo));
+  taosArrayDestroy(pSubTableList);
+  return code;
+}
+
+static void destroyTableScanWorker(STableScanWorker* pWorker) {
+  if (pWorker->pScanInfo != NULL) {
+    tsdbReaderClose(pWorker->pScanInfo->dataReader);
+    nodesDestroyNode(pWorker->pScanInfo->pFilterNode);
+    taosMemoryFree(pWorker->pScanInfo);
+  }
+
+  blockDataDestroy(pWorker->pBlock);
+  taosMemoryFree(pWorker->pOperator);
+  taosMemoryFree(pWorker->pTaskInfo);
+}
+
+static void destroyParallelTableScan(STableScanParaInfo* pPara) {
+  if (pPara == NULL) {
+    return;
+  }
+
+  // stop the workers and wait for them to end, the workers not started yet end as soon as they are started, and the
+  // parked ones are never rescheduled
+  taosThreadMutexLock(&pPara->mutex);
+  atomic_store_8(&pPara->stop, 1);
+  for (int32_t i = 0; i < taosArrayGetSize(pPara->pParked); ++i) {
+    STableScanWorker* pWorker = taosArrayGetP(pPara->pParked, i);
+    addBlockLoadCost(pPara->pRecorder, &pWorker->pScanInfo->readRecorder);
+    pPara->numOfRunning -= 1;
+  }
+  taosArrayClear(pPara->pParked);
+
+  while (pPara->numOfRunning > 0) {
+    taosThreadCondWait(&pPara->notEmpty, &pPara->mutex);
+  }
+  taosThreadMutexUnlock(&pPara->mutex);
+
+  for (int32_t i = 0; i < pPara->numOfWorkers; ++i) {
+    destroyTableScanWorker(&pPara->pWorkers[i]);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pPara->pBlocks); ++i) {
+    blockDataDestroy(taosArrayGetP(pPara->pBlocks, i));
+  }
+
+  taosArrayDestroy(pPara->pBlocks);
+  taosArrayDestroy(pPara->pParked);
+  blockDataDestroy(pPara->pCurBlock);
+  taosMemoryFree(pPara->pWorkers);
+  taosThreadCondDestroy(&pPara->notEmpty);
+  taosThreadMutexDestroy(&pPara->mutex);
+  taosMemoryFree(pPara);
+}
+
+// the worker is ended if it can not be scheduled, and the scan fails with the error
+static int32_t scheduleTableScanWorker(STableScanWorker* pWorker) {
+  SSchedMsg msg = {.fp = doTableScanWorker, .ahandle = pWorker};
+  if (taosScheduleTask(&scanWorkerPool, &msg) != 0) {
+    tableScanWorkerDone(pWorker, TSDB_CODE_QRY_SYS_ERROR);
+    return TSDB_CODE_QRY_SYS_ERROR;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t startParallelTableScan(SOperatorInfo* pOperator, int32_t numOfWorkers) {
+  STableScanInfo* pInfo = pOperator->info;
+  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
+
+  STableScanParaInfo* pPara = taosMemoryCalloc(1, sizeof(STableScanParaInfo));
+  if (pPara == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pPara->capacity = numOfWorkers * SCAN_WORKER_BUFFER_BLOCKS;
+  pPara->pBlocks = taosArrayInit(pPara->capacity, POINTER_BYTES);
+  pPara->pParked = taosArrayInit(numOfWorkers, POINTER_BYTES);
+  pPara->pWorkers = taosMemoryCalloc(numOfWorkers, sizeof(STableScanWorker));
+  if (pPara->pBlocks == NULL || pPara->pParked == NULL || pPara->pWorkers == NULL) {
+    taosArrayDestroy(pPara->pBlocks);
+    taosArrayDestroy(pPara->pParked);
+    taosMemoryFree(pPara->pWorkers);
+    taosMemoryFree(pPara);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexInit(&pPara->mutex, NULL);
+  taosThreadCondInit(&pPara->notEmpty, NULL);
+  pPara->pTaskInfo = pTaskInfo;
+  pPara->pRecorder = &pInfo->readRecorder;
+
+  // the workers started so far are stopped when the operator is destroyed, if any error happens
+  pInfo->pParaScan = pPara;
+
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    pPara->numOfWorkers += 1;
+    int32_t code = initTableScanWorker(pOperator, &pPara->pWorkers[i], i, numOfWorkers);
+    if (code != TSDB_CODE_SUCCESS) {
+      qError("%s failed to init table scan worker:%d, code:%s", GET_TASKID(pTaskInfo), i, tstrerror(code));
+      return code;
+    }
+  }
+
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    taosThreadMutexLock(&pPara->mutex);
+    pPara->numOfRunning += 1;
+    taosThreadMutexUnlock(&pPara->mutex);
+
+    int32_t code = scheduleTableScanWorker(&pPara->pWorkers[i]);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  qDebug("%s scan %d tables with %d workers", GET_TASKID(pTaskInfo),
+         (int32_t)taosArrayGetSize(pTaskInfo->tableqinfoList.pTableList), numOfWorkers);
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* doParallelTableScan(SOperatorInfo* pOperator) {
+  STableScanInfo*     pInfo = pOperator->info;
+  SExecTaskInfo*      pTaskInfo = pOperator->pTaskInfo;
+  STableScanParaInfo* pPara = pInfo->pParaScan;
+
+  pPara->pCurBlock = blockDataDestroy(pPara->pCurBlock);
+
+  int64_t st = taosGetTimestampUs();
+
+  taosThreadMutexLock(&pPara->mutex);
+  while (taosArrayGetSize(pPara->pBlocks) == 0 && pPara->numOfRunning > 0 && pPara->code == TSDB_CODE_SUCCESS) {
+    taosThreadCondWait(&pPara->notEmpty, &pPara->mutex);
+  }
+
+  // a parked worker is resumed for each block taken out, there are never more parked workers than buffered blocks
+  STableScanWorker* pResumed = NULL;
+  int32_t           code = pPara->code;
+  if (code == TSDB_CODE_SUCCESS && taosArrayGetSize(pPara->pBlocks) > 0) {
+    pPara->pCurBlock = taosArrayGetP(pPara->pBlocks, 0);
+    taosArrayRemove(pPara->pBlocks, 0);
+    if (taosArrayGetSize(pPara->pParked) > 0) {
+      pResumed = taosArrayGetP(pPara->pParked, 0);
+      taosArrayRemove(pPara->pParked, 0);
+    }
+  }
+  taosThreadMutexUnlock(&pPara->mutex);
+
+  if (pResumed != NULL) {
+    code = scheduleTableScanWorker(pResumed);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  pOperator->cost.totalCost += (taosGetTimestampUs() - st) / 1000.0;
+  if (pPara->pCurBlock == NULL) {
+    setTaskStatus(pTaskInfo, TASK_COMPLETED);
+    return NULL;
+  }
+
+  pOperator->resultInfo.totalRows += pPara->pCurBlock->info.rows;
+  return pPara->pCurBlock;
+}
+
+// The upstream only needs the first rows of a scan in the order of the timestamp, stop reading the data once they
+// have been returned.
+static SSDataBlock* applyScanLimit(SOperatorInfo* pOperator, SLimitInfo* pLimitInfo, SSDataBlock* pBlock) {
+  if (pBlock == NULL) {
+    return NULL;
+  }
+
+  int64_t remain = pLimitInfo->limit.limit - pLimitInfo->numOfOutputRows;
+  if (pBlock->info.rows >= remain) {
+    blockDataKeepFirstNRows(pBlock, remain);
+    doSetOperatorCompleted(pOperator);
+  }
+
+  pLimitInfo->numOfOutputRows += pBlock->info.rows;
+  return (pBlock->info.rows > 0) ? pBlock : NULL;
+}
+
+static SSDataBlock* doTableScanNext(SOperatorInfo* pOperator) {
   STableScanInfo* pInfo = pOperator->info;
   SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
 
@@ -645,6 +1140,20 @@ static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
     }
   }
 
+  if (pInfo->currentGroupId == -1 && pInfo->pParaScan == NULL) {
+    int32_t numOfWorkers = getTableScanParallelism(pOperator);
+    if (numOfWorkers > 1) {
+      int32_t code = startParallelTableScan(pOperator, numOfWorkers);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+  }
+
+  if (pInfo->pParaScan != NULL) {
+    return doParallelTableScan(pOperator);
+  }
+
   if (pInfo->currentGroupId == -1) {
     pInfo->currentGroupId++;
     if (pInfo->currentGroupId >= taosArrayGetSize(pTaskInfo->tableqinfoList.pGroupList)) {
@@ -690,6 +1199,19 @@ static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
   return NULL;
 }
 
+static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
+  STableScanInfo* pInfo = pOperator->info;
+  if (pInfo->limitInfo.limit.limit < 0) {
+    return doTableScanNext(pOperator);
+  }
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  return applyScanLimit(pOperator, &pInfo->limitInfo, doTableScanNext(pOperator));
+}
+
 static int32_t getTableScannerExecInfo(struct SOperatorInfo* pOptr, void** pOptrExplain, uint32_t* len) {
   SFileBlockLoadRecorder* pRecorder = taosMemoryCalloc(1, sizeof(SFileBlockLoadRecorder));
   STableScanInfo*         pTableScanInfo = pOptr->info;
@@ -701,6 +1223,7 @@ static int32_t getTableScannerExecInfo(struct SOperatorInfo* pOptr, void** pOptr
 
 static void destroyTableScanOperatorInfo(void* param) {
   STableScanInfo* pTableScanInfo = (STableScanInfo*)param;
+  destroyParallelTableScan(pTableScanInfo->pParaScan);
   blockDataDestroy(pTableScanInfo->pResBlock);
   cleanupQueryTableDataCond(&pTableScanInfo->cond);
 
@@ -711,10 +1234,71 @@ static void destroyTableScanOperatorInfo(void* param) {
     taosArrayDestroy(pTableScanInfo->pColMatchInfo);
   }
 
+  taosArrayDestroy(pTableScanInfo->pFilterCols);
+  taosArrayDestroy(pTableScanInfo->pFilterColMatch);
+  taosArrayDestroy(pTableScanInfo->pDelayedColMatch);
   cleanupExprSupp(&pTableScanInfo->pseudoSup);
   taosMemoryFreeClear(param);
 }
 
+static EDealRes collectFilterSlotIdWalker(SNode* pNode, void* pContext) {
+  if (QUERY_NODE_COLUMN == nodeType(pNode)) {
+    taosArrayPush((SArray*)pContext, &((SColumnNode*)pNode)->slotId);
+  }
+  return DEAL_RES_CONTINUE;
+}
+
+// split the scan columns into the ones required by the filter and the ones delayed until the filter is applied
+static int32_t initDelayedColumnLoad(STableScanInfo* pInfo) {
+  if (pInfo->pFilterNode == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(pInfo->pColMatchInfo);
+  SArray* pSlotIds = taosArrayInit(4, sizeof(int16_t));
+  pInfo->pFilterCols = taosArrayInit(4, sizeof(int16_t));
+  pInfo->pFilterColMatch = taosArrayInit(4, sizeof(SColMatchInfo));
+  pInfo->pDelayedColMatch = taosArrayInit(numOfCols, sizeof(SColMatchInfo));
+  if (pSlotIds == NULL || pInfo->pFilterCols == NULL || pInfo->pFilterColMatch == NULL ||
+      pInfo->pDelayedColMatch == NULL) {
+    taosArrayDestroy(pSlotIds);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  nodesWalkExpr(pInfo->pFilterNode, collectFilterSlotIdWalker, pSlotIds);
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColMatchInfo* pColMatch = taosArrayGet(pInfo->pColMatchInfo, i);
+
+    bool required = false;
+    for (int32_t j = 0; j < taosArrayGetSize(pSlotIds); ++j) {
+      if (*(int16_t*)taosArrayGet(pSlotIds, j) == pColMatch->targetSlotId) {
+        required = true;
+        break;
+      }
+    }
+
+    if (required) {
+      int16_t colId = pColMatch->colId;
+      taosArrayPush(pInfo->pFilterCols, &colId);
+      taosArrayPush(pInfo->pFilterColMatch, pColMatch);
+    } else {
+      taosArrayPush(pInfo->pDelayedColMatch, pColMatch);
+    }
+  }
+
+  taosArrayDestroy(pSlotIds);
+
+  // all the columns are required by the filter, nothing to delay
+  if (taosArrayGetSize(pInfo->pDelayedColMatch) == 0) {
+    pInfo->pFilterCols = taosArrayDestroy(pInfo->pFilterCols);
+    pInfo->pFilterColMatch = taosArrayDestroy(pInfo->pFilterColMatch);
+    pInfo->pDelayedColMatch = taosArrayDestroy(pInfo->pDelayedColMatch);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode, SReadHandle* readHandle,
                                            SExecTaskInfo* pTaskInfo) {
   STableScanInfo* pInfo = taosMemoryCalloc(1, sizeof(STableScanInfo));
@@ -751,6 +1335,13 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
   pInfo->pColMatchInfo = pColList;
   pInfo->currentGroupId = -1;
   pInfo->assignBlockUid = pTableScanNode->assignBlockUid;
+  pInfo->parallelism = pTableScanNode->parallelism;
+  initLimitInfo(pTableScanNode->scan.node.pLimit, NULL, &pInfo->limitInfo);
+
+  code = initDelayedColumnLoad(pInfo);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
 
   pOperator->name = "TableScanOperator";  // for debug purpose
   pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN;
@@ -2849,6 +3440,58 @@ _error:
   return NULL;
 }
 
+// without tbname in the output, the tag values of a whole batch of tables are copied from the columnar tag cache
+static bool doTagScanFromCache(SOperatorInfo* pOperator) {
+  STagScanInfo* pInfo = pOperator->info;
+  SExprInfo*    pExprInfo = &pOperator->exprSupp.pExprInfo[0];
+  SSDataBlock*  pRes = pInfo->pRes;
+  uint64_t      suid = pInfo->pTableList->suid;
+  int32_t       size = taosArrayGetSize(pInfo->pTableList->pTableList);
+  int32_t       count = TMIN(size - pInfo->curPos, pOperator->resultInfo.capacity);
+  bool          cached = true;
+
+  if (suid == 0 || count <= 0) {
+    return false;
+  }
+  for (int32_t j = 0; j < pOperator->exprSupp.numOfExprs; ++j) {
+    if (fmIsScanPseudoColumnFunc(pExprInfo[j].pExpr->_function.functionId)) {
+      return false;
+    }
+  }
+
+  SArray* uidList = taosArrayInit(count, sizeof(uint64_t));
+  if (uidList == NULL) {
+    return false;
+  }
+  for (int32_t i = 0; i < count; ++i) {
+    STableKeyInfo* item = taosArrayGet(pInfo->pTableList->pTableList, pInfo->curPos + i);
+    taosArrayPush(uidList, &item->uid);
+  }
+
+  blockDataCleanup(pRes);
+  for (int32_t j = 0; j < pOperator->exprSupp.numOfExprs; ++j) {
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pExprInfo[j].base.resSchema.slotId);
+    int16_t          cid = pExprInfo[j].base.pParam[0].pCol->colId;
+    if (metaGetTagCacheCol(pInfo->readHandle.meta, suid, uidList, cid, pDst) != TSDB_CODE_SUCCESS) {
+      cached = false;
+      break;
+    }
+  }
+  taosArrayDestroy(uidList);
+
+  if (!cached) {
+    blockDataCleanup(pRes);
+    return false;
+  }
+
+  pInfo->curPos += count;
+  if (pInfo->curPos >= size) {
+    doSetOperatorCompleted(pOperator);
+  }
+  pRes->info.rows = count;
+  return true;
+}
+
 static SSDataBlock* doTagScan(SOperatorInfo* pOperator) {
   if (pOperator->status == OP_EXEC_DONE) {
     return NULL;
@@ -2866,6 +3509,14 @@ static SSDataBlock* doTagScan(SOperatorInfo* pOperator) {
     return NULL;
   }
 
+  if (doTagScanFromCache(pOperator)) {
+    if (pOperator->status == OP_EXEC_DONE) {
+      setTaskStatus(pTaskInfo, TASK_COMPLETED);
+    }
+    pOperator->resultInfo.totalRows += pRes->info.rows;
+    return pRes;
+  }
+
   char        str[512] = {0};
   int32_t     count = 0;
   SMetaReader mr = {0};
@@ -3378,6 +4029,12 @@ SSDataBlock* doTableMergeScan(SOperatorInfo* pOperator) {
     if (pBlock != NULL) {
       pBlock->info.groupId = pInfo->groupId;
       pOperator->resultInfo.totalRows += pBlock->info.rows;
+      if (pInfo->limitInfo.limit.limit >= 0) {
+        pBlock = applyScanLimit(pOperator, &pInfo->limitInfo, pBlock);
+        if (pOperator->status == OP_EXEC_DONE) {
+          stopGroupTableMergeScan(pOperator);
+        }
+      }
       return pBlock;
     } else {
       stopGroupTableMergeScan(pOperator);
@@ -3489,6 +4146,7 @@ SOperatorInfo* createTableMergeScanOperatorInfo(STableScanPhysiNode* pTableScanN
   pInfo->tableListInfo = pTableListInfo;
   pInfo->scanFlag = MAIN_SCAN;
   pInfo->pColMatchInfo = pColList;
+  initLimitInfo(pTableScanNode->scan.node.pLimit, NULL, &pInfo->limitInfo);
 
   pInfo->pResBlock = createResDataBlock(pDescNode);
   pInfo->sortSourceParams = taosArrayInit(64, sizeof(STableMergeScanSortSourceParam));
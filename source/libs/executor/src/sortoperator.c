@@ -14,6 +14,7 @@
  */
 
 #include "executorimpl.h"
+#include "tcompare.h"
 #include "tdatablock.h"
 
 static SSDataBlock* doSort(SOperatorInfo* pOperator);
@@ -22,8 +23,15 @@ static int32_t      getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain
 
 static void destroyOrderOperatorInfo(void* param);
 
-// todo add limit/offset impl
+static bool           isTopNSort(const SSortPhysiNode* pSortNode);
+static SOperatorInfo* createTopNOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode,
+                                             SExecTaskInfo* pTaskInfo);
+
 SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode, SExecTaskInfo* pTaskInfo) {
+  if (isTopNSort(pSortNode)) {
+    return createTopNOperatorInfo(downstream, pSortNode, pTaskInfo);
+  }
+
   SSortOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SSortOperatorInfo));
   SOperatorInfo*     pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
   if (pInfo == NULL || pOperator == NULL) {
@@ -272,6 +280,361 @@ int32_t getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain, uint32_t*
   return TSDB_CODE_SUCCESS;
 }
 
+//=====================================================================================
+// TopN Operator
+// the sort with a small limit keeps the first 'limit + offset' rows in a bounded heap, instead of sorting all rows
+#define TOPN_MAX_ROWS 65536
+
+typedef struct STopNOperatorInfo {
+  SOptrBasicInfo binfo;
+  SArray*        pSortInfo;
+  SArray*        pColMatchInfo;
+  int64_t        limit;
+  int64_t        offset;
+  int32_t        numOfCandidates;  // limit + offset
+  SSDataBlock*   pCandidates;      // the rows that are kept so far, in the order of insertion
+  int32_t*       pHeap;            // row index in pCandidates, the last row in the sort order is at the top
+  bool           hasVarCol;
+  int32_t        numOfReplaced;    // the var data of the replaced rows is not released until the block is compacted
+  int32_t        outputIndex;
+  int64_t        startTs;
+} STopNOperatorInfo;
+
+static bool isTopNSort(const SSortPhysiNode* pSortNode) {
+  SLimitNode* pLimit = (SLimitNode*)pSortNode->node.pLimit;
+  if (NULL == pLimit || pLimit->limit <= 0 || NULL != pSortNode->node.pSlimit || NULL != pSortNode->node.pConditions) {
+    return false;
+  }
+
+  return pLimit->limit + TMAX(pLimit->offset, 0) <= TOPN_MAX_ROWS;
+}
+
+// compare two rows of blocks that have the same schema, the same as dataBlockCompar
+static int32_t topNCompareRow(SArray* pSortInfo, SSDataBlock* pLeft, int32_t left, SSDataBlock* pRight, int32_t right,
+                              SExecTaskInfo* pTaskInfo) {
+  for (int32_t i = 0; i < taosArrayGetSize(pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pSortInfo, i);
+    SColumnInfoData* pLeftCol = taosArrayGet(pLeft->pDataBlock, pOrder->slotId);
+    SColumnInfoData* pRightCol = taosArrayGet(pRight->pDataBlock, pOrder->slotId);
+
+    bool leftNull = colDataIsNull_s(pLeftCol, left);
+    bool rightNull = colDataIsNull_s(pRightCol, right);
+    if (leftNull && rightNull) {
+      continue;
+    }
+
+    if (rightNull) {
+      return pOrder->nullFirst ? 1 : -1;
+    }
+
+    if (leftNull) {
+      return pOrder->nullFirst ? -1 : 1;
+    }
+
+    void* left1 = colDataGetData(pLeftCol, left);
+    void* right1 = colDataGetData(pRightCol, right);
+    if (pLeftCol->info.type == TSDB_DATA_TYPE_JSON && (tTagIsJson(left1) || tTagIsJson(right1))) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_JSON_NOT_SUPPORT_ERROR);
+    }
+
+    __compar_fn_t fn = getKeyComparFunc(pLeftCol->info.type, pOrder->order);
+
+    int32_t ret = fn(left1, right1);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  return 0;
+}
+
+static void topNSiftUp(STopNOperatorInfo* pInfo, int32_t pos, SExecTaskInfo* pTaskInfo) {
+  int32_t* pHeap = pInfo->pHeap;
+  int32_t  rowIndex = pHeap[pos];
+  while (pos > 0) {
+    int32_t parent = (pos - 1) >> 1;
+    if (topNCompareRow(pInfo->pSortInfo, pInfo->pCandidates, rowIndex, pInfo->pCandidates, pHeap[parent], pTaskInfo) <=
+        0) {
+      break;
+    }
+    pHeap[pos] = pHeap[parent];
+    pos = parent;
+  }
+  pHeap[pos] = rowIndex;
+}
+
+static void topNSiftDown(STopNOperatorInfo* pInfo, int32_t num, SExecTaskInfo* pTaskInfo) {
+  int32_t* pHeap = pInfo->pHeap;
+  int32_t  rowIndex = pHeap[0];
+  int32_t  pos = 0;
+  while (1) {
+    int32_t child = (pos << 1) + 1;
+    if (child >= num) {
+      break;
+    }
+
+    if (child + 1 < num && topNCompareRow(pInfo->pSortInfo, pInfo->pCandidates, pHeap[child + 1], pInfo->pCandidates,
+                                          pHeap[child], pTaskInfo) > 0) {
+      child += 1;
+    }
+
+    if (topNCompareRow(pInfo->pSortInfo, pInfo->pCandidates, pHeap[child], pInfo->pCandidates, rowIndex, pTaskInfo) <=
+        0) {
+      break;
+    }
+    pHeap[pos] = pHeap[child];
+    pos = child;
+  }
+  pHeap[pos] = rowIndex;
+}
+
+static void topNCopyRow(SSDataBlock* pDst, int32_t dstIndex, SSDataBlock* pSrc, int32_t srcIndex,
+                        SExecTaskInfo* pTaskInfo) {
+  int32_t numOfCols = taosArrayGetSize(pDst->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    if (colDataIsNull_s(pSrcCol, srcIndex)) {
+      colDataAppendNULL(pDstCol, dstIndex);
+      continue;
+    }
+
+    int32_t code = colDataAppend(pDstCol, dstIndex, colDataGetData(pSrcCol, srcIndex), false);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    // the slot may be reused by a row that used to be NULL
+    if (!IS_VAR_DATA_TYPE(pDstCol->info.type)) {
+      colDataSetNotNull_f(pDstCol->nullbitmap, dstIndex);
+    }
+  }
+}
+
+// the replaced var data is appended to the end of the column, copy the live rows into a new block once the garbage
+// may be as large as the live data
+static void topNCompactCandidates(STopNOperatorInfo* pInfo, SExecTaskInfo* pTaskInfo) {
+  SSDataBlock* pBlock = blockDataExtractBlock(pInfo->pCandidates, 0, pInfo->pCandidates->info.rows);
+  if (pBlock == NULL || blockDataEnsureCapacity(pBlock, pInfo->numOfCandidates) != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pBlock);
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  blockDataDestroy(pInfo->pCandidates);
+  pInfo->pCandidates = pBlock;
+  pInfo->numOfReplaced = 0;
+}
+
+static void topNAddBlock(STopNOperatorInfo* pInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
+  if (pInfo->pCandidates == NULL) {
+    pInfo->pCandidates = createOneDataBlock(pBlock, false);
+    if (pInfo->pCandidates == NULL ||
+        blockDataEnsureCapacity(pInfo->pCandidates, pInfo->numOfCandidates) != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+
+    for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+      pInfo->hasVarCol |= IS_VAR_DATA_TYPE(pCol->info.type);
+    }
+  }
+
+  SSDataBlock* pCandidates = pInfo->pCandidates;
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int32_t num = pCandidates->info.rows;
+    if (num < pInfo->numOfCandidates) {
+      topNCopyRow(pCandidates, num, pBlock, i, pTaskInfo);
+      pCandidates->info.rows += 1;
+      pInfo->pHeap[num] = num;
+      topNSiftUp(pInfo, num, pTaskInfo);
+      continue;
+    }
+
+    // most rows are dropped here once the heap is filled with good candidates
+    if (topNCompareRow(pInfo->pSortInfo, pBlock, i, pCandidates, pInfo->pHeap[0], pTaskInfo) >= 0) {
+      continue;
+    }
+
+    topNCopyRow(pCandidates, pInfo->pHeap[0], pBlock, i, pTaskInfo);
+    topNSiftDown(pInfo, num, pTaskInfo);
+
+    if (pInfo->hasVarCol && (++pInfo->numOfReplaced) >= pInfo->numOfCandidates) {
+      topNCompactCandidates(pInfo, pTaskInfo);
+      pCandidates = pInfo->pCandidates;
+    }
+  }
+}
+
+static int32_t doOpenTopNOperator(SOperatorInfo* pOperator) {
+  STopNOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*     pTaskInfo = pOperator->pTaskInfo;
+
+  if (OPTR_IS_OPENED(pOperator)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pInfo->startTs = taosGetTimestampUs();
+
+  SOperatorInfo* downstream = pOperator->pDownstream[0];
+  while (1) {
+    SSDataBlock* pBlock = downstream->fpSet.getNextFn(downstream);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    applyScalarFunction(pBlock, pOperator);
+    topNAddBlock(pInfo, pBlock, pTaskInfo);
+  }
+
+  if (pInfo->pCandidates != NULL) {
+    int32_t code = blockDataSort(pInfo->pCandidates, pInfo->pSortInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+  }
+
+  pInfo->outputIndex = pInfo->offset;
+
+  pOperator->cost.openCost = (taosGetTimestampUs() - pInfo->startTs) / 1000.0;
+  pOperator->status = OP_RES_TO_RETURN;
+
+  OPTR_SET_OPENED(pOperator);
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* doTopN(SOperatorInfo* pOperator) {
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  SExecTaskInfo*     pTaskInfo = pOperator->pTaskInfo;
+  STopNOperatorInfo* pInfo = pOperator->info;
+
+  int32_t code = pOperator->fpSet._openFn(pOperator);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  int32_t numOfRows = (pInfo->pCandidates == NULL) ? 0 : pInfo->pCandidates->info.rows;
+  int32_t rows = TMIN(numOfRows - pInfo->outputIndex, pOperator->resultInfo.capacity);
+  if (rows <= 0) {
+    doSetOperatorCompleted(pOperator);
+    return NULL;
+  }
+
+  SSDataBlock* p = blockDataExtractBlock(pInfo->pCandidates, pInfo->outputIndex, rows);
+  if (p == NULL) {
+    T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  SSDataBlock* pRes = pInfo->binfo.pRes;
+  blockDataCleanup(pRes);
+  blockDataEnsureCapacity(pRes, rows);
+
+  int32_t numOfCols = taosArrayGetSize(pInfo->pColMatchInfo);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColMatchInfo* pmInfo = taosArrayGet(pInfo->pColMatchInfo, i);
+    ASSERT(pmInfo->matchType == COL_MATCH_FROM_SLOT_ID);
+
+    SColumnInfoData* pSrc = taosArrayGet(p->pDataBlock, pmInfo->srcSlotId);
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pmInfo->targetSlotId);
+    colDataAssign(pDst, pSrc, rows, &pRes->info);
+  }
+
+  pRes->info.rows = rows;
+  blockDataDestroy(p);
+
+  pInfo->outputIndex += rows;
+  pOperator->resultInfo.totalRows += rows;
+  return pRes;
+}
+
+static void destroyTopNOperatorInfo(void* param) {
+  STopNOperatorInfo* pInfo = (STopNOperatorInfo*)param;
+  pInfo->binfo.pRes = blockDataDestroy(pInfo->binfo.pRes);
+  pInfo->pCandidates = blockDataDestroy(pInfo->pCandidates);
+
+  taosMemoryFree(pInfo->pHeap);
+  taosArrayDestroy(pInfo->pSortInfo);
+  taosArrayDestroy(pInfo->pColMatchInfo);
+  taosMemoryFreeClear(param);
+}
+
+static int32_t getTopNExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain, uint32_t* len) {
+  ASSERT(pOptr != NULL);
+  SSortExecInfo* pInfo = taosMemoryCalloc(1, sizeof(SSortExecInfo));
+
+  STopNOperatorInfo* pOperatorInfo = (STopNOperatorInfo*)pOptr->info;
+
+  pInfo->sortMethod = SORT_QSORT_T;
+  pInfo->sortBuffer = (pOperatorInfo->pCandidates == NULL) ? 0 : blockDataGetSize(pOperatorInfo->pCandidates);
+  *pOptrExplain = pInfo;
+  *len = sizeof(SSortExecInfo);
+  return TSDB_CODE_SUCCESS;
+}
+
+static SOperatorInfo* createTopNOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode,
+                                             SExecTaskInfo* pTaskInfo) {
+  STopNOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(STopNOperatorInfo));
+  SOperatorInfo*     pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  if (pInfo == NULL || pOperator == NULL) {
+    goto _error;
+  }
+
+  SLimitNode* pLimit = (SLimitNode*)pSortNode->node.pLimit;
+  pInfo->limit = pLimit->limit;
+  pInfo->offset = TMAX(pLimit->offset, 0);
+  pInfo->numOfCandidates = pInfo->limit + pInfo->offset;
+  pInfo->pHeap = taosMemoryMalloc(pInfo->numOfCandidates * sizeof(int32_t));
+  if (pInfo->pHeap == NULL) {
+    goto _error;
+  }
+
+  pOperator->pTaskInfo = pTaskInfo;
+  SDataBlockDescNode* pDescNode = pSortNode->node.pOutputDataBlockDesc;
+
+  int32_t      numOfCols = 0;
+  SSDataBlock* pResBlock = createResDataBlock(pDescNode);
+  SExprInfo*   pExprInfo = createExprInfo(pSortNode->pExprs, NULL, &numOfCols);
+
+  int32_t numOfOutputCols = 0;
+  pInfo->pColMatchInfo = extractColMatchInfo(pSortNode->pTargets, pDescNode, &numOfOutputCols, COL_MATCH_FROM_SLOT_ID);
+
+  pOperator->exprSupp.pCtx = createSqlFunctionCtx(pExprInfo, numOfCols, &pOperator->exprSupp.rowEntryInfoOffset);
+
+  initResultSizeInfo(&pOperator->resultInfo, 1024);
+
+  pInfo->binfo.pRes = pResBlock;
+  pInfo->pSortInfo = createSortInfo(pSortNode->pSortKeys);
+
+  pOperator->name = "TopNOperator";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_SORT;
+  pOperator->blocking = true;
+  pOperator->status = OP_NOT_OPENED;
+  pOperator->info = pInfo;
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+
+  pOperator->fpSet = createOperatorFpSet(doOpenTopNOperator, doTopN, NULL, NULL, destroyTopNOperatorInfo, NULL, NULL,
+                                         getTopNExplainExecInfo);
+
+  int32_t code = appendDownstream(pOperator, &downstream, 1);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  pTaskInfo->code = TSDB_CODE_OUT_OF_MEMORY;
+  if (pInfo != NULL) {
+    taosMemoryFree(pInfo->pHeap);
+  }
+  taosMemoryFree(pInfo);
+  taosMemoryFree(pOperator);
+  return NULL;
+}
+
 //=====================================================================================
 // Group Sort Operator
 typedef enum EChildOperatorStatus { CHILD_OP_NEW_GROUP, CHILD_OP_SAME_GROUP, CHILD_OP_FINISHED } EChildOperatorStatus;
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tgrouphash.h"
+#include "taoserror.h"
+#include "thash.h"
+#include "tlog.h"
+
+#define GHASH_MAX_CAPACITY    (1u << 30)
+#define GHASH_PREFETCH_WINDOW 16
+
+// a slot keeps the upper 32 bits of the hash value and the entry index plus one, an empty slot is zero
+#define GHASH_TAG(_h)             ((_h)&0xFFFFFFFF00000000ULL)
+#define GHASH_SLOT(_h, _i)        (GHASH_TAG(_h) | (uint64_t)((_i) + 1))
+#define GHASH_SLOT_INDEX(_s)      ((int32_t)(((_s)&0xFFFFFFFFULL) - 1))
+#define GHASH_NEED_RESIZE(_h, _n) ((int64_t)((_h)->size + (_n)) * 2 > (_h)->capacity)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GHASH_PREFETCH(_p) __builtin_prefetch((_p))
+#else
+#define GHASH_PREFETCH(_p)
+#endif
+
+typedef struct SGroupHashEntry {
+  uint64_t hash;
+  int32_t  keyLen;
+  int32_t  reserved;
+} SGroupHashEntry;
+
+struct SGroupHashObj {
+  uint64_t *pSlots;
+  int32_t   capacity;   // number of slots, always a power of 2
+  int32_t   size;       // number of entries
+  char     *pEntries;
+  int32_t   entryCap;   // number of allocated entries
+  int32_t   entrySize;  // header + payload + key, or the offset of the key in pKeyBuf
+  int32_t   dataLen;
+  int32_t   maxKeyLen;
+  bool      inlineKey;
+  char     *pKeyBuf;  // keys longer than GROUP_HASH_MAX_INLINE_KEY
+  int64_t   keyBufLen;
+  int64_t   keyBufCap;
+};
+
+#define GET_GHASH_ENTRY(_h, _i) ((SGroupHashEntry *)((_h)->pEntries + (int64_t)(_i) * (_h)->entrySize))
+#define GET_GHASH_DATA(_e)      ((char *)(_e) + sizeof(SGroupHashEntry))
+
+static FORCE_INLINE char *getEntryKey(const SGroupHashObj *pHashObj, SGroupHashEntry *pEntry) {
+  char *p = GET_GHASH_DATA(pEntry) + pHashObj->dataLen;
+  return pHashObj->inlineKey ? p : pHashObj->pKeyBuf + *(int64_t *)p;
+}
+
+static int32_t groupHashCapacity(int32_t length) {
+  uint32_t len = (length < GHASH_MAX_CAPACITY ? length : GHASH_MAX_CAPACITY);
+
+  uint32_t i = 16;
+  while (i < len) i = (i << 1u);
+  return (int32_t)i;
+}
+
+SGroupHashObj *tGroupHashInit(int32_t capacity, int32_t maxKeyLen, int32_t dataLen) {
+  SGroupHashObj *pHashObj = (SGroupHashObj *)taosMemoryCalloc(1, sizeof(SGroupHashObj));
+  if (pHashObj == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pHashObj->capacity = groupHashCapacity(capacity * 2);
+  pHashObj->maxKeyLen = maxKeyLen;
+  pHashObj->dataLen = ALIGN8(dataLen);
+  pHashObj->inlineKey = (maxKeyLen <= GROUP_HASH_MAX_INLINE_KEY);
+  pHashObj->entrySize = sizeof(SGroupHashEntry) + pHashObj->dataLen +
+                        (pHashObj->inlineKey ? ALIGN8(maxKeyLen) : (int32_t)sizeof(int64_t));
+
+  pHashObj->pSlots = taosMemoryCalloc(pHashObj->capacity, sizeof(uint64_t));
+  if (pHashObj->pSlots == NULL) {
+    taosMemoryFree(pHashObj);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  return pHashObj;
+}
+
+void tGroupHashCleanup(SGroupHashObj *pHashObj) {
+  if (pHashObj == NULL) {
+    return;
+  }
+
+  taosMemoryFree(pHashObj->pSlots);
+  taosMemoryFree(pHashObj->pEntries);
+  taosMemoryFree(pHashObj->pKeyBuf);
+  taosMemoryFree(pHashObj);
+}
+
+void tGroupHashClear(SGroupHashObj *pHashObj) {
+  if (pHashObj == NULL || pHashObj->size == 0) {
+    return;
+  }
+
+  memset(pHashObj->pSlots, 0, sizeof(uint64_t) * pHashObj->capacity);
+  pHashObj->size = 0;
+  pHashObj->keyBufLen = 0;
+}
+
+int32_t tGroupHashGetSize(const SGroupHashObj *pHashObj) { return (pHashObj == NULL) ? 0 : pHashObj->size; }
+
+uint64_t tGroupHashCalc(const void *key, int32_t keyLen) { return MurmurHash3_64(key, keyLen); }
+
+static int32_t groupHashResize(SGroupHashObj *pHashObj, int32_t num) {
+  int32_t newCapacity = groupHashCapacity((pHashObj->size + num) * 2);
+  if (newCapacity <= pHashObj->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  uint64_t *pSlots = taosMemoryCalloc(newCapacity, sizeof(uint64_t));
+  if (pSlots == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the hash value is kept in the entry, no need to calculate it again
+  uint32_t mask = newCapacity - 1;
+  for (int32_t i = 0; i < pHashObj->size; ++i) {
+    uint64_t hash = GET_GHASH_ENTRY(pHashObj, i)->hash;
+    uint32_t pos = hash & mask;
+    while (pSlots[pos] != 0) {
+      pos = (pos + 1) & mask;
+    }
+    pSlots[pos] = GHASH_SLOT(hash, i);
+  }
+
+  taosMemoryFree(pHashObj->pSlots);
+  pHashObj->pSlots = pSlots;
+  pHashObj->capacity = newCapacity;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t groupHashAppend(SGroupHashObj *pHashObj, const void *key, int32_t keyLen, uint64_t hash) {
+  ASSERT(keyLen <= pHashObj->maxKeyLen);
+
+  if (pHashObj->size >= pHashObj->entryCap) {
+    int32_t newCap = (pHashObj->entryCap == 0) ? 64 : pHashObj->entryCap * 2;
+    char   *p = taosMemoryRealloc(pHashObj->pEntries, (int64_t)newCap * pHashObj->entrySize);
+    if (p == NULL) {
+      return -1;
+    }
+    pHashObj->pEntries = p;
+    pHashObj->entryCap = newCap;
+  }
+
+  int32_t          index = pHashObj->size;
+  SGroupHashEntry *pEntry = GET_GHASH_ENTRY(pHashObj, index);
+  pEntry->hash = hash;
+  pEntry->keyLen = keyLen;
+  pEntry->reserved = 0;
+  memset(GET_GHASH_DATA(pEntry), 0, pHashObj->dataLen);
+
+  char *pKey = GET_GHASH_DATA(pEntry) + pHashObj->dataLen;
+  if (pHashObj->inlineKey) {
+    memcpy(pKey, key, keyLen);
+  } else {
+    if (pHashObj->keyBufLen + keyLen > pHashObj->keyBufCap) {
+      int64_t newCap = TMAX(pHashObj->keyBufCap * 2, pHashObj->keyBufLen + keyLen + 4096);
+      char   *p = taosMemoryRealloc(pHashObj->pKeyBuf, newCap);
+      if (p == NULL) {
+        return -1;
+      }
+      pHashObj->pKeyBuf = p;
+      pHashObj->keyBufCap = newCap;
+    }
+
+    memcpy(pHashObj->pKeyBuf + pHashObj->keyBufLen, key, keyLen);
+    *(int64_t *)pKey = pHashObj->keyBufLen;
+    pHashObj->keyBufLen += keyLen;
+  }
+
+  pHashObj->size += 1;
+  return index;
+}
+
+// return the entry index of the key, or -1 with the empty slot where the key should be put in pPos, the caller
+// guarantees that there is at least one empty slot
+static FORCE_INLINE int32_t groupHashFind(const SGroupHashObj *pHashObj, const void *key, int32_t keyLen,
+                                          uint64_t hash, uint32_t *pPos) {
+  uint32_t mask = pHashObj->capacity - 1;
+  uint32_t pos = hash & mask;
+  uint64_t tag = GHASH_TAG(hash);
+
+  while (1) {
+    uint64_t slot = pHashObj->pSlots[pos];
+    if (slot == 0) {
+      break;
+    }
+
+    if (GHASH_TAG(slot) == tag) {
+      int32_t          index = GHASH_SLOT_INDEX(slot);
+      SGroupHashEntry *pEntry = GET_GHASH_ENTRY(pHashObj, index);
+      if (pEntry->hash == hash && pEntry->keyLen == keyLen && memcmp(getEntryKey(pHashObj, pEntry), key, keyLen) == 0) {
+        return index;
+      }
+    }
+
+    pos = (pos + 1) & mask;
+  }
+
+  *pPos = pos;
+  return -1;
+}
+
+static FORCE_INLINE int32_t groupHashProbe(SGroupHashObj *pHashObj, const void *key, int32_t keyLen, uint64_t hash,
+                                           bool *pNew) {
+  uint32_t pos = 0;
+  int32_t  index = groupHashFind(pHashObj, key, keyLen, hash, &pos);
+  if (index >= 0) {
+    *pNew = false;
+    return index;
+  }
+
+  index = groupHashAppend(pHashObj, key, keyLen, hash);
+  if (index < 0) {
+    return -1;
+  }
+
+  pHashObj->pSlots[pos] = GHASH_SLOT(hash, index);
+  *pNew = true;
+  return index;
+}
+
+int32_t tGroupHashPut(SGroupHashObj *pHashObj, const void *key, int32_t keyLen, uint64_t hash, bool *pNew) {
+  if (GHASH_NEED_RESIZE(pHashObj, 1)) {
+    if (groupHashResize(pHashObj, 1) != TSDB_CODE_SUCCESS) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  int32_t index = groupHashProbe(pHashObj, key, keyLen, hash, pNew);
+  if (index < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return index;
+}
+
+int32_t tGroupHashBatchPut(SGroupHashObj *pHashObj, const char *pKeys, int32_t keyLen, const uint64_t *pHashes,
+                           int32_t num, int32_t *pIndex) {
+  // reserve the slots for the whole batch up front, so that the prefetched slots stay where they are
+  if (GHASH_NEED_RESIZE(pHashObj, num)) {
+    if (groupHashResize(pHashObj, num) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  uint32_t mask = pHashObj->capacity - 1;
+  for (int32_t i = 0; i < num && i < GHASH_PREFETCH_WINDOW; ++i) {
+    GHASH_PREFETCH(&pHashObj->pSlots[pHashes[i] & mask]);
+  }
+
+  bool isNew = false;
+  for (int32_t i = 0; i < num; ++i) {
+    if (i + GHASH_PREFETCH_WINDOW < num) {
+      GHASH_PREFETCH(&pHashObj->pSlots[pHashes[i + GHASH_PREFETCH_WINDOW] & mask]);
+    }
+
+    pIndex[i] = groupHashProbe(pHashObj, pKeys + (int64_t)i * keyLen, keyLen, pHashes[i], &isNew);
+    if (pIndex[i] < 0) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t tGroupHashGet(const SGroupHashObj *pHashObj, const void *key, int32_t keyLen, uint64_t hash) {
+  if (pHashObj->size == 0) {
+    return -1;
+  }
+
+  uint32_t pos = 0;
+  return groupHashFind(pHashObj, key, keyLen, hash, &pos);
+}
+
+void *tGroupHashGetData(const SGroupHashObj *pHashObj, int32_t index) {
+  ASSERT(index >= 0 && index < pHashObj->size);
+  return GET_GHASH_DATA(GET_GHASH_ENTRY(pHashObj, index));
+}
+
+void *tGroupHashGetKey(const SGroupHashObj *pHashObj, int32_t index, int32_t *keyLen) {
+  ASSERT(index >= 0 && index < pHashObj->size);
+  SGroupHashEntry *pEntry = GET_GHASH_ENTRY(pHashObj, index);
+  if (keyLen != NULL) {
+    *keyLen = pEntry->keyLen;
+  }
+
+  return getEntryKey(pHashObj, pEntry);
+}
@@ -126,6 +126,12 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
     taosMemoryFreeClear(*pSource);
   }
   taosArrayDestroy(pSortHandle->pOrderedSource);
+
+  for (size_t i = 0; i < taosArrayGetSize(pSortHandle->cmpParam.pSourceKeys); i++) {
+    SSortSourceKeys* pKeys = taosArrayGet(pSortHandle->cmpParam.pSourceKeys, i);
+    taosMemoryFreeClear(pKeys->pKeys);
+  }
+  taosArrayDestroy(pSortHandle->cmpParam.pSourceKeys);
   taosMemoryFreeClear(pSortHandle);
 }
 
@@ -211,6 +217,78 @@ static void setCurrentSourceIsDone(SSortSource* pSource, SSortHandle* pHandle) {
   ++pHandle->numOfCompletedSources;
 }
 
+// encode the sort keys of the current block of a source, so that most comparisons in the loser tree are a memcmp
+static int32_t sortComparEncodeKeys(SMsortComparParam* cmpParam, int32_t index) {
+  SSortSource* pSource = cmpParam->pSources[index];
+  int32_t      keyLen = cmpParam->sortKey.keyLen;
+  if (keyLen == 0 || pSource->src.rowIndex == -1 || pSource->src.pBlock == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SSortSourceKeys* pKeys = taosArrayGet(cmpParam->pSourceKeys, index);
+  int32_t          rows = pSource->src.pBlock->info.rows;
+  if (rows > pKeys->capacity) {
+    char* p = taosMemoryRealloc(pKeys->pKeys, rows * keyLen);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pKeys->pKeys = p;
+    pKeys->capacity = rows;
+  }
+
+  blockDataEncodeSortKeys(pSource->src.pBlock, cmpParam->orderInfo, &cmpParam->sortKey, pKeys->pKeys, keyLen);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t sortComparInitKeys(SMsortComparParam* cmpParam) {
+  cmpParam->sortKey.keyLen = 0;
+
+  // the key layout only depends on the schema, which is the same for all sources
+  SSDataBlock* pBlock = NULL;
+  for (int32_t i = 0; i < cmpParam->numOfSources && pBlock == NULL; ++i) {
+    SSortSource* pSource = cmpParam->pSources[i];
+    if (pSource->src.rowIndex != -1) {
+      pBlock = pSource->src.pBlock;
+    }
+  }
+
+  if (pBlock == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SBlockSortKey key = {0};
+  blockDataGetSortKey(pBlock, cmpParam->orderInfo, &key);
+  if (key.keyLen == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (cmpParam->pSourceKeys == NULL) {
+    cmpParam->pSourceKeys = taosArrayInit(cmpParam->numOfSources, sizeof(SSortSourceKeys));
+    if (cmpParam->pSourceKeys == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SSortSourceKeys empty = {0};
+  while (taosArrayGetSize(cmpParam->pSourceKeys) < cmpParam->numOfSources) {
+    if (taosArrayPush(cmpParam->pSourceKeys, &empty) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  cmpParam->sortKey = key;
+  for (int32_t i = 0; i < cmpParam->numOfSources; ++i) {
+    int32_t code = sortComparEncodeKeys(cmpParam, i);
+    if (code != TSDB_CODE_SUCCESS) {
+      cmpParam->sortKey.keyLen = 0;
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t sortComparInit(SMsortComparParam* cmpParam, SArray* pSources, int32_t startIndex, int32_t endIndex, SSortHandle* pHandle) {
   cmpParam->pSources  = taosArrayGet(pSources, startIndex);
   cmpParam->numOfSources = (endIndex - startIndex + 1);
@@ -264,7 +342,7 @@ static int32_t sortComparInit(SMsortComparParam* cmpParam, SArray* pSources, int
     }
   }
 
-  return code;
+  return sortComparInitKeys(cmpParam);
 }
 
 static void appendOneRowToDataBlock(SSDataBlock *pBlock, const SSDataBlock* pSource, int32_t* rowIndex) {
@@ -292,6 +370,8 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource *pSource, SMultiwayMergeT
    * since it's last record in buffer has been chosen to be processed, as the winner of loser-tree
    */
   if (pSource->src.rowIndex >= pSource->src.pBlock->info.rows) {
+    int32_t code = TSDB_CODE_SUCCESS;
+
     pSource->src.rowIndex = 0;
 
     if (pHandle->type == SORT_SINGLESOURCE_SORT) {
@@ -305,7 +385,7 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource *pSource, SMultiwayMergeT
         int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex);
 
         void* pPage = getBufPage(pHandle->pBuf, *pPgId);
-        int32_t    code = blockDataFromBuf(pSource->src.pBlock, pPage);
+        code = blockDataFromBuf(pSource->src.pBlock, pPage);
         if (code != TSDB_CODE_SUCCESS) {
           return code;
         }
@@ -319,6 +399,11 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource *pSource, SMultiwayMergeT
         pSource->src.rowIndex = -1;
       }
     }
+
+    code = sortComparEncodeKeys(&pHandle->cmpParam, tMergeTreeGetChosenIndex(pTree));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
   /*
@@ -397,6 +482,23 @@ int32_t msortComparFn(const void *pLeft, const void *pRight, void *param) {
     }
   }
 
+  // the columns are only compared one by one if the normalized keys are equal but not exact
+  int32_t keyLen = pParam->sortKey.keyLen;
+  if (keyLen > 0) {
+    SSortSourceKeys* pLeftKeys = TARRAY_GET_ELEM(pParam->pSourceKeys, pLeftIdx);
+    SSortSourceKeys* pRightKeys = TARRAY_GET_ELEM(pParam->pSourceKeys, pRightIdx);
+
+    int32_t ret = memcmp(pLeftKeys->pKeys + pLeftSource->src.rowIndex * keyLen,
+                         pRightKeys->pKeys + pRightSource->src.rowIndex * keyLen, keyLen);
+    if (ret != 0) {
+      return ret < 0 ? -1 : 1;
+    }
+
+    if (pParam->sortKey.exact) {
+      return 0;
+    }
+  }
+
   for(int32_t i = 0; i < pInfo->size; ++i) {
     SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pInfo, i);
     SColumnInfoData* pLeftColInfoData = TARRAY_GET_ELEM(pLeftBlock->pDataBlock, pOrder->slotId);
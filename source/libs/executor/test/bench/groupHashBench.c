@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tgrouphash.h"
+#include "thash.h"
+#include "tsimplehash.h"
+#include "ttypes.h"
+
+// the groups of a bigint group by key, counted per group as the result rows of the group operator are
+static int64_t benchSimpleHash(SSHashObj *pHash, const int64_t *pKeys, int32_t numOfRows) {
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t *p = (int64_t *)tSimpleHashGet(pHash, &pKeys[i], sizeof(int64_t));
+    if (p == NULL) {
+      int64_t v = 0;
+      tSimpleHashPut(pHash, &pKeys[i], sizeof(int64_t), &v, sizeof(int64_t));
+      p = (int64_t *)tSimpleHashGet(pHash, &pKeys[i], sizeof(int64_t));
+    }
+    *p += 1;
+  }
+  return taosGetTimestampUs() - st;
+}
+
+static int64_t benchGroupHash(SGroupHashObj *pHash, const int64_t *pKeys, uint64_t *pHashes, int32_t *pIndex,
+                              int32_t numOfRows) {
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pHashes[i] = tGroupHashMix64(pKeys[i]);
+  }
+  tGroupHashBatchPut(pHash, (const char *)pKeys, sizeof(int64_t), pHashes, numOfRows, pIndex);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    *(int64_t *)tGroupHashGetData(pHash, pIndex[i]) += 1;
+  }
+  return taosGetTimestampUs() - st;
+}
+
+// both tables must hold the same groups with the same counts
+static bool checkGroups(SSHashObj *pSHash, SGroupHashObj *pGHash) {
+  if (tSimpleHashGetSize(pSHash) != tGroupHashGetSize(pGHash)) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < tGroupHashGetSize(pGHash); ++i) {
+    int64_t *pKey = (int64_t *)tGroupHashGetKey(pGHash, i, NULL);
+    int64_t *pCount = (int64_t *)tSimpleHashGet(pSHash, pKey, sizeof(int64_t));
+    if (pCount == NULL || *pCount != *(int64_t *)tGroupHashGetData(pGHash, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfRows = 4096;
+  int32_t numOfBlocks = 256;
+  int32_t numOfGroups = 0;
+  int32_t groups[] = {100, 10000, 100000, 500000};
+
+  for (int32_t i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      numOfRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i < argc - 1) {
+      numOfBlocks = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-g") == 0 && i < argc - 1) {
+      numOfGroups = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-r rows]: rows of a block, default is:%d\n", numOfRows);
+      printf("  [-b blocks]: blocks to group, default is:%d\n", numOfBlocks);
+      printf("  [-g groups]: distinct random keys, default is to run %d, %d, %d and %d\n", groups[0], groups[1],
+             groups[2], groups[3]);
+      exit(0);
+    }
+  }
+
+  int64_t  *pKeys = (int64_t *)taosMemoryCalloc(numOfRows, sizeof(int64_t));
+  uint64_t *pHashes = (uint64_t *)taosMemoryCalloc(numOfRows, sizeof(uint64_t));
+  int32_t  *pIndex = (int32_t *)taosMemoryCalloc(numOfRows, sizeof(int32_t));
+
+  printf("rows:%d blocks:%d, lookups in million rows/s\n", numOfRows, numOfBlocks);
+  printf("%-10s %10s %12s %12s %8s\n", "keys", "groups", "simple-hash", "group-hash", "speedup");
+
+  int32_t code = 0;
+  for (int32_t g = 0; g < tListLen(groups); ++g) {
+    int32_t keys = (numOfGroups > 0) ? numOfGroups : groups[g];
+
+    SSHashObj     *pSHash = tSimpleHashInit(4096, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT));
+    SGroupHashObj *pGHash = tGroupHashInit(4096, sizeof(int64_t), sizeof(int64_t));
+    int64_t        sHashElapsed = 0;
+    int64_t        gHashElapsed = 0;
+
+    taosSeedRand(1);
+    for (int32_t b = 0; b < numOfBlocks; ++b) {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        pKeys[i] = taosRand() % keys;
+      }
+
+      sHashElapsed += benchSimpleHash(pSHash, pKeys, numOfRows);
+      gHashElapsed += benchGroupHash(pGHash, pKeys, pHashes, pIndex, numOfRows);
+    }
+
+    if (!checkGroups(pSHash, pGHash)) {
+      printf("group mismatch, keys:%d\n", keys);
+      code = 1;
+    }
+
+    double total = (double)numOfRows * numOfBlocks;
+    printf("%-10d %10d %12.1f %12.1f %8.2f\n", keys, tGroupHashGetSize(pGHash), total / TMAX(sHashElapsed, 1),
+           total / TMAX(gHashElapsed, 1), (double)sHashElapsed / TMAX(gHashElapsed, 1));
+
+    tSimpleHashCleanup(pSHash);
+    tGroupHashCleanup(pGHash);
+    if (numOfGroups > 0) {
+      break;
+    }
+  }
+
+  taosMemoryFree(pKeys);
+  taosMemoryFree(pHashes);
+  taosMemoryFree(pIndex);
+  return code;
+}
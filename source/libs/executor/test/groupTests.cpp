@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "nodes.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+enum {
+  group_input_block = 1,
+  group_res_block = 2,
+};
+
+// rows i of the input: k bigint = the i-th key of a scrambled order of numOfGroups keys, NULL for every nullEvery-th
+// row, v bigint = i
+typedef struct SGroupInput {
+  int64_t      rows;
+  int64_t      numOfGroups;
+  int32_t      nullEvery;
+  int64_t      pos;
+  SSDataBlock* pBlock;
+} SGroupInput;
+
+// count(v), sum(v), min(v), max(v) of a group
+typedef struct SGroupAgg {
+  int64_t count;
+  int64_t sum;
+  int64_t min;
+  int64_t max;
+} SGroupAgg;
+
+// the NULL key of the reference result
+#define GROUP_NULL_KEY INT64_MIN
+
+typedef std::map<int64_t, SGroupAgg> SGroupResult;
+
+bool groupKeyIsNull(const SGroupInput* pInput, int64_t i) { return pInput->nullEvery > 0 && i % pInput->nullEvery == 0; }
+
+// the groups are visited in a scrambled order, so the rows of a group are spread over the whole input
+int64_t groupKeyOf(const SGroupInput* pInput, int64_t i) { return (i * 7919) % pInput->numOfGroups * 3 + 1; }
+
+SSDataBlock* getGroupInputBlock(SOperatorInfo* pOperator) {
+  SGroupInput* pInput = static_cast<SGroupInput*>(pOperator->info);
+  if (pInput->pos >= pInput->rows) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInput->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, 1000);
+
+  SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+
+  int32_t row = 0;
+  for (; row < 1000 && pInput->pos < pInput->rows; ++row, ++pInput->pos) {
+    int64_t k = groupKeyOf(pInput, pInput->pos);
+    if (groupKeyIsNull(pInput, pInput->pos)) {
+      colDataAppendNULL(pKeyCol, row);
+    } else {
+      colDataAppend(pKeyCol, row, reinterpret_cast<const char*>(&k), false);
+    }
+    colDataAppend(pValCol, row, reinterpret_cast<const char*>(&pInput->pos), false);
+  }
+
+  pBlock->info.rows = row;
+  return pBlock;
+}
+
+SOperatorInfo* createGroupInputOperator(int64_t rows, int64_t numOfGroups, int32_t nullEvery) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SGroupInput*   pInput = static_cast<SGroupInput*>(taosMemoryCalloc(1, sizeof(SGroupInput)));
+  pInput->rows = rows;
+  pInput->numOfGroups = numOfGroups;
+  pInput->nullEvery = nullEvery;
+  pInput->pBlock = createDataBlock();
+  pInput->pBlock->info.blockId = group_input_block;
+
+  SColumnInfoData k = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData v = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  blockDataAppendColInfo(pInput->pBlock, &k);
+  blockDataAppendColInfo(pInput->pBlock, &v);
+
+  pOperator->name = "groupInputOperator4Test";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;
+  pOperator->info = pInput;
+  pOperator->resultDataBlockId = group_input_block;
+  pOperator->fpSet.getNextFn = getGroupInputBlock;
+  return pOperator;
+}
+
+void destroyGroupInputOperator(SOperatorInfo* pOperator) {
+  SGroupInput* pInput = static_cast<SGroupInput*>(pOperator->info);
+  blockDataDestroy(pInput->pBlock);
+  taosMemoryFree(pInput);
+  taosMemoryFree(pOperator);
+}
+
+// the reference result of the input
+SGroupResult aggregateGroupInput(SOperatorInfo* pOperator) {
+  SGroupInput* pInput = static_cast<SGroupInput*>(pOperator->info);
+  SGroupResult res;
+  for (int64_t i = 0; i < pInput->rows; ++i) {
+    int64_t    k = groupKeyIsNull(pInput, i) ? GROUP_NULL_KEY : groupKeyOf(pInput, i);
+    SGroupAgg& agg = res[k];
+    if (agg.count == 0) {
+      agg.min = i;
+      agg.max = i;
+    }
+    agg.count += 1;
+    agg.sum += i;
+    agg.min = TMIN(agg.min, i);
+    agg.max = TMAX(agg.max, i);
+  }
+  return res;
+}
+
+SNode* makeGroupColumn(int16_t blockId, int16_t slotId) {
+  SColumnNode* pCol = reinterpret_cast<SColumnNode*>(nodesMakeNode(QUERY_NODE_COLUMN));
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->colType = COLUMN_TYPE_COLUMN;
+  pCol->node.resType.type = TSDB_DATA_TYPE_BIGINT;
+  pCol->node.resType.bytes = sizeof(int64_t);
+  return reinterpret_cast<SNode*>(pCol);
+}
+
+void addGroupTarget(SNodeList** pList, SDataBlockDescNode* pDesc, SNode* pExpr) {
+  int16_t slotId = LIST_LENGTH(pDesc->pSlots);
+
+  STargetNode* pTarget = reinterpret_cast<STargetNode*>(nodesMakeNode(QUERY_NODE_TARGET));
+  pTarget->dataBlockId = group_res_block;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  nodesListMakeAppend(pList, reinterpret_cast<SNode*>(pTarget));
+
+  SSlotDescNode* pSlot = reinterpret_cast<SSlotDescNode*>(nodesMakeNode(QUERY_NODE_SLOT_DESC));
+  pSlot->slotId = slotId;
+  pSlot->dataType = reinterpret_cast<SExprNode*>(pExpr)->resType;
+  pSlot->output = true;
+  nodesListMakeAppend(&pDesc->pSlots, reinterpret_cast<SNode*>(pSlot));
+}
+
+// SELECT count(v), sum(v), min(v), max(v), k FROM input GROUP BY k
+SAggPhysiNode* createGroupAggNode() {
+  SAggPhysiNode* pAgg = reinterpret_cast<SAggPhysiNode*>(nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_AGG));
+  SDataBlockDescNode* pDesc = reinterpret_cast<SDataBlockDescNode*>(nodesMakeNode(QUERY_NODE_DATABLOCK_DESC));
+  pDesc->dataBlockId = group_res_block;
+  pAgg->node.pOutputDataBlockDesc = pDesc;
+
+  const char* funcs[] = {"count", "sum", "min", "max"};
+  for (int32_t i = 0; i < tListLen(funcs); ++i) {
+    SFunctionNode* pFunc = reinterpret_cast<SFunctionNode*>(nodesMakeNode(QUERY_NODE_FUNCTION));
+    snprintf(pFunc->functionName, sizeof(pFunc->functionName), "%s", funcs[i]);
+    nodesListMakeAppend(&pFunc->pParameterList, makeGroupColumn(group_input_block, 1));
+
+    char msg[128] = {0};
+    EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), TSDB_CODE_SUCCESS) << msg;
+    addGroupTarget(&pAgg->pAggFuncs, pDesc, reinterpret_cast<SNode*>(pFunc));
+  }
+
+  addGroupTarget(&pAgg->pGroupKeys, pDesc, makeGroupColumn(group_input_block, 0));
+  return pAgg;
+}
+
+SOperatorInfo* createGroupOperator(SOperatorInfo* pInput, SAggPhysiNode* pAgg, SExecTaskInfo* pTaskInfo) {
+  int32_t      num = 0;
+  SExprInfo*   pExprInfo = createExprInfo(pAgg->pAggFuncs, pAgg->pGroupKeys, &num);
+  SSDataBlock* pResBlock = createResDataBlock(pAgg->node.pOutputDataBlockDesc);
+
+  SArray* pColList = taosArrayInit(1, sizeof(SColumn));
+  SColumn c = {0};
+  c.slotId = 0;
+  c.colId = 1;
+  c.colType = COLUMN_TYPE_COLUMN;
+  c.type = TSDB_DATA_TYPE_BIGINT;
+  c.bytes = sizeof(int64_t);
+  taosArrayPush(pColList, &c);
+
+  return createGroupOperatorInfo(pInput, pExprInfo, num, pResBlock, pColList, NULL, NULL, 0, pTaskInfo);
+}
+
+void destroyGroupOperator(SOperatorInfo* pOperator) {
+  pOperator->fpSet.closeFn(pOperator->info);
+  cleanupExprSupp(&pOperator->exprSupp);
+  taosMemoryFree(pOperator->pDownstream);
+  taosMemoryFree(pOperator);
+}
+
+void collectGroupBlock(SSDataBlock* pBlock, SGroupResult* pRes) {
+  SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 4));
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int64_t k = colDataIsNull_s(pKeyCol, i) ? GROUP_NULL_KEY : *(int64_t*)colDataGetData(pKeyCol, i);
+    EXPECT_EQ(pRes->count(k), 0) << "group " << k << " returned twice";
+
+    SGroupAgg& agg = (*pRes)[k];
+    agg.count = *(int64_t*)colDataGetData(static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0)), i);
+    agg.sum = *(int64_t*)colDataGetData(static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1)), i);
+    agg.min = *(int64_t*)colDataGetData(static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 2)), i);
+    agg.max = *(int64_t*)colDataGetData(static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 3)), i);
+  }
+}
+
+SGroupResult collectGroupResult(SOperatorInfo* pOperator) {
+  SGroupResult res;
+  SSDataBlock* pBlock = NULL;
+  while ((pBlock = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+    collectGroupBlock(pBlock, &res);
+  }
+  return res;
+}
+
+void checkGroupResult(const SGroupResult& res, const SGroupResult& expect) {
+  ASSERT_EQ(res.size(), expect.size());
+  for (auto& it : expect) {
+    auto r = res.find(it.first);
+    ASSERT_NE(r, res.end()) << "group " << it.first;
+    EXPECT_EQ(r->second.count, it.second.count) << "group " << it.first;
+    EXPECT_EQ(r->second.sum, it.second.sum) << "group " << it.first;
+    EXPECT_EQ(r->second.min, it.second.min) << "group " << it.first;
+    EXPECT_EQ(r->second.max, it.second.max) << "group " << it.first;
+  }
+}
+
+class GroupSpillTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_EQ(fmFuncMgtInit(), TSDB_CODE_SUCCESS); }
+
+  void SetUp() override {
+    queryGroupBufferSize = tsQueryGroupBufferSize;
+    tsQueryGroupBufferSize = 1;
+    taosMkDir(tsTempDir);
+  }
+
+  void TearDown() override { tsQueryGroupBufferSize = queryGroupBufferSize; }
+
+  // the number of groups of an operator that take the given ratio of the memory of the query
+  static int64_t groupsOfMemory(SOperatorInfo* pOperator, double ratio) {
+    SGroupbyOperatorInfo* pInfo = static_cast<SGroupbyOperatorInfo*>(pOperator->info);
+    return (int64_t)(pInfo->spillSup.memLimit * ratio / pInfo->spillSup.groupSize);
+  }
+
+  static int64_t spilledRows(SOperatorInfo* pOperator) {
+    return static_cast<SGroupbyOperatorInfo*>(pOperator->info)->spillSup.numOfSpilledRows;
+  }
+
+  int32_t queryGroupBufferSize = 0;
+};
+
+}  // namespace
+
+// many times more groups than the memory of the query holds, the rows beyond the memory are spilled
+TEST_F(GroupSpillTest, spill) {
+  SExecTaskInfo taskInfo = {0};
+  taskInfo.id.str = const_cast<char*>("groupSpillTest");
+
+  SAggPhysiNode* pAgg = createGroupAggNode();
+  SOperatorInfo* pInput = createGroupInputOperator(0, 1, 97);
+  SOperatorInfo* pOperator = createGroupOperator(pInput, pAgg, &taskInfo);
+  ASSERT_NE(pOperator, nullptr);
+
+  SGroupInput* pParam = static_cast<SGroupInput*>(pInput->info);
+  pParam->numOfGroups = groupsOfMemory(pOperator, 40);
+  pParam->rows = pParam->numOfGroups * 3;
+
+  SGroupResult res = collectGroupResult(pOperator);
+  checkGroupResult(res, aggregateGroupInput(pInput));
+
+  EXPECT_GT(spilledRows(pOperator), 0);
+  EXPECT_EQ(pOperator->status, OP_EXEC_DONE);
+  EXPECT_EQ(taskInfo.groupBufSize, 0);
+
+  destroyGroupOperator(pOperator);
+  destroyGroupInputOperator(pInput);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pAgg));
+}
+
+// the groups that fit in memory are not spilled
+TEST_F(GroupSpillTest, noSpill) {
+  SExecTaskInfo taskInfo = {0};
+  taskInfo.id.str = const_cast<char*>("groupSpillTest");
+
+  SAggPhysiNode* pAgg = createGroupAggNode();
+  SOperatorInfo* pInput = createGroupInputOperator(0, 1, 0);
+  SOperatorInfo* pOperator = createGroupOperator(pInput, pAgg, &taskInfo);
+  ASSERT_NE(pOperator, nullptr);
+
+  SGroupInput* pParam = static_cast<SGroupInput*>(pInput->info);
+  pParam->numOfGroups = groupsOfMemory(pOperator, 0.5);
+  pParam->rows = pParam->numOfGroups * 4;
+
+  checkGroupResult(collectGroupResult(pOperator), aggregateGroupInput(pInput));
+  EXPECT_EQ(spilledRows(pOperator), 0);
+
+  destroyGroupOperator(pOperator);
+  destroyGroupInputOperator(pInput);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pAgg));
+}
+
+// the memory is shared by the group by operators of the query. Either one fits on its own, but the second one spills
+// while the first one still holds its groups, and does not once the first one is done
+TEST_F(GroupSpillTest, memoryOfQuery) {
+  tsQueryGroupBufferSize = 4;
+
+  SExecTaskInfo taskInfo = {0};
+  taskInfo.id.str = const_cast<char*>("groupSpillTest");
+
+  SAggPhysiNode* pAgg1 = createGroupAggNode();
+  SAggPhysiNode* pAgg2 = createGroupAggNode();
+  SOperatorInfo* pInput1 = createGroupInputOperator(0, 1, 0);
+  SOperatorInfo* pInput2 = createGroupInputOperator(0, 1, 0);
+  SOperatorInfo* pOperator1 = createGroupOperator(pInput1, pAgg1, &taskInfo);
+  SOperatorInfo* pOperator2 = createGroupOperator(pInput2, pAgg2, &taskInfo);
+  ASSERT_NE(pOperator1, nullptr);
+  ASSERT_NE(pOperator2, nullptr);
+
+  // more groups than a result block holds, so the first operator is not done after its first block
+  SGroupInput* pParam1 = static_cast<SGroupInput*>(pInput1->info);
+  SGroupInput* pParam2 = static_cast<SGroupInput*>(pInput2->info);
+  pParam1->numOfGroups = groupsOfMemory(pOperator1, 0.7);
+  pParam1->rows = pParam1->numOfGroups * 2;
+  pParam2->numOfGroups = groupsOfMemory(pOperator2, 0.7);
+  pParam2->rows = pParam2->numOfGroups * 2;
+  ASSERT_GT(pParam1->numOfGroups, pOperator1->resultInfo.capacity);
+
+  SGroupResult res1;
+  SSDataBlock* pBlock = pOperator1->fpSet.getNextFn(pOperator1);
+  ASSERT_NE(pBlock, nullptr);
+  collectGroupBlock(pBlock, &res1);
+  EXPECT_EQ(spilledRows(pOperator1), 0);
+  EXPECT_GT(taskInfo.groupBufSize, 0);
+
+  checkGroupResult(collectGroupResult(pOperator2), aggregateGroupInput(pInput2));
+  EXPECT_GT(spilledRows(pOperator2), 0);
+
+  while ((pBlock = pOperator1->fpSet.getNextFn(pOperator1)) != NULL) {
+    collectGroupBlock(pBlock, &res1);
+  }
+  checkGroupResult(res1, aggregateGroupInput(pInput1));
+  EXPECT_EQ(taskInfo.groupBufSize, 0);
+
+  // the first one is done and the memory is given back, the same input is aggregated without spilling
+  SOperatorInfo* pOperator3 = createGroupOperator(pInput1, pAgg1, &taskInfo);
+  ASSERT_NE(pOperator3, nullptr);
+  pParam1->pos = 0;
+  checkGroupResult(collectGroupResult(pOperator3), aggregateGroupInput(pInput1));
+  EXPECT_EQ(spilledRows(pOperator3), 0);
+
+  destroyGroupOperator(pOperator3);
+  destroyGroupOperator(pOperator2);
+  destroyGroupOperator(pOperator1);
+  destroyGroupInputOperator(pInput1);
+  destroyGroupInputOperator(pInput2);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pAgg1));
+  nodesDestroyNode(reinterpret_cast<SNode*>(pAgg2));
+}
+
+#pragma GCC diagnostic pop
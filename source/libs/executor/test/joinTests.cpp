@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "os.h"
+
+#include "executorimpl.h"
+#include "nodes.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+enum {
+  join_left_block = 1,
+  join_right_block = 2,
+  join_res_block = 3,
+};
+
+// rows i of an input: k int = i % mod, NULL for every nullEvery-th row, v bigint = i, s varchar = "k<k>"
+typedef struct SJoinInput {
+  int32_t      rows;
+  int32_t      mod;
+  int32_t      nullEvery;
+  int32_t      pos;
+  SSDataBlock* pBlock;
+} SJoinInput;
+
+typedef std::vector<std::pair<int64_t, int64_t>> SJoinPairs;
+
+bool joinInputKeyIsNull(const SJoinInput* pInput, int64_t i) {
+  return pInput->nullEvery > 0 && i % pInput->nullEvery == 0;
+}
+
+SSDataBlock* getJoinInputBlock(SOperatorInfo* pOperator) {
+  SJoinInput* pInput = static_cast<SJoinInput*>(pOperator->info);
+  if (pInput->pos >= pInput->rows) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInput->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, 1000);
+
+  int32_t row = 0;
+  for (; row < 1000 && pInput->pos < pInput->rows; ++row, ++pInput->pos) {
+    int32_t k = pInput->pos % pInput->mod;
+    int64_t v = pInput->pos;
+    char    s[32];
+    snprintf(varDataVal(s), sizeof(s) - VARSTR_HEADER_SIZE, "k%d", k);
+    varDataSetLen(s, strlen(varDataVal(s)));
+
+    SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+    SColumnInfoData* pStrCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 2));
+    if (joinInputKeyIsNull(pInput, pInput->pos)) {
+      colDataAppendNULL(pKeyCol, row);
+      colDataAppendNULL(pStrCol, row);
+    } else {
+      colDataAppend(pKeyCol, row, reinterpret_cast<const char*>(&k), false);
+      colDataAppend(pStrCol, row, s, false);
+    }
+    colDataAppend(static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1)), row,
+                  reinterpret_cast<const char*>(&v), false);
+  }
+
+  pBlock->info.rows = row;
+  return pBlock;
+}
+
+SOperatorInfo* createJoinInputOperator(int16_t blockId, int32_t rows, int32_t mod, int32_t nullEvery) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  SJoinInput*    pInput = static_cast<SJoinInput*>(taosMemoryCalloc(1, sizeof(SJoinInput)));
+  pInput->rows = rows;
+  pInput->mod = mod;
+  pInput->nullEvery = nullEvery;
+  pInput->pBlock = createDataBlock();
+  pInput->pBlock->info.blockId = blockId;
+
+  SColumnInfoData k = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData v = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  SColumnInfoData s = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE, 3);
+  blockDataAppendColInfo(pInput->pBlock, &k);
+  blockDataAppendColInfo(pInput->pBlock, &v);
+  blockDataAppendColInfo(pInput->pBlock, &s);
+
+  pOperator->name = "joinInputOperator4Test";
+  pOperator->info = pInput;
+  pOperator->resultDataBlockId = blockId;
+  pOperator->fpSet.getNextFn = getJoinInputBlock;
+  return pOperator;
+}
+
+void destroyJoinInputOperator(SOperatorInfo* pOperator) {
+  SJoinInput* pInput = static_cast<SJoinInput*>(pOperator->info);
+  blockDataDestroy(pInput->pBlock);
+  taosMemoryFree(pInput);
+  taosMemoryFree(pOperator);
+}
+
+SNode* makeJoinColumn(int16_t blockId, int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = reinterpret_cast<SColumnNode*>(nodesMakeNode(QUERY_NODE_COLUMN));
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return reinterpret_cast<SNode*>(pCol);
+}
+
+void addJoinTarget(SHashJoinPhysiNode* pJoin, int16_t blockId, int16_t slotId, int8_t type, int32_t bytes) {
+  int16_t resSlotId = LIST_LENGTH(pJoin->pTargets);
+
+  STargetNode* pTarget = reinterpret_cast<STargetNode*>(nodesMakeNode(QUERY_NODE_TARGET));
+  pTarget->dataBlockId = join_res_block;
+  pTarget->slotId = resSlotId;
+  pTarget->pExpr = makeJoinColumn(blockId, slotId, type, bytes);
+  nodesListMakeAppend(&pJoin->pTargets, reinterpret_cast<SNode*>(pTarget));
+
+  SSlotDescNode* pSlot = reinterpret_cast<SSlotDescNode*>(nodesMakeNode(QUERY_NODE_SLOT_DESC));
+  pSlot->slotId = resSlotId;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = bytes;
+  pSlot->output = true;
+  nodesListMakeAppend(&pJoin->node.pOutputDataBlockDesc->pSlots, reinterpret_cast<SNode*>(pSlot));
+}
+
+// SELECT left.v, right.v, right.s FROM left JOIN right ON left.<key> = right.<key> [AND left.v > right.v]
+SHashJoinPhysiNode* createJoinNode(bool strKey, bool onCond) {
+  SHashJoinPhysiNode* pJoin =
+      reinterpret_cast<SHashJoinPhysiNode*>(nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN));
+  pJoin->joinType = JOIN_TYPE_INNER;
+  pJoin->node.pOutputDataBlockDesc =
+      reinterpret_cast<SDataBlockDescNode*>(nodesMakeNode(QUERY_NODE_DATABLOCK_DESC));
+  pJoin->node.pOutputDataBlockDesc->dataBlockId = join_res_block;
+
+  // the keys of the right input first in the left keys, the operator tells the sides by the block id
+  int16_t slotId = strKey ? 2 : 0;
+  int8_t  type = strKey ? TSDB_DATA_TYPE_VARCHAR : TSDB_DATA_TYPE_INT;
+  int32_t bytes = strKey ? 16 + VARSTR_HEADER_SIZE : sizeof(int32_t);
+  nodesListMakeAppend(&pJoin->pLeftKeys, makeJoinColumn(join_right_block, slotId, type, bytes));
+  nodesListMakeAppend(&pJoin->pRightKeys, makeJoinColumn(join_left_block, slotId, type, bytes));
+
+  addJoinTarget(pJoin, join_left_block, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  addJoinTarget(pJoin, join_right_block, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  addJoinTarget(pJoin, join_right_block, 2, TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE);
+
+  if (onCond) {
+    SOperatorNode* pOp = reinterpret_cast<SOperatorNode*>(nodesMakeNode(QUERY_NODE_OPERATOR));
+    pOp->opType = OP_TYPE_GREATER_THAN;
+    pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+    pOp->node.resType.bytes = sizeof(bool);
+    pOp->pLeft = makeJoinColumn(join_res_block, 0, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+    pOp->pRight = makeJoinColumn(join_res_block, 1, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+    pJoin->pOnConditions = reinterpret_cast<SNode*>(pOp);
+  }
+  return pJoin;
+}
+
+// runs the join over the inputs, returns the (left.v, right.v) pairs sorted
+SJoinPairs runHashJoin(SOperatorInfo* pLeft, SOperatorInfo* pRight, bool strKey, bool onCond, int64_t maxBufSize,
+                       bool* pSpilled, int32_t* pBuildIdx) {
+  SExecTaskInfo       taskInfo = {0};
+  SOperatorInfo*      pDownstream[2] = {pLeft, pRight};
+  SHashJoinPhysiNode* pJoin = createJoinNode(strKey, onCond);
+  SJoinPairs          pairs;
+
+  taskInfo.id.str = const_cast<char*>("hashJoinTest");
+  SOperatorInfo* pOperator = createHashJoinOperatorInfo(pDownstream, 2, pJoin, &taskInfo);
+  EXPECT_NE(pOperator, nullptr);
+  if (pOperator == NULL) {
+    nodesDestroyNode(reinterpret_cast<SNode*>(pJoin));
+    return pairs;
+  }
+
+  SHashJoinOperatorInfo* pInfo = static_cast<SHashJoinOperatorInfo*>(pOperator->info);
+  if (maxBufSize > 0) {
+    pInfo->maxBufSize = maxBufSize;
+  }
+
+  SSDataBlock* pRes = NULL;
+  while ((pRes = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+    SColumnInfoData* pLeftV = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+    SColumnInfoData* pRightV = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+    SColumnInfoData* pRightS = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2));
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      int64_t lv = *reinterpret_cast<int64_t*>(colDataGetData(pLeftV, i));
+      int64_t rv = *reinterpret_cast<int64_t*>(colDataGetData(pRightV, i));
+      pairs.push_back(std::make_pair(lv, rv));
+
+      // the var data column of the build or the probe side is copied along with the row it belongs to
+      EXPECT_FALSE(colDataIsNull_s(pRightS, i));
+      char* s = colDataGetData(pRightS, i);
+      EXPECT_EQ(atoi(std::string(varDataVal(s) + 1, varDataLen(s) - 1).c_str()),
+                rv % static_cast<SJoinInput*>(pRight->info)->mod);
+    }
+  }
+
+  *pSpilled = pInfo->spilled;
+  *pBuildIdx = pInfo->buildIdx;
+  pOperator->fpSet.closeFn(pOperator->info);
+  destroyExprInfo(pOperator->exprSupp.pExprInfo, pOperator->exprSupp.numOfExprs);
+  taosMemoryFree(pOperator->exprSupp.pExprInfo);
+  taosMemoryFree(pOperator->pDownstream);
+  taosMemoryFree(pOperator);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pJoin));
+
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+// the pairs of the inputs with equal non NULL keys, walking the rows of the key on the right directly
+SJoinPairs expectedJoinPairs(const SJoinInput* pLeft, const SJoinInput* pRight, bool onCond) {
+  SJoinPairs pairs;
+  for (int64_t i = 0; i < pLeft->rows; ++i) {
+    if (joinInputKeyIsNull(pLeft, i) || i % pLeft->mod >= pRight->mod) continue;
+    for (int64_t j = i % pLeft->mod; j < pRight->rows; j += pRight->mod) {
+      if (joinInputKeyIsNull(pRight, j) || (onCond && i <= j)) continue;
+      pairs.push_back(std::make_pair(i, j));
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+void checkHashJoin(int32_t nLeft, int32_t mLeft, int32_t nRight, int32_t mRight, int32_t nullEvery, bool strKey,
+                   bool onCond, int64_t maxBufSize, bool spill, int32_t buildIdx) {
+  SOperatorInfo* pLeft = createJoinInputOperator(join_left_block, nLeft, mLeft, nullEvery);
+  SOperatorInfo* pRight = createJoinInputOperator(join_right_block, nRight, mRight, nullEvery);
+  SJoinInput     left = *static_cast<SJoinInput*>(pLeft->info);
+  SJoinInput     right = *static_cast<SJoinInput*>(pRight->info);
+
+  bool       spilled = false;
+  int32_t    actualBuildIdx = -1;
+  SJoinPairs pairs = runHashJoin(pLeft, pRight, strKey, onCond, maxBufSize, &spilled, &actualBuildIdx);
+  SJoinPairs expected = expectedJoinPairs(&left, &right, onCond);
+
+  EXPECT_EQ(spilled, spill);
+  if (buildIdx >= 0) {
+    EXPECT_EQ(actualBuildIdx, buildIdx);
+  }
+  ASSERT_EQ(pairs.size(), expected.size());
+  EXPECT_TRUE(pairs == expected);
+
+  destroyJoinInputOperator(pLeft);
+  destroyJoinInputOperator(pRight);
+}
+
+}  // namespace
+
+TEST(testCase, hashJoin_buildProbe_Test) {
+  // the input that ends first is the build side, in both orders, and the probe side is read on after the build
+  checkHashJoin(5000, 100, 300, 100, 0, false, false, 0, false, 1);
+  checkHashJoin(300, 100, 5000, 100, 0, false, false, 0, false, 0);
+  // keys only on one side, an empty input
+  checkHashJoin(3000, 50, 3000, 70, 0, false, false, 0, false, -1);
+  checkHashJoin(0, 10, 5000, 10, 0, false, false, 0, false, 0);
+  // var data keys
+  checkHashJoin(3000, 7, 5000, 13, 0, true, false, 0, false, 0);
+}
+
+TEST(testCase, hashJoin_nullKey_Test) {
+  // NULL keys equal nothing, not even the NULL keys of the other side
+  checkHashJoin(5000, 100, 3000, 100, 97, false, false, 0, false, 1);
+  checkHashJoin(3000, 7, 5000, 13, 11, true, false, 0, false, 0);
+  checkHashJoin(100, 1, 100, 1, 1, false, false, 0, false, -1);
+}
+
+TEST(testCase, hashJoin_onCondition_Test) {
+  // a non key ON condition filters the joined rows
+  checkHashJoin(5000, 100, 3000, 100, 0, false, true, 0, false, 1);
+  checkHashJoin(3000, 7, 5000, 13, 97, true, true, 0, false, 0);
+}
+
+TEST(testCase, hashJoin_spill_Test) {
+  if (tsTempDir[0] == 0) {
+    strcpy(tsTempDir, TD_TMP_DIR_PATH);
+  }
+
+  // beyond the memory budget both inputs are partitioned to disk, and joined partition by partition
+  checkHashJoin(20000, 500, 20000, 700, 0, false, false, 64 * 1024, true, -1);
+  checkHashJoin(20000, 500, 8000, 700, 97, true, false, 64 * 1024, true, -1);
+  checkHashJoin(20000, 300, 20000, 300, 13, false, true, 64 * 1024, true, -1);
+}
+
+#pragma GCC diagnostic pop
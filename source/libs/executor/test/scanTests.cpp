@@ -0,0 +1,819 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "nodes.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "vnodeTestUtil.h"
+
+#define SCAN_TEST_ROOT TD_TMP_DIR_PATH "scanTest"
+#define SCAN_TEST_SUID 1000
+#define SCAN_TEST_UID  1001
+
+namespace {
+
+// rows of a table: ts = start + i * 10, v = uid * 1000000 + i, s = "<uid>-<i % 100>"
+typedef struct SScanRow {
+  int64_t ts;
+  int64_t v;
+  bool    s;  // s matches the row
+} SScanRow;
+
+typedef std::map<uint64_t, std::vector<SScanRow>> SScanResult;
+
+// (uid, ts) of the rows in the order they are returned
+typedef std::vector<std::pair<uint64_t, int64_t>> SScanSeq;
+
+class TableScanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pVnode = vnodeTestOpen(SCAN_TEST_ROOT, 2);
+    ASSERT_NE(pVnode, nullptr);
+    pVnode->config.cacheLast = 0;
+    pVnode->config.cacheLastSize = 1;
+    pVnode->config.szBuf = 16 * 1024 * 1024;
+    pVnode->config.tsdbCfg.minRows = 10;
+    pVnode->config.tsdbCfg.maxRows = 1000;  // rows of a block in the data files
+
+    ASSERT_EQ(vnodeOpenBufPool(pVnode, 4 * 1024 * 1024), 0);
+    ASSERT_EQ(metaOpen(pVnode, &pVnode->pMeta), 0);
+    ASSERT_EQ(tsdbOpen(pVnode, &pVnode->pTsdb, VNODE_TSDB_DIR, NULL), 0);
+    ASSERT_EQ(metaBegin(pVnode->pMeta, 1), 0);
+    beginTsdb();
+
+    start = taosGetTimestampMs() - 24 * 3600 * 1000LL;
+    taskInfo.id.str = (char *)"scanTest";
+    taskInfo.execModel = OPTR_EXEC_MODEL_BATCH;
+  }
+
+  void TearDown() override {
+    destroyTableList();
+    tsdbCommit(pVnode->pTsdb);
+    if (pVnode->inUse != NULL) {
+      vnodeBufPoolUnRef(pVnode->inUse);
+      pVnode->inUse = NULL;
+    }
+    metaCommit(pVnode->pMeta);
+    tsdbClose(&pVnode->pTsdb);
+    metaClose(pVnode->pMeta);
+    vnodeCloseBufPool(pVnode);
+    vnodeTestClose(pVnode);
+    taosRemoveDir(SCAN_TEST_ROOT);
+  }
+
+  // as vnodeBegin does, each commit writes the data files of a new commit id
+  void beginTsdb() {
+    pVnode->state.commitID++;
+    pVnode->inUse = pVnode->pPool;
+    pVnode->inUse->nRef = 1;
+    pVnode->pPool = pVnode->inUse->next;
+    pVnode->inUse->next = NULL;
+    ASSERT_EQ(tsdbBegin(pVnode->pTsdb), 0);
+  }
+
+  // the rows in memory are written to the data files
+  void commitTsdb() {
+    vnodeBufPoolUnRef(pVnode->inUse);
+    pVnode->inUse = NULL;
+    ASSERT_EQ(tsdbCommit(pVnode->pTsdb), 0);
+    beginTsdb();
+  }
+
+  // super table (ts timestamp, v bigint, s varchar(16)) tags (t int), child tables SCAN_TEST_UID + i
+  void createTables(int32_t numOfTables) {
+    SSchema aCol[] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+                      {.type = TSDB_DATA_TYPE_BIGINT, .colId = 2, .bytes = 8, .name = "v"},
+                      {.type = TSDB_DATA_TYPE_VARCHAR, .colId = 3, .bytes = 16 + VARSTR_HEADER_SIZE, .name = "s"}};
+    SSchema aTag[] = {{.type = TSDB_DATA_TYPE_INT, .colId = 4, .bytes = 4, .name = "t"}};
+
+    SVCreateStbReq stb = {0};
+    stb.name = (char *)"st";
+    stb.suid = SCAN_TEST_SUID;
+    stb.schemaRow = {.nCols = 3, .version = 1, .pSchema = aCol};
+    stb.schemaTag = {.nCols = 1, .version = 1, .pSchema = aTag};
+    ASSERT_EQ(metaCreateSTable(pVnode->pMeta, ++version, &stb), 0);
+
+    for (int32_t i = 0; i < numOfTables; ++i) {
+      SArray *pVals = taosArrayInit(1, sizeof(STagVal));
+      STag   *pTag = NULL;
+      STagVal val = {.cid = 4, .type = TSDB_DATA_TYPE_INT};
+      val.i64 = i;
+      taosArrayPush(pVals, &val);
+      tTagNew(pVals, 1, false, &pTag);
+      taosArrayDestroy(pVals);
+
+      char name[TSDB_TABLE_NAME_LEN];
+      snprintf(name, sizeof(name), "t%d", i);
+
+      SVCreateTbReq req = {0};
+      req.name = name;
+      req.uid = SCAN_TEST_UID + i;
+      req.type = TSDB_CHILD_TABLE;
+      req.ctb.name = (char *)"st";
+      req.ctb.suid = SCAN_TEST_SUID;
+      req.ctb.pTag = (uint8_t *)pTag;
+
+      STableMetaRsp *pRsp = NULL;
+      ASSERT_EQ(metaCreateTable(pVnode->pMeta, ++version, &req, &pRsp), 0);
+      taosMemoryFree(pRsp);
+      taosMemoryFree(pTag);
+    }
+  }
+
+  static int64_t rowValue(uint64_t uid, int32_t row) { return (int64_t)uid * 1000000 + row; }
+
+  static void rowString(uint64_t uid, int32_t row, char *buf) {
+    snprintf(varDataVal(buf), 16, "%" PRIu64 "-%d", uid, row % 100);
+    varDataSetLen(buf, strlen(varDataVal(buf)));
+  }
+
+  // rows [from, to) of the table
+  void insertRows(uint64_t uid, int32_t from, int32_t to) {
+    SSDataBlock    *pBlock = createDataBlock();
+    SColumnInfoData ts = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+    SColumnInfoData v = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, 2);
+    SColumnInfoData s = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE, 3);
+    blockDataAppendColInfo(pBlock, &ts);
+    blockDataAppendColInfo(pBlock, &v);
+    blockDataAppendColInfo(pBlock, &s);
+    blockDataEnsureCapacity(pBlock, to - from);
+
+    for (int32_t i = from; i < to; ++i) {
+      int64_t k = start + i * 10;
+      int64_t val = rowValue(uid, i);
+      char    str[16 + VARSTR_HEADER_SIZE];
+      rowString(uid, i, str);
+      colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0), i - from, (const char *)&k, false);
+      colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1), i - from, (const char *)&val, false);
+      colDataAppend((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2), i - from, str, false);
+    }
+    pBlock->info.rows = to - from;
+    pBlock->info.rowSize = 8 + 8 + 16 + VARSTR_HEADER_SIZE;
+    pBlock->info.groupId = uid;  // the table the submit block is for
+
+    STSchema   *pTSchema = metaGetTbTSchema(pVnode->pMeta, SCAN_TEST_SUID, -1);
+    SSubmitReq *pReq = NULL;
+    ASSERT_EQ(buildSubmitReqFromDataBlock(&pReq, pBlock, pTSchema, pVnode->config.vgId, SCAN_TEST_SUID), 0);
+    ASSERT_EQ(tsdbInsertData(pVnode->pTsdb, ++version, pReq, NULL), 0);
+    pVnode->state.applied = version;
+
+    taosMemoryFree(pReq);
+    taosMemoryFree(pTSchema);
+    blockDataDestroy(pBlock);
+  }
+
+  // all the tables in one group, the group id of a table is its uid * 10
+  void createTableList(int32_t numOfTables) {
+    STableListInfo *pList = &taskInfo.tableqinfoList;
+    pList->pTableList = taosArrayInit(numOfTables, sizeof(STableKeyInfo));
+    pList->pGroupList = taosArrayInit(1, POINTER_BYTES);
+    pList->map = taosHashInit(numOfTables, taosGetDefaultHashFunction(TSDB_DATA_TYPE_UBIGINT), false, HASH_NO_LOCK);
+    for (int32_t i = 0; i < numOfTables; ++i) {
+      STableKeyInfo info = {.uid = (uint64_t)SCAN_TEST_UID + i, .groupId = ((uint64_t)SCAN_TEST_UID + i) * 10};
+      taosArrayPush(pList->pTableList, &info);
+      taosHashPut(pList->map, &info.uid, sizeof(info.uid), &info.groupId, sizeof(info.groupId));
+    }
+
+    SArray *pGroup = taosArrayDup(pList->pTableList);
+    taosArrayPush(pList->pGroupList, &pGroup);
+  }
+
+  void destroyTableList() {
+    STableListInfo *pList = &taskInfo.tableqinfoList;
+    for (int32_t i = 0; i < taosArrayGetSize(pList->pGroupList); ++i) {
+      taosArrayDestroy((SArray *)taosArrayGetP(pList->pGroupList, i));
+    }
+    pList->pGroupList = (SArray *)taosArrayDestroy(pList->pGroupList);
+    pList->pTableList = (SArray *)taosArrayDestroy(pList->pTableList);
+    taosHashCleanup(pList->map);
+    pList->map = NULL;
+  }
+
+  static SNode *makeScanCol(int16_t colId, int16_t slotId, int8_t type, int32_t bytes) {
+    SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+    pCol->colId = colId;
+    pCol->colType = (colId == 1) ? COLUMN_TYPE_COLUMN : COLUMN_TYPE_COLUMN;
+    pCol->dataBlockId = 1;
+    pCol->slotId = slotId;
+    pCol->node.resType.type = type;
+    pCol->node.resType.bytes = bytes;
+    return (SNode *)pCol;
+  }
+
+  static SNode *makeScanValue(int64_t v) {
+    SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+    pVal->node.resType.type = TSDB_DATA_TYPE_BIGINT;
+    pVal->node.resType.bytes = sizeof(int64_t);
+    nodesSetValueNodeValue(pVal, &v);
+    return (SNode *)pVal;
+  }
+
+  static SNode *makeScanString(const char *str) {
+    SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+    pVal->node.resType.type = TSDB_DATA_TYPE_VARCHAR;
+    pVal->node.resType.bytes = strlen(str);
+    pVal->datum.p = (char *)taosMemoryCalloc(1, strlen(str) + VARSTR_HEADER_SIZE);
+    STR_TO_VARSTR(pVal->datum.p, str);
+    return (SNode *)pVal;
+  }
+
+  static SNode *makeScanOp(EOperatorType opType, int8_t resType, SNode *pLeft, SNode *pRight) {
+    SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+    pOp->node.resType.type = resType;
+    pOp->node.resType.bytes = tDataTypes[resType].bytes;
+    pOp->opType = opType;
+    pOp->pLeft = pLeft;
+    pOp->pRight = pRight;
+    return (SNode *)pOp;
+  }
+
+  static SNode *makeScanAnd(SNode *pLeft, SNode *pRight) {
+    SLogicConditionNode *pCond = (SLogicConditionNode *)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    pCond->condType = LOGIC_COND_TYPE_AND;
+    pCond->node.resType.type = TSDB_DATA_TYPE_BOOL;
+    pCond->node.resType.bytes = sizeof(bool);
+    nodesListMakeAppend(&pCond->pParameterList, pLeft);
+    nodesListMakeAppend(&pCond->pParameterList, pRight);
+    return (SNode *)pCond;
+  }
+
+  // v % 7 = 0 and v % 1000000 < 2500, only the rows of some blocks and none of the others pass
+  static SNode *makeValueFilter() {
+    SNode *pRem = makeScanOp(OP_TYPE_REM, TSDB_DATA_TYPE_DOUBLE, makeScanCol(2, 1, TSDB_DATA_TYPE_BIGINT, 8),
+                             makeScanValue(7));
+    SNode *pRow = makeScanOp(OP_TYPE_REM, TSDB_DATA_TYPE_DOUBLE, makeScanCol(2, 1, TSDB_DATA_TYPE_BIGINT, 8),
+                             makeScanValue(1000000));
+    return makeScanAnd(makeScanOp(OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pRem, makeScanValue(0)),
+                       makeScanOp(OP_TYPE_LOWER_THAN, TSDB_DATA_TYPE_BOOL, pRow, makeScanValue(2500)));
+  }
+
+  static bool valueFilterRow(uint64_t uid, int32_t row) { return rowValue(uid, row) % 7 == 0 && row < 2500; }
+
+  // s like '%-1_'
+  static SNode *makeStringFilter() {
+    return makeScanOp(OP_TYPE_LIKE, TSDB_DATA_TYPE_BOOL,
+                      makeScanCol(3, 2, TSDB_DATA_TYPE_VARCHAR, 16 + VARSTR_HEADER_SIZE), makeScanString("%-1_"));
+  }
+
+  static bool stringFilterRow(uint64_t uid, int32_t row) { return row % 100 >= 10 && row % 100 < 20; }
+
+  // select ts, v, s from st
+  static STableScanPhysiNode *createScanNode(int8_t parallelism, int32_t order = TSDB_ORDER_ASC) {
+    STableScanPhysiNode *pScan = (STableScanPhysiNode *)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN);
+    pScan->scan.suid = SCAN_TEST_SUID;
+    pScan->scan.tableType = TSDB_SUPER_TABLE;
+    pScan->scanSeq[0] = (order == TSDB_ORDER_ASC) ? 1 : 0;
+    pScan->scanSeq[1] = (order == TSDB_ORDER_ASC) ? 0 : 1;
+    pScan->scanRange = (STimeWindow){.skey = INT64_MIN, .ekey = INT64_MAX};
+    pScan->ratio = 1.0;
+    pScan->dataRequired = FUNC_DATA_REQUIRED_DATA_LOAD;
+    pScan->parallelism = parallelism;
+
+    SDataBlockDescNode *pDesc = (SDataBlockDescNode *)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+    pDesc->dataBlockId = 1;
+    pScan->scan.node.pOutputDataBlockDesc = pDesc;
+
+    int8_t  types[] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_VARCHAR};
+    int32_t bytes[] = {8, 8, 16 + VARSTR_HEADER_SIZE};
+    for (int16_t i = 0; i < 3; ++i) {
+      STargetNode *pTarget = (STargetNode *)nodesMakeNode(QUERY_NODE_TARGET);
+      pTarget->dataBlockId = 1;
+      pTarget->slotId = i;
+      pTarget->pExpr = makeScanCol(i + 1, i, types[i], bytes[i]);
+      nodesListMakeAppend(&pScan->scan.pScanCols, (SNode *)pTarget);
+
+      SSlotDescNode *pSlot = (SSlotDescNode *)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+      pSlot->slotId = i;
+      pSlot->dataType.type = types[i];
+      pSlot->dataType.bytes = bytes[i];
+      pSlot->output = true;
+      nodesListMakeAppend(&pDesc->pSlots, (SNode *)pSlot);
+    }
+
+    return pScan;
+  }
+
+  SOperatorInfo *createScanOperator(STableScanPhysiNode *pScan) {
+    SReadHandle handle = {0};
+    handle.vnode = pVnode;
+    handle.meta = pVnode->pMeta;
+    return createTableScanOperatorInfo(pScan, &handle, &taskInfo);
+  }
+
+  static void destroyScanOperator(SOperatorInfo *pOperator) {
+    pOperator->fpSet.closeFn(pOperator->info);
+    taosMemoryFree(pOperator);
+  }
+
+  // the rows of each block are checked against the table it comes from
+  void collectBlock(SSDataBlock *pBlock, SScanResult *pResult) {
+    EXPECT_EQ(pBlock->info.groupId, pBlock->info.uid * 10);
+
+    SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData *pV = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData *pS = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+      SScanRow row = {0};
+      row.ts = *(int64_t *)colDataGetData(pTs, i);
+      row.v = *(int64_t *)colDataGetData(pV, i);
+
+      char    str[16 + VARSTR_HEADER_SIZE];
+      int32_t index = (int32_t)((row.ts - start) / 10);
+      rowString(pBlock->info.uid, index, str);
+      char *s = colDataGetData(pS, i);
+      row.s = varDataLen(s) == varDataLen(str) && memcmp(varDataVal(s), varDataVal(str), varDataLen(s)) == 0;
+      EXPECT_EQ(row.v, rowValue(pBlock->info.uid, index));
+      EXPECT_TRUE(row.s);
+
+      (*pResult)[pBlock->info.uid].push_back(row);
+    }
+  }
+
+  SScanResult scanAll(int8_t parallelism) {
+    STableScanPhysiNode *pScan = createScanNode(parallelism);
+    SOperatorInfo       *pOperator = createScanOperator(pScan);
+    SScanResult          result;
+
+    EXPECT_NE(pOperator, nullptr);
+    if (pOperator != NULL) {
+      SSDataBlock *pBlock = NULL;
+      while ((pBlock = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+        collectBlock(pBlock, &result);
+      }
+      destroyScanOperator(pOperator);
+    }
+
+    nodesDestroyNode((SNode *)pScan);
+    return result;
+  }
+
+  // a serial scan with the limit pushed down, pLoaded receives the rows loaded from the tsdb reader
+  SScanSeq scanWithLimit(int64_t limit, int8_t parallelism, int64_t *pLoaded) {
+    STableScanPhysiNode *pScan = createScanNode(parallelism);
+    SScanSeq             seq;
+    if (limit >= 0) {
+      SLimitNode *pLimit = (SLimitNode *)nodesMakeNode(QUERY_NODE_LIMIT);
+      pLimit->limit = limit;
+      pScan->scan.node.pLimit = (SNode *)pLimit;
+    }
+
+    SOperatorInfo *pOperator = createScanOperator(pScan);
+    EXPECT_NE(pOperator, nullptr);
+    if (pOperator != NULL) {
+      SScanResult  result;
+      SSDataBlock *pBlock = NULL;
+      while ((pBlock = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+        EXPECT_GT(pBlock->info.rows, 0);
+        collectBlock(pBlock, &result);
+        SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+        for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+          seq.push_back(std::make_pair(pBlock->info.uid, *(int64_t *)colDataGetData(pTs, i)));
+        }
+      }
+
+      // the limit is reached or the data is exhausted, the scan returns nothing more either way
+      EXPECT_EQ(pOperator->fpSet.getNextFn(pOperator), nullptr);
+
+      STableScanInfo *pInfo = (STableScanInfo *)pOperator->info;
+      EXPECT_EQ(pInfo->pParaScan, nullptr);
+      *pLoaded = pInfo->readRecorder.totalRows;
+      destroyScanOperator(pOperator);
+    }
+
+    nodesDestroyNode((SNode *)pScan);
+    return seq;
+  }
+
+  // a serial scan with the filter, pDelayed receives whether the columns not in the filter are loaded after it
+  SScanResult scanWithFilter(SNode *pFilter, int32_t order, bool *pDelayed) {
+    STableScanPhysiNode *pScan = createScanNode(1, order);
+    pScan->scan.node.pConditions = pFilter;
+
+    SOperatorInfo *pOperator = createScanOperator(pScan);
+    SScanResult    result;
+    EXPECT_NE(pOperator, nullptr);
+    if (pOperator != NULL) {
+      *pDelayed = (((STableScanInfo *)pOperator->info)->pDelayedColMatch != NULL);
+
+      SSDataBlock *pBlock = NULL;
+      while ((pBlock = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+        collectBlock(pBlock, &result);
+      }
+      destroyScanOperator(pOperator);
+    }
+
+    nodesDestroyNode((SNode *)pScan);
+    return result;
+  }
+
+  // the rows of each table passing the filter are returned in the order of the scan
+  void checkFilterResult(const SScanResult &result, int32_t numOfTables, int32_t numOfRows, int32_t order,
+                         bool (*fp)(uint64_t, int32_t)) {
+    for (int32_t t = 0; t < numOfTables; ++t) {
+      uint64_t             uid = SCAN_TEST_UID + t;
+      std::vector<int64_t> expect;
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        if (fp(uid, i)) {
+          expect.push_back(start + i * 10);
+        }
+      }
+      if (order == TSDB_ORDER_DESC) {
+        std::reverse(expect.begin(), expect.end());
+      }
+
+      auto it = result.find(uid);
+      if (expect.empty()) {
+        EXPECT_EQ(it, result.end()) << "uid:" << uid;
+        continue;
+      }
+
+      ASSERT_NE(it, result.end()) << "uid:" << uid;
+      ASSERT_EQ(it->second.size(), expect.size()) << "uid:" << uid;
+      for (int32_t i = 0; i < expect.size(); ++i) {
+        EXPECT_EQ(it->second[i].ts, expect[i]) << "uid:" << uid;
+      }
+    }
+  }
+
+  // the rows of each table are returned in the order of the timestamp, all of them
+  void checkResult(const SScanResult &result, int32_t numOfTables, int32_t numOfRows) {
+    ASSERT_EQ(result.size(), numOfTables);
+    for (auto &it : result) {
+      ASSERT_EQ(it.second.size(), numOfRows);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        EXPECT_EQ(it.second[i].ts, start + i * 10);
+      }
+    }
+  }
+
+  // the rows of a table read by a reader of the given window, the condition of the reader is left in pCond
+  std::vector<int32_t> readRows(uint64_t uid, int32_t type, int32_t order, STimeWindow w, SQueryTableDataCond *pCond) {
+    static SColumnInfo cols[] = {{.colId = 1, .type = TSDB_DATA_TYPE_TIMESTAMP, .bytes = 8},
+                                 {.colId = 2, .type = TSDB_DATA_TYPE_BIGINT, .bytes = 8}};
+
+    SArray       *pTableList = taosArrayInit(1, sizeof(STableKeyInfo));
+    STableKeyInfo info = {.uid = uid, .groupId = 0};
+    taosArrayPush(pTableList, &info);
+
+    memset(pCond, 0, sizeof(SQueryTableDataCond));
+    pCond->suid = SCAN_TEST_SUID;
+    pCond->order = order;
+    pCond->numOfCols = tListLen(cols);
+    pCond->colList = cols;
+    pCond->type = type;
+    pCond->twindows = w;
+    pCond->startVersion = -1;
+    pCond->endVersion = -1;
+
+    std::vector<int32_t> rows;
+    STsdbReader         *pReader = NULL;
+    EXPECT_EQ(tsdbReaderOpen(pVnode, pCond, pTableList, &pReader, "scanTest"), 0);
+    while (pReader != NULL && tsdbNextDataBlock(pReader)) {
+      SArray *pCols = tsdbRetrieveDataBlock(pReader, NULL);
+      EXPECT_NE(pCols, nullptr);
+      if (pCols == NULL) break;
+
+      SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pCols, 0);
+      SColumnInfoData *pV = (SColumnInfoData *)taosArrayGet(pCols, 1);
+      SDataBlockInfo   blockInfo = {0};
+      tsdbRetrieveDataBlockInfo(pReader, &blockInfo);
+      for (int32_t i = 0; i < blockInfo.rows; ++i) {
+        int32_t row = (int32_t)((*(int64_t *)colDataGetData(pTs, i) - start) / 10);
+        EXPECT_EQ(*(int64_t *)colDataGetData(pV, i), rowValue(uid, row));
+        rows.push_back(row);
+      }
+    }
+
+    tsdbReaderClose(pReader);
+    taosArrayDestroy(pTableList);
+    return rows;
+  }
+
+  // the window of the rows [from, to] of a table
+  STimeWindow rowWindow(int32_t from, int32_t to) { return (STimeWindow){.skey = start + from * 10, .ekey = start + to * 10}; }
+
+  // the rows [from, to] in the order of the scan
+  static std::vector<int32_t> rowRange(int32_t from, int32_t to, int32_t order) {
+    std::vector<int32_t> rows;
+    for (int32_t i = from; i <= to; ++i) {
+      rows.push_back(i);
+    }
+    if (order == TSDB_ORDER_DESC) {
+      std::reverse(rows.begin(), rows.end());
+    }
+    return rows;
+  }
+
+  SVnode       *pVnode = NULL;
+  SExecTaskInfo taskInfo = {0};
+  int64_t       version = 0;
+  int64_t       start = 0;
+};
+
+}  // namespace
+
+TEST_F(TableScanTest, parallelScan) {
+  const int32_t numOfTables = 7;
+  const int32_t numOfRows = 10000;
+
+  createTables(numOfTables);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 0, numOfRows);
+  }
+  createTableList(numOfTables);
+
+  // the workers are bounded by the threads of the pool, which is created by the first parallel scan
+  tsNumOfCores = 4;
+
+  SScanResult serial = scanAll(1);
+  checkResult(serial, numOfTables, numOfRows);
+
+  for (int8_t parallelism = 2; parallelism <= 4; ++parallelism) {
+    SScanResult parallel = scanAll(parallelism);
+    checkResult(parallel, numOfTables, numOfRows);
+  }
+}
+
+TEST_F(TableScanTest, parallelScanParksWorkers) {
+  const int32_t numOfTables = 8;
+  const int32_t numOfRows = 20000;
+
+  createTables(numOfTables);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 0, numOfRows);
+  }
+  createTableList(numOfTables);
+  tsNumOfCores = 4;
+
+  // a scan taking all the threads of the pool, with a consumer that stops after the first block
+  STableScanPhysiNode *pScan = createScanNode(4);
+  SOperatorInfo       *pOperator = createScanOperator(pScan);
+  ASSERT_NE(pOperator, nullptr);
+
+  SScanResult  result;
+  SSDataBlock *pBlock = pOperator->fpSet.getNextFn(pOperator);
+  ASSERT_NE(pBlock, nullptr);
+  collectBlock(pBlock, &result);
+
+  STableScanParaInfo *pPara = ((STableScanInfo *)pOperator->info)->pParaScan;
+  ASSERT_NE(pPara, nullptr);
+  ASSERT_EQ(pPara->numOfWorkers, 4);
+
+  // each worker still has blocks to load, so all of them end up parked on the full buffer
+  int32_t numOfParked = 0;
+  for (int32_t i = 0; i < 1000 && numOfParked < pPara->numOfWorkers; ++i) {
+    taosMsleep(10);
+    taosThreadMutexLock(&pPara->mutex);
+    numOfParked = taosArrayGetSize(pPara->pParked);
+    EXPECT_LE(taosArrayGetSize(pPara->pBlocks), pPara->capacity);
+    taosThreadMutexUnlock(&pPara->mutex);
+  }
+  ASSERT_EQ(numOfParked, pPara->numOfWorkers);
+  EXPECT_EQ(taosArrayGetSize(pPara->pBlocks), pPara->capacity);
+  EXPECT_EQ(pPara->numOfRunning, pPara->numOfWorkers);
+
+  // parked workers do not hold the threads of the pool, another scan runs through meanwhile
+  SScanResult other = scanAll(4);
+  checkResult(other, numOfTables, numOfRows);
+
+  // and the parked workers are resumed as the blocks are consumed
+  while ((pBlock = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+    collectBlock(pBlock, &result);
+  }
+  checkResult(result, numOfTables, numOfRows);
+  EXPECT_EQ(taosArrayGetSize(pPara->pParked), 0);
+  EXPECT_EQ(pPara->numOfRunning, 0);
+
+  destroyScanOperator(pOperator);
+  nodesDestroyNode((SNode *)pScan);
+}
+
+TEST_F(TableScanTest, parallelScanStopsParkedWorkers) {
+  const int32_t numOfTables = 8;
+  const int32_t numOfRows = 20000;
+
+  createTables(numOfTables);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 0, numOfRows);
+  }
+  createTableList(numOfTables);
+  tsNumOfCores = 4;
+
+  STableScanPhysiNode *pScan = createScanNode(4);
+  SOperatorInfo       *pOperator = createScanOperator(pScan);
+  ASSERT_NE(pOperator, nullptr);
+  ASSERT_NE(pOperator->fpSet.getNextFn(pOperator), nullptr);
+
+  STableScanParaInfo *pPara = ((STableScanInfo *)pOperator->info)->pParaScan;
+  ASSERT_NE(pPara, nullptr);
+  for (int32_t i = 0; i < 1000; ++i) {
+    taosThreadMutexLock(&pPara->mutex);
+    int32_t numOfParked = taosArrayGetSize(pPara->pParked);
+    taosThreadMutexUnlock(&pPara->mutex);
+    if (numOfParked > 0) break;
+    taosMsleep(10);
+  }
+
+  // closed before the scan is done, the parked workers are ended without being rescheduled
+  destroyScanOperator(pOperator);
+  nodesDestroyNode((SNode *)pScan);
+
+  SScanResult result = scanAll(4);
+  checkResult(result, numOfTables, numOfRows);
+}
+
+// an ordered scan with a limit returns the first rows of the scan without the limit, and stops reading once it has
+// returned them
+TEST_F(TableScanTest, scanLimit) {
+  const int32_t numOfTables = 3;
+  const int32_t numOfRows = 5000;
+  const int64_t total = numOfTables * numOfRows;
+
+  // the first rows of each table are in the data files, in blocks of 1000 rows, and the rest in memory
+  createTables(numOfTables);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 0, 3000);
+  }
+  commitTsdb();
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 3000, numOfRows);
+  }
+  createTableList(numOfTables);
+
+  int64_t  loaded = 0;
+  SScanSeq all = scanWithLimit(-1, 1, &loaded);
+  ASSERT_EQ(all.size(), total);
+  ASSERT_EQ(loaded, total);
+
+  int64_t limits[] = {1, 999, 1000, 1001, 3500, 4999, 5000, total - 1, total, total + 1, 10 * total};
+  for (int32_t i = 0; i < tListLen(limits); ++i) {
+    SCOPED_TRACE(testing::Message() << "limit:" << limits[i]);
+
+    SScanSeq seq = scanWithLimit(limits[i], 1, &loaded);
+    int64_t  expect = TMIN(limits[i], total);
+    ASSERT_EQ(seq.size(), expect);
+    EXPECT_TRUE(std::equal(seq.begin(), seq.end(), all.begin()));
+
+    // at most the block holding the last row is read past the limit
+    EXPECT_GE(loaded, expect);
+    EXPECT_LT(loaded, expect + 4096);
+  }
+
+  // a scan with a limit is not run in parallel, the workers would return the blocks out of order
+  tsNumOfCores = 4;
+  SScanSeq seq = scanWithLimit(2500, 4, &loaded);
+  ASSERT_EQ(seq.size(), 2500);
+  EXPECT_TRUE(std::equal(seq.begin(), seq.end(), all.begin()));
+}
+
+// with a filter, the columns not used by the filter are loaded for the qualified rows of a block only
+TEST_F(TableScanTest, filterLoadsDelayedColumns) {
+  const int32_t numOfTables = 3;
+  const int32_t numOfRows = 5000;
+
+  // the first rows of each table are in the data files, in blocks of 1000 rows, and the rest in memory. The rows
+  // written again for the first table are merged with its file block
+  createTables(numOfTables);
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 0, 3000);
+  }
+  commitTsdb();
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    insertRows(SCAN_TEST_UID + i, 3000, numOfRows);
+  }
+  insertRows(SCAN_TEST_UID, 1500, 1600);
+  createTableList(numOfTables);
+
+  int32_t orders[] = {TSDB_ORDER_ASC, TSDB_ORDER_DESC};
+  for (int32_t i = 0; i < tListLen(orders); ++i) {
+    SCOPED_TRACE(testing::Message() << "order:" << orders[i]);
+    bool delayed = false;
+
+    // the var-length column s is loaded after the filter on v
+    SScanResult result = scanWithFilter(makeValueFilter(), orders[i], &delayed);
+    EXPECT_TRUE(delayed);
+    checkFilterResult(result, numOfTables, numOfRows, orders[i], valueFilterRow);
+
+    // the fixed-length column v is loaded after the filter on s
+    result = scanWithFilter(makeStringFilter(), orders[i], &delayed);
+    EXPECT_TRUE(delayed);
+    checkFilterResult(result, numOfTables, numOfRows, orders[i], stringFilterRow);
+  }
+}
+
+// a window that starts and ends inside file blocks returns the rows in it only, in both orders
+TEST_F(TableScanTest, readerPartialWindow) {
+  createTables(1);
+  insertRows(SCAN_TEST_UID, 0, 3000);
+  commitTsdb();
+
+  int32_t orders[] = {TSDB_ORDER_ASC, TSDB_ORDER_DESC};
+  for (int32_t o = 0; o < tListLen(orders); ++o) {
+    SCOPED_TRACE(testing::Message() << "order:" << orders[o]);
+    SQueryTableDataCond cond;
+
+    // in one block, across two blocks, and from inside a block to the end
+    EXPECT_EQ(readRows(SCAN_TEST_UID, TIMEWINDOW_RANGE_CONTAINED, orders[o], rowWindow(1100, 1200), &cond),
+              rowRange(1100, 1200, orders[o]));
+    EXPECT_EQ(readRows(SCAN_TEST_UID, TIMEWINDOW_RANGE_CONTAINED, orders[o], rowWindow(1505, 2505), &cond),
+              rowRange(1505, 2505, orders[o]));
+    EXPECT_EQ(readRows(SCAN_TEST_UID, TIMEWINDOW_RANGE_CONTAINED, orders[o], rowWindow(2500, 3500), &cond),
+              rowRange(2500, 2999, orders[o]));
+  }
+}
+
+// a reader of an external range returns the rows in the range, the row before it and the row after it, whether the
+// rows are in the data files or in memory
+TEST_F(TableScanTest, readerExternalRange) {
+  createTables(2);
+  insertRows(SCAN_TEST_UID, 0, 3000);
+  commitTsdb();
+  insertRows(SCAN_TEST_UID + 1, 0, 3000);
+
+  STimeWindow w = {.skey = start + 1000 * 10 + 5, .ekey = start + 2000 * 10 + 5};
+  for (uint64_t uid = SCAN_TEST_UID; uid <= SCAN_TEST_UID + 1; ++uid) {
+    int32_t orders[] = {TSDB_ORDER_ASC, TSDB_ORDER_DESC};
+    for (int32_t o = 0; o < tListLen(orders); ++o) {
+      SCOPED_TRACE(testing::Message() << "uid:" << uid << " order:" << orders[o]);
+      SQueryTableDataCond cond;
+
+      EXPECT_EQ(readRows(uid, TIMEWINDOW_RANGE_EXTERNAL, orders[o], w, &cond), rowRange(1000, 2001, orders[o]));
+
+      // the condition of the caller is not changed by the inner readers
+      EXPECT_EQ(cond.order, orders[o]);
+      EXPECT_EQ(cond.twindows.skey, w.skey);
+      EXPECT_EQ(cond.twindows.ekey, w.ekey);
+    }
+  }
+
+  // no row before or after the range
+  SQueryTableDataCond cond;
+  EXPECT_EQ(readRows(SCAN_TEST_UID, TIMEWINDOW_RANGE_EXTERNAL, TSDB_ORDER_ASC, rowWindow(-10, 3010), &cond),
+            rowRange(0, 2999, TSDB_ORDER_ASC));
+}
+
+// a reader of an external range closed before all of it is read
+TEST_F(TableScanTest, readerExternalRangeClose) {
+  createTables(1);
+  insertRows(SCAN_TEST_UID, 0, 3000);
+  commitTsdb();
+
+  SColumnInfo   cols[] = {{.colId = 1, .type = TSDB_DATA_TYPE_TIMESTAMP, .bytes = 8}};
+  SArray       *pTableList = taosArrayInit(1, sizeof(STableKeyInfo));
+  STableKeyInfo info = {.uid = SCAN_TEST_UID, .groupId = 0};
+  taosArrayPush(pTableList, &info);
+
+  for (int32_t numOfBlocks = 0; numOfBlocks < 3; ++numOfBlocks) {
+    SQueryTableDataCond cond = {0};
+    cond.suid = SCAN_TEST_SUID;
+    cond.order = TSDB_ORDER_ASC;
+    cond.numOfCols = tListLen(cols);
+    cond.colList = cols;
+    cond.type = TIMEWINDOW_RANGE_EXTERNAL;
+    cond.twindows = (STimeWindow){.skey = start + 1000 * 10 + 5, .ekey = start + 2000 * 10 + 5};
+    cond.startVersion = -1;
+    cond.endVersion = -1;
+
+    STsdbReader *pReader = NULL;
+    ASSERT_EQ(tsdbReaderOpen(pVnode, &cond, pTableList, &pReader, "scanTest"), 0);
+    for (int32_t i = 0; i < numOfBlocks; ++i) {
+      ASSERT_TRUE(tsdbNextDataBlock(pReader));
+    }
+    tsdbReaderClose(pReader);
+  }
+
+  taosArrayDestroy(pTableList);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "taos.h"
+#include "tgrouphash.h"
+#include "thash.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+TEST(testCase, tGroupHashTest_intKey) {
+  SGroupHashObj *pHashObj = tGroupHashInit(8, sizeof(int64_t), sizeof(int64_t));
+  ASSERT_NE(pHashObj, nullptr);
+  ASSERT_EQ(0, tGroupHashGetSize(pHashObj));
+
+  bool isNew = false;
+  for (int64_t i = 1; i <= 10000; ++i) {
+    int32_t index = tGroupHashPut(pHashObj, &i, sizeof(int64_t), tGroupHashMix64(i), &isNew);
+    ASSERT_TRUE(isNew);
+    ASSERT_EQ(i - 1, index);
+    ASSERT_EQ(0, *(int64_t *)tGroupHashGetData(pHashObj, index));
+    *(int64_t *)tGroupHashGetData(pHashObj, index) = i * 2;
+  }
+
+  ASSERT_EQ(10000, tGroupHashGetSize(pHashObj));
+
+  for (int64_t i = 1; i <= 10000; ++i) {
+    int32_t index = tGroupHashPut(pHashObj, &i, sizeof(int64_t), tGroupHashMix64(i), &isNew);
+    ASSERT_FALSE(isNew);
+    ASSERT_EQ(i * 2, *(int64_t *)tGroupHashGetData(pHashObj, index));
+
+    int32_t keyLen = 0;
+    ASSERT_EQ(i, *(int64_t *)tGroupHashGetKey(pHashObj, index, &keyLen));
+    ASSERT_EQ(sizeof(int64_t), keyLen);
+  }
+
+  tGroupHashClear(pHashObj);
+  ASSERT_EQ(0, tGroupHashGetSize(pHashObj));
+
+  int64_t key = 10;
+  ASSERT_EQ(0, tGroupHashPut(pHashObj, &key, sizeof(int64_t), tGroupHashMix64(key), &isNew));
+  ASSERT_TRUE(isNew);
+
+  tGroupHashCleanup(pHashObj);
+}
+
+TEST(testCase, tGroupHashTest_binaryKey) {
+  // long keys are kept outside of the entries
+  for (int32_t maxKeyLen : {32, 512}) {
+    SGroupHashObj *pHashObj = tGroupHashInit(4, maxKeyLen, sizeof(int32_t));
+    ASSERT_NE(pHashObj, nullptr);
+
+    char    key[512] = {0};
+    bool    isNew = false;
+    int32_t num = 2000;
+    for (int32_t i = 0; i < num; ++i) {
+      int32_t len = snprintf(key, maxKeyLen, "group_key_%d", i * 7);
+      int32_t index = tGroupHashPut(pHashObj, key, len, tGroupHashCalc(key, len), &isNew);
+      ASSERT_TRUE(isNew);
+      *(int32_t *)tGroupHashGetData(pHashObj, index) = i;
+    }
+
+    for (int32_t i = 0; i < num; ++i) {
+      int32_t len = snprintf(key, maxKeyLen, "group_key_%d", i * 7);
+      int32_t index = tGroupHashPut(pHashObj, key, len, tGroupHashCalc(key, len), &isNew);
+      ASSERT_FALSE(isNew);
+      ASSERT_EQ(i, *(int32_t *)tGroupHashGetData(pHashObj, index));
+
+      int32_t keyLen = 0;
+      char   *pKey = (char *)tGroupHashGetKey(pHashObj, index, &keyLen);
+      ASSERT_EQ(len, keyLen);
+      ASSERT_EQ(0, memcmp(pKey, key, len));
+    }
+
+    // a prefix of an existing key is another key
+    int32_t len = snprintf(key, maxKeyLen, "group_key_");
+    tGroupHashPut(pHashObj, key, len, tGroupHashCalc(key, len), &isNew);
+    ASSERT_TRUE(isNew);
+    ASSERT_EQ(num + 1, tGroupHashGetSize(pHashObj));
+
+    tGroupHashCleanup(pHashObj);
+  }
+}
+
+TEST(testCase, tGroupHashTest_get) {
+  SGroupHashObj *pHashObj = tGroupHashInit(8, sizeof(int64_t), sizeof(int32_t));
+  ASSERT_NE(pHashObj, nullptr);
+
+  int64_t key = 1;
+  ASSERT_EQ(-1, tGroupHashGet(pHashObj, &key, sizeof(int64_t), tGroupHashMix64(key)));
+
+  bool isNew = false;
+  for (int64_t i = 0; i < 1000; i += 2) {
+    tGroupHashPut(pHashObj, &i, sizeof(int64_t), tGroupHashMix64(i), &isNew);
+  }
+
+  // lookups never add new entries
+  for (int64_t i = 0; i < 1000; ++i) {
+    int32_t index = tGroupHashGet(pHashObj, &i, sizeof(int64_t), tGroupHashMix64(i));
+    if (i % 2 == 0) {
+      ASSERT_EQ(i / 2, index);
+    } else {
+      ASSERT_EQ(-1, index);
+    }
+  }
+  ASSERT_EQ(500, tGroupHashGetSize(pHashObj));
+
+  tGroupHashCleanup(pHashObj);
+}
+
+TEST(testCase, tGroupHashTest_batch) {
+  SGroupHashObj *pHashObj = tGroupHashInit(16, sizeof(int64_t), 0);
+  ASSERT_NE(pHashObj, nullptr);
+
+  int32_t   num = 4096;
+  int64_t  *pKeys = (int64_t *)taosMemoryCalloc(num, sizeof(int64_t));
+  uint64_t *pHashes = (uint64_t *)taosMemoryCalloc(num, sizeof(uint64_t));
+  int32_t  *pIndex = (int32_t *)taosMemoryCalloc(num, sizeof(int32_t));
+
+  // 1000 distinct keys in each round, half of them are new ones
+  for (int32_t round = 0; round < 3; ++round) {
+    for (int32_t i = 0; i < num; ++i) {
+      pKeys[i] = (i * 7919) % 1000 + round * 500;
+      pHashes[i] = tGroupHashMix64(pKeys[i]);
+    }
+
+    int32_t prevSize = tGroupHashGetSize(pHashObj);
+    ASSERT_EQ(0, tGroupHashBatchPut(pHashObj, (const char *)pKeys, sizeof(int64_t), pHashes, num, pIndex));
+    ASSERT_EQ(1000 + round * 500, tGroupHashGetSize(pHashObj));
+
+    int32_t next = prevSize;
+    for (int32_t i = 0; i < num; ++i) {
+      ASSERT_EQ(pKeys[i], *(int64_t *)tGroupHashGetKey(pHashObj, pIndex[i], NULL));
+      if (pIndex[i] >= prevSize) {
+        // the new entries are created in the order of their first occurrence
+        ASSERT_LE(pIndex[i], next);
+        if (pIndex[i] == next) {
+          next += 1;
+        }
+      }
+    }
+    ASSERT_EQ(tGroupHashGetSize(pHashObj), next);
+  }
+
+  taosMemoryFree(pKeys);
+  taosMemoryFree(pHashes);
+  taosMemoryFree(pIndex);
+  tGroupHashCleanup(pHashObj);
+}
+
+#pragma GCC diagnostic pop
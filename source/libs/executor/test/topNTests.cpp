@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <tglobal.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "os.h"
+
+#include "executorimpl.h"
+#include "nodes.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+enum {
+  topn_input_block = 1,
+  topn_res_block = 2,
+};
+
+// rows i of the input, in a shuffled order: k int = i % mod, NULL for every nullEvery-th row, v bigint = i,
+// s varchar = "s<i>"
+typedef struct STopNInput {
+  std::vector<int64_t> order;
+  int32_t              mod;
+  int32_t              nullEvery;
+  int32_t              pos;
+  SSDataBlock*         pBlock;
+} STopNInput;
+
+typedef struct STopNRow {
+  bool    isNull;
+  int32_t k;
+  int64_t v;
+} STopNRow;
+
+bool topNKeyIsNull(int32_t nullEvery, int64_t v) { return nullEvery > 0 && v % nullEvery == 0; }
+
+SSDataBlock* getTopNInputBlock(SOperatorInfo* pOperator) {
+  STopNInput* pInput = static_cast<STopNInput*>(pOperator->info);
+  if (pInput->pos >= (int32_t)pInput->order.size()) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInput->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, 1000);
+
+  SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+  SColumnInfoData* pStrCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 2));
+
+  int32_t row = 0;
+  for (; row < 1000 && pInput->pos < (int32_t)pInput->order.size(); ++row, ++pInput->pos) {
+    int64_t v = pInput->order[pInput->pos];
+    int32_t k = v % pInput->mod;
+    char    s[32];
+    snprintf(varDataVal(s), sizeof(s) - VARSTR_HEADER_SIZE, "s%" PRId64, v);
+    varDataSetLen(s, strlen(varDataVal(s)));
+
+    if (topNKeyIsNull(pInput->nullEvery, v)) {
+      colDataAppendNULL(pKeyCol, row);
+    } else {
+      colDataAppend(pKeyCol, row, reinterpret_cast<const char*>(&k), false);
+    }
+    colDataAppend(pValCol, row, reinterpret_cast<const char*>(&v), false);
+    colDataAppend(pStrCol, row, s, false);
+  }
+
+  pBlock->info.rows = row;
+  return pBlock;
+}
+
+SOperatorInfo* createTopNInputOperator(int32_t rows, int32_t mod, int32_t nullEvery, bool shuffle) {
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  STopNInput*    pInput = new STopNInput();
+  pInput->mod = mod;
+  pInput->nullEvery = nullEvery;
+  pInput->pos = 0;
+  for (int64_t i = 0; i < rows; ++i) {
+    pInput->order.push_back(i);
+  }
+  if (shuffle) {
+    for (int32_t i = rows - 1; i > 0; --i) {
+      std::swap(pInput->order[i], pInput->order[taosRand() % (i + 1)]);
+    }
+  }
+
+  pInput->pBlock = createDataBlock();
+  pInput->pBlock->info.blockId = topn_input_block;
+
+  SColumnInfoData k = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData v = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  SColumnInfoData s = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 24 + VARSTR_HEADER_SIZE, 3);
+  blockDataAppendColInfo(pInput->pBlock, &k);
+  blockDataAppendColInfo(pInput->pBlock, &v);
+  blockDataAppendColInfo(pInput->pBlock, &s);
+
+  pOperator->name = "topNInputOperator4Test";
+  pOperator->info = pInput;
+  pOperator->resultDataBlockId = topn_input_block;
+  pOperator->fpSet.getNextFn = getTopNInputBlock;
+  return pOperator;
+}
+
+void destroyTopNInputOperator(SOperatorInfo* pOperator) {
+  STopNInput* pInput = static_cast<STopNInput*>(pOperator->info);
+  blockDataDestroy(pInput->pBlock);
+  delete pInput;
+  taosMemoryFree(pOperator);
+}
+
+SNode* makeTopNColumn(int16_t blockId, int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = reinterpret_cast<SColumnNode*>(nodesMakeNode(QUERY_NODE_COLUMN));
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return reinterpret_cast<SNode*>(pCol);
+}
+
+typedef struct STopNKey {
+  int16_t slotId;
+  bool    asc;
+  bool    nullFirst;
+} STopNKey;
+
+// SELECT k, v, s FROM input ORDER BY <keys> LIMIT limit OFFSET offset
+SSortPhysiNode* createTopNSortNode(const std::vector<STopNKey>& keys, int64_t limit, int64_t offset) {
+  SSortPhysiNode* pSort = reinterpret_cast<SSortPhysiNode*>(nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_SORT));
+  pSort->node.pOutputDataBlockDesc = reinterpret_cast<SDataBlockDescNode*>(nodesMakeNode(QUERY_NODE_DATABLOCK_DESC));
+  pSort->node.pOutputDataBlockDesc->dataBlockId = topn_res_block;
+
+  int8_t  types[] = {TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_VARCHAR};
+  int32_t bytes[] = {sizeof(int32_t), sizeof(int64_t), 24 + VARSTR_HEADER_SIZE};
+  for (int16_t i = 0; i < 3; ++i) {
+    STargetNode* pTarget = reinterpret_cast<STargetNode*>(nodesMakeNode(QUERY_NODE_TARGET));
+    pTarget->dataBlockId = topn_res_block;
+    pTarget->slotId = i;
+    pTarget->pExpr = makeTopNColumn(topn_input_block, i, types[i], bytes[i]);
+    nodesListMakeAppend(&pSort->pTargets, reinterpret_cast<SNode*>(pTarget));
+
+    SSlotDescNode* pSlot = reinterpret_cast<SSlotDescNode*>(nodesMakeNode(QUERY_NODE_SLOT_DESC));
+    pSlot->slotId = i;
+    pSlot->dataType.type = types[i];
+    pSlot->dataType.bytes = bytes[i];
+    pSlot->output = true;
+    nodesListMakeAppend(&pSort->node.pOutputDataBlockDesc->pSlots, reinterpret_cast<SNode*>(pSlot));
+  }
+
+  for (const STopNKey& key : keys) {
+    SOrderByExprNode* pOrder = reinterpret_cast<SOrderByExprNode*>(nodesMakeNode(QUERY_NODE_ORDER_BY_EXPR));
+    pOrder->pExpr = makeTopNColumn(topn_input_block, key.slotId, types[key.slotId], bytes[key.slotId]);
+    pOrder->order = key.asc ? ORDER_ASC : ORDER_DESC;
+    pOrder->nullOrder = key.nullFirst ? NULL_ORDER_FIRST : NULL_ORDER_LAST;
+    nodesListMakeAppend(&pSort->pSortKeys, reinterpret_cast<SNode*>(pOrder));
+  }
+
+  SLimitNode* pLimit = reinterpret_cast<SLimitNode*>(nodesMakeNode(QUERY_NODE_LIMIT));
+  pLimit->limit = limit;
+  pLimit->offset = offset;
+  pSort->node.pLimit = reinterpret_cast<SNode*>(pLimit);
+  return pSort;
+}
+
+// -1, 0 or 1 as the first row goes before, the same as, or after the second one in the order of the keys
+int32_t compareTopNRow(const std::vector<STopNKey>& keys, const STopNRow& left, const STopNRow& right) {
+  for (const STopNKey& key : keys) {
+    if (key.slotId == 0) {
+      if (left.isNull && right.isNull) {
+        continue;
+      }
+      if (left.isNull || right.isNull) {
+        return (left.isNull == key.nullFirst) ? -1 : 1;
+      }
+      if (left.k != right.k) {
+        return ((left.k < right.k) == key.asc) ? -1 : 1;
+      }
+    } else if (left.v != right.v) {
+      return ((left.v < right.v) == key.asc) ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+// the rows returned by the sort operator, the k and s of each row are checked against its v
+std::vector<STopNRow> runTopN(int32_t rows, int32_t mod, int32_t nullEvery, const std::vector<STopNKey>& keys,
+                              int64_t limit, int64_t offset, bool* pIsTopN) {
+  SExecTaskInfo   taskInfo = {0};
+  SOperatorInfo*  pInput = createTopNInputOperator(rows, mod, nullEvery, true);
+  SSortPhysiNode* pSort = createTopNSortNode(keys, limit, offset);
+
+  std::vector<STopNRow> res;
+  taskInfo.id.str = const_cast<char*>("topNTest");
+  SOperatorInfo* pOperator = createSortOperatorInfo(pInput, pSort, &taskInfo);
+  EXPECT_NE(pOperator, nullptr);
+  if (pOperator == NULL) {
+    nodesDestroyNode(reinterpret_cast<SNode*>(pSort));
+    destroyTopNInputOperator(pInput);
+    return res;
+  }
+
+  *pIsTopN = (strcmp(pOperator->name, "TopNOperator") == 0);
+
+  SSDataBlock* pBlock = NULL;
+  while ((pBlock = pOperator->fpSet.getNextFn(pOperator)) != NULL) {
+    SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+    SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+    SColumnInfoData* pStrCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 2));
+    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+      STopNRow row = {0};
+      row.v = *(int64_t*)colDataGetData(pValCol, i);
+      row.isNull = colDataIsNull_s(pKeyCol, i);
+      if (!row.isNull) {
+        row.k = *(int32_t*)colDataGetData(pKeyCol, i);
+        EXPECT_EQ(row.k, row.v % mod);
+      }
+      EXPECT_EQ(row.isNull, topNKeyIsNull(nullEvery, row.v));
+
+      char*       s = colDataGetData(pStrCol, i);
+      std::string expect = "s" + std::to_string(row.v);
+      EXPECT_EQ(std::string(varDataVal(s), varDataLen(s)), expect);
+      res.push_back(row);
+    }
+  }
+  EXPECT_EQ(pOperator->status, OP_EXEC_DONE);
+
+  pOperator->fpSet.closeFn(pOperator->info);
+  taosMemoryFree(pOperator->pDownstream);
+  taosMemoryFree(pOperator);
+  nodesDestroyNode(reinterpret_cast<SNode*>(pSort));
+  destroyTopNInputOperator(pInput);
+  return res;
+}
+
+// the TopN result in the order of the keys, compared with a full sort of the input. Rows tied on all the keys may
+// come in any order, and at the limit any of them may be kept, so only the keys of the rows are compared.
+void checkTopN(int32_t rows, int32_t mod, int32_t nullEvery, const std::vector<STopNKey>& keys, int64_t limit,
+               int64_t offset) {
+  SCOPED_TRACE(testing::Message() << "rows:" << rows << " limit:" << limit << " offset:" << offset);
+
+  bool                  isTopN = false;
+  std::vector<STopNRow> res = runTopN(rows, mod, nullEvery, keys, limit, offset, &isTopN);
+  EXPECT_TRUE(isTopN);
+
+  std::vector<STopNRow> all;
+  for (int64_t v = 0; v < rows; ++v) {
+    STopNRow row = {topNKeyIsNull(nullEvery, v), (int32_t)(v % mod), v};
+    all.push_back(row);
+  }
+  std::stable_sort(all.begin(), all.end(),
+                   [&](const STopNRow& l, const STopNRow& r) { return compareTopNRow(keys, l, r) < 0; });
+
+  int64_t begin = TMIN(offset, rows);
+  int64_t end = TMIN(offset + limit, rows);
+  ASSERT_EQ(res.size(), end - begin);
+
+  std::set<int64_t> uniq;
+  for (int64_t i = begin; i < end; ++i) {
+    const STopNRow& row = res[i - begin];
+    ASSERT_EQ(compareTopNRow(keys, row, all[i]), 0) << "row " << i;
+    ASSERT_TRUE(uniq.insert(row.v).second);
+  }
+}
+
+}  // namespace
+
+TEST(topNTest, uniqueKeys) {
+  taosSeedRand(taosGetTimestampSec());
+
+  std::vector<STopNKey> keys = {{1, true, false}};
+  checkTopN(5000, 7, 0, keys, 10, 0);
+  checkTopN(5000, 7, 0, keys, 10, 100);
+  checkTopN(5000, 7, 0, keys, 1, 4999);
+
+  keys = {{1, false, false}};
+  checkTopN(5000, 7, 0, keys, 100, 0);
+  checkTopN(5000, 7, 0, keys, 3000, 1000);
+}
+
+// most rows are tied on the key, the rows at the limit are any of the tied ones
+TEST(topNTest, ties) {
+  std::vector<STopNKey> keys = {{0, true, false}};
+  checkTopN(5000, 7, 0, keys, 10, 0);
+  checkTopN(5000, 7, 0, keys, 700, 10);
+  checkTopN(5000, 3, 0, keys, 2000, 1500);
+
+  // the ties are broken by the second key
+  keys = {{0, false, false}, {1, true, false}};
+  checkTopN(5000, 7, 0, keys, 20, 0);
+  checkTopN(5000, 7, 0, keys, 800, 700);
+}
+
+TEST(topNTest, nullKeys) {
+  std::vector<STopNKey> keys = {{0, true, true}, {1, true, false}};
+  checkTopN(5000, 11, 5, keys, 50, 0);
+  checkTopN(5000, 11, 5, keys, 50, 990);
+
+  keys = {{0, true, false}, {1, false, false}};
+  checkTopN(5000, 11, 5, keys, 50, 0);
+  checkTopN(5000, 11, 5, keys, 200, 4000);
+}
+
+// the limit and the offset cover more rows than the input has
+TEST(topNTest, limitLargerThanInput) {
+  std::vector<STopNKey> keys = {{0, false, false}, {1, true, false}};
+  checkTopN(50, 7, 0, keys, 1000, 0);
+  checkTopN(50, 7, 0, keys, 1000, 10);
+  checkTopN(50, 7, 0, keys, 10, 45);
+  checkTopN(50, 7, 0, keys, 10, 50);
+  checkTopN(50, 7, 0, keys, 10, 500);
+  checkTopN(0, 7, 0, keys, 10, 0);
+}
+
+// the replaced var data of the candidates is compacted many times over
+TEST(topNTest, replaceVarData) {
+  std::vector<STopNKey> keys = {{1, false, false}};
+  checkTopN(60000, 13, 0, keys, 100, 0);
+  checkTopN(60000, 13, 0, keys, 1500, 20);
+}
+
+// a sort without limit, or with a limit too large to keep in memory, is not run as a TopN
+TEST(topNTest, fallBackToSort) {
+  std::vector<STopNKey> keys = {{1, true, false}};
+  bool                  isTopN = true;
+
+  std::vector<STopNRow> res = runTopN(100, 7, 0, keys, 70000, 0, &isTopN);
+  EXPECT_FALSE(isTopN);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TVECAGG_H
+#define TDENGINE_TVECAGG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tcommon.h"
+
+/*
+ * Block-at-a-time kernels for the core aggregate functions. Every kernel works on the rows
+ * [start, start + numOfRows) of a fixed-length numeric column and skips the NULL rows. Blocks without NULL rows
+ * take a branch-free path, blocks with NULL rows are processed eight rows (one bitmap byte) at a time with the
+ * bitmap turned into a lane mask. The AVX2 kernels are picked at runtime when the cpu supports them, the scalar
+ * ones are used otherwise.
+ */
+
+/**
+ * Resolve the kernels from the cpu flags, the scalar kernels are used until it is called.
+ */
+void vecAggInit();
+
+/**
+ * Add the non-null values to *pSum, which is an int64_t for the signed integer and bool types, an uint64_t for the
+ * unsigned integer types and a double for float and double.
+ * @return the number of non-null rows
+ */
+int32_t vecSumColumn(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, void* pSum);
+
+/**
+ * Find the min (isMin) or max non-null value. pRes receives the value in the column type and, when pIndex is not
+ * NULL, *pIndex receives the first row holding it. Both are left untouched if all rows are NULL.
+ * @return the number of non-null rows
+ */
+int32_t vecMinMaxColumn(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin, void* pRes,
+                        int32_t* pIndex);
+
+/**
+ * @return the number of non-null rows of a fixed-length column
+ */
+int32_t vecCountColumn(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows);
+
+/**
+ * Switch between the SIMD and the scalar kernels, mostly for benchmarks and tests. Not thread safe, and only takes
+ * effect after vecAggInit.
+ * @return true if the SIMD kernels are in use afterwards
+ */
+bool vecAggSetSimd(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TVECAGG_H
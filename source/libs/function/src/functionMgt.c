@@ -21,6 +21,7 @@
 #include "taoserror.h"
 #include "thash.h"
 #include "tudf.h"
+#include "tvecagg.h"
 
 typedef struct SFuncMgtService {
   SHashObj* pFuncNameHashTable;
@@ -36,6 +37,8 @@ static TdThreadOnce    functionHashTableInit = PTHREAD_ONCE_INIT;
 static int32_t         initFunctionCode = 0;
 
 static void doInitFunctionTable() {
+  vecAggInit();
+
   gFunMgtService.pFuncNameHashTable =
       taosHashInit(funcMgtBuiltinsNum, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
   if (NULL == gFunMgtService.pFuncNameHashTable) {
@@ -0,0 +1,815 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// the intrinsics headers go before os.h, which forbids malloc/free
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(_TD_ARM_) && \
+    !defined(_TD_MIPS_) && !defined(WINDOWS)
+#define VECAGG_AVX2
+#include <immintrin.h>
+#define AVX2_FUNC __attribute__((target("avx2")))
+#endif
+
+#include "tvecagg.h"
+#include "tdatablock.h"
+
+// resolved once by vecAggInit, the kernels only read the flag
+static bool vecAggCpuAvx2 = false;
+static bool vecAggAvx2 = false;
+
+void vecAggInit() {
+#ifdef VECAGG_AVX2
+  __builtin_cpu_init();
+  vecAggCpuAvx2 = __builtin_cpu_supports("avx2");
+#endif
+  vecAggAvx2 = vecAggCpuAvx2;
+}
+
+static FORCE_INLINE bool useAvx2() { return vecAggAvx2; }
+
+bool vecAggSetSimd(bool enable) {
+  vecAggAvx2 = enable && vecAggCpuAvx2;
+  return vecAggAvx2;
+}
+
+// a NULL bitmap means no NULL rows
+static FORCE_INLINE const uint8_t* getNullBitmap(const SColumnInfoData* pCol) {
+  return (pCol->hasNull && pCol->nullbitmap != NULL) ? (const uint8_t*)pCol->nullbitmap : NULL;
+}
+
+/*
+ * scalar kernels
+ */
+#define SCALAR_SUM(_name, _t, _acc_t)                                                           \
+  static int32_t _name(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, _acc_t* pSum) { \
+    const _t*      d = (const _t*)pCol->pData;                                                  \
+    const uint8_t* bm = getNullBitmap(pCol);                                                    \
+    int32_t        end = start + numOfRows;                                                     \
+    int32_t        num = 0;                                                                     \
+    int32_t        i = start;                                                                   \
+    _acc_t         s = 0;                                                                       \
+                                                                                                \
+    if (bm == NULL) {                                                                           \
+      for (; i < end; ++i) {                                                                    \
+        s += d[i];                                                                              \
+      }                                                                                         \
+      *pSum += s;                                                                               \
+      return numOfRows;                                                                         \
+    }                                                                                           \
+                                                                                                \
+    for (; i < end && BitPos(i) != 0; ++i) {                                                    \
+      if (!colDataIsNull_f(bm, i)) {                                                            \
+        s += d[i];                                                                              \
+        num += 1;                                                                               \
+      }                                                                                         \
+    }                                                                                           \
+                                                                                                \
+    for (; i + 8 <= end; i += 8) {                                                              \
+      uint8_t b = bm[i >> NBIT];                                                                \
+      if (b == 0) {                                                                             \
+        s += d[i];                                                                              \
+        s += d[i + 1];                                                                          \
+        s += d[i + 2];                                                                          \
+        s += d[i + 3];                                                                          \
+        s += d[i + 4];                                                                          \
+        s += d[i + 5];                                                                          \
+        s += d[i + 6];                                                                          \
+        s += d[i + 7];                                                                          \
+        num += 8;                                                                               \
+      } else if (b != 0xFF) {                                                                   \
+        for (int32_t j = 0; j < 8; ++j) {                                                       \
+          if ((b & (0x80u >> j)) == 0) {                                                        \
+            s += d[i + j];                                                                      \
+            num += 1;                                                                           \
+          }                                                                                     \
+        }                                                                                       \
+      }                                                                                         \
+    }                                                                                           \
+                                                                                                \
+    for (; i < end; ++i) {                                                                      \
+      if (!colDataIsNull_f(bm, i)) {                                                            \
+        s += d[i];                                                                              \
+        num += 1;                                                                               \
+      }                                                                                         \
+    }                                                                                           \
+                                                                                                \
+    *pSum += s;                                                                                 \
+    return num;                                                                                 \
+  }
+
+SCALAR_SUM(sumI8, int8_t, int64_t)
+SCALAR_SUM(sumI16, int16_t, int64_t)
+SCALAR_SUM(sumI32, int32_t, int64_t)
+SCALAR_SUM(sumI64, int64_t, int64_t)
+SCALAR_SUM(sumU8, uint8_t, uint64_t)
+SCALAR_SUM(sumU16, uint16_t, uint64_t)
+SCALAR_SUM(sumU32, uint32_t, uint64_t)
+SCALAR_SUM(sumU64, uint64_t, uint64_t)
+SCALAR_SUM(sumFloat, float, double)
+SCALAR_SUM(sumDouble, double, double)
+
+// fold one row into the running min/max, the first non-null row is taken as it is
+#define MINMAX_ROW(_v, _assigned, _x, _isMin)         \
+  do {                                                \
+    if (!(_assigned)) {                               \
+      (_v) = (_x);                                    \
+      (_assigned) = true;                             \
+    } else if ((_isMin) ? (_x) < (_v) : (_x) > (_v)) { \
+      (_v) = (_x);                                    \
+    }                                                 \
+  } while (0)
+
+#define SCALAR_MINMAX(_name, _t)                                                                         \
+  static int32_t _name(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin, _t* pRes) { \
+    const _t*      d = (const _t*)pCol->pData;                                                           \
+    const uint8_t* bm = getNullBitmap(pCol);                                                             \
+    int32_t        end = start + numOfRows;                                                              \
+    int32_t        num = 0;                                                                              \
+    bool           assigned = false;                                                                     \
+    _t             v = 0;                                                                                \
+                                                                                                         \
+    for (int32_t i = start; i < end; ++i) {                                                              \
+      if (bm != NULL) {                                                                                  \
+        uint8_t b = bm[i >> NBIT];                                                                       \
+        if (b == 0xFF && BitPos(i) == 0 && i + 8 <= end) {                                               \
+          i += 7;                                                                                        \
+          continue;                                                                                      \
+        }                                                                                                \
+        if (colDataIsNull_f(bm, i)) {                                                                    \
+          continue;                                                                                      \
+        }                                                                                                \
+      }                                                                                                  \
+                                                                                                         \
+      MINMAX_ROW(v, assigned, d[i], isMin);                                                              \
+      num += 1;                                                                                          \
+    }                                                                                                    \
+                                                                                                         \
+    if (num > 0) {                                                                                       \
+      *pRes = v;                                                                                         \
+    }                                                                                                    \
+    return num;                                                                                          \
+  }
+
+SCALAR_MINMAX(minmaxI8, int8_t)
+SCALAR_MINMAX(minmaxI16, int16_t)
+SCALAR_MINMAX(minmaxI32, int32_t)
+SCALAR_MINMAX(minmaxI64, int64_t)
+SCALAR_MINMAX(minmaxU8, uint8_t)
+SCALAR_MINMAX(minmaxU16, uint16_t)
+SCALAR_MINMAX(minmaxU32, uint32_t)
+SCALAR_MINMAX(minmaxU64, uint64_t)
+SCALAR_MINMAX(minmaxFloat, float)
+SCALAR_MINMAX(minmaxDouble, double)
+
+// first non-null row equal to the given value, or the first non-null row if there is no such row (NaN)
+#define FIND_FIRST(_name, _t)                                                                             \
+  static int32_t _name(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, _t val) {          \
+    const _t*      d = (const _t*)pCol->pData;                                                            \
+    const uint8_t* bm = getNullBitmap(pCol);                                                              \
+    int32_t        first = -1;                                                                            \
+    for (int32_t i = start; i < start + numOfRows; ++i) {                                                 \
+      if (bm != NULL && colDataIsNull_f(bm, i)) {                                                         \
+        continue;                                                                                         \
+      }                                                                                                   \
+      if (d[i] == val) {                                                                                  \
+        return i;                                                                                         \
+      }                                                                                                   \
+      if (first == -1) {                                                                                  \
+        first = i;                                                                                        \
+      }                                                                                                   \
+    }                                                                                                     \
+    return first;                                                                                         \
+  }
+
+FIND_FIRST(findFirstI8, int8_t)
+FIND_FIRST(findFirstI16, int16_t)
+FIND_FIRST(findFirstI32, int32_t)
+FIND_FIRST(findFirstI64, int64_t)
+FIND_FIRST(findFirstU8, uint8_t)
+FIND_FIRST(findFirstU16, uint16_t)
+FIND_FIRST(findFirstU32, uint32_t)
+FIND_FIRST(findFirstU64, uint64_t)
+FIND_FIRST(findFirstFloat, float)
+FIND_FIRST(findFirstDouble, double)
+
+#ifdef VECAGG_AVX2
+/*
+ * AVX2 kernels, eight rows are processed per step so that each step consumes exactly one byte of the null bitmap.
+ * The rows before the first byte boundary and after the last one go through the scalar code.
+ */
+
+// lane masks of the non-null rows, row i + k of the step is lane k and is tested by bit (7 - k) of the byte
+static AVX2_FUNC FORCE_INLINE __m256i maskEpi32(uint8_t b) {
+  const __m256i bits = _mm256_set_epi32(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+  return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(b), bits), _mm256_setzero_si256());
+}
+
+static AVX2_FUNC FORCE_INLINE void maskEpi64(uint8_t b, __m256i* lo, __m256i* hi) {
+  const __m256i bitsLo = _mm256_set_epi64x(0x10, 0x20, 0x40, 0x80);
+  const __m256i bitsHi = _mm256_set_epi64x(0x01, 0x02, 0x04, 0x08);
+  __m256i       vb = _mm256_set1_epi64x(b);
+  *lo = _mm256_cmpeq_epi64(_mm256_and_si256(vb, bitsLo), _mm256_setzero_si256());
+  *hi = _mm256_cmpeq_epi64(_mm256_and_si256(vb, bitsHi), _mm256_setzero_si256());
+}
+
+// load eight values widened to two vectors of 64-bit lanes
+#define LOAD_I8_EPI64(_p, _lo, _hi)                  \
+  do {                                               \
+    __m128i _v = _mm_loadl_epi64((const __m128i*)(_p)); \
+    _lo = _mm256_cvtepi8_epi64(_v);                  \
+    _hi = _mm256_cvtepi8_epi64(_mm_srli_si128(_v, 4)); \
+  } while (0)
+
+#define LOAD_U8_EPI64(_p, _lo, _hi)                  \
+  do {                                               \
+    __m128i _v = _mm_loadl_epi64((const __m128i*)(_p)); \
+    _lo = _mm256_cvtepu8_epi64(_v);                  \
+    _hi = _mm256_cvtepu8_epi64(_mm_srli_si128(_v, 4)); \
+  } while (0)
+
+#define LOAD_I16_EPI64(_p, _lo, _hi)                  \
+  do {                                                \
+    __m128i _v = _mm_loadu_si128((const __m128i*)(_p)); \
+    _lo = _mm256_cvtepi16_epi64(_v);                  \
+    _hi = _mm256_cvtepi16_epi64(_mm_srli_si128(_v, 8)); \
+  } while (0)
+
+#define LOAD_U16_EPI64(_p, _lo, _hi)                  \
+  do {                                                \
+    __m128i _v = _mm_loadu_si128((const __m128i*)(_p)); \
+    _lo = _mm256_cvtepu16_epi64(_v);                  \
+    _hi = _mm256_cvtepu16_epi64(_mm_srli_si128(_v, 8)); \
+  } while (0)
+
+#define LOAD_I32_EPI64(_p, _lo, _hi)                             \
+  do {                                                           \
+    __m256i _v = _mm256_loadu_si256((const __m256i*)(_p));       \
+    _lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(_v));     \
+    _hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(_v, 1)); \
+  } while (0)
+
+#define LOAD_U32_EPI64(_p, _lo, _hi)                             \
+  do {                                                           \
+    __m256i _v = _mm256_loadu_si256((const __m256i*)(_p));       \
+    _lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(_v));     \
+    _hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(_v, 1)); \
+  } while (0)
+
+#define LOAD_I64_EPI64(_p, _lo, _hi)                         \
+  do {                                                       \
+    _lo = _mm256_loadu_si256((const __m256i*)(_p));          \
+    _hi = _mm256_loadu_si256((const __m256i*)((_p) + 4));    \
+  } while (0)
+
+#define LOAD_FLOAT_PD(_p, _lo, _hi)                        \
+  do {                                                     \
+    __m256 _v = _mm256_loadu_ps((const float*)(_p));       \
+    _lo = _mm256_cvtps_pd(_mm256_castps256_ps128(_v));     \
+    _hi = _mm256_cvtps_pd(_mm256_extractf128_ps(_v, 1));   \
+  } while (0)
+
+#define LOAD_DOUBLE_PD(_p, _lo, _hi)          \
+  do {                                        \
+    _lo = _mm256_loadu_pd((const double*)(_p)); \
+    _hi = _mm256_loadu_pd((const double*)(_p) + 4); \
+  } while (0)
+
+// the integer sums wrap around in 64 bits, so the signed and the unsigned types share one accumulator
+#define AVX2_SUM_INT(_name, _t, _acc_t, _load)                                                                \
+  static AVX2_FUNC int32_t _name(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, _acc_t* pSum) { \
+    const _t*      d = (const _t*)pCol->pData;                                                                 \
+    const uint8_t* bm = getNullBitmap(pCol);                                                                   \
+    int32_t        end = start + numOfRows;                                                                    \
+    int32_t        num = 0;                                                                                    \
+    int32_t        i = start;                                                                                  \
+    _acc_t         s = 0;                                                                                      \
+    __m256i        acc = _mm256_setzero_si256();                                                               \
+    __m256i        lo, hi;                                                                                     \
+                                                                                                               \
+    if (bm == NULL) {                                                                                          \
+      for (; i + 8 <= end; i += 8) {                                                                           \
+        _load(d + i, lo, hi);                                                                                  \
+        acc = _mm256_add_epi64(acc, _mm256_add_epi64(lo, hi));                                                 \
+      }                                                                                                        \
+      num = i - start;                                                                                         \
+    } else {                                                                                                   \
+      for (; i < end && BitPos(i) != 0; ++i) {                                                                 \
+        if (!colDataIsNull_f(bm, i)) {                                                                         \
+          s += d[i];                                                                                           \
+          num += 1;                                                                                            \
+        }                                                                                                      \
+      }                                                                                                        \
+      for (; i + 8 <= end; i += 8) {                                                                           \
+        uint8_t b = bm[i >> NBIT];                                                                             \
+        if (b == 0xFF) {                                                                                       \
+          continue;                                                                                            \
+        }                                                                                                      \
+        _load(d + i, lo, hi);                                                                                  \
+        if (b != 0) {                                                                                          \
+          __m256i mlo, mhi;                                                                                    \
+          maskEpi64(b, &mlo, &mhi);                                                                            \
+          lo = _mm256_and_si256(lo, mlo);                                                                      \
+          hi = _mm256_and_si256(hi, mhi);                                                                      \
+        }                                                                                                      \
+        acc = _mm256_add_epi64(acc, _mm256_add_epi64(lo, hi));                                                 \
+        num += 8 - __builtin_popcount(b);                                                                      \
+      }                                                                                                        \
+    }                                                                                                          \
+                                                                                                               \
+    for (; i < end; ++i) {                                                                                     \
+      if (bm == NULL || !colDataIsNull_f(bm, i)) {                                                             \
+        s += d[i];                                                                                             \
+        num += 1;                                                                                              \
+      }                                                                                                        \
+    }                                                                                                          \
+                                                                                                               \
+    int64_t lanes[4];                                                                                          \
+    _mm256_storeu_si256((__m256i*)lanes, acc);                                                                 \
+    s += (_acc_t)lanes[0] + (_acc_t)lanes[1] + (_acc_t)lanes[2] + (_acc_t)lanes[3];                            \
+    *pSum += s;                                                                                                \
+    return num;                                                                                                \
+  }
+
+AVX2_SUM_INT(sumI8Avx2, int8_t, int64_t, LOAD_I8_EPI64)
+AVX2_SUM_INT(sumI16Avx2, int16_t, int64_t, LOAD_I16_EPI64)
+AVX2_SUM_INT(sumI32Avx2, int32_t, int64_t, LOAD_I32_EPI64)
+AVX2_SUM_INT(sumI64Avx2, int64_t, int64_t, LOAD_I64_EPI64)
+AVX2_SUM_INT(sumU8Avx2, uint8_t, uint64_t, LOAD_U8_EPI64)
+AVX2_SUM_INT(sumU16Avx2, uint16_t, uint64_t, LOAD_U16_EPI64)
+AVX2_SUM_INT(sumU32Avx2, uint32_t, uint64_t, LOAD_U32_EPI64)
+AVX2_SUM_INT(sumU64Avx2, uint64_t, uint64_t, LOAD_I64_EPI64)
+
+// the lanes are added up at the end, so the rounding may differ slightly from the row by row summation
+#define AVX2_SUM_FLT(_name, _t, _load)                                                                        \
+  static AVX2_FUNC int32_t _name(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum) { \
+    const _t*      d = (const _t*)pCol->pData;                                                                 \
+    const uint8_t* bm = getNullBitmap(pCol);                                                                   \
+    int32_t        end = start + numOfRows;                                                                    \
+    int32_t        num = 0;                                                                                    \
+    int32_t        i = start;                                                                                  \
+    double         s = 0;                                                                                      \
+    __m256d        acc = _mm256_setzero_pd();                                                                  \
+    __m256d        lo, hi;                                                                                     \
+                                                                                                               \
+    if (bm == NULL) {                                                                                          \
+      for (; i + 8 <= end; i += 8) {                                                                           \
+        _load(d + i, lo, hi);                                                                                  \
+        acc = _mm256_add_pd(acc, _mm256_add_pd(lo, hi));                                                       \
+      }                                                                                                        \
+      num = i - start;                                                                                         \
+    } else {                                                                                                   \
+      for (; i < end && BitPos(i) != 0; ++i) {                                                                 \
+        if (!colDataIsNull_f(bm, i)) {                                                                         \
+          s += d[i];                                                                                           \
+          num += 1;                                                                                            \
+        }                                                                                                      \
+      }                                                                                                        \
+      for (; i + 8 <= end; i += 8) {                                                                           \
+        uint8_t b = bm[i >> NBIT];                                                                             \
+        if (b == 0xFF) {                                                                                       \
+          continue;                                                                                            \
+        }                                                                                                      \
+        _load(d + i, lo, hi);                                                                                  \
+        if (b != 0) {                                                                                          \
+          __m256i mlo, mhi;                                                                                    \
+          maskEpi64(b, &mlo, &mhi);                                                                            \
+          lo = _mm256_and_pd(lo, _mm256_castsi256_pd(mlo));                                                    \
+          hi = _mm256_and_pd(hi, _mm256_castsi256_pd(mhi));                                                    \
+        }                                                                                                      \
+        acc = _mm256_add_pd(acc, _mm256_add_pd(lo, hi));                                                       \
+        num += 8 - __builtin_popcount(b);                                                                      \
+      }                                                                                                        \
+    }                                                                                                          \
+                                                                                                               \
+    for (; i < end; ++i) {                                                                                     \
+      if (bm == NULL || !colDataIsNull_f(bm, i)) {                                                             \
+        s += d[i];                                                                                             \
+        num += 1;                                                                                              \
+      }                                                                                                        \
+    }                                                                                                          \
+                                                                                                               \
+    double lanes[4];                                                                                           \
+    _mm256_storeu_pd(lanes, acc);                                                                              \
+    *pSum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + s;                                                \
+    return num;                                                                                                \
+  }
+
+AVX2_SUM_FLT(sumFloatAvx2, float, LOAD_FLOAT_PD)
+AVX2_SUM_FLT(sumDoubleAvx2, double, LOAD_DOUBLE_PD)
+
+/*
+ * min/max: the types up to 32 bits are kept in one vector of eight 32-bit lanes, the 64-bit types in two vectors of
+ * four lanes. The NULL lanes are replaced by the identity value of the operation before folding.
+ */
+#define LOAD_I8_EPI32(_p)  _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(_p)))
+#define LOAD_U8_EPI32(_p)  _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(_p)))
+#define LOAD_I16_EPI32(_p) _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(_p)))
+#define LOAD_U16_EPI32(_p) _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(_p)))
+#define LOAD_I32_EPI32(_p) _mm256_loadu_si256((const __m256i*)(_p))
+
+#define AVX2_MINMAX_EPI32(_name, _t, _lane_t, _load, _min, _max, _idMin, _idMax)                                \
+  static AVX2_FUNC int32_t _name(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin,      \
+                                 _t* pRes) {                                                                    \
+    const _t*      d = (const _t*)pCol->pData;                                                                  \
+    const uint8_t* bm = getNullBitmap(pCol);                                                                    \
+    int32_t        end = start + numOfRows;                                                                     \
+    int32_t        num = 0;                                                                                     \
+    int32_t        vnum = 0;                                                                                    \
+    int32_t        i = start;                                                                                   \
+    bool           assigned = false;                                                                            \
+    _t             v = 0;                                                                                       \
+    const __m256i  id = _mm256_set1_epi32(isMin ? (_idMin) : (_idMax));                                         \
+    __m256i        acc = id;                                                                                    \
+                                                                                                                \
+    for (; bm != NULL && i < end && BitPos(i) != 0; ++i) {                                                      \
+      if (!colDataIsNull_f(bm, i)) {                                                                            \
+        MINMAX_ROW(v, assigned, d[i], isMin);                                                                   \
+        num += 1;                                                                                               \
+      }                                                                                                         \
+    }                                                                                                           \
+                                                                                                                \
+    for (; i + 8 <= end; i += 8) {                                                                              \
+      uint8_t b = (bm != NULL) ? bm[i >> NBIT] : 0;                                                             \
+      if (b == 0xFF) {                                                                                          \
+        continue;                                                                                               \
+      }                                                                                                         \
+      __m256i x = _load(d + i);                                                                                 \
+      if (b != 0) {                                                                                             \
+        x = _mm256_blendv_epi8(id, x, maskEpi32(b));                                                            \
+      }                                                                                                         \
+      acc = isMin ? _min(acc, x) : _max(acc, x);                                                                \
+      vnum += 8 - __builtin_popcount(b);                                                                        \
+    }                                                                                                           \
+                                                                                                                \
+    if (vnum > 0) {                                                                                             \
+      _lane_t lanes[8];                                                                                         \
+      _lane_t best = 0;                                                                                         \
+      bool    hasBest = false;                                                                                  \
+      _mm256_storeu_si256((__m256i*)lanes, acc);                                                                \
+      for (int32_t k = 0; k < 8; ++k) {                                                                         \
+        MINMAX_ROW(best, hasBest, lanes[k], isMin);                                                             \
+      }                                                                                                         \
+      MINMAX_ROW(v, assigned, (_t)best, isMin);                                                                 \
+      num += vnum;                                                                                              \
+    }                                                                                                           \
+                                                                                                                \
+    for (; i < end; ++i) {                                                                                      \
+      if (bm == NULL || !colDataIsNull_f(bm, i)) {                                                              \
+        MINMAX_ROW(v, assigned, d[i], isMin);                                                                   \
+        num += 1;                                                                                               \
+      }                                                                                                         \
+    }                                                                                                           \
+                                                                                                                \
+    if (num > 0) {                                                                                              \
+      *pRes = v;                                                                                                \
+    }                                                                                                           \
+    return num;                                                                                                 \
+  }
+
+// the lanes are reduced in the 32-bit domain, where the identity values can never beat a real value
+AVX2_MINMAX_EPI32(minmaxI8Avx2, int8_t, int32_t, LOAD_I8_EPI32, _mm256_min_epi32, _mm256_max_epi32, INT32_MAX,
+                  INT32_MIN)
+AVX2_MINMAX_EPI32(minmaxI16Avx2, int16_t, int32_t, LOAD_I16_EPI32, _mm256_min_epi32, _mm256_max_epi32, INT32_MAX,
+                  INT32_MIN)
+AVX2_MINMAX_EPI32(minmaxI32Avx2, int32_t, int32_t, LOAD_I32_EPI32, _mm256_min_epi32, _mm256_max_epi32, INT32_MAX,
+                  INT32_MIN)
+AVX2_MINMAX_EPI32(minmaxU8Avx2, uint8_t, int32_t, LOAD_U8_EPI32, _mm256_min_epi32, _mm256_max_epi32, INT32_MAX,
+                  INT32_MIN)
+AVX2_MINMAX_EPI32(minmaxU16Avx2, uint16_t, int32_t, LOAD_U16_EPI32, _mm256_min_epi32, _mm256_max_epi32, INT32_MAX,
+                  INT32_MIN)
+AVX2_MINMAX_EPI32(minmaxU32Avx2, uint32_t, uint32_t, LOAD_I32_EPI32, _mm256_min_epu32, _mm256_max_epu32,
+                  (int32_t)UINT32_MAX, 0)
+
+static AVX2_FUNC int32_t minmaxFloatAvx2(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin,
+                                         float* pRes) {
+  const float*   d = (const float*)pCol->pData;
+  const uint8_t* bm = getNullBitmap(pCol);
+  int32_t        end = start + numOfRows;
+  int32_t        num = 0;
+  int32_t        vnum = 0;
+  int32_t        i = start;
+  bool           assigned = false;
+  float          v = 0;
+  const __m256   id = _mm256_set1_ps(isMin ? INFINITY : -INFINITY);
+  __m256         acc = id;
+
+  for (; bm != NULL && i < end && BitPos(i) != 0; ++i) {
+    if (!colDataIsNull_f(bm, i)) {
+      MINMAX_ROW(v, assigned, d[i], isMin);
+      num += 1;
+    }
+  }
+
+  for (; i + 8 <= end; i += 8) {
+    uint8_t b = (bm != NULL) ? bm[i >> NBIT] : 0;
+    if (b == 0xFF) {
+      continue;
+    }
+    __m256 x = _mm256_loadu_ps(d + i);
+    if (b != 0) {
+      x = _mm256_blendv_ps(id, x, _mm256_castsi256_ps(maskEpi32(b)));
+    }
+    acc = isMin ? _mm256_min_ps(acc, x) : _mm256_max_ps(acc, x);
+    vnum += 8 - __builtin_popcount(b);
+  }
+
+  if (vnum > 0) {
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc);
+    for (int32_t k = 0; k < 8; ++k) {
+      MINMAX_ROW(v, assigned, lanes[k], isMin);
+    }
+    num += vnum;
+  }
+
+  for (; i < end; ++i) {
+    if (bm == NULL || !colDataIsNull_f(bm, i)) {
+      MINMAX_ROW(v, assigned, d[i], isMin);
+      num += 1;
+    }
+  }
+
+  if (num > 0) {
+    *pRes = v;
+  }
+  return num;
+}
+
+static AVX2_FUNC int32_t minmaxDoubleAvx2(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin,
+                                          double* pRes) {
+  const double*  d = (const double*)pCol->pData;
+  const uint8_t* bm = getNullBitmap(pCol);
+  int32_t        end = start + numOfRows;
+  int32_t        num = 0;
+  int32_t        vnum = 0;
+  int32_t        i = start;
+  bool           assigned = false;
+  double         v = 0;
+  const __m256d  id = _mm256_set1_pd(isMin ? INFINITY : -INFINITY);
+  __m256d        acc = id;
+  __m256d        lo, hi;
+
+  for (; bm != NULL && i < end && BitPos(i) != 0; ++i) {
+    if (!colDataIsNull_f(bm, i)) {
+      MINMAX_ROW(v, assigned, d[i], isMin);
+      num += 1;
+    }
+  }
+
+  for (; i + 8 <= end; i += 8) {
+    uint8_t b = (bm != NULL) ? bm[i >> NBIT] : 0;
+    if (b == 0xFF) {
+      continue;
+    }
+    LOAD_DOUBLE_PD(d + i, lo, hi);
+    if (b != 0) {
+      __m256i mlo, mhi;
+      maskEpi64(b, &mlo, &mhi);
+      lo = _mm256_blendv_pd(id, lo, _mm256_castsi256_pd(mlo));
+      hi = _mm256_blendv_pd(id, hi, _mm256_castsi256_pd(mhi));
+    }
+    acc = isMin ? _mm256_min_pd(acc, _mm256_min_pd(lo, hi)) : _mm256_max_pd(acc, _mm256_max_pd(lo, hi));
+    vnum += 8 - __builtin_popcount(b);
+  }
+
+  if (vnum > 0) {
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    for (int32_t k = 0; k < 4; ++k) {
+      MINMAX_ROW(v, assigned, lanes[k], isMin);
+    }
+    num += vnum;
+  }
+
+  for (; i < end; ++i) {
+    if (bm == NULL || !colDataIsNull_f(bm, i)) {
+      MINMAX_ROW(v, assigned, d[i], isMin);
+      num += 1;
+    }
+  }
+
+  if (num > 0) {
+    *pRes = v;
+  }
+  return num;
+}
+
+// there is no unsigned 64-bit compare in AVX2, the unsigned values are compared with the sign bit flipped
+static AVX2_FUNC int32_t minmaxEpi64Avx2(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin,
+                                         bool isUnsigned, int64_t* pRes) {
+  const int64_t* d = (const int64_t*)pCol->pData;
+  const uint8_t* bm = getNullBitmap(pCol);
+  int32_t        end = start + numOfRows;
+  int32_t        num = 0;
+  int32_t        vnum = 0;
+  int32_t        i = start;
+  bool           assigned = false;
+  int64_t        v = 0;
+  const int64_t  bias = isUnsigned ? INT64_MIN : 0;
+  const __m256i  vbias = _mm256_set1_epi64x(bias);
+  const __m256i  id = _mm256_set1_epi64x(isMin ? INT64_MAX : INT64_MIN);
+  __m256i        acc = id;
+  __m256i        lo, hi;
+
+  // the scalar rows are folded in the biased domain as well
+  for (; bm != NULL && i < end && BitPos(i) != 0; ++i) {
+    if (!colDataIsNull_f(bm, i)) {
+      MINMAX_ROW(v, assigned, d[i] ^ bias, isMin);
+      num += 1;
+    }
+  }
+
+  for (; i + 8 <= end; i += 8) {
+    uint8_t b = (bm != NULL) ? bm[i >> NBIT] : 0;
+    if (b == 0xFF) {
+      continue;
+    }
+    LOAD_I64_EPI64(d + i, lo, hi);
+    lo = _mm256_xor_si256(lo, vbias);
+    hi = _mm256_xor_si256(hi, vbias);
+    if (b != 0) {
+      __m256i mlo, mhi;
+      maskEpi64(b, &mlo, &mhi);
+      lo = _mm256_blendv_epi8(id, lo, mlo);
+      hi = _mm256_blendv_epi8(id, hi, mhi);
+    }
+    if (isMin) {
+      acc = _mm256_blendv_epi8(acc, lo, _mm256_cmpgt_epi64(acc, lo));
+      acc = _mm256_blendv_epi8(acc, hi, _mm256_cmpgt_epi64(acc, hi));
+    } else {
+      acc = _mm256_blendv_epi8(acc, lo, _mm256_cmpgt_epi64(lo, acc));
+      acc = _mm256_blendv_epi8(acc, hi, _mm256_cmpgt_epi64(hi, acc));
+    }
+    vnum += 8 - __builtin_popcount(b);
+  }
+
+  if (vnum > 0) {
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    for (int32_t k = 0; k < 4; ++k) {
+      MINMAX_ROW(v, assigned, lanes[k], isMin);
+    }
+    num += vnum;
+  }
+
+  for (; i < end; ++i) {
+    if (bm == NULL || !colDataIsNull_f(bm, i)) {
+      MINMAX_ROW(v, assigned, d[i] ^ bias, isMin);
+      num += 1;
+    }
+  }
+
+  if (num > 0) {
+    *pRes = v ^ bias;
+  }
+  return num;
+}
+#endif  // VECAGG_AVX2
+
+#ifdef VECAGG_AVX2
+#define CALL_KERNEL(_scalar, _avx2, ...) (useAvx2() ? _avx2(__VA_ARGS__) : _scalar(__VA_ARGS__))
+#else
+#define CALL_KERNEL(_scalar, _avx2, ...) _scalar(__VA_ARGS__)
+#endif
+
+int32_t vecSumColumn(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, void* pSum) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return CALL_KERNEL(sumI8, sumI8Avx2, pCol, start, numOfRows, (int64_t*)pSum);
+    case TSDB_DATA_TYPE_SMALLINT:
+      return CALL_KERNEL(sumI16, sumI16Avx2, pCol, start, numOfRows, (int64_t*)pSum);
+    case TSDB_DATA_TYPE_INT:
+      return CALL_KERNEL(sumI32, sumI32Avx2, pCol, start, numOfRows, (int64_t*)pSum);
+    case TSDB_DATA_TYPE_BIGINT:
+      return CALL_KERNEL(sumI64, sumI64Avx2, pCol, start, numOfRows, (int64_t*)pSum);
+    case TSDB_DATA_TYPE_UTINYINT:
+      return CALL_KERNEL(sumU8, sumU8Avx2, pCol, start, numOfRows, (uint64_t*)pSum);
+    case TSDB_DATA_TYPE_USMALLINT:
+      return CALL_KERNEL(sumU16, sumU16Avx2, pCol, start, numOfRows, (uint64_t*)pSum);
+    case TSDB_DATA_TYPE_UINT:
+      return CALL_KERNEL(sumU32, sumU32Avx2, pCol, start, numOfRows, (uint64_t*)pSum);
+    case TSDB_DATA_TYPE_UBIGINT:
+      return CALL_KERNEL(sumU64, sumU64Avx2, pCol, start, numOfRows, (uint64_t*)pSum);
+    case TSDB_DATA_TYPE_FLOAT:
+      return CALL_KERNEL(sumFloat, sumFloatAvx2, pCol, start, numOfRows, (double*)pSum);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return CALL_KERNEL(sumDouble, sumDoubleAvx2, pCol, start, numOfRows, (double*)pSum);
+    default:
+      ASSERT(0);
+      return 0;
+  }
+}
+
+static int32_t minmaxI64Dispatch(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin,
+                                 int64_t* pRes) {
+#ifdef VECAGG_AVX2
+  if (useAvx2()) {
+    return minmaxEpi64Avx2(pCol, start, numOfRows, isMin, false, pRes);
+  }
+#endif
+  return minmaxI64(pCol, start, numOfRows, isMin, pRes);
+}
+
+static int32_t minmaxU64Dispatch(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin,
+                                 uint64_t* pRes) {
+#ifdef VECAGG_AVX2
+  if (useAvx2()) {
+    return minmaxEpi64Avx2(pCol, start, numOfRows, isMin, true, (int64_t*)pRes);
+  }
+#endif
+  return minmaxU64(pCol, start, numOfRows, isMin, pRes);
+}
+
+#define MINMAX_AND_FIND(_t, _kernel, _find)                        \
+  do {                                                             \
+    _t      v = 0;                                                 \
+    int32_t n = _kernel;                                           \
+    if (n > 0) {                                                   \
+      *(_t*)pRes = v;                                              \
+      if (pIndex != NULL) {                                        \
+        *pIndex = _find(pCol, start, numOfRows, v);                \
+      }                                                            \
+    }                                                              \
+    return n;                                                      \
+  } while (0)
+
+int32_t vecMinMaxColumn(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, bool isMin, void* pRes,
+                        int32_t* pIndex) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      MINMAX_AND_FIND(int8_t, CALL_KERNEL(minmaxI8, minmaxI8Avx2, pCol, start, numOfRows, isMin, &v), findFirstI8);
+    case TSDB_DATA_TYPE_SMALLINT:
+      MINMAX_AND_FIND(int16_t, CALL_KERNEL(minmaxI16, minmaxI16Avx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstI16);
+    case TSDB_DATA_TYPE_INT:
+      MINMAX_AND_FIND(int32_t, CALL_KERNEL(minmaxI32, minmaxI32Avx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstI32);
+    case TSDB_DATA_TYPE_BIGINT:
+      MINMAX_AND_FIND(int64_t, minmaxI64Dispatch(pCol, start, numOfRows, isMin, &v), findFirstI64);
+    case TSDB_DATA_TYPE_UTINYINT:
+      MINMAX_AND_FIND(uint8_t, CALL_KERNEL(minmaxU8, minmaxU8Avx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstU8);
+    case TSDB_DATA_TYPE_USMALLINT:
+      MINMAX_AND_FIND(uint16_t, CALL_KERNEL(minmaxU16, minmaxU16Avx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstU16);
+    case TSDB_DATA_TYPE_UINT:
+      MINMAX_AND_FIND(uint32_t, CALL_KERNEL(minmaxU32, minmaxU32Avx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstU32);
+    case TSDB_DATA_TYPE_UBIGINT:
+      MINMAX_AND_FIND(uint64_t, minmaxU64Dispatch(pCol, start, numOfRows, isMin, &v), findFirstU64);
+    case TSDB_DATA_TYPE_FLOAT:
+      MINMAX_AND_FIND(float, CALL_KERNEL(minmaxFloat, minmaxFloatAvx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstFloat);
+    case TSDB_DATA_TYPE_DOUBLE:
+      MINMAX_AND_FIND(double, CALL_KERNEL(minmaxDouble, minmaxDoubleAvx2, pCol, start, numOfRows, isMin, &v),
+                      findFirstDouble);
+    default:
+      ASSERT(0);
+      return 0;
+  }
+}
+
+int32_t vecCountColumn(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows) {
+  const uint8_t* bm = getNullBitmap(pCol);
+  if (bm == NULL) {
+    return numOfRows;
+  }
+
+  int32_t end = start + numOfRows;
+  int32_t num = 0;
+  int32_t i = start;
+
+  for (; i < end && BitPos(i) != 0; ++i) {
+    num += colDataIsNull_f(bm, i) ? 0 : 1;
+  }
+
+  // 64 rows per word, popcnt is available with the sse4.2 baseline
+  for (; i + 64 <= end; i += 64) {
+    uint64_t w;
+    memcpy(&w, bm + (i >> NBIT), sizeof(w));
+    num += 64 - __builtin_popcountll(w);
+  }
+
+  for (; i + 8 <= end; i += 8) {
+    num += 8 - __builtin_popcount(bm[i >> NBIT]);
+  }
+
+  for (; i < end; ++i) {
+    num += colDataIsNull_f(bm, i) ? 0 : 1;
+  }
+
+  return num;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tdatablock.h"
+#include "ttypes.h"
+#include "tvecagg.h"
+
+typedef struct {
+  int32_t type;
+  char*   name;
+} SBenchType;
+
+static SBenchType benchTypes[] = {
+    {TSDB_DATA_TYPE_TINYINT, "tinyint"},   {TSDB_DATA_TYPE_SMALLINT, "smallint"},
+    {TSDB_DATA_TYPE_INT, "int"},           {TSDB_DATA_TYPE_BIGINT, "bigint"},
+    {TSDB_DATA_TYPE_UTINYINT, "utinyint"}, {TSDB_DATA_TYPE_USMALLINT, "usmallint"},
+    {TSDB_DATA_TYPE_UINT, "uint"},         {TSDB_DATA_TYPE_UBIGINT, "ubigint"},
+    {TSDB_DATA_TYPE_FLOAT, "float"},       {TSDB_DATA_TYPE_DOUBLE, "double"},
+};
+
+static void initColumn(SColumnInfoData* pCol, int32_t type, int32_t numOfRows, int32_t nullRatio) {
+  memset(pCol, 0, sizeof(SColumnInfoData));
+  pCol->info.type = type;
+  pCol->info.bytes = tDataTypes[type].bytes;
+  pCol->pData = taosMemoryCalloc(numOfRows, pCol->info.bytes);
+  pCol->nullbitmap = taosMemoryCalloc(BitmapLen(numOfRows), 1);
+  pCol->hasNull = (nullRatio > 0);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char* p = pCol->pData + i * pCol->info.bytes;
+    int32_t v = (int32_t)(taosRand() % 10000) - 5000;
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:
+      case TSDB_DATA_TYPE_UTINYINT:
+        *(int8_t*)p = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+      case TSDB_DATA_TYPE_USMALLINT:
+        *(int16_t*)p = (int16_t)v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+      case TSDB_DATA_TYPE_UINT:
+        *(int32_t*)p = v;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_UBIGINT:
+        *(int64_t*)p = (int64_t)v * 1000003;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        *(float*)p = v / 7.0f;
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        *(double*)p = v / 7.0;
+        break;
+    }
+
+    if (nullRatio > 0 && taosRand() % 100 < nullRatio) {
+      colDataSetNull_f(pCol->nullbitmap, i);
+    }
+  }
+}
+
+static void destroyColumn(SColumnInfoData* pCol) {
+  taosMemoryFree(pCol->pData);
+  taosMemoryFree(pCol->nullbitmap);
+}
+
+// the SIMD kernels must return what the scalar ones do, float sums may differ in the last bits only
+static bool checkKernels(SColumnInfoData* pCol, int32_t numOfRows) {
+  bool    ok = true;
+  int32_t type = pCol->info.type;
+
+  for (int32_t start = 0; start < 3 && start < numOfRows; ++start) {
+    int32_t rows = numOfRows - start;
+    int64_t sum[2] = {0};
+    int32_t num[2] = {0};
+
+    for (int32_t i = 0; i < 2; ++i) {
+      vecAggSetSimd(i == 1);
+      num[i] = vecSumColumn(pCol, start, rows, &sum[i]);
+    }
+
+    bool sumOk = (num[0] == num[1]);
+    if (IS_FLOAT_TYPE(type)) {
+      double s0 = *(double*)&sum[0];
+      double s1 = *(double*)&sum[1];
+      sumOk = sumOk && fabs(s0 - s1) <= 1e-9 * TMAX(fabs(s0), 1.0);
+    } else {
+      sumOk = sumOk && sum[0] == sum[1];
+    }
+    if (!sumOk) {
+      printf("sum mismatch, type:%d start:%d\n", type, start);
+      ok = false;
+    }
+
+    for (int32_t isMin = 0; isMin < 2; ++isMin) {
+      int64_t v[2] = {0};
+      int32_t index[2] = {-1, -1};
+      for (int32_t i = 0; i < 2; ++i) {
+        vecAggSetSimd(i == 1);
+        num[i] = vecMinMaxColumn(pCol, start, rows, isMin, &v[i], &index[i]);
+      }
+      if (num[0] != num[1] || v[0] != v[1] || index[0] != index[1]) {
+        printf("%s mismatch, type:%d start:%d\n", isMin ? "min" : "max", type, start);
+        ok = false;
+      }
+    }
+
+    for (int32_t i = 0; i < 2; ++i) {
+      vecAggSetSimd(i == 1);
+      num[i] = vecCountColumn(pCol, start, rows);
+    }
+    if (num[0] != num[1]) {
+      printf("count mismatch, type:%d start:%d\n", type, start);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+// rows per microsecond of each kernel, i.e. millions of rows per second
+static void runBench(SColumnInfoData* pCol, int32_t numOfRows, int32_t loops, double* res) {
+  int64_t sum[1] = {0};
+  int64_t v = 0;
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; ++i) {
+    vecSumColumn(pCol, 0, numOfRows, sum);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+  res[0] = (double)numOfRows * loops / TMAX(el, 1);
+
+  st = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; ++i) {
+    vecMinMaxColumn(pCol, 0, numOfRows, (i & 1), &v, NULL);
+  }
+  el = taosGetTimestampUs() - st;
+  res[1] = (double)numOfRows * loops / TMAX(el, 1);
+
+  st = taosGetTimestampUs();
+  int64_t num = 0;
+  for (int32_t i = 0; i < loops; ++i) {
+    num += vecCountColumn(pCol, 0, numOfRows);
+  }
+  el = taosGetTimestampUs() - st;
+  res[2] = (double)numOfRows * loops / TMAX(el, 1);
+
+  // keep the results alive
+  if (sum[0] == 1 && v == 1 && num == 1) {
+    printf("\n");
+  }
+}
+
+int main(int argc, char* argv[]) {
+  int32_t numOfRows = 4096;
+  int32_t loops = 20000;
+  int32_t nullRatio = 10;
+
+  for (int32_t i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      numOfRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      loops = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nullRatio = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-r rows]: rows of a block, default is:%d\n", numOfRows);
+      printf("  [-l loops]: times to aggregate a block, default is:%d\n", loops);
+      printf("  [-n ratio]: percentage of NULL rows in the masked test, default is:%d\n", nullRatio);
+      exit(0);
+    }
+  }
+
+  taosSeedRand(taosGetTimestampSec());
+  vecAggInit();
+  bool simd = vecAggSetSimd(true);
+  printf("rows:%d loops:%d null ratio:%d%% simd:%s, throughput in million rows/s\n", numOfRows, loops, nullRatio,
+         simd ? "avx2" : "not supported");
+  printf("%-10s %-7s %10s %10s %10s %10s %10s\n", "type", "nulls", "sum", "sum-simd", "minmax", "mm-simd", "count");
+
+  int32_t code = 0;
+  for (int32_t t = 0; t < tListLen(benchTypes); ++t) {
+    for (int32_t withNull = 0; withNull < 2; ++withNull) {
+      SColumnInfoData col;
+      double          scalar[3] = {0};
+      double          vec[3] = {0};
+
+      initColumn(&col, benchTypes[t].type, numOfRows, withNull ? nullRatio : 0);
+      if (simd && !checkKernels(&col, numOfRows)) {
+        code = 1;
+      }
+
+      vecAggSetSimd(false);
+      runBench(&col, numOfRows, loops, scalar);
+      if (simd) {
+        vecAggSetSimd(true);
+        runBench(&col, numOfRows, loops, vec);
+      }
+
+      // count only reads the null bitmap and has no separate SIMD kernel
+      printf("%-10s %-7s %10.1f %10.1f %10.1f %10.1f %10.1f\n", benchTypes[t].name, withNull ? "yes" : "no", scalar[0],
+             vec[0], scalar[1], vec[1], scalar[2]);
+      destroyColumn(&col);
+    }
+  }
+
+  return code;
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <type_traits>
+
+#include "os.h"
+#include "tdatablock.h"
+#include "ttypes.h"
+#include "tvecagg.h"
+
+namespace {
+
+const int32_t aggTypes[] = {
+    TSDB_DATA_TYPE_BOOL,     TSDB_DATA_TYPE_TINYINT,   TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+    TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UTINYINT,  TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,
+    TSDB_DATA_TYPE_UBIGINT,  TSDB_DATA_TYPE_FLOAT,     TSDB_DATA_TYPE_DOUBLE,
+};
+
+// nullMode: 0 no NULL rows, 1 random NULL rows, 2 all rows NULL
+void initColumn(SColumnInfoData *pCol, int32_t type, int32_t numOfRows, int32_t nullMode) {
+  memset(pCol, 0, sizeof(SColumnInfoData));
+  pCol->info.type = type;
+  pCol->info.bytes = tDataTypes[type].bytes;
+  pCol->pData = (char *)taosMemoryCalloc(numOfRows, pCol->info.bytes);
+  pCol->nullbitmap = (char *)taosMemoryCalloc(BitmapLen(numOfRows), 1);
+  pCol->hasNull = (nullMode != 0);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char   *p = pCol->pData + i * pCol->info.bytes;
+    int64_t v = (int64_t)(taosRand() % 20001) - 10000;
+    switch (type) {
+      case TSDB_DATA_TYPE_BOOL:
+        *(int8_t *)p = (int8_t)(v & 1);
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        *(int8_t *)p = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        *(int16_t *)p = (int16_t)(v * 3);
+        break;
+      case TSDB_DATA_TYPE_INT:
+        *(int32_t *)p = (int32_t)(v * 200003);
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        *(int64_t *)p = v * 100000000007LL;
+        break;
+      // the unsigned values cover the upper half of the range, which a signed compare gets wrong
+      case TSDB_DATA_TYPE_UTINYINT:
+        *(uint8_t *)p = (uint8_t)(v + 10000);
+        break;
+      case TSDB_DATA_TYPE_USMALLINT:
+        *(uint16_t *)p = (uint16_t)((v + 10000) * 3);
+        break;
+      case TSDB_DATA_TYPE_UINT:
+        *(uint32_t *)p = (uint32_t)((v + 10000) * 214741);
+        break;
+      case TSDB_DATA_TYPE_UBIGINT:
+        *(uint64_t *)p = (uint64_t)(v + 10000) * 922337203685477ULL;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        *(float *)p = v / 7.0f;
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        *(double *)p = v / 7.0;
+        break;
+    }
+
+    if (nullMode == 2 || (nullMode == 1 && taosRand() % 4 == 0)) {
+      colDataSetNull_f(pCol->nullbitmap, i);
+    }
+  }
+}
+
+void destroyColumn(SColumnInfoData *pCol) {
+  taosMemoryFree(pCol->pData);
+  taosMemoryFree(pCol->nullbitmap);
+}
+
+bool isNullRow(const SColumnInfoData *pCol, int32_t i) { return pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i); }
+
+template <typename T>
+T getValue(const SColumnInfoData *pCol, int32_t i) {
+  return *(T *)(pCol->pData + i * sizeof(T));
+}
+
+// row by row result of the aggregates, with the first row holding the min/max
+template <typename T, typename S>
+void checkType(const SColumnInfoData *pCol, int32_t start, int32_t numOfRows) {
+  S       sum = 0;
+  T       minVal = 0, maxVal = 0;
+  int32_t minIndex = -1, maxIndex = -1;
+  int32_t num = 0;
+
+  for (int32_t i = start; i < start + numOfRows; ++i) {
+    if (isNullRow(pCol, i)) {
+      continue;
+    }
+
+    T v = getValue<T>(pCol, i);
+    sum += v;
+    if (num == 0 || v < minVal) {
+      minVal = v;
+      minIndex = i;
+    }
+    if (num == 0 || v > maxVal) {
+      maxVal = v;
+      maxIndex = i;
+    }
+    num += 1;
+  }
+
+  S res = 0;
+  ASSERT_EQ(vecSumColumn(pCol, start, numOfRows, &res), num);
+  if (std::is_floating_point<S>::value) {
+    ASSERT_NEAR((double)res, (double)sum, 1e-9 * TMAX(fabs((double)sum), 1.0));
+  } else {
+    ASSERT_EQ(res, sum);
+  }
+
+  T       v = 0;
+  int32_t index = -1;
+  ASSERT_EQ(vecMinMaxColumn(pCol, start, numOfRows, true, &v, &index), num);
+  if (num > 0) {
+    ASSERT_EQ(v, minVal);
+    ASSERT_EQ(index, minIndex);
+  } else {
+    ASSERT_EQ(index, -1);
+  }
+
+  index = -1;
+  ASSERT_EQ(vecMinMaxColumn(pCol, start, numOfRows, false, &v, &index), num);
+  if (num > 0) {
+    ASSERT_EQ(v, maxVal);
+    ASSERT_EQ(index, maxIndex);
+  }
+
+  ASSERT_EQ(vecCountColumn(pCol, start, numOfRows), num);
+}
+
+void checkColumn(const SColumnInfoData *pCol, int32_t start, int32_t numOfRows) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      checkType<int8_t, int64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      checkType<int16_t, int64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      checkType<int32_t, int64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      checkType<int64_t, int64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      checkType<uint8_t, uint64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      checkType<uint16_t, uint64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      checkType<uint32_t, uint64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      checkType<uint64_t, uint64_t>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      checkType<float, double>(pCol, start, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      checkType<double, double>(pCol, start, numOfRows);
+      break;
+  }
+}
+
+// both the scalar and the SIMD kernels, with heads and tails not aligned to a bitmap byte or a vector
+void checkAllKernels(int32_t nullMode) {
+  const int32_t numOfRows = 1037;
+  const int32_t ranges[][2] = {{0, numOfRows}, {3, 1000}, {8, 64}, {13, 7}, {1, 1}, {500, 0}};
+
+  for (int32_t t = 0; t < tListLen(aggTypes); ++t) {
+    SColumnInfoData col;
+    initColumn(&col, aggTypes[t], numOfRows, nullMode);
+
+    for (int32_t simd = 0; simd < 2; ++simd) {
+      if (simd == 1 && !vecAggSetSimd(true)) {
+        break;
+      }
+      vecAggSetSimd(simd == 1);
+
+      for (int32_t r = 0; r < tListLen(ranges); ++r) {
+        SCOPED_TRACE(testing::Message() << "type:" << aggTypes[t] << " simd:" << simd << " start:" << ranges[r][0]
+                                        << " rows:" << ranges[r][1]);
+        checkColumn(&col, ranges[r][0], ranges[r][1]);
+      }
+    }
+
+    destroyColumn(&col);
+  }
+}
+
+}  // namespace
+
+class VecAggTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    taosSeedRand(taosGetTimestampSec());
+    vecAggInit();
+  }
+
+  void TearDown() override { vecAggSetSimd(true); }
+};
+
+TEST_F(VecAggTest, noNull) { checkAllKernels(0); }
+
+TEST_F(VecAggTest, withNull) { checkAllKernels(1); }
+
+TEST_F(VecAggTest, allNull) { checkAllKernels(2); }
+
+// the first of the rows holding the min/max is returned, whatever lane finds it
+TEST_F(VecAggTest, minMaxFirstIndex) {
+  const int32_t numOfRows = 100;
+
+  for (int32_t simd = 0; simd < 2; ++simd) {
+    vecAggSetSimd(simd == 1);
+
+    SColumnInfoData col;
+    initColumn(&col, TSDB_DATA_TYPE_INT, numOfRows, 0);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ((int32_t *)col.pData)[i] = 5;
+    }
+    ((int32_t *)col.pData)[37] = 1;
+    ((int32_t *)col.pData)[71] = 1;
+    ((int32_t *)col.pData)[40] = 9;
+    ((int32_t *)col.pData)[90] = 9;
+
+    int32_t v = 0, index = -1;
+    ASSERT_EQ(vecMinMaxColumn(&col, 0, numOfRows, true, &v, &index), numOfRows);
+    EXPECT_EQ(v, 1);
+    EXPECT_EQ(index, 37);
+    ASSERT_EQ(vecMinMaxColumn(&col, 0, numOfRows, false, &v, &index), numOfRows);
+    EXPECT_EQ(v, 9);
+    EXPECT_EQ(index, 40);
+
+    // the first min is NULL, the second one is taken
+    col.hasNull = true;
+    colDataSetNull_f(col.nullbitmap, 37);
+    ASSERT_EQ(vecMinMaxColumn(&col, 0, numOfRows, true, &v, &index), numOfRows - 1);
+    EXPECT_EQ(v, 1);
+    EXPECT_EQ(index, 71);
+
+    destroyColumn(&col);
+  }
+}
+
+// the sums of the integer types wrap around like the row by row addition
+TEST_F(VecAggTest, sumOverflow) {
+  const int32_t numOfRows = 64;
+
+  for (int32_t simd = 0; simd < 2; ++simd) {
+    vecAggSetSimd(simd == 1);
+
+    SColumnInfoData col;
+    initColumn(&col, TSDB_DATA_TYPE_UBIGINT, numOfRows, 0);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ((uint64_t *)col.pData)[i] = UINT64_MAX - i;
+    }
+    checkColumn(&col, 0, numOfRows);
+    destroyColumn(&col);
+
+    initColumn(&col, TSDB_DATA_TYPE_BIGINT, numOfRows, 0);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ((int64_t *)col.pData)[i] = (i & 1) ? INT64_MAX : INT64_MIN + 1;
+    }
+    checkColumn(&col, 0, numOfRows);
+    destroyColumn(&col);
+  }
+}
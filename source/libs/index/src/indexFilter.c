@@ -79,6 +79,10 @@ typedef struct SIFParam {
   char          colName[TSDB_COL_NAME_LEN * 2 + 4];
 
   SIndexMetaArg arg;
+
+  // tag index condition not run yet, so that an AND of several can be evaluated by meta in one pass
+  bool          fltPending;
+  SMetaFltParam fltParam;
 } SIFParam;
 
 typedef struct SIFCtx {
@@ -120,6 +124,8 @@ static FORCE_INLINE void sifFreeParam(SIFParam *param) {
   param->condValue = NULL;
   taosHashCleanup(param->pFilter);
   param->pFilter = NULL;
+  taosMemoryFree(param->fltParam.val);
+  param->fltParam.val = NULL;
 }
 
 static FORCE_INLINE int32_t sifGetOperParamNum(EOperatorType ty) {
@@ -477,6 +483,7 @@ static int32_t sifDoIndex(SIFParam *left, SIFParam *right, int8_t operType, SIFP
                            .type = left->colValType,
                            .val = right->condValue,
                            .reverse = reverse,
+                           .equal = qtype == QUERY_TERM,
                            .filterFunc = filterFunc};
 
     char buf[128] = {0};
@@ -492,11 +499,56 @@ static int32_t sifDoIndex(SIFParam *left, SIFParam *right, int8_t operType, SIFP
     } else {
       sifSetFltParam(left, right, &typedata, &param);
     }
-    ret = metaFilterTableIds(arg->metaEx, &param, output->result);
+    if (filterFunc == NULL) {
+      ret = metaFilterTableIds(arg->metaEx, &param, output->result);
+    } else {
+      int32_t len = IS_VAR_DATA_TYPE(param.type) ? varDataTLen(param.val) : tDataTypes[param.type].bytes;
+      output->fltParam = param;
+      output->fltParam.val = taosMemoryMalloc(len);
+      if (output->fltParam.val == NULL) {
+        return TSDB_CODE_QRY_OUT_OF_MEMORY;
+      }
+      memcpy(output->fltParam.val, param.val, len);
+      output->fltPending = true;
+    }
   }
   return ret;
 }
 
+static int32_t sifExecPending(SIFParam *param) {
+  if (!param->fltPending) {
+    return TSDB_CODE_SUCCESS;
+  }
+  param->fltPending = false;
+  return metaFilterTableIds(param->arg.metaEx, &param->fltParam, param->result);
+}
+
+// the pending children of an AND are intersected by meta, the rest are left to the caller
+static int32_t sifExecPendingAnd(SIFParam *params, int32_t nParam, SIFParam *output) {
+  int32_t nPending = 0;
+  for (int32_t m = 0; m < nParam; m++) {
+    if (params[m].fltPending) nPending++;
+  }
+  if (nPending <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SMetaFltParam *flts = taosMemoryCalloc(nPending, sizeof(SMetaFltParam));
+  if (flts == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  int32_t n = 0;
+  for (int32_t m = 0; m < nParam; m++) {
+    if (params[m].fltPending) {
+      flts[n++] = params[m].fltParam;
+      params[m].fltPending = false;
+    }
+  }
+  int32_t code = metaFilterTableIdsMulti(output->arg.metaEx, flts, nPending, output->result);
+  taosMemoryFree(flts);
+  return code;
+}
+
 static FORCE_INLINE int32_t sifLessThanFunc(SIFParam *left, SIFParam *right, SIFParam *output) {
   int id = OP_TYPE_LOWER_THAN;
   return sifDoIndex(left, right, id, output);
@@ -685,7 +737,12 @@ static int32_t sifExecLogic(SLogicConditionNode *node, SIFCtx *ctx, SIFParam *ou
   SIF_ERR_RET(sifInitParamList(&params, node->pParameterList, ctx));
 
   if (ctx->noExec == false) {
+    output->arg = ctx->arg;
+    if (node->condType == LOGIC_COND_TYPE_AND) {
+      SIF_ERR_JRET(sifExecPendingAnd(params, node->pParameterList->length, output));
+    }
     for (int32_t m = 0; m < node->pParameterList->length; m++) {
+      SIF_ERR_JRET(sifExecPending(&params[m]));
       if (node->condType == LOGIC_COND_TYPE_AND) {
         taosArrayAddAll(output->result, params[m].result);
       } else if (node->condType == LOGIC_COND_TYPE_OR) {
@@ -821,7 +878,8 @@ static int32_t sifCalculate(SNode *pNode, SIFParam *pDst) {
       indexError("no valid res in hash, node:(%p), type(%d)", (void *)&pNode, nodeType(pNode));
       SIF_ERR_RET(TSDB_CODE_QRY_APP_ERROR);
     }
-    if (res->result != NULL) {
+    code = sifExecPending(res);
+    if (code == 0 && res->result != NULL) {
       taosArrayAddAll(pDst->result, res->result);
     }
 
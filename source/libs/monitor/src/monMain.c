@@ -395,6 +395,8 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "req_insert_batch", pStat->numOfBatchInsertReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_success", pStat->numOfBatchInsertSuccessReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_rate", req_insert_batch_rate);
+  tjsonAddDoubleToObject(pJson, "schema_cache_hit", pStat->numOfSchemaCacheHits);
+  tjsonAddDoubleToObject(pJson, "schema_cache_miss", pStat->numOfSchemaCacheMisses);
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
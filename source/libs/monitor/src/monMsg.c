@@ -349,6 +349,8 @@ int32_t tEncodeSVnodesStat(SEncoder *encoder, const SVnodesStat *pStat) {
   if (tEncodeI64(encoder, pStat->numOfInsertSuccessReqs) < 0) return -1;
   if (tEncodeI64(encoder, pStat->numOfBatchInsertReqs) < 0) return -1;
   if (tEncodeI64(encoder, pStat->numOfBatchInsertSuccessReqs) < 0) return -1;
+  if (tEncodeI64(encoder, pStat->numOfSchemaCacheHits) < 0) return -1;
+  if (tEncodeI64(encoder, pStat->numOfSchemaCacheMisses) < 0) return -1;
   if (tEncodeI64(encoder, pStat->errors) < 0) return -1;
   return 0;
 }
@@ -362,6 +364,8 @@ static int32_t tDecodeSVnodesStat(SDecoder *decoder, SVnodesStat *pStat) {
   if (tDecodeI64(decoder, &pStat->numOfInsertSuccessReqs) < 0) return -1;
   if (tDecodeI64(decoder, &pStat->numOfBatchInsertReqs) < 0) return -1;
   if (tDecodeI64(decoder, &pStat->numOfBatchInsertSuccessReqs) < 0) return -1;
+  if (tDecodeI64(decoder, &pStat->numOfSchemaCacheHits) < 0) return -1;
+  if (tDecodeI64(decoder, &pStat->numOfSchemaCacheMisses) < 0) return -1;
   if (tDecodeI64(decoder, &pStat->errors) < 0) return -1;
   return 0;
 }
@@ -521,6 +525,8 @@ int32_t tSerializeSMonVloadInfo(void *buf, int32_t bufLen, SMonVloadInfo *pInfo)
     if (tEncodeI64(&encoder, pLoad->numOfInsertSuccessReqs) < 0) return -1;
     if (tEncodeI64(&encoder, pLoad->numOfBatchInsertReqs) < 0) return -1;
     if (tEncodeI64(&encoder, pLoad->numOfBatchInsertSuccessReqs) < 0) return -1;
+    if (tEncodeI64(&encoder, pLoad->numOfSchemaCacheHits) < 0) return -1;
+    if (tEncodeI64(&encoder, pLoad->numOfSchemaCacheMisses) < 0) return -1;
   }
   tEndEncode(&encoder);
 
@@ -556,6 +562,8 @@ int32_t tDeserializeSMonVloadInfo(void *buf, int32_t bufLen, SMonVloadInfo *pInf
     if (tDecodeI64(&decoder, &load.numOfInsertSuccessReqs) < 0) return -1;
     if (tDecodeI64(&decoder, &load.numOfBatchInsertReqs) < 0) return -1;
     if (tDecodeI64(&decoder, &load.numOfBatchInsertSuccessReqs) < 0) return -1;
+    if (tDecodeI64(&decoder, &load.numOfSchemaCacheHits) < 0) return -1;
+    if (tDecodeI64(&decoder, &load.numOfSchemaCacheMisses) < 0) return -1;
     taosArrayPush(pInfo->pVloads, &load);
   }
 
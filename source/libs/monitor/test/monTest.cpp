@@ -173,6 +173,8 @@ void MonitorTest::GetVnodeStat(SVnodesStat *pInfo) {
   pInfo->numOfInsertSuccessReqs = 10;
   pInfo->numOfBatchInsertReqs = 11;
   pInfo->numOfBatchInsertSuccessReqs = 12;
+  pInfo->numOfSchemaCacheHits = 13;
+  pInfo->numOfSchemaCacheMisses = 14;
   pInfo->errors = 4;
   pInfo->totalVnodes = 5;
   pInfo->masterNum = 6;
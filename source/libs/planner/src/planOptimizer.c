@@ -663,16 +663,83 @@ static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode*
   }
 }
 
+static bool pushDownCondOptIsColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight)) {
+    return false;
+  }
+  // the hash join compares the key values byte by byte, so both sides must be of the same type
+  if (((SExprNode*)pOper->pLeft)->resType.type != ((SExprNode*)pOper->pRight)->resType.type) {
+    return false;
+  }
+
+  SNodeList* pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList* pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptBelongThisTable(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptBelongThisTable(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+static bool pushDownCondOptContainColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+    if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
+      return false;
+    }
+    SNode* pCond = NULL;
+    FOREACH(pCond, pLogicCond->pParameterList) {
+      if (pushDownCondOptIsColEqualCond(pJoin, pCond)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return pushDownCondOptIsColEqualCond(pJoin, pCond);
+}
+
 static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
   if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+    // without left.ts = right.ts the inputs cannot be merged by timestamp, fall back to hashing the equal columns
+    if (pushDownCondOptContainColEqualCond(pJoin, pJoin->pOnConditions)) {
+      pJoin->hashJoin = true;
+      return TSDB_CODE_SUCCESS;
+    }
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
   }
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t pushDownCondOptSetHashJoinDataOrder(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
+  // the output of a hash join is not ordered by timestamp
+  if (NULL != pJoin->node.pParent && pJoin->node.pParent->requireDataOrder > DATA_ORDER_LEVEL_NONE) {
+    return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
+  }
+
+  pJoin->node.requireDataOrder = DATA_ORDER_LEVEL_NONE;
+  pJoin->node.resultDataOrder = DATA_ORDER_LEVEL_NONE;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  SNode*  pChild = NULL;
+  FOREACH(pChild, pJoin->node.pChildren) {
+    code = adjustLogicNodeDataRequirement((SLogicNode*)pChild, DATA_ORDER_LEVEL_NONE);
+    if (TSDB_CODE_SUCCESS != code) {
+      break;
+    }
+  }
+  return code;
+}
+
 static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, SNode** ppMergeCond, SNode** ppOnCond) {
   SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pJoin->pOnConditions);
 
@@ -723,6 +790,11 @@ static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMe
 
 static int32_t pushDownCondOptJoinExtractMergeCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   int32_t code = pushDownCondOptCheckJoinOnCond(pCxt, pJoin);
+  if (TSDB_CODE_SUCCESS == code && pJoin->hashJoin) {
+    // the equal columns are picked out of the on conditions when the physical plan is created
+    return pushDownCondOptSetHashJoinDataOrder(pCxt, pJoin);
+  }
+
   SNode*  pJoinMergeCond = NULL;
   SNode*  pJoinOnCond = NULL;
   if (TSDB_CODE_SUCCESS == code) {
@@ -2391,11 +2463,71 @@ static int32_t tagScanOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubp
   return TSDB_CODE_SUCCESS;
 }
 
+static bool pushDownLimitOptIsOrderedScan(SScanLogicNode* pScan) {
+  if (NULL != pScan->pGroupTags || NULL != pScan->node.pSlimit) {
+    return false;
+  }
+  // the rows of a single table come out in timestamp order, while the rows of a super table only do so when they are
+  // merged by the timestamp
+  return (SCAN_TYPE_TABLE == pScan->scanType && TSDB_SUPER_TABLE != pScan->tableType) ||
+         (SCAN_TYPE_TABLE_MERGE == pScan->scanType && pScan->sortPrimaryKey);
+}
+
+static bool pushDownLimitOptMayBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_PROJECT != nodeType(pNode) || NULL == pNode->pLimit || NULL != pNode->pSlimit ||
+      NULL != pNode->pConditions || 1 != LIST_LENGTH(pNode->pChildren) || ((SLimitNode*)pNode->pLimit)->limit < 0) {
+    return false;
+  }
+
+  SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pNode->pChildren, 0);
+  if (NULL != pChild->pLimit) {
+    return false;
+  }
+
+  switch (nodeType(pChild)) {
+    case QUERY_NODE_LOGIC_PLAN_SORT:
+      return !((SSortLogicNode*)pChild)->groupSort && NULL == pChild->pConditions && NULL == pChild->pSlimit;
+    case QUERY_NODE_LOGIC_PLAN_SCAN:
+      return pushDownLimitOptIsOrderedScan((SScanLogicNode*)pChild);
+    default:
+      break;
+  }
+  return false;
+}
+
+// The projection keeps the original LIMIT/OFFSET, its child only needs to produce the first 'limit + offset' rows.
+// A sort with limit runs as a bounded TopN, and keeps the limit when it is split into the partial sort of each vgroup.
+// An ordered table scan stops reading once enough rows have been returned.
+static int32_t pushDownLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  if (pCxt->pPlanCxt->streamQuery) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SLogicNode* pProject = optFindPossibleNode(pLogicSubplan->pNode, pushDownLimitOptMayBeOptimized);
+  if (NULL == pProject) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SLimitNode* pLimit = (SLimitNode*)pProject->pLimit;
+  SLimitNode* pChildLimit = (SLimitNode*)nodesMakeNode(QUERY_NODE_LIMIT);
+  if (NULL == pChildLimit) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pChildLimit->limit = pLimit->limit + (pLimit->offset > 0 ? pLimit->offset : 0);
+  pChildLimit->offset = 0;
+
+  SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pProject->pChildren, 0);
+  pChild->pLimit = (SNode*)pChildLimit;
+  pCxt->optimized = true;
+  return TSDB_CODE_SUCCESS;
+}
+
 // clang-format off
 static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "ScanPath",                   .optimizeFunc = scanPathOptimize},
   {.pName = "PushDownCondition",          .optimizeFunc = pushDownCondOptimize},
   {.pName = "SortPrimaryKey",             .optimizeFunc = sortPrimaryKeyOptimize},
+  {.pName = "PushDownLimit",              .optimizeFunc = pushDownLimitOptimize},
   {.pName = "SmaIndex",                   .optimizeFunc = smaIndexOptimize},
   {.pName = "PartitionTags",              .optimizeFunc = partTagsOptimize},
   {.pName = "MergeProjects",              .optimizeFunc = mergeProjectsOptimize},
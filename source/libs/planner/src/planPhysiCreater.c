@@ -562,6 +562,7 @@ static int32_t createTableScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubp
   pTableScan->watermark = pScanLogicNode->watermark;
   pTableScan->igExpired = pScanLogicNode->igExpired;
   pTableScan->assignBlockUid = pCxt->pPlanCxt->rSmaQuery ? true : false;
+  pTableScan->parallelism = (pCxt->pPlanCxt->streamQuery || pCxt->pPlanCxt->topicQuery) ? 1 : tsQueryScanParallelism;
 
   return createScanPhysiNodeFinalize(pCxt, pSubplan, pScanLogicNode, (SScanPhysiNode*)pTableScan, pPhyNode);
 }
@@ -629,8 +630,149 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
+static bool isHashJoinKeyCond(SPhysiPlanContext* pCxt, SDataBlockDescNode* pLeftDesc, SDataBlockDescNode* pRightDesc,
+                              SNode* pCond, SNode** pLeftKey, SNode** pRightKey) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond) || OP_TYPE_EQUAL != ((SOperatorNode*)pCond)->opType) {
+    return false;
+  }
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (QUERY_NODE_COLUMN != nodeType(pOper->pLeft) || QUERY_NODE_COLUMN != nodeType(pOper->pRight) ||
+      ((SExprNode*)pOper->pLeft)->resType.type != ((SExprNode*)pOper->pRight)->resType.type) {
+    return false;
+  }
+
+  SNode* pLeft = NULL;
+  SNode* pRight = NULL;
+  if (TSDB_CODE_SUCCESS !=
+          setNodeSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pOper->pLeft, &pLeft) ||
+      TSDB_CODE_SUCCESS !=
+          setNodeSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pOper->pRight, &pRight)) {
+    nodesDestroyNode(pLeft);
+    return false;
+  }
+
+  int16_t leftBlockId = ((SColumnNode*)pLeft)->dataBlockId;
+  int16_t rightBlockId = ((SColumnNode*)pRight)->dataBlockId;
+  if (leftBlockId == pLeftDesc->dataBlockId && rightBlockId == pRightDesc->dataBlockId) {
+    *pLeftKey = pLeft;
+    *pRightKey = pRight;
+    return true;
+  } else if (leftBlockId == pRightDesc->dataBlockId && rightBlockId == pLeftDesc->dataBlockId) {
+    *pLeftKey = pRight;
+    *pRightKey = pLeft;
+    return true;
+  }
+
+  nodesDestroyNode(pLeft);
+  nodesDestroyNode(pRight);
+  return false;
+}
+
+static int32_t partHashJoinCond(SPhysiPlanContext* pCxt, SDataBlockDescNode* pLeftDesc, SDataBlockDescNode* pRightDesc,
+                                SNode* pCond, SHashJoinPhysiNode* pJoin, SNodeList** pOtherConds) {
+  SNode* pLeftKey = NULL;
+  SNode* pRightKey = NULL;
+  if (!isHashJoinKeyCond(pCxt, pLeftDesc, pRightDesc, pCond, &pLeftKey, &pRightKey)) {
+    return nodesListMakeStrictAppend(pOtherConds, nodesCloneNode(pCond));
+  }
+  int32_t code = nodesListMakeStrictAppend(&pJoin->pLeftKeys, pLeftKey);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pJoin->pRightKeys, pRightKey);
+  } else {
+    nodesDestroyNode(pRightKey);
+  }
+  return code;
+}
+
+// The equal columns of both sides are the hash keys, the rest of the on conditions is evaluated after the join.
+static int32_t partHashJoinOnCond(SPhysiPlanContext* pCxt, SDataBlockDescNode* pLeftDesc,
+                                  SDataBlockDescNode* pRightDesc, SNode* pOnCond, SHashJoinPhysiNode* pJoin,
+                                  SNode** pOtherCond) {
+  int32_t    code = TSDB_CODE_SUCCESS;
+  SNodeList* pOtherConds = NULL;
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pOnCond) &&
+      LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)pOnCond)->condType) {
+    SNode* pCond = NULL;
+    FOREACH(pCond, ((SLogicConditionNode*)pOnCond)->pParameterList) {
+      code = partHashJoinCond(pCxt, pLeftDesc, pRightDesc, pCond, pJoin, &pOtherConds);
+      if (TSDB_CODE_SUCCESS != code) {
+        break;
+      }
+    }
+  } else {
+    code = partHashJoinCond(pCxt, pLeftDesc, pRightDesc, pOnCond, pJoin, &pOtherConds);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && 0 == LIST_LENGTH(pJoin->pLeftKeys)) {
+    planError("hash join without equal columns of both sides");
+    code = TSDB_CODE_PLAN_INTERNAL_ERROR;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesMergeConds(pOtherCond, &pOtherConds);
+  }
+  if (TSDB_CODE_SUCCESS != code) {
+    nodesDestroyList(pOtherConds);
+  }
+  return code;
+}
+
+static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                       SPhysiNode** pPhyNode) {
+  SHashJoinPhysiNode* pJoin =
+      (SHashJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  if (NULL == pJoin) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SDataBlockDescNode* pLeftDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 0))->pOutputDataBlockDesc;
+  SDataBlockDescNode* pRightDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 1))->pOutputDataBlockDesc;
+  SNode*              pOtherCond = NULL;
+
+  pJoin->joinType = pJoinLogicNode->joinType;
+  int32_t code =
+      partHashJoinOnCond(pCxt, pLeftDesc, pRightDesc, pJoinLogicNode->pOnConditions, pJoin, &pOtherCond);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setListSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->node.pTargets,
+                         &pJoin->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, pJoin->pTargets, pJoin->node.pOutputDataBlockDesc);
+  }
+
+  SNodeList* condCols = nodesMakeList();
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    code = nodesCollectColumnsFromNode(pOtherCond, NULL, COLLECT_COL_TYPE_ALL, &condCols);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, condCols, pJoin->node.pOutputDataBlockDesc);
+  }
+  nodesDestroyList(condCols);
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    code = setNodeSlotId(pCxt, ((SPhysiNode*)pJoin)->pOutputDataBlockDesc->dataBlockId, -1, pOtherCond,
+                         &pJoin->pOnConditions);
+  }
+  nodesDestroyNode(pOtherCond);
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setConditionsSlotId(pCxt, (const SLogicNode*)pJoinLogicNode, (SPhysiNode*)pJoin);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *pPhyNode = (SPhysiNode*)pJoin;
+  } else {
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  return code;
+}
+
 static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
                                    SPhysiNode** pPhyNode) {
+  if (pJoinLogicNode->hashJoin) {
+    return createHashJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+  }
+
   SSortMergeJoinPhysiNode* pJoin =
       (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
   if (NULL == pJoin) {
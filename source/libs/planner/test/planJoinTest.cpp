@@ -62,3 +62,13 @@ TEST_F(PlanJoinTest, stable) {
 
   run("SELECT t1.c1, t2.c1 FROM st1 t1 JOIN st2 t2 ON t1.ts = t2.ts ");
 }
+
+TEST_F(PlanJoinTest, hashJoin) {
+  useDb("root", "test");
+
+  run("SELECT t1.c1, t2.c2 FROM st1s1 t1 JOIN st1s2 t2 ON t1.c1 = t2.c1");
+
+  run("SELECT t1.c1, t2.c2 FROM st1s1 t1 JOIN st1s2 t2 ON t1.c1 = t2.c1 AND t1.c2 = t2.c2 AND t1.ts > t2.ts");
+
+  run("SELECT COUNT(*) FROM st1 t1 JOIN st2 t2 ON t1.c1 = t2.c1");
+}
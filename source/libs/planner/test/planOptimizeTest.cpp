@@ -75,6 +75,20 @@ TEST_F(PlanOptimizeTest, sortPrimaryKey) {
       "FILL(LINEAR) ORDER BY _WSTART");
 }
 
+TEST_F(PlanOptimizeTest, pushDownLimit) {
+  useDb("root", "test");
+
+  run("SELECT c1 FROM t1 ORDER BY c1 LIMIT 10");
+
+  run("SELECT c1 FROM st1 ORDER BY c1 LIMIT 5 OFFSET 3");
+
+  run("SELECT c1 FROM t1 ORDER BY ts LIMIT 10");
+
+  run("SELECT c1 FROM st1 ORDER BY ts DESC LIMIT 10");
+
+  run("SELECT c1 FROM t1 WHERE c1 > 10 LIMIT 10");
+}
+
 TEST_F(PlanOptimizeTest, PartitionTags) {
   useDb("root", "test");
 
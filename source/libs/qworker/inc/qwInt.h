@@ -87,6 +87,7 @@ typedef struct SQWMsgInfo {
   int8_t taskType;
   int8_t explain;
   int8_t needFetch;
+  int8_t staleRead;
 } SQWMsgInfo;
 
 typedef struct SQWMsg {
@@ -133,6 +134,7 @@ typedef struct SQWTaskCtx {
   int8_t   taskType;
   int8_t   explain;
   int8_t   needFetch;
+  int8_t   staleRead;  // admitted with bounded staleness, may be fetched on a follower
   int32_t  msgType;
   int32_t  fetchType;
   int32_t  execId;
@@ -387,6 +387,10 @@ int32_t qWorkerProcessQueryMsg(void *node, void *qWorkerMgmt, SRpcMsg *pMsg, int
   qwMsg.msgInfo.explain = msg->explain;
   qwMsg.msgInfo.taskType = msg->taskType;
   qwMsg.msgInfo.needFetch = msg->needFetch;
+
+  SSubQueryMsgExt ext = {0};
+  tGetSubQueryMsgExt(msg, pMsg->contLen, &ext);
+  qwMsg.msgInfo.staleRead = (ext.maxStaleMs > 0);
   
   char * sql = strndup(msg->msg, msg->sqlLen);
   QW_SCH_TASK_DLOG("processQuery start, node:%p, type:%s, handle:%p, SQL:%s", node, TMSG_INFO(pMsg->msgType), pMsg->info.handle, sql);
@@ -399,6 +403,31 @@ _return:
   return code;
 }
 
+bool qWorkerIsStaleReadTask(void *qWorkerMgmt, SRpcMsg *pMsg) {
+  SResFetchReq *msg = pMsg->pCont;
+  SQWorker *    mgmt = (SQWorker *)qWorkerMgmt;
+  SQWTaskCtx *  ctx = NULL;
+
+  if (NULL == msg || pMsg->contLen < sizeof(*msg)) {
+    return false;
+  }
+
+  // not converted to host order yet, see qWorkerProcessFetchMsg
+  uint64_t sId = be64toh(msg->sId);
+  uint64_t qId = be64toh(msg->queryId);
+  uint64_t tId = be64toh(msg->taskId);
+  int64_t  rId = 0;
+  int32_t  eId = ntohl(msg->execId);
+
+  if (qwAcquireTaskCtx(QW_FPARAMS(), &ctx)) {
+    return false;
+  }
+
+  bool staleRead = ctx->staleRead;
+  qwReleaseTaskCtx(mgmt, ctx);
+  return staleRead;
+}
+
 int32_t qWorkerProcessCQueryMsg(void *node, void *qWorkerMgmt, SRpcMsg *pMsg, int64_t ts) {
   int32_t            code = 0;
   int8_t             status = 0;
@@ -233,6 +233,19 @@ typedef struct SFltBuildGroupCtx {
   int32_t      code;
 } SFltBuildGroupCtx;
 
+#define FLT_KERNEL_MAX_IN_VALS 16
+
+typedef struct SFltKernel SFltKernel;
+typedef void (*flt_kernel_func)(const SFltKernel *pKernel, const char *pData, int32_t numOfRows, int8_t *res);
+
+// type specialized kernel of a filter that compares one fixed length column with constant values
+struct SFltKernel {
+  flt_kernel_func fp;
+  uint8_t         type;       // type of the column
+  int32_t         numOfVals;  // number of the values in the IN list
+  int64_t         vals[FLT_KERNEL_MAX_IN_VALS];  // bounds of the range or values of the IN list, in the column type
+};
+
 struct SFilterInfo {
   bool              scalarMode;
   SFltScalarCtx     sclCtx;
@@ -258,6 +271,7 @@ struct SFilterInfo {
   SArray           *blkList;
 
   SFilterPCtx       pctx;
+  SFltKernel        kernel;
 };
 
 #define FILTER_NO_MERGE_DATA_TYPE(t) ((t) == TSDB_DATA_TYPE_BINARY || (t) == TSDB_DATA_TYPE_NCHAR || (t) == TSDB_DATA_TYPE_JSON)
@@ -351,6 +365,15 @@ struct SFilterInfo {
 extern bool filterDoCompare(__compar_fn_t func, uint8_t optr, void *left, void *right);
 extern __compar_fn_t filterGetCompFunc(int32_t type, int32_t optr);
 extern __compar_fn_t filterGetCompFuncEx(int32_t lType, int32_t rType, int32_t optr);
+extern bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SColumnDataAgg *statis, int16_t numOfCols);
+extern bool filterExecuteImplKernel(void *pinfo, int32_t numOfRows, int8_t** p, SColumnDataAgg *statis, int16_t numOfCols);
+extern filter_exec_func filterGetGenericExecFunc(SFilterInfo *info);
+
+extern bool fltInitKernel(const SFilterComUnit *pUnit, SFltKernel *pKernel);
+extern bool fltInitInKernel(const SFilterInfo *info, SFltKernel *pKernel);
+extern bool fltExecKernel(const SFltKernel *pKernel, const SColumnInfoData *pCol, int32_t numOfRows, int8_t *res);
+extern bool fltInitCompareKernel(int32_t type, int32_t optr, const void *pVal, SFltKernel *pKernel);
+extern bool fltCompareColumns(int32_t optr, const SColumnInfoData *pLeft, const SColumnInfoData *pRight, int32_t numOfRows, int8_t *res);
 
 #ifdef __cplusplus
 }
@@ -1186,7 +1186,8 @@ int32_t fltAddGroupUnitFromNode(SFilterInfo *info, SNode* tree, SArray *group) {
         filterAddField(info, NULL, (void**) &out.columnData->pData, FLD_TYPE_VALUE, &right, len, true);
         out.columnData->pData = NULL;
       } else {
-        void *data = taosMemoryCalloc(1, tDataTypes[type].bytes);
+        // the ranges read the value as an int64_t, see SIMPLE_COPY_VALUES
+        void *data = taosMemoryCalloc(1, TMAX(tDataTypes[type].bytes, sizeof(int64_t)));
         if (NULL == data) {
           FLT_ERR_RET(TSDB_CODE_QRY_OUT_OF_MEMORY);
         }
@@ -3207,6 +3208,38 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, int8_t** p, SColumnDa
 }
 
 
+// the filter of the units that a kernel compares at once, for the column types the kernel does not cover
+filter_exec_func filterGetGenericExecFunc(SFilterInfo *info) {
+  if (info->unitNum > 1) {
+    return filterExecuteImpl;
+  }
+
+  return info->cunits[0].rfunc >= 0 ? filterExecuteImplRange : filterExecuteImplMisc;
+}
+
+// single unit, or the = of an IN list, on a fixed length column, compared by the type specialized kernel
+bool filterExecuteImplKernel(void *pinfo, int32_t numOfRows, int8_t** p, SColumnDataAgg *statis, int16_t numOfCols) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  SColumnInfoData *pCol = info->cunits[0].colData;
+  bool all = true;
+
+  if (pCol == NULL || pCol->info.type != info->kernel.type) {
+    return (*filterGetGenericExecFunc(info))(pinfo, numOfRows, p, statis, numOfCols);
+  }
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, p, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  // every row is written by the kernel
+  if (*p == NULL) {
+    *p = taosMemoryMalloc(numOfRows * sizeof(int8_t));
+  }
+
+  return fltExecKernel(&info->kernel, pCol, numOfRows, *p);
+}
+
+
 bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SColumnDataAgg *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -3293,7 +3326,7 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
   }
 
   if (info->unitNum > 1) {
-    info->func = filterExecuteImpl;
+    info->func = fltInitInKernel(info, &info->kernel) ? filterExecuteImplKernel : filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -3307,6 +3340,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (fltInitKernel(&info->cunits[0], &info->kernel)) {
+    info->func = filterExecuteImplKernel;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->cunits[0].rfunc >= 0) {
     info->func = filterExecuteImplRange;
     return TSDB_CODE_SUCCESS;
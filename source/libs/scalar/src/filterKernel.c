@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "os.h"
+#include "filterInt.h"
+#include "tcompare.h"
+
+// same results as compareFloatVal/compareDoubleVal, so that the kernels agree with the generic filter
+static FORCE_INLINE int32_t fltCmpFloat(float p1, float p2) {
+  if (isnan(p1) && isnan(p2)) {
+    return 0;
+  }
+  if (isnan(p1)) {
+    return -1;
+  }
+  if (isnan(p2)) {
+    return 1;
+  }
+  if (p1 == p2 || FLT_EQUAL(p1, p2)) {
+    return 0;
+  }
+  return FLT_GREATER(p1, p2) ? 1 : -1;
+}
+
+static FORCE_INLINE int32_t fltCmpDouble(double p1, double p2) {
+  if (isnan(p1) && isnan(p2)) {
+    return 0;
+  }
+  if (isnan(p1)) {
+    return -1;
+  }
+  if (isnan(p2)) {
+    return 1;
+  }
+  if (p1 == p2 || FLT_EQUAL(p1, p2)) {
+    return 0;
+  }
+  return FLT_GREATER(p1, p2) ? 1 : -1;
+}
+
+#define FLT_CMP_INT(_x, _v) (((_x) > (_v)) - ((_x) < (_v)))
+
+// the loops have no branch and no call, so that the compiler is able to vectorize them
+#define FLT_KERNEL(_name, _type, _expr)                                                          \
+  static void _name(const SFltKernel *pKernel, const char *pData, int32_t numOfRows, int8_t *res) { \
+    const _type *p = (const _type *)pData;                                                       \
+    _type        lo, hi;                                                                         \
+    memcpy(&lo, &pKernel->vals[0], sizeof(_type));                                               \
+    memcpy(&hi, &pKernel->vals[1], sizeof(_type));                                               \
+    (void)lo;                                                                                    \
+    (void)hi;                                                                                    \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                    \
+      const _type x = p[i];                                                                      \
+      res[i] = (_expr);                                                                          \
+    }                                                                                            \
+  }
+
+// in the order of gRangeCompare, followed by = and <>
+#define FLT_DEFINE_KERNELS(_n, _type, _cmp)                                 \
+  FLT_KERNEL(fltKernelEe##_n, _type, (_cmp(x, lo) > 0) & (_cmp(x, hi) < 0))   \
+  FLT_KERNEL(fltKernelEi##_n, _type, (_cmp(x, lo) > 0) & (_cmp(x, hi) <= 0))  \
+  FLT_KERNEL(fltKernelIe##_n, _type, (_cmp(x, lo) >= 0) & (_cmp(x, hi) < 0))  \
+  FLT_KERNEL(fltKernelIi##_n, _type, (_cmp(x, lo) >= 0) & (_cmp(x, hi) <= 0)) \
+  FLT_KERNEL(fltKernelGe##_n, _type, _cmp(x, lo) > 0)                         \
+  FLT_KERNEL(fltKernelGi##_n, _type, _cmp(x, lo) >= 0)                        \
+  FLT_KERNEL(fltKernelLe##_n, _type, _cmp(x, hi) < 0)                         \
+  FLT_KERNEL(fltKernelLi##_n, _type, _cmp(x, hi) <= 0)                        \
+  FLT_KERNEL(fltKernelEq##_n, _type, _cmp(x, lo) == 0)                        \
+  FLT_KERNEL(fltKernelNe##_n, _type, _cmp(x, lo) != 0)
+
+#define FLT_KERNEL_LIST(_n)                                                                                  \
+  {                                                                                                          \
+    fltKernelEe##_n, fltKernelEi##_n, fltKernelIe##_n, fltKernelIi##_n, fltKernelGe##_n, fltKernelGi##_n,     \
+        fltKernelLe##_n, fltKernelLi##_n, fltKernelEq##_n, fltKernelNe##_n                                   \
+  }
+
+FLT_DEFINE_KERNELS(I8, int8_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(I16, int16_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(I32, int32_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(I64, int64_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(U8, uint8_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(U16, uint16_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(U32, uint32_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(U64, uint64_t, FLT_CMP_INT)
+FLT_DEFINE_KERNELS(F, float, fltCmpFloat)
+FLT_DEFINE_KERNELS(D, double, fltCmpDouble)
+
+#define FLT_KERNEL_EQ_IDX 8
+#define FLT_KERNEL_NE_IDX 9
+
+static flt_kernel_func fltKernels[][10] = {
+    FLT_KERNEL_LIST(I8),  FLT_KERNEL_LIST(I16), FLT_KERNEL_LIST(I32), FLT_KERNEL_LIST(I64), FLT_KERNEL_LIST(U8),
+    FLT_KERNEL_LIST(U16), FLT_KERNEL_LIST(U32), FLT_KERNEL_LIST(U64), FLT_KERNEL_LIST(F),   FLT_KERNEL_LIST(D),
+};
+
+// the values of IN are compared by their raw bytes, as the = of the integers
+#define FLT_IN_KERNEL(_name, _type)                                                                 \
+  static void _name(const SFltKernel *pKernel, const char *pData, int32_t numOfRows, int8_t *res) { \
+    const _type *p = (const _type *)pData;                                                          \
+    _type        vals[FLT_KERNEL_MAX_IN_VALS];                                                      \
+    int32_t      num = pKernel->numOfVals;                                                          \
+    for (int32_t j = 0; j < num; ++j) {                                                             \
+      memcpy(&vals[j], &pKernel->vals[j], sizeof(_type));                                           \
+    }                                                                                               \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                       \
+      const _type x = p[i];                                                                         \
+      int8_t      r = 0;                                                                            \
+      for (int32_t j = 0; j < num; ++j) {                                                           \
+        r |= (x == vals[j]);                                                                        \
+      }                                                                                             \
+      res[i] = r;                                                                                   \
+    }                                                                                               \
+  }
+
+FLT_IN_KERNEL(fltKernelIn1, uint8_t)
+FLT_IN_KERNEL(fltKernelIn2, uint16_t)
+FLT_IN_KERNEL(fltKernelIn4, uint32_t)
+FLT_IN_KERNEL(fltKernelIn8, uint64_t)
+
+// comparisons between two columns of the same type, in the order of the operators from OP_TYPE_GREATER_THAN
+typedef void (*flt_col_kernel_func)(const char *pLeft, const char *pRight, int32_t numOfRows, int8_t *res);
+
+#define FLT_COL_KERNEL(_name, _type, _expr)                                                   \
+  static void _name(const char *pLeft, const char *pRight, int32_t numOfRows, int8_t *res) { \
+    const _type *pl = (const _type *)pLeft;                                                   \
+    const _type *pr = (const _type *)pRight;                                                  \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                 \
+      const _type x = pl[i];                                                                  \
+      const _type y = pr[i];                                                                  \
+      res[i] = (_expr);                                                                       \
+    }                                                                                         \
+  }
+
+#define FLT_DEFINE_COL_KERNELS(_n, _type, _cmp)           \
+  FLT_COL_KERNEL(fltColKernelGt##_n, _type, _cmp(x, y) > 0)  \
+  FLT_COL_KERNEL(fltColKernelGe##_n, _type, _cmp(x, y) >= 0) \
+  FLT_COL_KERNEL(fltColKernelLt##_n, _type, _cmp(x, y) < 0)  \
+  FLT_COL_KERNEL(fltColKernelLe##_n, _type, _cmp(x, y) <= 0) \
+  FLT_COL_KERNEL(fltColKernelEq##_n, _type, _cmp(x, y) == 0) \
+  FLT_COL_KERNEL(fltColKernelNe##_n, _type, _cmp(x, y) != 0)
+
+#define FLT_COL_KERNEL_LIST(_n) \
+  { fltColKernelGt##_n, fltColKernelGe##_n, fltColKernelLt##_n, fltColKernelLe##_n, fltColKernelEq##_n, fltColKernelNe##_n }
+
+FLT_DEFINE_COL_KERNELS(I8, int8_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(I16, int16_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(I32, int32_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(I64, int64_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(U8, uint8_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(U16, uint16_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(U32, uint32_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(U64, uint64_t, FLT_CMP_INT)
+FLT_DEFINE_COL_KERNELS(F, float, fltCmpFloat)
+FLT_DEFINE_COL_KERNELS(D, double, fltCmpDouble)
+
+static flt_col_kernel_func fltColKernels[][6] = {
+    FLT_COL_KERNEL_LIST(I8),  FLT_COL_KERNEL_LIST(I16), FLT_COL_KERNEL_LIST(I32), FLT_COL_KERNEL_LIST(I64),
+    FLT_COL_KERNEL_LIST(U8),  FLT_COL_KERNEL_LIST(U16), FLT_COL_KERNEL_LIST(U32), FLT_COL_KERNEL_LIST(U64),
+    FLT_COL_KERNEL_LIST(F),   FLT_COL_KERNEL_LIST(D),
+};
+
+static int32_t fltKernelTypeIdx(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:   return 0;
+    case TSDB_DATA_TYPE_SMALLINT:  return 1;
+    case TSDB_DATA_TYPE_INT:       return 2;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP: return 3;
+    case TSDB_DATA_TYPE_UTINYINT:  return 4;
+    case TSDB_DATA_TYPE_USMALLINT: return 5;
+    case TSDB_DATA_TYPE_UINT:      return 6;
+    case TSDB_DATA_TYPE_UBIGINT:   return 7;
+    case TSDB_DATA_TYPE_FLOAT:     return 8;
+    case TSDB_DATA_TYPE_DOUBLE:    return 9;
+    default:                       return -1;
+  }
+}
+
+static flt_kernel_func fltGetInKernel(int32_t bytes) {
+  switch (bytes) {
+    case 1: return fltKernelIn1;
+    case 2: return fltKernelIn2;
+    case 4: return fltKernelIn4;
+    case 8: return fltKernelIn8;
+    default: return NULL;
+  }
+}
+
+bool fltInitKernel(const SFilterComUnit *pUnit, SFltKernel *pKernel) {
+  memset(pKernel, 0, sizeof(SFltKernel));
+  if (pUnit->valData == NULL) {
+    return false;
+  }
+
+  int32_t typeIdx = fltKernelTypeIdx(pUnit->dataType);
+  if (typeIdx < 0) {
+    return false;
+  }
+
+  int32_t bytes = tDataTypes[pUnit->dataType].bytes;
+  if (pUnit->rfunc >= 0) {
+    memcpy(&pKernel->vals[0], pUnit->valData, bytes);
+    memcpy(&pKernel->vals[1], pUnit->valData2 ? pUnit->valData2 : pUnit->valData, bytes);
+    pKernel->fp = fltKernels[typeIdx][pUnit->rfunc];
+  } else if (pUnit->optr == OP_TYPE_EQUAL || pUnit->optr == OP_TYPE_NOT_EQUAL) {
+    memcpy(&pKernel->vals[0], pUnit->valData, bytes);
+    pKernel->fp = fltKernels[typeIdx][pUnit->optr == OP_TYPE_EQUAL ? FLT_KERNEL_EQ_IDX : FLT_KERNEL_NE_IDX];
+  }
+
+  if (pKernel->fp == NULL) {
+    return false;
+  }
+
+  pKernel->type = pUnit->dataType;
+  return true;
+}
+
+// an IN list over a fixed length column is split into the groups of one = each, they are compared at once
+bool fltInitInKernel(const SFilterInfo *info, SFltKernel *pKernel) {
+  memset(pKernel, 0, sizeof(SFltKernel));
+  if (info->groupNum > FLT_KERNEL_MAX_IN_VALS || info->groupNum != info->unitNum) {
+    return false;
+  }
+
+  const SFilterComUnit *pFirst = &info->cunits[0];
+  // the equality of float/double is not the bitwise one
+  if (fltKernelTypeIdx(pFirst->dataType) < 0 || IS_FLOAT_TYPE(pFirst->dataType)) {
+    return false;
+  }
+
+  int32_t bytes = tDataTypes[pFirst->dataType].bytes;
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *pGroup = &info->groups[g];
+    if (pGroup->unitNum != 1) {
+      return false;
+    }
+
+    const SFilterComUnit *pUnit = &info->cunits[pGroup->unitIdxs[0]];
+    if (pUnit->optr != OP_TYPE_EQUAL || pUnit->colId != pFirst->colId || pUnit->dataType != pFirst->dataType ||
+        pUnit->valData == NULL) {
+      return false;
+    }
+
+    memcpy(&pKernel->vals[pKernel->numOfVals++], pUnit->valData, bytes);
+  }
+
+  pKernel->fp = fltGetInKernel(bytes);
+  if (pKernel->fp == NULL) {
+    return false;
+  }
+
+  pKernel->type = pFirst->dataType;
+  return true;
+}
+
+bool fltInitCompareKernel(int32_t type, int32_t optr, const void *pVal, SFltKernel *pKernel) {
+  memset(pKernel, 0, sizeof(SFltKernel));
+
+  int32_t typeIdx = fltKernelTypeIdx(type);
+  if (typeIdx < 0) {
+    return false;
+  }
+
+  int32_t idx = -1;
+  switch (optr) {
+    case OP_TYPE_GREATER_THAN:  idx = 4; break;
+    case OP_TYPE_GREATER_EQUAL: idx = 5; break;
+    case OP_TYPE_LOWER_THAN:    idx = 6; break;
+    case OP_TYPE_LOWER_EQUAL:   idx = 7; break;
+    case OP_TYPE_EQUAL:         idx = FLT_KERNEL_EQ_IDX; break;
+    case OP_TYPE_NOT_EQUAL:     idx = FLT_KERNEL_NE_IDX; break;
+    default:                    return false;
+  }
+
+  memcpy(&pKernel->vals[0], pVal, tDataTypes[type].bytes);
+  memcpy(&pKernel->vals[1], pVal, tDataTypes[type].bytes);
+  pKernel->fp = fltKernels[typeIdx][idx];
+  pKernel->type = type;
+  return true;
+}
+
+// NULL never qualifies, the bitmap is scanned a word at a time and only the rows of the non-zero bits are cleared
+static void fltClearNullRows(const SColumnInfoData *pCol, int32_t numOfRows, int8_t *res) {
+  if (pCol->hasNull && pCol->nullbitmap != NULL) {
+    const char *bitmap = pCol->nullbitmap;
+    int32_t     len = BitmapLen(numOfRows);
+    int32_t     i = 0;
+    for (; i + (int32_t)sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+      uint64_t w;
+      memcpy(&w, bitmap + i, sizeof(uint64_t));
+      if (w == 0) {
+        continue;
+      }
+
+      int32_t end = TMIN((i + (int32_t)sizeof(uint64_t)) * 8, numOfRows);
+      for (int32_t r = i * 8; r < end; ++r) {
+        res[r] &= !colDataIsNull_f(bitmap, r);
+      }
+    }
+
+    for (int32_t r = i * 8; r < numOfRows; ++r) {
+      res[r] &= !colDataIsNull_f(bitmap, r);
+    }
+  }
+}
+
+bool fltExecKernel(const SFltKernel *pKernel, const SColumnInfoData *pCol, int32_t numOfRows, int8_t *res) {
+  (*pKernel->fp)(pKernel, pCol->pData, numOfRows, res);
+  fltClearNullRows(pCol, numOfRows, res);
+
+  int32_t num = 0;
+  for (int32_t r = 0; r < numOfRows; ++r) {
+    num += res[r];
+  }
+
+  return num == numOfRows;
+}
+
+bool fltCompareColumns(int32_t optr, const SColumnInfoData *pLeft, const SColumnInfoData *pRight, int32_t numOfRows,
+                       int8_t *res) {
+  int32_t typeIdx = fltKernelTypeIdx(pLeft->info.type);
+  if (typeIdx < 0 || pLeft->info.type != pRight->info.type || optr < OP_TYPE_GREATER_THAN ||
+      optr > OP_TYPE_NOT_EQUAL) {
+    return false;
+  }
+
+  (*fltColKernels[typeIdx][optr - OP_TYPE_GREATER_THAN])(pLeft->pData, pRight->pData, numOfRows, res);
+  fltClearNullRows(pLeft, numOfRows, res);
+  fltClearNullRows(pRight, numOfRows, res);
+  return true;
+}
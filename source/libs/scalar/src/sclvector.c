@@ -1098,6 +1098,143 @@ static void doReleaseVec(SColumnInfoData* pCol, int32_t type) {
   }
 }
 
+// type specialized kernels of + - * / %, used when both operands are numeric columns of the same type, or one of them
+// is a constant. The operands are converted to double as the generic loops do, so the results stay the same.
+#define VEC_MATH_REM_VALID(_lx, _rx) (isfinite(_lx) && isfinite(_rx) && !FLT_EQUAL(_rx, 0))
+
+// division by zero is NULL, as well as the remainder of nan/inf operands
+#define VEC_MATH_KERNEL(_lv, _rv)                                                  \
+  switch (optr) {                                                                  \
+    case OP_TYPE_ADD:                                                              \
+      for (int32_t i = 0; i < numOfRows; ++i) output[i] = (_lv) + (_rv);          \
+      break;                                                                       \
+    case OP_TYPE_SUB:                                                              \
+      for (int32_t i = 0; i < numOfRows; ++i) output[i] = (_lv) - (_rv);          \
+      break;                                                                       \
+    case OP_TYPE_MULTI:                                                            \
+      for (int32_t i = 0; i < numOfRows; ++i) output[i] = (_lv) * (_rv);          \
+      break;                                                                       \
+    case OP_TYPE_DIV:                                                              \
+      for (int32_t i = 0; i < numOfRows; ++i) {                                    \
+        double rx = (_rv);                                                         \
+        output[i] = (_lv) / rx;                                                    \
+        if (rx == 0) {                                                             \
+          colDataSetNull_f(pOutputCol->nullbitmap, i);                             \
+          hasNull = true;                                                          \
+        }                                                                          \
+      }                                                                            \
+      break;                                                                       \
+    case OP_TYPE_REM:                                                              \
+      for (int32_t i = 0; i < numOfRows; ++i) {                                    \
+        double lx = (_lv), rx = (_rv);                                             \
+        if (VEC_MATH_REM_VALID(lx, rx)) {                                          \
+          output[i] = lx - ((int64_t)(lx / rx)) * rx;                              \
+        } else {                                                                   \
+          colDataSetNull_f(pOutputCol->nullbitmap, i);                             \
+          hasNull = true;                                                          \
+        }                                                                          \
+      }                                                                            \
+      break;                                                                       \
+    default:                                                                       \
+      break;                                                                       \
+  }
+
+#define VEC_MATH_COL_COL(_type) VEC_MATH_KERNEL((double)((const _type *)pl)[i], (double)((const _type *)pr)[i])
+#define VEC_MATH_COL_VAL(_type) VEC_MATH_KERNEL((double)((const _type *)pl)[i], rv)
+#define VEC_MATH_VAL_COL(_type) VEC_MATH_KERNEL(lv, (double)((const _type *)pr)[i])
+
+#define VEC_MATH_TYPE_SWITCH(_type, _KERNEL)                       \
+  switch (_type) {                                                 \
+    case TSDB_DATA_TYPE_TINYINT:   _KERNEL(int8_t);   break;       \
+    case TSDB_DATA_TYPE_SMALLINT:  _KERNEL(int16_t);  break;       \
+    case TSDB_DATA_TYPE_INT:       _KERNEL(int32_t);  break;       \
+    case TSDB_DATA_TYPE_BIGINT:                                    \
+    case TSDB_DATA_TYPE_TIMESTAMP: _KERNEL(int64_t);  break;       \
+    case TSDB_DATA_TYPE_UTINYINT:  _KERNEL(uint8_t);  break;       \
+    case TSDB_DATA_TYPE_USMALLINT: _KERNEL(uint16_t); break;       \
+    case TSDB_DATA_TYPE_UINT:      _KERNEL(uint32_t); break;       \
+    case TSDB_DATA_TYPE_UBIGINT:   _KERNEL(uint64_t); break;       \
+    case TSDB_DATA_TYPE_FLOAT:     _KERNEL(float);    break;       \
+    case TSDB_DATA_TYPE_DOUBLE:    _KERNEL(double);   break;       \
+    default: break;                                                \
+  }
+
+static FORCE_INLINE bool vectorMathKernelType(int32_t type) {
+  return IS_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_TIMESTAMP;
+}
+
+// the null bitmap of a column operand is merged into the one of the result a word at a time
+static void vectorMathMergeNull(SColumnInfoData* pOutputCol, const SColumnInfoData* pCol, int32_t numOfRows) {
+  if (!pCol->hasNull || pCol->nullbitmap == NULL) {
+    return;
+  }
+
+  int32_t len = BitmapLen(numOfRows);
+  int32_t i = 0;
+  for (; i + (int32_t)sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t w, o;
+    memcpy(&w, pCol->nullbitmap + i, sizeof(uint64_t));
+    memcpy(&o, pOutputCol->nullbitmap + i, sizeof(uint64_t));
+    o |= w;
+    memcpy(pOutputCol->nullbitmap + i, &o, sizeof(uint64_t));
+  }
+  for (; i < len; ++i) {
+    pOutputCol->nullbitmap[i] |= pCol->nullbitmap[i];
+  }
+
+  pOutputCol->hasNull = true;
+}
+
+/**
+ * @return false if the operands are not supported, and the generic loop is used
+ */
+static bool vectorMathKernel(SColumnInfoData* pLeftCol, SColumnInfoData* pRightCol, SColumnInfoData* pOutputCol,
+                             int32_t numOfLeftRows, int32_t numOfRightRows, int32_t _ord, int32_t optr) {
+  if (_ord != TSDB_ORDER_ASC || pLeftCol == NULL || pRightCol == NULL ||
+      pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE || !vectorMathKernelType(pLeftCol->info.type) ||
+      !vectorMathKernelType(pRightCol->info.type)) {
+    return false;
+  }
+
+  int32_t lType = pLeftCol->info.type;
+  int32_t rType = pRightCol->info.type;
+  double *output = (double *)pOutputCol->pData;
+  char   *pl = pLeftCol->pData;
+  char   *pr = pRightCol->pData;
+  int32_t numOfRows = TMAX(numOfLeftRows, numOfRightRows);
+  bool    hasNull = false;
+
+  if (numOfLeftRows == numOfRightRows && lType == rType) {
+    vectorMathMergeNull(pOutputCol, pLeftCol, numOfRows);
+    vectorMathMergeNull(pOutputCol, pRightCol, numOfRows);
+    VEC_MATH_TYPE_SWITCH(lType, VEC_MATH_COL_COL);
+  } else if (numOfRightRows == 1) {
+    if (colDataIsNull_s(pRightCol, 0)) {
+      colDataAppendNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+    double rv = getVectorDoubleValueFn(rType)(pr, 0);
+    vectorMathMergeNull(pOutputCol, pLeftCol, numOfRows);
+    VEC_MATH_TYPE_SWITCH(lType, VEC_MATH_COL_VAL);
+  } else if (numOfLeftRows == 1) {
+    if (colDataIsNull_s(pLeftCol, 0)) {
+      colDataAppendNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+    double lv = getVectorDoubleValueFn(lType)(pl, 0);
+    vectorMathMergeNull(pOutputCol, pRightCol, numOfRows);
+    VEC_MATH_TYPE_SWITCH(rType, VEC_MATH_VAL_COL);
+  } else {
+    return false;
+  }
+
+  if (hasNull) {
+    pOutputCol->hasNull = true;
+  }
+
+  return true;
+}
+
 void vectorMathAdd(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut, int32_t _ord) {
   SColumnInfoData *pOutputCol = pOut->columnData;
 
@@ -1137,7 +1274,7 @@ void vectorMathAdd(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) + getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     } 
-  } else {
+  } else if (!vectorMathKernel(pLeftCol, pRightCol, pOutputCol, pLeft->numOfRows, pRight->numOfRows, _ord, OP_TYPE_ADD)) {
     double *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1236,7 +1373,7 @@ void vectorMathSub(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) - getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathKernel(pLeftCol, pRightCol, pOutputCol, pLeft->numOfRows, pRight->numOfRows, _ord, OP_TYPE_SUB)) {
     double *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1291,6 +1428,12 @@ void vectorMathMultiply(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam
   SColumnInfoData *pLeftCol   = doVectorConvert(pLeft, &leftConvert);
   SColumnInfoData *pRightCol  = doVectorConvert(pRight, &rightConvert);
 
+  if (vectorMathKernel(pLeftCol, pRightCol, pOutputCol, pLeft->numOfRows, pRight->numOfRows, _ord, OP_TYPE_MULTI)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1324,6 +1467,12 @@ void vectorMathDivide(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *p
   SColumnInfoData *pLeftCol  = doVectorConvert(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = doVectorConvert(pRight, &rightConvert);
 
+  if (vectorMathKernel(pLeftCol, pRightCol, pOutputCol, pLeft->numOfRows, pRight->numOfRows, _ord, OP_TYPE_DIV)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1380,6 +1529,12 @@ void vectorMathRemainder(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam
   SColumnInfoData *pLeftCol  = doVectorConvert(pLeft, &leftConvert);
   SColumnInfoData *pRightCol = doVectorConvert(pRight, &rightConvert);
 
+  if (vectorMathKernel(pLeftCol, pRightCol, pOutputCol, pLeft->numOfRows, pRight->numOfRows, _ord, OP_TYPE_REM)) {
+    doReleaseVec(pLeftCol, leftConvert);
+    doReleaseVec(pRightCol, rightConvert);
+    return;
+  }
+
   _getDoubleValue_fn_t getVectorDoubleValueFnLeft  = getVectorDoubleValueFn(pLeftCol->info.type);
   _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
 
@@ -1678,6 +1833,49 @@ void vectorBitOr(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut,
     if(freeRight) taosMemoryFreeClear(pRightData);\
   }
 
+// operands of the same fixed length type are compared by the type specialized kernels of the filter, NULL is false
+static bool vectorCompareKernel(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut, int32_t _ord, int32_t optr) {
+  int32_t type = GET_PARAM_TYPE(pLeft);
+  if (_ord != TSDB_ORDER_ASC || type != GET_PARAM_TYPE(pRight) || pOut->columnData->info.bytes != sizeof(int8_t)) {
+    return false;
+  }
+
+  int8_t *res = (int8_t *)pOut->columnData->pData;
+  if (pLeft->numOfRows == pRight->numOfRows) {
+    return fltCompareColumns(optr, pLeft->columnData, pRight->columnData, pLeft->numOfRows, res);
+  }
+
+  SScalarParam *pCol = pLeft;
+  SScalarParam *pVal = pRight;
+  if (pLeft->numOfRows == 1) {
+    // c op x is evaluated as x op' c
+    pCol = pRight;
+    pVal = pLeft;
+    switch (optr) {
+      case OP_TYPE_GREATER_THAN:  optr = OP_TYPE_LOWER_THAN;    break;
+      case OP_TYPE_GREATER_EQUAL: optr = OP_TYPE_LOWER_EQUAL;   break;
+      case OP_TYPE_LOWER_THAN:    optr = OP_TYPE_GREATER_THAN;  break;
+      case OP_TYPE_LOWER_EQUAL:   optr = OP_TYPE_GREATER_EQUAL; break;
+      default: break;
+    }
+  } else if (pRight->numOfRows != 1) {
+    return false;
+  }
+
+  SFltKernel kernel;
+  if (!fltInitCompareKernel(type, optr, colDataGetData(pVal->columnData, 0), &kernel)) {
+    return false;
+  }
+
+  if (colDataIsNull_s(pVal->columnData, 0)) {
+    memset(res, 0, pCol->numOfRows);
+  } else {
+    fltExecKernel(&kernel, pCol->columnData, pCol->numOfRows, res);
+  }
+
+  return true;
+}
+
 void vectorCompareImpl(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *pOut, int32_t _ord, int32_t optr) {
   int32_t       i = ((_ord) == TSDB_ORDER_ASC) ? 0 : TMAX(pLeft->numOfRows, pRight->numOfRows) - 1;
   int32_t       step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
@@ -1708,6 +1906,10 @@ void vectorCompareImpl(SScalarParam* pLeft, SScalarParam* pRight, SScalarParam *
     return;
   }
 
+  if (vectorCompareKernel(pLeft, pRight, pOut, _ord, optr)) {
+    return;
+  }
+
   if (pLeft->numOfRows == pRight->numOfRows) {
     VEC_COM_INNER(pLeft, i, i)
   } else if (pRight->numOfRows == 1) {
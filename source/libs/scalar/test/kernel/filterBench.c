@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "filter.h"
+#include "filterInt.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "ttypes.h"
+
+typedef struct {
+  int32_t type;
+  char*   name;
+} SBenchType;
+
+static SBenchType benchTypes[] = {
+    {TSDB_DATA_TYPE_TINYINT, "tinyint"},     {TSDB_DATA_TYPE_SMALLINT, "smallint"},
+    {TSDB_DATA_TYPE_INT, "int"},             {TSDB_DATA_TYPE_BIGINT, "bigint"},
+    {TSDB_DATA_TYPE_TIMESTAMP, "timestamp"}, {TSDB_DATA_TYPE_UTINYINT, "utinyint"},
+    {TSDB_DATA_TYPE_USMALLINT, "usmallint"}, {TSDB_DATA_TYPE_UINT, "uint"},
+    {TSDB_DATA_TYPE_UBIGINT, "ubigint"},     {TSDB_DATA_TYPE_FLOAT, "float"},
+    {TSDB_DATA_TYPE_DOUBLE, "double"},
+};
+
+static int32_t inVals[] = {1, 2, 3, 5, 8, 13, 21, 34};
+
+static void setValue(char* p, int32_t type, int32_t v) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      *(int8_t*)p = (int8_t)v;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      *(int16_t*)p = (int16_t)v;
+      break;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      *(int32_t*)p = v;
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      *(int64_t*)p = v;
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      *(float*)p = (float)v;
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      *(double*)p = (double)v;
+      break;
+  }
+}
+
+static SSDataBlock* createBenchBlock(int32_t type, int32_t numOfRows, int32_t nullRatio) {
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData idata = createColumnInfoData(type, tDataTypes[type].bytes, 1);
+  blockDataAppendColInfo(pBlock, &idata);
+  blockDataEnsureCapacity(pBlock, numOfRows);
+
+  SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, 0);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (nullRatio > 0 && taosRand() % 100 < nullRatio) {
+      colDataAppendNULL(pCol, i);
+    } else {
+      char v[sizeof(int64_t)] = {0};
+      setValue(v, type, (int32_t)(taosRand() % 10000) - 5000);
+      colDataAppend(pCol, i, v, false);
+    }
+  }
+
+  pBlock->info.rows = numOfRows;
+  return pBlock;
+}
+
+static SNode* makeValue(int32_t type, int32_t v) {
+  SValueNode* pVal = (SValueNode*)nodesMakeNode(QUERY_NODE_VALUE);
+  char        buf[sizeof(int64_t)] = {0};
+  pVal->node.resType.type = type;
+  pVal->node.resType.bytes = tDataTypes[type].bytes;
+  setValue(buf, type, v);
+  nodesSetValueNodeValue(pVal, buf);
+  return (SNode*)pVal;
+}
+
+static SNode* makeOp(EOperatorType opType, int32_t type, SNode* pRight) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  pCol->dataBlockId = 0;
+  pCol->slotId = 0;
+  pCol->colId = 1;
+
+  SOperatorNode* pOp = (SOperatorNode*)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->opType = opType;
+  pOp->pLeft = (SNode*)pCol;
+  pOp->pRight = pRight;
+  return (SNode*)pOp;
+}
+
+// c > 0, c between -1000 and 1000, c = 7, c in (...)
+static SNode* makeCond(int32_t cond, int32_t type) {
+  switch (cond) {
+    case 0:
+      return makeOp(OP_TYPE_GREATER_THAN, type, makeValue(type, 0));
+    case 1: {
+      SLogicConditionNode* pLogic = (SLogicConditionNode*)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+      pLogic->condType = LOGIC_COND_TYPE_AND;
+      pLogic->node.resType.type = TSDB_DATA_TYPE_BOOL;
+      pLogic->node.resType.bytes = sizeof(bool);
+      pLogic->pParameterList = nodesMakeList();
+      nodesListAppend(pLogic->pParameterList, makeOp(OP_TYPE_GREATER_EQUAL, type, makeValue(type, -1000)));
+      nodesListAppend(pLogic->pParameterList, makeOp(OP_TYPE_LOWER_EQUAL, type, makeValue(type, 1000)));
+      return (SNode*)pLogic;
+    }
+    case 2:
+      return makeOp(OP_TYPE_EQUAL, type, makeValue(type, 7));
+    default: {
+      SNodeListNode* pList = (SNodeListNode*)nodesMakeNode(QUERY_NODE_NODE_LIST);
+      pList->dataType.type = type;
+      pList->pNodeList = nodesMakeList();
+      for (int32_t i = 0; i < tListLen(inVals); ++i) {
+        nodesListAppend(pList->pNodeList, makeValue(type, inVals[i]));
+      }
+      return makeOp(OP_TYPE_IN, type, (SNode*)pList);
+    }
+  }
+}
+
+// rows per microsecond of the filter, i.e. millions of rows per second
+static double runBench(SSDataBlock* pBlock, int32_t cond, int32_t type, bool kernel, int32_t loops,
+                       int64_t* pQualified) {
+  SNode*       pCond = makeCond(cond, type);
+  SFilterInfo* pFilter = NULL;
+  if (filterInitFromNode(pCond, &pFilter, 0) != TSDB_CODE_SUCCESS) {
+    printf("failed to init filter, type:%d, cond:%d\n", type, cond);
+    nodesDestroyNode(pCond);
+    return 0;
+  }
+
+  // the generic filter that runs when there is no kernel
+  if (!kernel && pFilter->func == filterExecuteImplKernel) {
+    pFilter->func = filterGetGenericExecFunc(pFilter);
+  }
+
+  SFilterColumnParam param = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
+  filterSetDataFromSlotId(pFilter, &param);
+
+  int64_t num = 0;
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; ++i) {
+    int8_t* p = NULL;
+    filterExecute(pFilter, pBlock, &p, NULL, param.numOfCols);
+    num += (p != NULL) ? p[i % pBlock->info.rows] : 0;
+    taosMemoryFree(p);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  *pQualified += num;
+  filterFreeInfo(pFilter);
+  nodesDestroyNode(pCond);
+  return (double)pBlock->info.rows * loops / TMAX(el, 1);
+}
+
+int main(int argc, char* argv[]) {
+  int32_t numOfRows = 4096;
+  int32_t loops = 20000;
+  int32_t nullRatio = 10;
+
+  for (int32_t i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      numOfRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      loops = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nullRatio = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-r rows]: rows of a block, default is:%d\n", numOfRows);
+      printf("  [-l loops]: times to filter a block, default is:%d\n", loops);
+      printf("  [-n ratio]: percentage of NULL rows, default is:%d\n", nullRatio);
+      exit(0);
+    }
+  }
+
+  taosSeedRand(taosGetTimestampSec());
+  printf("rows:%d loops:%d null ratio:%d%%, throughput in million rows/s\n", numOfRows, loops, nullRatio);
+  printf("%-10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "type", ">", ">-kernel", "between", "btw-kernel", "=",
+         "=-kernel", "in", "in-kernel");
+
+  int64_t qualified = 0;
+  for (int32_t t = 0; t < tListLen(benchTypes); ++t) {
+    SSDataBlock* pBlock = createBenchBlock(benchTypes[t].type, numOfRows, nullRatio);
+    double       res[8] = {0};
+
+    for (int32_t cond = 0; cond < 4; ++cond) {
+      res[cond * 2] = runBench(pBlock, cond, benchTypes[t].type, false, loops, &qualified);
+      res[cond * 2 + 1] = runBench(pBlock, cond, benchTypes[t].type, true, loops, &qualified);
+    }
+
+    // IN over float/double has no kernel, both columns run the generic filter
+    printf("%-10s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", benchTypes[t].name, res[0], res[1],
+           res[2], res[3], res[4], res[5], res[6], res[7]);
+    blockDataDestroy(pBlock);
+  }
+
+  // keep the results alive
+  if (qualified == -1) {
+    printf("\n");
+  }
+
+  return 0;
+}
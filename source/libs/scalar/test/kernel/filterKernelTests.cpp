@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "os.h"
+#include "filter.h"
+#include "filterInt.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+#include "ttypes.h"
+
+namespace {
+
+const int32_t kernelTypes[] = {
+    TSDB_DATA_TYPE_BOOL,     TSDB_DATA_TYPE_TINYINT,   TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+    TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT,
+    TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT,   TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE,
+};
+
+// a value of the given type, from iv for the integers and from dv for float/double
+struct SKernelValue {
+  int64_t iv;
+  double  dv;
+};
+
+void setValue(char *p, int32_t type, SKernelValue v) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      *(int8_t *)p = (int8_t)v.iv;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      *(int16_t *)p = (int16_t)v.iv;
+      break;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      *(int32_t *)p = (int32_t)v.iv;
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      *(int64_t *)p = v.iv;
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      *(float *)p = (float)v.dv;
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      *(double *)p = v.dv;
+      break;
+  }
+}
+
+// the largest value of an unsigned type, so that the values of the upper half can be built as umax - k
+int64_t umax(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_UTINYINT:
+      return UINT8_MAX;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return UINT16_MAX;
+    case TSDB_DATA_TYPE_UINT:
+      return UINT32_MAX;
+    default:
+      return (int64_t)UINT64_MAX;
+  }
+}
+
+// the constants of the conditions, the rows are built around them
+void getBounds(int32_t type, SKernelValue *lo, SKernelValue *hi) {
+  if (type == TSDB_DATA_TYPE_BOOL) {
+    *lo = {0, 0};
+    *hi = {1, 0};
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    // the signed view of both bounds is negative
+    *lo = {umax(type) - 40, 0};
+    *hi = {umax(type) - 10, 0};
+  } else {
+    *lo = {-10, -2.5};
+    *hi = {20, 3.0};
+  }
+}
+
+SKernelValue randomValue(int32_t type) {
+  int32_t k = taosRand() % 60;
+  if (type == TSDB_DATA_TYPE_BOOL) {
+    return {k & 1, 0};
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    // both the upper and the lower half of the range
+    return {(k % 2 == 0) ? umax(type) - k : k, 0};
+  } else if (IS_FLOAT_TYPE(type)) {
+    SKernelValue lo, hi;
+    getBounds(type, &lo, &hi);
+    switch (k % 6) {
+      case 0:
+        return {0, NAN};
+      case 1:
+        return {0, (k % 4 == 1) ? INFINITY : -INFINITY};
+      case 2:  // equal to a bound within the tolerance of the float compare
+        return {0, ((k % 4 == 2) ? lo.dv : hi.dv) + FLT_EPSILON};
+      case 3:  // out of the tolerance
+        return {0, ((k % 4 == 3) ? lo.dv : hi.dv) - 8 * FLT_EPSILON};
+      default:
+        return {0, (k - 30) / 4.0};
+    }
+  }
+
+  return {k - 30, 0};
+}
+
+SSDataBlock *createKernelBlock(int32_t type, int32_t numOfRows, int32_t nullRatio) {
+  SSDataBlock    *pBlock = createDataBlock();
+  SColumnInfoData idata = createColumnInfoData(type, tDataTypes[type].bytes, 1);
+  blockDataAppendColInfo(pBlock, &idata);
+  blockDataEnsureCapacity(pBlock, numOfRows);
+
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (nullRatio > 0 && taosRand() % 100 < nullRatio) {
+      colDataAppendNULL(pCol, i);
+    } else {
+      char v[sizeof(int64_t)] = {0};
+      setValue(v, type, randomValue(type));
+      colDataAppend(pCol, i, v, false);
+    }
+  }
+
+  pBlock->info.rows = numOfRows;
+  return pBlock;
+}
+
+SNode *makeValue(int32_t type, SKernelValue v) {
+  SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+  char        buf[sizeof(int64_t)] = {0};
+  pVal->node.resType.type = type;
+  pVal->node.resType.bytes = tDataTypes[type].bytes;
+  setValue(buf, type, v);
+  nodesSetValueNodeValue(pVal, buf);
+  return (SNode *)pVal;
+}
+
+SNode *makeOp(EOperatorType opType, int32_t type, SNode *pRight) {
+  SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  pCol->dataBlockId = 0;
+  pCol->slotId = 0;
+  pCol->colId = 1;
+
+  SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->opType = opType;
+  pOp->pLeft = (SNode *)pCol;
+  pOp->pRight = pRight;
+  return (SNode *)pOp;
+}
+
+SNode *makeAnd(SNode *pLeft, SNode *pRight) {
+  SLogicConditionNode *pLogic = (SLogicConditionNode *)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+  pLogic->condType = LOGIC_COND_TYPE_AND;
+  pLogic->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pLogic->node.resType.bytes = sizeof(bool);
+  pLogic->pParameterList = nodesMakeList();
+  nodesListAppend(pLogic->pParameterList, pLeft);
+  nodesListAppend(pLogic->pParameterList, pRight);
+  return (SNode *)pLogic;
+}
+
+const int32_t numOfConds = 10;
+
+// single operators, the four kinds of ranges, = and IN, <> always runs in the scalar mode
+SNode *makeCond(int32_t cond, int32_t type) {
+  SKernelValue lo, hi;
+  getBounds(type, &lo, &hi);
+
+  switch (cond) {
+    case 0:
+      return makeOp(OP_TYPE_GREATER_THAN, type, makeValue(type, lo));
+    case 1:
+      return makeOp(OP_TYPE_GREATER_EQUAL, type, makeValue(type, lo));
+    case 2:
+      return makeOp(OP_TYPE_LOWER_THAN, type, makeValue(type, hi));
+    case 3:
+      return makeOp(OP_TYPE_LOWER_EQUAL, type, makeValue(type, hi));
+    case 4:
+      return makeAnd(makeOp(OP_TYPE_GREATER_THAN, type, makeValue(type, lo)),
+                     makeOp(OP_TYPE_LOWER_THAN, type, makeValue(type, hi)));
+    case 5:
+      return makeAnd(makeOp(OP_TYPE_GREATER_THAN, type, makeValue(type, lo)),
+                     makeOp(OP_TYPE_LOWER_EQUAL, type, makeValue(type, hi)));
+    case 6:
+      return makeAnd(makeOp(OP_TYPE_GREATER_EQUAL, type, makeValue(type, lo)),
+                     makeOp(OP_TYPE_LOWER_THAN, type, makeValue(type, hi)));
+    case 7:
+      return makeAnd(makeOp(OP_TYPE_GREATER_EQUAL, type, makeValue(type, lo)),
+                     makeOp(OP_TYPE_LOWER_EQUAL, type, makeValue(type, hi)));
+    case 8:
+      return makeOp(OP_TYPE_EQUAL, type, makeValue(type, lo));
+    default: {
+      SNodeListNode *pList = (SNodeListNode *)nodesMakeNode(QUERY_NODE_NODE_LIST);
+      pList->dataType.type = type;
+      pList->pNodeList = nodesMakeList();
+      nodesListAppend(pList->pNodeList, makeValue(type, lo));
+      nodesListAppend(pList->pNodeList, makeValue(type, hi));
+      for (int32_t i = 0; i < 5; ++i) {
+        nodesListAppend(pList->pNodeList, makeValue(type, randomValue(type)));
+      }
+      return makeOp(OP_TYPE_IN, type, (SNode *)pList);
+    }
+  }
+}
+
+// the rows selected by the filter, with the kernel or with the generic filter that runs when there is no kernel
+bool doFilter(SSDataBlock *pBlock, SNode *pCond, bool kernel, std::vector<int8_t> &res) {
+  SFilterInfo *pFilter = NULL;
+  EXPECT_EQ(filterInitFromNode(pCond, &pFilter, 0), TSDB_CODE_SUCCESS);
+  if (pFilter == NULL) {
+    return false;
+  }
+
+  if (!kernel && pFilter->func == filterExecuteImplKernel) {
+    pFilter->func = filterGetGenericExecFunc(pFilter);
+  }
+
+  SFilterColumnParam param = {.numOfCols = (int32_t)taosArrayGetSize(pBlock->pDataBlock),
+                              .pDataBlock = pBlock->pDataBlock};
+  filterSetDataFromSlotId(pFilter, &param);
+
+  int8_t *p = NULL;
+  bool    all = filterExecute(pFilter, pBlock, &p, NULL, param.numOfCols);
+  res.assign(pBlock->info.rows, 1);
+  if (p != NULL) {
+    res.assign(p, p + pBlock->info.rows);
+  }
+
+  taosMemoryFree(p);
+  filterFreeInfo(pFilter);
+  return all;
+}
+
+bool hasKernel(SNode *pCond) {
+  SFilterInfo *pFilter = NULL;
+  EXPECT_EQ(filterInitFromNode(pCond, &pFilter, 0), TSDB_CODE_SUCCESS);
+  bool kernel = (pFilter != NULL && pFilter->func == filterExecuteImplKernel);
+  filterFreeInfo(pFilter);
+  return kernel;
+}
+
+void checkKernels(int32_t numOfRows, int32_t nullRatio) {
+  for (int32_t t = 0; t < tListLen(kernelTypes); ++t) {
+    int32_t      type = kernelTypes[t];
+    SSDataBlock *pBlock = createKernelBlock(type, numOfRows, nullRatio);
+
+    for (int32_t cond = 0; cond < numOfConds; ++cond) {
+      // bool is only compared with a single value, a range of it is either empty or a single value
+      if (type == TSDB_DATA_TYPE_BOOL && (cond >= 4 && cond <= 7 || cond == numOfConds - 1)) {
+        continue;
+      }
+
+      SCOPED_TRACE(testing::Message() << "type:" << type << " cond:" << cond << " nullRatio:" << nullRatio);
+      SNode *pCond = makeCond(cond, type);
+
+      // IN over float/double has no kernel, the set does not use the bitwise equality
+      bool inFloat = (cond == numOfConds - 1 && IS_FLOAT_TYPE(type));
+      EXPECT_EQ(hasKernel(pCond), !inFloat);
+
+      std::vector<int8_t> generic, kernel;
+      bool                allGeneric = doFilter(pBlock, pCond, false, generic);
+      bool                allKernel = doFilter(pBlock, pCond, true, kernel);
+
+      EXPECT_EQ(allKernel, allGeneric);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        ASSERT_EQ(kernel[i], generic[i]) << "row:" << i;
+      }
+
+      nodesDestroyNode(pCond);
+    }
+
+    blockDataDestroy(pBlock);
+  }
+}
+
+}  // namespace
+
+class FilterKernelTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { taosSeedRand(taosGetTimestampSec()); }
+};
+
+TEST_F(FilterKernelTest, noNull) { checkKernels(1037, 0); }
+
+TEST_F(FilterKernelTest, withNull) { checkKernels(1037, 20); }
+
+TEST_F(FilterKernelTest, allNull) { checkKernels(133, 100); }
+
+// a block of which every row is selected is reported as such by both filters
+TEST_F(FilterKernelTest, allQualified) {
+  SKernelValue v = {5, 5.0};
+
+  SSDataBlock    *pBlock = createDataBlock();
+  SColumnInfoData idata = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(pBlock, &idata);
+  blockDataEnsureCapacity(pBlock, 100);
+
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  for (int32_t i = 0; i < 100; ++i) {
+    char buf[sizeof(int64_t)] = {0};
+    setValue(buf, TSDB_DATA_TYPE_INT, v);
+    colDataAppend(pCol, i, buf, false);
+  }
+  pBlock->info.rows = 100;
+
+  SNode *pCond = makeOp(OP_TYPE_EQUAL, TSDB_DATA_TYPE_INT, makeValue(TSDB_DATA_TYPE_INT, v));
+
+  std::vector<int8_t> generic, kernel;
+  EXPECT_TRUE(doFilter(pBlock, pCond, false, generic));
+  EXPECT_TRUE(doFilter(pBlock, pCond, true, kernel));
+
+  // one NULL row is not selected
+  colDataAppendNULL(pCol, 37);
+  EXPECT_FALSE(doFilter(pBlock, pCond, false, generic));
+  EXPECT_FALSE(doFilter(pBlock, pCond, true, kernel));
+  EXPECT_EQ(kernel, generic);
+  EXPECT_EQ(kernel[37], 0);
+
+  nodesDestroyNode(pCond);
+  blockDataDestroy(pBlock);
+}
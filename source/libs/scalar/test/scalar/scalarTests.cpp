@@ -43,6 +43,8 @@
 #include "tlog.h"
 #include "parUtil.h"
 #include "filterInt.h"
+#include "sclvector.h"
+#include "tcompare.h"
 
 #define _DEBUG_PRINT_ 0
 
@@ -3639,6 +3641,224 @@ TEST(ScalarFunctionTest, powFunction_column) {
  taosMemoryFree(pInput);
 }
 
+#define SCLT_VECTOR_ROWS 133
+
+void scltSetVectorValue(char *p, int32_t type, int32_t row) {
+ int32_t k = row % 11;
+ int64_t iv = (k == 3) ? 0 : (row * 7 % 23) - 11;
+ uint64_t uv = (k == 3) ? 0 : ((row % 2) ? UINT64_MAX - row % 13 : row % 13);
+ double dv = (row % 23 - 11) / 4.0;
+ switch (k) {
+   case 0: dv = NAN; break;
+   case 1: dv = INFINITY; break;
+   case 2: dv = -INFINITY; break;
+   case 3: dv = 0; break;
+   case 4: dv = 0.5 + FLT_EPSILON; break;
+   default: break;
+ }
+
+ switch (type) {
+   case TSDB_DATA_TYPE_TINYINT: *(int8_t *)p = (int8_t)iv; break;
+   case TSDB_DATA_TYPE_SMALLINT: *(int16_t *)p = (int16_t)iv; break;
+   case TSDB_DATA_TYPE_INT: *(int32_t *)p = (int32_t)iv; break;
+   case TSDB_DATA_TYPE_BIGINT: *(int64_t *)p = iv * 1000000007LL; break;
+   case TSDB_DATA_TYPE_UTINYINT: *(uint8_t *)p = (uint8_t)uv; break;
+   case TSDB_DATA_TYPE_UINT: *(uint32_t *)p = (uint32_t)uv; break;
+   case TSDB_DATA_TYPE_UBIGINT: *(uint64_t *)p = uv; break;
+   case TSDB_DATA_TYPE_FLOAT: *(float *)p = (float)dv; break;
+   case TSDB_DATA_TYPE_DOUBLE: *(double *)p = dv; break;
+   default: break;
+ }
+}
+
+double scltGetVectorValue(const char *p, int32_t type) {
+ switch (type) {
+   case TSDB_DATA_TYPE_TINYINT: return *(int8_t *)p;
+   case TSDB_DATA_TYPE_SMALLINT: return *(int16_t *)p;
+   case TSDB_DATA_TYPE_INT: return *(int32_t *)p;
+   case TSDB_DATA_TYPE_BIGINT: return (double)*(int64_t *)p;
+   case TSDB_DATA_TYPE_UTINYINT: return *(uint8_t *)p;
+   case TSDB_DATA_TYPE_UINT: return *(uint32_t *)p;
+   case TSDB_DATA_TYPE_UBIGINT: return (double)*(uint64_t *)p;
+   case TSDB_DATA_TYPE_FLOAT: return *(float *)p;
+   case TSDB_DATA_TYPE_DOUBLE: return *(double *)p;
+   default: return 0;
+ }
+}
+
+// a column of num rows taking the values of the rows from start on, every nullStep-th row is NULL, 0 for none
+void scltMakeVectorParam(SScalarParam *param, int32_t type, int32_t num, int32_t start, int32_t nullStep) {
+ param->columnData = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
+ param->numOfRows = num;
+ param->columnData->info = createColumnInfo(0, type, tDataTypes[type].bytes);
+ colInfoDataEnsureCapacity(param->columnData, num);
+
+ char buf[sizeof(int64_t)] = {0};
+ for (int32_t i = 0; i < num; ++i) {
+   if (nullStep > 0 && (start + i) % nullStep == 0) {
+     colDataAppendNULL(param->columnData, i);
+     continue;
+   }
+   scltSetVectorValue(buf, type, start + i);
+   colDataAppend(param->columnData, i, buf, false);
+ }
+}
+
+void scltDestroyVectorParam(SScalarParam *param) {
+ colDataDestroy(param->columnData);
+ taosMemoryFreeClear(param->columnData);
+}
+
+bool scltDoubleEqual(double a, double b) {
+ return (isnan(a) && isnan(b)) || a == b;
+}
+
+void scltCheckMathKernel(int32_t type, int32_t optr, SScalarParam *pLeft, SScalarParam *pRight) {
+ int32_t rows = TMAX(pLeft->numOfRows, pRight->numOfRows);
+ SScalarParam out = {0};
+ out.columnData = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
+ out.columnData->info = createColumnInfo(0, TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+ colInfoDataEnsureCapacity(out.columnData, rows);
+
+ getBinScalarOperatorFn(optr)(pLeft, pRight, &out, TSDB_ORDER_ASC);
+
+ for (int32_t i = 0; i < rows; ++i) {
+   int32_t li = (pLeft->numOfRows == 1) ? 0 : i;
+   int32_t ri = (pRight->numOfRows == 1) ? 0 : i;
+   bool    isNull = colDataIsNull_s(pLeft->columnData, li) || colDataIsNull_s(pRight->columnData, ri);
+   double  expect = 0;
+   if (!isNull) {
+     double lx = scltGetVectorValue(colDataGetData(pLeft->columnData, li), type);
+     double rx = scltGetVectorValue(colDataGetData(pRight->columnData, ri), type);
+     switch (optr) {
+       case OP_TYPE_ADD: expect = lx + rx; break;
+       case OP_TYPE_SUB: expect = lx - rx; break;
+       case OP_TYPE_MULTI: expect = lx * rx; break;
+       case OP_TYPE_DIV:
+         isNull = (rx == 0);
+         expect = lx / rx;
+         break;
+       case OP_TYPE_REM:
+         isNull = !isfinite(lx) || !isfinite(rx) || FLT_EQUAL(rx, 0);
+         expect = lx - ((int64_t)(lx / rx)) * rx;
+         break;
+       default: break;
+     }
+   }
+
+   ASSERT_EQ(colDataIsNull_s(out.columnData, i), isNull) << "type:" << type << " optr:" << optr << " row:" << i;
+   if (!isNull) {
+     ASSERT_TRUE(scltDoubleEqual(*(double *)colDataGetData(out.columnData, i), expect))
+         << "type:" << type << " optr:" << optr << " row:" << i;
+   }
+ }
+
+ scltDestroyVectorParam(&out);
+}
+
+void scltCheckCompareKernel(int32_t type, int32_t optr, SScalarParam *pLeft, SScalarParam *pRight) {
+ int32_t rows = TMAX(pLeft->numOfRows, pRight->numOfRows);
+ SScalarParam out = {0};
+ out.columnData = (SColumnInfoData *)taosMemoryCalloc(1, sizeof(SColumnInfoData));
+ out.columnData->info = createColumnInfo(0, TSDB_DATA_TYPE_BOOL, sizeof(bool));
+ colInfoDataEnsureCapacity(out.columnData, rows);
+
+ getBinScalarOperatorFn(optr)(pLeft, pRight, &out, TSDB_ORDER_ASC);
+
+ // the operands keep their sides, so a constant on the left checks the swapped operator of the kernel
+ __compar_fn_t fp = filterGetCompFunc(type, optr);
+ for (int32_t i = 0; i < rows; ++i) {
+   int32_t li = (pLeft->numOfRows == 1) ? 0 : i;
+   int32_t ri = (pRight->numOfRows == 1) ? 0 : i;
+   bool    expect = false;
+   if (!colDataIsNull_s(pLeft->columnData, li) && !colDataIsNull_s(pRight->columnData, ri)) {
+     expect = filterDoCompare(fp, optr, colDataGetData(pLeft->columnData, li), colDataGetData(pRight->columnData, ri));
+   }
+
+   ASSERT_EQ(*(int8_t *)colDataGetData(out.columnData, i), (int8_t)expect)
+       << "type:" << type << " optr:" << optr << " row:" << i;
+ }
+
+ scltDestroyVectorParam(&out);
+}
+
+static const int32_t scltVectorTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+                                          TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_UINT,
+                                          TSDB_DATA_TYPE_UBIGINT,  TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE};
+
+// rows of the constants: a non zero value, zero, nan and inf, the last two are plain values for the integer types
+static const int32_t scltVectorConstRows[] = {5, 3, 11, 12};
+
+void scltCheckVectorKernel(bool math, int32_t optr) {
+ for (int32_t t = 0; t < (int32_t)(sizeof(scltVectorTypes) / sizeof(scltVectorTypes[0])); ++t) {
+   int32_t type = scltVectorTypes[t];
+   SScalarParam left = {0}, right = {0};
+   scltMakeVectorParam(&left, type, SCLT_VECTOR_ROWS, 0, 5);
+   scltMakeVectorParam(&right, type, SCLT_VECTOR_ROWS, 40, 7);
+
+   if (math) {
+     scltCheckMathKernel(type, optr, &left, &right);
+   } else {
+     scltCheckCompareKernel(type, optr, &left, &right);
+   }
+
+   for (int32_t c = 0; c < (int32_t)(sizeof(scltVectorConstRows) / sizeof(scltVectorConstRows[0])); ++c) {
+     SScalarParam val = {0};
+     scltMakeVectorParam(&val, type, 1, scltVectorConstRows[c], 0);
+     if (math) {
+       scltCheckMathKernel(type, optr, &left, &val);
+       scltCheckMathKernel(type, optr, &val, &right);
+     } else {
+       scltCheckCompareKernel(type, optr, &left, &val);
+       scltCheckCompareKernel(type, optr, &val, &right);
+     }
+     scltDestroyVectorParam(&val);
+   }
+
+   SScalarParam nullVal = {0};
+   scltMakeVectorParam(&nullVal, type, 1, 0, 1);
+   if (math) {
+     scltCheckMathKernel(type, optr, &left, &nullVal);
+     scltCheckMathKernel(type, optr, &nullVal, &right);
+   } else {
+     scltCheckCompareKernel(type, optr, &left, &nullVal);
+     scltCheckCompareKernel(type, optr, &nullVal, &right);
+   }
+   scltDestroyVectorParam(&nullVal);
+
+   scltDestroyVectorParam(&left);
+   scltDestroyVectorParam(&right);
+ }
+}
+
+TEST(vectorKernelTest, math_add) {
+ scltCheckVectorKernel(true, OP_TYPE_ADD);
+}
+
+TEST(vectorKernelTest, math_sub) {
+ scltCheckVectorKernel(true, OP_TYPE_SUB);
+}
+
+TEST(vectorKernelTest, math_multi) {
+ scltCheckVectorKernel(true, OP_TYPE_MULTI);
+}
+
+TEST(vectorKernelTest, math_div_by_zero) {
+ scltCheckVectorKernel(true, OP_TYPE_DIV);
+}
+
+TEST(vectorKernelTest, math_rem_nan_inf) {
+ scltCheckVectorKernel(true, OP_TYPE_REM);
+}
+
+TEST(vectorKernelTest, compare_swapped_operator) {
+ int32_t optrs[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_THAN,
+                    OP_TYPE_LOWER_EQUAL,  OP_TYPE_EQUAL,         OP_TYPE_NOT_EQUAL};
+ for (int32_t i = 0; i < (int32_t)(sizeof(optrs) / sizeof(optrs[0])); ++i) {
+   scltCheckVectorKernel(false, optrs[i]);
+ }
+}
+
 int main(int argc, char** argv) {
  taosSeedRand(taosGetTimestampSec());
  testing::InitGoogleTest(&argc, argv);
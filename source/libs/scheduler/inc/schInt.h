@@ -237,6 +237,8 @@ typedef struct SSchJobAttr {
   bool         queryJob;
   bool         needFetch;
   bool         needFlowCtrl;
+  bool         linearizable;
+  int32_t      maxStaleMs;
 } SSchJobAttr;
 
 typedef struct {
@@ -719,6 +719,8 @@ int32_t schInitJob(int64_t *pJobId, SSchedulerReq *pReq) {
   }
 
   pJob->attr.explainMode = pReq->pDag->explainInfo.mode;
+  pJob->attr.linearizable = pReq->linearizable;
+  pJob->attr.maxStaleMs = pReq->linearizable ? 0 : pReq->maxStaleMs;
   pJob->conn = *pReq->pConn;
   if (pReq->sql) {
     pJob->sql = strdup(pReq->sql);
@@ -1016,8 +1016,9 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
     case TDMT_SCH_MERGE_QUERY: {
       SCH_ERR_RET(schMakeQueryRpcCtx(pJob, pTask, &rpcCtx));
 
-      uint32_t len = strlen(pJob->sql);
-      msgSize = sizeof(SSubQueryMsg) + pTask->msgLen + len;
+      uint32_t        len = strlen(pJob->sql);
+      SSubQueryMsgExt ext = {.linearizable = pJob->attr.linearizable, .maxStaleMs = pJob->attr.maxStaleMs};
+      msgSize = sizeof(SSubQueryMsg) + pTask->msgLen + len + tPutSubQueryMsgExt(NULL, &ext);
       msg = taosMemoryCalloc(1, msgSize);
       if (NULL == msg) {
         SCH_TASK_ELOG("calloc %d failed", msgSize);
@@ -1039,6 +1040,7 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
 
       memcpy(pMsg->msg, pJob->sql, len);
       memcpy(pMsg->msg + len, pTask->msg, pTask->msgLen);
+      tPutSubQueryMsgExt((uint8_t *)pMsg->msg + len + pTask->msgLen, &ext);
 
       persistHandle = true;
       SCH_SET_TASK_HANDLE(pTask, rpcAllocHandle());
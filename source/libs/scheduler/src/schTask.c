@@ -671,6 +671,16 @@ int32_t schSetTaskCandidateAddrs(SSchJob *pJob, SSchTask *pTask) {
 
     SCH_TASK_DLOG("use execNode in plan as candidate addr, numOfEps:%d", pTask->plan->execNode.epSet.numOfEps);
 
+    // spread stale reads over replicas, redirected to leader if the replica is too stale
+    if (SCH_IS_DATA_BIND_TASK(pTask) && pJob->attr.maxStaleMs > 0) {
+      SQueryNodeAddr *addr = taosArrayGet(pTask->candidateAddrs, 0);
+      if (addr->epSet.numOfEps > 1) {
+        addr->epSet.inUse = taosRand() % addr->epSet.numOfEps;
+        SCH_TASK_DLOG("stale read on replica, inUse:%d/%d, fqdn:%s, port:%d", addr->epSet.inUse,
+                      addr->epSet.numOfEps, SCH_GET_CUR_EP(addr)->fqdn, SCH_GET_CUR_EP(addr)->port);
+      }
+    }
+
     return TSDB_CODE_SUCCESS;
   }
 
@@ -35,6 +35,7 @@ extern "C" {
 #define ELECT_TIMER_MS_MAX   (ELECT_TIMER_MS_MIN * 2)
 #define ELECT_TIMER_MS_RANGE (ELECT_TIMER_MS_MAX - ELECT_TIMER_MS_MIN)
 #define HEARTBEAT_TIMER_MS   900
+#define LEASE_DRIFT_PCT      10  // clock drift allowance, percent of the election timeout
 
 #define EMPTY_RAFT_ID ((SRaftId){.addr = 0, .vgId = 0})
 
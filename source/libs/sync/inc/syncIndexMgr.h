@@ -34,6 +34,7 @@ typedef struct SSyncIndexMgr {
 
   int64_t startTimeArr[TSDB_MAX_REPLICA];
   int64_t recvTimeArr[TSDB_MAX_REPLICA];
+  int64_t leaseAckArr[TSDB_MAX_REPLICA];  // leader send time (monotonic) of the latest acked append entries
 
   int32_t    replicaNum;
   SSyncNode *pSyncNode;
@@ -52,6 +53,8 @@ void    syncIndexMgrSetStartTime(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pR
 int64_t syncIndexMgrGetStartTime(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId);
 void    syncIndexMgrSetRecvTime(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId, int64_t recvTime);
 int64_t syncIndexMgrGetRecvTime(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId);
+void    syncIndexMgrSetLeaseAck(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId, int64_t leaseStartMs);
+void    syncIndexMgrClearLeaseAck(SSyncIndexMgr *pSyncIndexMgr);
 
 // void     syncIndexMgrSetTerm(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId, SyncTerm term);
 // SyncTerm syncIndexMgrGetTerm(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId);
@@ -166,6 +166,13 @@ typedef struct SSyncNode {
   int64_t leaderTime;
   int64_t lastReplicateTime;
 
+  // leader lease
+  bool     leaseRevoked;      // leader: leader transfer proposed, no lease read in this term
+  int64_t  leaderContactMs;   // follower: last time heard from the leader of current term
+  int64_t  openMs;            // follower: monotonic time opened, a restarted node may be inside an unseen lease
+  SRaftId  transferTargetId;  // follower: candidate not held back by the lease
+  SyncTerm transferTerm;
+
 } SSyncNode;
 
 // open/close --------------
@@ -271,6 +278,13 @@ int32_t syncDoLeaderTransfer(SSyncNode* ths, SRpcMsg* pRpcMsg, SSyncRaftEntry* p
 
 int32_t syncNodeDynamicQuorum(const SSyncNode* pSyncNode);
 
+// leader lease
+int64_t syncNodeLeaseMs(const SSyncNode* pSyncNode);
+bool    syncNodeLeaseValid(SSyncNode* pSyncNode);
+void    syncNodeLeaseAck(SSyncNode* pSyncNode, const SRaftId* pRaftId, int64_t leaseStartMs);
+bool    syncNodeLeaseHoldVote(SSyncNode* pSyncNode, const SRaftId* pCandidateId);
+bool    syncNodeIsReadyForStaleRead(SSyncNode* pSyncNode, int32_t maxStaleMs, SyncIndex* pReadIndex);
+
 // trace log
 void syncLogSendRequestVote(SSyncNode* pSyncNode, const SyncRequestVote* pMsg, const char* s);
 void syncLogRecvRequestVote(SSyncNode* pSyncNode, const SyncRequestVote* pMsg, const char* s);
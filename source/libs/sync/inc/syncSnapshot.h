@@ -35,23 +35,42 @@ extern "C" {
 
 #define SYNC_SNAPSHOT_RETRY_MS 5000
 
+// max number of data blocks sent but not yet acked
+#define SYNC_SNAPSHOT_WINDOW_SIZE 8
+// blocks smaller than this are sent uncompressed
+#define SYNC_SNAPSHOT_CMPR_MIN_SIZE 1024
+
 //---------------------------------------------------
+typedef struct SSyncSnapshotBlock {
+  int32_t  seq;
+  uint32_t rawLen;  // 0 if pData is not compressed
+  uint32_t dataLen;
+  void    *pData;
+} SSyncSnapshotBlock;
+
 typedef struct SSyncSnapshotSender {
-  bool           start;
-  int32_t        seq;
-  int32_t        ack;
-  void          *pReader;
-  void          *pCurrentBlock;
-  int32_t        blockLen;
-  SSnapshotParam snapshotParam;
-  SSnapshot      snapshot;
-  SSyncCfg       lastConfig;
-  int64_t        sendingMS;
-  SSyncNode     *pSyncNode;
-  int32_t        replicaIndex;
-  SyncTerm       term;
-  SyncTerm       privateTerm;
-  bool           finish;
+  bool               start;
+  int32_t            seq;  // last seq sent
+  int32_t            ack;
+  void              *pReader;
+  void              *pCurrentBlock;
+  int32_t            blockLen;
+  bool               readFinish;
+  SSyncSnapshotBlock aBlock[SYNC_SNAPSHOT_WINDOW_SIZE];  // in flight blocks, indexed by seq
+  SSnapshotParam     snapshotParam;
+  SSnapshot          snapshot;
+  SSyncCfg           lastConfig;
+  int64_t            sendingMS;
+  int64_t            lastResendMS;
+  SSyncNode         *pSyncNode;
+  int32_t            replicaIndex;
+  SyncTerm           term;
+  SyncTerm           privateTerm;
+  bool               finish;
+  // progress
+  int64_t            startMS;
+  int64_t            rawBytes;
+  int64_t            wireBytes;
 } SSyncSnapshotSender;
 
 SSyncSnapshotSender *snapshotSenderCreate(SSyncNode *pSyncNode, int32_t replicaIndex);
@@ -78,7 +97,10 @@ typedef struct SSyncSnapshotReceiver {
   SSnapshot      snapshot;
   SRaftId        fromId;
   SSyncNode     *pSyncNode;
-
+  // progress
+  int64_t        startMS;
+  int64_t        rawBytes;
+  int64_t        wireBytes;
 } SSyncSnapshotReceiver;
 
 SSyncSnapshotReceiver *snapshotReceiverCreate(SSyncNode *pSyncNode, SRaftId fromId);
@@ -107,6 +107,7 @@ int32_t syncNodeOnAppendEntriesCb(SSyncNode* ths, SyncAppendEntries* pMsg) {
   // reset elect timer
   if (pMsg->term == ths->pRaftStore->currentTerm) {
     ths->leaderCache = pMsg->srcId;
+    ths->leaderContactMs = taosGetMonotonicMs();
     syncNodeResetElectTimer(ths);
   }
   ASSERT(pMsg->dataLen >= 0);
@@ -149,6 +150,7 @@ int32_t syncNodeOnAppendEntriesCb(SSyncNode* ths, SyncAppendEntries* pMsg) {
     pReply->success = false;
     pReply->matchIndex = SYNC_INDEX_INVALID;
     pReply->startTime = ths->startTime;
+    pReply->leaseStartMs = syncAppendEntriesLeaseStart(pMsg);
 
     // msg event log
     syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -292,6 +294,7 @@ int32_t syncNodeOnAppendEntriesCb(SSyncNode* ths, SyncAppendEntries* pMsg) {
     }
 
     pReply->startTime = ths->startTime;
+    pReply->leaseStartMs = syncAppendEntriesLeaseStart(pMsg);
 
     // msg event log
     syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -523,6 +526,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
   // reset elect timer
   if (pMsg->term == ths->pRaftStore->currentTerm) {
     ths->leaderCache = pMsg->srcId;
+    ths->leaderContactMs = taosGetMonotonicMs();
     syncNodeResetElectTimer(ths);
   }
   ASSERT(pMsg->dataLen >= 0);
@@ -607,6 +611,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->success = true;
       pReply->matchIndex = matchIndex;
       pReply->startTime = ths->startTime;
+      pReply->leaseStartMs = syncAppendEntriesBatchLeaseStart(pMsg);
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -656,6 +661,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->success = false;
       pReply->matchIndex = ths->commitIndex;
       pReply->startTime = ths->startTime;
+      pReply->leaseStartMs = syncAppendEntriesBatchLeaseStart(pMsg);
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -735,6 +741,7 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->success = true;
       pReply->matchIndex = hasAppendEntries ? pMsg->prevLogIndex + pMsg->dataCount : pMsg->prevLogIndex;
       pReply->startTime = ths->startTime;
+      pReply->leaseStartMs = syncAppendEntriesBatchLeaseStart(pMsg);
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -806,6 +813,7 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
   // reset elect timer
   if (pMsg->term == ths->pRaftStore->currentTerm) {
     ths->leaderCache = pMsg->srcId;
+    ths->leaderContactMs = taosGetMonotonicMs();
     syncNodeResetElectTimer(ths);
   }
   ASSERT(pMsg->dataLen >= 0);
@@ -881,6 +889,7 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
       pReply->success = true;
       pReply->matchIndex = matchIndex;
       pReply->startTime = ths->startTime;
+      pReply->leaseStartMs = syncAppendEntriesLeaseStart(pMsg);
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -927,6 +936,7 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
       pReply->success = false;
       pReply->matchIndex = SYNC_INDEX_INVALID;
       pReply->startTime = ths->startTime;
+      pReply->leaseStartMs = syncAppendEntriesLeaseStart(pMsg);
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
@@ -993,6 +1003,7 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
       pReply->success = true;
       pReply->matchIndex = hasAppendEntries ? pMsg->prevLogIndex + 1 : pMsg->prevLogIndex;
       pReply->startTime = ths->startTime;
+      pReply->leaseStartMs = syncAppendEntriesLeaseStart(pMsg);
 
       // msg event log
       syncLogSendAppendEntriesReply(ths, pReply, "");
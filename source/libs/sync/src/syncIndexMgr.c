@@ -52,6 +52,7 @@ void syncIndexMgrClear(SSyncIndexMgr *pSyncIndexMgr) {
   for (int i = 0; i < pSyncIndexMgr->replicaNum; ++i) {
     pSyncIndexMgr->startTimeArr[i] = 0;
     pSyncIndexMgr->recvTimeArr[i] = 0;
+    pSyncIndexMgr->leaseAckArr[i] = 0;
   }
 
   /*
@@ -194,6 +195,29 @@ int64_t syncIndexMgrGetRecvTime(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRa
   return -1;
 }
 
+void syncIndexMgrSetLeaseAck(SSyncIndexMgr *pSyncIndexMgr, const SRaftId *pRaftId, int64_t leaseStartMs) {
+  for (int i = 0; i < pSyncIndexMgr->replicaNum; ++i) {
+    if (syncUtilSameId(&((*(pSyncIndexMgr->replicas))[i]), pRaftId)) {
+      // replies may arrive out of order, keep the latest one
+      if (leaseStartMs > (pSyncIndexMgr->leaseAckArr)[i]) {
+        (pSyncIndexMgr->leaseAckArr)[i] = leaseStartMs;
+      }
+      return;
+    }
+  }
+
+  // maybe config change
+  char     host[128];
+  uint16_t port;
+  syncUtilU642Addr(pRaftId->addr, host, sizeof(host), &port);
+  sError("vgId:%d, index mgr set for %s:%d, lease-ack:%" PRId64 " error", pSyncIndexMgr->pSyncNode->vgId, host, port,
+         leaseStartMs);
+}
+
+void syncIndexMgrClearLeaseAck(SSyncIndexMgr *pSyncIndexMgr) {
+  memset(pSyncIndexMgr->leaseAckArr, 0, sizeof(pSyncIndexMgr->leaseAckArr));
+}
+
 // for debug -------------------
 void syncIndexMgrPrint(SSyncIndexMgr *pObj) {
   char *serialized = syncIndexMgr2Str(pObj);
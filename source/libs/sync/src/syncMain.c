@@ -310,6 +310,9 @@ int32_t syncNodeLeaderTransferTo(SSyncNode* pSyncNode, SNodeInfo newLeader) {
     syncNodeEventLog(pSyncNode, logBuf);
   } while (0);
 
+  // the new leader may be elected before the lease expires, stop lease read from now on
+  pSyncNode->leaseRevoked = true;
+
   SyncLeaderTransfer* pMsg = syncLeaderTransferBuild(pSyncNode->vgId);
   pMsg->newLeaderId.addr = syncUtilAddr2U64(newLeader.nodeFqdn, newLeader.nodePort);
   pMsg->newLeaderId.vgId = pSyncNode->vgId;
@@ -415,6 +418,61 @@ bool syncIsReadyForRead(int64_t rid) {
   return b;
 }
 
+bool syncIsReadyForLeaseRead(int64_t rid, SyncIndex* pReadIndex) {
+  SSyncNode* pSyncNode = (SSyncNode*)taosAcquireRef(tsNodeRefId, rid);
+  if (pSyncNode == NULL) {
+    terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
+    return false;
+  }
+  ASSERT(rid == pSyncNode->rid);
+
+  bool b = false;
+  if (pSyncNode->state != TAOS_SYNC_STATE_LEADER) {
+    terrno = TSDB_CODE_SYN_NOT_LEADER;
+  } else if (!syncNodeLeaseValid(pSyncNode)) {
+    terrno = TSDB_CODE_APP_NOT_READY;
+  } else {
+    // nothing newer than commit index can have been acknowledged to any client
+    *pReadIndex = pSyncNode->commitIndex;
+    b = true;
+  }
+
+  taosReleaseRef(tsNodeRefId, pSyncNode->rid);
+  return b;
+}
+
+bool syncIsReadyForStaleRead(int64_t rid, int32_t maxStaleMs, SyncIndex* pReadIndex) {
+  SSyncNode* pSyncNode = (SSyncNode*)taosAcquireRef(tsNodeRefId, rid);
+  if (pSyncNode == NULL) {
+    terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
+    return false;
+  }
+  ASSERT(rid == pSyncNode->rid);
+
+  bool b = syncNodeIsReadyForStaleRead(pSyncNode, maxStaleMs, pReadIndex);
+
+  taosReleaseRef(tsNodeRefId, pSyncNode->rid);
+  return b;
+}
+
+bool syncNodeIsReadyForStaleRead(SSyncNode* pSyncNode, int32_t maxStaleMs, SyncIndex* pReadIndex) {
+  bool b = false;
+  if (pSyncNode->state == TAOS_SYNC_STATE_LEADER) {
+    b = true;
+  } else if (pSyncNode->state == TAOS_SYNC_STATE_FOLLOWER) {
+    // commit index on follower is the one carried by the last append entries from leader
+    int64_t staleMs = taosGetMonotonicMs() - pSyncNode->leaderContactMs;
+    b = (pSyncNode->leaderContactMs > 0) && (staleMs <= maxStaleMs);
+  }
+
+  if (b) {
+    *pReadIndex = pSyncNode->commitIndex;
+  } else {
+    terrno = TSDB_CODE_SYN_NOT_LEADER;
+  }
+  return b;
+}
+
 bool syncIsRestoreFinish(int64_t rid) {
   SSyncNode* pSyncNode = (SSyncNode*)taosAcquireRef(tsNodeRefId, rid);
   if (pSyncNode == NULL) {
@@ -1158,6 +1216,7 @@ SSyncNode* syncNodeOpen(const SSyncInfo* pOldSyncInfo) {
   pSyncNode->startTime = timeNow;
   pSyncNode->leaderTime = timeNow;
   pSyncNode->lastReplicateTime = timeNow;
+  pSyncNode->openMs = taosGetMonotonicMs();
 
   syncNodeEventLog(pSyncNode, "sync open");
 
@@ -2150,6 +2209,10 @@ void syncNodeBecomeLeader(SSyncNode* pSyncNode, const char* debugStr) {
   // set leader cache
   pSyncNode->leaderCache = pSyncNode->myRaftId;
 
+  // lease starts from scratch in the new term
+  pSyncNode->leaseRevoked = false;
+  syncIndexMgrClearLeaseAck(pSyncNode->pNextIndex);
+
   for (int i = 0; i < pSyncNode->pNextIndex->replicaNum; ++i) {
     // maybe overwrite myself, no harm
     // just do it!
@@ -2809,6 +2872,10 @@ int32_t syncDoLeaderTransfer(SSyncNode* ths, SRpcMsg* pRpcMsg, SSyncRaftEntry* p
   bool sameNodeInfo = strcmp(pSyncLeaderTransfer->newNodeInfo.nodeFqdn, ths->myNodeInfo.nodeFqdn) == 0 &&
                       pSyncLeaderTransfer->newNodeInfo.nodePort == ths->myNodeInfo.nodePort;
 
+  // followers vote for the new leader without waiting for the old lease to expire
+  ths->transferTargetId = pSyncLeaderTransfer->newLeaderId;
+  ths->transferTerm = ths->pRaftStore->currentTerm;
+
   bool same = sameId || sameNodeInfo;
   if (same) {
     // reset elect timer now!
@@ -2939,6 +3006,80 @@ static int32_t syncNodeProposeConfigChangeFinish(SSyncNode* ths, SyncReconfigFin
   return 0;
 }
 
+// leader lease -----------------------------------------------------------------
+// A follower does not vote for others within electBaseLine after it heard from the leader or restarted, see
+// syncNodeLeaseHoldVote. So once a quorum acked an append entries sent at time t, no other leader can be elected
+// before t + electBaseLine, leader can serve reads locally until then, minus an allowance for clock drift.
+int64_t syncNodeLeaseMs(const SSyncNode* pSyncNode) {
+  return (int64_t)pSyncNode->electBaseLine * (100 - LEASE_DRIFT_PCT) / 100;
+}
+
+bool syncNodeLeaseValid(SSyncNode* pSyncNode) {
+  if (pSyncNode->state != TAOS_SYNC_STATE_LEADER || pSyncNode->leaseRevoked) {
+    return false;
+  }
+
+  // noop of this term not applied yet, commit index may be behind
+  if (!pSyncNode->restoreFinish) {
+    return false;
+  }
+
+  int64_t timeNow = taosGetMonotonicMs();
+  int64_t ackArr[TSDB_MAX_REPLICA];
+  int32_t ackNum = 0;
+  for (int i = 0; i < pSyncNode->replicaNum; ++i) {
+    if (syncUtilSameId(&(pSyncNode->replicasId[i]), &(pSyncNode->myRaftId))) {
+      ackArr[ackNum++] = timeNow;
+    } else {
+      ackArr[ackNum++] = pSyncNode->pNextIndex->leaseAckArr[i];
+    }
+  }
+
+  // the quorum-th latest ack bounds the lease
+  for (int i = 0; i < pSyncNode->quorum && i < ackNum; ++i) {
+    for (int j = i + 1; j < ackNum; ++j) {
+      if (ackArr[j] > ackArr[i]) {
+        int64_t tmp = ackArr[i];
+        ackArr[i] = ackArr[j];
+        ackArr[j] = tmp;
+      }
+    }
+  }
+
+  if (pSyncNode->quorum <= 0 || pSyncNode->quorum > ackNum) {
+    return false;
+  }
+  int64_t leaseStartMs = ackArr[pSyncNode->quorum - 1];
+  return leaseStartMs > 0 && timeNow < leaseStartMs + syncNodeLeaseMs(pSyncNode);
+}
+
+void syncNodeLeaseAck(SSyncNode* pSyncNode, const SRaftId* pRaftId, int64_t leaseStartMs) {
+  if (pSyncNode->state != TAOS_SYNC_STATE_LEADER || leaseStartMs <= 0) {
+    return;
+  }
+  syncIndexMgrSetLeaseAck(pSyncNode->pNextIndex, pRaftId, leaseStartMs);
+}
+
+bool syncNodeLeaseHoldVote(SSyncNode* pSyncNode, const SRaftId* pCandidateId) {
+  if (pSyncNode->state != TAOS_SYNC_STATE_FOLLOWER) {
+    return false;
+  }
+
+  if (syncUtilSameId(pCandidateId, &(pSyncNode->leaderCache))) {
+    return false;
+  }
+
+  // leader transfer
+  if (pSyncNode->transferTerm == pSyncNode->pRaftStore->currentTerm &&
+      syncUtilSameId(pCandidateId, &(pSyncNode->transferTargetId))) {
+    return false;
+  }
+
+  // the node may have acked the old leader right before a restart, count the restart as a contact
+  int64_t contactMs = TMAX(pSyncNode->leaderContactMs, pSyncNode->openMs);
+  return taosGetMonotonicMs() - contactMs < pSyncNode->electBaseLine;
+}
+
 bool syncNodeIsOptimizedOneReplica(SSyncNode* ths, SRpcMsg* pMsg) {
   return (ths->replicaNum == 1 && syncUtilUserCommit(pMsg->msgType) && ths->vgId != 1);
 }
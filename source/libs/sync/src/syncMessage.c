@@ -1428,7 +1428,7 @@ void syncRequestVoteReplyLog2(char* s, const SyncRequestVoteReply* pMsg) {
 
 // ---- message process SyncAppendEntries----
 SyncAppendEntries* syncAppendEntriesBuild(uint32_t dataLen, int32_t vgId) {
-  uint32_t           bytes = sizeof(SyncAppendEntries) + dataLen;
+  uint32_t           bytes = sizeof(SyncAppendEntries) + dataLen + sizeof(int64_t);
   SyncAppendEntries* pMsg = taosMemoryMalloc(bytes);
   memset(pMsg, 0, bytes);
   pMsg->bytes = bytes;
@@ -1438,6 +1438,19 @@ SyncAppendEntries* syncAppendEntriesBuild(uint32_t dataLen, int32_t vgId) {
   return pMsg;
 }
 
+void syncAppendEntriesSetLeaseStart(SyncAppendEntries* pMsg, int64_t leaseStartMs) {
+  ASSERT(pMsg->bytes == sizeof(SyncAppendEntries) + pMsg->dataLen + sizeof(int64_t));
+  memcpy(pMsg->data + pMsg->dataLen, &leaseStartMs, sizeof(int64_t));
+}
+
+int64_t syncAppendEntriesLeaseStart(const SyncAppendEntries* pMsg) {
+  int64_t leaseStartMs = 0;
+  if (pMsg->bytes >= sizeof(SyncAppendEntries) + pMsg->dataLen + sizeof(int64_t)) {
+    memcpy(&leaseStartMs, pMsg->data + pMsg->dataLen, sizeof(int64_t));
+  }
+  return leaseStartMs;
+}
+
 void syncAppendEntriesDestroy(SyncAppendEntries* pMsg) {
   if (pMsg != NULL) {
     taosMemoryFree(pMsg);
@@ -1452,7 +1465,8 @@ void syncAppendEntriesSerialize(const SyncAppendEntries* pMsg, char* buf, uint32
 void syncAppendEntriesDeserialize(const char* buf, uint32_t len, SyncAppendEntries* pMsg) {
   memcpy(pMsg, buf, len);
   ASSERT(len == pMsg->bytes);
-  ASSERT(pMsg->bytes == sizeof(SyncAppendEntries) + pMsg->dataLen);
+  ASSERT(pMsg->bytes == sizeof(SyncAppendEntries) + pMsg->dataLen ||
+         pMsg->bytes == sizeof(SyncAppendEntries) + pMsg->dataLen + sizeof(int64_t));
 }
 
 char* syncAppendEntriesSerialize2(const SyncAppendEntries* pMsg, uint32_t* len) {
@@ -1546,6 +1560,9 @@ cJSON* syncAppendEntries2Json(const SyncAppendEntries* pMsg) {
     snprintf(u64buf, sizeof(u64buf), "%" PRId64, pMsg->commitIndex);
     cJSON_AddStringToObject(pRoot, "commitIndex", u64buf);
 
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, syncAppendEntriesLeaseStart(pMsg));
+    cJSON_AddStringToObject(pRoot, "leaseStartMs", u64buf);
+
     cJSON_AddNumberToObject(pRoot, "dataLen", pMsg->dataLen);
     char* s;
     s = syncUtilprintBin((char*)(pMsg->data), pMsg->dataLen);
@@ -1616,7 +1633,7 @@ SyncAppendEntriesBatch* syncAppendEntriesBatchBuild(SSyncRaftEntry** entryPArr,
   }
   dataLen += (metaArrayLen + entryArrayLen);
 
-  uint32_t                bytes = sizeof(SyncAppendEntriesBatch) + dataLen;
+  uint32_t                bytes = sizeof(SyncAppendEntriesBatch) + dataLen + sizeof(int64_t);
   SyncAppendEntriesBatch* pMsg = taosMemoryMalloc(bytes);
   memset(pMsg, 0, bytes);
   pMsg->bytes = bytes;
@@ -1646,6 +1663,19 @@ SyncAppendEntriesBatch* syncAppendEntriesBatchBuild(SSyncRaftEntry** entryPArr,
   return pMsg;
 }
 
+void syncAppendEntriesBatchSetLeaseStart(SyncAppendEntriesBatch* pMsg, int64_t leaseStartMs) {
+  ASSERT(pMsg->bytes == sizeof(SyncAppendEntriesBatch) + pMsg->dataLen + sizeof(int64_t));
+  memcpy(pMsg->data + pMsg->dataLen, &leaseStartMs, sizeof(int64_t));
+}
+
+int64_t syncAppendEntriesBatchLeaseStart(const SyncAppendEntriesBatch* pMsg) {
+  int64_t leaseStartMs = 0;
+  if (pMsg->bytes >= sizeof(SyncAppendEntriesBatch) + pMsg->dataLen + sizeof(int64_t)) {
+    memcpy(&leaseStartMs, pMsg->data + pMsg->dataLen, sizeof(int64_t));
+  }
+  return leaseStartMs;
+}
+
 SOffsetAndContLen* syncAppendEntriesBatchMetaTableArray(SyncAppendEntriesBatch* pMsg) {
   return (SOffsetAndContLen*)(pMsg->data);
 }
@@ -1664,7 +1694,8 @@ void syncAppendEntriesBatchSerialize(const SyncAppendEntriesBatch* pMsg, char* b
 void syncAppendEntriesBatchDeserialize(const char* buf, uint32_t len, SyncAppendEntriesBatch* pMsg) {
   memcpy(pMsg, buf, len);
   ASSERT(len == pMsg->bytes);
-  ASSERT(pMsg->bytes == sizeof(SyncAppendEntriesBatch) + pMsg->dataLen);
+  ASSERT(pMsg->bytes == sizeof(SyncAppendEntriesBatch) + pMsg->dataLen ||
+         pMsg->bytes == sizeof(SyncAppendEntriesBatch) + pMsg->dataLen + sizeof(int64_t));
 }
 
 char* syncAppendEntriesBatchSerialize2(const SyncAppendEntriesBatch* pMsg, uint32_t* len) {
@@ -1758,6 +1789,9 @@ cJSON* syncAppendEntriesBatch2Json(const SyncAppendEntriesBatch* pMsg) {
     snprintf(u64buf, sizeof(u64buf), "%" PRIu64, pMsg->privateTerm);
     cJSON_AddStringToObject(pRoot, "privateTerm", u64buf);
 
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, syncAppendEntriesBatchLeaseStart(pMsg));
+    cJSON_AddStringToObject(pRoot, "leaseStartMs", u64buf);
+
     cJSON_AddNumberToObject(pRoot, "dataCount", pMsg->dataCount);
     cJSON_AddNumberToObject(pRoot, "dataLen", pMsg->dataLen);
 
@@ -1859,7 +1893,9 @@ void syncAppendEntriesReplySerialize(const SyncAppendEntriesReply* pMsg, char* b
 }
 
 void syncAppendEntriesReplyDeserialize(const char* buf, uint32_t len, SyncAppendEntriesReply* pMsg) {
-  memcpy(pMsg, buf, len);
+  // replies of older versions end before leaseStartMs
+  memset(pMsg, 0, sizeof(SyncAppendEntriesReply));
+  memcpy(pMsg, buf, TMIN(len, sizeof(SyncAppendEntriesReply)));
   ASSERT(len == pMsg->bytes);
 }
 
@@ -1874,8 +1910,7 @@ char* syncAppendEntriesReplySerialize2(const SyncAppendEntriesReply* pMsg, uint3
 }
 
 SyncAppendEntriesReply* syncAppendEntriesReplyDeserialize2(const char* buf, uint32_t len) {
-  uint32_t                bytes = *((uint32_t*)buf);
-  SyncAppendEntriesReply* pMsg = taosMemoryMalloc(bytes);
+  SyncAppendEntriesReply* pMsg = taosMemoryMalloc(sizeof(SyncAppendEntriesReply));
   ASSERT(pMsg != NULL);
   syncAppendEntriesReplyDeserialize(buf, len, pMsg);
   ASSERT(len == pMsg->bytes);
@@ -1949,6 +1984,8 @@ cJSON* syncAppendEntriesReply2Json(const SyncAppendEntriesReply* pMsg) {
     cJSON_AddStringToObject(pRoot, "matchIndex", u64buf);
     snprintf(u64buf, sizeof(u64buf), "%" PRId64, pMsg->startTime);
     cJSON_AddStringToObject(pRoot, "startTime", u64buf);
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, pMsg->leaseStartMs);
+    cJSON_AddStringToObject(pRoot, "leaseStartMs", u64buf);
   }
 
   cJSON* pJson = cJSON_CreateObject();
@@ -2464,6 +2501,31 @@ SyncSnapshotSend* syncSnapshotSendBuild(uint32_t dataLen, int32_t vgId) {
   return pMsg;
 }
 
+// rawLen is appended after data, so that uncompressed msgs keep the old layout
+SyncSnapshotSend* syncSnapshotSendBuildCmpr(uint32_t dataLen, uint32_t rawLen, int32_t vgId) {
+  if (rawLen == 0) {
+    return syncSnapshotSendBuild(dataLen, vgId);
+  }
+
+  uint32_t          bytes = sizeof(SyncSnapshotSend) + dataLen + sizeof(uint32_t);
+  SyncSnapshotSend* pMsg = taosMemoryMalloc(bytes);
+  memset(pMsg, 0, bytes);
+  pMsg->bytes = bytes;
+  pMsg->vgId = vgId;
+  pMsg->msgType = TDMT_SYNC_SNAPSHOT_SEND;
+  pMsg->dataLen = dataLen;
+  memcpy(pMsg->data + dataLen, &rawLen, sizeof(uint32_t));
+  return pMsg;
+}
+
+uint32_t syncSnapshotSendRawLen(const SyncSnapshotSend* pMsg) {
+  uint32_t rawLen = 0;
+  if (pMsg->bytes >= sizeof(SyncSnapshotSend) + pMsg->dataLen + sizeof(uint32_t)) {
+    memcpy(&rawLen, pMsg->data + pMsg->dataLen, sizeof(uint32_t));
+  }
+  return rawLen;
+}
+
 void syncSnapshotSendDestroy(SyncSnapshotSend* pMsg) {
   if (pMsg != NULL) {
     taosMemoryFree(pMsg);
@@ -2478,7 +2540,8 @@ void syncSnapshotSendSerialize(const SyncSnapshotSend* pMsg, char* buf, uint32_t
 void syncSnapshotSendDeserialize(const char* buf, uint32_t len, SyncSnapshotSend* pMsg) {
   memcpy(pMsg, buf, len);
   ASSERT(len == pMsg->bytes);
-  ASSERT(pMsg->bytes == sizeof(SyncSnapshotSend) + pMsg->dataLen);
+  ASSERT(pMsg->bytes == sizeof(SyncSnapshotSend) + pMsg->dataLen ||
+         pMsg->bytes == sizeof(SyncSnapshotSend) + pMsg->dataLen + sizeof(uint32_t));
 }
 
 char* syncSnapshotSendSerialize2(const SyncSnapshotSend* pMsg, uint32_t* len) {
@@ -2579,6 +2642,7 @@ cJSON* syncSnapshotSend2Json(const SyncSnapshotSend* pMsg) {
     cJSON_AddNumberToObject(pRoot, "seq", pMsg->seq);
 
     cJSON_AddNumberToObject(pRoot, "dataLen", pMsg->dataLen);
+    cJSON_AddNumberToObject(pRoot, "rawLen", syncSnapshotSendRawLen(pMsg));
     char* s;
     s = syncUtilprintBin((char*)(pMsg->data), pMsg->dataLen);
     cJSON_AddStringToObject(pRoot, "data", s);
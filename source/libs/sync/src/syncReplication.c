@@ -105,6 +105,7 @@ int32_t syncNodeAppendEntriesPeers(SSyncNode* pSyncNode) {
     pMsg->prevLogIndex = preLogIndex;
     pMsg->prevLogTerm = preLogTerm;
     pMsg->commitIndex = pSyncNode->commitIndex;
+    syncAppendEntriesSetLeaseStart(pMsg, taosGetMonotonicMs());
 
     syncAppendEntriesLog2("==syncNodeAppendEntriesPeers==", pMsg);
 
@@ -185,6 +186,7 @@ int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, Syn
   pMsg->prevLogIndex = preLogIndex;
   pMsg->prevLogTerm = preLogTerm;
   pMsg->commitIndex = pSyncNode->commitIndex;
+  syncAppendEntriesBatchSetLeaseStart(pMsg, taosGetMonotonicMs());
   pMsg->privateTerm = 0;
   pMsg->dataCount = getCount;
 
@@ -308,6 +310,7 @@ int32_t syncNodeAppendEntriesPeersSnapshot2(SSyncNode* pSyncNode) {
     pMsg->prevLogIndex = preLogIndex;
     pMsg->prevLogTerm = preLogTerm;
     pMsg->commitIndex = pSyncNode->commitIndex;
+    syncAppendEntriesBatchSetLeaseStart(pMsg, taosGetMonotonicMs());
     pMsg->privateTerm = 0;
     pMsg->dataCount = getCount;
 
@@ -408,6 +411,7 @@ int32_t syncNodeAppendEntriesPeersSnapshot(SSyncNode* pSyncNode) {
     pMsg->prevLogIndex = preLogIndex;
     pMsg->prevLogTerm = preLogTerm;
     pMsg->commitIndex = pSyncNode->commitIndex;
+    syncAppendEntriesSetLeaseStart(pMsg, taosGetMonotonicMs());
     pMsg->privateTerm = 0;
     // pMsg->privateTerm = syncIndexMgrGetTerm(pSyncNode->pNextIndex, pDestId);
 
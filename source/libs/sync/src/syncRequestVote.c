@@ -55,6 +55,10 @@ int32_t syncNodeOnRequestVoteCb(SSyncNode* ths, SyncRequestVote* pMsg) {
                ((pMsg->lastLogTerm == ths->pLogStore->getLastTerm(ths->pLogStore)) &&
                 (pMsg->lastLogIndex >= ths->pLogStore->getLastIndex(ths->pLogStore)));
 
+  // leader lease, do not help to elect a new leader while the current one is alive.
+  // the term is still updated and the vote rejected, so terms keep converging
+  bool holdVote = syncNodeLeaseHoldVote(ths, &(pMsg->srcId));
+
   // maybe update term
   if (pMsg->term > ths->pRaftStore->currentTerm) {
     syncNodeUpdateTerm(ths, pMsg->term);
@@ -68,7 +72,7 @@ int32_t syncNodeOnRequestVoteCb(SSyncNode* ths, SyncRequestVote* pMsg) {
   }
   ASSERT(pMsg->term <= ths->pRaftStore->currentTerm);
 
-  bool grant = (pMsg->term == ths->pRaftStore->currentTerm) && logOK &&
+  bool grant = !holdVote && (pMsg->term == ths->pRaftStore->currentTerm) && logOK &&
                ((!raftStoreHasVoted(ths->pRaftStore)) || (syncUtilSameId(&(ths->pRaftStore->voteFor), &(pMsg->srcId))));
   if (grant) {
     // maybe has already voted for pMsg->srcId
@@ -89,7 +93,7 @@ int32_t syncNodeOnRequestVoteCb(SSyncNode* ths, SyncRequestVote* pMsg) {
   // trace log
   do {
     char logBuf[32];
-    snprintf(logBuf, sizeof(logBuf), "grant:%d", pReply->voteGranted);
+    snprintf(logBuf, sizeof(logBuf), "grant:%d, lease-hold:%d", pReply->voteGranted, holdVote);
     syncLogRecvRequestVote(ths, pMsg, logBuf);
     syncLogSendRequestVoteReply(ths, pReply, "");
   } while (0);
@@ -168,6 +172,10 @@ int32_t syncNodeOnRequestVoteSnapshotCb(SSyncNode* ths, SyncRequestVote* pMsg) {
 
   bool logOK = syncNodeOnRequestVoteLogOK(ths, pMsg);
 
+  // leader lease, do not help to elect a new leader while the current one is alive.
+  // the term is still updated and the vote rejected, so terms keep converging
+  bool holdVote = syncNodeLeaseHoldVote(ths, &(pMsg->srcId));
+
   // maybe update term
   if (pMsg->term > ths->pRaftStore->currentTerm) {
     syncNodeUpdateTerm(ths, pMsg->term);
@@ -181,7 +189,7 @@ int32_t syncNodeOnRequestVoteSnapshotCb(SSyncNode* ths, SyncRequestVote* pMsg) {
   }
   ASSERT(pMsg->term <= ths->pRaftStore->currentTerm);
 
-  bool grant = (pMsg->term == ths->pRaftStore->currentTerm) && logOK &&
+  bool grant = !holdVote && (pMsg->term == ths->pRaftStore->currentTerm) && logOK &&
                ((!raftStoreHasVoted(ths->pRaftStore)) || (syncUtilSameId(&(ths->pRaftStore->voteFor), &(pMsg->srcId))));
   if (grant) {
     // maybe has already voted for pMsg->srcId
@@ -202,7 +210,7 @@ int32_t syncNodeOnRequestVoteSnapshotCb(SSyncNode* ths, SyncRequestVote* pMsg) {
   // trace log
   do {
     char logBuf[32];
-    snprintf(logBuf, sizeof(logBuf), "grant:%d", pReply->voteGranted);
+    snprintf(logBuf, sizeof(logBuf), "grant:%d, lease-hold:%d", pReply->voteGranted, holdVote);
     syncLogRecvRequestVote(ths, pMsg, logBuf);
     syncLogSendRequestVoteReply(ths, pReply, "");
   } while (0);
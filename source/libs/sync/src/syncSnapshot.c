@@ -19,10 +19,14 @@
 #include "syncRaftLog.h"
 #include "syncRaftStore.h"
 #include "syncUtil.h"
+#include "tcompression.h"
 #include "wal.h"
 
 //----------------------------------
 static void    snapshotSenderUpdateProgress(SSyncSnapshotSender *pSender, SyncSnapshotRsp *pMsg);
+static void    snapshotSenderClearBlocks(SSyncSnapshotSender *pSender);
+static void    snapshotSenderSendMsg(SSyncSnapshotSender *pSender, int32_t seq, const void *pData, uint32_t dataLen,
+                                     uint32_t rawLen);
 static void    snapshotReceiverDoStart(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pBeginMsg);
 static void    snapshotReceiverGotData(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg);
 static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg);
@@ -65,6 +69,7 @@ void snapshotSenderDestroy(SSyncSnapshotSender *pSender) {
       taosMemoryFree(pSender->pCurrentBlock);
       pSender->pCurrentBlock = NULL;
     }
+    snapshotSenderClearBlocks(pSender);
 
     // close reader
     if (pSender->pReader != NULL) {
@@ -101,8 +106,17 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender, SSnapshotParam snapsho
   // init current block
   if (pSender->pCurrentBlock != NULL) {
     taosMemoryFree(pSender->pCurrentBlock);
+    pSender->pCurrentBlock = NULL;
   }
   pSender->blockLen = 0;
+  pSender->readFinish = false;
+  snapshotSenderClearBlocks(pSender);
+
+  // init progress
+  pSender->startMS = taosGetTimestampMs();
+  pSender->lastResendMS = 0;
+  pSender->rawBytes = 0;
+  pSender->wireBytes = 0;
 
   // update term
   pSender->term = pSender->pSyncNode->pRaftStore->currentTerm;
@@ -165,24 +179,8 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender, SSnapshotParam snapsho
     memset(&(pSender->lastConfig), 0, sizeof(SSyncCfg));
   }
 
-  // build begin msg
-  SyncSnapshotSend *pMsg = syncSnapshotSendBuild(0, pSender->pSyncNode->vgId);
-  pMsg->srcId = pSender->pSyncNode->myRaftId;
-  pMsg->destId = (pSender->pSyncNode->replicasId)[pSender->replicaIndex];
-  pMsg->term = pSender->pSyncNode->pRaftStore->currentTerm;
-  pMsg->beginIndex = pSender->snapshotParam.start;
-  pMsg->lastIndex = pSender->snapshot.lastApplyIndex;
-  pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
-  pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
-  pMsg->lastConfig = pSender->lastConfig;
-  pMsg->seq = pSender->seq;  // SYNC_SNAPSHOT_SEQ_BEGIN
-  pMsg->privateTerm = pSender->privateTerm;
-
-  // send msg
-  SRpcMsg rpcMsg;
-  syncSnapshotSend2RpcMsg(pMsg, &rpcMsg);
-  syncNodeSendMsgById(&(pMsg->destId), pSender->pSyncNode, &rpcMsg);
-  syncSnapshotSendDestroy(pMsg);
+  // send begin msg
+  snapshotSenderSendMsg(pSender, pSender->seq, NULL, 0, 0);  // SYNC_SNAPSHOT_SEQ_BEGIN
 
   // event log
   do {
@@ -208,6 +206,7 @@ int32_t snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish) {
     pSender->pCurrentBlock = NULL;
     pSender->blockLen = 0;
   }
+  snapshotSenderClearBlocks(pSender);
 
   // update flag
   pSender->start = false;
@@ -225,29 +224,18 @@ int32_t snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish) {
   return 0;
 }
 
-// when sender receive ack, call this function to send msg from seq
-// seq = ack + 1, already updated
-int32_t snapshotSend(SSyncSnapshotSender *pSender) {
-  // free memory last time (current seq - 1)
-  if (pSender->pCurrentBlock != NULL) {
-    taosMemoryFree(pSender->pCurrentBlock);
-    pSender->pCurrentBlock = NULL;
-    pSender->blockLen = 0;
-  }
-
-  // read data
-  int32_t ret = pSender->pSyncNode->pFsm->FpSnapshotDoRead(pSender->pSyncNode->pFsm, pSender->pReader,
-                                                           &(pSender->pCurrentBlock), &(pSender->blockLen));
-  ASSERT(ret == 0);
-  if (pSender->blockLen > 0) {
-    // has read data
-  } else {
-    // read finish, update seq to end
-    pSender->seq = SYNC_SNAPSHOT_SEQ_END;
+static void snapshotSenderClearBlocks(SSyncSnapshotSender *pSender) {
+  for (int32_t i = 0; i < SYNC_SNAPSHOT_WINDOW_SIZE; ++i) {
+    SSyncSnapshotBlock *pBlock = &(pSender->aBlock[i]);
+    taosMemoryFreeClear(pBlock->pData);
+    memset(pBlock, 0, sizeof(*pBlock));
   }
+}
 
+static void snapshotSenderSendMsg(SSyncSnapshotSender *pSender, int32_t seq, const void *pData, uint32_t dataLen,
+                                  uint32_t rawLen) {
   // build msg
-  SyncSnapshotSend *pMsg = syncSnapshotSendBuild(pSender->blockLen, pSender->pSyncNode->vgId);
+  SyncSnapshotSend *pMsg = syncSnapshotSendBuildCmpr(dataLen, rawLen, pSender->pSyncNode->vgId);
   pMsg->srcId = pSender->pSyncNode->myRaftId;
   pMsg->destId = (pSender->pSyncNode->replicasId)[pSender->replicaIndex];
   pMsg->term = pSender->pSyncNode->pRaftStore->currentTerm;
@@ -256,9 +244,11 @@ int32_t snapshotSend(SSyncSnapshotSender *pSender) {
   pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
   pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
   pMsg->lastConfig = pSender->lastConfig;
-  pMsg->seq = pSender->seq;
+  pMsg->seq = seq;
   pMsg->privateTerm = pSender->privateTerm;
-  memcpy(pMsg->data, pSender->pCurrentBlock, pSender->blockLen);
+  if (dataLen > 0) {
+    memcpy(pMsg->data, pData, dataLen);
+  }
 
   // send msg
   SRpcMsg rpcMsg;
@@ -266,48 +256,86 @@ int32_t snapshotSend(SSyncSnapshotSender *pSender) {
   syncNodeSendMsgById(&(pMsg->destId), pSender->pSyncNode, &rpcMsg);
   syncSnapshotSendDestroy(pMsg);
 
-  // event log
-  do {
-    char *eventLog = NULL;
-    if (pSender->seq == SYNC_SNAPSHOT_SEQ_END) {
-      eventLog = snapshotSender2SimpleStr(pSender, "snapshot sender finish");
-    } else {
-      eventLog = snapshotSender2SimpleStr(pSender, "snapshot sender sending");
+  pSender->wireBytes += dataLen;
+}
+
+// compress the current block into the in flight window slot of seq
+static int32_t snapshotSenderBufferBlock(SSyncSnapshotSender *pSender, int32_t seq) {
+  SSyncSnapshotBlock *pBlock = &(pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_SIZE]);
+  ASSERT(pBlock->pData == NULL);
+
+  int32_t rawLen = pSender->blockLen;
+  if (rawLen >= SYNC_SNAPSHOT_CMPR_MIN_SIZE) {
+    // see tsCompressStringImp, one more byte for the indicator
+    int32_t bound = rawLen + rawLen / 255 + 16 + 1;
+    pBlock->pData = taosMemoryMalloc(bound);
+    if (pBlock->pData == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
     }
-    syncNodeEventLog(pSender->pSyncNode, eventLog);
-    taosMemoryFree(eventLog);
-  } while (0);
+    pBlock->dataLen = tsCompressStringImp(pSender->pCurrentBlock, rawLen, pBlock->pData, bound);
+    pBlock->rawLen = rawLen;
+  } else {
+    pBlock->pData = taosMemoryMalloc(rawLen);
+    if (pBlock->pData == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    memcpy(pBlock->pData, pSender->pCurrentBlock, rawLen);
+    pBlock->dataLen = rawLen;
+    pBlock->rawLen = 0;
+  }
+  pBlock->seq = seq;
 
+  pSender->rawBytes += rawLen;
   return 0;
 }
 
-// send snapshot data from cache
-int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
-  // send current block data
-  if (pSender->pCurrentBlock != NULL && pSender->blockLen > 0) {
-    // build msg
-    SyncSnapshotSend *pMsg = syncSnapshotSendBuild(pSender->blockLen, pSender->pSyncNode->vgId);
-    pMsg->srcId = pSender->pSyncNode->myRaftId;
-    pMsg->destId = (pSender->pSyncNode->replicasId)[pSender->replicaIndex];
-    pMsg->term = pSender->pSyncNode->pRaftStore->currentTerm;
-    pMsg->beginIndex = pSender->snapshotParam.start;
-    pMsg->lastIndex = pSender->snapshot.lastApplyIndex;
-    pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
-    pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
-    pMsg->lastConfig = pSender->lastConfig;
-    pMsg->seq = pSender->seq;
-    pMsg->privateTerm = pSender->privateTerm;
-    memcpy(pMsg->data, pSender->pCurrentBlock, pSender->blockLen);
-
-    // send msg
-    SRpcMsg rpcMsg;
-    syncSnapshotSend2RpcMsg(pMsg, &rpcMsg);
-    syncNodeSendMsgById(&(pMsg->destId), pSender->pSyncNode, &rpcMsg);
-    syncSnapshotSendDestroy(pMsg);
+// when sender receive ack, call this function to send msg from seq + 1
+// keep at most SYNC_SNAPSHOT_WINDOW_SIZE blocks in flight, send SYNC_SNAPSHOT_SEQ_END after all data acked
+int32_t snapshotSend(SSyncSnapshotSender *pSender) {
+  while (!pSender->readFinish && pSender->seq - pSender->ack < SYNC_SNAPSHOT_WINDOW_SIZE) {
+    // free memory last time
+    if (pSender->pCurrentBlock != NULL) {
+      taosMemoryFree(pSender->pCurrentBlock);
+      pSender->pCurrentBlock = NULL;
+      pSender->blockLen = 0;
+    }
+
+    // read data
+    int32_t ret = pSender->pSyncNode->pFsm->FpSnapshotDoRead(pSender->pSyncNode->pFsm, pSender->pReader,
+                                                             &(pSender->pCurrentBlock), &(pSender->blockLen));
+    ASSERT(ret == 0);
+    if (pSender->blockLen <= 0) {
+      // read finish
+      pSender->readFinish = true;
+      break;
+    }
+
+    int32_t seq = pSender->seq + 1;
+    ret = snapshotSenderBufferBlock(pSender, seq);
+    ASSERT(ret == 0);
+    pSender->seq = seq;
+
+    SSyncSnapshotBlock *pBlock = &(pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_SIZE]);
+    snapshotSenderSendMsg(pSender, seq, pBlock->pData, pBlock->dataLen, pBlock->rawLen);
+
+    // event log
+    do {
+      char *eventLog = snapshotSender2SimpleStr(pSender, "snapshot sender sending");
+      syncNodeEventLog(pSender->pSyncNode, eventLog);
+      taosMemoryFree(eventLog);
+    } while (0);
+  }
+
+  if (pSender->readFinish && pSender->seq != SYNC_SNAPSHOT_SEQ_END && pSender->ack == pSender->seq) {
+    // all data acked, update seq to end
+    pSender->seq = SYNC_SNAPSHOT_SEQ_END;
+    snapshotSenderSendMsg(pSender, pSender->seq, NULL, 0, 0);
 
     // event log
     do {
-      char *eventLog = snapshotSender2SimpleStr(pSender, "snapshot sender resend");
+      char *eventLog = snapshotSender2SimpleStr(pSender, "snapshot sender finish");
       syncNodeEventLog(pSender->pSyncNode, eventLog);
       taosMemoryFree(eventLog);
     } while (0);
@@ -316,10 +344,47 @@ int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
   return 0;
 }
 
+// send all unacked blocks from cache, the receiver drops the ones after a lost block
+int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
+  if (pSender->ack + 1 <= SYNC_SNAPSHOT_SEQ_BEGIN || pSender->ack >= pSender->seq ||
+      pSender->seq == SYNC_SNAPSHOT_SEQ_END) {
+    return 0;
+  }
+
+  for (int32_t seq = pSender->ack + 1; seq <= pSender->seq; ++seq) {
+    SSyncSnapshotBlock *pBlock = &(pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_SIZE]);
+    if (pBlock->pData != NULL && pBlock->seq == seq) {
+      snapshotSenderSendMsg(pSender, seq, pBlock->pData, pBlock->dataLen, pBlock->rawLen);
+    }
+  }
+  pSender->lastResendMS = taosGetTimestampMs();
+
+  // event log
+  do {
+    char *eventLog = snapshotSender2SimpleStr(pSender, "snapshot sender resend");
+    syncNodeEventLog(pSender->pSyncNode, eventLog);
+    taosMemoryFree(eventLog);
+  } while (0);
+
+  return 0;
+}
+
+// release all blocks up to ack
 static void snapshotSenderUpdateProgress(SSyncSnapshotSender *pSender, SyncSnapshotRsp *pMsg) {
-  ASSERT(pMsg->ack == pSender->seq);
+  ASSERT(pMsg->ack > pSender->ack && pMsg->ack <= pSender->seq);
+  for (int32_t seq = TMAX(pSender->ack + 1, SYNC_SNAPSHOT_SEQ_BEGIN + 1); seq <= pMsg->ack; ++seq) {
+    SSyncSnapshotBlock *pBlock = &(pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_SIZE]);
+    ASSERT(pBlock->seq == seq);
+    taosMemoryFreeClear(pBlock->pData);
+    memset(pBlock, 0, sizeof(*pBlock));
+  }
   pSender->ack = pMsg->ack;
-  ++(pSender->seq);
+}
+
+static double snapshotThroughput(int64_t bytes, int64_t startMS) {
+  int64_t elapsed = taosGetTimestampMs() - startMS;
+  if (startMS <= 0 || elapsed <= 0) return 0;
+  return (double)bytes / elapsed * 1000 / (1024 * 1024);
 }
 
 cJSON *snapshotSender2Json(SSyncSnapshotSender *pSender) {
@@ -364,6 +429,16 @@ cJSON *snapshotSender2Json(SSyncSnapshotSender *pSender) {
     snprintf(u64buf, sizeof(u64buf), "%" PRIu64, pSender->privateTerm);
     cJSON_AddStringToObject(pRoot, "privateTerm", u64buf);
     cJSON_AddNumberToObject(pRoot, "finish", pSender->finish);
+
+    cJSON *pProgress = cJSON_CreateObject();
+    cJSON_AddNumberToObject(pProgress, "readFinish", pSender->readFinish);
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, pSender->rawBytes);
+    cJSON_AddStringToObject(pProgress, "rawBytes", u64buf);
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, pSender->wireBytes);
+    cJSON_AddStringToObject(pProgress, "wireBytes", u64buf);
+    snprintf(u64buf, sizeof(u64buf), "%.2f", snapshotThroughput(pSender->rawBytes, pSender->startMS));
+    cJSON_AddStringToObject(pProgress, "MB/s", u64buf);
+    cJSON_AddItemToObject(pRoot, "progress", pProgress);
   }
 
   cJSON *pJson = cJSON_CreateObject();
@@ -379,7 +454,7 @@ char *snapshotSender2Str(SSyncSnapshotSender *pSender) {
 }
 
 char *snapshotSender2SimpleStr(SSyncSnapshotSender *pSender, char *event) {
-  int32_t len = 256;
+  int32_t len = 384;
   char   *s = taosMemoryMalloc(len);
 
   SRaftId  destId = pSender->pSyncNode->replicasId[pSender->replicaIndex];
@@ -389,12 +464,13 @@ char *snapshotSender2SimpleStr(SSyncSnapshotSender *pSender, char *event) {
 
   snprintf(s, len,
            "%s {%p s-param:%" PRId64 " e-param:%" PRId64 " laindex:%" PRId64 " laterm:%" PRIu64 " lcindex:%" PRId64
-           " seq:%d ack:%d finish:%d pterm:%" PRIu64
-           " "
+           " seq:%d ack:%d finish:%d pterm:%" PRIu64 " raw-bytes:%" PRId64 " wire-bytes:%" PRId64
+           " speed:%.2fMB/s "
            "replica-index:%d %s:%d}",
            event, pSender, pSender->snapshotParam.start, pSender->snapshotParam.end, pSender->snapshot.lastApplyIndex,
            pSender->snapshot.lastApplyTerm, pSender->snapshot.lastConfigIndex, pSender->seq, pSender->ack,
-           pSender->finish, pSender->privateTerm, pSender->replicaIndex, host, port);
+           pSender->finish, pSender->privateTerm, pSender->rawBytes, pSender->wireBytes,
+           snapshotThroughput(pSender->rawBytes, pSender->startMS), pSender->replicaIndex, host, port);
 
   return s;
 }
@@ -464,6 +540,11 @@ static void snapshotReceiverDoStart(SSyncSnapshotReceiver *pReceiver, SyncSnapsh
   pReceiver->snapshotParam.start = pBeginMsg->beginIndex;
   pReceiver->snapshotParam.end = pBeginMsg->lastIndex;
 
+  // init progress
+  pReceiver->startMS = taosGetTimestampMs();
+  pReceiver->rawBytes = 0;
+  pReceiver->wireBytes = 0;
+
   // start writer
   ASSERT(pReceiver->pWriter == NULL);
   int32_t ret = pReceiver->pSyncNode->pFsm->FpSnapshotStartWrite(pReceiver->pSyncNode->pFsm,
@@ -543,6 +624,40 @@ int32_t snapshotReceiverStop(SSyncSnapshotReceiver *pReceiver) {
   return 0;
 }
 
+// decompress data block if needed, then apply it
+static int32_t snapshotReceiverWriteData(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg) {
+  char    *pData = pMsg->data;
+  uint32_t dataLen = pMsg->dataLen;
+  char    *pBuf = NULL;
+  uint32_t rawLen = syncSnapshotSendRawLen(pMsg);
+
+  if (rawLen > 0) {
+    pBuf = taosMemoryMalloc(rawLen);
+    if (pBuf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    if (tsDecompressStringImp(pMsg->data, pMsg->dataLen, pBuf, rawLen) != (int32_t)rawLen) {
+      taosMemoryFree(pBuf);
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+
+    pData = pBuf;
+    dataLen = rawLen;
+  }
+
+  int32_t code =
+      pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter, pData, dataLen);
+  taosMemoryFree(pBuf);
+  if (code != 0) return code;
+
+  pReceiver->rawBytes += dataLen;
+  pReceiver->wireBytes += pMsg->dataLen;
+  return 0;
+}
+
 // when recv last snapshot block, apply data into snapshot
 static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg) {
   ASSERT(pMsg->seq == SYNC_SNAPSHOT_SEQ_END);
@@ -551,8 +666,7 @@ static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnap
   if (pReceiver->pWriter != NULL) {
     // write data
     if (pMsg->dataLen > 0) {
-      code = pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter, pMsg->data,
-                                                           pMsg->dataLen);
+      code = snapshotReceiverWriteData(pReceiver, pMsg);
       if (code != 0) {
         syncNodeErrorLog(pReceiver->pSyncNode, "snapshot write error");
         return -1;
@@ -616,8 +730,7 @@ static void snapshotReceiverGotData(SSyncSnapshotReceiver *pReceiver, SyncSnapsh
   if (pReceiver->pWriter != NULL) {
     if (pMsg->dataLen > 0) {
       // apply data block
-      int32_t code = pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter,
-                                                                   pMsg->data, pMsg->dataLen);
+      int32_t code = snapshotReceiverWriteData(pReceiver, pMsg);
       ASSERT(code == 0);
     }
 
@@ -676,6 +789,15 @@ cJSON *snapshotReceiver2Json(SSyncSnapshotReceiver *pReceiver) {
 
     snprintf(u64buf, sizeof(u64buf), "%" PRIu64, pReceiver->privateTerm);
     cJSON_AddStringToObject(pRoot, "privateTerm", u64buf);
+
+    cJSON *pProgress = cJSON_CreateObject();
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, pReceiver->rawBytes);
+    cJSON_AddStringToObject(pProgress, "rawBytes", u64buf);
+    snprintf(u64buf, sizeof(u64buf), "%" PRId64, pReceiver->wireBytes);
+    cJSON_AddStringToObject(pProgress, "wireBytes", u64buf);
+    snprintf(u64buf, sizeof(u64buf), "%.2f", snapshotThroughput(pReceiver->rawBytes, pReceiver->startMS));
+    cJSON_AddStringToObject(pProgress, "MB/s", u64buf);
+    cJSON_AddItemToObject(pRoot, "progress", pProgress);
   }
 
   cJSON *pJson = cJSON_CreateObject();
@@ -691,7 +813,7 @@ char *snapshotReceiver2Str(SSyncSnapshotReceiver *pReceiver) {
 }
 
 char *snapshotReceiver2SimpleStr(SSyncSnapshotReceiver *pReceiver, char *event) {
-  int32_t len = 256;
+  int32_t len = 384;
   char   *s = taosMemoryMalloc(len);
 
   SRaftId  fromId = pReceiver->fromId;
@@ -703,10 +825,11 @@ char *snapshotReceiver2SimpleStr(SSyncSnapshotReceiver *pReceiver, char *event)
            "%s {%p start:%d ack:%d term:%" PRIu64 " pterm:%" PRIu64 " from:%s:%d s-param:%" PRId64 " e-param:%" PRId64
            " laindex:%" PRId64 " laterm:%" PRIu64
            " "
-           "lcindex:%" PRId64 "}",
+           "lcindex:%" PRId64 " raw-bytes:%" PRId64 " wire-bytes:%" PRId64 " speed:%.2fMB/s}",
            event, pReceiver, pReceiver->start, pReceiver->ack, pReceiver->term, pReceiver->privateTerm, host, port,
            pReceiver->snapshotParam.start, pReceiver->snapshotParam.end, pReceiver->snapshot.lastApplyIndex,
-           pReceiver->snapshot.lastApplyTerm, pReceiver->snapshot.lastConfigIndex);
+           pReceiver->snapshot.lastApplyTerm, pReceiver->snapshot.lastConfigIndex, pReceiver->rawBytes,
+           pReceiver->wireBytes, snapshotThroughput(pReceiver->rawBytes, pReceiver->startMS));
 
   return s;
 }
@@ -828,8 +951,9 @@ int32_t syncNodeOnSnapshotSendCb(SSyncNode *pSyncNode, SyncSnapshotSend *pMsg) {
 // sender on message
 //
 // condition 1 sender receives SYNC_SNAPSHOT_SEQ_END, close sender
-// condition 2 sender receives ack, set seq = ack + 1, send msg from seq
-// condition 3 sender receives error msg, just print error log
+// condition 2 sender receives new ack, release acked blocks, refill the window
+// condition 3 sender receives duplicate ack, resend the unacked blocks
+// condition 4 sender receives error msg, just print error log
 //
 int32_t syncNodeOnSnapshotRspCb(SSyncNode *pSyncNode, SyncSnapshotRsp *pMsg) {
   // if already drop replica, do not process
@@ -853,15 +977,18 @@ int32_t syncNodeOnSnapshotRspCb(SSyncNode *pSyncNode, SyncSnapshotRsp *pMsg) {
       }
 
       // condition 2
-      // send next msg
-      if (pMsg->ack == pSender->seq) {
+      // send next msgs
+      if (pMsg->ack > pSender->ack && pMsg->ack <= pSender->seq) {
         // update sender ack
         snapshotSenderUpdateProgress(pSender, pMsg);
         snapshotSend(pSender);
 
-      } else if (pMsg->ack == pSender->seq - 1) {
-        // maybe resend
-        snapshotReSend(pSender);
+      } else if (pMsg->ack <= pSender->ack) {
+        // condition 3
+        // receiver missed a block, maybe resend
+        if (pMsg->ack == pSender->ack && taosGetTimestampMs() - pSender->lastResendMS > pSender->sendingMS) {
+          snapshotReSend(pSender);
+        }
 
       } else {
         // error log
@@ -0,0 +1,353 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <deque>
+#include "syncIndexMgr.h"
+#include "syncInt.h"
+#include "syncMessage.h"
+#include "syncRaftCfg.h"
+#include "syncRaftEntry.h"
+#include "syncRaftStore.h"
+#include "syncRequestVote.h"
+#include "syncRespMgr.h"
+#include "syncUtil.h"
+
+static const int32_t electBaseLine = 1000;
+static const char*   raftStorePath = "./syncLeaseTest_raft_store.json";
+
+static std::deque<SRpcMsg> sent;
+
+int32_t SendMsg(const SEpSet* pEpSet, SRpcMsg* pMsg) {
+  sent.push_back(*pMsg);
+  return 0;
+}
+
+SyncTerm  LogLastTerm(struct SSyncLogStore* pLogStore) { return 1; }
+SyncIndex LogLastIndex(struct SSyncLogStore* pLogStore) { return 10; }
+
+static SRaftId raftId(int32_t i) {
+  SRaftId id = {.addr = syncUtilAddr2U64("127.0.0.1", 7000 + i), .vgId = 1};
+  return id;
+}
+
+// node 0 of a 3 replica group
+SSyncNode* createNode(ESyncState state) {
+  SSyncNode* pSyncNode = (SSyncNode*)taosMemoryCalloc(1, sizeof(SSyncNode));
+  pSyncNode->vgId = 1;
+  pSyncNode->state = state;
+  pSyncNode->myRaftId = raftId(0);
+  pSyncNode->replicaNum = 3;
+  pSyncNode->quorum = 2;
+  for (int32_t i = 0; i < pSyncNode->replicaNum; ++i) {
+    pSyncNode->replicasId[i] = raftId(i);
+  }
+  pSyncNode->peersNum = 2;
+  pSyncNode->peersId[0] = raftId(1);
+  pSyncNode->peersId[1] = raftId(2);
+  pSyncNode->electBaseLine = electBaseLine;
+  pSyncNode->restoreFinish = true;
+  pSyncNode->FpSendMsg = SendMsg;
+
+  taosRemoveFile(raftStorePath);
+  pSyncNode->pRaftStore = raftStoreOpen(raftStorePath);
+  raftStoreSetTerm(pSyncNode->pRaftStore, 5);
+  raftStoreClearVote(pSyncNode->pRaftStore);
+  pSyncNode->pRaftCfg = (SRaftCfg*)taosMemoryCalloc(1, sizeof(SRaftCfg));
+  pSyncNode->pNextIndex = syncIndexMgrCreate(pSyncNode);
+  pSyncNode->pMatchIndex = syncIndexMgrCreate(pSyncNode);
+  pSyncNode->pSyncRespMgr = syncRespMgrCreate(pSyncNode, 0);
+
+  pSyncNode->pLogStore = (SSyncLogStore*)taosMemoryCalloc(1, sizeof(SSyncLogStore));
+  pSyncNode->pLogStore->getLastTerm = LogLastTerm;
+  pSyncNode->pLogStore->getLastIndex = LogLastIndex;
+  pSyncNode->pLogStore->syncLogLastIndex = LogLastIndex;
+  pSyncNode->pLogStore->syncLogBeginIndex = LogLastIndex;
+  pSyncNode->pFsm = (SSyncFSM*)taosMemoryCalloc(1, sizeof(SSyncFSM));
+  return pSyncNode;
+}
+
+void destroyNode(SSyncNode* pSyncNode) {
+  raftStoreClose(pSyncNode->pRaftStore);
+  taosRemoveFile(raftStorePath);
+  syncIndexMgrDestroy(pSyncNode->pNextIndex);
+  syncIndexMgrDestroy(pSyncNode->pMatchIndex);
+  syncRespMgrDestroy(pSyncNode->pSyncRespMgr);
+  taosMemoryFree(pSyncNode->pRaftCfg);
+  taosMemoryFree(pSyncNode->pLogStore);
+  taosMemoryFree(pSyncNode->pFsm);
+  taosMemoryFree(pSyncNode);
+}
+
+SyncRequestVoteReply* popVoteReply() {
+  EXPECT_EQ(sent.size(), 1);
+  SRpcMsg rpcMsg = sent.front();
+  sent.pop_front();
+  syncUtilMsgNtoH(rpcMsg.pCont);
+  SyncRequestVoteReply* pReply = syncRequestVoteReplyFromRpcMsg2(&rpcMsg);
+  rpcFreeCont(rpcMsg.pCont);
+  return pReply;
+}
+
+SyncRequestVoteReply* requestVote(SSyncNode* pSyncNode, int32_t candidate, SyncTerm term) {
+  SyncRequestVote* pMsg = syncRequestVoteBuild(1);
+  pMsg->srcId = raftId(candidate);
+  pMsg->destId = pSyncNode->myRaftId;
+  pMsg->term = term;
+  pMsg->lastLogTerm = 1;
+  pMsg->lastLogIndex = 10;
+  syncNodeOnRequestVoteCb(pSyncNode, pMsg);
+  syncRequestVoteDestroy(pMsg);
+  return popVoteReply();
+}
+
+TEST(syncLeaseTest, leaseQuorum) {
+  SSyncNode* pSyncNode = createNode(TAOS_SYNC_STATE_LEADER);
+  int64_t    now = taosGetMonotonicMs();
+
+  // only the leader itself
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+
+  // acks from an old term or older versions carry no lease start
+  syncNodeLeaseAck(pSyncNode, &pSyncNode->replicasId[1], 0);
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+
+  // self and one follower make the quorum
+  syncNodeLeaseAck(pSyncNode, &pSyncNode->replicasId[1], now);
+  EXPECT_TRUE(syncNodeLeaseValid(pSyncNode));
+
+  // a late reply of an older append entries does not move the lease back
+  syncNodeLeaseAck(pSyncNode, &pSyncNode->replicasId[1], now - electBaseLine);
+  EXPECT_TRUE(syncNodeLeaseValid(pSyncNode));
+
+  pSyncNode->restoreFinish = false;
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+  pSyncNode->restoreFinish = true;
+
+  pSyncNode->leaseRevoked = true;
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+  pSyncNode->leaseRevoked = false;
+
+  pSyncNode->state = TAOS_SYNC_STATE_FOLLOWER;
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+  pSyncNode->state = TAOS_SYNC_STATE_LEADER;
+
+  destroyNode(pSyncNode);
+}
+
+TEST(syncLeaseTest, leaseExpire) {
+  SSyncNode* pSyncNode = createNode(TAOS_SYNC_STATE_LEADER);
+  int64_t    now = taosGetMonotonicMs();
+
+  // the lease is shorter than the vote hold of followers by the drift allowance
+  EXPECT_LT(syncNodeLeaseMs(pSyncNode), electBaseLine);
+
+  syncNodeLeaseAck(pSyncNode, &pSyncNode->replicasId[1], now - syncNodeLeaseMs(pSyncNode) - 1);
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+
+  // the quorum-th latest ack bounds the lease, not the latest one
+  syncNodeLeaseAck(pSyncNode, &pSyncNode->replicasId[2], now);
+  EXPECT_TRUE(syncNodeLeaseValid(pSyncNode));
+
+  pSyncNode->quorum = 3;
+  EXPECT_FALSE(syncNodeLeaseValid(pSyncNode));
+
+  destroyNode(pSyncNode);
+}
+
+TEST(syncLeaseTest, holdVote) {
+  SSyncNode* pSyncNode = createNode(TAOS_SYNC_STATE_FOLLOWER);
+  SRaftId    candidate = raftId(2);
+  int64_t    now = taosGetMonotonicMs();
+
+  pSyncNode->leaderCache = raftId(1);
+  pSyncNode->leaderContactMs = now;
+  EXPECT_TRUE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+
+  // the known leader itself, e.g. after it restarted
+  EXPECT_FALSE(syncNodeLeaseHoldVote(pSyncNode, &pSyncNode->leaderCache));
+
+  // target of a leader transfer in this term
+  pSyncNode->transferTerm = pSyncNode->pRaftStore->currentTerm;
+  pSyncNode->transferTargetId = candidate;
+  EXPECT_FALSE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+  pSyncNode->transferTerm = pSyncNode->pRaftStore->currentTerm - 1;
+  EXPECT_TRUE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+
+  pSyncNode->leaderContactMs = now - electBaseLine;
+  EXPECT_FALSE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+
+  // restarted without hearing from any leader, the old leader may still be inside its lease
+  pSyncNode->leaderContactMs = 0;
+  pSyncNode->openMs = now;
+  EXPECT_TRUE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+  pSyncNode->openMs = now - electBaseLine;
+  EXPECT_FALSE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+
+  pSyncNode->leaderContactMs = now;
+  pSyncNode->state = TAOS_SYNC_STATE_CANDIDATE;
+  EXPECT_FALSE(syncNodeLeaseHoldVote(pSyncNode, &candidate));
+
+  destroyNode(pSyncNode);
+}
+
+TEST(syncLeaseTest, requestVote) {
+  SSyncNode* pSyncNode = createNode(TAOS_SYNC_STATE_FOLLOWER);
+  int64_t    now = taosGetMonotonicMs();
+  SyncTerm   term = pSyncNode->pRaftStore->currentTerm;
+
+  pSyncNode->leaderCache = raftId(1);
+  pSyncNode->leaderContactMs = now;
+
+  SyncRequestVoteReply* pReply = requestVote(pSyncNode, 2, term);
+  EXPECT_FALSE(pReply->voteGranted);
+  EXPECT_EQ(pReply->term, term);
+  EXPECT_FALSE(raftStoreHasVoted(pSyncNode->pRaftStore));
+  syncRequestVoteReplyDestroy(pReply);
+
+  // lease over, the same candidate gets the vote
+  pSyncNode->leaderContactMs = now - electBaseLine;
+  pReply = requestVote(pSyncNode, 2, term);
+  EXPECT_TRUE(pReply->voteGranted);
+  EXPECT_TRUE(syncUtilSameId(&pSyncNode->pRaftStore->voteFor, &pSyncNode->replicasId[2]));
+  syncRequestVoteReplyDestroy(pReply);
+
+  destroyNode(pSyncNode);
+}
+
+TEST(syncLeaseTest, requestVoteHigherTerm) {
+  SSyncNode* pSyncNode = createNode(TAOS_SYNC_STATE_FOLLOWER);
+  SyncTerm   term = pSyncNode->pRaftStore->currentTerm;
+
+  pSyncNode->leaderCache = raftId(1);
+  pSyncNode->leaderContactMs = taosGetMonotonicMs();
+
+  // the vote is held but the term still moves, the candidate is not stuck in an old term
+  SyncRequestVoteReply* pReply = requestVote(pSyncNode, 2, term + 1);
+  EXPECT_FALSE(pReply->voteGranted);
+  EXPECT_EQ(pReply->term, term + 1);
+  EXPECT_EQ(pSyncNode->pRaftStore->currentTerm, term + 1);
+  syncRequestVoteReplyDestroy(pReply);
+
+  destroyNode(pSyncNode);
+}
+
+TEST(syncLeaseTest, appendEntriesTrailer) {
+  SyncAppendEntries* pMsg = syncAppendEntriesBuild(16, 1);
+  memset(pMsg->data, 'a', pMsg->dataLen);
+  syncAppendEntriesSetLeaseStart(pMsg, 12345);
+
+  SRpcMsg rpcMsg;
+  syncAppendEntries2RpcMsg(pMsg, &rpcMsg);
+  SyncAppendEntries* pMsg2 = syncAppendEntriesFromRpcMsg2(&rpcMsg);
+  EXPECT_EQ(syncAppendEntriesLeaseStart(pMsg2), 12345);
+  EXPECT_EQ(pMsg2->dataLen, 16);
+  EXPECT_EQ(memcmp(pMsg2->data, pMsg->data, pMsg->dataLen), 0);
+  syncAppendEntriesDestroy(pMsg2);
+  rpcFreeCont(rpcMsg.pCont);
+
+  // sent by an older version, no trailer
+  uint32_t bytes = sizeof(SyncAppendEntries) + pMsg->dataLen;
+  char*    buf = (char*)taosMemoryMalloc(bytes);
+  memcpy(buf, pMsg, bytes);
+  ((SyncAppendEntries*)buf)->bytes = bytes;
+  pMsg2 = syncAppendEntriesDeserialize2(buf, bytes);
+  EXPECT_EQ(syncAppendEntriesLeaseStart(pMsg2), 0);
+  EXPECT_EQ(memcmp(pMsg2->data, pMsg->data, pMsg->dataLen), 0);
+  syncAppendEntriesDestroy(pMsg2);
+  taosMemoryFree(buf);
+
+  syncAppendEntriesDestroy(pMsg);
+}
+
+TEST(syncLeaseTest, appendEntriesBatchTrailer) {
+  SSyncRaftEntry* entryPArr[2];
+  for (int32_t i = 0; i < 2; ++i) {
+    entryPArr[i] = syncEntryBuild(8);
+    entryPArr[i]->index = i + 1;
+    memset(entryPArr[i]->data, 'b', entryPArr[i]->dataLen);
+  }
+
+  SyncAppendEntriesBatch* pMsg = syncAppendEntriesBatchBuild(entryPArr, 2, 1);
+  syncAppendEntriesBatchSetLeaseStart(pMsg, 54321);
+
+  SRpcMsg rpcMsg;
+  syncAppendEntriesBatch2RpcMsg(pMsg, &rpcMsg);
+  SyncAppendEntriesBatch* pMsg2 = syncAppendEntriesBatchFromRpcMsg2(&rpcMsg);
+  EXPECT_EQ(syncAppendEntriesBatchLeaseStart(pMsg2), 54321);
+  EXPECT_EQ(pMsg2->dataCount, 2);
+  EXPECT_EQ(memcmp(pMsg2->data, pMsg->data, pMsg->dataLen), 0);
+  syncAppendEntriesBatchDestroy(pMsg2);
+  rpcFreeCont(rpcMsg.pCont);
+
+  uint32_t bytes = sizeof(SyncAppendEntriesBatch) + pMsg->dataLen;
+  char*    buf = (char*)taosMemoryMalloc(bytes);
+  memcpy(buf, pMsg, bytes);
+  ((SyncAppendEntriesBatch*)buf)->bytes = bytes;
+  pMsg2 = syncAppendEntriesBatchDeserialize2(buf, bytes);
+  EXPECT_EQ(syncAppendEntriesBatchLeaseStart(pMsg2), 0);
+  EXPECT_EQ(pMsg2->dataCount, 2);
+  syncAppendEntriesBatchDestroy(pMsg2);
+  taosMemoryFree(buf);
+
+  syncAppendEntriesBatchDestroy(pMsg);
+  for (int32_t i = 0; i < 2; ++i) syncEntryDestory(entryPArr[i]);
+}
+
+TEST(syncLeaseTest, appendEntriesReplyOldLayout) {
+  SyncAppendEntriesReply* pReply = syncAppendEntriesReplyBuild(1);
+  pReply->term = 7;
+  pReply->success = true;
+  pReply->matchIndex = 99;
+  pReply->leaseStartMs = 777;
+
+  uint32_t                len = 0;
+  char*                   buf = syncAppendEntriesReplySerialize2(pReply, &len);
+  SyncAppendEntriesReply* pReply2 = syncAppendEntriesReplyDeserialize2(buf, len);
+  EXPECT_EQ(pReply2->leaseStartMs, 777);
+  EXPECT_EQ(pReply2->matchIndex, 99);
+  syncAppendEntriesReplyDestroy(pReply2);
+
+  // an older version ends before leaseStartMs
+  uint32_t oldLen = offsetof(SyncAppendEntriesReply, leaseStartMs);
+  ((SyncAppendEntriesReply*)buf)->bytes = oldLen;
+  pReply2 = syncAppendEntriesReplyDeserialize2(buf, oldLen);
+  EXPECT_EQ(pReply2->leaseStartMs, 0);
+  EXPECT_EQ(pReply2->term, 7);
+  EXPECT_EQ(pReply2->matchIndex, 99);
+  syncAppendEntriesReplyDestroy(pReply2);
+
+  taosMemoryFree(buf);
+  syncAppendEntriesReplyDestroy(pReply);
+}
+
+TEST(syncStaleReadTest, gate) {
+  SSyncNode* pSyncNode = createNode(TAOS_SYNC_STATE_FOLLOWER);
+  int64_t    now = taosGetMonotonicMs();
+  SyncIndex  readIndex = SYNC_INDEX_INVALID;
+
+  pSyncNode->commitIndex = 42;
+
+  // never heard from a leader since open
+  EXPECT_FALSE(syncNodeIsReadyForStaleRead(pSyncNode, 5000, &readIndex));
+  EXPECT_EQ(readIndex, SYNC_INDEX_INVALID);
+
+  pSyncNode->leaderContactMs = now - 100;
+  EXPECT_TRUE(syncNodeIsReadyForStaleRead(pSyncNode, 5000, &readIndex));
+  EXPECT_EQ(readIndex, 42);
+
+  // staler than the query accepts
+  readIndex = SYNC_INDEX_INVALID;
+  pSyncNode->leaderContactMs = now - 6000;
+  EXPECT_FALSE(syncNodeIsReadyForStaleRead(pSyncNode, 5000, &readIndex));
+  EXPECT_EQ(readIndex, SYNC_INDEX_INVALID);
+
+  pSyncNode->leaderContactMs = now;
+  pSyncNode->state = TAOS_SYNC_STATE_CANDIDATE;
+  EXPECT_FALSE(syncNodeIsReadyForStaleRead(pSyncNode, 5000, &readIndex));
+
+  pSyncNode->state = TAOS_SYNC_STATE_LEADER;
+  pSyncNode->leaderContactMs = 0;
+  EXPECT_TRUE(syncNodeIsReadyForStaleRead(pSyncNode, 5000, &readIndex));
+  EXPECT_EQ(readIndex, 42);
+
+  destroyNode(pSyncNode);
+}
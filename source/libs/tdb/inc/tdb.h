@@ -29,6 +29,8 @@ typedef struct STDB TDB;
 typedef struct STTB TTB;
 typedef struct STBC TBC;
 typedef struct STxn TXN;
+typedef struct STBL TBL;
+typedef struct STdbSnap TSNAP;
 
 // TDB
 int32_t tdbOpen(const char *dbname, int szPage, int pages, TDB **ppDb);
@@ -37,6 +39,30 @@ int32_t tdbBegin(TDB *pDb, TXN *pTxn);
 int32_t tdbCommit(TDB *pDb, TXN *pTxn);
 int32_t tdbAbort(TDB *pDb, TXN *pTxn);
 
+// journal mode, to be changed between transactions
+#define TDB_JOURNAL_MODE_ROLLBACK 0
+#define TDB_JOURNAL_MODE_WAL      1
+
+int32_t tdbSetJournalMode(TDB *pDb, int8_t mode);
+// read pages missing from the page cache out of a read-only mapping of the db files instead of pread, to be set
+// before any reader is running
+int32_t tdbSetMmapRead(TDB *pDb, bool enable);
+// snapshot reads, to be set before any reader is running: readers see the pages as of the last tdbPublish() and never
+// wait for the writer, nor does the writer wait for them. tdbReadBegin() pins one snapshot for all reads of the calling
+// thread until tdbReadEnd(), a cursor pins its own one. An object that outlives the read section pins a snapshot by
+// tdbSnapOpen(), to be closed from any thread, and reads it between tdbReadBeginAt() and tdbReadEnd().
+int32_t tdbSetSnapshotRead(TDB *pDb, bool enable);
+void    tdbReadBegin(TDB *pDb);
+void    tdbReadBeginAt(TDB *pDb, TSNAP *pSnap);
+void    tdbReadEnd(TDB *pDb);
+bool    tdbInRead(TDB *pDb);
+bool    tdbReadIsLatest(TDB *pDb);
+void    tdbPublish(TDB *pDb);
+int32_t tdbSnapOpen(TDB *pDb, TSNAP **ppSnap);
+void    tdbSnapClose(TSNAP *pSnap);
+int32_t tdbCheckpoint(TDB *pDb);
+bool    tdbNeedCheckpoint(TDB *pDb);
+
 // TTB
 int32_t tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprFn, TDB *pEnv, TTB **ppTb);
 int32_t tdbTbClose(TTB *pTb);
@@ -46,6 +72,13 @@ int32_t tdbTbDelete(TTB *pTb, const void *pKey, int kLen, TXN *pTxn);
 int32_t tdbTbUpsert(TTB *pTb, const void *pKey, int kLen, const void *pVal, int vLen, TXN *pTxn);
 int32_t tdbTbGet(TTB *pTb, const void *pKey, int kLen, void **ppVal, int *vLen);
 int32_t tdbTbPGet(TTB *pTb, const void *pKey, int kLen, void **ppKey, int *pkLen, void **ppVal, int *vLen);
+int32_t tdbTbCmpr(TTB *pTb, const void *pKey1, int kLen1, const void *pKey2, int kLen2);
+
+// TBL, bulk load of records in key order. The tree is built bottom-up with pages filled to fillFactor percent when it
+// is empty, otherwise or once a key is out of order the records are upserted.
+int32_t tdbTbBulkOpen(TTB *pTb, int fillFactor, TXN *pTxn, TBL **ppTbl);
+int32_t tdbTbBulkPut(TBL *pTbl, const void *pKey, int kLen, const void *pVal, int vLen);
+int32_t tdbTbBulkClose(TBL *pTbl);
 
 // TBC
 int32_t tdbTbcOpen(TTB *pTb, TBC **ppTbc, TXN *pTxn);
@@ -79,6 +112,8 @@ struct STxn {
   void *(*xMalloc)(void *, size_t);
   void (*xFree)(void *, void *);
   void *xArg;
+  // epoch of the snapshot a reader sees, 0 to read the latest pages
+  int64_t snapshot;
 };
 
 // error code
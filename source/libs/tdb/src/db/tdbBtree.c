@@ -18,6 +18,9 @@
 #define TDB_BTREE_ROOT 0x1
 #define TDB_BTREE_LEAF 0x2
 #define TDB_BTREE_OVFL 0x4
+#define TDB_BTREE_PFX  0x8  // page format with key prefix compression
+
+#define TDB_BTREE_MAX_PFX 64
 
 struct SBTree {
   SPgno         root;
@@ -30,6 +33,10 @@ struct SBTree {
   int           minLocal;
   int           maxLeaf;
   int           minLeaf;
+  int           maxLocalPfx;
+  int           minLocalPfx;
+  int           maxLeafPfx;
+  int           minLeafPfx;
   SBtInfo       info;
   char         *tbname;
   void         *pBuf;
@@ -42,6 +49,7 @@ struct SBTree {
 #define TDB_BTREE_PAGE_IS_ROOT(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_ROOT)
 #define TDB_BTREE_PAGE_IS_LEAF(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_LEAF)
 #define TDB_BTREE_PAGE_IS_OVFL(PAGE)          (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_OVFL)
+#define TDB_BTREE_PAGE_IS_PFX(PAGE)           (TDB_BTREE_PAGE_GET_FLAGS(PAGE) & TDB_BTREE_PFX)
 #define TDB_BTREE_ASSERT_FLAG(flags)                                                     \
   ASSERT(TDB_FLAG_IS(flags, TDB_BTREE_ROOT) || TDB_FLAG_IS(flags, TDB_BTREE_LEAF) ||     \
          TDB_FLAG_IS(flags, TDB_BTREE_ROOT | TDB_BTREE_LEAF) || TDB_FLAG_IS(flags, 0) || \
@@ -58,6 +66,32 @@ typedef struct {
 } SIntHdr;
 #pragma pack(pop)
 
+#define TDB_BTREE_HDR_SIZE(flags) (((flags)&TDB_BTREE_LEAF) ? sizeof(SLeafHdr) : sizeof(SIntHdr))
+
+/*
+ * Pages with TDB_BTREE_PFX set store a key prefix right after the page header:
+ *
+ *   | SLeafHdr/SIntHdr | nPfx (u8) | prefix (nPfx bytes) |
+ *
+ * and each cell carries one more header byte after the child pgno, the number of leading key bytes shared with the
+ * page prefix (nShared). Only the remaining key bytes are stored in the cell. A cell with nShared > 0 is always kept
+ * local, so the shared bytes never need to be stitched with bytes on overflow pages.
+ */
+static inline u8 *tdbBtreePagePfx(const SPage *pPage, int *nPfx) {
+  u8 *p = pPage->pData + TDB_BTREE_HDR_SIZE(TDB_BTREE_PAGE_GET_FLAGS(pPage));
+
+  *nPfx = p[0];
+  return p + 1;
+}
+
+static inline int tdbBtreeCommonPfx(const u8 *p1, int n1, const u8 *p2, int n2) {
+  int n = n1 < n2 ? n1 : n2;
+  int i = 0;
+
+  while (i < n && p1[i] == p2[i]) i++;
+  return i;
+}
+
 static int tdbDefaultKeyCmprFn(const void *pKey1, int keyLen1, const void *pKey2, int keyLen2);
 static int tdbBtreeOpenImpl(SBTree *pBt);
 // static int tdbBtreeInitPage(SPage *pPage, void *arg, int init);
@@ -66,6 +100,7 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
 static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pDecoder, TXN *pTxn, SBTree *pBt);
 static int tdbBtreeBalance(SBTC *pBtc);
 static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *pTxn, SBTree *pBt);
+static int tdbBtreeCellIsLocal(const SPage *pPage, const SCell *pCell);
 static int tdbBtcMoveDownward(SBTC *pBtc);
 static int tdbBtcMoveUpward(SBTC *pBtc);
 
@@ -101,6 +136,11 @@ int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPg
   pBt->maxLeaf = tdbPageCapacity(pBt->pageSize, sizeof(SLeafHdr));
   // pBt->minLeaf
   pBt->minLeaf = pBt->minLocal;
+  // prefix compressed pages leave room for the largest page prefix in the header
+  pBt->maxLocalPfx = tdbPageCapacity(pBt->pageSize, sizeof(SIntHdr) + 1 + TDB_BTREE_MAX_PFX) / 4;
+  pBt->minLocalPfx = pBt->maxLocalPfx / 2;
+  pBt->maxLeafPfx = tdbPageCapacity(pBt->pageSize, sizeof(SLeafHdr) + 1 + TDB_BTREE_MAX_PFX);
+  pBt->minLeafPfx = pBt->minLocalPfx;
 
   // if pgno == 0 fetch new btree root leaf page
   if (pgno == 0) {
@@ -111,8 +151,8 @@ int tdbBtreeOpen(int keyLen, int valLen, SPager *pPager, char const *tbname, SPg
 
     pPager->inTran = 1;
 
-    SBtreeInitPageArg zArg;
-    zArg.flags = 0x1 | 0x2;  // root leaf node;
+    SBtreeInitPageArg zArg = {0};
+    zArg.flags = TDB_BTREE_ROOT | TDB_BTREE_LEAF | TDB_BTREE_PFX;  // root leaf node;
     zArg.pBt = pBt;
     ret = tdbPagerFetchPage(pPager, &pgno, &pPage, tdbBtreeInitPage, &zArg, &txn);
     if (ret < 0) {
@@ -344,6 +384,8 @@ int tdbBtreePGet(SBTree *pBt, const void *pKey, int kLen, void **ppKey, int *pkL
     tdbFree(cd.pVal);
   }
 
+  tdbFree(cd.pBuf);
+
   tdbTrace("tdb pget end, btc decoder: %p/0x%x, local decoder:%p", &btc.coder, btc.coder.freeKV, &cd);
 
   tdbBtcClose(&btc);
@@ -401,26 +443,48 @@ static int tdbBtreeOpenImpl(SBTree *pBt) {
 }
 
 int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
-  SBTree *pBt;
-  u8      flags;
-  u8      leaf;
+  SBtreeInitPageArg *pArg;
+  SBTree            *pBt;
+  u8                 flags;
+  u8                 leaf;
+  u8                 pfx;
+  int                szAmHdr;
 
-  pBt = ((SBtreeInitPageArg *)arg)->pBt;
+  pArg = (SBtreeInitPageArg *)arg;
+  pBt = pArg->pBt;
 
   if (init) {
     // init page
     flags = TDB_BTREE_PAGE_GET_FLAGS(pPage);
     leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
-    TDB_BTREE_ASSERT_FLAG(flags);
+    pfx = TDB_BTREE_PAGE_IS_PFX(pPage);
+    TDB_BTREE_ASSERT_FLAG(TDB_FLAG_REMOVE(flags, TDB_BTREE_PFX));
+
+    szAmHdr = TDB_BTREE_HDR_SIZE(flags);
+    if (pfx) {
+      szAmHdr += 1 + pPage->pData[szAmHdr];
+    }
 
-    tdbPageInit(pPage, leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr), tdbBtreeCellSize);
+    tdbPageInit(pPage, szAmHdr, tdbBtreeCellSize);
   } else {
     // zero page
-    flags = ((SBtreeInitPageArg *)arg)->flags;
+    flags = pArg->flags;
     leaf = flags & TDB_BTREE_LEAF;
-    TDB_BTREE_ASSERT_FLAG(flags);
+    pfx = flags & TDB_BTREE_PFX;
+    TDB_BTREE_ASSERT_FLAG(TDB_FLAG_REMOVE(flags, TDB_BTREE_PFX));
 
-    tdbPageZero(pPage, leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr), tdbBtreeCellSize);
+    szAmHdr = TDB_BTREE_HDR_SIZE(flags);
+    if (pfx) {
+      ASSERT(pArg->nPfx >= 0 && pArg->nPfx <= TDB_BTREE_MAX_PFX);
+
+      pPage->pData[szAmHdr] = pArg->nPfx;
+      if (pArg->nPfx > 0) {
+        memcpy(pPage->pData + szAmHdr + 1, pArg->pPfx, pArg->nPfx);
+      }
+      szAmHdr += 1 + pArg->nPfx;
+    }
+
+    tdbPageZero(pPage, szAmHdr, tdbBtreeCellSize);
 
     if (leaf) {
       SLeafHdr *pLeafHdr = (SLeafHdr *)(pPage->pData);
@@ -436,8 +500,8 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
   if (leaf) {
     pPage->kLen = pBt->keyLen;
     pPage->vLen = pBt->valLen;
-    pPage->maxLocal = pBt->maxLeaf;
-    pPage->minLocal = pBt->minLeaf;
+    pPage->maxLocal = pfx ? pBt->maxLeafPfx : pBt->maxLeaf;
+    pPage->minLocal = pfx ? pBt->minLeafPfx : pBt->minLeaf;
   } else if (TDB_BTREE_PAGE_IS_OVFL(pPage)) {
     pPage->kLen = pBt->keyLen;
     pPage->vLen = pBt->valLen;
@@ -446,8 +510,8 @@ int tdbBtreeInitPage(SPage *pPage, void *arg, int init) {
   } else {
     pPage->kLen = pBt->keyLen;
     pPage->vLen = sizeof(SPgno);
-    pPage->maxLocal = pBt->maxLocal;
-    pPage->minLocal = pBt->minLocal;
+    pPage->maxLocal = pfx ? pBt->maxLocalPfx : pBt->maxLocal;
+    pPage->minLocal = pfx ? pBt->minLocalPfx : pBt->minLocal;
   }
 
   return 0;
@@ -461,17 +525,20 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   int               ret;
   u8                flags;
   SIntHdr          *pIntHdr;
-  SBtreeInitPageArg zArg;
+  SBtreeInitPageArg zArg = {0};
   u8                leaf;
 
   pPager = pRoot->pPager;
   flags = TDB_BTREE_PAGE_GET_FLAGS(pRoot);
   leaf = TDB_BTREE_PAGE_IS_LEAF(pRoot);
 
-  // allocate a new child page
+  // allocate a new child page, the child takes over the root cells along with the page prefix
   pgnoChild = 0;
   zArg.flags = TDB_FLAG_REMOVE(flags, TDB_BTREE_ROOT);
   zArg.pBt = pBt;
+  if (TDB_BTREE_PAGE_IS_PFX(pRoot)) {
+    zArg.pPfx = tdbBtreePagePfx(pRoot, &zArg.nPfx);
+  }
   ret = tdbPagerFetchPage(pPager, &pgnoChild, &pChild, tdbBtreeInitPage, &zArg, pTxn);
   if (ret < 0) {
     return -1;
@@ -492,8 +559,10 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   tdbPageCopy(pRoot, pChild, 0);
 
   // Reinitialize the root page
-  zArg.flags = TDB_BTREE_ROOT;
+  zArg.flags = TDB_BTREE_ROOT | (flags & TDB_BTREE_PFX);
   zArg.pBt = pBt;
+  zArg.pPfx = NULL;
+  zArg.nPfx = 0;
   ret = tdbBtreeInitPage(pRoot, &zArg, 0);
   if (ret < 0) {
     return -1;
@@ -506,6 +575,56 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   return 0;
 }
 
+// Copy an interior cell of pFrom for insertion into pTo with child pgno. Cells sharing bytes with the page prefix of
+// pFrom are re-encoded, other cells do not depend on the page they live on.
+static int tdbBtreeMoveIntCell(SPage *pFrom, SCell *pCell, int szCell, SPage *pTo, SPgno pgno, SCell **ppCell,
+                               int *szNewCell, TXN *pTxn, SBTree *pBt) {
+  SCellDecoder cd = {0};
+  SCell       *pNewCell;
+
+  if (!TDB_BTREE_PAGE_IS_PFX(pFrom) || pCell[sizeof(SPgno)] == 0) {
+    pNewCell = tdbOsMalloc(szCell);
+    if (pNewCell == NULL) {
+      return -1;
+    }
+
+    memcpy(pNewCell, pCell, szCell);
+    ((SPgno *)pNewCell)[0] = pgno;
+    *szNewCell = szCell;
+  } else {
+    if (tdbBtreeDecodeCell(pFrom, pCell, &cd, pTxn, pBt) < 0) {
+      tdbFree(cd.pBuf);
+      return -1;
+    }
+
+    pNewCell = tdbOsMalloc(cd.kLen + 10);
+    if (pNewCell == NULL) {
+      tdbFree(cd.pBuf);
+      return -1;
+    }
+
+    tdbBtreeEncodeCell(pTo, cd.pKey, cd.kLen, &pgno, sizeof(pgno), pNewCell, szNewCell, pTxn, pBt);
+    tdbFree(cd.pBuf);
+  }
+
+  *ppCell = pNewCell;
+  return 0;
+}
+
+// Length of the shortest prefix of the right key which still sorts after the left key, so it can divide the two
+// pages. Only variable length keys under the bytewise default comparator allow to cut a divider key this way.
+static int tdbBtreeSeparatorLen(SBTree *pBt, const u8 *pLKey, int lLen, const u8 *pRKey, int rLen) {
+  int n;
+
+  if (pBt->kcmpr != tdbDefaultKeyCmprFn || pBt->keyLen != TDB_VARIANT_LEN) {
+    return -1;
+  }
+
+  // keep the left key as divider unless the cut one is shorter
+  n = tdbBtreeCommonPfx(pLKey, lLen, pRKey, rLen) + 1;
+  return n < rLen && n < lLen ? n : -1;
+}
+
 static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTxn) {
   int ret;
 
@@ -516,6 +635,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
   int    sIdx;
   u8     childNotLeaf;
   SPgno  rPgno;
+  u8     flags;
 
   {  // Find 3 child pages at most to do balance
     int    nCells = TDB_PAGE_TOTAL_CELLS(pParent);
@@ -573,9 +693,19 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
         }
 
         if (i < nOlds - 1) {
-          ((SPgno *)pDivCell[i])[0] = ((SIntHdr *)pOlds[i]->pData)->pgno;
+          SCell *pNewCell;
+          int    szNewCell;
+
+          ret = tdbBtreeMoveIntCell(pParent, pDivCell[i], szDivCell[i], pOlds[i], ((SIntHdr *)pOlds[i]->pData)->pgno,
+                                    &pNewCell, &szNewCell, pTxn, pBt);
+          if (ret < 0) {
+            ASSERT(0);
+            return -1;
+          }
+
           ((SIntHdr *)pOlds[i]->pData)->pgno = 0;
-          tdbPageInsertCell(pOlds[i], TDB_PAGE_TOTAL_CELLS(pOlds[i]), pDivCell[i], szDivCell[i], 1);
+          tdbPageInsertCell(pOlds[i], TDB_PAGE_TOTAL_CELLS(pOlds[i]), pNewCell, szNewCell, 1);
+          tdbOsFree(pNewCell);
         }
       }
       rPgno = ((SIntHdr *)pOlds[nOlds - 1]->pData)->pgno;
@@ -599,76 +729,127 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     }
   }
 
+  flags = TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]);
+
+  int     nCells = 0;
+  SCell **apCell = NULL;
+  int    *aszCell = NULL;
+  u8     *pArena = NULL;
+  SPage  *pTmpl = NULL;
+  u8      aPfx[TDB_BTREE_MAX_PFX];
+  int     nPfx = 0;
+  {
+    // Gather the cells to distribute. On prefix compressed pages the new pages share the longest common prefix of
+    // the local cells, and the local cells are re-encoded against it. pTmpl is a scratch page in the new layout.
+    SCellDecoder cd = {0};
+    SCell       *pCell;
+    int          szArena = 0;
+    int          hasPfx = 0;
+    u8          *pPos;
+
+    for (int i = 0; i < nOlds; i++) {
+      for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pOlds[i]); oIdx++) {
+        pCell = tdbPageGetCell(pOlds[i], oIdx);
+        szArena += tdbBtreeCellSize(pOlds[i], pCell, 0, NULL, NULL);
+        nCells++;
+
+        if (TDB_BTREE_PAGE_IS_PFX(pOlds[i]) && tdbBtreeCellIsLocal(pOlds[i], pCell)) {
+          tdbBtreeDecodeCell(pOlds[i], pCell, &cd, pTxn, pBt);
+          if (!hasPfx) {
+            nPfx = cd.kLen < TDB_BTREE_MAX_PFX ? cd.kLen : TDB_BTREE_MAX_PFX;
+            memcpy(aPfx, cd.pKey, nPfx);
+            hasPfx = 1;
+          } else {
+            nPfx = tdbBtreeCommonPfx(aPfx, nPfx, cd.pKey, cd.kLen);
+          }
+        }
+      }
+    }
+
+    // a re-encoded cell grows by the bytes it shared with the old page prefix at most
+    szArena += nCells * (TDB_BTREE_MAX_PFX + 10);
+    apCell = tdbOsMalloc(sizeof(SCell *) * nCells);
+    aszCell = tdbOsMalloc(sizeof(int) * nCells);
+    pArena = tdbOsMalloc(szArena);
+    if (apCell == NULL || aszCell == NULL || pArena == NULL ||
+        tdbPageCreate(pOlds[0]->pageSize, &pTmpl, tdbDefaultMalloc, NULL) < 0) {
+      ASSERT(0);
+      return -1;
+    }
+    tdbBtreeInitPage(pTmpl, &((SBtreeInitPageArg){.pBt = pBt, .flags = flags, .pPfx = aPfx, .nPfx = nPfx}), 0);
+
+    pPos = pArena;
+    nCells = 0;
+    for (int i = 0; i < nOlds; i++) {
+      for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pOlds[i]); oIdx++) {
+        pCell = tdbPageGetCell(pOlds[i], oIdx);
+
+        if (TDB_BTREE_PAGE_IS_PFX(pOlds[i]) && tdbBtreeCellIsLocal(pOlds[i], pCell)) {
+          tdbBtreeDecodeCell(pOlds[i], pCell, &cd, pTxn, pBt);
+          tdbBtreeEncodeCell(pTmpl, cd.pKey, cd.kLen, cd.pVal, cd.vLen, pPos, &aszCell[nCells], pTxn, pBt);
+        } else {
+          aszCell[nCells] = tdbBtreeCellSize(pOlds[i], pCell, 0, NULL, NULL);
+          memcpy(pPos, pCell, aszCell[nCells]);
+        }
+
+        apCell[nCells] = pPos;
+        pPos += aszCell[nCells];
+        nCells++;
+      }
+
+      // all cells are copied out, free the overflow cells of the old page
+      for (int iOvfl = 0; iOvfl < pOlds[i]->nOverflow; iOvfl++) {
+        tdbOsFree(pOlds[i]->apOvfl[iOvfl]);
+      }
+      pOlds[i]->nOverflow = 0;
+    }
+
+    tdbFree(cd.pBuf);
+  }
+
   int nNews = 0;
   struct {
     int cnt;
     int size;
-    int iPage;
-    int oIdx;
+    int iCell;
   } infoNews[5] = {0};
 
   {  // Get how many new pages are needed and the new distribution
 
     // first loop to find minimum number of pages needed
-    for (int oPage = 0; oPage < nOlds; oPage++) {
-      SPage *pPage = pOlds[oPage];
-      SCell *pCell;
-      int    cellBytes;
-      int    oIdx;
-
-      for (oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++) {
-        pCell = tdbPageGetCell(pPage, oIdx);
-        cellBytes = TDB_BYTES_CELL_TAKEN(pPage, pCell);
-
-        if (infoNews[nNews].size + cellBytes > TDB_PAGE_USABLE_SIZE(pPage)) {
-          // page is full, use a new page
-          nNews++;
-
-          ASSERT(infoNews[nNews].size + cellBytes <= TDB_PAGE_USABLE_SIZE(pPage));
-
-          if (childNotLeaf) {
-            // for non-child page, this cell is used as the right-most child,
-            // the divider cell to parent as well
-            continue;
-          }
+    for (int iCell = 0; iCell < nCells; iCell++) {
+      int cellBytes = aszCell[iCell] + TDB_PAGE_OFFSET_SIZE(pTmpl);
+
+      if (infoNews[nNews].size + cellBytes > TDB_PAGE_USABLE_SIZE(pTmpl)) {
+        // page is full, use a new page
+        nNews++;
+
+        ASSERT(infoNews[nNews].size + cellBytes <= TDB_PAGE_USABLE_SIZE(pTmpl));
+
+        if (childNotLeaf) {
+          // for non-child page, this cell is used as the right-most child,
+          // the divider cell to parent as well
+          continue;
         }
-        infoNews[nNews].cnt++;
-        infoNews[nNews].size += cellBytes;
-        infoNews[nNews].iPage = oPage;
-        infoNews[nNews].oIdx = oIdx;
       }
+      infoNews[nNews].cnt++;
+      infoNews[nNews].size += cellBytes;
+      infoNews[nNews].iCell = iCell;
     }
 
     nNews++;
 
     // back loop to make the distribution even
     for (int iNew = nNews - 1; iNew > 0; iNew--) {
-      SCell *pCell;
-      int    szLCell, szRCell;
+      int szLCell, szRCell;
 
       // balance page (iNew) and (iNew-1)
       for (;;) {
-        pCell = tdbPageGetCell(pOlds[infoNews[iNew - 1].iPage], infoNews[iNew - 1].oIdx);
-
-        szLCell = tdbBtreeCellSize(pOlds[infoNews[iNew - 1].iPage], pCell, 0, NULL, NULL);
+        szLCell = aszCell[infoNews[iNew - 1].iCell];
         if (!childNotLeaf) {
           szRCell = szLCell;
         } else {
-          int    iPage = infoNews[iNew - 1].iPage;
-          int    oIdx = infoNews[iNew - 1].oIdx + 1;
-          SPage *pPage;
-          for (;;) {
-            pPage = pOlds[iPage];
-            if (oIdx < TDB_PAGE_TOTAL_CELLS(pPage)) {
-              break;
-            }
-
-            iPage++;
-            oIdx = 0;
-          }
-
-          pCell = tdbPageGetCell(pPage, oIdx);
-          szRCell = tdbBtreeCellSize(pPage, pCell, 0, NULL, NULL);
+          szRCell = aszCell[infoNews[iNew - 1].iCell + 1];
         }
 
         ASSERT(infoNews[iNew - 1].cnt > 0);
@@ -680,15 +861,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
         // Move a cell right forward
         infoNews[iNew - 1].cnt--;
         infoNews[iNew - 1].size -= szLCell;
-        infoNews[iNew - 1].oIdx--;
-        for (;;) {
-          if (infoNews[iNew - 1].oIdx >= 0) {
-            break;
-          }
-
-          infoNews[iNew - 1].iPage--;
-          infoNews[iNew - 1].oIdx = TDB_PAGE_TOTAL_CELLS(pOlds[infoNews[iNew - 1].iPage]) - 1;
-        }
+        infoNews[iNew - 1].iCell--;
 
         infoNews[iNew].cnt++;
         infoNews[iNew].size += szRCell;
@@ -700,10 +873,7 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
   {  // Allocate new pages, reuse the old page when possible
 
     SPgno             pgno;
-    SBtreeInitPageArg iarg;
-    u8                flags;
-
-    flags = TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]);
+    SBtreeInitPageArg iarg = {0};
 
     for (int iNew = 0; iNew < nNews; iNew++) {
       if (iNew < nOlds) {
@@ -730,83 +900,85 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
   }
 
   {  // Do the real cell distribution
-    SPage            *pOldsCopy[3] = {0};
     SCell            *pCell;
     int               szCell;
     SBtreeInitPageArg iarg;
     int               iNew, nNewCells;
     SCellDecoder      cd = {0};
+    SCellDecoder      rcd = {0};
 
     iarg.pBt = pBt;
-    iarg.flags = TDB_BTREE_PAGE_GET_FLAGS(pOlds[0]);
-    for (int i = 0; i < nOlds; i++) {
-      tdbPageCreate(pOlds[0]->pageSize, &pOldsCopy[i], tdbDefaultMalloc, NULL);
-      tdbBtreeInitPage(pOldsCopy[i], &iarg, 0);
-      tdbPageCopy(pOlds[i], pOldsCopy[i], 0);
-    }
+    iarg.flags = flags;
+    iarg.pPfx = aPfx;
+    iarg.nPfx = nPfx;
     iNew = 0;
     nNewCells = 0;
     tdbBtreeInitPage(pNews[iNew], &iarg, 0);
 
-    for (int iOld = 0; iOld < nOlds; iOld++) {
-      SPage *pPage;
-
-      pPage = pOldsCopy[iOld];
+    for (int iCell = 0; iCell < nCells; iCell++) {
+      pCell = apCell[iCell];
+      szCell = aszCell[iCell];
 
-      for (int oIdx = 0; oIdx < TDB_PAGE_TOTAL_CELLS(pPage); oIdx++) {
-        pCell = tdbPageGetCell(pPage, oIdx);
-        szCell = tdbBtreeCellSize(pPage, pCell, 0, NULL, NULL);
+      ASSERT(nNewCells <= infoNews[iNew].cnt);
+      ASSERT(iNew < nNews);
 
-        ASSERT(nNewCells <= infoNews[iNew].cnt);
-        ASSERT(iNew < nNews);
+      if (nNewCells < infoNews[iNew].cnt) {
+        tdbPageInsertCell(pNews[iNew], nNewCells, pCell, szCell, 0);
+        nNewCells++;
 
-        if (nNewCells < infoNews[iNew].cnt) {
-          tdbPageInsertCell(pNews[iNew], nNewCells, pCell, szCell, 0);
-          nNewCells++;
+        // insert parent page
+        if (!childNotLeaf && nNewCells == infoNews[iNew].cnt) {
+          SIntHdr *pIntHdr = (SIntHdr *)pParent->pData;
 
-          // insert parent page
-          if (!childNotLeaf && nNewCells == infoNews[iNew].cnt) {
-            SIntHdr *pIntHdr = (SIntHdr *)pParent->pData;
+          if (iNew == nNews - 1 && pIntHdr->pgno == 0) {
+            pIntHdr->pgno = TDB_PAGE_PGNO(pNews[iNew]);
+          } else {
+            const u8 *pKey;
+            int       kLen;
 
-            if (iNew == nNews - 1 && pIntHdr->pgno == 0) {
-              pIntHdr->pgno = TDB_PAGE_PGNO(pNews[iNew]);
-            } else {
-              tdbBtreeDecodeCell(pPage, pCell, &cd, pTxn, pBt);
+            tdbBtreeDecodeCell(pTmpl, pCell, &cd, pTxn, pBt);
+            pKey = cd.pKey;
+            kLen = cd.kLen;
 
-              // TODO: pCell here may be inserted as an overflow cell, handle it
-              SCell *pNewCell = tdbOsMalloc(cd.kLen + 9);
-              int    szNewCell;
-              SPgno  pgno;
-              pgno = TDB_PAGE_PGNO(pNews[iNew]);
-              tdbBtreeEncodeCell(pParent, cd.pKey, cd.kLen, (void *)&pgno, sizeof(SPgno), pNewCell, &szNewCell, pTxn,
-                                 pBt);
-              tdbPageInsertCell(pParent, sIdx++, pNewCell, szNewCell, 0);
-              tdbOsFree(pNewCell);
+            // cut the divider short when the first key of the next page allows
+            if (iCell + 1 < nCells) {
+              tdbBtreeDecodeCell(pTmpl, apCell[iCell + 1], &rcd, pTxn, pBt);
 
-              if (TDB_CELLDECODER_FREE_VAL(&cd)) {
-                tdbFree(cd.pVal);
-                cd.pVal = NULL;
+              int n = tdbBtreeSeparatorLen(pBt, cd.pKey, cd.kLen, rcd.pKey, rcd.kLen);
+              if (n > 0) {
+                pKey = rcd.pKey;
+                kLen = n;
               }
             }
 
-            // move to next new page
-            iNew++;
-            nNewCells = 0;
-            if (iNew < nNews) {
-              tdbBtreeInitPage(pNews[iNew], &iarg, 0);
+            // TODO: pCell here may be inserted as an overflow cell, handle it
+            SCell *pNewCell = tdbOsMalloc(kLen + 10);
+            int    szNewCell;
+            SPgno  pgno;
+            pgno = TDB_PAGE_PGNO(pNews[iNew]);
+            tdbBtreeEncodeCell(pParent, pKey, kLen, (void *)&pgno, sizeof(SPgno), pNewCell, &szNewCell, pTxn, pBt);
+            tdbPageInsertCell(pParent, sIdx++, pNewCell, szNewCell, 0);
+            tdbOsFree(pNewCell);
+
+            if (TDB_CELLDECODER_FREE_KEY(&cd)) {
+              tdbFree(cd.pKey);
+              cd.pKey = NULL;
+            }
+            if (TDB_CELLDECODER_FREE_VAL(&cd)) {
+              tdbFree(cd.pVal);
+              cd.pVal = NULL;
+            }
+            TDB_CELLDECODER_SET_FREE_NIL(&cd);
+            if (TDB_CELLDECODER_FREE_KEY(&rcd)) {
+              tdbFree(rcd.pKey);
+              rcd.pKey = NULL;
             }
+            if (TDB_CELLDECODER_FREE_VAL(&rcd)) {
+              tdbFree(rcd.pVal);
+              rcd.pVal = NULL;
+            }
+            TDB_CELLDECODER_SET_FREE_NIL(&rcd);
           }
-        } else {
-          ASSERT(childNotLeaf);
-          ASSERT(iNew < nNews - 1);
-
-          // set current new page right-most child
-          ((SIntHdr *)pNews[iNew]->pData)->pgno = ((SPgno *)pCell)[0];
-
-          // insert to parent as divider cell
-          ASSERT(iNew < nNews - 1);
-          ((SPgno *)pCell)[0] = TDB_PAGE_PGNO(pNews[iNew]);
-          tdbPageInsertCell(pParent, sIdx++, pCell, szCell, 0);
 
           // move to next new page
           iNew++;
@@ -815,6 +987,33 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
             tdbBtreeInitPage(pNews[iNew], &iarg, 0);
           }
         }
+      } else {
+        ASSERT(childNotLeaf);
+        ASSERT(iNew < nNews - 1);
+
+        SCell *pNewCell;
+        int    szNewCell;
+
+        // set current new page right-most child
+        ((SIntHdr *)pNews[iNew]->pData)->pgno = ((SPgno *)pCell)[0];
+
+        // insert to parent as divider cell
+        ASSERT(iNew < nNews - 1);
+        ret = tdbBtreeMoveIntCell(pTmpl, pCell, szCell, pParent, TDB_PAGE_PGNO(pNews[iNew]), &pNewCell, &szNewCell,
+                                  pTxn, pBt);
+        if (ret < 0) {
+          ASSERT(0);
+          return -1;
+        }
+        tdbPageInsertCell(pParent, sIdx++, pNewCell, szNewCell, 0);
+        tdbOsFree(pNewCell);
+
+        // move to next new page
+        iNew++;
+        nNewCells = 0;
+        if (iNew < nNews) {
+          tdbBtreeInitPage(pNews[iNew], &iarg, 0);
+        }
       }
     }
 
@@ -831,15 +1030,14 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
       }
     }
 
-    for (int i = 0; i < nOlds; i++) {
-      tdbPageDestroy(pOldsCopy[i], tdbDefaultFree, NULL);
-    }
+    tdbFree(cd.pBuf);
+    tdbFree(rcd.pBuf);
   }
 
   if (TDB_BTREE_PAGE_IS_ROOT(pParent) && TDB_PAGE_TOTAL_CELLS(pParent) == 0) {
-    i8 flags = TDB_BTREE_ROOT | TDB_BTREE_PAGE_IS_LEAF(pNews[0]);
+    i8 flags = TDB_BTREE_ROOT | TDB_BTREE_PAGE_IS_LEAF(pNews[0]) | TDB_BTREE_PAGE_IS_PFX(pNews[0]);
     // copy content to the parent page
-    tdbBtreeInitPage(pParent, &(SBtreeInitPageArg){.flags = flags, .pBt = pBt}, 0);
+    tdbBtreeInitPage(pParent, &(SBtreeInitPageArg){.flags = flags, .pBt = pBt, .pPfx = aPfx, .nPfx = nPfx}, 0);
     tdbPageCopy(pNews[0], pParent, 1);
 
     if (!TDB_BTREE_PAGE_IS_LEAF(pNews[0])) {
@@ -853,6 +1051,11 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     }
   }
 
+  tdbOsFree(apCell);
+  tdbOsFree(aszCell);
+  tdbOsFree(pArena);
+  tdbPageDestroy(pTmpl, tdbDefaultFree, NULL);
+
   for (pageIdx = 0; pageIdx < nOlds; ++pageIdx) {
     tdbPagerReturnPage(pBt->pPager, pOlds[pageIdx], pTxn);
   }
@@ -1163,6 +1366,7 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
   u8  leaf;
   int nHeader;
   int nPayload;
+  int nShared;
   int ret;
 
   ASSERT(pPage->kLen == TDB_VARIANT_LEN || pPage->kLen == kLen);
@@ -1171,25 +1375,49 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
 
   nPayload = 0;
   nHeader = 0;
+  nShared = 0;
   leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
 
-  // 1. Encode Header part
-  /* Encode SPgno if interior page */
-  if (!leaf) {
-    ASSERT(pPage->vLen == sizeof(SPgno));
+  if (TDB_BTREE_PAGE_IS_PFX(pPage)) {
+    int nPfx;
+    u8 *pPfx = tdbBtreePagePfx(pPage, &nPfx);
 
-    ((SPgno *)(pCell + nHeader))[0] = ((SPgno *)pVal)[0];
-    nHeader = nHeader + sizeof(SPgno);
+    nShared = tdbBtreeCommonPfx(pKey, kLen, pPfx, nPfx);
   }
 
-  /* Encode kLen if need */
-  if (pPage->kLen == TDB_VARIANT_LEN) {
-    nHeader += tdbPutVarInt(pCell + nHeader, kLen);
-  }
+  // 1. Encode Header part
+  for (;;) {
+    nHeader = 0;
 
-  /* Encode vLen if need */
-  if (pPage->vLen == TDB_VARIANT_LEN) {
-    nHeader += tdbPutVarInt(pCell + nHeader, vLen);
+    /* Encode SPgno if interior page */
+    if (!leaf) {
+      ASSERT(pPage->vLen == sizeof(SPgno));
+
+      ((SPgno *)(pCell + nHeader))[0] = ((SPgno *)pVal)[0];
+      nHeader = nHeader + sizeof(SPgno);
+    }
+
+    /* Encode the bytes shared with page prefix */
+    if (TDB_BTREE_PAGE_IS_PFX(pPage)) {
+      pCell[nHeader] = nShared;
+      nHeader++;
+    }
+
+    /* Encode kLen if need */
+    if (pPage->kLen == TDB_VARIANT_LEN) {
+      nHeader += tdbPutVarInt(pCell + nHeader, kLen - nShared);
+    }
+
+    /* Encode vLen if need */
+    if (pPage->vLen == TDB_VARIANT_LEN) {
+      nHeader += tdbPutVarInt(pCell + nHeader, vLen);
+    }
+
+    // a cell sharing bytes with the page prefix must be local, or fall back to store the full key
+    if (nShared == 0 || nHeader + kLen - nShared + ((!leaf || pPage->vLen == 0) ? 0 : vLen) <= pPage->maxLocal) {
+      break;
+    }
+    nShared = 0;
   }
 
   // 2. Encode payload part
@@ -1198,7 +1426,8 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
     vLen = 0;
   }
 
-  ret = tdbBtreeEncodePayload(pPage, pCell, nHeader, pKey, kLen, pVal, vLen, &nPayload, pTxn, pBt);
+  ret = tdbBtreeEncodePayload(pPage, pCell, nHeader, (const u8 *)pKey + nShared, kLen - nShared, pVal, vLen, &nPayload,
+                              pTxn, pBt);
   if (ret < 0) {
     // TODO
     ASSERT(0);
@@ -1400,9 +1629,11 @@ static int tdbBtreeDecodePayload(SPage *pPage, const SCell *pCell, int nHeader,
 static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pDecoder, TXN *pTxn, SBTree *pBt) {
   u8  leaf;
   int nHeader;
+  int nShared;
   int ret;
 
   nHeader = 0;
+  nShared = 0;
   leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
 
   // Clear the state of decoder
@@ -1427,10 +1658,15 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
     nHeader = nHeader + sizeof(SPgno);
   }
 
+  if (TDB_BTREE_PAGE_IS_PFX(pPage)) {
+    nShared = pCell[nHeader];
+    nHeader++;
+  }
+
   if (pPage->kLen == TDB_VARIANT_LEN) {
     nHeader += tdbGetVarInt(pCell + nHeader, &(pDecoder->kLen));
   } else {
-    pDecoder->kLen = pPage->kLen;
+    pDecoder->kLen = pPage->kLen - nShared;
   }
 
   if (pPage->vLen == TDB_VARIANT_LEN) {
@@ -1441,6 +1677,28 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
   }
 
   // 2. Decode payload part
+  if (nShared > 0) {
+    // the cell is local, rebuild the full key from the page prefix
+    int nPfx;
+    u8 *pPfx = tdbBtreePagePfx(pPage, &nPfx);
+
+    ASSERT(nShared <= nPfx);
+
+    pDecoder->pBuf = tdbRealloc(pDecoder->pBuf, nShared + pDecoder->kLen);
+    if (pDecoder->pBuf == NULL) {
+      return -1;
+    }
+
+    memcpy(pDecoder->pBuf, pPfx, nShared);
+    memcpy(pDecoder->pBuf + nShared, pCell + nHeader, pDecoder->kLen);
+    if (leaf && pDecoder->vLen > 0) {
+      pDecoder->pVal = (SCell *)pCell + nHeader + pDecoder->kLen;
+    }
+    pDecoder->pKey = pDecoder->pBuf;
+    pDecoder->kLen += nShared;
+    return 0;
+  }
+
   ret = tdbBtreeDecodePayload(pPage, pCell, nHeader, pDecoder, pTxn, pBt);
   if (ret < 0) {
     return -1;
@@ -1449,9 +1707,10 @@ static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pD
   return 0;
 }
 
-static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *pTxn, SBTree *pBt) {
+// Decode the cell header, kLen is the length of the key bytes stored in the cell
+static int tdbBtreeCellHeader(const SPage *pPage, const SCell *pCell, int *kLen, int *vLen) {
   u8  leaf;
-  int kLen = 0, vLen = 0, nHeader = 0;
+  int nHeader = 0, nShared = 0;
 
   leaf = TDB_BTREE_PAGE_IS_LEAF(pPage);
 
@@ -1459,19 +1718,39 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
     nHeader += sizeof(SPgno);
   }
 
+  if (TDB_BTREE_PAGE_IS_PFX(pPage)) {
+    nShared = pCell[nHeader];
+    nHeader++;
+  }
+
   if (pPage->kLen == TDB_VARIANT_LEN) {
-    nHeader += tdbGetVarInt(pCell + nHeader, &kLen);
+    nHeader += tdbGetVarInt(pCell + nHeader, kLen);
   } else {
-    kLen = pPage->kLen;
+    *kLen = pPage->kLen - nShared;
   }
 
   if (pPage->vLen == TDB_VARIANT_LEN) {
     ASSERT(leaf);
-    nHeader += tdbGetVarInt(pCell + nHeader, &vLen);
+    nHeader += tdbGetVarInt(pCell + nHeader, vLen);
   } else if (leaf) {
-    vLen = pPage->vLen;
+    *vLen = pPage->vLen;
   }
 
+  return nHeader;
+}
+
+static int tdbBtreeCellIsLocal(const SPage *pPage, const SCell *pCell) {
+  int kLen = 0, vLen = 0, nHeader;
+
+  nHeader = tdbBtreeCellHeader(pPage, pCell, &kLen, &vLen);
+  return nHeader + kLen + vLen <= pPage->maxLocal;
+}
+
+static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *pTxn, SBTree *pBt) {
+  int kLen = 0, vLen = 0, nHeader;
+
+  nHeader = tdbBtreeCellHeader(pPage, pCell, &kLen, &vLen);
+
   int nPayload = kLen + vLen;
   if (nHeader + nPayload <= pPage->maxLocal) {
     return nHeader + kLen + vLen;
@@ -1529,8 +1808,10 @@ int tdbBtcOpen(SBTC *pBtc, SBTree *pBt, TXN *pTxn) {
   if (pTxn == NULL) {
     pBtc->pTxn = &pBtc->txn;
     tdbTxnOpen(pBtc->pTxn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL, 0);
+    pBtc->txn.snapshot = tdbPCacheSnapshotOpen(pBt->pPager->pCache, &pBtc->snap);
   } else {
     pBtc->pTxn = pTxn;
+    pBtc->snap.pCache = NULL;
   }
 
   return 0;
@@ -1700,6 +1981,7 @@ int tdbBtreeNext(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
 
   pKey = tdbRealloc(*ppKey, cd.kLen);
   if (pKey == NULL) {
+    tdbFree(cd.pBuf);
     return -1;
   }
 
@@ -1712,6 +1994,7 @@ int tdbBtreeNext(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     pVal = tdbRealloc(*ppVal, cd.vLen);
     if (pVal == NULL) {
       tdbFree(pKey);
+      tdbFree(cd.pBuf);
       return -1;
     }
 
@@ -1720,6 +2003,8 @@ int tdbBtreeNext(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     memcpy(pVal, cd.pVal, cd.vLen);
   }
 
+  tdbFree(cd.pBuf);
+
   ret = tdbBtcMoveToNext(pBtc);
   if (ret < 0) {
     ASSERT(0);
@@ -1746,6 +2031,7 @@ int tdbBtreePrev(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
 
   pKey = tdbRealloc(*ppKey, cd.kLen);
   if (pKey == NULL) {
+    tdbFree(cd.pBuf);
     return -1;
   }
 
@@ -1758,6 +2044,7 @@ int tdbBtreePrev(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     pVal = tdbRealloc(*ppVal, cd.vLen);
     if (pVal == NULL) {
       tdbFree(pKey);
+      tdbFree(cd.pBuf);
       return -1;
     }
 
@@ -1766,6 +2053,8 @@ int tdbBtreePrev(SBTC *pBtc, void **ppKey, int *kLen, void **ppVal, int *vLen) {
     memcpy(pVal, cd.pVal, cd.vLen);
   }
 
+  tdbFree(cd.pBuf);
+
   ret = tdbBtcMoveToPrev(pBtc);
   if (ret < 0) {
     ASSERT(0);
@@ -1930,13 +2219,6 @@ int tdbBtcDelete(SBTC *pBtc) {
   int         idx = pBtc->idx;
   int         nCells = TDB_PAGE_TOTAL_CELLS(pBtc->pPage);
   SPager     *pPager = pBtc->pBt->pPager;
-  const void *pKey;
-  i8          iPage;
-  SPage      *pPage;
-  SPgno       pgno;
-  SCell      *pCell;
-  int         szCell;
-  int         nKey;
   int         ret;
 
   ASSERT(idx >= 0 && idx < nCells);
@@ -1950,42 +2232,12 @@ int tdbBtcDelete(SBTC *pBtc) {
 
   tdbPageDropCell(pBtc->pPage, idx, pBtc->pTxn, pBtc->pBt);
 
-  // update interior page or do balance
+  // The divider cells on interior pages still separate the pages after deleting the last cell of a leaf, so they
+  // are left as they are. Rewriting them with the new last key could overflow the interior page, a truncated divider
+  // is usually much shorter than a full key.
   if (idx == nCells - 1) {
     if (idx) {
       pBtc->idx--;
-      tdbBtcGet(pBtc, &pKey, &nKey, NULL, NULL);
-
-      // loop to update the interial page
-      pgno = TDB_PAGE_PGNO(pBtc->pPage);
-      for (iPage = pBtc->iPage - 1; iPage >= 0; iPage--) {
-        pPage = pBtc->pgStack[iPage];
-        idx = pBtc->idxStack[iPage];
-        nCells = TDB_PAGE_TOTAL_CELLS(pPage);
-
-        if (idx < nCells) {
-          ret = tdbPagerWrite(pPager, pPage);
-          if (ret < 0) {
-            ASSERT(0);
-            return -1;
-          }
-
-          // update the cell with new key
-          pCell = tdbOsMalloc(nKey + 9);
-          tdbBtreeEncodeCell(pPage, pKey, nKey, &pgno, sizeof(pgno), pCell, &szCell, pBtc->pTxn, pBtc->pBt);
-
-          ret = tdbPageUpdateCell(pPage, idx, pCell, szCell, pBtc->pTxn, pBtc->pBt);
-          if (ret < 0) {
-            tdbOsFree(pCell);
-            ASSERT(0);
-            return -1;
-          }
-          tdbOsFree(pCell);
-          break;
-        } else {
-          pgno = TDB_PAGE_PGNO(pPage);
-        }
-      }
     } else {
       // delete the leaf page and do balance
       ASSERT(TDB_PAGE_TOTAL_CELLS(pBtc->pPage) == 0);
@@ -2200,6 +2452,8 @@ int tdbBtcMoveTo(SBTC *pBtc, const void *pKey, int kLen, int *pCRst) {
 }
 
 int tdbBtcClose(SBTC *pBtc) {
+  tdbPCacheSnapshotClose(&pBtc->snap);
+
   if (pBtc->iPage < 0) return 0;
 
   for (;;) {
@@ -2220,6 +2474,9 @@ int tdbBtcClose(SBTC *pBtc) {
     tdbFree(pBtc->coder.pVal);
   }
 
+  tdbFree(pBtc->coder.pBuf);
+  pBtc->coder.pBuf = NULL;
+
   return 0;
 }
 
@@ -2232,6 +2489,393 @@ int tdbBtcIsValid(SBTC *pBtc) {
 }
 // TDB_BTREE_CURSOR
 
+// TDB_BTREE_BULK =====================
+/*
+ * Bulk load builds a tree bottom-up from records given in key order. Records are collected per level until they fill
+ * a page up to the fill factor, then they are written into a new page with the common key prefix of the page, and
+ * the page goes up into the level above as a (divider, pgno) record. The last record of an interior page is its
+ * right-most child, so an interior level keeps one record back when it writes a page, which makes sure the last page
+ * of the level has a cell besides the right-most child. When the load finishes, the records left on the top level
+ * are written into the root page.
+ *
+ * Only an empty tree can be built this way and keys must be strictly ascending. Otherwise the records collected so
+ * far are built into the tree and the rest is upserted one by one.
+ */
+typedef struct {
+  int nRec;
+  int nLocal;  // records which will be stored local
+  int nPfx;    // common prefix of the keys collected
+  int szRec;   // size of the records without prefix compression, cell offsets included
+  int nPage;   // pages written on the level
+  int nBuf;
+  u8 *pBuf;  // | kLen | vLen | key | val | ...
+  u8 *pDiv;  // divider of the last page written
+} SBtLoadLevel;
+
+struct SBtLoader {
+  SBTree      *pBt;
+  TXN         *pTxn;
+  int          fillFactor;
+  u8           pfx;
+  u8           fallback;
+  int          nLevel;
+  SBtLoadLevel aLevel[BTREE_MAX_DEPTH];
+  u8          *pLKey;
+  int          lkLen;
+  SCell       *pCell;
+};
+
+#define TDB_BTLOAD_REC_KLEN(pRec) (((int *)(pRec))[0])
+#define TDB_BTLOAD_REC_VLEN(pRec) (((int *)(pRec))[1])
+#define TDB_BTLOAD_REC_KEY(pRec)  ((pRec) + sizeof(int) * 2)
+#define TDB_BTLOAD_REC_VAL(pRec)  ((pRec) + sizeof(int) * 2 + TDB_BTLOAD_REC_KLEN(pRec))
+#define TDB_BTLOAD_REC_SIZE(pRec) (sizeof(int) * 2 + TDB_BTLOAD_REC_KLEN(pRec) + TDB_BTLOAD_REC_VLEN(pRec))
+
+static int tdbBtLoadFlush(SBtLoader *pLoader, int iLevel, int nRec, const u8 *pNKey, int nkLen);
+
+// size of the cell of a record without prefix compression, and if the cell is kept local
+static int tdbBtLoadCellSize(SBtLoader *pLoader, int leaf, int kLen, int vLen, int *local) {
+  SBTree *pBt = pLoader->pBt;
+  u8      buf[6];
+  int     nHeader = leaf ? 0 : sizeof(SPgno);
+  int     maxLocal;
+
+  if (pLoader->pfx) nHeader++;
+  if (pBt->keyLen == TDB_VARIANT_LEN) nHeader += tdbPutVarInt(buf, kLen);
+  if (leaf && pBt->valLen == TDB_VARIANT_LEN) nHeader += tdbPutVarInt(buf, vLen);
+  if (!leaf || pBt->valLen == 0) vLen = 0;
+
+  if (leaf) {
+    maxLocal = pLoader->pfx ? pBt->maxLeafPfx : pBt->maxLeaf;
+  } else {
+    maxLocal = pLoader->pfx ? pBt->maxLocalPfx : pBt->maxLocal;
+  }
+
+  *local = (nHeader + kLen + vLen <= maxLocal);
+  return (*local ? nHeader + kLen + vLen : nHeader + maxLocal) + (pBt->pageSize < 65536 ? 2 : 3);
+}
+
+static int tdbBtLoadBudget(SBtLoader *pLoader, int leaf, int nPfx) {
+  int amHdr = leaf ? sizeof(SLeafHdr) : sizeof(SIntHdr);
+
+  if (pLoader->pfx) amHdr += 1 + nPfx;
+  return tdbPageCapacity(pLoader->pBt->pageSize, amHdr) * pLoader->fillFactor / 100;
+}
+
+static void tdbBtLoadAddRec(SBtLoader *pLoader, int iLevel, const u8 *pRec) {
+  SBtLoadLevel *pLevel = &pLoader->aLevel[iLevel];
+  int           kLen = TDB_BTLOAD_REC_KLEN(pRec);
+  int           local;
+
+  if (pLevel->nRec == 0) {
+    pLevel->nPfx = pLoader->pfx ? TMIN(kLen, TDB_BTREE_MAX_PFX) : 0;
+  } else if (pLoader->pfx) {
+    pLevel->nPfx = tdbBtreeCommonPfx(TDB_BTLOAD_REC_KEY(pLevel->pBuf), pLevel->nPfx, TDB_BTLOAD_REC_KEY(pRec), kLen);
+  }
+  pLevel->szRec += tdbBtLoadCellSize(pLoader, iLevel == 0, kLen, TDB_BTLOAD_REC_VLEN(pRec), &local);
+  pLevel->nLocal += local;
+  pLevel->nRec++;
+}
+
+static int tdbBtLoadPut(SBtLoader *pLoader, int iLevel, const void *pKey, int kLen, const void *pVal, int vLen) {
+  SBtLoadLevel *pLevel;
+  int           leaf = (iLevel == 0);
+  int           szRec;
+  int           local;
+  int           nPfx;
+  u8           *pBuf;
+
+  if (iLevel >= BTREE_MAX_DEPTH) {
+    ASSERT(0);
+    return -1;
+  }
+  if (iLevel >= pLoader->nLevel) {
+    pLoader->nLevel = iLevel + 1;
+  }
+  pLevel = &pLoader->aLevel[iLevel];
+
+  // write a page when the new record does not fit
+  if (pLevel->nRec >= (leaf ? 1 : 3)) {
+    szRec = tdbBtLoadCellSize(pLoader, leaf, kLen, vLen, &local);
+    nPfx = pLoader->pfx ? tdbBtreeCommonPfx(TDB_BTLOAD_REC_KEY(pLevel->pBuf), pLevel->nPfx, pKey, kLen) : 0;
+
+    if (pLevel->szRec + szRec - (pLevel->nLocal + local) * nPfx > tdbBtLoadBudget(pLoader, leaf, nPfx)) {
+      if (tdbBtLoadFlush(pLoader, iLevel, leaf ? pLevel->nRec : pLevel->nRec - 1, leaf ? pKey : NULL, kLen) < 0) {
+        return -1;
+      }
+    }
+  }
+
+  // append the record
+  pBuf = tdbRealloc(pLevel->pBuf, pLevel->nBuf + sizeof(int) * 2 + kLen + vLen);
+  if (pBuf == NULL) {
+    return -1;
+  }
+  pLevel->pBuf = pBuf;
+  pBuf += pLevel->nBuf;
+
+  TDB_BTLOAD_REC_KLEN(pBuf) = kLen;
+  TDB_BTLOAD_REC_VLEN(pBuf) = vLen;
+  memcpy(TDB_BTLOAD_REC_KEY(pBuf), pKey, kLen);
+  if (vLen > 0) {
+    memcpy(TDB_BTLOAD_REC_VAL(pBuf), pVal, vLen);
+  }
+  pLevel->nBuf += TDB_BTLOAD_REC_SIZE(pBuf);
+
+  tdbBtLoadAddRec(pLoader, iLevel, pBuf);
+  return 0;
+}
+
+// Write the first nRec records collected on a level into a new page, or into the root page if pRoot is given. The key
+// of the last record written is returned as divider.
+static int tdbBtLoadWritePage(SBtLoader *pLoader, int iLevel, int nRec, SPage *pRoot, SPgno *pPgno, u8 **ppDiv,
+                              int *pnDiv) {
+  SBTree           *pBt = pLoader->pBt;
+  SBtLoadLevel     *pLevel = &pLoader->aLevel[iLevel];
+  SBtreeInitPageArg zArg = {0};
+  SPage            *pPage;
+  SPgno             pgno;
+  u8               *pRec;
+  u8               *pDiv;
+  int               szCell;
+  int               nBuf;
+  int               ret;
+
+  ASSERT(nRec > 0 && nRec <= pLevel->nRec && (iLevel == 0 || nRec > 1));
+
+  zArg.flags = (iLevel == 0 ? TDB_BTREE_LEAF : 0) | (pLoader->pfx ? TDB_BTREE_PFX : 0);
+  zArg.pBt = pBt;
+  zArg.pPfx = TDB_BTLOAD_REC_KEY(pLevel->pBuf);
+  zArg.nPfx = pLevel->nPfx;
+
+  // the prefix is common to all the records collected, so also to the ones written
+  if (pRoot) {
+    pPage = pRoot;
+    zArg.flags |= TDB_BTREE_ROOT;
+    ret = tdbBtreeInitPage(pPage, &zArg, 0);
+  } else {
+    pgno = 0;
+    ret = tdbPagerFetchPage(pBt->pPager, &pgno, &pPage, tdbBtreeInitPage, &zArg, pLoader->pTxn);
+    if (ret == 0) {
+      ret = tdbPagerWrite(pBt->pPager, pPage);
+      if (ret < 0) {
+        tdbPagerReturnPage(pBt->pPager, pPage, pLoader->pTxn);
+      }
+    }
+  }
+  if (ret < 0) {
+    return -1;
+  }
+
+  pRec = pLevel->pBuf;
+  for (int iRec = 0; iRec < nRec; iRec++) {
+    if (iLevel > 0 && iRec == nRec - 1) {
+      // the last record of an interior page is the right-most child
+      memcpy(&((SIntHdr *)pPage->pData)->pgno, TDB_BTLOAD_REC_VAL(pRec), sizeof(SPgno));
+      break;
+    }
+
+    ret = tdbBtreeEncodeCell(pPage, TDB_BTLOAD_REC_KEY(pRec), TDB_BTLOAD_REC_KLEN(pRec), TDB_BTLOAD_REC_VAL(pRec),
+                             TDB_BTLOAD_REC_VLEN(pRec), pLoader->pCell, &szCell, pLoader->pTxn, pBt);
+    if (ret == 0) {
+      ret = tdbPageInsertCell(pPage, iRec, pLoader->pCell, szCell, 0);
+    }
+    if (ret < 0 || pPage->nOverflow > 0) {
+      ASSERT(0);
+      if (!pRoot) tdbPagerReturnPage(pBt->pPager, pPage, pLoader->pTxn);
+      return -1;
+    }
+
+    if (iRec < nRec - 1) pRec += TDB_BTLOAD_REC_SIZE(pRec);
+  }
+
+  if (!pRoot) {
+    *pPgno = TDB_PAGE_PGNO(pPage);
+    tdbPagerReturnPage(pBt->pPager, pPage, pLoader->pTxn);
+  }
+  pLevel->nPage++;
+
+  // keep the divider
+  pDiv = tdbRealloc(pLevel->pDiv, TDB_BTLOAD_REC_KLEN(pRec));
+  if (pDiv == NULL) {
+    return -1;
+  }
+  pLevel->pDiv = pDiv;
+  memcpy(pDiv, TDB_BTLOAD_REC_KEY(pRec), TDB_BTLOAD_REC_KLEN(pRec));
+  *ppDiv = pDiv;
+  *pnDiv = TDB_BTLOAD_REC_KLEN(pRec);
+
+  // move the records left to the front
+  pRec += TDB_BTLOAD_REC_SIZE(pRec);
+  nBuf = pLevel->nBuf - (pRec - pLevel->pBuf);
+  memmove(pLevel->pBuf, pRec, nBuf);
+
+  nRec = pLevel->nRec - nRec;
+  pLevel->nRec = 0;
+  pLevel->nLocal = 0;
+  pLevel->szRec = 0;
+  pLevel->nBuf = nBuf;
+  for (pRec = pLevel->pBuf; nRec > 0; nRec--) {
+    tdbBtLoadAddRec(pLoader, iLevel, pRec);
+    pRec += TDB_BTLOAD_REC_SIZE(pRec);
+  }
+
+  return 0;
+}
+
+// Write the first nRec records of a level into a new page and put the page into the level above. For a leaf, pNKey
+// is the first key of the next page to cut the divider with.
+static int tdbBtLoadFlush(SBtLoader *pLoader, int iLevel, int nRec, const u8 *pNKey, int nkLen) {
+  u8   *pDiv;
+  int   nDiv;
+  int   n = -1;
+  SPgno pgno;
+
+  if (tdbBtLoadWritePage(pLoader, iLevel, nRec, NULL, &pgno, &pDiv, &nDiv) < 0) {
+    return -1;
+  }
+
+  if (pNKey) {
+    n = tdbBtreeSeparatorLen(pLoader->pBt, pDiv, nDiv, pNKey, nkLen);
+  }
+
+  if (n > 0) {
+    return tdbBtLoadPut(pLoader, iLevel + 1, pNKey, n, &pgno, sizeof(pgno));
+  } else {
+    return tdbBtLoadPut(pLoader, iLevel + 1, pDiv, nDiv, &pgno, sizeof(pgno));
+  }
+}
+
+// Build the records collected so far into the tree, the top level goes into the root page.
+static int tdbBtLoadFinish(SBtLoader *pLoader) {
+  SBTree           *pBt = pLoader->pBt;
+  SPage            *pRoot;
+  u8               *pDiv;
+  int               nDiv;
+  int               iLevel;
+  int               ret;
+  SBtreeInitPageArg arg = {.pBt = pBt, .flags = TDB_BTREE_ROOT | TDB_BTREE_LEAF};
+
+  if (pLoader->nLevel == 0 || pLoader->aLevel[0].nRec == 0) {
+    return 0;
+  }
+
+  for (iLevel = 0; iLevel < pLoader->nLevel - 1 || pLoader->aLevel[iLevel].nPage > 0; iLevel++) {
+    if (tdbBtLoadFlush(pLoader, iLevel, pLoader->aLevel[iLevel].nRec, NULL, 0) < 0) {
+      return -1;
+    }
+  }
+
+  ret = tdbPagerFetchPage(pBt->pPager, &pBt->root, &pRoot, tdbBtreeInitPage, &arg, pLoader->pTxn);
+  if (ret < 0) {
+    return -1;
+  }
+
+  ret = tdbPagerWrite(pBt->pPager, pRoot);
+  if (ret == 0) {
+    ret = tdbBtLoadWritePage(pLoader, iLevel, pLoader->aLevel[iLevel].nRec, pRoot, NULL, &pDiv, &nDiv);
+  }
+
+  tdbPagerReturnPage(pBt->pPager, pRoot, pLoader->pTxn);
+  return ret;
+}
+
+int tdbBtreeBulkOpen(SBTree *pBt, int fillFactor, TXN *pTxn, SBtLoader **ppLoader) {
+  SBtLoader        *pLoader;
+  SPage            *pRoot;
+  int               ret;
+  SBtreeInitPageArg arg = {.pBt = pBt, .flags = TDB_BTREE_ROOT | TDB_BTREE_LEAF};
+
+  *ppLoader = NULL;
+
+  pLoader = (SBtLoader *)tdbOsCalloc(1, sizeof(*pLoader));
+  if (pLoader == NULL) {
+    return -1;
+  }
+  pLoader->pBt = pBt;
+  pLoader->pTxn = pTxn;
+  pLoader->fillFactor = TMIN(TMAX(fillFactor, 50), 100);
+
+  pLoader->pCell = (SCell *)tdbOsMalloc(pBt->pageSize);
+  if (pLoader->pCell == NULL) {
+    tdbOsFree(pLoader);
+    return -1;
+  }
+
+  ret = tdbPagerFetchPage(pBt->pPager, &pBt->root, &pRoot, tdbBtreeInitPage, &arg, pTxn);
+  if (ret < 0) {
+    tdbOsFree(pLoader->pCell);
+    tdbOsFree(pLoader);
+    return -1;
+  }
+
+  // keep the page format of the tree, old trees are not prefix compressed
+  pLoader->pfx = TDB_BTREE_PAGE_IS_PFX(pRoot) ? 1 : 0;
+  pLoader->fallback = (TDB_BTREE_PAGE_IS_LEAF(pRoot) && TDB_PAGE_TOTAL_CELLS(pRoot) == 0) ? 0 : 1;
+
+  tdbPagerReturnPage(pBt->pPager, pRoot, pTxn);
+
+  *ppLoader = pLoader;
+  return 0;
+}
+
+int tdbBtreeBulkPut(SBtLoader *pLoader, const void *pKey, int kLen, const void *pVal, int vLen) {
+  SBTree *pBt = pLoader->pBt;
+  u8     *pLKey;
+
+  if (!pLoader->fallback && pLoader->pLKey && pBt->kcmpr(pLoader->pLKey, pLoader->lkLen, pKey, kLen) >= 0) {
+    tdbDebug("tdb bulk load falls back to upsert on out of order key, btree:%p", pBt);
+
+    if (tdbBtLoadFinish(pLoader) < 0) {
+      return -1;
+    }
+    pLoader->fallback = 1;
+  }
+
+  if (pLoader->fallback) {
+    return tdbBtreeUpsert(pBt, pKey, kLen, pVal, vLen, pLoader->pTxn);
+  }
+
+  if (tdbBtLoadPut(pLoader, 0, pKey, kLen, pVal, vLen) < 0) {
+    return -1;
+  }
+
+  pLKey = tdbRealloc(pLoader->pLKey, kLen);
+  if (pLKey == NULL) {
+    return -1;
+  }
+  memcpy(pLKey, pKey, kLen);
+  pLoader->pLKey = pLKey;
+  pLoader->lkLen = kLen;
+
+  return 0;
+}
+
+int tdbBtreeBulkClose(SBtLoader *pLoader) {
+  int ret = 0;
+
+  if (pLoader) {
+    if (!pLoader->fallback) {
+      ret = tdbBtLoadFinish(pLoader);
+    }
+
+    for (int iLevel = 0; iLevel < BTREE_MAX_DEPTH; iLevel++) {
+      tdbFree(pLoader->aLevel[iLevel].pBuf);
+      tdbFree(pLoader->aLevel[iLevel].pDiv);
+    }
+    tdbFree(pLoader->pLKey);
+    tdbOsFree(pLoader->pCell);
+    tdbOsFree(pLoader);
+  }
+
+  return ret;
+}
+
+int tdbBtreeCmpr(SBTree *pBt, const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  return pBt->kcmpr(pKey1, kLen1, pKey2, kLen2);
+}
+// TDB_BTREE_BULK
+
 // TDB_BTREE_DEBUG =====================
 #ifndef NODEBUG
 typedef struct {
@@ -116,6 +116,9 @@ int32_t tdbCommit(TDB *pDb, TXN *pTxn) {
   SPager *pPager;
   int     ret;
 
+  // readers of older epochs keep reading the versions of the committed pages, no need to wait for them
+  tdbPCachePublish(pDb->pCache);
+
   for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
     ret = tdbPagerCommit(pPager, pTxn);
     if (ret < 0) {
@@ -124,6 +127,7 @@ int32_t tdbCommit(TDB *pDb, TXN *pTxn) {
     }
   }
 
+  tdbPCacheRetire(pDb->pCache);
   return 0;
 }
 
@@ -131,6 +135,8 @@ int32_t tdbAbort(TDB *pDb, TXN *pTxn) {
   SPager *pPager;
   int     ret;
 
+  tdbPCachePublish(pDb->pCache);
+
   for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
     ret = tdbPagerAbort(pPager, pTxn);
     if (ret < 0) {
@@ -139,9 +145,98 @@ int32_t tdbAbort(TDB *pDb, TXN *pTxn) {
     }
   }
 
+  tdbPCacheRetire(pDb->pCache);
+  return 0;
+}
+
+int32_t tdbSetJournalMode(TDB *pDb, int8_t mode) {
+  SPager *pPager;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    if (tdbPagerSetJournalMode(pPager, mode) < 0) {
+      return -1;
+    }
+  }
+
+  pDb->jMode = mode;
+  return 0;
+}
+
+int32_t tdbSetMmapRead(TDB *pDb, bool enable) {
+  SPager *pPager;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    if (tdbPagerSetMmapRead(pPager, enable) < 0) {
+      return -1;
+    }
+  }
+
+  pDb->mmapRead = enable;
   return 0;
 }
 
+int32_t tdbSetSnapshotRead(TDB *pDb, bool enable) {
+  tdbPCacheSetSnapshotRead(pDb->pCache, enable);
+  return 0;
+}
+
+void tdbReadBegin(TDB *pDb) { tdbPCacheReadBegin(pDb->pCache); }
+
+void tdbReadBeginAt(TDB *pDb, TSNAP *pSnap) { tdbPCacheReadBeginAt(pDb->pCache, pSnap); }
+
+void tdbReadEnd(TDB *pDb) { tdbPCacheReadEnd(pDb->pCache); }
+
+bool tdbInRead(TDB *pDb) { return tdbPCacheInRead(pDb->pCache); }
+
+bool tdbReadIsLatest(TDB *pDb) { return tdbPCacheReadIsLatest(pDb->pCache); }
+
+void tdbPublish(TDB *pDb) { tdbPCachePublish(pDb->pCache); }
+
+int32_t tdbSnapOpen(TDB *pDb, TSNAP **ppSnap) {
+  TSNAP *pSnap;
+
+  *ppSnap = NULL;
+  if (!tdbPCacheSnapshotRead(pDb->pCache)) return 0;
+
+  pSnap = (TSNAP *)tdbOsCalloc(1, sizeof(*pSnap));
+  if (pSnap == NULL) {
+    return -1;
+  }
+
+  tdbPCacheSnapshotOpen(pDb->pCache, pSnap);
+  *ppSnap = pSnap;
+  return 0;
+}
+
+void tdbSnapClose(TSNAP *pSnap) {
+  if (pSnap) {
+    tdbPCacheSnapshotClose(pSnap);
+    tdbOsFree(pSnap);
+  }
+}
+
+int32_t tdbCheckpoint(TDB *pDb) {
+  SPager *pPager;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    if (tdbPagerCheckpoint(pPager) < 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+bool tdbNeedCheckpoint(TDB *pDb) {
+  SPager *pPager;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    if (tdbPagerNeedCheckpoint(pPager)) return true;
+  }
+
+  return false;
+}
+
 SPager *tdbEnvGetPager(TDB *pDb, const char *fname) {
   u32      hash;
   SPager **ppPager;
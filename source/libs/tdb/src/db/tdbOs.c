@@ -95,4 +95,10 @@ i64 tdbOsWrite(tdb_fd_t fd, const void *pData, i64 nBytes) {
   return nWrite;
 }
 
-#endif
\ No newline at end of file
+// tdbOsMmap
+void *tdbOsMmap(tdb_fd_t fd, i64 len) {
+  void *ptr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+  return (ptr == MAP_FAILED) ? NULL : ptr;
+}
+
+#endif
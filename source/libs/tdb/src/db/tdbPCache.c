@@ -17,10 +17,12 @@
 // #include <sys/types.h>
 // #include <unistd.h>
 
-struct SPCache {
-  int         szPage;
-  int         nPages;
-  SPage     **aPage;
+// The cache is partitioned into shards by page id, each shard owns a part of the local pages and has its own
+// lock, hash table, free list and LRU list, so fetching a cached page only locks the shard of the page.
+#define TDB_PCACHE_MAX_SHARDS       16
+#define TDB_PCACHE_MIN_SHARD_PAGES 64
+
+typedef struct {
   tdb_mutex_t mutex;
   int         nFree;
   SPage      *pFree;
@@ -29,25 +31,74 @@ struct SPCache {
   SPage     **pgHash;
   int         nRecyclable;
   SPage       lru;
+  int         nVersioned;
+  SPage       ver;  // unreferenced pages with versions older snapshots may still read, never recycled
+} SPCacheShard;
+
+struct SPCache {
+  int           szPage;
+  int           nPages;
+  SPage       **aPage;
+  int           nShard;
+  SPCacheShard *aShard;
+  // snapshot reads
+  bool          snapRead;
+  volatile i64  epoch;    // last published epoch, the writer changes pages in epoch + 1
+  i64           retired;  // the oldest pinned epoch on the last tdbPCacheRetire()
+  tdb_mutex_t   snapMutex;
+  STdbSnap      snapList;  // pinned snapshots, oldest first
 };
 
+// the image of a page before it was changed in epoch `until`, versions of a page are chained newest first
+struct SPageVer {
+  i64       until;
+  SPageVer *pNext;
+  int       szAmHdr;
+  int       kLen;
+  int       vLen;
+  int       maxLocal;
+  int       minLocal;
+  int (*xCellSize)(const SPage *, SCell *, int, TXN *pTxn, SBTree *pBt);
+  u8        data[];
+};
+
+// the read section of a thread, see tdbPCacheReadBegin()
+typedef struct {
+  i32       nRef;
+  STdbSnap *pSnap;  // the snapshot the reads of the section see
+  STdbSnap  own;    // pinned by the section itself if it was not given one
+} STdbRead;
+
+static tdbThreadLocal STdbRead tdbThreadRead;
+
 static inline uint32_t tdbPCachePageHash(const SPgid *pPgid) {
   uint32_t *t = (uint32_t *)((pPgid)->fileid);
   return (uint32_t)(t[0] + t[1] + t[2] + t[3] + t[4] + t[5] + (pPgid)->pgno);
 }
 
+static inline SPCacheShard *tdbPCacheGetShard(SPCache *pCache, const SPgid *pPgid) {
+  return &pCache->aShard[tdbPCachePageHash(pPgid) % pCache->nShard];
+}
+
+// low bits of the hash select the shard, use the rest for the bucket
+static inline uint32_t tdbPCacheBucket(SPCache *pCache, SPCacheShard *pShard, const SPgid *pPgid) {
+  return (tdbPCachePageHash(pPgid) / pCache->nShard) % pShard->nHash;
+}
+
 static int    tdbPCacheOpenImpl(SPCache *pCache);
-static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn);
-static void   tdbPCachePinPage(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheRemovePageFromHash(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheAddPageToHash(SPCache *pCache, SPage *pPage);
-static void   tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage);
+static SPage *tdbPCacheFetchImpl(SPCache *pCache, SPCacheShard *pShard, const SPgid *pPgid, TXN *pTxn);
+static void   tdbPCachePinPage(SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheRemovePageFromHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheAddPageToHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheUnpinPage(SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheParkPage(SPCacheShard *pShard, SPage *pPage);
+static void   tdbPCacheCopyVersion(SPage *pPageH, SPage *pPage, i64 snapshot);
 static int    tdbPCacheCloseImpl(SPCache *pCache);
 
-static void tdbPCacheInitLock(SPCache *pCache) { tdbMutexInit(&(pCache->mutex), NULL); }
-static void tdbPCacheDestroyLock(SPCache *pCache) { tdbMutexDestroy(&(pCache->mutex)); }
-static void tdbPCacheLock(SPCache *pCache) { tdbMutexLock(&(pCache->mutex)); }
-static void tdbPCacheUnlock(SPCache *pCache) { tdbMutexUnlock(&(pCache->mutex)); }
+static void tdbPCacheInitLock(SPCacheShard *pShard) { tdbMutexInit(&(pShard->mutex), NULL); }
+static void tdbPCacheDestroyLock(SPCacheShard *pShard) { tdbMutexDestroy(&(pShard->mutex)); }
+static void tdbPCacheLock(SPCacheShard *pShard) { tdbMutexLock(&(pShard->mutex)); }
+static void tdbPCacheUnlock(SPCacheShard *pShard) { tdbMutexUnlock(&(pShard->mutex)); }
 
 int tdbPCacheOpen(int pageSize, int cacheSize, SPCache **ppCache) {
   SPCache *pCache;
@@ -62,9 +113,12 @@ int tdbPCacheOpen(int pageSize, int cacheSize, SPCache **ppCache) {
   pCache->szPage = pageSize;
   pCache->nPages = cacheSize;
   pCache->aPage = (SPage **)&pCache[1];
+  pCache->epoch = 1;
+  tdbMutexInit(&pCache->snapMutex, NULL);
+  pCache->snapList.pPrev = pCache->snapList.pNext = &pCache->snapList;
 
   if (tdbPCacheOpenImpl(pCache) < 0) {
-    tdbOsFree(pCache);
+    tdbPCacheClose(pCache);
     return -1;
   }
 
@@ -75,25 +129,27 @@ int tdbPCacheOpen(int pageSize, int cacheSize, SPCache **ppCache) {
 int tdbPCacheClose(SPCache *pCache) {
   if (pCache) {
     tdbPCacheCloseImpl(pCache);
+    tdbMutexDestroy(&pCache->snapMutex);
     tdbOsFree(pCache);
   }
   return 0;
 }
 
 SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
-  SPage *pPage;
-  i32    nRef;
+  SPCacheShard *pShard = tdbPCacheGetShard(pCache, pPgid);
+  SPage        *pPage;
+  i32           nRef;
 
-  tdbPCacheLock(pCache);
+  tdbPCacheLock(pShard);
 
-  pPage = tdbPCacheFetchImpl(pCache, pPgid, pTxn);
+  pPage = tdbPCacheFetchImpl(pCache, pShard, pPgid, pTxn);
   if (pPage) {
     nRef = tdbRefPage(pPage);
   }
 
   ASSERT(pPage);
 
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlock(pShard);
 
   // printf("thread %" PRId64 " fetch page %d pgno %d pPage %p nRef %d\n", taosGetSelfPthreadId(), pPage->id,
   //        TDB_PAGE_PGNO(pPage), pPage, nRef);
@@ -103,14 +159,15 @@ SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
 }
 
 void tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn) {
-  i32 nRef;
+  SPCacheShard *pShard = tdbPCacheGetShard(pCache, &(pPage->pgid));
+  i32           nRef;
 
   ASSERT(pTxn);
 
   // nRef = tdbUnrefPage(pPage);
   // ASSERT(nRef >= 0);
 
-  tdbPCacheLock(pCache);
+  tdbPCacheLock(pShard);
   nRef = tdbUnrefPage(pPage);
   tdbDebug("pcache/release page %p/%d/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id, nRef);
   if (nRef == 0) {
@@ -118,26 +175,293 @@ void tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn) {
     // it is safe th handle the page
     // nRef = tdbGetPageRef(pPage);
     // if (nRef == 0) {
-    if (pPage->isLocal) {
-      tdbPCacheUnpinPage(pCache, pPage);
+    if (pPage->pVer) {
+      // only pages the writer changed have versions, keep them in the hash until no snapshot reads the versions
+      tdbPCacheParkPage(pShard, pPage);
+    } else if (pPage->isLocal) {
+      tdbPCacheUnpinPage(pShard, pPage);
     } else {
       if (TDB_TXN_IS_WRITE(pTxn)) {
         // remove from hash
-        tdbPCacheRemovePageFromHash(pCache, pPage);
+        tdbPCacheRemovePageFromHash(pCache, pShard, pPage);
       }
 
-      tdbPageDestroy(pPage, pTxn->xFree, pTxn->xArg);
+      // with snapshot reads the pages of the writer may outlive its txn, see tdbPCacheFetchImpl()
+      if (TDB_TXN_IS_WRITE(pTxn) && pCache->snapRead) {
+        tdbPageDestroy(pPage, tdbDefaultFree, NULL);
+      } else {
+        tdbPageDestroy(pPage, pTxn->xFree, pTxn->xArg);
+      }
     }
     // }
   }
-  tdbPCacheUnlock(pCache);
+  tdbPCacheUnlock(pShard);
   // printf("thread %" PRId64 " relas page %d pgno %d pPage %p nRef %d\n", taosGetSelfPthreadId(), pPage->id,
   //        TDB_PAGE_PGNO(pPage), pPage, nRef);
 }
 
 int tdbPCacheGetPageSize(SPCache *pCache) { return pCache->szPage; }
 
-static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn) {
+void tdbPCacheSetSnapshotRead(SPCache *pCache, bool enable) { pCache->snapRead = enable; }
+
+bool tdbPCacheSnapshotRead(SPCache *pCache) { return pCache->snapRead; }
+
+// pin a snapshot to the epoch, the list is kept in epoch order as a section may pin an older epoch than the latest
+static void tdbPCachePinSnapshot(SPCache *pCache, STdbSnap *pSnap, i64 epoch) {
+  STdbSnap *pPrev;
+
+  tdbMutexLock(&pCache->snapMutex);
+  pSnap->epoch = epoch ? epoch : pCache->epoch;
+  pSnap->pCache = pCache;
+  for (pPrev = pCache->snapList.pPrev; pPrev != &pCache->snapList && pPrev->epoch > pSnap->epoch; pPrev = pPrev->pPrev)
+    ;
+  pSnap->pPrev = pPrev;
+  pSnap->pNext = pPrev->pNext;
+  pPrev->pNext->pPrev = pSnap;
+  pPrev->pNext = pSnap;
+  tdbMutexUnlock(&pCache->snapMutex);
+}
+
+static void tdbPCacheUnpinSnapshot(STdbSnap *pSnap) {
+  SPCache *pCache = pSnap->pCache;
+
+  tdbMutexLock(&pCache->snapMutex);
+  pSnap->pPrev->pNext = pSnap->pNext;
+  pSnap->pNext->pPrev = pSnap->pPrev;
+  tdbMutexUnlock(&pCache->snapMutex);
+  pSnap->pCache = NULL;
+}
+
+// the oldest epoch a reader is pinned to, or may pin from now on
+static i64 tdbPCacheMinSnapshot(SPCache *pCache) {
+  i64 epoch;
+
+  tdbMutexLock(&pCache->snapMutex);
+  epoch = (pCache->snapList.pNext != &pCache->snapList) ? pCache->snapList.pNext->epoch : pCache->epoch;
+  tdbMutexUnlock(&pCache->snapMutex);
+
+  return epoch;
+}
+
+void tdbPCacheReadBegin(SPCache *pCache) {
+  STdbRead *pRead = &tdbThreadRead;
+
+  if (!pCache->snapRead) return;
+
+  if (pRead->nRef == 0) {
+    tdbPCachePinSnapshot(pCache, &pRead->own, 0);
+    pRead->pSnap = &pRead->own;
+  } else if (pRead->pSnap->pCache != pCache) {
+    // the thread is already reading another db, reads of this one pin a snapshot per cursor
+    return;
+  }
+  pRead->nRef++;
+}
+
+void tdbPCacheReadBeginAt(SPCache *pCache, STdbSnap *pSnap) {
+  STdbRead *pRead = &tdbThreadRead;
+
+  if (!pCache->snapRead || pSnap == NULL || pSnap->pCache != pCache) return;
+
+  if (pRead->nRef == 0) {
+    pRead->pSnap = pSnap;
+  } else if (pRead->pSnap->pCache != pCache) {
+    return;
+  }
+  pRead->nRef++;
+}
+
+void tdbPCacheReadEnd(SPCache *pCache) {
+  STdbRead *pRead = &tdbThreadRead;
+
+  if (!pCache->snapRead || pRead->nRef == 0 || pRead->pSnap->pCache != pCache) return;
+
+  if (--pRead->nRef == 0) {
+    if (pRead->pSnap == &pRead->own) {
+      tdbPCacheUnpinSnapshot(&pRead->own);
+    }
+    pRead->pSnap = NULL;
+  }
+}
+
+bool tdbPCacheInRead(SPCache *pCache) { return tdbThreadRead.nRef > 0 && tdbThreadRead.pSnap->pCache == pCache; }
+
+bool tdbPCacheReadIsLatest(SPCache *pCache) {
+  return !tdbPCacheInRead(pCache) || tdbThreadRead.pSnap->epoch == atomic_load_64(&pCache->epoch);
+}
+
+// a cursor always pins a snapshot of its own, so it can be kept open past the read section and closed by any thread
+i64 tdbPCacheSnapshotOpen(SPCache *pCache, STdbSnap *pSnap) {
+  pSnap->pCache = NULL;
+  if (!pCache->snapRead) return 0;
+
+  tdbPCachePinSnapshot(pCache, pSnap, tdbPCacheInRead(pCache) ? tdbThreadRead.pSnap->epoch : 0);
+  return pSnap->epoch;
+}
+
+void tdbPCacheSnapshotClose(STdbSnap *pSnap) {
+  if (pSnap->pCache) {
+    tdbPCacheUnpinSnapshot(pSnap);
+  }
+}
+
+void tdbPCachePublish(SPCache *pCache) {
+  if (!pCache->snapRead) return;
+
+  tdbMutexLock(&pCache->snapMutex);
+  atomic_add_fetch_64(&pCache->epoch, 1);
+  tdbMutexUnlock(&pCache->snapMutex);
+
+  // nothing more to retire unless the oldest snapshot moved on
+  if (tdbPCacheMinSnapshot(pCache) != pCache->retired) {
+    tdbPCacheRetire(pCache);
+  }
+}
+
+// unlink the versions no snapshot from minEpoch on can pick, the caller frees them
+static SPageVer *tdbPCachePruneVersions(SPage *pPage, i64 minEpoch) {
+  SPageVer **ppVer;
+  SPageVer  *pDrop;
+
+  TDB_LOCK_PAGE(pPage);
+  for (ppVer = &pPage->pVer; *ppVer && (*ppVer)->until > minEpoch; ppVer = &(*ppVer)->pNext)
+    ;
+  pDrop = *ppVer;
+  *ppVer = NULL;
+  TDB_UNLOCK_PAGE(pPage);
+
+  return pDrop;
+}
+
+static void tdbPCacheFreeVersions(SPageVer *pDrop) {
+  SPageVer *pVer;
+
+  while (pDrop) {
+    pVer = pDrop;
+    pDrop = pDrop->pNext;
+    tdbOsFree(pVer);
+  }
+}
+
+// drop the versions the pinned snapshots are done with, parked pages left without versions can be recycled again
+void tdbPCacheRetire(SPCache *pCache) {
+  SPCacheShard *pShard;
+  SPage        *pPage;
+  SPage        *pNext;
+  i64           minEpoch;
+
+  if (!pCache->snapRead) return;
+
+  minEpoch = tdbPCacheMinSnapshot(pCache);
+  pCache->retired = minEpoch;
+
+  for (int iShard = 0; iShard < pCache->nShard; iShard++) {
+    pShard = &pCache->aShard[iShard];
+
+    tdbPCacheLock(pShard);
+    for (pPage = pShard->ver.pLruNext; !pPage->isAnchor; pPage = pNext) {
+      pNext = pPage->pLruNext;
+
+      tdbPCacheFreeVersions(tdbPCachePruneVersions(pPage, minEpoch));
+      if (pPage->pVer) continue;
+
+      pPage->pLruPrev->pLruNext = pPage->pLruNext;
+      pPage->pLruNext->pLruPrev = pPage->pLruPrev;
+      pPage->pLruNext = NULL;
+      pShard->nVersioned--;
+
+      if (pPage->isLocal) {
+        tdbPCacheUnpinPage(pShard, pPage);
+      } else {
+        tdbPCacheRemovePageFromHash(pCache, pShard, pPage);
+        tdbPageDestroy(pPage, tdbDefaultFree, NULL);
+      }
+    }
+    tdbPCacheUnlock(pShard);
+  }
+}
+
+int tdbPCacheSaveVersion(SPCache *pCache, SPage *pPage) {
+  SPageVer *pVer;
+  i64       epoch;
+  i64       minEpoch;
+
+  if (!pCache->snapRead) return 0;
+
+  // only the writer changes the page epoch, the image is kept on the first change in an epoch
+  epoch = atomic_load_64(&pCache->epoch) + 1;
+  if (pPage->epoch == epoch) return 0;
+
+  pVer = (SPageVer *)tdbOsMalloc(sizeof(*pVer) + pPage->pageSize);
+  if (pVer == NULL) {
+    return -1;
+  }
+  pVer->until = epoch;
+  pVer->szAmHdr = pPage->pPageHdr - pPage->pData;
+  pVer->kLen = pPage->kLen;
+  pVer->vLen = pPage->vLen;
+  pVer->maxLocal = pPage->maxLocal;
+  pVer->minLocal = pPage->minLocal;
+  pVer->xCellSize = pPage->xCellSize;
+  memcpy(pVer->data, pPage->pData, pPage->pageSize);
+
+  // versions no reader can pick any more are dropped on the way
+  minEpoch = tdbPCacheMinSnapshot(pCache);
+
+  TDB_LOCK_PAGE(pPage);
+  pVer->pNext = pPage->pVer;
+  pPage->pVer = pVer;
+  pPage->epoch = epoch;
+  TDB_UNLOCK_PAGE(pPage);
+
+  tdbPCacheFreeVersions(tdbPCachePruneVersions(pPage, minEpoch));
+
+  return 0;
+}
+
+void tdbPCacheDropVersions(SPage *pPage) {
+  SPageVer *pDrop;
+
+  if (pPage->pVer == NULL) return;
+
+  TDB_LOCK_PAGE(pPage);
+  pDrop = pPage->pVer;
+  pPage->pVer = NULL;
+  TDB_UNLOCK_PAGE(pPage);
+
+  tdbPCacheFreeVersions(pDrop);
+}
+
+// copy the page as of the snapshot, the one of the oldest version kept after the snapshot
+static void tdbPCacheCopyVersion(SPage *pPageH, SPage *pPage, i64 snapshot) {
+  SPageVer *pVer = NULL;
+
+  TDB_LOCK_PAGE(pPageH);
+  if (pPageH->epoch > snapshot) {
+    for (SPageVer *p = pPageH->pVer; p && p->until > snapshot; p = p->pNext) {
+      pVer = p;
+    }
+  }
+
+  if (pVer) {
+    memcpy(pPage->pData, pVer->data, pPage->pageSize);
+    tdbPageInit(pPage, pVer->szAmHdr, pVer->xCellSize);
+    pPage->kLen = pVer->kLen;
+    pPage->vLen = pVer->vLen;
+    pPage->maxLocal = pVer->maxLocal;
+    pPage->minLocal = pVer->minLocal;
+  } else {
+    memcpy(pPage->pData, pPageH->pData, pPage->pageSize);
+    tdbPageInit(pPage, pPageH->pPageHdr - pPageH->pData, pPageH->xCellSize);
+    pPage->kLen = pPageH->kLen;
+    pPage->vLen = pPageH->vLen;
+    pPage->maxLocal = pPageH->maxLocal;
+    pPage->minLocal = pPageH->minLocal;
+  }
+  TDB_UNLOCK_PAGE(pPageH);
+}
+
+static SPage *tdbPCacheFetchImpl(SPCache *pCache, SPCacheShard *pShard, const SPgid *pPgid, TXN *pTxn) {
   int    ret = 0;
   SPage *pPage = NULL;
   SPage *pPageH = NULL;
@@ -145,42 +469,48 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   ASSERT(pTxn);
 
   // 1. Search the hash table
-  pPage = pCache->pgHash[tdbPCachePageHash(pPgid) % pCache->nHash];
+  pPage = pShard->pgHash[tdbPCacheBucket(pCache, pShard, pPgid)];
   while (pPage) {
     if (pPage->pgid.pgno == pPgid->pgno && memcmp(pPage->pgid.fileid, pPgid->fileid, TDB_FILE_ID_LEN) == 0) break;
     pPage = pPage->pHashNext;
   }
 
   if (pPage) {
-    if (pPage->isLocal || TDB_TXN_IS_WRITE(pTxn)) {
-      tdbPCachePinPage(pCache, pPage);
+    if ((pPage->isLocal && !TDB_TXN_IS_SNAPSHOT(pTxn)) || TDB_TXN_IS_WRITE(pTxn)) {
+      tdbPCachePinPage(pShard, pPage);
       return pPage;
     }
   }
 
   // 1. pPage == NULL
   // 2. pPage && pPage->isLocal == 0 && !TDB_TXN_IS_WRITE(pTxn)
+  // 3. pPage && TDB_TXN_IS_SNAPSHOT(pTxn), a snapshot reader always works on a copy
   pPageH = pPage;
   pPage = NULL;
 
   // 2. Try to allocate a new page from the free list
-  if (pCache->pFree) {
-    pPage = pCache->pFree;
-    pCache->pFree = pPage->pFreeNext;
-    pCache->nFree--;
+  if (pShard->pFree) {
+    pPage = pShard->pFree;
+    pShard->pFree = pPage->pFreeNext;
+    pShard->nFree--;
     pPage->pLruNext = NULL;
   }
 
   // 3. Try to Recycle a page
-  if (!pPage && !pCache->lru.pLruPrev->isAnchor) {
-    pPage = pCache->lru.pLruPrev;
-    tdbPCacheRemovePageFromHash(pCache, pPage);
-    tdbPCachePinPage(pCache, pPage);
+  if (!pPage && !pShard->lru.pLruPrev->isAnchor) {
+    pPage = pShard->lru.pLruPrev;
+    tdbPCacheRemovePageFromHash(pCache, pShard, pPage);
+    tdbPCachePinPage(pShard, pPage);
   }
 
   // 4. Try a create new page
   if (!pPage) {
-    ret = tdbPageCreate(pCache->szPage, &pPage, pTxn->xMalloc, pTxn->xArg);
+    if (TDB_TXN_IS_WRITE(pTxn) && pCache->snapRead) {
+      // a page of the writer is parked past the txn while it has versions, so it can't come from the txn memory
+      ret = tdbPageCreate(pCache->szPage, &pPage, tdbDefaultMalloc, NULL);
+    } else {
+      ret = tdbPageCreate(pCache->szPage, &pPage, pTxn->xMalloc, pTxn->xArg);
+    }
     if (ret < 0) {
       // TODO
       ASSERT(0);
@@ -212,22 +542,30 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
 
       pPage->pLruNext = NULL;
       pPage->pPager = pPageH->pPager;
-
-      memcpy(pPage->pData, pPageH->pData, pPage->pageSize);
-      tdbDebug("pcache/pPageH: %p %d %p %p %d", pPageH, pPageH->pPageHdr - pPageH->pData, pPageH->xCellSize, pPage,
-               TDB_PAGE_PGNO(pPageH));
-      tdbPageInit(pPage, pPageH->pPageHdr - pPageH->pData, pPageH->xCellSize);
-      pPage->kLen = pPageH->kLen;
-      pPage->vLen = pPageH->vLen;
-      pPage->maxLocal = pPageH->maxLocal;
-      pPage->minLocal = pPageH->minLocal;
+      pPage->epoch = 0;
+      pPage->pVer = NULL;
+
+      if (TDB_TXN_IS_SNAPSHOT(pTxn)) {
+        tdbPCacheCopyVersion(pPageH, pPage, pTxn->snapshot);
+      } else {
+        memcpy(pPage->pData, pPageH->pData, pPage->pageSize);
+        tdbDebug("pcache/pPageH: %p %d %p %p %d", pPageH, pPageH->pPageHdr - pPageH->pData, pPageH->xCellSize, pPage,
+                 TDB_PAGE_PGNO(pPageH));
+        tdbPageInit(pPage, pPageH->pPageHdr - pPageH->pData, pPageH->xCellSize);
+        pPage->kLen = pPageH->kLen;
+        pPage->vLen = pPageH->vLen;
+        pPage->maxLocal = pPageH->maxLocal;
+        pPage->minLocal = pPageH->minLocal;
+      }
     } else {
       memcpy(&(pPage->pgid), pPgid, sizeof(*pPgid));
       pPage->pLruNext = NULL;
       pPage->pPager = NULL;
+      pPage->epoch = 0;
+      pPage->pVer = NULL;
 
       if (pPage->isLocal || TDB_TXN_IS_WRITE(pTxn)) {
-        tdbPCacheAddPageToHash(pCache, pPage);
+        tdbPCacheAddPageToHash(pCache, pShard, pPage);
       }
     }
   }
@@ -235,7 +573,7 @@ static SPage *tdbPCacheFetchImpl(SPCache *pCache, const SPgid *pPgid, TXN *pTxn)
   return pPage;
 }
 
-static void tdbPCachePinPage(SPCache *pCache, SPage *pPage) {
+static void tdbPCachePinPage(SPCacheShard *pShard, SPage *pPage) {
   if (pPage->pLruNext != NULL) {
     ASSERT(tdbGetPageRef(pPage) == 0);
 
@@ -243,14 +581,18 @@ static void tdbPCachePinPage(SPCache *pCache, SPage *pPage) {
     pPage->pLruNext->pLruPrev = pPage->pLruPrev;
     pPage->pLruNext = NULL;
 
-    pCache->nRecyclable--;
+    if (pPage->pVer) {
+      pShard->nVersioned--;
+    } else {
+      pShard->nRecyclable--;
+    }
 
     // printf("pin page %d pgno %d pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
     tdbDebug("pcache/pin page %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
   }
 }
 
-static void tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage) {
+static void tdbPCacheUnpinPage(SPCacheShard *pShard, SPage *pPage) {
   i32 nRef;
 
   ASSERT(pPage->isLocal);
@@ -259,40 +601,55 @@ static void tdbPCacheUnpinPage(SPCache *pCache, SPage *pPage) {
 
   ASSERT(pPage->pLruNext == NULL);
 
-  pPage->pLruPrev = &(pCache->lru);
-  pPage->pLruNext = pCache->lru.pLruNext;
-  pCache->lru.pLruNext->pLruPrev = pPage;
-  pCache->lru.pLruNext = pPage;
+  pPage->pLruPrev = &(pShard->lru);
+  pPage->pLruNext = pShard->lru.pLruNext;
+  pShard->lru.pLruNext->pLruPrev = pPage;
+  pShard->lru.pLruNext = pPage;
 
-  pCache->nRecyclable++;
+  pShard->nRecyclable++;
 
   // printf("unpin page %d pgno %d pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   tdbDebug("pcache/unpin page %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
 }
 
-static void tdbPCacheRemovePageFromHash(SPCache *pCache, SPage *pPage) {
-  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pCache->nHash;
+static void tdbPCacheParkPage(SPCacheShard *pShard, SPage *pPage) {
+  ASSERT(!pPage->isDirty);
+  ASSERT(tdbGetPageRef(pPage) == 0);
+  ASSERT(pPage->pLruNext == NULL);
+
+  pPage->pLruPrev = &(pShard->ver);
+  pPage->pLruNext = pShard->ver.pLruNext;
+  pShard->ver.pLruNext->pLruPrev = pPage;
+  pShard->ver.pLruNext = pPage;
+
+  pShard->nVersioned++;
+
+  tdbDebug("pcache/park page %p/%d/%d", pPage, TDB_PAGE_PGNO(pPage), pPage->id);
+}
+
+static void tdbPCacheRemovePageFromHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage) {
+  uint32_t h = tdbPCacheBucket(pCache, pShard, &(pPage->pgid));
 
-  SPage **ppPage = &(pCache->pgHash[h]);
+  SPage **ppPage = &(pShard->pgHash[h]);
   for (; (*ppPage) && *ppPage != pPage; ppPage = &((*ppPage)->pHashNext))
     ;
 
   if (*ppPage) {
     *ppPage = pPage->pHashNext;
-    pCache->nPage--;
+    pShard->nPage--;
     // printf("rmv page %d to hash, pgno %d, pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   }
 
   tdbDebug("pcache/remove page %p/%d/%d from hash %" PRIu32, pPage, TDB_PAGE_PGNO(pPage), pPage->id, h);
 }
 
-static void tdbPCacheAddPageToHash(SPCache *pCache, SPage *pPage) {
-  uint32_t h = tdbPCachePageHash(&(pPage->pgid)) % pCache->nHash;
+static void tdbPCacheAddPageToHash(SPCache *pCache, SPCacheShard *pShard, SPage *pPage) {
+  uint32_t h = tdbPCacheBucket(pCache, pShard, &(pPage->pgid));
 
-  pPage->pHashNext = pCache->pgHash[h];
-  pCache->pgHash[h] = pPage;
+  pPage->pHashNext = pShard->pgHash[h];
+  pShard->pgHash[h] = pPage;
 
-  pCache->nPage++;
+  pShard->nPage++;
 
   // printf("add page %d to hash, pgno %d, pPage %p\n", pPage->id, TDB_PAGE_PGNO(pPage), pPage);
   tdbDebug("pcache/add page %p/%d/%d to hash %" PRIu32, pPage, TDB_PAGE_PGNO(pPage), pPage->id, h);
@@ -304,15 +661,54 @@ static int tdbPCacheOpenImpl(SPCache *pCache) {
   int    tsize;
   int    ret;
 
-  tdbPCacheInitLock(pCache);
+  // Open the shards, keep enough pages in each shard to recycle
+  pCache->nShard = 1;
+  while (pCache->nShard < TDB_PCACHE_MAX_SHARDS &&
+         pCache->nPages / (pCache->nShard * 2) >= TDB_PCACHE_MIN_SHARD_PAGES) {
+    pCache->nShard *= 2;
+  }
+  pCache->aShard = (SPCacheShard *)tdbOsCalloc(pCache->nShard, sizeof(SPCacheShard));
+  if (pCache->aShard == NULL) {
+    return -1;
+  }
 
-  // Open the free list
-  pCache->nFree = 0;
-  pCache->pFree = NULL;
+  // init all shards first, so a partially opened cache can be closed by tdbPCacheClose
+  for (int iShard = 0; iShard < pCache->nShard; iShard++) {
+    SPCacheShard *pShard = &pCache->aShard[iShard];
+
+    tdbPCacheInitLock(pShard);
+
+    // Open LRU list
+    pShard->nRecyclable = 0;
+    pShard->lru.isAnchor = 1;
+    pShard->lru.pLruNext = &(pShard->lru);
+    pShard->lru.pLruPrev = &(pShard->lru);
+
+    pShard->nVersioned = 0;
+    pShard->ver.isAnchor = 1;
+    pShard->ver.pLruNext = &(pShard->ver);
+    pShard->ver.pLruPrev = &(pShard->ver);
+  }
+
+  for (int iShard = 0; iShard < pCache->nShard; iShard++) {
+    SPCacheShard *pShard = &pCache->aShard[iShard];
+    int           nPages = pCache->nPages / pCache->nShard;
+
+    // Open the hash table
+    pShard->nPage = 0;
+    pShard->nHash = nPages < 8 ? 8 : nPages;
+    pShard->pgHash = (SPage **)tdbOsCalloc(pShard->nHash, sizeof(SPage *));
+    if (pShard->pgHash == NULL) {
+      return -1;
+    }
+  }
+
+  // Open the free list, pages are spread over the shards
   for (int i = 0; i < pCache->nPages; i++) {
+    SPCacheShard *pShard = &pCache->aShard[i % pCache->nShard];
+
     ret = tdbPageCreate(pCache->szPage, &pPage, tdbDefaultMalloc, NULL);
     if (ret < 0) {
-      // TODO: handle error
       return -1;
     }
 
@@ -326,42 +722,49 @@ static int tdbPCacheOpenImpl(SPCache *pCache) {
     pPage->pDirtyNext = NULL;
 
     // add page to free list
-    pPage->pFreeNext = pCache->pFree;
-    pCache->pFree = pPage;
-    pCache->nFree++;
+    pPage->pFreeNext = pShard->pFree;
+    pShard->pFree = pPage;
+    pShard->nFree++;
 
     // add to local list
     pPage->id = i;
     pCache->aPage[i] = pPage;
   }
 
-  // Open the hash table
-  pCache->nPage = 0;
-  pCache->nHash = pCache->nPages < 8 ? 8 : pCache->nPages;
-  pCache->pgHash = (SPage **)tdbOsCalloc(pCache->nHash, sizeof(SPage *));
-  if (pCache->pgHash == NULL) {
-    // TODO
-    return -1;
-  }
-
-  // Open LRU list
-  pCache->nRecyclable = 0;
-  pCache->lru.isAnchor = 1;
-  pCache->lru.pLruNext = &(pCache->lru);
-  pCache->lru.pLruPrev = &(pCache->lru);
-
   return 0;
 }
 
 static int tdbPCacheCloseImpl(SPCache *pCache) {
+  // the local pages are freed below, the parked ones of the writer here
+  for (int iShard = 0; pCache->aShard && iShard < pCache->nShard; iShard++) {
+    SPCacheShard *pShard = &pCache->aShard[iShard];
+    SPage        *pNext;
+
+    if (pShard->ver.pLruNext == NULL) continue;
+    for (SPage *pPage = pShard->ver.pLruNext; !pPage->isAnchor; pPage = pNext) {
+      pNext = pPage->pLruNext;
+      if (!pPage->isLocal) {
+        tdbPCacheDropVersions(pPage);
+        tdbPageDestroy(pPage, tdbDefaultFree, NULL);
+      }
+    }
+  }
+
   for (i32 iPage = 0; iPage < pCache->nPages; iPage++) {
     if (pCache->aPage[iPage]) {
+      tdbPCacheDropVersions(pCache->aPage[iPage]);
       tdbPageDestroy(pCache->aPage[iPage], tdbDefaultFree, NULL);
       pCache->aPage[iPage] = NULL;
     }
   }
 
-  tdbOsFree(pCache->pgHash);
-  tdbPCacheDestroyLock(pCache);
+  if (pCache->aShard) {
+    for (int iShard = 0; iShard < pCache->nShard; iShard++) {
+      tdbOsFree(pCache->aShard[iShard].pgHash);
+      tdbPCacheDestroyLock(&pCache->aShard[iShard]);
+    }
+    tdbOsFree(pCache->aShard);
+    pCache->aShard = NULL;
+  }
   return 0;
 }
@@ -14,6 +14,7 @@
  */
 
 #include "tdbInt.h"
+#include "tchecksum.h"
 
 #pragma pack(push, 1)
 typedef struct {
@@ -27,12 +28,63 @@ typedef struct {
 
 TDB_STATIC_ASSERT(sizeof(SFileHdr) == 128, "Size of file header is not correct");
 
+// In wal journal mode a commit appends the images of the dirty pages to the "-wal" file with one fsync, the main file
+// is left untouched. Readers resolve pages through the wal index first, and a checkpoint copies the latest image of
+// each page back into the main file and truncates the wal.
+#define TDB_WAL_CKPT_FRAMES 1000   // checkpoint is worth doing
+#define TDB_WAL_MAX_FRAMES  20000  // checkpoint inline on commit
+
+#pragma pack(push, 1)
+typedef struct {
+  SPgno pgno;
+  SPgno commitSize;  // size of the db in pages on the last frame of a commit, 0 otherwise
+  u32   cksum;
+} SWalFrameHdr;
+#pragma pack(pop)
+
+struct SPagerWal {
+  char          *fileName;
+  tdb_fd_t       fd;
+  i64            size;    // size of the committed frames in bytes
+  int            nFrame;  // number of committed frames
+  SHashObj      *pIdx;    // pgno -> offset of the latest committed frame
+  TdThreadRwlock lock;    // protect pIdx between readers and commit/checkpoint
+  tdb_mutex_t    mutex;   // serialize commit and checkpoint
+};
+
+#define TDB_WAL_FRAME_SIZE(pageSize) ((i64)sizeof(SWalFrameHdr) + (pageSize))
+
+// In mmap read mode a page missing from the page cache is copied out of a read-only shared mapping of the db file,
+// so a miss costs a memcpy from the OS page cache rather than a pread. The mapping is grown geometrically by the
+// writer when the file outgrows it; retired regions stay mapped until close since readers may still be on them.
+#define TDB_MMAP_MIN_SIZE (4 * 1024 * 1024)
+
+typedef struct SMmapRegion SMmapRegion;
+struct SMmapRegion {
+  u8          *pAddr;
+  i64          len;
+  SMmapRegion *pPrev;
+};
+
+struct SPagerMmap {
+  SMmapRegion *pRegion;   // current region
+  i64          fileSize;  // bytes of the db file readers may take from the region
+  tdb_mutex_t  mutex;     // serialize refreshes from commit and checkpoint
+};
+
 #define TDB_PAGE_INITIALIZED(pPage) ((pPage)->pPager != NULL)
 
 static int tdbPagerInitPage(SPager *pPager, SPage *pPage, int (*initPage)(SPage *, void *, int), void *arg,
                             u8 loadPage);
 static int tdbPagerWritePageToJournal(SPager *pPager, SPage *pPage);
 static int tdbPagerWritePageToDB(SPager *pPager, SPage *pPage);
+static int tdbPagerRestoreWal(SPager *pPager);
+static int tdbPagerWriteWal(SPager *pPager);
+static int tdbPagerReadPageFromWal(SPager *pPager, SPgno pgno, u8 *pData);
+static int tdbPagerCloseWal(SPager *pPager);
+static void tdbPagerFreeWal(SPager *pPager, bool toRemove);
+static int tdbPagerReadPageFromMmap(SPager *pPager, SPgno pgno, u8 *pData);
+static int tdbPagerRefreshMmap(SPager *pPager);
 
 static FORCE_INLINE int32_t pageCmpFn(const void *lhs, const void *rhs) {
   SPage *pPageL = (SPage *)(((uint8_t *)lhs) - sizeof(SRBTreeNode));
@@ -95,6 +147,13 @@ int tdbPagerOpen(SPCache *pCache, const char *fileName, SPager **ppPager) {
 
   // pPager->jfd = -1;
   pPager->pageSize = tdbPCacheGetPageSize(pCache);
+
+  // fold the committed frames of a wal left by last run into the db file
+  ret = tdbPagerRestoreWal(pPager);
+  if (ret < 0) {
+    return -1;
+  }
+
   // pPager->dbOrigSize
   ret = tdbGetFileSize(pPager->fd, pPager->pageSize, &(pPager->dbOrigSize));
   pPager->dbFileSize = pPager->dbOrigSize;
@@ -107,9 +166,15 @@ int tdbPagerOpen(SPCache *pCache, const char *fileName, SPager **ppPager) {
 
 int tdbPagerClose(SPager *pPager) {
   if (pPager) {
-    if (pPager->inTran) {
+    if (pPager->pWal) {
+      // keep the wal file if the checkpoint fails, it is restored on next open
+      if (tdbPagerCloseWal(pPager) < 0) {
+        tdbPagerFreeWal(pPager, false);
+      }
+    } else if (pPager->inTran) {
       tdbOsClose(pPager->jfd);
     }
+    tdbPagerSetMmapRead(pPager, false);
     tdbOsClose(pPager->fd);
     tdbOsFree(pPager);
   }
@@ -180,6 +245,11 @@ int tdbPagerWrite(SPager *pPager, SPage *pPage) {
   }
 #endif
 
+  // keep the image for the snapshot readers before the page is changed, dirty or not
+  if (tdbPCacheSaveVersion(pPager->pCache, pPage) < 0) {
+    return -1;
+  }
+
   if (pPage->isDirty) return 0;
 
   // ref page one more time so the page will not be release
@@ -207,7 +277,7 @@ int tdbPagerWrite(SPager *pPager, SPage *pPage) {
   tRBTreePut(&pPager->rbt, (SRBTreeNode *)pPage);
 
   // Write page to journal if neccessary
-  if (TDB_PAGE_PGNO(pPage) <= pPager->dbOrigSize) {
+  if (pPager->pWal == NULL && TDB_PAGE_PGNO(pPage) <= pPager->dbOrigSize) {
     ret = tdbPagerWritePageToJournal(pPager, pPage);
     if (ret < 0) {
       ASSERT(0);
@@ -223,6 +293,11 @@ int tdbPagerBegin(SPager *pPager, TXN *pTxn) {
     return 0;
   }
 
+  if (pPager->pWal) {
+    pPager->inTran = 1;
+    return 0;
+  }
+
   // Open the journal
   pPager->jfd = tdbOsOpen(pPager->jFileName, TDB_O_CREAT | TDB_O_RDWR, 0755);
   if (pPager->jfd < 0) {
@@ -237,27 +312,37 @@ int tdbPagerBegin(SPager *pPager, TXN *pTxn) {
 }
 
 int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
-  SPage *pPage;
-  int    ret;
-
-  // sync the journal file
-  ret = tdbOsFSync(pPager->jfd);
-  if (ret < 0) {
-    // TODO
-    ASSERT(0);
-    return 0;
-  }
-
-  // loop to write the dirty pages to file
-  SRBTreeIter  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+  SPage       *pPage;
+  int          ret;
+  SRBTreeIter  iter;
   SRBTreeNode *pNode = NULL;
-  while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
-    pPage = (SPage *)pNode;
-    ret = tdbPagerWritePageToDB(pPager, pPage);
+
+  if (pPager->pWal) {
+    // append the dirty pages to the wal with one sync
+    ret = tdbPagerWriteWal(pPager);
     if (ret < 0) {
       ASSERT(0);
       return -1;
     }
+  } else {
+    // sync the journal file
+    ret = tdbOsFSync(pPager->jfd);
+    if (ret < 0) {
+      // TODO
+      ASSERT(0);
+      return 0;
+    }
+
+    // loop to write the dirty pages to file
+    iter = tRBTreeIterCreate(&pPager->rbt, 1);
+    while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+      pPage = (SPage *)pNode;
+      ret = tdbPagerWritePageToDB(pPager, pPage);
+      if (ret < 0) {
+        ASSERT(0);
+        return -1;
+      }
+    }
   }
 
   tdbTrace("tdbttl commit:%p, %d/%d", pPager, pPager->dbOrigSize, pPager->dbFileSize);
@@ -276,8 +361,19 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
 
   tRBTreeCreate(&pPager->rbt, pageCmpFn);
 
+  if (pPager->pWal) {
+    pPager->inTran = 0;
+
+    // the background checkpoint is falling behind, do it here
+    if (pPager->pWal->nFrame >= TDB_WAL_MAX_FRAMES) {
+      tdbPagerCheckpoint(pPager);
+    }
+    return 0;
+  }
+
   // sync the db file
   tdbOsFSync(pPager->fd);
+  tdbPagerRefreshMmap(pPager);
 
   // remove the journal file
   tdbOsClose(pPager->jfd);
@@ -294,6 +390,22 @@ int tdbPagerAbort(SPager *pPager, TXN *pTxn) {
   SPgno  journalSize = 0;
   int    ret;
 
+  if (pPager->pWal) {
+    // nothing was written out in wal mode
+    SRBTreeIter  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+    SRBTreeNode *pNode = NULL;
+    while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+      pPage = (SPage *)pNode;
+      pPage->isDirty = 0;
+      tRBTreeDrop(&pPager->rbt, (SRBTreeNode *)pPage);
+      tdbPCacheRelease(pPager->pCache, pPage, pTxn);
+    }
+    tRBTreeCreate(&pPager->rbt, pageCmpFn);
+    pPager->dbFileSize = pPager->dbOrigSize;
+    pPager->inTran = 0;
+    return 0;
+  }
+
   // 0, sync the journal file
   ret = tdbOsFSync(pPager->jfd);
   if (ret < 0) {
@@ -394,6 +506,13 @@ int tdbPagerFetchPage(SPager *pPager, SPgno *ppgno, SPage **ppPage, int (*initPa
       ASSERT(0);
       return -1;
     }
+
+    // the page is loaded into the cache for a snapshot reader, fetch again for a copy of it
+    if (TDB_TXN_IS_SNAPSHOT(pTxn) && pPage->isLocal) {
+      SPage *pCopy = tdbPCacheFetch(pPager->pCache, &pgid, pTxn);
+      tdbPCacheRelease(pPager->pCache, pPage, pTxn);
+      pPage = pCopy;
+    }
   }
 
   // printf("thread %" PRId64 " pager fetch page %d pgno %d ppage %p\n", taosGetSelfPthreadId(), pPage->id,
@@ -469,11 +588,18 @@ static int tdbPagerInitPage(SPager *pPager, SPage *pPage, int (*initPage)(SPage
     if (loadPage && pgno <= pPager->dbOrigSize) {
       init = 1;
 
-      nRead = tdbOsPRead(pPager->fd, pPage->pData, pPage->pageSize, ((i64)pPage->pageSize) * (pgno - 1));
-      tdbTrace("tdbttl pager:%p, pgno:%d, nRead:%" PRId64, pPager, pgno, nRead);
-      if (nRead < pPage->pageSize) {
+      ret = pPager->pWal ? tdbPagerReadPageFromWal(pPager, pgno, pPage->pData) : 0;
+      if (ret < 0) {
         ASSERT(0);
+        TDB_UNLOCK_PAGE(pPage);
         return -1;
+      } else if (ret == 0 && (pPager->pMmap == NULL || tdbPagerReadPageFromMmap(pPager, pgno, pPage->pData) == 0)) {
+        nRead = tdbOsPRead(pPager->fd, pPage->pData, pPage->pageSize, ((i64)pPage->pageSize) * (pgno - 1));
+        tdbTrace("tdbttl pager:%p, pgno:%d, nRead:%" PRId64, pPager, pgno, nRead);
+        if (nRead < pPage->pageSize) {
+          ASSERT(0);
+          return -1;
+        }
       }
     } else {
       init = 0;
@@ -610,3 +736,382 @@ int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
 
   return 0;
 }
+
+// ---------------------------- WAL manipulation
+static u32 tdbWalFrameChecksum(SWalFrameHdr *pHdr, const u8 *pData, int pageSize) {
+  u32 cksum = taosCalcChecksum(0, (const uint8_t *)pHdr, offsetof(SWalFrameHdr, cksum));
+  return taosCalcChecksum(cksum, pData, pageSize);
+}
+
+static int tdbPagerRestoreWal(SPager *pPager) {
+  char     fname[TDB_FILENAME_LEN + 8];
+  tdb_fd_t wfd;
+  i64      wsize = 0;
+  i64      validSize = 0;
+  SPgno    commitSize = 0;
+  i64      szFrame = TDB_WAL_FRAME_SIZE(pPager->pageSize);
+  u8      *pFrame = NULL;
+  int      nFrame = 0;
+  int      ret = 0;
+
+  snprintf(fname, sizeof(fname), "%s-wal", pPager->dbFileName);
+  if (!taosCheckExistFile(fname)) {
+    return 0;
+  }
+
+  wfd = tdbOsOpen(fname, TDB_O_READ, 0755);
+  if (wfd == NULL) {
+    return -1;
+  }
+
+  if (tdbOsFileSize(wfd, &wsize) < 0 || (pFrame = tdbOsMalloc(szFrame)) == NULL) {
+    tdbOsClose(wfd);
+    return -1;
+  }
+
+  // find the end of the last complete commit, a torn tail is dropped
+  for (i64 offset = 0; offset + szFrame <= wsize; offset += szFrame) {
+    SWalFrameHdr *pHdr = (SWalFrameHdr *)pFrame;
+    if (tdbOsPRead(wfd, pFrame, szFrame, offset) < szFrame) break;
+    if (pHdr->cksum != tdbWalFrameChecksum(pHdr, pFrame + sizeof(*pHdr), pPager->pageSize)) break;
+    if (pHdr->commitSize > 0) {
+      validSize = offset + szFrame;
+      commitSize = pHdr->commitSize;
+    }
+  }
+
+  // copy the frames in order, so the latest image of each page wins
+  for (i64 offset = 0; offset < validSize; offset += szFrame) {
+    SWalFrameHdr *pHdr = (SWalFrameHdr *)pFrame;
+    if (tdbOsPRead(wfd, pFrame, szFrame, offset) < szFrame ||
+        tdbOsLSeek(pPager->fd, (i64)pPager->pageSize * (pHdr->pgno - 1), SEEK_SET) < 0 ||
+        tdbOsWrite(pPager->fd, pFrame + sizeof(*pHdr), pPager->pageSize) < 0) {
+      ret = -1;
+      break;
+    }
+    nFrame++;
+  }
+
+  // pages beyond the size of the last commit are left by a torn transaction
+  if (ret == 0 && nFrame > 0) {
+    ret = taosFtruncateFile(pPager->fd, (i64)pPager->pageSize * commitSize);
+  }
+
+  if (ret == 0 && nFrame > 0) {
+    ret = tdbOsFSync(pPager->fd);
+  }
+
+  tdbOsFree(pFrame);
+  tdbOsClose(wfd);
+  if (ret < 0) {
+    tdbError("failed to restore wal %s", fname);
+    return -1;
+  }
+
+  tdbInfo("restore %d frames from wal %s, size:%" PRId64 " valid:%" PRId64, nFrame, fname, wsize, validSize);
+  tdbOsRemove(fname);
+  return 0;
+}
+
+static int tdbPagerWriteWal(SPager *pPager) {
+  SPagerWal   *pWal = pPager->pWal;
+  i64          szFrame = TDB_WAL_FRAME_SIZE(pPager->pageSize);
+  int          nDirty = 0;
+  u8          *pBuf = NULL;
+  SRBTreeIter  iter;
+  SRBTreeNode *pNode = NULL;
+  int          ret = 0;
+
+  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+  while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+    nDirty++;
+  }
+  if (nDirty == 0) {
+    return 0;
+  }
+
+  pBuf = tdbOsMalloc(szFrame * nDirty);
+  if (pBuf == NULL) {
+    return -1;
+  }
+
+  int iFrame = 0;
+  iter = tRBTreeIterCreate(&pPager->rbt, 1);
+  while ((pNode = tRBTreeIterNext(&iter)) != NULL) {
+    SPage        *pPage = (SPage *)pNode;
+    SWalFrameHdr *pHdr = (SWalFrameHdr *)(pBuf + szFrame * iFrame);
+
+    iFrame++;
+    pHdr->pgno = TDB_PAGE_PGNO(pPage);
+    pHdr->commitSize = (iFrame == nDirty) ? pPager->dbFileSize : 0;
+    memcpy(&pHdr[1], pPage->pData, pPager->pageSize);
+    pHdr->cksum = tdbWalFrameChecksum(pHdr, (u8 *)&pHdr[1], pPager->pageSize);
+  }
+
+  tdbMutexLock(&pWal->mutex);
+
+  if (tdbOsLSeek(pWal->fd, pWal->size, SEEK_SET) < 0 || tdbOsWrite(pWal->fd, pBuf, szFrame * nDirty) < 0 ||
+      tdbOsFSync(pWal->fd) < 0) {
+    tdbError("failed to write %d frames to wal %s", nDirty, pWal->fileName);
+    ret = -1;
+  } else {
+    // publish the frames to readers
+    taosThreadRwlockWrlock(&pWal->lock);
+    for (iFrame = 0; iFrame < nDirty; iFrame++) {
+      SWalFrameHdr *pHdr = (SWalFrameHdr *)(pBuf + szFrame * iFrame);
+      i64           offset = pWal->size + szFrame * iFrame;
+      taosHashPut(pWal->pIdx, &pHdr->pgno, sizeof(pHdr->pgno), &offset, sizeof(offset));
+    }
+    pWal->size += szFrame * nDirty;
+    pWal->nFrame += nDirty;
+    taosThreadRwlockUnlock(&pWal->lock);
+  }
+
+  tdbMutexUnlock(&pWal->mutex);
+
+  tdbOsFree(pBuf);
+  return ret;
+}
+
+// return 1 if the page is read from wal, 0 if the page is not in wal
+static int tdbPagerReadPageFromWal(SPager *pPager, SPgno pgno, u8 *pData) {
+  SPagerWal *pWal = pPager->pWal;
+  int        ret = 0;
+
+  taosThreadRwlockRdlock(&pWal->lock);
+  i64 *pOffset = taosHashGet(pWal->pIdx, &pgno, sizeof(pgno));
+  if (pOffset) {
+    i64 nRead = tdbOsPRead(pWal->fd, pData, pPager->pageSize, *pOffset + sizeof(SWalFrameHdr));
+    ret = (nRead < pPager->pageSize) ? -1 : 1;
+  }
+  taosThreadRwlockUnlock(&pWal->lock);
+
+  return ret;
+}
+
+int tdbPagerCheckpoint(SPager *pPager) {
+  SPagerWal *pWal = pPager->pWal;
+  u8        *pData = NULL;
+  void      *pIter = NULL;
+  int        nFrame = 0;
+  int        ret = 0;
+
+  if (pWal == NULL) return 0;
+
+  tdbMutexLock(&pWal->mutex);
+
+  if (pWal->nFrame == 0) {
+    tdbMutexUnlock(&pWal->mutex);
+    return 0;
+  }
+
+  pData = tdbOsMalloc(pPager->pageSize);
+  if (pData == NULL) {
+    tdbMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
+  // the index is only changed by commit, which is blocked by the mutex, readers still go to the wal meanwhile
+  while ((pIter = taosHashIterate(pWal->pIdx, pIter)) != NULL) {
+    SPgno pgno = *(SPgno *)taosHashGetKey(pIter, NULL);
+    i64   offset = *(i64 *)pIter;
+
+    if (tdbOsPRead(pWal->fd, pData, pPager->pageSize, offset + sizeof(SWalFrameHdr)) < pPager->pageSize ||
+        tdbOsLSeek(pPager->fd, (i64)pPager->pageSize * (pgno - 1), SEEK_SET) < 0 ||
+        tdbOsWrite(pPager->fd, pData, pPager->pageSize) < 0) {
+      taosHashCancelIterate(pWal->pIdx, pIter);
+      ret = -1;
+      break;
+    }
+    nFrame++;
+  }
+
+  if (ret == 0) {
+    ret = tdbOsFSync(pPager->fd);
+  }
+
+  if (ret == 0) {
+    tdbPagerRefreshMmap(pPager);
+
+    // pages are in the db file now, reset the wal
+    taosThreadRwlockWrlock(&pWal->lock);
+    ret = taosFtruncateFile(pWal->fd, 0);
+    taosHashClear(pWal->pIdx);
+    pWal->size = 0;
+    pWal->nFrame = 0;
+    taosThreadRwlockUnlock(&pWal->lock);
+  }
+
+  tdbMutexUnlock(&pWal->mutex);
+  tdbOsFree(pData);
+
+  if (ret < 0) {
+    tdbError("failed to checkpoint wal %s", pWal->fileName);
+    return -1;
+  }
+
+  tdbDebug("checkpoint %d pages from wal %s", nFrame, pWal->fileName);
+  return 0;
+}
+
+bool tdbPagerNeedCheckpoint(SPager *pPager) {
+  return pPager->pWal && atomic_load_32(&pPager->pWal->nFrame) >= TDB_WAL_CKPT_FRAMES;
+}
+
+static void tdbPagerFreeWal(SPager *pPager, bool toRemove) {
+  SPagerWal *pWal = pPager->pWal;
+
+  pPager->pWal = NULL;
+  tdbOsClose(pWal->fd);
+  if (toRemove) {
+    tdbOsRemove(pWal->fileName);
+  }
+  taosHashCleanup(pWal->pIdx);
+  taosThreadRwlockDestroy(&pWal->lock);
+  tdbMutexDestroy(&pWal->mutex);
+  tdbOsFree(pWal);
+}
+
+// the wal is removed only after all frames are in the db file, if the checkpoint fails the wal stays open
+static int tdbPagerCloseWal(SPager *pPager) {
+  if (tdbPagerCheckpoint(pPager) < 0) {
+    return -1;
+  }
+
+  tdbPagerFreeWal(pPager, true);
+  return 0;
+}
+
+int tdbPagerSetJournalMode(SPager *pPager, int8_t mode) {
+  SPagerWal *pWal = pPager->pWal;
+
+  if ((mode == TDB_JOURNAL_MODE_WAL) == (pWal != NULL)) {
+    return 0;
+  }
+
+  // switch between transactions only
+  if (pPager->inTran) {
+    return -1;
+  }
+
+  if (mode == TDB_JOURNAL_MODE_WAL) {
+    int fsize = strlen(pPager->dbFileName);
+    pWal = (SPagerWal *)tdbOsCalloc(1, sizeof(*pWal) + fsize + 5);
+    if (pWal == NULL) {
+      return -1;
+    }
+
+    pWal->fileName = (char *)&pWal[1];
+    snprintf(pWal->fileName, fsize + 5, "%s-wal", pPager->dbFileName);
+    pWal->fd = tdbOsOpen(pWal->fileName, TDB_O_CREAT | TDB_O_RDWR | TDB_O_TRUNC, 0755);
+    if (pWal->fd == NULL) {
+      tdbOsFree(pWal);
+      return -1;
+    }
+
+    pWal->pIdx = taosHashInit(1024, taosIntHash_32, true, HASH_NO_LOCK);
+    if (pWal->pIdx == NULL) {
+      tdbOsClose(pWal->fd);
+      tdbOsRemove(pWal->fileName);
+      tdbOsFree(pWal);
+      return -1;
+    }
+
+    taosThreadRwlockInit(&pWal->lock, NULL);
+    tdbMutexInit(&pWal->mutex, NULL);
+    pPager->pWal = pWal;
+  } else {
+    if (tdbPagerCloseWal(pPager) < 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// ---------------------------- mmap read
+// return 1 if the page is copied from the mapping, 0 if it is not mapped yet
+static int tdbPagerReadPageFromMmap(SPager *pPager, SPgno pgno, u8 *pData) {
+  SPagerMmap  *pMmap = pPager->pMmap;
+  i64          offset = (i64)pPager->pageSize * (pgno - 1);
+  SMmapRegion *pRegion = (SMmapRegion *)atomic_load_ptr(&pMmap->pRegion);
+
+  if (pRegion == NULL || offset + pPager->pageSize > pRegion->len ||
+      offset + pPager->pageSize > atomic_load_64(&pMmap->fileSize)) {
+    return 0;
+  }
+
+  memcpy(pData, pRegion->pAddr + offset, pPager->pageSize);
+  return 1;
+}
+
+static int tdbPagerRefreshMmap(SPager *pPager) {
+  SPagerMmap *pMmap = pPager->pMmap;
+  i64         size = 0;
+  int         ret = 0;
+
+  if (pMmap == NULL) return 0;
+
+  if (tdbOsFileSize(pPager->fd, &size) < 0) {
+    return -1;
+  }
+
+  tdbMutexLock(&pMmap->mutex);
+
+  SMmapRegion *pRegion = pMmap->pRegion;
+  if (size > 0 && (pRegion == NULL || size > pRegion->len)) {
+    SMmapRegion *pNew = tdbOsCalloc(1, sizeof(*pNew));
+    if (pNew) {
+      pNew->len = TMAX(size * 2, TDB_MMAP_MIN_SIZE);
+      pNew->pAddr = tdbOsMmap(pPager->fd, pNew->len);
+    }
+
+    if (pNew == NULL || pNew->pAddr == NULL) {
+      // pages beyond the current region go to pread meanwhile
+      tdbError("failed to mmap %s, size:%" PRId64, pPager->dbFileName, size);
+      tdbOsFree(pNew);
+      ret = -1;
+    } else {
+      pNew->pPrev = pRegion;
+      atomic_store_ptr(&pMmap->pRegion, pNew);
+    }
+  }
+
+  if (ret == 0) {
+    atomic_store_64(&pMmap->fileSize, size);
+  }
+
+  tdbMutexUnlock(&pMmap->mutex);
+  return ret;
+}
+
+int tdbPagerSetMmapRead(SPager *pPager, bool enable) {
+  SPagerMmap *pMmap = pPager->pMmap;
+
+  if (enable == (pMmap != NULL)) {
+    return 0;
+  }
+
+  if (enable) {
+    pMmap = (SPagerMmap *)tdbOsCalloc(1, sizeof(*pMmap));
+    if (pMmap == NULL) {
+      return -1;
+    }
+    tdbMutexInit(&pMmap->mutex, NULL);
+    pPager->pMmap = pMmap;
+
+    return tdbPagerRefreshMmap(pPager);
+  }
+
+  // only switched off on close, when no reader is left
+  pPager->pMmap = NULL;
+  for (SMmapRegion *pRegion = pMmap->pRegion; pRegion;) {
+    SMmapRegion *pPrev = pRegion->pPrev;
+    tdbOsMunmap(pRegion->pAddr, pRegion->len);
+    tdbOsFree(pRegion);
+    pRegion = pPrev;
+  }
+  tdbMutexDestroy(&pMmap->mutex);
+  tdbOsFree(pMmap);
+  return 0;
+}
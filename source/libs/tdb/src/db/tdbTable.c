@@ -24,6 +24,10 @@ struct STBC {
   SBTC btc;
 };
 
+struct STBL {
+  SBtLoader *pLoader;
+};
+
 int tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprFn, TDB *pEnv, TTB **ppTb) {
   TTB    *pTb;
   SPager *pPager;
@@ -74,9 +78,15 @@ int tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprF
         return -1;
       }
 
-      tdbEnvAddPager(pEnv, pPager);
-
       pPager->pEnv = pEnv;
+
+      if (tdbPagerSetJournalMode(pPager, pEnv->jMode) < 0 || tdbPagerSetMmapRead(pPager, pEnv->mmapRead) < 0) {
+        tdbPagerClose(pPager);
+        tdbOsFree(pTb);
+        return -1;
+      }
+
+      tdbEnvAddPager(pEnv, pPager);
     }
 
     if (pPager->dbOrigSize > 0) {
@@ -96,6 +106,12 @@ int tdbTbOpen(const char *tbname, int keyLen, int valLen, tdb_cmpr_fn_t keyCmprF
       return -1;
     }
 
+    if (tdbPagerSetJournalMode(pPager, pEnv->jMode) < 0 || tdbPagerSetMmapRead(pPager, pEnv->mmapRead) < 0) {
+      tdbPagerClose(pPager);
+      tdbOsFree(pTb);
+      return -1;
+    }
+
     tdbEnvAddPager(pEnv, pPager);
   }
 
@@ -149,6 +165,43 @@ int tdbTbPGet(TTB *pTb, const void *pKey, int kLen, void **ppKey, int *pkLen, vo
   return tdbBtreePGet(pTb->pBt, pKey, kLen, ppKey, pkLen, ppVal, vLen);
 }
 
+int tdbTbCmpr(TTB *pTb, const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  return tdbBtreeCmpr(pTb->pBt, pKey1, kLen1, pKey2, kLen2);
+}
+
+int tdbTbBulkOpen(TTB *pTb, int fillFactor, TXN *pTxn, TBL **ppTbl) {
+  TBL *pTbl = NULL;
+
+  *ppTbl = NULL;
+  pTbl = (TBL *)tdbOsMalloc(sizeof(*pTbl));
+  if (pTbl == NULL) {
+    return -1;
+  }
+
+  if (tdbBtreeBulkOpen(pTb->pBt, fillFactor, pTxn, &pTbl->pLoader) < 0) {
+    tdbOsFree(pTbl);
+    return -1;
+  }
+
+  *ppTbl = pTbl;
+  return 0;
+}
+
+int tdbTbBulkPut(TBL *pTbl, const void *pKey, int kLen, const void *pVal, int vLen) {
+  return tdbBtreeBulkPut(pTbl->pLoader, pKey, kLen, pVal, vLen);
+}
+
+int tdbTbBulkClose(TBL *pTbl) {
+  int ret = 0;
+
+  if (pTbl) {
+    ret = tdbBtreeBulkClose(pTbl->pLoader);
+    tdbOsFree(pTbl);
+  }
+
+  return ret;
+}
+
 int tdbTbcOpen(TTB *pTb, TBC **ppTbc, TXN *pTxn) {
   int  ret;
   TBC *pTbc = NULL;
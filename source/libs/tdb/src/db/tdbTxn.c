@@ -25,6 +25,7 @@ int tdbTxnOpen(TXN *pTxn, int64_t txnid, void *(*xMalloc)(void *, size_t), void
   pTxn->xMalloc = xMalloc;
   pTxn->xFree = xFree;
   pTxn->xArg = xArg;
+  pTxn->snapshot = 0;
   return 0;
 }
 
@@ -102,6 +102,7 @@ typedef struct SPage   SPage;
 #define TDB_TXN_IS_WRITE(PTXN)            ((PTXN)->flags & TDB_TXN_WRITE)
 #define TDB_TXN_IS_READ(PTXN)             (!TDB_TXN_IS_WRITE(PTXN))
 #define TDB_TXN_IS_READ_UNCOMMITTED(PTXN) ((PTXN)->flags & TDB_TXN_READ_UNCOMMITTED)
+#define TDB_TXN_IS_SNAPSHOT(PTXN)         (TDB_TXN_IS_READ(PTXN) && (PTXN)->snapshot > 0)
 
 // tdbEnv.c ====================================
 void    tdbEnvAddPager(TDB *pEnv, SPager *pPager);
@@ -111,6 +112,16 @@ SPager *tdbEnvGetPager(TDB *pEnv, const char *fname);
 // tdbBtree.c ====================================
 typedef struct SBTree SBTree;
 typedef struct SBTC   SBTC;
+typedef struct STdbSnap STdbSnap;
+typedef struct SPageVer SPageVer;
+
+// a pinned snapshot, see tdbPCache.c
+struct STdbSnap {
+  i64       epoch;
+  SPCache  *pCache;
+  STdbSnap *pPrev;
+  STdbSnap *pNext;
+};
 typedef struct SBtInfo {
   SPgno root;
   int   nLevel;
@@ -148,6 +159,7 @@ struct SBTC {
   SCellDecoder coder;
   TXN         *pTxn;
   TXN          txn;
+  STdbSnap     snap;  // snapshot pinned by the cursor itself, if any
 };
 
 // SBTree
@@ -159,10 +171,20 @@ int tdbBtreeDelete(SBTree *pBt, const void *pKey, int kLen, TXN *pTxn);
 int tdbBtreeUpsert(SBTree *pBt, const void *pKey, int nKey, const void *pData, int nData, TXN *pTxn);
 int tdbBtreeGet(SBTree *pBt, const void *pKey, int kLen, void **ppVal, int *vLen);
 int tdbBtreePGet(SBTree *pBt, const void *pKey, int kLen, void **ppKey, int *pkLen, void **ppVal, int *vLen);
+int tdbBtreeCmpr(SBTree *pBt, const void *pKey1, int kLen1, const void *pKey2, int kLen2);
+
+// SBtLoader
+typedef struct SBtLoader SBtLoader;
+
+int tdbBtreeBulkOpen(SBTree *pBt, int fillFactor, TXN *pTxn, SBtLoader **ppLoader);
+int tdbBtreeBulkPut(SBtLoader *pLoader, const void *pKey, int kLen, const void *pVal, int vLen);
+int tdbBtreeBulkClose(SBtLoader *pLoader);
 
 typedef struct {
-  u8      flags;
-  SBTree *pBt;
+  u8        flags;
+  SBTree   *pBt;
+  const u8 *pPfx;  // key prefix of a zeroed prefix compressed page
+  int       nPfx;
 } SBtreeInitPageArg;
 
 int tdbBtreeInitPage(SPage *pPage, void *arg, int init);
@@ -196,6 +218,10 @@ int  tdbPagerFetchPage(SPager *pPager, SPgno *ppgno, SPage **ppPage, int (*initP
 void tdbPagerReturnPage(SPager *pPager, SPage *pPage, TXN *pTxn);
 int  tdbPagerAllocPage(SPager *pPager, SPgno *ppgno);
 int  tdbPagerRestore(SPager *pPager, SBTree *pBt);
+int  tdbPagerSetJournalMode(SPager *pPager, int8_t mode);
+int  tdbPagerSetMmapRead(SPager *pPager, bool enable);
+int  tdbPagerCheckpoint(SPager *pPager);
+bool tdbPagerNeedCheckpoint(SPager *pPager);
 
 // tdbPCache.c ====================================
 #define TDB_PCACHE_PAGE    \
@@ -210,7 +236,9 @@ int  tdbPagerRestore(SPager *pPager, SBTree *pBt);
   SPage       *pLruPrev;   \
   SPage       *pDirtyNext; \
   SPager      *pPager;     \
-  SPgid        pgid;
+  SPgid        pgid;       \
+  i64          epoch;      \
+  SPageVer    *pVer;
 
 // For page ref
 
@@ -220,6 +248,23 @@ SPage *tdbPCacheFetch(SPCache *pCache, const SPgid *pPgid, TXN *pTxn);
 void   tdbPCacheRelease(SPCache *pCache, SPage *pPage, TXN *pTxn);
 int    tdbPCacheGetPageSize(SPCache *pCache);
 
+// Snapshot reads: the writer keeps the image a page had before it is first changed in an epoch, so a reader pinned
+// to an epoch copies the page as of that epoch and never waits for the writer. An epoch ends on tdbPCachePublish().
+// Versions outlive the txn, a page keeps them until tdbPCacheRetire() finds no snapshot pinned before they ended.
+void tdbPCacheSetSnapshotRead(SPCache *pCache, bool enable);
+bool tdbPCacheSnapshotRead(SPCache *pCache);
+void tdbPCacheReadBegin(SPCache *pCache);
+void tdbPCacheReadBeginAt(SPCache *pCache, STdbSnap *pSnap);
+void tdbPCacheReadEnd(SPCache *pCache);
+bool tdbPCacheInRead(SPCache *pCache);
+bool tdbPCacheReadIsLatest(SPCache *pCache);
+i64  tdbPCacheSnapshotOpen(SPCache *pCache, STdbSnap *pSnap);
+void tdbPCacheSnapshotClose(STdbSnap *pSnap);
+void tdbPCachePublish(SPCache *pCache);
+void tdbPCacheRetire(SPCache *pCache);
+int  tdbPCacheSaveVersion(SPCache *pCache, SPage *pPage);
+void tdbPCacheDropVersions(SPage *pPage);
+
 // tdbPage.c ====================================
 typedef u8 SCell;
 
@@ -371,6 +416,8 @@ struct STDB {
   char    *jnName;
   int      jfd;
   SPCache *pCache;
+  int8_t   jMode;
+  bool     mmapRead;
   SPager  *pgrList;
   int      nPager;
   int      nPgrHash;
@@ -380,21 +427,26 @@ struct STDB {
 #endif
 };
 
+typedef struct SPagerWal  SPagerWal;
+typedef struct SPagerMmap SPagerMmap;
+
 struct SPager {
-  char    *dbFileName;
-  char    *jFileName;
-  int      pageSize;
-  uint8_t  fid[TDB_FILE_ID_LEN];
-  tdb_fd_t fd;
-  tdb_fd_t jfd;
-  SPCache *pCache;
-  SPgno    dbFileSize;
-  SPgno    dbOrigSize;
-  SPage   *pDirty;
-  SRBTree  rbt;
-  u8       inTran;
-  SPager  *pNext;      // used by TDB
-  SPager  *pHashNext;  // used by TDB
+  char      *dbFileName;
+  char      *jFileName;
+  int        pageSize;
+  uint8_t    fid[TDB_FILE_ID_LEN];
+  tdb_fd_t   fd;
+  tdb_fd_t   jfd;
+  SPagerWal  *pWal;   // not NULL in wal journal mode
+  SPagerMmap *pMmap;  // not NULL in mmap read mode
+  SPCache    *pCache;
+  SPgno      dbFileSize;
+  SPgno      dbOrigSize;
+  SPage     *pDirty;
+  SRBTree    rbt;
+  u8         inTran;
+  SPager    *pNext;      // used by TDB
+  SPager    *pHashNext;  // used by TDB
 #ifdef USE_MAINDB
   TDB *pEnv;
 #endif
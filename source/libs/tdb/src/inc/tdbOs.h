@@ -54,6 +54,8 @@ typedef TdFilePtr tdb_fd_t;
 #define tdbOsLSeek               taosLSeekFile
 #define tdbOsRemove              remove
 #define tdbOsFileSize(FD, PSIZE) taosFStatFile(FD, PSIZE, NULL)
+#define tdbOsMmap(FD, LEN)       taosMmapReadOnlyFile(FD, LEN)
+#define tdbOsMunmap(PTR, LEN)    taosMunmapFile(PTR, LEN)
 
 /* directory */
 #define tdbOsMkdir taosMkDir
@@ -77,6 +79,9 @@ typedef TdThreadMutex tdb_mutex_t;
 #define tdbMutexLock    taosThreadMutexLock
 #define tdbMutexUnlock  taosThreadMutexUnlock
 
+#define tdbThreadLocal threadlocal
+#define tdbOsUSleep    taosUsleep
+
 #else
 
 // For memory -----------------
@@ -107,11 +112,13 @@ typedef int tdb_fd_t;
 i64 tdbOsRead(tdb_fd_t fd, void *pData, i64 nBytes);
 i64 tdbOsPRead(tdb_fd_t fd, void *pData, i64 nBytes, i64 offset);
 i64 tdbOsWrite(tdb_fd_t fd, const void *pData, i64 nBytes);
+void *tdbOsMmap(tdb_fd_t fd, i64 len);
 
 #define tdbOsFSync  fsync
 #define tdbOsLSeek  lseek
 #define tdbOsRemove remove
 #define tdbOsFileSize(FD, PSIZE)
+#define tdbOsMunmap(PTR, LEN) munmap(PTR, LEN)
 
 /* directory */
 #define tdbOsMkdir mkdir
@@ -135,6 +142,9 @@ typedef pthread_mutex_t tdb_mutex_t;
 #define tdbMutexLock    pthread_mutex_lock
 #define tdbMutexUnlock  pthread_mutex_unlock
 
+#define tdbThreadLocal __thread
+#define tdbOsUSleep    usleep
+
 #endif
 
 #ifdef __cplusplus
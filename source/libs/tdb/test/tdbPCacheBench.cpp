@@ -0,0 +1,123 @@
+#define ALLOW_FORBID_FUNC
+#include "os.h"
+#include "tdb.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Multi-threaded point read benchmark of tdb, all pages fit in the page cache so the numbers show how the page
+// cache scales with reader threads.
+
+static void *benchMalloc(void *arg, size_t size) { return taosMemoryMalloc(size); }
+static void  benchFree(void *arg, void *ptr) { taosMemoryFree(ptr); }
+
+static int benchInsert(TDB *pEnv, TTB *pDb, int nData) {
+  TXN  txn;
+  char key[64];
+  char val[64];
+
+  tdbTxnOpen(&txn, 0, benchMalloc, benchFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+
+  for (int iData = 0; iData < nData; iData++) {
+    int kLen = sprintf(key, "key%09d", iData);
+    int vLen = sprintf(val, "value%d", iData);
+    if (tdbTbInsert(pDb, key, kLen, val, vLen, &txn) < 0) {
+      tdbTxnClose(&txn);
+      return -1;
+    }
+  }
+
+  tdbCommit(pEnv, &txn);
+  tdbTxnClose(&txn);
+  return 0;
+}
+
+static double benchGet(TTB *pDb, int nData, int nThreads, int nGetPerThread) {
+  std::atomic<int> nFail(0);
+
+  auto f = [&](int seed) {
+    std::mt19937 gen(seed);
+    char         key[64];
+    void        *pVal = NULL;
+    int          vLen = 0;
+
+    for (int i = 0; i < nGetPerThread; i++) {
+      int kLen = sprintf(key, "key%09d", (int)(gen() % nData));
+      if (tdbTbGet(pDb, key, kLen, &pVal, &vLen) < 0) nFail++;
+    }
+    tdbFree(pVal);
+  };
+
+  auto                     start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nThreads; i++) {
+    threads.push_back(std::thread(f, i + 1));
+  }
+  for (auto &th : threads) {
+    th.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (nFail.load() > 0) {
+    std::cerr << "failed gets:" << nFail.load() << std::endl;
+    return -1;
+  }
+  return (double)nThreads * nGetPerThread / elapsed.count();
+}
+
+int main(int argc, char *argv[]) {
+  TDB *pEnv;
+  TTB *pDb;
+  int  nData = 200000;
+  int  nGetPerThread = 100000;
+  int  maxThreads = TMAX((int)std::thread::hardware_concurrency(), 1);
+  int  ret = 0;
+
+  taosRemoveDir("tdb_bench");
+
+  if (tdbOpen("tdb_bench", 4096, 4096, &pEnv) < 0) {
+    std::cerr << "failed to open tdb" << std::endl;
+    return 1;
+  }
+  if (tdbTbOpen("db.db", -1, -1, NULL, pEnv, &pDb) < 0) {
+    std::cerr << "failed to open table" << std::endl;
+    tdbClose(pEnv);
+    return 1;
+  }
+
+  if (benchInsert(pEnv, pDb, nData) < 0) {
+    std::cerr << "failed to insert data" << std::endl;
+    ret = 1;
+    goto _exit;
+  }
+
+  // warm up the cache
+  if (benchGet(pDb, nData, 1, nData) < 0) {
+    ret = 1;
+    goto _exit;
+  }
+
+  {
+    double base = 0;
+    for (int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+      double qps = benchGet(pDb, nData, nThreads, nGetPerThread);
+      if (qps < 0) {
+        ret = 1;
+        goto _exit;
+      }
+      if (nThreads == 1) base = qps;
+      std::cout << "threads:" << nThreads << " gets/s:" << (int64_t)qps << " speedup:" << qps / base << std::endl;
+    }
+  }
+
+_exit:
+  tdbTbClose(pDb);
+  tdbClose(pEnv);
+  taosRemoveDir("tdb_bench");
+  return ret;
+}
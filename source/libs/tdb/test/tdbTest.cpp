@@ -4,11 +4,16 @@
 #include "os.h"
 #include "tdb.h"
 
+#include <atomic>
 #include <shared_mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#ifndef WINDOWS
+#include <sys/wait.h>
+#endif
+
 typedef struct SPoolMem {
   int64_t          size;
   struct SPoolMem *prev;
@@ -726,4 +731,702 @@ TEST(tdb_test, DISABLED_multi_thread1) {
   ret = tdbClose(pDb);
   GTEST_ASSERT_EQ(ret, 0);
 #endif
-}
\ No newline at end of file
+}
+TEST(tdb_test, wal_mode_commit) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  int   nData = 10000;
+  TXN   txn;
+  char  key[64];
+  char  val[64];
+  void *pVal = NULL;
+  int   vLen;
+
+  SPoolMem *pPool = openPool();
+
+  taosRemoveDir("tdb");
+
+  ret = tdbOpen("tdb", 4096, 64, &pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+  GTEST_ASSERT_EQ(tdbSetJournalMode(pEnv, TDB_JOURNAL_MODE_WAL), 0);
+
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  // several commits, the first ones are folded into the db file by a checkpoint
+  for (int iCommit = 0; iCommit < 4; iCommit++) {
+    tdbTxnOpen(&txn, iCommit, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+    tdbBegin(pEnv, &txn);
+    for (int iData = iCommit * nData; iData < (iCommit + 1) * nData; iData++) {
+      sprintf(key, "key%d", iData);
+      sprintf(val, "value%d", iData);
+      ret = tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn);
+      GTEST_ASSERT_EQ(ret, 0);
+    }
+    GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+    tdbTxnClose(&txn);
+    clearPool(pPool);
+
+    if (iCommit == 1) {
+      GTEST_ASSERT_EQ(tdbCheckpoint(pEnv), 0);
+    }
+  }
+
+  tdbTbClose(pDb);
+  GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+
+  // reopen in rollback mode and read everything back from the db file
+  ret = tdbOpen("tdb", 4096, 64, &pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  for (int iData = 0; iData < nData * 4; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "value%d", iData);
+    ret = tdbTbGet(pDb, key, strlen(key), &pVal, &vLen);
+    GTEST_ASSERT_EQ(ret, 0);
+    GTEST_ASSERT_EQ(vLen, strlen(val));
+    GTEST_ASSERT_EQ(memcmp(val, pVal, vLen), 0);
+  }
+  tdbFree(pVal);
+
+  tdbTbClose(pDb);
+  GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  closePool(pPool);
+}
+
+#ifndef WINDOWS
+// write nCommit commits of nData rows in wal mode in a child process, which exits without checkpoint or close
+static int walWriteAndCrash(int nCommit, int nData) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    TDB      *pEnv;
+    TTB      *pDb;
+    TXN       txn;
+    char      key[64];
+    char      val[64];
+    SPoolMem *pPool = openPool();
+
+    if (tdbOpen("tdb", 4096, 64, &pEnv) < 0 || tdbSetJournalMode(pEnv, TDB_JOURNAL_MODE_WAL) < 0 ||
+        tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb) < 0) {
+      _exit(1);
+    }
+
+    for (int iCommit = 0; iCommit < nCommit; iCommit++) {
+      tdbTxnOpen(&txn, iCommit, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+      tdbBegin(pEnv, &txn);
+      for (int iData = iCommit * nData; iData < (iCommit + 1) * nData; iData++) {
+        sprintf(key, "key%d", iData);
+        sprintf(val, "value%d", iData);
+        if (tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn) < 0) _exit(1);
+      }
+      if (tdbCommit(pEnv, &txn) < 0) _exit(1);
+      tdbTxnClose(&txn);
+      clearPool(pPool);
+    }
+
+    _exit(0);
+  }
+
+  int status = 0;
+  if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) return -1;
+  return WEXITSTATUS(status);
+}
+
+// reopen in rollback mode, rows of the first nCommit commits are found, rows of later commits are not
+static void walCheckRecovered(int nCommit, int nAll, int nData) {
+  TDB  *pEnv;
+  TTB  *pDb;
+  TXN   txn;
+  char  key[64];
+  char  val[64];
+  void *pVal = NULL;
+  int   vLen;
+
+  GTEST_ASSERT_EQ(tdbOpen("tdb", 4096, 64, &pEnv), 0);
+  GTEST_ASSERT_EQ(tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb), 0);
+  // the wal is folded into the db file on open
+  GTEST_ASSERT_EQ(taosCheckExistFile("tdb/main.tdb-wal"), false);
+
+  for (int iData = 0; iData < nAll * nData; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "value%d", iData);
+    int ret = tdbTbGet(pDb, key, strlen(key), &pVal, &vLen);
+    if (iData < nCommit * nData) {
+      GTEST_ASSERT_EQ(ret, 0);
+      GTEST_ASSERT_EQ(vLen, strlen(val));
+      GTEST_ASSERT_EQ(memcmp(val, pVal, vLen), 0);
+    } else {
+      GTEST_ASSERT_LT(ret, 0);
+    }
+  }
+  tdbFree(pVal);
+  pVal = NULL;
+
+  // the recovered db takes new commits
+  SPoolMem *pPool = openPool();
+  tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+  for (int iData = nCommit * nData; iData < nAll * nData; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "value%d", iData);
+    GTEST_ASSERT_EQ(tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn), 0);
+  }
+  GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+  tdbTxnClose(&txn);
+  closePool(pPool);
+
+  for (int iData = 0; iData < nAll * nData; iData++) {
+    sprintf(key, "key%d", iData);
+    GTEST_ASSERT_EQ(tdbTbGet(pDb, key, strlen(key), &pVal, &vLen), 0);
+  }
+  tdbFree(pVal);
+
+  tdbTbClose(pDb);
+  GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+}
+
+TEST(tdb_test, wal_mode_crash_recovery) {
+  int nData = 5000;
+
+  taosRemoveDir("tdb");
+  GTEST_ASSERT_EQ(walWriteAndCrash(3, nData), 0);
+
+  // all commits are only in the wal
+  int64_t size = 0;
+  GTEST_ASSERT_EQ(taosStatFile("tdb/main.tdb-wal", &size, NULL), 0);
+  GTEST_ASSERT_GT(size, 0);
+
+  walCheckRecovered(3, 3, nData);
+  taosRemoveDir("tdb");
+}
+
+TEST(tdb_test, wal_mode_torn_tail) {
+  int     nData = 5000;
+  int64_t size[2] = {0};
+
+  // size of the wal after two commits, then after three
+  taosRemoveDir("tdb");
+  GTEST_ASSERT_EQ(walWriteAndCrash(2, nData), 0);
+  GTEST_ASSERT_EQ(taosStatFile("tdb/main.tdb-wal", &size[0], NULL), 0);
+
+  taosRemoveDir("tdb");
+  GTEST_ASSERT_EQ(walWriteAndCrash(3, nData), 0);
+  GTEST_ASSERT_EQ(taosStatFile("tdb/main.tdb-wal", &size[1], NULL), 0);
+  GTEST_ASSERT_GT(size[1], size[0]);
+
+  // tear the last commit in the middle of a frame, it is dropped as a whole
+  TdFilePtr pFile = taosOpenFile("tdb/main.tdb-wal", TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  GTEST_ASSERT_EQ(taosFtruncateFile(pFile, size[0] + (size[1] - size[0]) / 2 + 7), 0);
+  taosCloseFile(&pFile);
+
+  walCheckRecovered(2, 3, nData);
+
+  // a corrupted frame in the last commit is a torn tail too
+  taosRemoveDir("tdb");
+  GTEST_ASSERT_EQ(walWriteAndCrash(3, nData), 0);
+  pFile = taosOpenFile("tdb/main.tdb-wal", TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  GTEST_ASSERT_EQ(taosLSeekFile(pFile, size[1] - 100, SEEK_SET), size[1] - 100);
+  GTEST_ASSERT_EQ(taosWriteFile(pFile, "garbage", 7), 7);
+  taosCloseFile(&pFile);
+
+  walCheckRecovered(2, 3, nData);
+  taosRemoveDir("tdb");
+}
+#endif
+
+TEST(tdb_test, mmap_read) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  int   nData = 20000;
+  TXN   txn;
+  char  key[64];
+  char  val[64];
+  void *pVal = NULL;
+  int   vLen;
+
+  SPoolMem *pPool = openPool();
+
+  taosRemoveDir("tdb");
+
+  // a cache much smaller than the db, so most reads are misses served from the mapping
+  for (int iOpen = 0; iOpen < 2; iOpen++) {
+    ret = tdbOpen("tdb", 4096, 16, &pEnv);
+    GTEST_ASSERT_EQ(ret, 0);
+    GTEST_ASSERT_EQ(tdbSetMmapRead(pEnv, true), 0);
+
+    ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb);
+    GTEST_ASSERT_EQ(ret, 0);
+
+    // the file grows across commits, the mapping has to follow
+    for (int iCommit = 0; iOpen == 0 && iCommit < 4; iCommit++) {
+      tdbTxnOpen(&txn, iCommit, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+      tdbBegin(pEnv, &txn);
+      for (int iData = iCommit * nData; iData < (iCommit + 1) * nData; iData++) {
+        sprintf(key, "key%d", iData);
+        sprintf(val, "value%d", iData);
+        ret = tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn);
+        GTEST_ASSERT_EQ(ret, 0);
+      }
+      GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+      tdbTxnClose(&txn);
+      clearPool(pPool);
+    }
+
+    for (int iData = 0; iData < nData * 4; iData++) {
+      sprintf(key, "key%d", iData);
+      sprintf(val, "value%d", iData);
+      ret = tdbTbGet(pDb, key, strlen(key), &pVal, &vLen);
+      GTEST_ASSERT_EQ(ret, 0);
+      GTEST_ASSERT_EQ(vLen, strlen(val));
+      GTEST_ASSERT_EQ(memcmp(val, pVal, vLen), 0);
+    }
+    tdbFree(pVal);
+    pVal = NULL;
+
+    tdbTbClose(pDb);
+    GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  }
+  closePool(pPool);
+}
+
+TEST(tdb_test, prefix_compressed_keys) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  TBC  *pTbc;
+  int   nData = 50000;
+  TXN   txn;
+  char  key[128];
+  char  val[64];
+  void *pKey = NULL;
+  void *pVal = NULL;
+  int   kLen;
+  int   vLen;
+
+  SPoolMem *pPool = openPool();
+
+  taosRemoveDir("tdb");
+
+  // keys with long shared prefixes like the meta tag index keys, both with the default comparator (divider keys are
+  // truncated) and a custom one
+  for (int iCmpr = 0; iCmpr < 2; iCmpr++) {
+    ret = tdbOpen("tdb", 4096, 64, &pEnv);
+    GTEST_ASSERT_EQ(ret, 0);
+    ret = tdbTbOpen(iCmpr ? "db1.db" : "db0.db", -1, -1, iCmpr ? tDefaultKeyCmpr : NULL, pEnv, &pDb);
+    GTEST_ASSERT_EQ(ret, 0);
+
+    tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+    tdbBegin(pEnv, &txn);
+    for (int iData = 0; iData < nData; iData++) {
+      sprintf(key, "suid:%018d:cid:%04d:tag:%08d:uid:%012d", 1024, 7, iData / 100, iData);
+      sprintf(val, "value%d", iData);
+      ret = tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn);
+      GTEST_ASSERT_EQ(ret, 0);
+    }
+    for (int iData = 0; iData < nData; iData += 3) {
+      sprintf(key, "suid:%018d:cid:%04d:tag:%08d:uid:%012d", 1024, 7, iData / 100, iData);
+      ret = tdbTbDelete(pDb, key, strlen(key), &txn);
+      GTEST_ASSERT_EQ(ret, 0);
+    }
+    GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+    tdbTxnClose(&txn);
+    clearPool(pPool);
+
+    tdbTbClose(pDb);
+    GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+
+    // reopen and check both point reads and the scan order
+    ret = tdbOpen("tdb", 4096, 64, &pEnv);
+    GTEST_ASSERT_EQ(ret, 0);
+    ret = tdbTbOpen(iCmpr ? "db1.db" : "db0.db", -1, -1, iCmpr ? tDefaultKeyCmpr : NULL, pEnv, &pDb);
+    GTEST_ASSERT_EQ(ret, 0);
+
+    for (int iData = 0; iData < nData; iData++) {
+      sprintf(key, "suid:%018d:cid:%04d:tag:%08d:uid:%012d", 1024, 7, iData / 100, iData);
+      sprintf(val, "value%d", iData);
+      ret = tdbTbGet(pDb, key, strlen(key), &pVal, &vLen);
+      if (iData % 3 == 0) {
+        GTEST_ASSERT_LT(ret, 0);
+      } else {
+        GTEST_ASSERT_EQ(ret, 0);
+        GTEST_ASSERT_EQ(vLen, strlen(val));
+        GTEST_ASSERT_EQ(memcmp(val, pVal, vLen), 0);
+      }
+    }
+
+    tdbTbcOpen(pDb, &pTbc, NULL);
+    tdbTbcMoveToFirst(pTbc);
+    for (int iData = 0; iData < nData; iData++) {
+      if (iData % 3 == 0) continue;
+
+      sprintf(key, "suid:%018d:cid:%04d:tag:%08d:uid:%012d", 1024, 7, iData / 100, iData);
+      ret = tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen);
+      GTEST_ASSERT_EQ(ret, 0);
+      GTEST_ASSERT_EQ(kLen, strlen(key));
+      GTEST_ASSERT_EQ(memcmp(key, pKey, kLen), 0);
+    }
+    GTEST_ASSERT_LT(tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen), 0);
+    tdbTbcClose(pTbc);
+
+    tdbTbClose(pDb);
+    GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  }
+
+  tdbFree(pKey);
+  tdbFree(pVal);
+  closePool(pPool);
+}
+
+TEST(tdb_test, bulk_load) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  TBL  *pTbl;
+  TBC  *pTbc;
+  int   nData = 100000;
+  TXN   txn;
+  char  key[128];
+  char  val[2048];
+  void *pKey = NULL;
+  void *pVal = NULL;
+  int   kLen;
+  int   vLen;
+
+  SPoolMem *pPool = openPool();
+
+  taosRemoveDir("tdb");
+
+  auto makeVal = [&](int iData) {
+    int n = sprintf(val, "value%d", iData);
+    if (iData % 1000 == 7) {
+      // a few values on overflow pages
+      memset(val + n, 'v', 1500);
+      n += 1500;
+    }
+    return n;
+  };
+
+  for (int iCmpr = 0; iCmpr < 2; iCmpr++) {
+    ret = tdbOpen("tdb", 4096, 64, &pEnv);
+    GTEST_ASSERT_EQ(ret, 0);
+    ret = tdbTbOpen(iCmpr ? "db1.db" : "db0.db", -1, -1, iCmpr ? tDefaultKeyCmpr : NULL, pEnv, &pDb);
+    GTEST_ASSERT_EQ(ret, 0);
+
+    // load the even keys in order, then a key out of order falls back to upsert
+    tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+    tdbBegin(pEnv, &txn);
+    GTEST_ASSERT_EQ(tdbTbBulkOpen(pDb, 90, &txn, &pTbl), 0);
+    for (int iData = 0; iData < nData; iData += 2) {
+      sprintf(key, "suid:%018d:tag:%08d:uid:%012d", 1024, iData / 100, iData);
+      GTEST_ASSERT_EQ(tdbTbBulkPut(pTbl, key, strlen(key), val, makeVal(iData)), 0);
+    }
+    sprintf(key, "suid:%018d:tag:%08d:uid:%012d", 1024, 1 / 100, 1);
+    GTEST_ASSERT_EQ(tdbTbBulkPut(pTbl, key, strlen(key), val, makeVal(1)), 0);
+    GTEST_ASSERT_EQ(tdbTbBulkClose(pTbl), 0);
+
+    // the loaded tree takes normal inserts and deletes
+    for (int iData = 3; iData < nData; iData += 2) {
+      sprintf(key, "suid:%018d:tag:%08d:uid:%012d", 1024, iData / 100, iData);
+      ret = tdbTbInsert(pDb, key, strlen(key), val, makeVal(iData), &txn);
+      GTEST_ASSERT_EQ(ret, 0);
+    }
+    for (int iData = 0; iData < nData; iData += 5) {
+      sprintf(key, "suid:%018d:tag:%08d:uid:%012d", 1024, iData / 100, iData);
+      ret = tdbTbDelete(pDb, key, strlen(key), &txn);
+      GTEST_ASSERT_EQ(ret, 0);
+    }
+    GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+    tdbTxnClose(&txn);
+    clearPool(pPool);
+
+    tdbTbClose(pDb);
+    GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+
+    // reopen and check both point reads and the scan order
+    ret = tdbOpen("tdb", 4096, 64, &pEnv);
+    GTEST_ASSERT_EQ(ret, 0);
+    ret = tdbTbOpen(iCmpr ? "db1.db" : "db0.db", -1, -1, iCmpr ? tDefaultKeyCmpr : NULL, pEnv, &pDb);
+    GTEST_ASSERT_EQ(ret, 0);
+
+    for (int iData = 0; iData < nData; iData++) {
+      sprintf(key, "suid:%018d:tag:%08d:uid:%012d", 1024, iData / 100, iData);
+      ret = tdbTbGet(pDb, key, strlen(key), &pVal, &vLen);
+      if (iData % 5 == 0) {
+        GTEST_ASSERT_LT(ret, 0);
+      } else {
+        GTEST_ASSERT_EQ(ret, 0);
+        GTEST_ASSERT_EQ(vLen, makeVal(iData));
+        GTEST_ASSERT_EQ(memcmp(val, pVal, vLen), 0);
+      }
+    }
+
+    tdbTbcOpen(pDb, &pTbc, NULL);
+    tdbTbcMoveToFirst(pTbc);
+    for (int iData = 0; iData < nData; iData++) {
+      if (iData % 5 == 0) continue;
+
+      sprintf(key, "suid:%018d:tag:%08d:uid:%012d", 1024, iData / 100, iData);
+      ret = tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen);
+      GTEST_ASSERT_EQ(ret, 0);
+      GTEST_ASSERT_EQ(kLen, strlen(key));
+      GTEST_ASSERT_EQ(memcmp(key, pKey, kLen), 0);
+    }
+    GTEST_ASSERT_LT(tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen), 0);
+    tdbTbcClose(pTbc);
+
+    tdbTbClose(pDb);
+    GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  }
+
+  tdbFree(pKey);
+  tdbFree(pVal);
+  closePool(pPool);
+}
+
+// scan the whole table, all values must be of the same round
+static int snapshotScan(TTB *pDb, int *pRound) {
+  TBC  *pTbc = NULL;
+  void *pKey = NULL;
+  void *pVal = NULL;
+  int   kLen;
+  int   vLen;
+  int   n = 0;
+
+  *pRound = -1;
+  if (tdbTbcOpen(pDb, &pTbc, NULL) < 0) return -1;
+  tdbTbcMoveToFirst(pTbc);
+  while (tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen) == 0) {
+    int round = atoi((char *)pVal + 1);
+    if (*pRound < 0) *pRound = round;
+    if (round != *pRound) {
+      n = -1;
+      break;
+    }
+    n++;
+  }
+  tdbTbcClose(pTbc);
+  tdbFree(pKey);
+  tdbFree(pVal);
+  return n;
+}
+
+TEST(tdb_test, snapshot_read) {
+  int   ret;
+  TDB  *pEnv;
+  TTB  *pDb;
+  int   nData = 5000;
+  TXN   txn;
+  char  key[64];
+  char  val[64];
+  void *pVal = NULL;
+  int   vLen;
+  int   round;
+
+  SPoolMem *pPool = openPool();
+
+  taosRemoveDir("tdb");
+
+  ret = tdbOpen("tdb", 4096, 64, &pEnv);
+  GTEST_ASSERT_EQ(ret, 0);
+  GTEST_ASSERT_EQ(tdbSetSnapshotRead(pEnv, true), 0);
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+  for (int iData = 0; iData < nData; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "r%d-value%d", 0, iData);
+    GTEST_ASSERT_EQ(tdbTbInsert(pDb, key, strlen(key), val, strlen(val), &txn), 0);
+  }
+  GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+  tdbTxnClose(&txn);
+  clearPool(pPool);
+
+  // the writer changes every value and doubles the table, a snapshot pinned before sees none of it
+  tdbReadBegin(pEnv);
+  tdbTxnOpen(&txn, 1, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+  for (int iData = 0; iData < nData * 2; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "r%d-value%d", 1, iData);
+    GTEST_ASSERT_EQ(tdbTbUpsert(pDb, key, strlen(key), val, strlen(val), &txn), 0);
+  }
+  tdbPublish(pEnv);
+
+  for (int iData = 0; iData < nData * 2; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "r%d-value%d", 0, iData);
+    ret = tdbTbGet(pDb, key, strlen(key), &pVal, &vLen);
+    if (iData < nData) {
+      GTEST_ASSERT_EQ(ret, 0);
+      GTEST_ASSERT_EQ(vLen, strlen(val));
+      GTEST_ASSERT_EQ(memcmp(val, pVal, vLen), 0);
+    } else {
+      GTEST_ASSERT_LT(ret, 0);
+    }
+  }
+  GTEST_ASSERT_EQ(snapshotScan(pDb, &round), nData);
+  GTEST_ASSERT_EQ(round, 0);
+  tdbReadEnd(pEnv);
+
+  // a new snapshot sees the published changes before they are committed
+  GTEST_ASSERT_EQ(snapshotScan(pDb, &round), nData * 2);
+  GTEST_ASSERT_EQ(round, 1);
+  GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+  tdbTxnClose(&txn);
+  clearPool(pPool);
+
+  // readers scan while the writer rewrites the table round by round, each scan must see exactly one round
+  std::atomic<bool> stop(false);
+  std::atomic<int>  nScan(0);
+  std::atomic<int>  nBad(0);
+  std::vector<std::thread> readers;
+  for (int iReader = 0; iReader < 4; iReader++) {
+    readers.emplace_back([&]() {
+      int r;
+      while (!stop) {
+        tdbReadBegin(pEnv);
+        if (snapshotScan(pDb, &r) != nData * 2) nBad++;
+        tdbReadEnd(pEnv);
+        nScan++;
+      }
+    });
+  }
+
+  for (int iRound = 2; iRound < 12; iRound++) {
+    if (iRound % 4 == 2) {
+      tdbTxnOpen(&txn, iRound, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+      tdbBegin(pEnv, &txn);
+    }
+    for (int iData = 0; iData < nData * 2; iData++) {
+      sprintf(key, "key%d", iData);
+      sprintf(val, "r%d-value%d%s", iRound, iData, (iData % 7) ? "" : "-with-a-longer-tail");
+      GTEST_ASSERT_EQ(tdbTbUpsert(pDb, key, strlen(key), val, strlen(val), &txn), 0);
+    }
+    tdbPublish(pEnv);
+    if (iRound % 4 == 1) {
+      GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+      tdbTxnClose(&txn);
+      clearPool(pPool);
+    }
+  }
+
+  stop = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  GTEST_ASSERT_EQ(nBad.load(), 0);
+  GTEST_ASSERT_GT(nScan.load(), 0);
+
+  GTEST_ASSERT_EQ(snapshotScan(pDb, &round), nData * 2);
+  GTEST_ASSERT_EQ(round, 11);
+
+  tdbFree(pVal);
+  tdbTbClose(pDb);
+  GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  closePool(pPool);
+}
+
+static void snapshotWriteRound(TDB *pEnv, TTB *pDb, SPoolMem *pPool, int nData, int round) {
+  TXN  txn;
+  char key[64];
+  char val[64];
+
+  tdbTxnOpen(&txn, round, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+  for (int iData = 0; iData < nData; iData++) {
+    sprintf(key, "key%d", iData);
+    sprintf(val, "r%d-value%d%s", round, iData, (iData % 5) ? "" : "-with-a-longer-tail");
+    GTEST_ASSERT_EQ(tdbTbUpsert(pDb, key, strlen(key), val, strlen(val), &txn), 0);
+  }
+  tdbPublish(pEnv);
+  GTEST_ASSERT_EQ(tdbCommit(pEnv, &txn), 0);
+  tdbTxnClose(&txn);
+  clearPool(pPool);
+}
+
+TEST(tdb_test, snapshot_outlives_commit) {
+  TDB   *pEnv;
+  TTB   *pDb;
+  TBC   *pTbc = NULL;
+  TBC   *pTbcIn = NULL;
+  TSNAP *pSnap = NULL;
+  void  *pKey = NULL;
+  void  *pVal = NULL;
+  int    kLen;
+  int    vLen;
+  int    nData = 3000;
+  int    round;
+  int    n;
+
+  SPoolMem *pPool = openPool();
+
+  taosRemoveDir("tdb");
+  GTEST_ASSERT_EQ(tdbOpen("tdb", 4096, 64, &pEnv), 0);
+  GTEST_ASSERT_EQ(tdbSetSnapshotRead(pEnv, true), 0);
+  GTEST_ASSERT_EQ(tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb), 0);
+  snapshotWriteRound(pEnv, pDb, pPool, nData, 0);
+
+  // a cursor in the middle of a scan, one opened in a read section that is over and a snapshot held by an object
+  GTEST_ASSERT_EQ(tdbTbcOpen(pDb, &pTbc, NULL), 0);
+  tdbTbcMoveToFirst(pTbc);
+  for (n = 0; n < nData / 2; n++) {
+    GTEST_ASSERT_EQ(tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen), 0);
+  }
+  tdbReadBegin(pEnv);
+  GTEST_ASSERT_EQ(tdbTbcOpen(pDb, &pTbcIn, NULL), 0);
+  tdbReadEnd(pEnv);
+  GTEST_ASSERT_FALSE(tdbInRead(pEnv));
+  GTEST_ASSERT_EQ(tdbSnapOpen(pEnv, &pSnap), 0);
+  GTEST_ASSERT_NE(pSnap, nullptr);
+
+  // commits don't wait for any of them
+  for (round = 1; round <= 3; round++) {
+    snapshotWriteRound(pEnv, pDb, pPool, nData, round);
+  }
+
+  for (; tdbTbcNext(pTbc, &pKey, &kLen, &pVal, &vLen) == 0; n++) {
+    GTEST_ASSERT_EQ(atoi((char *)pVal + 1), 0);
+  }
+  GTEST_ASSERT_EQ(n, nData);
+
+  tdbTbcMoveToFirst(pTbcIn);
+  for (n = 0; tdbTbcNext(pTbcIn, &pKey, &kLen, &pVal, &vLen) == 0; n++) {
+    GTEST_ASSERT_EQ(atoi((char *)pVal + 1), 0);
+  }
+  GTEST_ASSERT_EQ(n, nData);
+
+  tdbReadBeginAt(pEnv, pSnap);
+  GTEST_ASSERT_EQ(snapshotScan(pDb, &round), nData);
+  GTEST_ASSERT_EQ(round, 0);
+  tdbReadEnd(pEnv);
+
+  // the pins belong to the cursors and the snapshot, not to the thread that made them
+  std::thread closer([&]() {
+    tdbTbcClose(pTbc);
+    tdbTbcClose(pTbcIn);
+    tdbSnapClose(pSnap);
+  });
+  closer.join();
+
+  GTEST_ASSERT_EQ(snapshotScan(pDb, &round), nData);
+  GTEST_ASSERT_EQ(round, 3);
+
+  // the versions retired, the pages are read and recycled as usual
+  snapshotWriteRound(pEnv, pDb, pPool, nData, 4);
+  GTEST_ASSERT_EQ(snapshotScan(pDb, &round), nData);
+  GTEST_ASSERT_EQ(round, 4);
+
+  tdbFree(pKey);
+  tdbFree(pVal);
+  tdbTbClose(pDb);
+  GTEST_ASSERT_EQ(tdbClose(pEnv), 0);
+  closePool(pPool);
+}
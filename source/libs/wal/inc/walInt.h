@@ -36,6 +36,21 @@ typedef struct {
   int64_t fileSize;
 } SWalFileInfo;
 
+// read-only mapping of one log file, shared by all readers of the wal.
+// the registry in pMmapHash holds one reference while the mapping is current,
+// each reader pinning it holds another one. every mapping alive, current or not,
+// is linked in pWal->pMmapList so that truncating a file can fence all of them
+struct SWalMmap {
+  SWal*     pWal;
+  int64_t   fileFirstVer;
+  int64_t   size;     // readable length, shrinks when the file is truncated
+  int64_t   mapSize;  // length of the mapping
+  void*     pBase;
+  int32_t   refCnt;   // guarded by pWal->mutex
+  SWalMmap* pPrev;
+  SWalMmap* pNext;
+};
+
 typedef struct WalIdxEntry {
   int64_t ver;
   int64_t offset;
@@ -155,6 +170,14 @@ int64_t walChangeWrite(SWal* pWal, int64_t ver);
 int     walInitWriteFile(SWal* pWal);
 // seek section end
 
+// mmap section
+SWalMmap* walMmapAcquire(SWal* pWal, int64_t fileFirstVer, TdFilePtr pLogFile, int64_t minSize);
+void      walMmapRelease(SWalMmap* pMmap);
+void      walMmapDrop(SWal* pWal, int64_t fileFirstVer);
+void      walMmapDropAll(SWal* pWal);
+int32_t   walMmapTruncate(SWal* pWal, int64_t fileFirstVer, int64_t size);
+// mmap section end
+
 int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
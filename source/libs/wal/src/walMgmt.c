@@ -108,6 +108,14 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     return NULL;
   }
 
+  // init shared log file mappings
+  pWal->pMmapHash = taosHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+  if (pWal->pMmapHash == NULL) {
+    taosHashCleanup(pWal->pRefHash);
+    taosMemoryFree(pWal);
+    return NULL;
+  }
+
   // open meta
   walResetVer(&pWal->vers);
   pWal->pLogFile = NULL;
@@ -117,6 +125,7 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   if (pWal->fileInfoSet == NULL) {
     wError("vgId:%d, path:%s, failed to init taosArray %s", pWal->cfg.vgId, pWal->path, strerror(errno));
     taosHashCleanup(pWal->pRefHash);
+    taosHashCleanup(pWal->pMmapHash);
     taosMemoryFree(pWal);
     return NULL;
   }
@@ -133,6 +142,7 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   if (taosThreadMutexInit(&pWal->mutex, NULL) < 0) {
     taosArrayDestroy(pWal->fileInfoSet);
     taosHashCleanup(pWal->pRefHash);
+    taosHashCleanup(pWal->pMmapHash);
     taosMemoryFree(pWal);
     return NULL;
   }
@@ -140,6 +150,7 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   pWal->refId = taosAddRef(tsWal.refSetId, pWal);
   if (pWal->refId < 0) {
     taosHashCleanup(pWal->pRefHash);
+    taosHashCleanup(pWal->pMmapHash);
     taosThreadMutexDestroy(&pWal->mutex);
     taosArrayDestroy(pWal->fileInfoSet);
     taosMemoryFree(pWal);
@@ -150,6 +161,7 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
 
   if (walCheckAndRepairMeta(pWal) < 0) {
     taosHashCleanup(pWal->pRefHash);
+    taosHashCleanup(pWal->pMmapHash);
     taosRemoveRef(tsWal.refSetId, pWal->refId);
     taosThreadMutexDestroy(&pWal->mutex);
     taosArrayDestroy(pWal->fileInfoSet);
@@ -196,6 +208,8 @@ void walClose(SWal *pWal) {
   taosArrayDestroy(pWal->fileInfoSet);
   pWal->fileInfoSet = NULL;
   taosHashCleanup(pWal->pRefHash);
+  walMmapDropAll(pWal);
+  taosHashCleanup(pWal->pMmapHash);
   taosThreadMutexUnlock(&pWal->mutex);
 
   taosRemoveRef(tsWal.refSetId, pWal->refId);
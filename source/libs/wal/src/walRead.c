@@ -16,9 +16,8 @@
 #include "taoserror.h"
 #include "walInt.h"
 
-static int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer);
-static int32_t walFetchBodyNew(SWalReader *pRead);
-static int32_t walSkipFetchBodyNew(SWalReader *pRead);
+static int32_t walFetchHeadMmap(SWalReader *pRead, int64_t fetchVer);
+static int32_t walFetchBodyMmap(SWalReader *pRead);
 
 SWalReader *walOpenReader(SWal *pWal, SWalFilterCond *cond) {
   SWalReader *pReader = taosMemoryCalloc(1, sizeof(SWalReader));
@@ -42,15 +41,25 @@ SWalReader *walOpenReader(SWal *pWal, SWalFilterCond *cond) {
     pReader->cond.scanNotApplied = 0;
     pReader->cond.scanMeta = 0;
     pReader->cond.enableRef = 0;
+    pReader->cond.enableMmap = 0;
   }
+#ifdef WINDOWS
+  pReader->cond.enableMmap = 0;
+#endif
 
   taosThreadMutexInit(&pReader->mutex, NULL);
 
-  pReader->pHead = taosMemoryMalloc(sizeof(SWalCkHead));
-  if (pReader->pHead == NULL) {
-    terrno = TSDB_CODE_WAL_OUT_OF_MEMORY;
-    taosMemoryFree(pReader);
-    return NULL;
+  pReader->pMmap = NULL;
+  pReader->mmapOffset = -1;
+
+  // in mmap mode pHead always points into the mapping
+  if (!pReader->cond.enableMmap) {
+    pReader->pHead = taosMemoryMalloc(sizeof(SWalCkHead));
+    if (pReader->pHead == NULL) {
+      terrno = TSDB_CODE_WAL_OUT_OF_MEMORY;
+      taosMemoryFree(pReader);
+      return NULL;
+    }
   }
 
   /*if (pReader->cond.enableRef) {*/
@@ -66,7 +75,14 @@ void walCloseReader(SWalReader *pReader) {
   /*if (pReader->cond.enableRef) {*/
   /*taosHashRemove(pReader->pWal->pRefHash, &pReader->readerId, sizeof(int64_t));*/
   /*}*/
-  taosMemoryFreeClear(pReader->pHead);
+  if (pReader->cond.enableMmap) {
+    walMmapRelease(pReader->pMmap);
+    pReader->pMmap = NULL;
+    pReader->pHead = NULL;
+  } else {
+    taosMemoryFreeClear(pReader->pHead);
+  }
+  taosThreadMutexDestroy(&pReader->mutex);
   taosMemoryFree(pReader);
 }
 
@@ -148,6 +164,10 @@ static int32_t walReadChangeFile(SWalReader *pReader, int64_t fileFirstVer) {
 
   taosCloseFile(&pReader->pIdxFile);
   taosCloseFile(&pReader->pLogFile);
+  if (pReader->pMmap != NULL) {
+    walMmapRelease(pReader->pMmap);
+    pReader->pMmap = NULL;
+  }
 
   walBuildLogName(pReader->pWal, fileFirstVer, fnameStr);
   TdFilePtr pLogFile = taosOpenFile(fnameStr, TD_FILE_READ);
@@ -190,9 +210,11 @@ int32_t walReadSeekVerImpl(SWalReader *pReader, int64_t ver) {
   }
 
   // error code was set inner
-  if (walReadSeekFilePos(pReader, pRet->firstVer, ver) < 0) {
+  int64_t pos = walReadSeekFilePos(pReader, pRet->firstVer, ver);
+  if (pos < 0) {
     return -1;
   }
+  pReader->mmapOffset = pos;
 
   wDebug("vgId:%d, wal version reset from index:%" PRId64 "(invalid:%d) to index:%" PRId64, pReader->pWal->cfg.vgId,
          pReader->curVersion, pReader->curInvalid, ver);
@@ -229,12 +251,106 @@ int32_t walReadSeekVer(SWalReader *pReader, int64_t ver) {
 
 void walSetReaderCapacity(SWalReader *pRead, int32_t capacity) { pRead->capacity = capacity; }
 
-static int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer) {
+// make sure the pinned mapping covers [0, minSize) of the current file, return 1 if the file is not long enough
+static int32_t walReadPinMmap(SWalReader *pRead, int64_t minSize) {
+  if (pRead->pMmap != NULL && pRead->pMmap->size >= minSize) {
+    return 0;
+  }
+
+  SWalMmap *pMmap = walMmapAcquire(pRead->pWal, pRead->curFileFirstVer, pRead->pLogFile, minSize);
+  if (pMmap == NULL) {
+    return terrno == TSDB_CODE_WAL_LOG_NOT_EXIST ? 1 : -1;
+  }
+
+  walMmapRelease(pRead->pMmap);
+  pRead->pMmap = pMmap;
+  return 0;
+}
+
+static int32_t walFetchHeadMmap(SWalReader *pRead, int64_t fetchVer) {
+  bool seeked = false;
+
+  if (pRead->curInvalid || pRead->curVersion != fetchVer) {
+    if (walReadSeekVer(pRead, fetchVer) < 0) {
+      pRead->curVersion = fetchVer;
+      pRead->curInvalid = 1;
+      return -1;
+    }
+    seeked = true;
+  }
+
+  while (1) {
+    int32_t code = walReadPinMmap(pRead, pRead->mmapOffset + sizeof(SWalCkHead));
+    if (code == 0) {
+      break;
+    } else if (code > 0 && !seeked) {
+      // reach the end of a closed file, move to the file the version belongs to
+      if (walReadSeekVerImpl(pRead, fetchVer) < 0) {
+        pRead->curInvalid = 1;
+        return -1;
+      }
+      seeked = true;
+      continue;
+    } else {
+      if (code > 0) terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+      wError("vgId:%d, wal fetch head error, index:%" PRId64 ", since %s", pRead->pWal->cfg.vgId, fetchVer,
+             terrstr());
+      pRead->curInvalid = 1;
+      return -1;
+    }
+  }
+
+  pRead->pHead = (SWalCkHead *)((char *)pRead->pMmap->pBase + pRead->mmapOffset);
+  if (walValidHeadCksum(pRead->pHead) != 0 || pRead->pHead->head.version != fetchVer) {
+    wError("vgId:%d, wal fetch head error, index:%" PRId64 ", since head checksum not passed", pRead->pWal->cfg.vgId,
+           fetchVer);
+    pRead->pHead = NULL;
+    pRead->curInvalid = 1;
+    terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+    return -1;
+  }
+
+  pRead->curInvalid = 0;
+  return 0;
+}
+
+static int32_t walFetchBodyMmap(SWalReader *pRead) {
+  int64_t ver = pRead->pHead->head.version;
+  int64_t entryLen = sizeof(SWalCkHead) + pRead->pHead->head.bodyLen;
+
+  // the head may sit at the tail of a mapping taken before the body was visible
+  int32_t code = walReadPinMmap(pRead, pRead->mmapOffset + entryLen);
+  if (code != 0) {
+    if (code > 0) terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+    wError("vgId:%d, wal fetch body error, index:%" PRId64 ", since %s", pRead->pWal->cfg.vgId, ver, terrstr());
+    pRead->curInvalid = 1;
+    return -1;
+  }
+  pRead->pHead = (SWalCkHead *)((char *)pRead->pMmap->pBase + pRead->mmapOffset);
+
+  if (walValidBodyCksum(pRead->pHead) != 0) {
+    wError("vgId:%d, wal fetch body error:%" PRId64 ", since body checksum not passed", pRead->pWal->cfg.vgId, ver);
+    pRead->curInvalid = 1;
+    terrno = TSDB_CODE_WAL_FILE_CORRUPTED;
+    return -1;
+  }
+
+  wDebug("vgId:%d, index:%" PRId64 " is fetched in place, cursor advance", pRead->pWal->cfg.vgId, ver);
+  pRead->mmapOffset += entryLen;
+  pRead->curVersion = ver + 1;
+  return 0;
+}
+
+int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer) {
   int64_t contLen;
   bool    seeked = false;
 
   wDebug("vgId:%d, wal starts to fetch head, index:%" PRId64, pRead->pWal->cfg.vgId, fetchVer);
 
+  if (pRead->cond.enableMmap) {
+    return walFetchHeadMmap(pRead, fetchVer);
+  }
+
   if (pRead->curInvalid || pRead->curVersion != fetchVer) {
     if (walReadSeekVer(pRead, fetchVer) < 0) {
       ASSERT(0);
@@ -267,12 +383,16 @@ static int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer) {
   return 0;
 }
 
-static int32_t walFetchBodyNew(SWalReader *pRead) {
+int32_t walFetchBodyNew(SWalReader *pRead) {
   SWalCont *pReadHead = &pRead->pHead->head;
   int64_t   ver = pReadHead->version;
 
   wDebug("vgId:%d, wal starts to fetch body, index:%" PRId64, pRead->pWal->cfg.vgId, ver);
 
+  if (pRead->cond.enableMmap) {
+    return walFetchBodyMmap(pRead);
+  }
+
   if (pRead->capacity < pReadHead->bodyLen) {
     void *ptr = taosMemoryRealloc(pRead->pHead, sizeof(SWalCkHead) + pReadHead->bodyLen);
     if (ptr == NULL) {
@@ -321,12 +441,19 @@ static int32_t walFetchBodyNew(SWalReader *pRead) {
   return 0;
 }
 
-static int32_t walSkipFetchBodyNew(SWalReader *pRead) {
+int32_t walSkipFetchBodyNew(SWalReader *pRead) {
   int64_t code;
 
   ASSERT(pRead->curVersion == pRead->pHead->head.version);
   ASSERT(pRead->curInvalid == 0);
 
+  if (pRead->cond.enableMmap) {
+    pRead->mmapOffset += sizeof(SWalCkHead) + pRead->pHead->head.bodyLen;
+    pRead->curVersion++;
+    wDebug("vgId:%d, version advance to %" PRId64 ", skip fetch", pRead->pWal->cfg.vgId, pRead->curVersion);
+    return 0;
+  }
+
   code = taosLSeekFile(pRead->pLogFile, pRead->pHead->head.bodyLen, SEEK_CUR);
   if (code < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
@@ -349,6 +476,12 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver, SWalCkHead *pHead) {
     return -1;
   }
 
+  if (pRead->cond.enableMmap) {
+    if (walFetchHeadMmap(pRead, ver) < 0) return -1;
+    memcpy(pHead, pRead->pHead, sizeof(SWalCkHead));
+    return 0;
+  }
+
   if (pRead->curInvalid || pRead->curVersion != ver) {
     code = walReadSeekVer(pRead, ver);
     if (code < 0) return -1;
@@ -377,6 +510,10 @@ int32_t walSkipFetchBody(SWalReader *pRead, const SWalCkHead *pHead) {
 
   //  ASSERT(pRead->curVersion == pHead->head.version);
 
+  if (pRead->cond.enableMmap) {
+    return walSkipFetchBodyNew(pRead);
+  }
+
   code = taosLSeekFile(pRead->pLogFile, pHead->head.bodyLen, SEEK_CUR);
   if (code < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
@@ -404,6 +541,12 @@ int32_t walFetchBody(SWalReader *pRead, SWalCkHead **ppHead) {
     pRead->capacity = pReadHead->bodyLen;
   }
 
+  if (pRead->cond.enableMmap) {
+    if (walFetchBodyMmap(pRead) < 0) return -1;
+    memcpy(pReadHead->body, pRead->pHead->head.body, pReadHead->bodyLen);
+    return 0;
+  }
+
   if (pReadHead->bodyLen != taosReadFile(pRead->pLogFile, pReadHead->body, pReadHead->bodyLen)) {
     ASSERT(0);
     return -1;
@@ -449,6 +592,13 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
 
   taosThreadMutexLock(&pReader->mutex);
 
+  if (pReader->cond.enableMmap) {
+    code = walFetchHeadMmap(pReader, ver);
+    if (code == 0) code = walFetchBodyMmap(pReader);
+    taosThreadMutexUnlock(&pReader->mutex);
+    return code;
+  }
+
   if (pReader->curInvalid || pReader->curVersion != ver) {
     if (walReadSeekVer(pReader, ver) < 0) {
       wError("vgId:%d, unexpected wal log, index:%" PRId64 ", since %s", pReader->pWal->cfg.vgId, ver, terrstr());
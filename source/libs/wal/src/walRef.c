@@ -92,3 +92,124 @@ SWalRef *walRefCommittedVer(SWal *pWal) {
   taosThreadMutexUnlock(&pWal->mutex);
   return pRef;
 }
+
+static void walMmapReleaseImpl(SWalMmap *pMmap);
+
+SWalMmap *walMmapAcquire(SWal *pWal, int64_t fileFirstVer, TdFilePtr pLogFile, int64_t minSize) {
+  taosThreadMutexLock(&pWal->mutex);
+
+  SWalMmap **ppMmap = taosHashGet(pWal->pMmapHash, &fileFirstVer, sizeof(int64_t));
+  if (ppMmap != NULL && (*ppMmap)->size >= minSize) {
+    SWalMmap *pMmap = *ppMmap;
+    pMmap->refCnt++;
+    taosThreadMutexUnlock(&pWal->mutex);
+    return pMmap;
+  }
+
+  // the file is still growing or not mapped yet, map it again with its current size
+  int64_t size = 0;
+  if (taosFStatFile(pLogFile, &size, NULL) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    taosThreadMutexUnlock(&pWal->mutex);
+    return NULL;
+  }
+  if (size < minSize || size == 0) {
+    terrno = TSDB_CODE_WAL_LOG_NOT_EXIST;
+    taosThreadMutexUnlock(&pWal->mutex);
+    return NULL;
+  }
+
+  SWalMmap *pMmap = taosMemoryCalloc(1, sizeof(SWalMmap));
+  if (pMmap == NULL) {
+    terrno = TSDB_CODE_WAL_OUT_OF_MEMORY;
+    taosThreadMutexUnlock(&pWal->mutex);
+    return NULL;
+  }
+  pMmap->pBase = taosMmapReadOnlyFile(pLogFile, size);
+  if (pMmap->pBase == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, failed to mmap wal file:%020" PRId64 ", size:%" PRId64 " since %s", pWal->cfg.vgId, fileFirstVer,
+           size, terrstr());
+    taosMemoryFree(pMmap);
+    taosThreadMutexUnlock(&pWal->mutex);
+    return NULL;
+  }
+  pMmap->pWal = pWal;
+  pMmap->fileFirstVer = fileFirstVer;
+  pMmap->size = size;
+  pMmap->mapSize = size;
+  pMmap->refCnt = 2;
+
+  pMmap->pNext = pWal->pMmapList;
+  if (pWal->pMmapList != NULL) pWal->pMmapList->pPrev = pMmap;
+  pWal->pMmapList = pMmap;
+
+  // readers still pinning the old mapping keep it alive until they move on
+  walMmapDrop(pWal, fileFirstVer);
+  taosHashPut(pWal->pMmapHash, &fileFirstVer, sizeof(int64_t), &pMmap, sizeof(void *));
+
+  taosThreadMutexUnlock(&pWal->mutex);
+
+  wDebug("vgId:%d, wal file:%020" PRId64 " is mapped, size:%" PRId64, pWal->cfg.vgId, fileFirstVer, size);
+  return pMmap;
+}
+
+// should be called with pWal->mutex locked
+static void walMmapReleaseImpl(SWalMmap *pMmap) {
+  if (--pMmap->refCnt > 0) return;
+
+  SWal *pWal = pMmap->pWal;
+  if (pMmap->pPrev != NULL) {
+    pMmap->pPrev->pNext = pMmap->pNext;
+  } else {
+    pWal->pMmapList = pMmap->pNext;
+  }
+  if (pMmap->pNext != NULL) pMmap->pNext->pPrev = pMmap->pPrev;
+
+  taosMunmapFile(pMmap->pBase, pMmap->mapSize);
+  taosMemoryFree(pMmap);
+}
+
+void walMmapRelease(SWalMmap *pMmap) {
+  if (pMmap == NULL) return;
+  SWal *pWal = pMmap->pWal;
+  taosThreadMutexLock(&pWal->mutex);
+  walMmapReleaseImpl(pMmap);
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
+// should be called with pWal->mutex locked
+void walMmapDrop(SWal *pWal, int64_t fileFirstVer) {
+  SWalMmap **ppMmap = taosHashGet(pWal->pMmapHash, &fileFirstVer, sizeof(int64_t));
+  if (ppMmap == NULL) return;
+  SWalMmap *pMmap = *ppMmap;
+  taosHashRemove(pWal->pMmapHash, &fileFirstVer, sizeof(int64_t));
+  walMmapReleaseImpl(pMmap);
+}
+
+// should be called with pWal->mutex locked
+void walMmapDropAll(SWal *pWal) {
+  void *pIter = NULL;
+  while (1) {
+    pIter = taosHashIterate(pWal->pMmapHash, pIter);
+    if (pIter == NULL) break;
+    walMmapReleaseImpl(*(SWalMmap **)pIter);
+  }
+  taosHashClear(pWal->pMmapHash);
+}
+
+// should be called with pWal->mutex locked, before the file is truncated to size.
+// the mappings readers still pin past size would raise SIGBUS once the file is shorter,
+// so their tail is replaced by zero pages, which fail the checksum and make the reader remap
+int32_t walMmapTruncate(SWal *pWal, int64_t fileFirstVer, int64_t size) {
+  for (SWalMmap *pMmap = pWal->pMmapList; pMmap != NULL; pMmap = pMmap->pNext) {
+    if (pMmap->fileFirstVer != fileFirstVer || pMmap->size <= size) continue;
+    if (taosMmapZeroTail(pMmap->pBase, pMmap->mapSize, size) < 0) {
+      wError("vgId:%d, failed to fence mapping of wal file:%020" PRId64 " at:%" PRId64 " since %s", pWal->cfg.vgId,
+             fileFirstVer, size, terrstr());
+      return -1;
+    }
+    pMmap->size = size;
+  }
+  return 0;
+}
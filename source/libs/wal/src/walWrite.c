@@ -34,6 +34,7 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
 
   taosCloseFile(&pWal->pLogFile);
   taosCloseFile(&pWal->pIdxFile);
+  walMmapDropAll(pWal);
 
   if (pWal->vers.firstVer != -1) {
     int32_t fileSetSize = taosArrayGetSize(pWal->fileInfoSet);
@@ -106,6 +107,7 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     // delete files
     int fileSetSize = taosArrayGetSize(pWal->fileInfoSet);
     for (int i = pWal->writeCur + 1; i < fileSetSize; i++) {
+      walMmapDrop(pWal, ((SWalFileInfo *)taosArrayGet(pWal->fileInfoSet, i))->firstVer);
       walBuildLogName(pWal, ((SWalFileInfo *)taosArrayGet(pWal->fileInfoSet, i))->firstVer, fnameStr);
       taosRemoveFile(fnameStr);
       walBuildIdxName(pWal, ((SWalFileInfo *)taosArrayGet(pWal->fileInfoSet, i))->firstVer, fnameStr);
@@ -179,7 +181,12 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
 
-  // truncate old files
+  // truncate old files, fence the mappings readers still pin before the file gets shorter
+  walMmapDrop(pWal, walGetCurFileFirstVer(pWal));
+  if (walMmapTruncate(pWal, walGetCurFileFirstVer(pWal), entry.offset) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
   code = taosFtruncateFile(pLogFile, entry.offset);
   if (code < 0) {
     ASSERT(0);
@@ -299,6 +306,7 @@ int32_t walEndSnapshot(SWal *pWal) {
     // remove file
     for (int i = 0; i < deleteCnt; i++) {
       pInfo = taosArrayGet(pWal->fileInfoSet, i);
+      walMmapDrop(pWal, pInfo->firstVer);
       walBuildLogName(pWal, pInfo->firstVer, fnameStr);
       if (taosRemoveFile(fnameStr) < 0) {
         goto UPDATE_META;
@@ -328,6 +328,136 @@ TEST_F(WalKeepEnv, readHandleRead) {
   walCloseReader(pRead);
 }
 
+TEST_F(WalKeepEnv, readHandleMmapRead) {
+  walResetEnv();
+  int            code;
+  SWalFilterCond cond = {0};
+  cond.enableMmap = 1;
+  SWalReader* pRead = walOpenReader(pWal, &cond);
+  ASSERT(pRead != NULL);
+
+  int i;
+  for (i = 0; i < 100; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, i);
+    int len = strlen(newStr);
+    code = walWrite(pWal, i, 0, newStr, len);
+    ASSERT_EQ(code, 0);
+  }
+  for (int i = 0; i < 1000; i++) {
+    int ver = taosRand() % 100;
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    ASSERT_EQ(pRead->curVersion, ver + 1);
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, ver);
+    int len = strlen(newStr);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      EXPECT_EQ(newStr[j], pRead->pHead->head.body[j]);
+    }
+  }
+
+  // the active file grows after it is mapped
+  for (i = 100; i < 200; i++) {
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, i);
+    int len = strlen(newStr);
+    code = walWrite(pWal, i, 0, newStr, len);
+    ASSERT_EQ(code, 0);
+  }
+
+  for (int ver = 0; ver < 200; ver++) {
+    code = walFetchHeadNew(pRead, ver);
+    ASSERT_EQ(code, 0);
+    if (ver % 2 == 0) {
+      code = walSkipFetchBodyNew(pRead);
+      ASSERT_EQ(code, 0);
+      continue;
+    }
+    code = walFetchBodyNew(pRead);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    ASSERT_EQ(pRead->curVersion, ver + 1);
+    char newStr[100];
+    sprintf(newStr, "%s-%d", ranStr, ver);
+    int len = strlen(newStr);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, len);
+    for (int j = 0; j < len; j++) {
+      EXPECT_EQ(newStr[j], pRead->pHead->head.body[j]);
+    }
+  }
+  walCloseReader(pRead);
+}
+
+// the mapping a reader pins must stay readable after the file is truncated by a rollback
+TEST_F(WalKeepEnv, readHandleMmapRollback) {
+  walResetEnv();
+  int            code;
+  SWalFilterCond cond = {0};
+  cond.enableMmap = 1;
+  SWalReader* pRead = walOpenReader(pWal, &cond);
+  ASSERT(pRead != NULL);
+
+  // bodies large enough that the rolled back part spans several pages
+  char newStr[300];
+  for (int i = 0; i < 200; i++) {
+    memset(newStr, 'x', sizeof(newStr));
+    sprintf(newStr, "%s-%d", ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, sizeof(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  for (int ver = 0; ver < 200; ver++) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+  }
+
+  SWalMmap* pMmap = pRead->pMmap;
+  ASSERT(pMmap != NULL);
+  int64_t mapSize = pMmap->mapSize;
+
+  code = walRollback(pWal, 100);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->vers.lastVer, 99);
+
+  // the tail of the pinned mapping past the new end of file reads as zeros instead of faulting
+  ASSERT_LT(pMmap->size, mapSize);
+  EXPECT_EQ(((char*)pMmap->pBase)[mapSize - 1], 0);
+
+  // the versions rolled back are gone, the ones before are still readable
+  for (int ver = 100; ver < 200; ver += 10) {
+    code = walReadVer(pRead, ver);
+    ASSERT_NE(code, 0);
+  }
+  for (int ver = 0; ver < 100; ver += 7) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+  }
+
+  // rewrite the rolled back versions with other bodies and read them back
+  for (int i = 100; i < 200; i++) {
+    memset(newStr, 'y', sizeof(newStr));
+    sprintf(newStr, "%s-r%d", ranStr, i);
+    code = walWrite(pWal, i, 0, newStr, sizeof(newStr));
+    ASSERT_EQ(code, 0);
+  }
+  for (int ver = 100; ver < 200; ver++) {
+    code = walReadVer(pRead, ver);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, sizeof(newStr));
+    char expect[100];
+    sprintf(expect, "%s-r%d", ranStr, ver);
+    EXPECT_EQ(strcmp(expect, pRead->pHead->head.body), 0);
+    EXPECT_EQ(pRead->pHead->head.body[sizeof(newStr) - 1], 'y');
+  }
+  walCloseReader(pRead);
+}
+
 TEST_F(WalRetentionEnv, repairMeta1) {
   walResetEnv();
   int code;
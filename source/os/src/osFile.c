@@ -31,6 +31,7 @@
 #if !defined(_TD_DARWIN_64)
 #include <sys/sendfile.h>
 #endif
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #define LINUX_FILE_NO_TEXT_OPTION 0
@@ -728,6 +729,56 @@ int64_t taosFSendFile(TdFilePtr pFileOut, TdFilePtr pFileIn, int64_t *offset, in
 #endif
 }
 
+void *taosMmapReadOnlyFile(TdFilePtr pFile, int64_t length) {
+  if (pFile == NULL || length <= 0) {
+    return NULL;
+  }
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+
+#ifdef WINDOWS
+  return NULL;
+#else
+  void *ptr = mmap(NULL, (size_t)length, PROT_READ, MAP_SHARED, pFile->fd, 0);
+  if (ptr == MAP_FAILED) {
+    return NULL;
+  }
+  return ptr;
+#endif
+}
+
+int32_t taosMunmapFile(void *ptr, int64_t length) {
+  if (ptr == NULL) {
+    return 0;
+  }
+#ifdef WINDOWS
+  return 0;
+#else
+  return munmap(ptr, (size_t)length);
+#endif
+}
+
+int32_t taosMmapZeroTail(void *ptr, int64_t length, int64_t offset) {
+  if (ptr == NULL) {
+    return 0;
+  }
+#ifdef WINDOWS
+  return 0;
+#else
+  int64_t pageSize = sysconf(_SC_PAGESIZE);
+  int64_t start = (offset + pageSize - 1) / pageSize * pageSize;
+  if (start >= length) {
+    return 0;
+  }
+  void *p = mmap((char *)ptr + start, (size_t)(length - start), PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1,
+                 0);
+  if (p == MAP_FAILED) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 void taosFprintfFile(TdFilePtr pFile, const char *format, ...) {
   if (pFile == NULL) {
     return;
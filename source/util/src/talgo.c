@@ -288,3 +288,115 @@ void taosheapsort(void *base, int32_t size, int32_t len, const void *parcompar,
     taosMemoryFreeClear(buf);
   */
 }
+
+#define RADIX_SORT_INSERT_THRESHOLD 32
+
+typedef struct SRadixSortSup {
+  int64_t           size;
+  int32_t           keyLen;
+  const void       *param;
+  __ext_compar_fn_t comparFn;
+  char             *aux;     // the scatter buffer, as large as the records
+  int32_t          *counts;  // 256 counters for each key byte
+} SRadixSortSup;
+
+static FORCE_INLINE int32_t radixSortCompar(const SRadixSortSup *pSup, const char *p1, const char *p2, int32_t depth) {
+  int32_t ret = memcmp(p1 + depth, p2 + depth, pSup->keyLen - depth);
+  if (ret == 0 && pSup->comparFn != NULL) {
+    ret = pSup->comparFn(p1, p2, pSup->param);
+  }
+  return ret;
+}
+
+static void radixInsertSort(const SRadixSortSup *pSup, char *src, int64_t num, int32_t depth) {
+  int64_t size = pSup->size;
+  char   *buf = pSup->aux;  // not used by the caller at this time
+  for (int64_t i = 1; i < num; ++i) {
+    int64_t j = i;
+    if (radixSortCompar(pSup, src + (j - 1) * size, src + j * size, depth) <= 0) {
+      continue;
+    }
+
+    memcpy(buf, src + i * size, size);
+    while (j > 0 && radixSortCompar(pSup, src + (j - 1) * size, buf, depth) > 0) {
+      j -= 1;
+    }
+    memmove(src + (j + 1) * size, src + j * size, (i - j) * size);
+    memcpy(src + j * size, buf, size);
+  }
+}
+
+// most significant byte first, the records are scattered into the buckets of the byte at depth
+static void radixSortImpl(const SRadixSortSup *pSup, char *src, int64_t num, int32_t depth) {
+  int64_t size = pSup->size;
+
+  while (depth < pSup->keyLen) {
+    if (num <= RADIX_SORT_INSERT_THRESHOLD) {
+      radixInsertSort(pSup, src, num, depth);
+      return;
+    }
+
+    int32_t *counts = pSup->counts + depth * 256;
+    memset(counts, 0, sizeof(int32_t) * 256);
+    for (int64_t i = 0; i < num; ++i) {
+      counts[(uint8_t)src[i * size + depth]] += 1;
+    }
+
+    // all records have the same byte
+    if (counts[(uint8_t)src[depth]] == num) {
+      depth += 1;
+      continue;
+    }
+
+    // the counters become the start of each bucket, and then the end of it after the records are scattered
+    int32_t start = 0;
+    for (int32_t i = 0; i < 256; ++i) {
+      int32_t c = counts[i];
+      counts[i] = start;
+      start += c;
+    }
+
+    for (int64_t i = 0; i < num; ++i) {
+      uint8_t b = (uint8_t)src[i * size + depth];
+      memcpy(pSup->aux + (int64_t)counts[b] * size, src + i * size, size);
+      counts[b] += 1;
+    }
+    memcpy(src, pSup->aux, num * size);
+
+    start = 0;
+    for (int32_t i = 0; i < 256; ++i) {
+      if (counts[i] - start > 1) {
+        radixSortImpl(pSup, src + (int64_t)start * size, counts[i] - start, depth + 1);
+      }
+      start = counts[i];
+    }
+    return;
+  }
+
+  // the keys are identical
+  if (pSup->comparFn != NULL && num > 1) {
+    taosqsort(src, num, size, pSup->param, pSup->comparFn);
+  }
+}
+
+int32_t taosRadixSort(void *src, int64_t numOfElem, int64_t size, int32_t keyLen, const void *param,
+                      __ext_compar_fn_t comparFn) {
+  if (numOfElem <= 1) {
+    return 0;
+  }
+
+  SRadixSortSup sup = {.size = size, .keyLen = keyLen, .param = param, .comparFn = comparFn};
+  sup.aux = taosMemoryMalloc(numOfElem * size);
+  sup.counts = taosMemoryMalloc(sizeof(int32_t) * 256 * (keyLen + 1));
+  if (sup.aux == NULL || sup.counts == NULL) {
+    taosMemoryFree(sup.aux);
+    taosMemoryFree(sup.counts);
+    return -1;
+  }
+
+  radixSortImpl(&sup, src, numOfElem, 0);
+
+  taosMemoryFree(sup.aux);
+  taosMemoryFree(sup.counts);
+  return 0;
+}
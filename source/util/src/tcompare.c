@@ -150,7 +150,7 @@ int32_t compareFloatVal(const void *pLeft, const void *pRight) {
   if (isnan(p2)) {
     return 1;
   }
-  if (FLT_EQUAL(p1, p2)) {
+  if (p1 == p2 || FLT_EQUAL(p1, p2)) {
     return 0;
   }
   return FLT_GREATER(p1, p2) ? 1 : -1;
@@ -174,7 +174,7 @@ int32_t compareDoubleVal(const void *pLeft, const void *pRight) {
     return 1;
   }
 
-  if (FLT_EQUAL(p1, p2)) {
+  if (p1 == p2 || FLT_EQUAL(p1, p2)) {
     return 0;
   }
   return FLT_GREATER(p1, p2) ? 1 : -1;
@@ -210,7 +210,7 @@ int32_t compareLenPrefixedWStr(const void *pLeft, const void *pRight) {
   if (len1 != len2) {
     return len1 > len2 ? 1 : -1;
   } else {
-    int32_t ret = memcmp((TdUcs4 *)pLeft, (TdUcs4 *)pRight, len1);
+    int32_t ret = memcmp(varDataVal(pLeft), varDataVal(pRight), len1);
     if (ret == 0) {
       return 0;
     } else {
@@ -588,6 +588,11 @@ void setBufPageDirty(void* pPage, bool dirty) {
 
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) { pBuf->comp = comp; }
 
+void dBufSetInMemBufSize(SDiskbasedBuf* pBuf, int32_t inMemBufSize) {
+  // at least more than 2 pages must be in memory
+  pBuf->inMemPages = TMAX(inMemBufSize / pBuf->pageSize, 2);
+}
+
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
   SPageInfo* ppi = getPageInfoFromPayload(pPage);
 